@@ -115,7 +115,6 @@ int http_api_v2(mqtt_wss_client client, aclk_query_t *query)
     BUFFER *local_buffer = NULL;
     usec_t dt_ut = 0;
 
-    int z_ret;
     BUFFER *z_buffer = buffer_create(NETDATA_WEB_RESPONSE_INITIAL_SIZE, &netdata_buffers_statistics.buffers_aclk);
 
     struct web_client *w = web_client_get_from_cache();
@@ -160,28 +159,27 @@ int http_api_v2(mqtt_wss_client client, aclk_query_t *query)
     w->response.code = (short)web_client_api_request_with_node_selection(localhost, w, path);
     web_client_timeout_checkpoint_response_ready(w, &dt_ut);
 
-    if (w->response.data->len && w->response.zinitialized) {
-        w->response.zstream.next_in = (Bytef *)w->response.data->buffer;
-        w->response.zstream.avail_in = w->response.data->len;
+    if (w->response.data->len && web_client_response_compressor(w)) {
+        const char *in = w->response.data->buffer;
+        size_t in_size = w->response.data->len;
         do {
-            w->response.zstream.avail_out = NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE;
-            w->response.zstream.next_out = w->response.zbuffer;
-            z_ret = deflate(&w->response.zstream, Z_FINISH);
-            if(z_ret < 0) {
-                if(w->response.zstream.msg)
-                    netdata_log_error("Error compressing body. ZLIB error: \"%s\"", w->response.zstream.msg);
-                else
-                    netdata_log_error("Unknown error during zlib compression.");
+            ssize_t produced = web_response_compressor_compress(
+                w->response.compressor, in, in_size, w->response.zbuffer, NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE, true);
+            if(produced < 0) {
+                netdata_log_error("Error compressing body.");
                 retval = 1;
                 w->response.code = 500;
                 aclk_http_msg_v2_err(client, query->callback_topic, query->msg_id, w->response.code, CLOUD_EC_ZLIB_ERROR, CLOUD_EMSG_ZLIB_ERROR, NULL, 0);
                 goto cleanup;
             }
-            int bytes_to_cpy = NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE - w->response.zstream.avail_out;
-            buffer_need_bytes(z_buffer, bytes_to_cpy);
-            memcpy(&z_buffer->buffer[z_buffer->len], w->response.zbuffer, bytes_to_cpy);
-            z_buffer->len += bytes_to_cpy;
-        } while(z_ret != Z_STREAM_END);
+            size_t pending = web_response_compressor_pending_input(w->response.compressor);
+            in += in_size - pending;
+            in_size = pending;
+
+            buffer_need_bytes(z_buffer, produced);
+            memcpy(&z_buffer->buffer[z_buffer->len], w->response.zbuffer, produced);
+            z_buffer->len += produced;
+        } while(web_response_compressor_has_output(w->response.compressor));
 
         // so that web_client_build_http_header
         // puts correct content length into header
@@ -197,7 +195,7 @@ int http_api_v2(mqtt_wss_client client, aclk_query_t *query)
     buffer_strcat(local_buffer, w->response.header_output->buffer);
 
     if (w->response.data->len) {
-        if (w->response.zinitialized) {
+        if (w->response.compressor) {
             buffer_need_bytes(local_buffer, w->response.data->len);
             memcpy(&local_buffer->buffer[local_buffer->len], w->response.data->buffer, w->response.data->len);
             local_buffer->len += w->response.data->len;
@@ -1511,6 +1511,13 @@ static void ebpf_parse_args(int argc, char **argv)
 
                 ebpf_ut_cleanup_memory();
 
+                // Receive process exits while children fork and connect
+                ebpf_ut_initialize_structure(MODE_ENTRY);
+                if (ebpf_ut_lifecycle_storm())
+                    goto unittest;
+
+                ebpf_ut_cleanup_memory();
+
                 exit_code = 0;
             unittest:
                 exit(exit_code);
@@ -1681,6 +1688,8 @@ void ebpf_send_statistic_data()
     ebpf_send_hash_table_pid_data(
         NETDATA_EBPF_HASH_TABLES_REMOVE_PID_ELEMENTS, NETDATA_EBPF_GLOBAL_TABLE_PID_TABLE_DEL);
 
+    ebpf_map_reader_send_statistics(EBPF_DEFAULT_UPDATE_EVERY);
+
     for (i = 0; i < EBPF_MODULE_FUNCTION_IDX; i++) {
         ebpf_module_t *wem = &ebpf_modules[i];
         if (!wem->functions.fnct_routine || !wem->functions.fcnt_thread_chart_name ||
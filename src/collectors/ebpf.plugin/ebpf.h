@@ -164,6 +164,9 @@ typedef struct ebpf_tracepoint {
 #define NETDATA_EBPF_HASH_TABLES_GLOBAL_ELEMENTS "ebpf_hash_tables_global_elements"
 #define NETDATA_EBPF_HASH_TABLES_INSERT_PID_ELEMENTS "ebpf_hash_tables_insert_pid_elements"
 #define NETDATA_EBPF_HASH_TABLES_REMOVE_PID_ELEMENTS "ebpf_hash_tables_remove_pid_elements"
+#define NETDATA_EBPF_HASH_TABLES_READ_TIME "ebpf_hash_tables_read_time"
+#define NETDATA_EBPF_HASH_TABLES_READ_ELEMENTS "ebpf_hash_tables_read_elements"
+#define NETDATA_EBPF_HASH_TABLES_READ_CALLS "ebpf_hash_tables_read_calls"
 
 // Log file
 #define NETDATA_DEVELOPER_LOG_FILE "developer.log"
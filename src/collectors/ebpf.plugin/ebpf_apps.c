@@ -823,6 +823,57 @@ void ebpf_del_pid_entry(pid_t pid)
     ebpf_pid_del(pid);
 }
 
+/**
+ * Retire Process
+ *
+ * Credit the final counters of a process that exited to its target, so the target keeps them
+ * after the process is removed from the tables. The caller must hold collect_data_mutex.
+ *
+ * @param pid   the process that exited.
+ * @param final its counters when kernel released it.
+ */
+void ebpf_apps_retire_process(uint32_t pid, const ebpf_publish_process_t *final)
+{
+    ebpf_pid_data_t *p = ebpf_find_pid_data((pid_t)pid);
+    if (!p || !p->target)
+        return;
+
+    ebpf_publish_process_t *out = &p->target->exited_process;
+    out->exit_call += final->exit_call;
+    out->release_call += final->release_call;
+    out->create_process += final->create_process;
+    out->create_thread += final->create_thread;
+    out->task_err += final->task_err;
+}
+
+/**
+ * Retire Socket
+ *
+ * Credit the final counters of a closed socket to the target of its process.
+ * The caller must hold collect_data_mutex.
+ *
+ * @param pid   the process that owned the socket.
+ * @param final the socket counters when it was closed.
+ */
+void ebpf_apps_retire_socket(uint32_t pid, const ebpf_socket_publish_apps_t *final)
+{
+    ebpf_pid_data_t *p = ebpf_find_pid_data((pid_t)pid);
+    if (!p || !p->target)
+        return;
+
+    ebpf_socket_publish_apps_t *out = &p->target->closed_socket;
+    out->bytes_sent += final->bytes_sent;
+    out->bytes_received += final->bytes_received;
+    out->call_tcp_sent += final->call_tcp_sent;
+    out->call_tcp_received += final->call_tcp_received;
+    out->retransmit += final->retransmit;
+    out->call_udp_sent += final->call_udp_sent;
+    out->call_udp_received += final->call_udp_received;
+    out->call_close += final->call_close;
+    out->call_tcp_v4_connection += final->call_tcp_v4_connection;
+    out->call_tcp_v6_connection += final->call_tcp_v6_connection;
+}
+
 /**
  * Remove PIDs when they are not running more.
  */
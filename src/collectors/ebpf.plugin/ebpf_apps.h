@@ -94,6 +94,10 @@ struct ebpf_target {
     ebpf_process_stat_t process;
     ebpf_socket_publish_apps_t socket;
 
+    // final counters of the processes and sockets retired by lifecycle events
+    ebpf_publish_process_t exited_process;
+    ebpf_socket_publish_apps_t closed_socket;
+
     kernel_uint_t starttime;
     kernel_uint_t collected_starttime;
 
@@ -155,6 +159,8 @@ extern ebpf_pid_data_t *ebpf_pids_link_list;
 extern size_t ebpf_all_pids_count;
 extern size_t ebpf_hash_table_pids_count;
 void ebpf_del_pid_entry(pid_t pid);
+void ebpf_apps_retire_process(uint32_t pid, const ebpf_publish_process_t *final);
+void ebpf_apps_retire_socket(uint32_t pid, const ebpf_socket_publish_apps_t *final);
 
 ebpf_pid_data_t *ebpf_find_or_create_pid_data(pid_t pid);
 
@@ -300,7 +306,8 @@ int ebpf_read_hash_table(void *ep, int fd, uint32_t pid);
 
 int get_pid_comm(pid_t pid, size_t n, char *dest);
 
-void collect_data_for_all_processes(int tbl_pid_stats_fd, int maps_per_core);
+struct ebpf_map_reader;
+void collect_data_for_all_processes(int tbl_pid_stats_fd, struct ebpf_map_reader *reader, int maps_per_core);
 void ebpf_process_apps_accumulator(ebpf_process_stat_t *out, int maps_per_core);
 
 // The default value is at least 32 times smaller than maximum number of PIDs allowed on system,
@@ -312,7 +319,6 @@ void ebpf_process_apps_accumulator(ebpf_process_stat_t *out, int maps_per_core);
 
 // ARAL Sectiion
 void ebpf_aral_init(void);
-extern ebpf_process_stat_t *process_stat_vector;
 
 extern ARAL *ebpf_aral_vfs_pid;
 void ebpf_vfs_aral_init();
@@ -8,7 +8,6 @@ static char *cachestat_counter_dimension_name[NETDATA_CACHESTAT_END] = {"ratio",
 static netdata_syscall_stat_t cachestat_counter_aggregated_data[NETDATA_CACHESTAT_END];
 static netdata_publish_syscall_t cachestat_counter_publish_aggregated[NETDATA_CACHESTAT_END];
 
-netdata_cachestat_pid_t *cachestat_vector = NULL;
 
 static netdata_idx_t cachestat_hash_values[NETDATA_CACHESTAT_END];
 static netdata_idx_t *cachestat_values = NULL;
@@ -633,8 +632,6 @@ static void ebpf_cachestat_exit(void *pptr)
     ebpf_module_enabled_set(em, NETDATA_THREAD_EBPF_STOPPED);
     netdata_mutex_unlock(&ebpf_exit_cleanup);
 
-    freez(cachestat_vector);
-    cachestat_vector = NULL;
     freez(cachestat_values);
     cachestat_values = NULL;
 }
@@ -818,30 +815,30 @@ static inline void cachestat_save_pid_values(netdata_publish_cachestat_t *out, n
  *
  * Read the apps table and store data inside the structure.
  *
+ * @param reader        the reader used to harvest the hash table.
  * @param maps_per_core do I need to read all cores?
  */
-static void ebpf_read_cachestat_apps_table(int maps_per_core)
+static void ebpf_read_cachestat_apps_table(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_cachestat_pid_t *cv = cachestat_vector;
+    if (!reader)
+        return;
+
+    netdata_cachestat_pid_t *cv;
+    uint32_t *key_ptr;
     int fd = cachestat_maps[NETDATA_CACHESTAT_PID_STATS].map_fd;
-    size_t length = sizeof(netdata_cachestat_pid_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&cv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, cv)) {
-            goto end_cachestat_loop;
-        }
+        uint32_t key = *key_ptr;
 
         cachestat_apps_accumulator(cv, maps_per_core);
 
         netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_CACHESTAT_IDX);
         if (!local_pid)
-            goto end_cachestat_loop;
+            continue;
         netdata_publish_cachestat_t *publish = &local_pid->cachestat;
 
         if (!publish->ct || publish->ct != cv->ct) {
@@ -852,12 +849,8 @@ static void ebpf_read_cachestat_apps_table(int maps_per_core)
                     memset(publish, 0, sizeof(*publish));
             }
         }
-
-    end_cachestat_loop:
-        // We are cleaning to avoid passing data read from one process to other.
-        memset(cv, 0, length);
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -1028,6 +1021,8 @@ void ebpf_read_cachestat_thread(void *ptr)
     uint32_t lifetime = em->lifetime;
     uint32_t running_time = 0;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_CACHESTAT_IDX, cachestat_maps[NETDATA_CACHESTAT_PID_STATS].map_fd);
+    ebpf_local_maps_t *pid_map = &cachestat_maps[NETDATA_CACHESTAT_PID_STATS];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
     while (!ebpf_plugin_stop() && running_time < lifetime) {
@@ -1047,7 +1042,7 @@ void ebpf_read_cachestat_thread(void *ptr)
             break;
         }
 
-        ebpf_read_cachestat_apps_table(maps_per_core);
+        ebpf_read_cachestat_apps_table(reader, maps_per_core);
         ebpf_cachestat_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -1075,6 +1070,8 @@ void ebpf_read_cachestat_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -1733,7 +1730,6 @@ static void ebpf_create_memory_charts(ebpf_module_t *em)
  */
 static void ebpf_cachestat_allocate_global_vectors()
 {
-    cachestat_vector = callocz((size_t)ebpf_nprocs, sizeof(netdata_cachestat_pid_t));
     cachestat_values = callocz((size_t)ebpf_nprocs, sizeof(netdata_idx_t));
 
     memset(cachestat_hash_values, 0, NETDATA_CACHESTAT_END * sizeof(netdata_idx_t));
@@ -8,7 +8,6 @@ static char *dcstat_counter_dimension_name[NETDATA_DCSTAT_IDX_END] = {"ratio", "
 static netdata_syscall_stat_t dcstat_counter_aggregated_data[NETDATA_DCSTAT_IDX_END];
 static netdata_publish_syscall_t dcstat_counter_publish_aggregated[NETDATA_DCSTAT_IDX_END];
 
-netdata_dcstat_pid_t *dcstat_vector = NULL;
 
 static netdata_idx_t dcstat_hash_values[NETDATA_DCSTAT_IDX_END];
 static netdata_idx_t *dcstat_values = NULL;
@@ -572,30 +571,30 @@ static void ebpf_dcstat_apps_accumulator(netdata_dcstat_pid_t *out, int maps_per
  *
  * Read the apps table and store data inside the structure.
  *
+ * @param reader        the reader used to harvest the hash table.
  * @param maps_per_core do I need to read all cores?
  */
-static void ebpf_read_dc_apps_table(int maps_per_core)
+static void ebpf_read_dc_apps_table(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_dcstat_pid_t *cv = dcstat_vector;
+    if (!reader)
+        return;
+
+    netdata_dcstat_pid_t *cv;
+    uint32_t *key_ptr;
     int fd = dcstat_maps[NETDATA_DCSTAT_PID_STATS].map_fd;
-    size_t length = sizeof(netdata_dcstat_pid_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&cv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, cv)) {
-            goto end_dc_loop;
-        }
+        uint32_t key = *key_ptr;
 
         ebpf_dcstat_apps_accumulator(cv, maps_per_core);
 
         netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_DCSTAT_IDX);
         if (!local_pid)
-            goto end_dc_loop;
+            continue;
         netdata_publish_dcstat_t *publish = &local_pid->directory_cache;
         if (!publish->ct || publish->ct != cv->ct) {
             publish->ct = cv->ct;
@@ -608,12 +607,8 @@ static void ebpf_read_dc_apps_table(int maps_per_core)
                     memset(publish, 0, sizeof(*publish));
             }
         }
-
-    end_dc_loop:
-        // We are cleaning to avoid passing data read from one process to other.
-        memset(cv, 0, length);
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -723,6 +718,8 @@ void ebpf_read_dcstat_thread(void *ptr)
     uint32_t lifetime = em->lifetime;
     uint32_t running_time = 0;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_DCSTAT_IDX, dcstat_maps[NETDATA_DCSTAT_PID_STATS].map_fd);
+    ebpf_local_maps_t *pid_map = &dcstat_maps[NETDATA_DCSTAT_PID_STATS];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
     while (!ebpf_plugin_stop() && running_time < lifetime) {
@@ -742,7 +739,7 @@ void ebpf_read_dcstat_thread(void *ptr)
             break;
         }
 
-        ebpf_read_dc_apps_table(maps_per_core);
+        ebpf_read_dc_apps_table(reader, maps_per_core);
         ebpf_dc_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -773,6 +770,8 @@ void ebpf_read_dcstat_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -1505,7 +1504,6 @@ static void ebpf_create_dc_global_charts(int update_every)
  */
 static void ebpf_dcstat_allocate_global_vectors()
 {
-    dcstat_vector = callocz((size_t)ebpf_nprocs, sizeof(netdata_dcstat_pid_t));
     dcstat_values = callocz((size_t)ebpf_nprocs, sizeof(netdata_idx_t));
 
     memset(dcstat_counter_aggregated_data, 0, NETDATA_DCSTAT_IDX_END * sizeof(netdata_syscall_stat_t));
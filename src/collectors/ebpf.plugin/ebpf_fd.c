@@ -58,7 +58,6 @@ struct config fd_config = APPCONFIG_INITIALIZER;
 static netdata_idx_t fd_hash_values[NETDATA_FD_COUNTER];
 static netdata_idx_t *fd_values = NULL;
 
-netdata_fd_stat_t *fd_vector = NULL;
 static bool fd_safe_clean = false;
 
 static int fd_use_close_fd = -1;
@@ -659,8 +658,6 @@ static void ebpf_fd_exit(void *pptr)
         netdata_mutex_unlock(&lock);
     }
 
-    freez(fd_vector);
-    fd_vector = NULL;
     freez(fd_values);
     fd_values = NULL;
 
@@ -763,31 +760,30 @@ static void fd_apps_accumulator(netdata_fd_stat_t *out, int maps_per_core)
  *
  * Read the apps table and store data inside the structure.
  *
+ * @param reader        the reader used to harvest the hash table.
  * @param maps_per_core do I need to read all cores?
  */
-static void ebpf_read_fd_apps_table(int maps_per_core)
+static void ebpf_read_fd_apps_table(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_fd_stat_t *fv = fd_vector;
+    if (!reader)
+        return;
+
+    netdata_fd_stat_t *fv;
+    uint32_t *key_ptr;
     int fd = fd_maps[NETDATA_FD_PID_STATS].map_fd;
-    size_t length = sizeof(netdata_fd_stat_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&fv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, fv)) {
-            netdata_log_error("Failed to lookup PID %u in FD map", key);
-            goto end_fd_loop;
-        }
+        uint32_t key = *key_ptr;
 
         fd_apps_accumulator(fv, maps_per_core);
 
         netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_FD_IDX);
         if (!local_pid)
-            goto end_fd_loop;
+            continue;
         netdata_publish_fd_stat_t *publish_fd = &local_pid->fd;
 
         if (kill((pid_t)key, 0) == -1 && errno == ESRCH) {
@@ -800,12 +796,8 @@ static void ebpf_read_fd_apps_table(int maps_per_core)
             publish_fd->open_err = fv->open_err;
             publish_fd->close_err = fv->close_err;
         }
-
-    end_fd_loop:
-        // We are cleaning to avoid passing data read from one process to other.
-        memset(fv, 0, length);
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -912,6 +904,8 @@ void ebpf_read_fd_thread(void *ptr)
     int cgroups = em->cgroup_charts;
     uint32_t running_time = 0;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_FD_IDX, fd_maps[NETDATA_FD_PID_STATS].map_fd);
+    ebpf_local_maps_t *pid_map = &fd_maps[NETDATA_FD_PID_STATS];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
 
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
@@ -931,7 +925,7 @@ void ebpf_read_fd_thread(void *ptr)
                 netdata_log_error("FD: Failed to wait on semaphore.");
             break;
         }
-        ebpf_read_fd_apps_table(maps_per_core);
+        ebpf_read_fd_apps_table(reader, maps_per_core);
         ebpf_fd_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -961,6 +955,8 @@ void ebpf_read_fd_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -1613,7 +1609,6 @@ static void ebpf_create_fd_global_charts(ebpf_module_t *em)
  */
 static inline void ebpf_fd_allocate_global_vectors(void)
 {
-    fd_vector = callocz((size_t)ebpf_nprocs, sizeof(netdata_fd_stat_t));
     fd_values = callocz((size_t)ebpf_nprocs, sizeof(netdata_idx_t));
 }
 
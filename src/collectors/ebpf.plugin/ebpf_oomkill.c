@@ -360,36 +360,31 @@ void ebpf_oomkill_send_cgroup_data(int update_every)
 /**
  * Read data
  *
- * Read OOMKILL events from table.
+ * Read OOMKILL events from table, removing them.
  *
- * @param keys vector where data will be stored
+ * @param reader the reader used to harvest the table.
+ * @param keys   vector where data will be stored
  *
  * @return It returns the number of read elements
  */
-static uint32_t oomkill_read_data(int32_t *keys)
+static uint32_t oomkill_read_data(ebpf_map_reader_t *reader, int32_t *keys)
 {
     // the first `i` entries of `keys` will contain the currently active PIDs
     // in the eBPF map.
     uint32_t i = 0;
+    if (!reader)
+        return 0;
 
-    uint32_t curr_key = 0;
-    uint32_t key;
-    int mapfd = oomkill_maps[0].map_fd;
-    while (bpf_map_get_next_key(mapfd, &curr_key, &key) == 0) {
+    // the table has room for NETDATA_OOMKILL_MAX_ENTRIES, so a batch never deletes more than we can store
+    void *key, *values;
+    ebpf_map_reader_begin(reader);
+    while (i < NETDATA_OOMKILL_MAX_ENTRIES && ebpf_map_reader_next(reader, &key, &values)) {
         if (ebpf_plugin_stop())
             break;
 
-        curr_key = key;
-
-        keys[i] = (int32_t)key;
-        i += 1;
-
-        if (unlikely(bpf_map_delete_elem(mapfd, &key) < 0)) {
-            netdata_log_error("key unexpectedly not available for deletion.");
-        }
-        if (i >= NETDATA_OOMKILL_MAX_ENTRIES)
-            break;
+        keys[i++] = *(int32_t *)key;
     }
+    ebpf_map_reader_end(reader);
 
     return i;
 }
@@ -453,6 +448,8 @@ static void oomkill_collector(ebpf_module_t *em)
     int cgroups = em->cgroup_charts;
     int update_every = em->update_every;
     int32_t keys[NETDATA_OOMKILL_MAX_ENTRIES];
+    ebpf_map_reader_t *reader =
+        ebpf_map_reader_create(em->info.thread_name, oomkill_maps[0].name, oomkill_maps[0].map_fd, true);
 
     // loop and read until ebpf plugin is closed.
     int counter = update_every - 1;
@@ -474,7 +471,7 @@ static void oomkill_collector(ebpf_module_t *em)
 
         counter = 0;
 
-        uint32_t count = oomkill_read_data(keys);
+        uint32_t count = oomkill_read_data(reader, keys);
 
         stats[NETDATA_CONTROLLER_PID_TABLE_ADD] += (uint64_t)count;
         stats[NETDATA_CONTROLLER_PID_TABLE_DEL] += (uint64_t)count;
@@ -498,6 +495,8 @@ static void oomkill_collector(ebpf_module_t *em)
 
         running_time = ebpf_update_oomkill_period(running_time, em);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
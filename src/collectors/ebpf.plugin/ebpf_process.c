@@ -68,13 +68,15 @@ static int was_sched_process_exec_enabled = 0;
 static int was_sched_process_fork_enabled = 0;
 
 static netdata_idx_t *process_hash_values = NULL;
-ebpf_process_stat_t *process_stat_vector = NULL;
 static bool process_safe_clean = false;
 static netdata_syscall_stat_t process_aggregated_data[NETDATA_KEY_PUBLISH_PROCESS_END];
 static netdata_publish_syscall_t process_publish_aggregated[NETDATA_KEY_PUBLISH_PROCESS_END];
 
 struct config process_config = APPCONFIG_INITIALIZER;
 
+static ebpf_event_stream_t *process_events = NULL;
+static ebpf_process_stat_t *process_exit_values = NULL;
+
 #ifdef LIBBPF_MAJOR_VERSION
 /**
  * Disable probe
@@ -995,7 +997,6 @@ static void ebpf_process_exit(void *pptr)
     }
 
     freez(process_hash_values);
-    freez(process_stat_vector);
 
     ebpf_process_disable_tracepoints();
 
@@ -1481,21 +1482,15 @@ void ebpf_process_update_cgroup_algorithm()
 void ebpf_process_apps_accumulator(ebpf_process_stat_t *out, int maps_per_core)
 {
     int i, end = (maps_per_core) ? ebpf_nprocs : 1;
+
+    // exit_call, release_call, create_process, create_thread and task_err are consecutive
+    ebpf_sum_percpu_u32(out, sizeof(*out), offsetof(ebpf_process_stat_t, exit_call), 5, end);
+
     ebpf_process_stat_t *total = &out[0];
     uint64_t ct = total->ct;
     for (i = 1; i < end; i++) {
-        if (ebpf_plugin_stop())
-            break;
-
-        ebpf_process_stat_t *w = &out[i];
-        total->exit_call += w->exit_call;
-        total->task_err += w->task_err;
-        total->create_thread += w->create_thread;
-        total->create_process += w->create_process;
-        total->release_call += w->release_call;
-
-        if (w->ct > ct)
-            ct = w->ct;
+        if (out[i].ct > ct)
+            ct = out[i].ct;
     }
     total->ct = ct;
 }
@@ -1504,11 +1499,20 @@ void ebpf_process_apps_accumulator(ebpf_process_stat_t *out, int maps_per_core)
  * Sum values for pid
  *
  * @param structure to store result.
+ * @param exited the counters of processes of the target that have already exited.
  * @param root the structure with all available PIDs
  */
-void ebpf_process_sum_values_for_pids(ebpf_process_stat_t *process, struct ebpf_pid_on_target *root)
+void ebpf_process_sum_values_for_pids(
+    ebpf_process_stat_t *process,
+    ebpf_publish_process_t *exited,
+    struct ebpf_pid_on_target *root)
 {
     memset(process, 0, sizeof(ebpf_process_stat_t));
+    process->task_err = exited->task_err;
+    process->release_call = exited->release_call;
+    process->exit_call = exited->exit_call;
+    process->create_thread = exited->create_thread;
+    process->create_process = exited->create_process;
     for (; root; root = root->next) {
         if (ebpf_plugin_stop())
             break;
@@ -1528,6 +1532,50 @@ void ebpf_process_sum_values_for_pids(ebpf_process_stat_t *process, struct ebpf_
     }
 }
 
+/**
+ * Retire PID
+ *
+ * Apply the final counters of a task released by kernel and remove it from the tables,
+ * instead of waiting for the next scan to notice it is gone.
+ *
+ * @param record the ebpf_process_exit_event_t written by kernel.
+ * @param data   a pointer to maps_per_core.
+ */
+static void ebpf_process_retire_pid(void *record, void *data)
+{
+    ebpf_process_exit_event_t *ev = record;
+    ebpf_process_stat_t *final = &ev->stat;
+    int maps_per_core = *(int *)data;
+
+    // with maps per core the record only has the counters of the core that released the task
+    if (!bpf_map_lookup_elem(process_pid_fd, &ev->key, process_exit_values)) {
+        ebpf_process_apps_accumulator(process_exit_values, maps_per_core);
+        ebpf_process_stat_t *table = &process_exit_values[0];
+        final->exit_call = MAX(final->exit_call, table->exit_call);
+        final->release_call = MAX(final->release_call, table->release_call);
+        final->create_process = MAX(final->create_process, table->create_process);
+        final->create_thread = MAX(final->create_thread, table->create_thread);
+        final->task_err = MAX(final->task_err, table->task_err);
+    }
+
+    ebpf_publish_process_t out = {
+        .ct = final->ct,
+        .exit_call = final->exit_call,
+        .release_call = final->release_call,
+        .create_process = final->create_process,
+        .create_thread = final->create_thread,
+        .task_err = final->task_err,
+    };
+    ebpf_apps_retire_process(ev->key, &out);
+
+    netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_lookup_shm_pointer_unsafe(ev->key);
+    if (local_pid && (local_pid->threads & (1U << (NETDATA_EBPF_PIDS_PROCESS_IDX << 1)))) {
+        if (netdata_ebpf_reset_shm_pointer_unsafe(process_pid_fd, ev->key, NETDATA_EBPF_PIDS_PROCESS_IDX))
+            memset(&local_pid->process, 0, sizeof(local_pid->process));
+    } else
+        bpf_map_delete_elem(process_pid_fd, &ev->key);
+}
+
 /**
  * Collect data for all process
  *
@@ -1535,56 +1583,49 @@ void ebpf_process_sum_values_for_pids(ebpf_process_stat_t *process, struct ebpf_
  * It also creates the link between targets and PIDs.
  *
  * @param tbl_pid_stats_fd      The mapped file descriptor for the hash table.
+ * @param reader                the reader used to harvest the hash table.
  * @param maps_per_core         do I have hash maps per core?
  */
-void collect_data_for_all_processes(int tbl_pid_stats_fd, int maps_per_core)
+void collect_data_for_all_processes(int tbl_pid_stats_fd, struct ebpf_map_reader *reader, int maps_per_core)
 {
-    if (tbl_pid_stats_fd == -1)
+    if (tbl_pid_stats_fd == -1 || !reader)
         return;
 
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_PROCESS_IDX, tbl_pid_stats_fd);
-    size_t length = sizeof(ebpf_process_stat_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
-
-    if (tbl_pid_stats_fd != -1) {
-        uint32_t key = 0, next_key = 0;
-        while (bpf_map_get_next_key(tbl_pid_stats_fd, &key, &next_key) == 0) {
-            if (ebpf_plugin_stop())
-                break;
 
-            if (bpf_map_lookup_elem(tbl_pid_stats_fd, &key, process_stat_vector)) {
-                goto end_process_loop;
-            }
+    // tasks released since the last iteration, the scan below is a fallback for the events we lost
+    ebpf_event_stream_drain(process_events, ebpf_process_retire_pid, &maps_per_core);
 
-            ebpf_process_apps_accumulator(process_stat_vector, maps_per_core);
+    uint32_t *key;
+    ebpf_process_stat_t *values;
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key, (void **)&values)) {
+        if (ebpf_plugin_stop())
+            break;
 
-            netdata_ebpf_pid_stats_t *local_pid =
-                netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_PROCESS_IDX);
-            if (!local_pid)
-                goto end_process_loop;
+        ebpf_process_apps_accumulator(values, maps_per_core);
 
-            ebpf_publish_process_t *w = &local_pid->process;
+        netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(*key, NETDATA_EBPF_PIDS_PROCESS_IDX);
+        if (!local_pid)
+            continue;
 
-            if (!w->ct || w->ct != process_stat_vector[0].ct) {
-                w->ct = process_stat_vector[0].ct;
-                w->create_thread = process_stat_vector[0].create_thread;
-                w->exit_call = process_stat_vector[0].exit_call;
-                w->create_process = process_stat_vector[0].create_process;
-                w->release_call = process_stat_vector[0].release_call;
-                w->task_err = process_stat_vector[0].task_err;
-            } else {
-                if (kill((pid_t)key, 0) == -1 && errno == ESRCH) {
-                    if (netdata_ebpf_reset_shm_pointer_unsafe(tbl_pid_stats_fd, key, NETDATA_EBPF_PIDS_PROCESS_IDX))
-                        memset(w, 0, sizeof(*w));
-                }
+        ebpf_publish_process_t *w = &local_pid->process;
+
+        if (!w->ct || w->ct != values[0].ct) {
+            w->ct = values[0].ct;
+            w->create_thread = values[0].create_thread;
+            w->exit_call = values[0].exit_call;
+            w->create_process = values[0].create_process;
+            w->release_call = values[0].release_call;
+            w->task_err = values[0].task_err;
+        } else {
+            if (kill((pid_t)*key, 0) == -1 && errno == ESRCH) {
+                if (netdata_ebpf_reset_shm_pointer_unsafe(tbl_pid_stats_fd, *key, NETDATA_EBPF_PIDS_PROCESS_IDX))
+                    memset(w, 0, sizeof(*w));
             }
-
-        end_process_loop:
-            memset(process_stat_vector, 0, length);
-            key = next_key;
         }
     }
+    ebpf_map_reader_end(reader);
 
     struct ebpf_target *w;
     for (w = apps_groups_root_target; w; w = w->next) {
@@ -1594,7 +1635,7 @@ void collect_data_for_all_processes(int tbl_pid_stats_fd, int maps_per_core)
         if (unlikely(!(w->processes)))
             continue;
 
-        ebpf_process_sum_values_for_pids(&w->process, w->root_pid);
+        ebpf_process_sum_values_for_pids(&w->process, &w->exited_process, w->root_pid);
     }
 }
 
@@ -1623,6 +1664,19 @@ static void process_collector(ebpf_module_t *em)
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
     int process_maps_per_core = ebpf_modules[EBPF_MODULE_PROCESS_IDX].maps_per_core;
+    ebpf_map_reader_t *pid_reader = ebpf_map_reader_create(
+        em->info.thread_name, process_maps[NETDATA_PROCESS_PID_TABLE].name, process_pid_fd, false);
+    if (pid_reader && em->lifecycle_events) {
+        struct bpf_object *obj = em->objects;
+#ifdef LIBBPF_MAJOR_VERSION
+        if (!(em->load & EBPF_LOAD_LEGACY) && process_bpf_obj)
+            obj = process_bpf_obj->obj;
+#endif
+        process_events = ebpf_event_stream_create(
+            em->info.thread_name, obj, NETDATA_PROCESS_EVENTS_TABLE, sizeof(ebpf_process_exit_event_t));
+        if (process_events)
+            process_exit_values = callocz(1, ebpf_map_reader_value_size(pid_reader));
+    }
     while (!ebpf_plugin_stop() && running_time < lifetime) {
         if (ebpf_plugin_stop())
             break;
@@ -1646,7 +1700,7 @@ static void process_collector(ebpf_module_t *em)
                     break;
                 }
                 netdata_mutex_lock(&collect_data_mutex);
-                collect_data_for_all_processes(process_pid_fd, process_maps_per_core);
+                collect_data_for_all_processes(process_pid_fd, pid_reader, process_maps_per_core);
 
                 if (cgroups && ebpf_cgroup_integration_active_get()) {
                     ebpf_update_process_cgroup();
@@ -1694,6 +1748,12 @@ static void process_collector(ebpf_module_t *em)
             netdata_mutex_unlock(&ebpf_exit_cleanup);
         }
     }
+
+    ebpf_event_stream_destroy(process_events);
+    process_events = NULL;
+    freez(process_exit_values);
+    process_exit_values = NULL;
+    ebpf_map_reader_destroy(pid_reader);
 }
 
 /*****************************************************************
@@ -1714,7 +1774,6 @@ static void ebpf_process_allocate_global_vectors(size_t length)
     memset(process_aggregated_data, 0, length * sizeof(netdata_syscall_stat_t));
     memset(process_publish_aggregated, 0, length * sizeof(netdata_publish_syscall_t));
     process_hash_values = callocz(ebpf_nprocs, sizeof(netdata_idx_t));
-    process_stat_vector = callocz(ebpf_nprocs, sizeof(ebpf_process_stat_t));
 }
 
 static void change_syscalls()
@@ -54,6 +54,9 @@ enum netdata_ebpf_stats_order {
     NETDATA_EBPF_ORDER_STAT_HASH_GLOBAL_TABLE_TOTAL,
     NETDATA_EBPF_ORDER_STAT_HASH_PID_TABLE_ADDED,
     NETDATA_EBPF_ORDER_STAT_HASH_PID_TABLE_REMOVED,
+    NETDATA_EBPF_ORDER_STAT_HASH_READ_TIME,
+    NETDATA_EBPF_ORDER_STAT_HASH_READ_ELEMENTS,
+    NETDATA_EBPF_ORDER_STAT_HASH_READ_CALLS,
     NETDATA_EBPF_ORDER_STAT_ARAL_BEGIN,
     NETDATA_EBPF_ORDER_FUNCTION_PER_THREAD,
 };
@@ -111,6 +114,15 @@ enum netdata_core_process {
 
 enum ebpf_process_tables { NETDATA_PROCESS_PID_TABLE, NETDATA_PROCESS_GLOBAL_TABLE, NETDATA_PROCESS_CTRL_TABLE };
 
+// Ring buffer filled by kernel when a task is released, used when `lifecycle events` is enabled
+#define NETDATA_PROCESS_EVENTS_TABLE "tbl_pid_events"
+
+typedef struct ebpf_process_exit_event {
+    uint32_t key; // the key of the task inside tbl_pid_stats
+    uint32_t reserved;
+    ebpf_process_stat_t stat; // the final counters of the task
+} ebpf_process_exit_event_t;
+
 extern netdata_ebpf_targets_t process_targets[];
 extern struct config process_config;
 
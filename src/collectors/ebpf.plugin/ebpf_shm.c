@@ -583,24 +583,25 @@ static void ebpf_update_shm_cgroup(void)
  *
  * Read the apps table and store data inside the structure.
  *
+ * @param reader        the reader used to harvest the hash table.
  * @param maps_per_core do I need to read all cores?
  */
-static void ebpf_read_shm_apps_table(int maps_per_core)
+static void ebpf_read_shm_apps_table(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_ebpf_shm_t *cv = shm_vector;
+    if (!reader)
+        return;
+
+    netdata_ebpf_shm_t *cv;
+    uint32_t *key_ptr;
     int fd = shm_maps[NETDATA_PID_SHM_TABLE].map_fd;
-    size_t length = sizeof(netdata_ebpf_shm_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
+    size_t length = ebpf_map_reader_value_size(reader);
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&cv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, cv)) {
-            goto end_shm_loop;
-        }
+        uint32_t key = *key_ptr;
 
         shm_apps_accumulator(cv, maps_per_core);
 
@@ -622,9 +623,8 @@ static void ebpf_read_shm_apps_table(int maps_per_core)
         // now that we've consumed the value, zero it out in the map.
         memset(cv, 0, length);
         bpf_map_update_elem(fd, &key, cv, BPF_EXIST);
-
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -1135,6 +1135,8 @@ void ebpf_read_shm_thread(void *ptr)
     int cgroups = em->cgroup_charts;
     uint32_t running_time = 0;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_SHM_IDX, shm_maps[NETDATA_PID_SHM_TABLE].map_fd);
+    ebpf_local_maps_t *pid_map = &shm_maps[NETDATA_PID_SHM_TABLE];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
     while (!ebpf_plugin_stop() && running_time < lifetime) {
@@ -1153,7 +1155,7 @@ void ebpf_read_shm_thread(void *ptr)
                 netdata_log_error("SHM: Failed to wait on semaphore.");
             break;
         }
-        ebpf_read_shm_apps_table(maps_per_core);
+        ebpf_read_shm_apps_table(reader, maps_per_core);
         ebpf_shm_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -1179,6 +1181,8 @@ void ebpf_read_shm_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
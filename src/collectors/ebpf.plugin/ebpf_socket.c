@@ -93,8 +93,6 @@ static netdata_idx_t *socket_hash_values = NULL;
 static netdata_syscall_stat_t socket_aggregated_data[NETDATA_MAX_SOCKET_VECTOR];
 static netdata_publish_syscall_t socket_publish_aggregated[NETDATA_MAX_SOCKET_VECTOR];
 
-netdata_socket_t *socket_values;
-
 ebpf_network_viewer_port_list_t *listen_ports = NULL;
 ebpf_addresses_t tcp_v6_connect_address = {.function = "tcp_v6_connect", .hash = 0, .addr = 0, .type = 0};
 
@@ -123,6 +121,7 @@ struct netdata_static_thread ebpf_read_socket = {
     .start_routine = NULL};
 
 ARAL *aral_socket_table = NULL;
+static ebpf_event_stream_t *socket_events = NULL;
 
 #define NETDATA_MAX(a, b) ((a) > (b) ? (a) : (b))
 
@@ -1633,21 +1632,17 @@ static void ebpf_hash_socket_accumulator(netdata_socket_t *values, int end)
     uint64_t ft = values[0].first_timestamp;
     uint16_t family = AF_UNSPEC;
     uint32_t external_origin = values[0].external_origin;
+
+    ebpf_sum_percpu_u32(values, sizeof(*values), offsetof(netdata_socket_t, tcp.call_tcp_sent), 2, end);
+    ebpf_sum_percpu_u64(values, sizeof(*values), offsetof(netdata_socket_t, tcp.tcp_bytes_sent), 2, end);
+    ebpf_sum_percpu_u32(values, sizeof(*values), offsetof(netdata_socket_t, tcp.close), 4, end);
+
     for (i = 1; i < end; i++) {
         if (ebpf_plugin_stop())
             break;
 
         netdata_socket_t *w = &values[i];
 
-        values[0].tcp.call_tcp_sent += w->tcp.call_tcp_sent;
-        values[0].tcp.call_tcp_received += w->tcp.call_tcp_received;
-        values[0].tcp.tcp_bytes_received += w->tcp.tcp_bytes_received;
-        values[0].tcp.tcp_bytes_sent += w->tcp.tcp_bytes_sent;
-        values[0].tcp.close += w->tcp.close;
-        values[0].tcp.retransmit += w->tcp.retransmit;
-        values[0].tcp.ipv4_connect += w->tcp.ipv4_connect;
-        values[0].tcp.ipv6_connect += w->tcp.ipv6_connect;
-
         if (!protocol)
             protocol = w->protocol;
 
@@ -1799,39 +1794,30 @@ static void ebpf_socket_translate(netdata_socket_plus_t *dst, netdata_socket_idx
  *
  * Read data from hash table and update vectors.
  *
- * @param em the structure with configuration
+ * @param em     the structure with configuration
+ * @param reader the reader used to harvest the socket table.
  */
-static void ebpf_update_array_vectors(ebpf_module_t *em)
+static void ebpf_update_array_vectors(ebpf_module_t *em, ebpf_map_reader_t *reader)
 {
-    netdata_socket_idx_t key = {};
-    netdata_socket_idx_t next_key = {};
+    if (!reader)
+        return;
+
+    netdata_socket_idx_t key;
+    void *key_ptr;
+    netdata_socket_t *values;
 
     int maps_per_core = em->maps_per_core;
     int fd = em->maps[NETDATA_SOCKET_OPEN_SOCKET].map_fd;
+    int end = (maps_per_core) ? ebpf_nprocs : 1;
 
-    netdata_socket_t *values = socket_values;
-    size_t length = sizeof(netdata_socket_t);
-    int ret, end;
-    if (maps_per_core) {
-        length *= ebpf_nprocs;
-        end = ebpf_nprocs;
-    } else
-        end = 1;
-
-    // We need to reset the values when we are working on kernel 4.15 or newer, because kernel does not create
-    // values for specific processor unless it is used to store data. As result of this behavior one the next socket
-    // can have values from the previous one.
-    memset(values, 0, length);
     time_t update_time = time(NULL);
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, &key_ptr, (void **)&values)) {
         if (ebpf_plugin_stop())
             break;
 
-        ret = bpf_map_lookup_elem(fd, &key, values);
+        memcpy(&key, key_ptr, sizeof(key));
         bool deleted = true;
-        if (ret < 0) {
-            goto end_socket_loop;
-        }
 
         if (key.pid > (uint32_t)pid_max) {
             goto end_socket_loop;
@@ -1914,10 +1900,73 @@ static void ebpf_update_array_vectors(ebpf_module_t *em)
         // socket entries in the kernel map and we'd re-iterate them forever.
         if (deleted)
             bpf_map_delete_elem(fd, &key);
-        memset(values, 0, length);
-        memcpy(&key, &next_key, sizeof(key));
     }
+    ebpf_map_reader_end(reader);
+}
+
+/**
+ * Retire Socket
+ *
+ * Apply the final counters of a closed socket and remove it from the tables, instead of
+ * waiting for a scan that does not see it updated.
+ *
+ * @param record the ebpf_socket_close_event_t written by kernel.
+ * @param data   a pointer to the file descriptor of the socket table.
+ */
+static void ebpf_socket_retire(void *record, void *data)
+{
+    ebpf_socket_close_event_t *ev = record;
+    int fd = *(int *)data;
+    uint32_t pid = ev->idx.pid;
+
+    rw_spinlock_write_lock(&ebpf_judy_pid.index.rw_spinlock);
+    Pvoid_t *pid_value = JudyLGet(ebpf_judy_pid.index.JudyLArray, (Word_t)pid, PJE0);
+    if (pid_value) {
+        netdata_ebpf_judy_pid_stats_t *pid_ptr = *pid_value;
+
+        rw_spinlock_write_lock(&pid_ptr->socket_stats.rw_spinlock);
+        Pvoid_t *socket_value = JudyLGet(pid_ptr->socket_stats.JudyLArray, ev->data.first_timestamp, PJE0);
+        if (socket_value) {
+            aral_freez(aral_socket_table, *socket_value);
+            JudyLDel(&pid_ptr->socket_stats.JudyLArray, ev->data.first_timestamp, PJE0);
+        }
+        rw_spinlock_write_unlock(&pid_ptr->socket_stats.rw_spinlock);
+    }
+    rw_spinlock_write_unlock(&ebpf_judy_pid.index.rw_spinlock);
+
+    ebpf_socket_publish_apps_t final;
+    ebpf_socket_fill_publish_apps(&final, &ev->data);
+    ebpf_apps_retire_socket(pid, &final);
+
+    // The process may be publishing the counters of this socket. The scan that follows
+    // the drain publishes the sockets still open.
+    netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_lookup_shm_pointer_unsafe(pid);
+    if (local_pid && (local_pid->threads & (1U << (NETDATA_EBPF_PIDS_SOCKET_IDX << 1)))) {
+        netdata_ebpf_reset_shm_pointer_unsafe(fd, pid, NETDATA_EBPF_PIDS_SOCKET_IDX);
+        memset(&local_pid->socket, 0, sizeof(local_pid->socket));
+    }
+
+    bpf_map_delete_elem(fd, &ev->idx);
 }
+
+/**
+ * Drain socket events
+ *
+ * Retire the sockets closed since the last iteration.
+ *
+ * @param em the structure with configuration
+ */
+static void ebpf_socket_drain_events(ebpf_module_t *em)
+{
+    if (!socket_events)
+        return;
+
+    int fd = em->maps[NETDATA_SOCKET_OPEN_SOCKET].map_fd;
+    netdata_mutex_lock(&collect_data_mutex);
+    ebpf_event_stream_drain(socket_events, ebpf_socket_retire, &fd);
+    netdata_mutex_unlock(&collect_data_mutex);
+}
+
 /**
  * Resume apps data
  */
@@ -1936,7 +1985,7 @@ void ebpf_socket_resume_apps_data()
         struct ebpf_pid_on_target *move = w->root_pid;
 
         ebpf_socket_publish_apps_t *values = &w->socket;
-        memset(&w->socket, 0, sizeof(ebpf_socket_publish_apps_t));
+        memcpy(&w->socket, &w->closed_socket, sizeof(ebpf_socket_publish_apps_t));
         for (; move; move = move->next) {
             uint32_t pid = move->pid;
             netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_lookup_shm_pointer_unsafe(pid);
@@ -1945,15 +1994,15 @@ void ebpf_socket_resume_apps_data()
 
             ebpf_socket_publish_apps_t *ws = &local_pid->socket;
 
-            values->call_tcp_v4_connection = ws->call_tcp_v4_connection;
-            values->call_tcp_v6_connection = ws->call_tcp_v6_connection;
-            values->bytes_sent = ws->bytes_sent;
-            values->bytes_received = ws->bytes_received;
-            values->call_tcp_sent = ws->call_tcp_sent;
-            values->call_tcp_received = ws->call_tcp_received;
-            values->retransmit = ws->retransmit;
-            values->call_udp_sent = ws->call_udp_sent;
-            values->call_udp_received = ws->call_udp_received;
+            values->call_tcp_v4_connection += ws->call_tcp_v4_connection;
+            values->call_tcp_v6_connection += ws->call_tcp_v6_connection;
+            values->bytes_sent += ws->bytes_sent;
+            values->bytes_received += ws->bytes_received;
+            values->call_tcp_sent += ws->call_tcp_sent;
+            values->call_tcp_received += ws->call_tcp_received;
+            values->retransmit += ws->retransmit;
+            values->call_udp_sent += ws->call_udp_sent;
+            values->call_udp_received += ws->call_udp_received;
         }
     }
     netdata_mutex_unlock(&collect_data_mutex);
@@ -2011,13 +2060,33 @@ void ebpf_read_socket_thread(void *ptr)
 {
     ebpf_module_t *em = (ebpf_module_t *)ptr;
 
-    ebpf_update_array_vectors(em);
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(
+        em->info.thread_name,
+        em->maps[NETDATA_SOCKET_OPEN_SOCKET].name,
+        em->maps[NETDATA_SOCKET_OPEN_SOCKET].map_fd,
+        false);
+
+    if (reader && em->lifecycle_events && (em->apps_charts || em->cgroup_charts)) {
+        struct bpf_object *obj = em->objects;
+#ifdef LIBBPF_MAJOR_VERSION
+        if (!(em->load & EBPF_LOAD_LEGACY) && socket_bpf_obj)
+            obj = socket_bpf_obj->obj;
+#endif
+        socket_events = ebpf_event_stream_create(
+            em->info.thread_name, obj, NETDATA_SOCKET_EVENTS_TABLE, sizeof(ebpf_socket_close_event_t));
+    }
+
+    ebpf_update_array_vectors(em, reader);
 
     int update_every = em->update_every;
     int counter = update_every - 1;
     int collect_pid = (em->apps_charts || em->cgroup_charts);
-    if (!collect_pid)
+    if (!collect_pid) {
+        ebpf_event_stream_destroy(socket_events);
+        socket_events = NULL;
+        ebpf_map_reader_destroy(reader);
         return;
+    }
 
     uint32_t running_time = 0;
     uint32_t lifetime = em->lifetime;
@@ -2040,7 +2109,8 @@ void ebpf_read_socket_thread(void *ptr)
                 netdata_log_error("SOCKET: Failed to wait on semaphore.");
             break;
         }
-        ebpf_update_array_vectors(em);
+        ebpf_socket_drain_events(em);
+        ebpf_update_array_vectors(em, reader);
         ebpf_socket_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -2061,6 +2131,10 @@ void ebpf_read_socket_thread(void *ptr)
         if (ebpf_plugin_stop())
             break;
     }
+
+    ebpf_event_stream_destroy(socket_events);
+    socket_events = NULL;
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -2930,8 +3004,6 @@ static void ebpf_socket_initialize_global_vectors()
 
     aral_socket_table = ebpf_allocate_pid_aral(NETDATA_EBPF_SOCKET_ARAL_TABLE_NAME, sizeof(netdata_socket_plus_t));
 
-    socket_values = callocz((size_t)ebpf_nprocs, sizeof(netdata_socket_t));
-
     ebpf_load_addresses(&tcp_v6_connect_address, -1);
 }
 
@@ -291,6 +291,14 @@ typedef struct netdata_socket_idx {
     uint32_t pid;
 } netdata_socket_idx_t;
 
+// Ring buffer filled by kernel when a socket is closed, used when `lifecycle events` is enabled
+#define NETDATA_SOCKET_EVENTS_TABLE "tbl_nd_socket_events"
+
+typedef struct ebpf_socket_close_event {
+    netdata_socket_idx_t idx; // the key of the socket inside tbl_nd_socket
+    netdata_socket_t data;    // the final counters of the socket
+} ebpf_socket_close_event_t;
+
 extern ebpf_network_viewer_port_list_t *listen_ports;
 void update_listen_table(uint16_t value, uint16_t proto, netdata_passive_connection_t *values);
 void ebpf_fill_ip_list_unsafe(ebpf_network_viewer_ip_list_t **out, ebpf_network_viewer_ip_list_t *in, char *table);
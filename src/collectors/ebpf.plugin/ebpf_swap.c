@@ -11,7 +11,6 @@ static netdata_publish_syscall_t swap_publish_aggregated[NETDATA_SWAP_END];
 static netdata_idx_t swap_hash_values[NETDATA_SWAP_END];
 static netdata_idx_t *swap_values = NULL;
 
-netdata_ebpf_swap_t *swap_vector = NULL;
 
 struct config swap_config = APPCONFIG_INITIALIZER;
 
@@ -483,8 +482,6 @@ static void ebpf_swap_exit(void *pptr)
         return;
     }
 
-    freez(swap_vector);
-    swap_vector = NULL;
     freez(swap_values);
     swap_values = NULL;
 
@@ -608,30 +605,30 @@ void ebpf_swap_resume_apps_data(void)
  *
  * Read the apps table and store data inside the structure.
  *
+ * @param reader        the reader used to harvest the hash table.
  * @param maps_per_core do I need to read all cores?
  */
-static void ebpf_read_swap_apps_table(int maps_per_core)
+static void ebpf_read_swap_apps_table(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_ebpf_swap_t *cv = swap_vector;
+    if (!reader)
+        return;
+
+    netdata_ebpf_swap_t *cv;
+    uint32_t *key_ptr;
     int fd = swap_maps[NETDATA_PID_SWAP_TABLE].map_fd;
-    size_t length = sizeof(netdata_ebpf_swap_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&cv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, cv)) {
-            goto end_swap_loop;
-        }
+        uint32_t key = *key_ptr;
 
         swap_apps_accumulator(cv, maps_per_core);
 
         netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_SWAP_IDX);
         if (!local_pid)
-            goto end_swap_loop;
+            continue;
         netdata_publish_swap_t *publish = &local_pid->swap;
 
         if (!publish->ct || publish->ct != cv->ct) {
@@ -642,12 +639,8 @@ static void ebpf_read_swap_apps_table(int maps_per_core)
                     memset(publish, 0, sizeof(*publish));
             }
         }
-
-        // We are cleaning to avoid passing data read from one process to other.
-    end_swap_loop:
-        memset(cv, 0, length);
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -675,6 +668,8 @@ void ebpf_read_swap_thread(void *ptr)
     uint32_t running_time = 0;
     int cgroups = em->cgroup_charts;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_SWAP_IDX, swap_maps[NETDATA_PID_SWAP_TABLE].map_fd);
+    ebpf_local_maps_t *pid_map = &swap_maps[NETDATA_PID_SWAP_TABLE];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
 
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
@@ -694,7 +689,7 @@ void ebpf_read_swap_thread(void *ptr)
                 netdata_log_error("SWAP: Failed to wait on semaphore.");
             break;
         }
-        ebpf_read_swap_apps_table(maps_per_core);
+        ebpf_read_swap_apps_table(reader, maps_per_core);
         ebpf_swap_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -720,6 +715,8 @@ void ebpf_read_swap_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -1183,8 +1180,6 @@ void ebpf_swap_create_apps_charts(struct ebpf_module *em, void *ptr)
  */
 static void ebpf_swap_allocate_global_vectors(void)
 {
-    swap_vector = callocz((size_t)ebpf_nprocs, sizeof(netdata_ebpf_swap_t));
-
     swap_values = callocz((size_t)ebpf_nprocs, sizeof(netdata_idx_t));
 
     memset(swap_hash_values, 0, sizeof(swap_hash_values));
@@ -8,8 +8,12 @@
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
 #include "libbpf_api/ebpf_library.h"
 #include "ebpf.h"
+#include "ebpf_process.h"
 #include "ebpf_socket.h"
 
 extern uint32_t integration_with_collectors;
@@ -113,6 +117,156 @@ int ebpf_ut_load_fake_binary()
     return !ret;
 }
 
+#define EBPF_UT_STORM_CHILDREN 256
+#define EBPF_UT_STORM_TIMEOUT_MS 5000
+
+struct ebpf_ut_storm {
+    pid_t pids[EBPF_UT_STORM_CHILDREN];
+    bool exited[EBPF_UT_STORM_CHILDREN];
+    int children;
+    int seen;
+};
+
+/**
+ * Storm exit
+ *
+ * Mark the children of the storm that kernel reported as released.
+ *
+ * @param record the ebpf_process_exit_event_t written by kernel.
+ * @param data   the storm.
+ */
+static void ebpf_ut_storm_exit(void *record, void *data)
+{
+    ebpf_process_exit_event_t *ev = record;
+    struct ebpf_ut_storm *storm = data;
+
+    int i;
+    for (i = 0; i < storm->children; i++) {
+        uint32_t pid = (uint32_t)storm->pids[i];
+        if (storm->exited[i] || (pid != ev->stat.pid && pid != ev->stat.tgid))
+            continue;
+
+        storm->exited[i] = true;
+        storm->seen++;
+        break;
+    }
+}
+
+/**
+ * Fork and connect storm
+ *
+ * Fork children that connect to a local listener and exit at once.
+ *
+ * @param storm the structure that keeps the children.
+ *
+ * @return It returns 0 on success and -1 otherwise.
+ */
+static int ebpf_ut_fork_connect_storm(struct ebpf_ut_storm *storm)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK), .sin_port = 0};
+    socklen_t len = sizeof(addr);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0)
+        return -1;
+
+    if (bind(listener, (struct sockaddr *)&addr, len) || listen(listener, EBPF_UT_STORM_CHILDREN) ||
+        getsockname(listener, (struct sockaddr *)&addr, &len)) {
+        close(listener);
+        return -1;
+    }
+
+    int i;
+    for (i = 0; i < EBPF_UT_STORM_CHILDREN; i++) {
+        pid_t pid = fork();
+        if (pid < 0)
+            break;
+
+        if (!pid) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            int ret = (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr))) ? 1 : 0;
+            _exit(ret);
+        }
+
+        storm->pids[storm->children++] = pid;
+    }
+
+    // accept what the children connected, a child that failed must not block us
+    struct pollfd pfd = {.fd = listener, .events = POLLIN};
+    int accepted = 0;
+    while (accepted < storm->children && poll(&pfd, 1, 1000) > 0) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            break;
+        close(fd);
+        accepted++;
+    }
+    close(listener);
+
+    int failed = 0;
+    for (i = 0; i < storm->children; i++) {
+        int status;
+        if (waitpid(storm->pids[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+            failed++;
+    }
+
+    fprintf(
+        stderr,
+        "Storm: %d children forked, %d connections accepted, %d children failed.\n",
+        storm->children,
+        accepted,
+        failed);
+
+    return (storm->children == EBPF_UT_STORM_CHILDREN && !failed) ? 0 : -1;
+}
+
+/**
+ * Lifecycle events
+ *
+ * Load the process binary, fork and connect a storm of children and check kernel reported the
+ * exit of every one of them through the ring buffer. When the binary does not have the ring
+ * buffer, the test is skipped.
+ *
+ * @return It returns 0 on success and -1 otherwise.
+ */
+int ebpf_ut_lifecycle_storm()
+{
+    test_em.probe_links = ebpf_load_program(ebpf_plugin_dir, &test_em, running_on_kernel, isrh, &test_em.objects);
+    if (!test_em.probe_links)
+        return -1;
+
+    ebpf_event_stream_t *stream = ebpf_event_stream_create(
+        test_em.info.thread_name,
+        test_em.objects,
+        NETDATA_PROCESS_EVENTS_TABLE,
+        sizeof(ebpf_process_exit_event_t));
+    if (!stream) {
+        fprintf(stderr, "Storm: the binary does not have lifecycle events, skipping.\n");
+        ebpf_unload_legacy_code(test_em.objects, test_em.probe_links);
+        return 0;
+    }
+
+    struct ebpf_ut_storm *storm = callocz(1, sizeof(*storm));
+    int ret = ebpf_ut_fork_connect_storm(storm);
+
+    int waited;
+    for (waited = 0; storm->seen < storm->children && waited < EBPF_UT_STORM_TIMEOUT_MS; waited += 10) {
+        ebpf_event_stream_drain(stream, ebpf_ut_storm_exit, storm);
+        sleep_usec(10 * USEC_PER_MS);
+    }
+    ebpf_event_stream_drain(stream, ebpf_ut_storm_exit, storm);
+
+    fprintf(stderr, "Storm: %d of %d exits received.\n", storm->seen, storm->children);
+    if (storm->seen != storm->children)
+        ret = -1;
+
+    freez(storm);
+    ebpf_event_stream_destroy(stream);
+    ebpf_unload_legacy_code(test_em.objects, test_em.probe_links);
+
+    return ret;
+}
+
 /**
  * Test write_chart_dimension
  *
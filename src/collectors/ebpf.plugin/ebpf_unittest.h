@@ -6,6 +6,7 @@
 void ebpf_ut_initialize_structure(netdata_run_mode_t mode);
 int ebpf_ut_load_real_binary();
 int ebpf_ut_load_fake_binary();
+int ebpf_ut_lifecycle_storm();
 void ebpf_ut_cleanup_memory();
 void ebpf_library_run_unittests(void);
 #endif
@@ -12,7 +12,6 @@ static char *vfs_id_names[NETDATA_KEY_PUBLISH_VFS_END] =
 static netdata_idx_t *vfs_hash_values = NULL;
 static netdata_syscall_stat_t vfs_aggregated_data[NETDATA_KEY_PUBLISH_VFS_END];
 static netdata_publish_syscall_t vfs_publish_aggregated[NETDATA_KEY_PUBLISH_VFS_END];
-netdata_ebpf_vfs_t *vfs_vector = NULL;
 
 static ebpf_local_maps_t vfs_maps[] = {
     {.name = "tbl_vfs_pid",
@@ -1247,35 +1246,17 @@ static void vfs_apps_accumulator(netdata_ebpf_vfs_t *out, int maps_per_core)
     netdata_ebpf_vfs_t *total = &out[0];
     uint64_t ct = total->ct;
 
+    // counters are stored in three runs: calls, bytes and errors
+    ebpf_sum_percpu_u32(out, sizeof(*out), offsetof(netdata_ebpf_vfs_t, write_call), 8, end);
+    ebpf_sum_percpu_u64(out, sizeof(*out), offsetof(netdata_ebpf_vfs_t, write_bytes), 4, end);
+    ebpf_sum_percpu_u32(out, sizeof(*out), offsetof(netdata_ebpf_vfs_t, write_err), 8, end);
+
     for (i = 1; i < end; i++) {
         if (ebpf_plugin_stop())
             break;
 
         netdata_ebpf_vfs_t *w = &out[i];
 
-        total->write_bytes += w->write_bytes;
-        total->writev_bytes += w->writev_bytes;
-        total->readv_bytes += w->readv_bytes;
-        total->read_bytes += w->read_bytes;
-
-        total->write_call += w->write_call;
-        total->writev_call += w->writev_call;
-        total->read_call += w->read_call;
-        total->readv_call += w->readv_call;
-        total->unlink_call += w->unlink_call;
-        total->fsync_call += w->fsync_call;
-        total->open_call += w->open_call;
-        total->create_call += w->create_call;
-
-        total->write_err += w->write_err;
-        total->writev_err += w->writev_err;
-        total->read_err += w->read_err;
-        total->readv_err += w->readv_err;
-        total->unlink_err += w->unlink_err;
-        total->fsync_err += w->fsync_err;
-        total->open_err += w->open_err;
-        total->create_err += w->create_err;
-
         if (w->ct > ct)
             ct = w->ct;
 
@@ -1289,28 +1270,27 @@ static void vfs_apps_accumulator(netdata_ebpf_vfs_t *out, int maps_per_core)
 /**
  * Read the hash table and store data to allocated vectors.
  */
-static void ebpf_vfs_read_apps(int maps_per_core)
+static void ebpf_vfs_read_apps(ebpf_map_reader_t *reader, int maps_per_core)
 {
-    netdata_ebpf_vfs_t *vv = vfs_vector;
+    if (!reader)
+        return;
+
+    netdata_ebpf_vfs_t *vv;
+    uint32_t *key_ptr;
     int fd = vfs_maps[NETDATA_VFS_PID].map_fd;
-    size_t length = sizeof(netdata_ebpf_vfs_t);
-    if (maps_per_core)
-        length *= ebpf_nprocs;
 
-    uint32_t key = 0, next_key = 0;
-    while (bpf_map_get_next_key(fd, &key, &next_key) == 0) {
+    ebpf_map_reader_begin(reader);
+    while (ebpf_map_reader_next(reader, (void **)&key_ptr, (void **)&vv)) {
         if (ebpf_plugin_stop())
             break;
 
-        if (bpf_map_lookup_elem(fd, &key, vv) != 0) {
-            goto end_vfs_loop;
-        }
+        uint32_t key = *key_ptr;
 
         vfs_apps_accumulator(vv, maps_per_core);
 
         netdata_ebpf_pid_stats_t *local_pid = netdata_ebpf_get_shm_pointer_unsafe(key, NETDATA_EBPF_PIDS_VFS_IDX);
         if (!local_pid)
-            goto end_vfs_loop;
+            continue;
         netdata_publish_vfs_t *publish = &local_pid->vfs;
 
         if (!publish->ct || publish->ct != vv->ct) {
@@ -1321,12 +1301,8 @@ static void ebpf_vfs_read_apps(int maps_per_core)
                     memset(publish, 0, sizeof(*publish));
             }
         }
-
-    end_vfs_loop:
-        // We are cleaning to avoid passing data read from one process to other.
-        memset(vv, 0, length);
-        key = next_key;
     }
+    ebpf_map_reader_end(reader);
 }
 
 /**
@@ -2334,6 +2310,8 @@ void ebpf_read_vfs_thread(void *ptr)
     int cgroups = em->cgroup_charts;
     uint32_t running_time = 0;
     ebpf_set_pid_map_fd(NETDATA_EBPF_PIDS_VFS_IDX, vfs_maps[NETDATA_VFS_PID].map_fd);
+    ebpf_local_maps_t *pid_map = &vfs_maps[NETDATA_VFS_PID];
+    ebpf_map_reader_t *reader = ebpf_map_reader_create(em->info.thread_name, pid_map->name, pid_map->map_fd, false);
     heartbeat_t hb;
     heartbeat_init(&hb, USEC_PER_SEC);
     while (!ebpf_plugin_stop() && running_time < lifetime) {
@@ -2352,7 +2330,7 @@ void ebpf_read_vfs_thread(void *ptr)
                 netdata_log_error("VFS: Failed to wait on semaphore.");
             break;
         }
-        ebpf_vfs_read_apps(maps_per_core);
+        ebpf_vfs_read_apps(reader, maps_per_core);
         ebpf_vfs_resume_apps_data();
         if (ebpf_plugin_stop()) {
             if (sem_post(shm_mutex_ebpf_integration))
@@ -2378,6 +2356,8 @@ void ebpf_read_vfs_thread(void *ptr)
         em->running_time = running_time;
         netdata_mutex_unlock(&ebpf_exit_cleanup);
     }
+
+    ebpf_map_reader_destroy(reader);
 }
 
 /**
@@ -2900,8 +2880,6 @@ void ebpf_vfs_create_apps_charts(struct ebpf_module *em, void *ptr)
  */
 static void ebpf_vfs_allocate_global_vectors()
 {
-    vfs_vector = callocz(ebpf_nprocs, sizeof(netdata_ebpf_vfs_t));
-
     memset(vfs_aggregated_data, 0, sizeof(vfs_aggregated_data));
     memset(vfs_publish_aggregated, 0, sizeof(vfs_publish_aggregated));
 
@@ -1385,9 +1385,14 @@ void ebpf_update_module_using_config(
     if (kver < NETDATA_EBPF_KERNEL_4_06)
         modules->maps_per_core = CONFIG_BOOLEAN_NO;
 
+    modules->lifecycle_events =
+        inicfg_get_boolean(modules->cfg, EBPF_GLOBAL_SECTION, EBPF_CFG_LIFECYCLE_EVENTS, modules->lifecycle_events);
+    if (kver < NETDATA_EBPF_KERNEL_5_8)
+        modules->lifecycle_events = CONFIG_BOOLEAN_NO;
+
 #ifdef NETDATA_DEV_MODE
     collector_info(
-        "The thread %s was configured with: mode = %s; update every = %d; apps = %s; cgroup = %s; ebpf type format = %s; ebpf co-re tracing = %s; collect pid = %s; maps per core = %s, lifetime=%u",
+        "The thread %s was configured with: mode = %s; update every = %d; apps = %s; cgroup = %s; ebpf type format = %s; ebpf co-re tracing = %s; collect pid = %s; maps per core = %s, lifecycle events = %s, lifetime=%u",
         modules->info.thread_name,
         load_mode,
         modules->update_every,
@@ -1397,6 +1402,7 @@ void ebpf_update_module_using_config(
         core_attach,
         collect_pid,
         (modules->maps_per_core) ? "enabled" : "disabled",
+        (modules->lifecycle_events) ? "enabled" : "disabled",
         modules->lifetime);
 #endif
 }
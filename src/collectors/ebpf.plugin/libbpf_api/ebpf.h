@@ -43,6 +43,7 @@
 #define EBPF_CFG_PROGRAM_PATH "btf path"
 
 #define EBPF_CFG_MAPS_PER_CORE "maps per core"
+#define EBPF_CFG_LIFECYCLE_EVENTS "lifecycle events"
 
 #define EBPF_CFG_UPDATE_EVERY "update every"
 #define EBPF_CFG_LIFETIME "lifetime"
@@ -91,6 +92,7 @@ enum netdata_ebpf_kernel_versions {
     NETDATA_EBPF_KERNEL_5_3 = 328448,    //  327680 = 5 * 65536 +  3 * 256
     NETDATA_EBPF_KERNEL_5_4 = 328704,    //  327680 = 5 * 65536 +  4 * 256
     NETDATA_EBPF_KERNEL_5_5 = 328960,    //  327680 = 5 * 65536 +  5 * 256
+    NETDATA_EBPF_KERNEL_5_8 = 329728,    //  329728 = 5 * 65536 +  8 * 256
     NETDATA_EBPF_KERNEL_5_9_16 = 330000, //  330240 = 5 * 65536 + 9 * 256 + 16
     NETDATA_EBPF_KERNEL_5_10 = 330240,   //  330240 = 5 * 65536 + 10 * 256
     NETDATA_EBPF_KERNEL_5_11 = 330496,   //  330240 = 5 * 65536 + 11 * 256
@@ -357,6 +359,7 @@ typedef struct ebpf_module {
     char memory_usage[NETDATA_EBPF_CHART_MEM_LENGTH];
     char memory_allocations[NETDATA_EBPF_CHART_MEM_LENGTH];
     int maps_per_core;
+    int lifecycle_events; // consume process exit and socket close events from BPF ring buffers
 
     // period to run
     uint32_t running_time; // internal usage, this is used to reset a value when a new request happens.
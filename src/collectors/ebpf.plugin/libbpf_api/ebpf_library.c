@@ -1329,6 +1329,648 @@ void ebpf_read_global_table_stats(
     }
 }
 
+/*****************************************************************
+ *
+ *  FUNCTIONS TO READ HASH TABLES IN BATCHES
+ *
+ *****************************************************************/
+
+#define EBPF_MAP_READER_BATCH_KEYS 1024U
+#define EBPF_MAP_READER_BATCH_BYTES (8U * 1024U * 1024U)
+#define EBPF_MAP_READER_MAX_BATCH_KEYS 65536U
+
+// not exported to user space, but returned by kernels without batch support for a map type
+#ifndef ENOTSUPP
+#define ENOTSUPP 524
+#endif
+
+struct ebpf_map_reader {
+    char dimension[NETDATA_EBPF_MAP_READER_NAME_LENGTH];
+
+    int fd;
+    uint32_t key_size;
+    uint32_t value_size;  // the bytes of all the values of a key (all cores for per-core maps)
+    uint32_t token_size;  // the bytes of the batch position kept by the kernel
+    uint32_t batch_keys;  // the keys requested per call
+    bool destructive;     // delete the keys while reading them
+    bool fallback;        // the kernel cannot read this map in batches
+
+    void *keys;
+    void *values;
+    void *in_batch;
+    void *out_batch; // the next batch position, or the next key when we iterate the map
+    bool has_next;
+
+    // the current pass
+    uint32_t count;
+    uint32_t position;
+    bool first;
+    bool last;
+    usec_t started_ut;
+    uint64_t pass_keys;
+    uint64_t pass_syscalls;
+
+    // cumulative statistics, read by the main thread
+    uint64_t read_ut;
+    uint64_t read_keys;
+    uint64_t syscalls;
+
+    struct ebpf_map_reader *prev, *next;
+};
+
+static struct {
+    SPINLOCK spinlock;
+    uint32_t version; // changes every time a reader is added or removed
+    struct ebpf_map_reader *base;
+} ebpf_map_readers = {
+    .spinlock = SPINLOCK_INITIALIZER,
+    .version = 0,
+    .base = NULL,
+};
+
+/**
+ * Is Percpu Map
+ *
+ * @param type the map type reported by kernel.
+ *
+ * @return It returns true when kernel stores one value per core for each key.
+ */
+static inline bool ebpf_map_reader_is_percpu(uint32_t type)
+{
+    return type == BPF_MAP_TYPE_PERCPU_HASH || type == BPF_MAP_TYPE_PERCPU_ARRAY ||
+           type == BPF_MAP_TYPE_LRU_PERCPU_HASH;
+}
+
+/**
+ * Create Map Reader
+ *
+ * Allocate the buffers used to read a map. Key and value sizes are requested from kernel, so
+ * per-core maps get room for all possible cores, even when some of them are offline.
+ *
+ * @param thread_name the thread reading the map, used to name the statistic dimension.
+ * @param map_name    the map name.
+ * @param map_fd      the map file descriptor.
+ * @param destructive delete the keys as they are read?
+ *
+ * @return It returns a new reader on success and NULL otherwise.
+ */
+ebpf_map_reader_t *
+ebpf_map_reader_create(const char *thread_name, const char *map_name, int map_fd, bool destructive)
+{
+    if (map_fd < 0)
+        return NULL;
+
+    struct bpf_map_info info = {};
+    uint32_t info_len = sizeof(info);
+    if (bpf_obj_get_info_by_fd(map_fd, &info, &info_len)) {
+        netdata_log_error("Cannot get information for map %s: %s", map_name, strerror(errno));
+        return NULL;
+    }
+
+    ebpf_map_reader_t *r = callocz(1, sizeof(*r));
+    snprintfz(r->dimension, sizeof(r->dimension) - 1, "%s_%s", thread_name, map_name);
+    r->fd = map_fd;
+    r->key_size = info.key_size;
+    r->destructive = destructive;
+
+    if (ebpf_map_reader_is_percpu(info.type)) {
+        int cores = libbpf_num_possible_cpus();
+        if (cores < ebpf_nprocs)
+            cores = ebpf_nprocs;
+
+        // kernel aligns the value of every core to 8 bytes
+        r->value_size = ((info.value_size + 7U) & ~7U) * (uint32_t)cores;
+    } else
+        r->value_size = info.value_size;
+
+    // hash tables keep a bucket index, arrays keep a key
+    r->token_size = MAX(r->key_size, (uint32_t)sizeof(uint64_t));
+
+    uint32_t batch = EBPF_MAP_READER_BATCH_BYTES / MAX(r->value_size + r->key_size, 1U);
+    batch = MIN(batch, EBPF_MAP_READER_BATCH_KEYS);
+    if (info.max_entries)
+        batch = MIN(batch, info.max_entries);
+    r->batch_keys = MAX(batch, 16U);
+
+    r->keys = mallocz((size_t)r->batch_keys * r->key_size);
+    r->values = mallocz((size_t)r->batch_keys * r->value_size);
+    r->in_batch = callocz(1, r->token_size);
+    r->out_batch = callocz(1, r->token_size);
+
+    spinlock_lock(&ebpf_map_readers.spinlock);
+    DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(ebpf_map_readers.base, r, prev, next);
+    ebpf_map_readers.version++;
+    spinlock_unlock(&ebpf_map_readers.spinlock);
+
+    return r;
+}
+
+/**
+ * Destroy Map Reader
+ *
+ * @param r the reader to release.
+ */
+void ebpf_map_reader_destroy(ebpf_map_reader_t *r)
+{
+    if (!r)
+        return;
+
+    spinlock_lock(&ebpf_map_readers.spinlock);
+    DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(ebpf_map_readers.base, r, prev, next);
+    ebpf_map_readers.version++;
+    spinlock_unlock(&ebpf_map_readers.spinlock);
+
+    freez(r->keys);
+    freez(r->values);
+    freez(r->in_batch);
+    freez(r->out_batch);
+    freez(r);
+}
+
+/**
+ * Begin Pass
+ *
+ * Start reading the map from its first key.
+ *
+ * @param r the reader.
+ */
+void ebpf_map_reader_begin(ebpf_map_reader_t *r)
+{
+    r->count = 0;
+    r->position = 0;
+    r->first = true;
+    r->last = false;
+    r->has_next = false;
+    r->pass_keys = 0;
+    r->pass_syscalls = 0;
+    r->started_ut = now_monotonic_usec();
+}
+
+/**
+ * End Pass
+ *
+ * Account the time spent reading the map. It must be called even when the caller stopped before
+ * reading all keys.
+ *
+ * @param r the reader.
+ */
+void ebpf_map_reader_end(ebpf_map_reader_t *r)
+{
+    __atomic_add_fetch(&r->read_ut, now_monotonic_usec() - r->started_ut, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&r->read_keys, r->pass_keys, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&r->syscalls, r->pass_syscalls, __ATOMIC_RELAXED);
+}
+
+/**
+ * Fill with next key
+ *
+ * Read the map one key at a time, the way kernels without batch operations allow. We always know
+ * the key that follows the current one before the caller gets it, so the caller can delete the
+ * current key without breaking the iteration.
+ *
+ * @param r the reader.
+ *
+ * @return It returns true when a key was read.
+ */
+static bool ebpf_map_reader_fill_one(ebpf_map_reader_t *r)
+{
+    while (true) {
+        if (r->first) {
+            r->first = false;
+            r->pass_syscalls++;
+            if (bpf_map_get_next_key(r->fd, NULL, r->out_batch)) {
+                // kernels older than 4.12 do not accept a NULL key
+                if (errno != EFAULT && errno != EINVAL)
+                    return false;
+
+                memset(r->keys, 0, r->key_size);
+                r->pass_syscalls++;
+                if (bpf_map_get_next_key(r->fd, r->keys, r->out_batch))
+                    return false;
+            }
+        } else if (!r->has_next)
+            return false;
+
+        memcpy(r->keys, r->out_batch, r->key_size);
+
+        r->pass_syscalls += 2;
+        r->has_next = !bpf_map_get_next_key(r->fd, r->keys, r->out_batch);
+        if (bpf_map_lookup_elem(r->fd, r->keys, r->values))
+            continue; // removed by kernel meanwhile
+
+        if (r->destructive) {
+            r->pass_syscalls++;
+            bpf_map_delete_elem(r->fd, r->keys);
+        }
+
+        r->count = 1;
+        r->position = 0;
+        return true;
+    }
+}
+
+/**
+ * Fill with next batch
+ *
+ * @param r the reader.
+ *
+ * @return It returns true when keys were read.
+ */
+static bool ebpf_map_reader_fill_batch(ebpf_map_reader_t *r)
+{
+    while (true) {
+        uint32_t count = r->batch_keys;
+        void *in_batch = (r->first) ? NULL : r->in_batch;
+
+        int ret = (r->destructive) ?
+                      bpf_map_lookup_and_delete_batch(r->fd, in_batch, r->out_batch, r->keys, r->values, &count, NULL) :
+                      bpf_map_lookup_batch(r->fd, in_batch, r->out_batch, r->keys, r->values, &count, NULL);
+        r->pass_syscalls++;
+
+        int err = (ret < 0) ? errno : 0;
+        if (!ret || err == ENOENT) {
+            // ENOENT is the end of the map, the last keys may come with it
+            r->first = false;
+            r->last = (err == ENOENT);
+            r->count = count;
+            r->position = 0;
+            memcpy(r->in_batch, r->out_batch, r->token_size);
+            return count > 0 || !r->last;
+        }
+
+        if (err == ENOSPC && r->batch_keys < EBPF_MAP_READER_MAX_BATCH_KEYS) {
+            // a hash bucket has more keys than we asked for
+            r->batch_keys *= 2;
+            r->keys = reallocz(r->keys, (size_t)r->batch_keys * r->key_size);
+            r->values = reallocz(r->values, (size_t)r->batch_keys * r->value_size);
+            continue;
+        }
+
+        if (r->first && (err == EINVAL || err == ENOTSUPP || err == EOPNOTSUPP || err == ENOSYS)) {
+            netdata_log_info("Kernel cannot read map %s in batches, reading it one key at a time.", r->dimension);
+            r->fallback = true;
+            return ebpf_map_reader_fill_one(r);
+        }
+
+        netdata_log_error("Cannot read map %s: %s", r->dimension, strerror(err));
+        r->last = true;
+        return false;
+    }
+}
+
+/**
+ * Next Key
+ *
+ * Give the next key of the map and its values. The pointers are valid until the next call.
+ *
+ * @param r      the reader.
+ * @param key    the key read.
+ * @param values the values of the key, one per core for per-core maps.
+ *
+ * @return It returns false when all keys were read.
+ */
+bool ebpf_map_reader_next(ebpf_map_reader_t *r, void **key, void **values)
+{
+    while (r->position >= r->count) {
+        bool filled = (r->fallback) ? ebpf_map_reader_fill_one(r) : (!r->last && ebpf_map_reader_fill_batch(r));
+        if (!filled)
+            return false;
+    }
+
+    *key = (char *)r->keys + (size_t)r->position * r->key_size;
+    *values = (char *)r->values + (size_t)r->position * r->value_size;
+    r->position++;
+    r->pass_keys++;
+
+    return true;
+}
+
+/**
+ * Value Size
+ *
+ * @param r the reader.
+ *
+ * @return It returns the bytes of the values of a key, for all cores on per-core maps.
+ */
+size_t ebpf_map_reader_value_size(ebpf_map_reader_t *r)
+{
+    return r->value_size;
+}
+
+/**
+ * Create Map Reader Charts
+ *
+ * (Re)define the charts with one dimension per reader.
+ *
+ * @param update_every time used to update charts
+ */
+static void ebpf_map_reader_create_charts(int update_every)
+{
+    static const struct {
+        char *id;
+        char *title;
+        char *units;
+        int order;
+    } charts[] = {
+        {NETDATA_EBPF_HASH_TABLES_READ_TIME,
+         "Time spent reading hash tables",
+         "microseconds/s",
+         NETDATA_EBPF_ORDER_STAT_HASH_READ_TIME},
+        {NETDATA_EBPF_HASH_TABLES_READ_ELEMENTS,
+         "Elements read from hash tables",
+         "rows/s",
+         NETDATA_EBPF_ORDER_STAT_HASH_READ_ELEMENTS},
+        {NETDATA_EBPF_HASH_TABLES_READ_CALLS,
+         "System calls used to read hash tables",
+         "calls/s",
+         NETDATA_EBPF_ORDER_STAT_HASH_READ_CALLS},
+    };
+
+    size_t i;
+    for (i = 0; i < sizeof(charts) / sizeof(charts[0]); i++) {
+        ebpf_write_chart_cmd(
+            NETDATA_MONITORING_FAMILY,
+            charts[i].id,
+            "",
+            charts[i].title,
+            charts[i].units,
+            NETDATA_EBPF_FAMILY,
+            NETDATA_EBPF_CHART_TYPE_LINE,
+            NULL,
+            charts[i].order,
+            update_every,
+            NETDATA_EBPF_MODULE_NAME_PROCESS);
+
+        ebpf_map_reader_t *r;
+        for (r = ebpf_map_readers.base; r; r = r->next)
+            ebpf_write_global_dimension(r->dimension, r->dimension, ebpf_algorithms[NETDATA_EBPF_INCREMENTAL_IDX]);
+    }
+}
+
+/**
+ * Send Map Reader Statistics
+ *
+ * Write to standard output the time spent, the keys read and the system calls used by every reader.
+ *
+ * @param update_every time used to update charts
+ */
+void ebpf_map_reader_send_statistics(int update_every)
+{
+    static uint32_t defined_version = 0;
+
+    spinlock_lock(&ebpf_map_readers.spinlock);
+
+    if (defined_version != ebpf_map_readers.version) {
+        defined_version = ebpf_map_readers.version;
+        ebpf_map_reader_create_charts(update_every);
+    }
+
+    if (!defined_version) {
+        spinlock_unlock(&ebpf_map_readers.spinlock);
+        return;
+    }
+
+    ebpf_map_reader_t *r;
+    ebpf_write_begin_chart(NETDATA_MONITORING_FAMILY, NETDATA_EBPF_HASH_TABLES_READ_TIME, "");
+    for (r = ebpf_map_readers.base; r; r = r->next)
+        write_chart_dimension(r->dimension, (long long)__atomic_load_n(&r->read_ut, __ATOMIC_RELAXED));
+    ebpf_write_end_chart();
+
+    ebpf_write_begin_chart(NETDATA_MONITORING_FAMILY, NETDATA_EBPF_HASH_TABLES_READ_ELEMENTS, "");
+    for (r = ebpf_map_readers.base; r; r = r->next)
+        write_chart_dimension(r->dimension, (long long)__atomic_load_n(&r->read_keys, __ATOMIC_RELAXED));
+    ebpf_write_end_chart();
+
+    ebpf_write_begin_chart(NETDATA_MONITORING_FAMILY, NETDATA_EBPF_HASH_TABLES_READ_CALLS, "");
+    for (r = ebpf_map_readers.base; r; r = r->next)
+        write_chart_dimension(r->dimension, (long long)__atomic_load_n(&r->syscalls, __ATOMIC_RELAXED));
+    ebpf_write_end_chart();
+
+    spinlock_unlock(&ebpf_map_readers.spinlock);
+}
+
+/*****************************************************************
+ *
+ *  FUNCTIONS TO CONSUME RING BUFFERS
+ *
+ *****************************************************************/
+
+#define EBPF_EVENT_STREAM_INITIAL_RECORDS 1024U
+#define EBPF_EVENT_STREAM_MAX_RECORDS 65536U
+#define EBPF_EVENT_STREAM_POLL_MS 100
+
+struct ebpf_event_queue {
+    uint8_t *records;
+    size_t used;
+    size_t size;
+};
+
+struct ebpf_event_stream {
+    char name[NETDATA_EBPF_MAP_READER_NAME_LENGTH];
+    size_t record_size;
+
+    struct ring_buffer *rb;
+    ND_THREAD *thread;
+    bool stop;
+
+    // the consumer thread appends to queue, the collector swaps it with spare to drain it
+    SPINLOCK spinlock;
+    struct ebpf_event_queue queue;
+    struct ebpf_event_queue spare;
+
+    uint64_t dropped;
+    uint64_t reported_drops;
+};
+
+#ifdef LIBBPF_MAJOR_VERSION
+/**
+ * Store Event
+ *
+ * Callback given to libbpf, it copies one record of the ring buffer to the queue.
+ *
+ * @param ctx  the event stream.
+ * @param data the record inside the ring buffer.
+ * @param size the record size.
+ *
+ * @return It always returns 0, so libbpf keeps consuming the ring buffer.
+ */
+static int ebpf_event_stream_store(void *ctx, void *data, size_t size)
+{
+    ebpf_event_stream_t *s = ctx;
+
+    // a record we do not know how to parse
+    if (unlikely(size < s->record_size)) {
+        __atomic_add_fetch(&s->dropped, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    spinlock_lock(&s->spinlock);
+
+    struct ebpf_event_queue *q = &s->queue;
+    if (unlikely(q->used == q->size)) {
+        if (q->size >= EBPF_EVENT_STREAM_MAX_RECORDS) {
+            spinlock_unlock(&s->spinlock);
+            __atomic_add_fetch(&s->dropped, 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+
+        q->size = (q->size) ? q->size * 2 : EBPF_EVENT_STREAM_INITIAL_RECORDS;
+        q->records = reallocz(q->records, q->size * s->record_size);
+    }
+
+    memcpy(&q->records[q->used * s->record_size], data, s->record_size);
+    q->used++;
+
+    spinlock_unlock(&s->spinlock);
+
+    return 0;
+}
+
+/**
+ * Event Stream Thread
+ *
+ * Wait for records of the ring buffer until the stream or the plugin is stopped.
+ *
+ * @param ptr the event stream.
+ */
+static void ebpf_event_stream_thread(void *ptr)
+{
+    ebpf_event_stream_t *s = ptr;
+
+    while (!ebpf_plugin_stop() && !__atomic_load_n(&s->stop, __ATOMIC_RELAXED)) {
+        int ret = ring_buffer__poll(s->rb, EBPF_EVENT_STREAM_POLL_MS);
+        if (ret < 0 && ret != -EINTR) {
+            netdata_log_error("%s: cannot poll the ring buffer (error %d), lifecycle events stopped.", s->name, ret);
+            break;
+        }
+    }
+}
+#endif
+
+/**
+ * Create Event Stream
+ *
+ * Start consuming a ring buffer of a loaded eBPF object.
+ *
+ * @param thread_name the thread that will drain the events, used in messages.
+ * @param obj         the loaded eBPF object.
+ * @param map_name    the name of the ring buffer inside the object.
+ * @param record_size the size of the records written by kernel.
+ *
+ * @return It returns a new stream on success and NULL when the object does not have the ring buffer.
+ */
+ebpf_event_stream_t *
+ebpf_event_stream_create(const char *thread_name, struct bpf_object *obj, const char *map_name, size_t record_size)
+{
+#ifdef LIBBPF_MAJOR_VERSION
+    if (!obj || !record_size)
+        return NULL;
+
+    struct bpf_map *map = bpf_object__find_map_by_name(obj, map_name);
+    if (!map || bpf_map__type(map) != BPF_MAP_TYPE_RINGBUF || bpf_map__fd(map) < 0) {
+        netdata_log_info(
+            "%s: the eBPF program does not have the ring buffer %s, lifecycle events are disabled.",
+            thread_name,
+            map_name);
+        return NULL;
+    }
+
+    ebpf_event_stream_t *s = callocz(1, sizeof(*s));
+    snprintfz(s->name, sizeof(s->name) - 1, "%s_%s", thread_name, map_name);
+    s->record_size = record_size;
+    spinlock_init(&s->spinlock);
+
+    s->rb = ring_buffer__new(bpf_map__fd(map), ebpf_event_stream_store, s, NULL);
+    if (!s->rb) {
+        netdata_log_error("%s: cannot open the ring buffer %s, lifecycle events are disabled.", thread_name, map_name);
+        freez(s);
+        return NULL;
+    }
+
+    s->thread = nd_thread_create("EBPF_EVENTS", NETDATA_THREAD_OPTION_DEFAULT, ebpf_event_stream_thread, s);
+    if (!s->thread) {
+        ring_buffer__free(s->rb);
+        freez(s);
+        return NULL;
+    }
+
+    return s;
+#else
+    UNUSED(obj);
+    UNUSED(record_size);
+    netdata_log_info(
+        "%s: this libbpf cannot consume ring buffers, %s is not used and lifecycle events are disabled.",
+        thread_name,
+        map_name);
+    return NULL;
+#endif
+}
+
+/**
+ * Destroy Event Stream
+ *
+ * Stop the consumer thread and release the stream. Events not drained are discarded.
+ *
+ * @param s the stream, it can be NULL.
+ */
+void ebpf_event_stream_destroy(ebpf_event_stream_t *s)
+{
+    if (!s)
+        return;
+
+#ifdef LIBBPF_MAJOR_VERSION
+    __atomic_store_n(&s->stop, true, __ATOMIC_RELAXED);
+    nd_thread_join(s->thread);
+    ring_buffer__free(s->rb);
+#endif
+
+    freez(s->queue.records);
+    freez(s->spare.records);
+    freez(s);
+}
+
+/**
+ * Drain Event Stream
+ *
+ * Call the callback for every record queued since the last drain, in the order kernel wrote them.
+ * Only one thread can drain a stream.
+ *
+ * @param s    the stream, it can be NULL.
+ * @param cb   the function that applies one record.
+ * @param data the argument given to the callback.
+ *
+ * @return It returns the number of records drained.
+ */
+size_t ebpf_event_stream_drain(ebpf_event_stream_t *s, ebpf_event_stream_cb cb, void *data)
+{
+    if (!s)
+        return 0;
+
+    spinlock_lock(&s->spinlock);
+    struct ebpf_event_queue q = s->queue;
+    s->queue = s->spare;
+    spinlock_unlock(&s->spinlock);
+
+    size_t i;
+    for (i = 0; i < q.used; i++)
+        cb(&q.records[i * s->record_size], data);
+
+    size_t drained = q.used;
+    q.used = 0;
+    s->spare = q;
+
+    uint64_t dropped = __atomic_load_n(&s->dropped, __ATOMIC_RELAXED);
+    if (unlikely(dropped != s->reported_drops)) {
+        netdata_log_error(
+            "%s: %" PRIu64 " lifecycle events were dropped, the periodic scan of the tables will catch up.",
+            s->name,
+            dropped - s->reported_drops);
+        s->reported_drops = dropped;
+    }
+
+    return drained;
+}
+
 /**
  * Check if the ip is inside a IP range
  *
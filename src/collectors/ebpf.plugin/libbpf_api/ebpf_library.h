@@ -4,6 +4,8 @@
 #define NETDATA_COLLECTOR_EBPF_LIBRARY_H 1
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "../ebpf_socket_ipc.h"
 
 typedef struct netdata_publish_syscall netdata_publish_syscall_t;
@@ -143,6 +145,85 @@ void ebpf_read_global_table_stats(
     uint32_t begin,
     uint32_t end);
 
+/*****************************************************************
+ *
+ *  FUNCTIONS TO READ HASH TABLES IN BATCHES
+ *
+ *****************************************************************/
+
+#define NETDATA_EBPF_MAP_READER_NAME_LENGTH 64
+
+// Reads all keys of a map with BPF_MAP_LOOKUP_BATCH (or BPF_MAP_LOOKUP_AND_DELETE_BATCH), falling back
+// to one key at a time on kernels that do not support batches (before 5.6).
+typedef struct ebpf_map_reader ebpf_map_reader_t;
+
+ebpf_map_reader_t *
+ebpf_map_reader_create(const char *thread_name, const char *map_name, int map_fd, bool destructive);
+void ebpf_map_reader_destroy(ebpf_map_reader_t *r);
+void ebpf_map_reader_begin(ebpf_map_reader_t *r);
+bool ebpf_map_reader_next(ebpf_map_reader_t *r, void **key, void **values);
+size_t ebpf_map_reader_value_size(ebpf_map_reader_t *r);
+void ebpf_map_reader_end(ebpf_map_reader_t *r);
+void ebpf_map_reader_send_statistics(int update_every);
+
+/**
+ * Sum per-core counters
+ *
+ * Sum a run of consecutive counters of all cores into the values of the first core.
+ * The loops are kept simple, so the compiler can vectorize them.
+ *
+ * @param values     the values of a key, one per core.
+ * @param value_size the size of the value of one core.
+ * @param offset     the offset of the first counter inside the value.
+ * @param counters   the number of consecutive counters.
+ * @param cores      the number of cores to sum.
+ */
+static inline void
+ebpf_sum_percpu_u32(void *values, size_t value_size, size_t offset, size_t counters, int cores)
+{
+    uint32_t *restrict total = (uint32_t *)((char *)values + offset);
+    int i;
+    for (i = 1; i < cores; i++) {
+        const uint32_t *restrict w = (const uint32_t *)((char *)values + (size_t)i * value_size + offset);
+        size_t j;
+        for (j = 0; j < counters; j++)
+            total[j] += w[j];
+    }
+}
+
+static inline void
+ebpf_sum_percpu_u64(void *values, size_t value_size, size_t offset, size_t counters, int cores)
+{
+    uint64_t *restrict total = (uint64_t *)((char *)values + offset);
+    int i;
+    for (i = 1; i < cores; i++) {
+        const uint64_t *restrict w = (const uint64_t *)((char *)values + (size_t)i * value_size + offset);
+        size_t j;
+        for (j = 0; j < counters; j++)
+            total[j] += w[j];
+    }
+}
+
+/*****************************************************************
+ *
+ *  FUNCTIONS TO CONSUME RING BUFFERS
+ *
+ *****************************************************************/
+
+// Consumes the records of a BPF_MAP_TYPE_RINGBUF map in a dedicated thread, waiting on the
+// epoll descriptor of the ring buffer, and queues them until the collector drains them.
+struct bpf_object;
+typedef struct ebpf_event_stream ebpf_event_stream_t;
+typedef void (*ebpf_event_stream_cb)(void *record, void *data);
+
+ebpf_event_stream_t *ebpf_event_stream_create(
+    const char *thread_name,
+    struct bpf_object *obj,
+    const char *map_name,
+    size_t record_size);
+void ebpf_event_stream_destroy(ebpf_event_stream_t *s);
+size_t ebpf_event_stream_drain(ebpf_event_stream_t *s, ebpf_event_stream_cb cb, void *data);
+
 /*****************************************************************
  *
  *  FUNCTIONS TO DEFINE OPTIONS
@@ -296,6 +296,13 @@ void log_job_command_line_help(const char *name) {
     printf("       Show the configuration in YAML format before starting the job.\n");
     printf("       This is also an easy way to convert command line parameters to yaml.\n");
     printf("\n");
+    printf("  --threads N\n");
+    printf("       Process the logs with N parser threads (default 1, max %d).\n", MAX_THREADS);
+    printf("       When N is more than 1, a reader thread splits the input into chunks of\n");
+    printf("       lines, N workers process the chunks in parallel and a writer outputs\n");
+    printf("       them in the order they were read. The output is the same, but lines are\n");
+    printf("       flushed in chunks and errors on stderr may not be in order.\n");
+    printf("\n");
     printf("The program accepts all parameters as both --option=value and --option value.\n");
     printf("\n");
     printf("The maximum log line length accepted is %d characters.\n", MAX_LINE_LENGTH);
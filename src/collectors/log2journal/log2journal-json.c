@@ -10,6 +10,7 @@ struct log_json_state {
     LOG_JOB *jb;
 
     const char *line;
+    uint32_t len;
     uint32_t pos;
     uint32_t depth;
     char *stack[JSON_DEPTH_MAX];
@@ -24,6 +25,76 @@ static inline bool json_parse_array(LOG_JSON_STATE *js);
 #define json_current_pos(js) &(js)->line[(js)->pos]
 #define json_consume_char(js) ++(js)->pos
 
+// ----------------------------------------------------------------------------
+// structural scanner
+// string values are copied in runs, up to the next quote or backslash
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+ALWAYS_INLINE
+static const char *json_scan_string(const char *s, const char *e) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    while(s + 16 <= e) {
+        __m128i v = _mm_loadu_si128((const __m128i *)s);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+
+        unsigned mask = (unsigned)_mm_movemask_epi8(m);
+        if(mask)
+            return s + __builtin_ctz(mask);
+
+        s += 16;
+    }
+
+    while(s < e && *s != '"' && *s != '\\')
+        s++;
+
+    return s;
+}
+
+#else // !__SSE2__
+
+#define JSON_SWAR_ONES (~(uint64_t)0 / 255)
+#define JSON_SWAR_HIGHS (JSON_SWAR_ONES * 0x80)
+
+ALWAYS_INLINE
+static uint64_t json_swar_zero_bytes(uint64_t v) {
+    return (v - JSON_SWAR_ONES) & ~v & JSON_SWAR_HIGHS;
+}
+
+ALWAYS_INLINE
+static const char *json_scan_string(const char *s, const char *e) {
+    while(s + 8 <= e) {
+        uint64_t v;
+        memcpy(&v, s, sizeof(v));
+
+        uint64_t m = json_swar_zero_bytes(v ^ (JSON_SWAR_ONES * '"')) |
+                     json_swar_zero_bytes(v ^ (JSON_SWAR_ONES * '\\'));
+
+        if(m) {
+            // false positives may only appear above a true one, so the lowest is exact
+#if BYTE_ORDER == LITTLE_ENDIAN
+            return s + (__builtin_ctzll(m) / 8);
+#else
+            return s + (__builtin_clzll(m) / 8);
+#endif
+        }
+
+        s += 8;
+    }
+
+    while(s < e && *s != '"' && *s != '\\')
+        s++;
+
+    return s;
+}
+
+#endif // !__SSE2__
+
+// ----------------------------------------------------------------------------
+
 static inline void json_process_key_value(LOG_JSON_STATE *js, const char *value, size_t len) {
     log_job_send_extracted_key_value(js->jb, js->key, value, len);
 }
@@ -287,12 +358,29 @@ static inline bool json_parse_string(LOG_JSON_STATE *js) {
     value[0] = '\0';
     char *d = value;
     const char *s = json_current_pos(js);
+    const char *e = js->line + js->len;
     size_t remaining = sizeof(value);
 
     while (*s && *s != '"') {
         char c;
 
-        if (*s == '\\') {
+        if (*s != '\\') {
+            const char *run = json_scan_string(s, e);
+            size_t len = run - s;
+
+            if(len >= remaining) {
+                snprintf(js->msg, sizeof(js->msg),
+                         "JSON PARSER: truncated string value at position %u", js->pos);
+                return false;
+            }
+
+            memcpy(d, s, len);
+            d += len;
+            remaining -= len;
+            s = run;
+            continue;
+        }
+        else {
             s++;
 
             switch (*s) {
@@ -334,8 +422,6 @@ static inline bool json_parse_string(LOG_JSON_STATE *js) {
                     break;
             }
         }
-        else
-            c = *s++;
 
         if(remaining < 2) {
             snprintf(js->msg, sizeof(js->msg),
@@ -612,8 +698,9 @@ const char *json_parser_error(LOG_JSON_STATE *js) {
     return js->msg;
 }
 
-bool json_parse_document(LOG_JSON_STATE *js, const char *txt) {
+bool json_parse_document(LOG_JSON_STATE *js, const char *txt, size_t len) {
     js->line = txt;
+    js->len = len;
     js->pos = 0;
     js->msg[0] = '\0';
     js->stack[0][0] = '\0';
@@ -640,7 +727,8 @@ void json_test(void) {
     log_job_key_prefix_set(&jb, "NGINX_", 6);
     LOG_JSON_STATE *json = json_parser_create(&jb);
 
-    json_parse_document(json, "{\"value\":\"\\u\\u039A\\u03B1\\u03BB\\u03B7\\u03BC\\u03AD\\u03C1\\u03B1\"}");
+    const char *txt = "{\"value\":\"\\u\\u039A\\u03B1\\u03BB\\u03B7\\u03BC\\u03AD\\u03C1\\u03B1\"}";
+    json_parse_document(json, txt, strlen(txt));
 
     json_parser_destroy(json);
     log_job_cleanup(&jb);
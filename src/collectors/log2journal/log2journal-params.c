@@ -6,6 +6,7 @@
 
 void log_job_init(LOG_JOB *jb) {
     memset(jb, 0, sizeof(*jb));
+    jb->threads = 1;
     simple_hashtable_init_KEY(&jb->hashtable, 32);
     hashed_key_set(&jb->line.key, "LINE", -1);
 }
@@ -132,6 +133,19 @@ bool log_job_exclude_pattern_set(LOG_JOB *jb, const char *pattern, size_t patter
     return true;
 }
 
+bool log_job_threads_set(LOG_JOB *jb, const char *threads) {
+    char *end = NULL;
+    long n = (threads && *threads) ? strtol(threads, &end, 10) : 0;
+
+    if(!end || *end || n < 1 || n > MAX_THREADS) {
+        l2j_log("Error: invalid number of threads '%s', it should be between 1 and %d", threads ? threads : "", MAX_THREADS);
+        return false;
+    }
+
+    jb->threads = (uint32_t)n;
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 
 static bool parse_rename(LOG_JOB *jb, const char *param) {
@@ -363,6 +377,10 @@ bool log_job_command_line_parse_parameters(LOG_JOB *jb, int argc, char **argv) {
                     return false;
             }
 #endif
+            else if (strcmp(param, "--threads") == 0) {
+                if (!log_job_threads_set(jb, value))
+                    return false;
+            }
             else if (strcmp(param, "--unmatched-key") == 0)
                 hashed_key_set(&jb->unmatched.key, value, -1);
             else if (strcmp(param, "--inject") == 0) {
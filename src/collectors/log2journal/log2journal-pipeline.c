@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "log2journal.h"
+
+// ----------------------------------------------------------------------------
+// The multi-threaded pipeline
+//
+// The main thread reads stdin in big blocks, splits them into lines (like fgets()
+// would) and packs the lines into chunks. It also consumes the 'tail -F' filename
+// headers, so each chunk carries the filename its lines belong to.
+//
+// The workers have their own LOG_JOB (hashtable, parser, pcre2 match data), and
+// convert whole chunks to Journal Export Format, into the output buffer of the chunk.
+//
+// The writer outputs the chunks in the order they were read and returns them
+// to the reader for reuse.
+
+#define CHUNK_MAX_LINES 1024
+#define CHUNK_MAX_BYTES (256 * 1024)
+#define CHUNKS_PER_WORKER 4
+#define READ_BUFFER_SIZE (MAX_LINE_LENGTH * 2)
+
+typedef struct l2j_chunk {
+    uint64_t id;
+
+    TXT_L2J filename;                   // the 'tail -F' filename of these lines
+
+    char *input;                        // the lines, each one null terminated
+    size_t input_len;
+    size_t input_size;
+
+    uint32_t lines;
+    uint32_t lengths[CHUNK_MAX_LINES];
+
+    TXT_L2J output;                     // the output of the worker
+
+    struct l2j_chunk *next;
+} L2J_CHUNK;
+
+struct l2j_pipeline;
+
+typedef struct l2j_worker {
+    struct l2j_pipeline *pp;
+    pthread_t thread;
+    bool started;
+    LOG_JOB jb;
+} L2J_WORKER;
+
+typedef struct l2j_pipeline {
+    LOG_JOB *jb;                        // the job of the reader, it tracks the filenames
+
+    uint32_t workers_count;
+    L2J_WORKER *workers;
+
+    pthread_t writer;
+    bool writer_started;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_work;           // the workers wait for chunks to process
+    pthread_cond_t cond_done;           // the writer waits for the next chunk in order
+    pthread_cond_t cond_room;           // the reader waits for the writer to release chunks
+
+    struct {
+        L2J_CHUNK *head;
+        L2J_CHUNK *tail;
+    } queue;                            // chunks waiting for a worker
+
+    L2J_CHUNK **done;                   // processed chunks, at slot id % max_chunks
+    L2J_CHUNK *available;               // chunks to be reused by the reader
+
+    uint32_t max_chunks;
+    uint32_t chunks;                    // the chunks allocated
+    uint32_t in_flight;                 // the chunks the writer has not released yet
+
+    uint64_t submitted;
+    bool eof;
+
+    L2J_CHUNK *current;                 // the chunk the reader fills
+} L2J_PIPELINE;
+
+// ----------------------------------------------------------------------------
+// chunks
+
+static void chunk_free(L2J_CHUNK *c) {
+    txt_l2j_cleanup(&c->filename);
+    txt_l2j_cleanup(&c->output);
+    freez(c->input);
+    freez(c);
+}
+
+static L2J_CHUNK *chunk_get(L2J_PIPELINE *pp) {
+    L2J_CHUNK *c;
+
+    pthread_mutex_lock(&pp->mutex);
+
+    while(pp->in_flight >= pp->max_chunks)
+        pthread_cond_wait(&pp->cond_room, &pp->mutex);
+
+    pp->in_flight++;
+
+    c = pp->available;
+    if(c)
+        pp->available = c->next;
+    else
+        pp->chunks++;
+
+    pthread_mutex_unlock(&pp->mutex);
+
+    if(!c)
+        c = callocz(1, sizeof(*c));
+
+    c->id = pp->submitted;
+    c->input_len = 0;
+    c->lines = 0;
+    c->output.len = 0;
+    c->next = NULL;
+    txt_l2j_set(&c->filename, pp->jb->filename.current.txt, pp->jb->filename.current.len);
+
+    return c;
+}
+
+static void chunk_submit(L2J_PIPELINE *pp) {
+    L2J_CHUNK *c = pp->current;
+    if(!c || !c->lines)
+        return;
+
+    pp->current = NULL;
+
+    pthread_mutex_lock(&pp->mutex);
+
+    if(pp->queue.tail)
+        pp->queue.tail->next = c;
+    else
+        pp->queue.head = c;
+
+    pp->queue.tail = c;
+    pp->submitted++;
+
+    pthread_cond_signal(&pp->cond_work);
+    pthread_mutex_unlock(&pp->mutex);
+}
+
+// ----------------------------------------------------------------------------
+// the reader
+
+static void reader_add_line(L2J_PIPELINE *pp, const char *s, size_t size) {
+    // like fgets() and strlen(), stop at the first null
+    size_t len = strnlen(s, size);
+
+    // remove trailing newlines and spaces
+    while(len > 1 && (s[len - 1] == '\n' || isspace((uint8_t)s[len - 1])))
+        len--;
+
+    // skip leading spaces
+    while(len && isspace((uint8_t)*s)) {
+        s++;
+        len--;
+    }
+
+    if(!pp->current)
+        pp->current = chunk_get(pp);
+
+    L2J_CHUNK *c = pp->current;
+
+    if(c->input_len + len + 1 > c->input_size) {
+        c->input_size = c->input_len + len + 1 + CHUNK_MAX_BYTES;
+        c->input = reallocz(c->input, c->input_size);
+    }
+
+    char *line = &c->input[c->input_len];
+    memcpy(line, s, len);
+    line[len] = '\0';
+
+    if(log_job_switched_filename(pp->jb, line, len)) {
+        // a filename header ends the chunk, so that the next lines get the new filename
+        if(len) {
+            if(c->lines)
+                chunk_submit(pp);
+            else
+                txt_l2j_set(&c->filename, pp->jb->filename.current.txt, pp->jb->filename.current.len);
+        }
+
+        return;
+    }
+
+    c->lengths[c->lines++] = len;
+    c->input_len += len + 1;
+
+    if(c->lines >= CHUNK_MAX_LINES || c->input_len >= CHUNK_MAX_BYTES)
+        chunk_submit(pp);
+}
+
+static void reader_run(L2J_PIPELINE *pp) {
+    char *buffer = mallocz(READ_BUFFER_SIZE);
+    size_t used = 0;
+    bool eof = false;
+
+    while(!eof) {
+        ssize_t bytes = read(STDIN_FILENO, &buffer[used], READ_BUFFER_SIZE - used);
+        if(bytes < 0) {
+            if(errno == EINTR)
+                continue;
+
+            l2j_log("Error: cannot read from stdin: %s", strerror(errno));
+            eof = true;
+        }
+        else if(bytes == 0)
+            eof = true;
+        else
+            used += bytes;
+
+        char *s = buffer;
+        char *e = &buffer[used];
+        while(s < e) {
+            char *nl = memchr(s, '\n', e - s);
+            size_t size = nl ? (size_t)(nl - s + 1) : (size_t)(e - s);
+
+            // fgets() splits lines longer than the max line length
+            if(size > MAX_LINE_LENGTH)
+                size = MAX_LINE_LENGTH;
+            else if(!nl && !eof)
+                // wait for the rest of the line
+                break;
+
+            reader_add_line(pp, s, size);
+            s += size;
+        }
+
+        used = e - s;
+        if(used && s != buffer)
+            memmove(buffer, s, used);
+
+        // do not hold the lines we have while waiting for more input
+        chunk_submit(pp);
+    }
+
+    freez(buffer);
+
+    pthread_mutex_lock(&pp->mutex);
+
+    // the last chunk may have only filename headers
+    if(pp->current) {
+        pp->current->next = pp->available;
+        pp->available = pp->current;
+        pp->current = NULL;
+        pp->in_flight--;
+    }
+
+    pp->eof = true;
+    pthread_cond_broadcast(&pp->cond_work);
+    pthread_cond_signal(&pp->cond_done);
+    pthread_mutex_unlock(&pp->mutex);
+}
+
+// ----------------------------------------------------------------------------
+// the workers
+
+static void *worker_thread(void *ptr) {
+    L2J_WORKER *w = ptr;
+    L2J_PIPELINE *pp = w->pp;
+    LOG_JOB *jb = &w->jb;
+
+    while(true) {
+        pthread_mutex_lock(&pp->mutex);
+
+        while(!pp->queue.head && !pp->eof)
+            pthread_cond_wait(&pp->cond_work, &pp->mutex);
+
+        L2J_CHUNK *c = pp->queue.head;
+        if(c) {
+            pp->queue.head = c->next;
+            if(!pp->queue.head)
+                pp->queue.tail = NULL;
+        }
+
+        pthread_mutex_unlock(&pp->mutex);
+
+        if(!c)
+            break;
+
+        txt_l2j_set(&jb->filename.current, c->filename.txt, c->filename.len);
+        jb->output = &c->output;
+
+        const char *line = c->input;
+        for(uint32_t i = 0; i < c->lines; i++) {
+            log_job_process_line(jb, line, c->lengths[i]);
+            line += c->lengths[i] + 1;
+        }
+
+        jb->output = NULL;
+
+        pthread_mutex_lock(&pp->mutex);
+        pp->done[c->id % pp->max_chunks] = c;
+        pthread_cond_signal(&pp->cond_done);
+        pthread_mutex_unlock(&pp->mutex);
+    }
+
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+// the writer
+
+static void *writer_thread(void *ptr) {
+    L2J_PIPELINE *pp = ptr;
+
+    for(uint64_t id = 0; ; id++) {
+        size_t slot = id % pp->max_chunks;
+
+        pthread_mutex_lock(&pp->mutex);
+
+        while(!pp->done[slot] && !(pp->eof && id == pp->submitted))
+            pthread_cond_wait(&pp->cond_done, &pp->mutex);
+
+        L2J_CHUNK *c = pp->done[slot];
+        pp->done[slot] = NULL;
+
+        pthread_mutex_unlock(&pp->mutex);
+
+        if(!c)
+            break;
+
+        if(c->output.len) {
+            fwrite(c->output.txt, 1, c->output.len, stdout);
+            fflush(stdout);
+        }
+
+        pthread_mutex_lock(&pp->mutex);
+        c->next = pp->available;
+        pp->available = c;
+        pp->in_flight--;
+        pthread_cond_signal(&pp->cond_room);
+        pthread_mutex_unlock(&pp->mutex);
+    }
+
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+static void pipeline_cleanup(L2J_PIPELINE *pp) {
+    for(uint32_t i = 0; i < pp->workers_count; i++) {
+        L2J_WORKER *w = &pp->workers[i];
+        if(w->started)
+            pthread_join(w->thread, NULL);
+
+        log_job_parser_destroy(&w->jb);
+        log_job_cleanup(&w->jb);
+    }
+    freez(pp->workers);
+
+    if(pp->writer_started)
+        pthread_join(pp->writer, NULL);
+
+    // at this point, all chunks have been written and are available
+    while(pp->available) {
+        L2J_CHUNK *c = pp->available;
+        pp->available = c->next;
+        chunk_free(c);
+    }
+    freez(pp->done);
+
+    pthread_cond_destroy(&pp->cond_work);
+    pthread_cond_destroy(&pp->cond_done);
+    pthread_cond_destroy(&pp->cond_room);
+    pthread_mutex_destroy(&pp->mutex);
+}
+
+static void pipeline_stop(L2J_PIPELINE *pp) {
+    pthread_mutex_lock(&pp->mutex);
+    pp->eof = true;
+    pthread_cond_broadcast(&pp->cond_work);
+    pthread_cond_signal(&pp->cond_done);
+    pthread_mutex_unlock(&pp->mutex);
+}
+
+int log_job_run_pipeline(LOG_JOB *jb, int argc, char **argv) {
+    L2J_PIPELINE pipeline = {
+        .jb = jb,
+        .workers_count = jb->threads,
+        .max_chunks = jb->threads * CHUNKS_PER_WORKER,
+    };
+    L2J_PIPELINE *pp = &pipeline;
+
+    pthread_mutex_init(&pp->mutex, NULL);
+    pthread_cond_init(&pp->cond_work, NULL);
+    pthread_cond_init(&pp->cond_done, NULL);
+    pthread_cond_init(&pp->cond_room, NULL);
+
+    pp->done = callocz(pp->max_chunks, sizeof(*pp->done));
+    pp->workers = callocz(pp->workers_count, sizeof(*pp->workers));
+
+    // each worker gets its own job, with the same configuration
+    for(uint32_t i = 0; i < pp->workers_count; i++) {
+        L2J_WORKER *w = &pp->workers[i];
+        w->pp = pp;
+        log_job_init(&w->jb);
+
+        if(!log_job_command_line_parse_parameters(&w->jb, argc, argv) || !log_job_parser_create(&w->jb)) {
+            pipeline_cleanup(pp);
+            return 1;
+        }
+    }
+
+    int ret = 0;
+
+    for(uint32_t i = 0; i < pp->workers_count; i++) {
+        L2J_WORKER *w = &pp->workers[i];
+        if(pthread_create(&w->thread, NULL, worker_thread, w) != 0) {
+            l2j_log("Error: cannot create worker thread %u", i);
+            ret = 1;
+            break;
+        }
+        w->started = true;
+    }
+
+    if(!ret) {
+        if(pthread_create(&pp->writer, NULL, writer_thread, pp) != 0) {
+            l2j_log("Error: cannot create the writer thread");
+            ret = 1;
+        }
+        else
+            pp->writer_started = true;
+    }
+
+    if(ret)
+        pipeline_stop(pp);
+    else
+        reader_run(pp);
+
+    pipeline_cleanup(pp);
+    return ret;
+}
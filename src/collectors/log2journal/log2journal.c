@@ -276,6 +276,17 @@ static inline HASHED_KEY *rename_key(LOG_JOB *jb, HASHED_KEY *k) {
     return k;
 }
 
+// ----------------------------------------------------------------------------
+// the workers of the pipeline write to their chunk, instead of stdout
+
+static inline void output_append(LOG_JOB *jb, const char *txt, size_t len) {
+    TXT_L2J *o = jb->output;
+    txt_l2j_resize(o, o->len + len + 1, true);
+    memcpy(&o->txt[o->len], txt, len);
+    o->len += len;
+    o->txt[o->len] = '\0';
+}
+
 // ----------------------------------------------------------------------------
 
 static inline void send_key_value_constant(LOG_JOB *jb __maybe_unused, HASHED_KEY *key, const char *value, size_t len) {
@@ -291,12 +302,33 @@ static inline void send_key_value_error(LOG_JOB *jb, HASHED_KEY *key, const char
 static inline void send_key_value_error(LOG_JOB *jb, HASHED_KEY *key, const char *format, ...) {
     HASHED_KEY *ht_key = get_key_from_hashtable(jb, key);
 
-    printf("%s=", ht_key->key);
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+
+    if(jb->output) {
+        va_list args2;
+        va_copy(args2, args);
+        int len = vsnprintf(NULL, 0, format, args2);
+        va_end(args2);
+
+        if(len > 0) {
+            output_append(jb, ht_key->key, ht_key->len);
+            output_append(jb, "=", 1);
+
+            TXT_L2J *o = jb->output;
+            txt_l2j_resize(o, o->len + len + 2, true);
+            vsnprintf(&o->txt[o->len], len + 1, format, args);
+            o->len += len;
+            output_append(jb, "\n", 1);
+        }
+    }
+    else {
+        printf("%s=", ht_key->key);
+        vprintf(format, args);
+        printf("\n");
+    }
+
     va_end(args);
-    printf("\n");
 }
 
 inline void log_job_send_extracted_key_value(LOG_JOB *jb, const char *key, const char *value, size_t len) {
@@ -353,8 +385,17 @@ static inline void send_all_fields(LOG_JOB *jb) {
                 validate_key(jb, k);
             }
 
-            if(k->flags & HK_FILTERED_INCLUDED)
-                printf("%s=%.*s\n", k->key, (int)k->value.len, k->value.txt);
+            if(k->flags & HK_FILTERED_INCLUDED) {
+                if(jb->output) {
+                    // like printf() below, stop at the first null
+                    output_append(jb, k->key, k->len);
+                    output_append(jb, "=", 1);
+                    output_append(jb, k->value.txt, strnlen(k->value.txt, k->value.len));
+                    output_append(jb, "\n", 1);
+                }
+                else
+                    printf("%s=%.*s\n", k->key, (int)k->value.len, k->value.txt);
+            }
 
             // reset it for the next round
             k->value.txt[0] = '\0';
@@ -408,7 +449,7 @@ static inline void jb_inject_filename(LOG_JOB *jb) {
         send_key_value_constant(jb, &jb->filename.key, jb->filename.current.txt, jb->filename.current.len);
 }
 
-static inline bool jb_switched_filename(LOG_JOB *jb, const char *line, size_t len) {
+bool log_job_switched_filename(LOG_JOB *jb, const char *line, size_t len) {
     // IMPORTANT:
     // Return TRUE when the caller should skip this line (because it is ours).
     // Unfortunately, we have to consume empty lines too.
@@ -478,81 +519,109 @@ static char *get_next_line(LOG_JOB *jb __maybe_unused, char *buffer, size_t size
     return line;
 }
 
-int log_job_run(LOG_JOB *jb) {
+bool log_job_parser_create(LOG_JOB *jb) {
     select_which_injections_should_be_injected_on_unmatched(jb);
 
-    PCRE2_STATE *pcre2 = NULL;
-    LOG_JSON_STATE *json = NULL;
-    LOGFMT_STATE *logfmt = NULL;
-
     if(strcmp(jb->pattern, "json") == 0) {
-        json = json_parser_create(jb);
+        jb->parser.json = json_parser_create(jb);
         // never fails
     }
     else if(strcmp(jb->pattern, "logfmt") == 0) {
-        logfmt = logfmt_parser_create(jb);
+        jb->parser.logfmt = logfmt_parser_create(jb);
         // never fails
     }
     else if(strcmp(jb->pattern, "none") != 0) {
-        pcre2 = pcre2_parser_create(jb);
-        if(pcre2_has_error(pcre2)) {
-            l2j_log("%s", pcre2_parser_error(pcre2));
-            pcre2_parser_destroy(pcre2);
-            return 1;
+        jb->parser.pcre2 = pcre2_parser_create(jb);
+        if(pcre2_has_error(jb->parser.pcre2)) {
+            l2j_log("%s", pcre2_parser_error(jb->parser.pcre2));
+            pcre2_parser_destroy(jb->parser.pcre2);
+            jb->parser.pcre2 = NULL;
+            return false;
         }
     }
 
-    jb->line.buffer = mallocz(MAX_LINE_LENGTH + 1);
-    jb->line.size = MAX_LINE_LENGTH + 1;
-    jb->line.trimmed_len = 0;
-    jb->line.trimmed = jb->line.buffer;
+    return true;
+}
 
-    while ((jb->line.trimmed = get_next_line(jb, (char *)jb->line.buffer, jb->line.size, &jb->line.trimmed_len))) {
-        const char *line = jb->line.trimmed;
-        size_t len = jb->line.trimmed_len;
+void log_job_parser_destroy(LOG_JOB *jb) {
+    if(jb->parser.json)
+        json_parser_destroy(jb->parser.json);
 
-        if(jb_switched_filename(jb, line, len))
-            continue;
+    else if(jb->parser.logfmt)
+        logfmt_parser_destroy(jb->parser.logfmt);
+
+    else if(jb->parser.pcre2)
+        pcre2_parser_destroy(jb->parser.pcre2);
+
+    jb->parser.json = NULL;
+    jb->parser.logfmt = NULL;
+    jb->parser.pcre2 = NULL;
+}
+
+bool log_job_process_line(LOG_JOB *jb, const char *line, size_t len) {
+    LOG_JSON_STATE *json = jb->parser.json;
+    LOGFMT_STATE *logfmt = jb->parser.logfmt;
+    PCRE2_STATE *pcre2 = jb->parser.pcre2;
+
+    jb->line.trimmed = line;
+    jb->line.trimmed_len = len;
 
-        bool line_is_matched = true;
+    bool line_is_matched = true;
 
+    if(json)
+        line_is_matched = json_parse_document(json, line, len);
+    else if(logfmt)
+        line_is_matched = logfmt_parse_document(logfmt, line);
+    else if(pcre2)
+        line_is_matched = pcre2_parse_document(pcre2, line, len);
+
+    if(!line_is_matched) {
         if(json)
-            line_is_matched = json_parse_document(json, line);
+            l2j_log("%s", json_parser_error(json));
         else if(logfmt)
-            line_is_matched = logfmt_parse_document(logfmt, line);
+            l2j_log("%s", logfmt_parser_error(logfmt));
         else if(pcre2)
-            line_is_matched = pcre2_parse_document(pcre2, line, len);
-
-        if(!line_is_matched) {
-            if(json)
-                l2j_log("%s", json_parser_error(json));
-            else if(logfmt)
-                l2j_log("%s", logfmt_parser_error(logfmt));
-            else if(pcre2)
-                l2j_log("%s", pcre2_parser_error(pcre2));
-
-            if(!jb_send_unmatched_line(jb, line))
-                // just logging to stderr, not sending unmatched lines
-                continue;
-        }
+            l2j_log("%s", pcre2_parser_error(pcre2));
+
+        if(!jb_send_unmatched_line(jb, line))
+            // just logging to stderr, not sending unmatched lines
+            return false;
+    }
 
-        jb_inject_filename(jb);
-        jb_finalize_injections(jb, line_is_matched);
+    jb_inject_filename(jb);
+    jb_finalize_injections(jb, line_is_matched);
 
-        log_job_process_rewrites(jb);
-        send_all_fields(jb);
+    log_job_process_rewrites(jb);
+    send_all_fields(jb);
+
+    if(jb->output)
+        output_append(jb, "\n", 1);
+    else
         printf("\n");
-        fflush(stdout);
-    }
 
-    if(json)
-        json_parser_destroy(json);
+    return true;
+}
 
-    else if(logfmt)
-        logfmt_parser_destroy(logfmt);
+int log_job_run(LOG_JOB *jb) {
+    if(!log_job_parser_create(jb))
+        return 1;
 
-    else if(pcre2)
-        pcre2_parser_destroy(pcre2);
+    jb->line.buffer = mallocz(MAX_LINE_LENGTH + 1);
+    jb->line.size = MAX_LINE_LENGTH + 1;
+    jb->line.trimmed_len = 0;
+    jb->line.trimmed = jb->line.buffer;
+
+    const char *line;
+    size_t len;
+    while ((line = get_next_line(jb, (char *)jb->line.buffer, jb->line.size, &len))) {
+        if(log_job_switched_filename(jb, line, len))
+            continue;
+
+        if(log_job_process_line(jb, line, len))
+            fflush(stdout);
+    }
+
+    log_job_parser_destroy(jb);
 
     freez((void *)jb->line.buffer);
 
@@ -572,7 +641,11 @@ int main(int argc, char *argv[]) {
     if(log_job.show_config)
         log_job_configuration_to_yaml(&log_job);
 
-    int ret = log_job_run(&log_job);
+    int ret;
+    if(log_job.threads > 1)
+        ret = log_job_run_pipeline(&log_job, argc, argv);
+    else
+        ret = log_job_run(&log_job);
 
     log_job_cleanup(&log_job);
     return ret;
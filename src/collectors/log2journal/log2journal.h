@@ -46,6 +46,7 @@ static inline int compare_keys(struct hashed_key *k1, struct hashed_key *k2);
 #define MAX_INJECTIONS (MAX_OUTPUT_KEYS / 2)
 #define MAX_REWRITES (MAX_OUTPUT_KEYS / 2)
 #define MAX_RENAMES (MAX_OUTPUT_KEYS / 2)
+#define MAX_THREADS 256
 
 #define JOURNAL_MAX_KEY_LEN 64              // according to systemd-journald
 #define JOURNAL_MAX_VALUE_LEN (48 * 1024)   // according to systemd-journald
@@ -163,6 +164,7 @@ void rewrite_cleanup(REWRITE *rw);
 
 typedef struct log_job {
     bool show_config;
+    uint32_t threads;
 
     const char *pattern;
     const char *prefix;
@@ -211,6 +213,14 @@ typedef struct log_job {
         uint32_t used;
         RENAME array[MAX_RENAMES];
     } renames;
+
+    struct {
+        struct log_json_state *json;
+        struct logfmt_state *logfmt;
+        struct pcre2_state *pcre2;
+    } parser;
+
+    TXT_L2J *output;    // when set, the output is appended to it, instead of stdout
 } LOG_JOB;
 
 // initialize a log job
@@ -237,11 +247,31 @@ bool log_job_rewrite_add(LOG_JOB *jb, const char *key, RW_FLAGS flags, const cha
 bool log_job_rename_add(LOG_JOB *jb, const char *new_key, size_t new_key_len, const char *old_key, size_t old_key_len);
 bool log_job_include_pattern_set(LOG_JOB *jb, const char *pattern, size_t pattern_len);
 bool log_job_exclude_pattern_set(LOG_JOB *jb, const char *pattern, size_t pattern_len);
+bool log_job_threads_set(LOG_JOB *jb, const char *threads);
 
 // entry point to parse command line parameters
 bool log_job_command_line_parse_parameters(LOG_JOB *jb, int argc, char **argv);
 void log_job_command_line_help(const char *name);
 
+// ----------------------------------------------------------------------------
+// running a job
+
+// create the parser of the job, before processing any lines
+bool log_job_parser_create(LOG_JOB *jb);
+void log_job_parser_destroy(LOG_JOB *jb);
+
+// returns true when the line is consumed, because it is empty or it is a 'tail -F' filename header
+bool log_job_switched_filename(LOG_JOB *jb, const char *line, size_t len);
+
+// process a trimmed line and output its fields, returns false when nothing is output for it
+bool log_job_process_line(LOG_JOB *jb, const char *line, size_t len);
+
+int log_job_run(LOG_JOB *jb);
+
+// the multi-threaded pipeline, used when more than one thread is configured
+// the workers get their own job, by parsing the same command line parameters
+int log_job_run_pipeline(LOG_JOB *jb, int argc, char **argv);
+
 // ----------------------------------------------------------------------------
 // YAML configuration related
 
@@ -259,7 +289,7 @@ typedef struct log_json_state LOG_JSON_STATE;
 LOG_JSON_STATE *json_parser_create(LOG_JOB *jb);
 void json_parser_destroy(LOG_JSON_STATE *js);
 const char *json_parser_error(LOG_JSON_STATE *js);
-bool json_parse_document(LOG_JSON_STATE *js, const char *txt);
+bool json_parse_document(LOG_JSON_STATE *js, const char *txt, size_t len);
 void json_test(void);
 
 size_t parse_surrogate(const char *s, char *d, size_t *remaining);
@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+
+# Throughput benchmark of log2journal, on generated nginx JSON logs.
+#
+# It runs log2journal with 1 thread and with the pipeline (--threads N),
+# reports lines/second for each run and checks that the outputs are identical.
+#
+# Usage: ./benchmark.sh [LINES] [THREADS...]
+#        default: 500000 lines, 1 2 4 8 threads
+
+set -e
+
+LINES="${1:-500000}"
+shift || true
+if [ $# -gt 0 ]; then
+    THREADS=("$@")
+else
+    THREADS=(1 2 4 8)
+fi
+
+if [ -z "${TESTED_LOG2JOURNAL_BIN}" ]; then
+    TESTED_LOG2JOURNAL_BIN="log2journal"
+fi
+
+WORK_DIR=$(mktemp -d /tmp/log2journal-benchmark.XXXXXX)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+echo "Generating ${LINES} nginx JSON log lines..."
+awk -v lines="${LINES}" 'BEGIN {
+    srand(1);
+    split("GET POST PUT DELETE", methods, " ");
+    split("200 200 200 301 404 500", statuses, " ");
+    for(i = 0; i < lines; i++) {
+        printf("{\"msec\":\"%d.%03d\",\"connection\":%d,\"connection_requests\":%d,\"pid\":%d,", 1700000000 + i, i % 1000, i, i % 100, 1000 + i % 16);
+        printf("\"request_id\":\"%08x%08x\",\"request_length\":%d,\"remote_addr\":\"10.%d.%d.%d\",\"remote_port\":%d,", i, i * 7, 300 + i % 500, i % 256, int(i / 256) % 256, i % 250, 1024 + i % 60000);
+        printf("\"request\":\"%s /api/v1/items/%d?page=%d&q=\\\"%d\\\" HTTP/1.1\",", methods[1 + i % 4], i, i % 10, i);
+        printf("\"status\":\"%s\",\"body_bytes_sent\":%d,\"request_time\":%.3f,", statuses[1 + i % 6], int(rand() * 100000), rand());
+        printf("\"http_referer\":\"https://example.com/page/%d\",\"http_user_agent\":\"Mozilla/5.0 (X11; Linux x86_64; rv:120.0) Gecko/20100101 Firefox/120.0\",", i % 1000);
+        printf("\"upstream\":{\"addr\":\"10.1.0.%d:8080\",\"status\":\"%s\",\"response_time\":%.3f}}\n", i % 8, statuses[1 + i % 6], rand());
+    }
+}' > "${WORK_DIR}/nginx.json"
+
+SIZE=$(du -m "${WORK_DIR}/nginx.json" | cut -f1)
+echo "Input: ${SIZE} MiB, using ${TESTED_LOG2JOURNAL_BIN}"
+echo
+
+for t in "${THREADS[@]}"; do
+    start=$(date +%s%N)
+    "${TESTED_LOG2JOURNAL_BIN}" json --threads "${t}" < "${WORK_DIR}/nginx.json" > "${WORK_DIR}/output-${t}"
+    end=$(date +%s%N)
+
+    ms=$(( (end - start) / 1000000 ))
+    [ "${ms}" -eq 0 ] && ms=1
+    echo "threads ${t}: ${ms} ms, $(( LINES * 1000 / ms )) lines/s"
+
+    if [ "${t}" != "${THREADS[0]}" ] && ! cmp -s "${WORK_DIR}/output-${THREADS[0]}" "${WORK_DIR}/output-${t}"; then
+        echo "ERROR: the output with ${t} threads differs from the output with ${THREADS[0]} threads"
+        exit 1
+    fi
+done
@@ -0,0 +1 @@
+${TESTED_LOG2JOURNAL_BIN} json --threads 4 --filename-key LOG_FILENAME --unmatched-key MESSAGE --inject-unmatched PRIORITY=3
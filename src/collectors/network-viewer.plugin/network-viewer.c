@@ -174,6 +174,9 @@ static void __attribute__((destructor)) destroy_mutex(void) {
 static bool plugin_should_exit = false;
 static SERVICENAMES_CACHE *sc;
 
+// the sockets of all processes, shared by all functions and updated incrementally
+static LS_PID_INDEX *pid_index = NULL;
+
 ENUM_STR_MAP_DEFINE(SOCKET_DIRECTION) = {
     { .id = SOCKET_DIRECTION_LISTEN, .name = "listen" },
     { .id = SOCKET_DIRECTION_LOCAL_INBOUND, .name = "local" },
@@ -1547,6 +1550,7 @@ static bool topology_prepare_context(NV_TOPOLOGY_CONTEXT *ctx, usec_t now_ut, co
 #if defined(LOCAL_SOCKETS_USE_SETNS)
         .spawn_server = spawn_srv,
 #endif
+        .pid_index = pid_index,
         .stats = { 0 },
         .sockets_hashtable = { 0 },
         .local_ips_hashtable = { 0 },
@@ -2847,6 +2851,7 @@ void network_viewer_function(const char *transaction, char *function __maybe_unu
 #if defined(LOCAL_SOCKETS_USE_SETNS)
             .spawn_server = spawn_srv,
 #endif
+            .pid_index = pid_index,
             .stats = { 0 },
             .sockets_hashtable = { 0 },
             .local_ips_hashtable = { 0 },
@@ -3289,6 +3294,66 @@ close_and_send:
     netdata_mutex_unlock(&stdout_mutex);
 }
 
+// ----------------------------------------------------------------------------------------------------------------
+// internal charts
+
+static void network_viewer_send_pid_index_charts(int update_every) {
+    static bool created_charts = false;
+
+    netdata_mutex_lock(&pid_index->mutex);
+    size_t scans = pid_index->stats.scans;
+    size_t pids = pid_index->stats.pids;
+    size_t pids_scanned = pid_index->stats.pids_scanned;
+    size_t pids_cached = pid_index->stats.pids_cached;
+    size_t pids_removed = pid_index->stats.pids_removed;
+    size_t fds_read = pid_index->stats.fds_read;
+    usec_t scan_ut = pid_index->stats.scan_ut;
+    netdata_mutex_unlock(&pid_index->mutex);
+
+    netdata_mutex_lock(&stdout_mutex);
+
+    if(!created_charts) {
+        created_charts = true;
+
+        fprintf(stdout,
+                "CHART netdata.network_viewer_pid_index_time '' 'Network Viewer Processes Index Time' 'milliseconds/s' network-viewer.plugin netdata.network_viewer_pid_index_time line 145000 %1$d '' 'network-viewer.plugin'\n"
+                "DIMENSION scan '' incremental 1 1000\n"
+                "CHART netdata.network_viewer_pid_index_pids '' 'Network Viewer Processes Index' 'processes/s' network-viewer.plugin netdata.network_viewer_pid_index_pids line 145001 %1$d '' 'network-viewer.plugin'\n"
+                "DIMENSION scanned '' incremental 1 1\n"
+                "DIMENSION cached '' incremental 1 1\n"
+                "DIMENSION removed '' incremental 1 1\n"
+                "DIMENSION fds 'fds read' incremental 1 1\n"
+                "DIMENSION scans '' incremental 1 1\n"
+                "DIMENSION indexed '' absolute 1 1\n"
+                , update_every
+        );
+    }
+
+    fprintf(stdout,
+            "BEGIN netdata.network_viewer_pid_index_time\n"
+            "SET scan = %"PRIu64"\n"
+            "END\n"
+            "BEGIN netdata.network_viewer_pid_index_pids\n"
+            "SET scanned = %zu\n"
+            "SET cached = %zu\n"
+            "SET removed = %zu\n"
+            "SET fds = %zu\n"
+            "SET scans = %zu\n"
+            "SET indexed = %zu\n"
+            "END\n"
+            , (uint64_t)scan_ut
+            , pids_scanned
+            , pids_cached
+            , pids_removed
+            , fds_read
+            , scans
+            , pids
+    );
+
+    fflush(stdout);
+    netdata_mutex_unlock(&stdout_mutex);
+}
+
 // ----------------------------------------------------------------------------------------------------------------
 // main
 
@@ -3311,6 +3376,7 @@ int main(int argc __maybe_unused, char **argv __maybe_unused) {
     cached_usernames_init();
     update_cached_host_users();
     sc = system_servicenames_cache_init();
+    pid_index = local_sockets_pid_index_create();
 
     // ----------------------------------------------------------------------------------------------------------------
 
@@ -3368,6 +3434,8 @@ int main(int argc __maybe_unused, char **argv __maybe_unused) {
     // ----------------------------------------------------------------------------------------------------------------
 
     usec_t send_newline_ut = 0;
+    usec_t send_charts_ut = 0;
+    const int update_every = 10;
     bool tty = isatty(fileno(stdout)) == 1;
 
     heartbeat_t hb;
@@ -3376,6 +3444,13 @@ int main(int argc __maybe_unused, char **argv __maybe_unused) {
     while(!__atomic_load_n(&plugin_should_exit, __ATOMIC_ACQUIRE)) {
         usec_t dt_ut = heartbeat_next(&hb);
         send_newline_ut += dt_ut;
+        send_charts_ut += dt_ut;
+
+        if(!tty && send_charts_ut >= update_every * USEC_PER_SEC) {
+            network_viewer_send_pid_index_charts(update_every);
+            send_charts_ut = 0;
+            send_newline_ut = 0;
+        }
 
         if(!tty && send_newline_ut > USEC_PER_SEC) {
             send_newline_and_flush(&stdout_mutex);
@@ -2,38 +2,51 @@
 
 #include "plugin_proc.h"
 
+// Modules are collected by a small pool of threads, so that a slow module
+// (e.g. diskstats with thousands of devices) does not delay the others.
+// The critical modules are always collected by the main thread, in order,
+// before any other module. The rest are claimed by any thread of the pool
+// when they are due, according to their own update every.
+
 static struct proc_module {
     const char *name;
     const char *dim;
 
     int enabled;
+    bool critical;          // collected by the main thread, every iteration
 
     int (*func)(int update_every, usec_t dt);
     void (*cleanup)(void);  // Cleanup function pointer
 
     RRDDIM *rd;
 
+    // scheduling
+    int update_every;
+    bool running;           // a thread is collecting it
+    usec_t next_run_ut;     // monotonic, when it is due again
+    usec_t last_run_ut;     // monotonic, when it was collected last time
+
 } proc_modules[] = {
 
     // system metrics
-    {.name = "/proc/stat",                   .dim = "stat",         .func = do_proc_stat, .cleanup = proc_stat_plugin_cleanup},
-    {.name = "/proc/uptime",                 .dim = "uptime",       .func = do_proc_uptime},
-    {.name = "/proc/loadavg",                .dim = "loadavg",      .func = do_proc_loadavg, .cleanup = proc_loadavg_plugin_cleanup},
+    {.name = "/proc/stat",                   .dim = "stat",         .critical = true, .func = do_proc_stat, .cleanup = proc_stat_plugin_cleanup},
+    {.name = "/proc/uptime",                 .dim = "uptime",       .critical = true, .func = do_proc_uptime},
+    {.name = "/proc/loadavg",                .dim = "loadavg",      .critical = true, .func = do_proc_loadavg, .cleanup = proc_loadavg_plugin_cleanup},
     {.name = "/proc/sys/fs/file-nr",         .dim = "file-nr",      .func = do_proc_sys_fs_file_nr},
     {.name = "/proc/sys/kernel/random/entropy_avail", .dim = "entropy", .func = do_proc_sys_kernel_random_entropy_avail},
 
     {.name = "/run/reboot_required",         .dim = "reboot-required", .func = do_run_reboot_required},
 
     // pressure metrics
-    {.name = "/proc/pressure",               .dim = "pressure",     .func = do_proc_pressure},
+    {.name = "/proc/pressure",               .dim = "pressure",     .critical = true, .func = do_proc_pressure},
 
     // CPU metrics
     {.name = "/proc/interrupts",             .dim = "interrupts",   .func = do_proc_interrupts},
     {.name = "/proc/softirqs",               .dim = "softirqs",     .func = do_proc_softirqs},
 
     // memory metrics
-    {.name = "/proc/vmstat",                 .dim = "vmstat",       .func = do_proc_vmstat},
-    {.name = "/proc/meminfo",                .dim = "meminfo",      .func = do_proc_meminfo},
+    {.name = "/proc/vmstat",                 .dim = "vmstat",       .critical = true, .func = do_proc_vmstat},
+    {.name = "/proc/meminfo",                .dim = "meminfo",      .critical = true, .func = do_proc_meminfo},
     {.name = "/sys/kernel/mm/ksm",           .dim = "ksm",          .func = do_sys_kernel_mm_ksm},
     {.name = "/sys/block/zram",              .dim = "zram",         .func = do_sys_block_zram},
     {.name = "/sys/devices/system/edac/mc",  .dim = "edac",         .func = do_proc_sys_devices_system_edac_mc},
@@ -82,12 +95,19 @@ static struct proc_module {
     {.name = NULL, .dim = NULL, .func = NULL}
 };
 
-#if WORKER_UTILIZATION_MAX_JOB_TYPES < 36
-#error WORKER_UTILIZATION_MAX_JOB_TYPES has to be at least 36
+#if WORKER_UTILIZATION_MAX_JOB_TYPES < 37
+#error WORKER_UTILIZATION_MAX_JOB_TYPES has to be at least 37
 #endif
 
+#define WORKER_PROC_JOB_LATE (WORKER_UTILIZATION_MAX_JOB_TYPES - 1)
+
+#define PROC_MAX_THREADS 16
+
 static ND_THREAD *netdev_thread = NULL;
 
+static size_t proc_threads_count = 0;
+static ND_THREAD *proc_threads[PROC_MAX_THREADS] = { 0 };
+
 static void proc_main_cleanup(void *pptr)
 {
     struct netdata_static_thread *static_thread = CLEANUP_FUNCTION_GET_PTR(pptr);
@@ -95,6 +115,10 @@ static void proc_main_cleanup(void *pptr)
 
     static_thread->enabled = NETDATA_MAIN_THREAD_EXITING;
 
+    // the modules may still be running on the other threads
+    for(size_t t = 0; t < proc_threads_count ; t++)
+        nd_thread_join(proc_threads[t]);
+
     // Run all module cleanup functions
     int i;
     for(i = 0; proc_modules[i].name; i++) {
@@ -205,11 +229,106 @@ static bool log_proc_module(BUFFER *wb, void *data) {
     return true;
 }
 
+#define LGS_MODULE_ID 0
+
+static void proc_module_collect(struct proc_module *pm, size_t job_id, struct log_stack_entry *lgs) {
+    usec_t update_every_ut = pm->update_every * USEC_PER_SEC;
+    usec_t started_ut = now_monotonic_usec();
+    usec_t dt = pm->last_run_ut ? started_ut - pm->last_run_ut : update_every_ut;
+    pm->last_run_ut = started_ut;
+
+    worker_is_busy(job_id);
+    lgs[LGS_MODULE_ID] = ND_LOG_FIELD_CB(NDF_MODULE, log_proc_module, pm);
+    int enabled = !pm->func(pm->update_every, dt);
+    lgs[LGS_MODULE_ID] = ND_LOG_FIELD_TXT(NDF_MODULE, "proc.plugin");
+    worker_is_idle();
+
+    // when a module takes longer than its update every, it misses its next iteration
+    usec_t next_run_ut = started_ut + update_every_ut;
+    usec_t finished_ut = now_monotonic_usec();
+    if(unlikely(finished_ut > next_run_ut)) {
+        worker_set_metric(WORKER_PROC_JOB_LATE, 1);
+        next_run_ut = finished_ut;
+    }
+
+    __atomic_store_n(&pm->enabled, enabled, __ATOMIC_RELAXED);
+    __atomic_store_n(&pm->next_run_ut, next_run_ut, __ATOMIC_RELEASE);
+}
+
+// collect the modules that are due, the critical or the rest
+static void proc_modules_collect(bool critical, struct log_stack_entry *lgs) {
+    // the threads do not wake up at exactly the same time,
+    // so a module is due if it will be due within half an iteration
+    usec_t tolerance_ut = localhost->rrd_update_every * USEC_PER_SEC / 2;
+
+    for(size_t i = 0; proc_modules[i].name; i++) {
+        if(unlikely(!service_running(SERVICE_COLLECTORS)))
+            break;
+
+        struct proc_module *pm = &proc_modules[i];
+        if(unlikely(pm->critical != critical || !__atomic_load_n(&pm->enabled, __ATOMIC_RELAXED)))
+            continue;
+
+        if(now_monotonic_usec() + tolerance_ut < __atomic_load_n(&pm->next_run_ut, __ATOMIC_ACQUIRE))
+            continue;
+
+        if(critical) {
+            // only the main thread collects them
+            proc_module_collect(pm, i, lgs);
+            continue;
+        }
+
+        bool expected = false;
+        if(!__atomic_compare_exchange_n(&pm->running, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            continue;
+
+        // another thread may have collected it, before we claimed it
+        if(now_monotonic_usec() + tolerance_ut >= __atomic_load_n(&pm->next_run_ut, __ATOMIC_ACQUIRE))
+            proc_module_collect(pm, i, lgs);
+
+        __atomic_store_n(&pm->running, false, __ATOMIC_RELEASE);
+    }
+}
+
+static void proc_worker_register(void) {
+    worker_register("PROC");
+
+    for(size_t i = 0; proc_modules[i].name; i++)
+        worker_register_job_name(i, proc_modules[i].dim);
+
+    worker_register_job_custom_metric(WORKER_PROC_JOB_LATE, "late modules", "modules", WORKER_METRIC_INCREMENT);
+}
+
+static void proc_worker_thread(void *ptr __maybe_unused) {
+    proc_worker_register();
+
+    ND_LOG_STACK lgs[] = {
+            [LGS_MODULE_ID] = ND_LOG_FIELD_TXT(NDF_MODULE, "proc.plugin"),
+            ND_LOG_FIELD_END(),
+    };
+    ND_LOG_STACK_PUSH(lgs);
+
+    heartbeat_t hb;
+    heartbeat_init(&hb, localhost->rrd_update_every * USEC_PER_SEC);
+
+    while(service_running(SERVICE_COLLECTORS)) {
+        worker_is_idle();
+        heartbeat_next(&hb);
+
+        if(unlikely(!service_running(SERVICE_COLLECTORS)))
+            break;
+
+        proc_modules_collect(false, lgs);
+    }
+
+    worker_unregister();
+}
+
 void proc_main(void *ptr)
 {
     CLEANUP_FUNCTION_REGISTER(proc_main_cleanup) cleanup_ptr = ptr;
 
-    worker_register("PROC");
+    proc_worker_register();
 
     rrd_collector_started();
 
@@ -220,7 +339,7 @@ void proc_main(void *ptr)
 
     inicfg_get_boolean(&netdata_config, "plugin:proc", "/proc/pagetypeinfo", CONFIG_BOOLEAN_NO);
 
-    // check the enabled status for each module
+    // check the enabled status and the update every of each module
     int i;
     for(i = 0; proc_modules[i].name; i++) {
         struct proc_module *pm = &proc_modules[i];
@@ -228,18 +347,40 @@ void proc_main(void *ptr)
         pm->enabled = inicfg_get_boolean(&netdata_config, "plugin:proc", pm->name, CONFIG_BOOLEAN_YES);
         pm->rd = NULL;
 
-        worker_register_job_name(i, proc_modules[i].dim);
-    }
+        pm->update_every = localhost->rrd_update_every;
+        if(pm->enabled && !pm->critical) {
+            char section[CONFIG_MAX_NAME + 1];
+            snprintfz(section, sizeof(section), "plugin:proc:%s", pm->name);
+            pm->update_every = (int)inicfg_get_duration_seconds(&netdata_config, section, "update every", localhost->rrd_update_every);
+            if(pm->update_every < localhost->rrd_update_every) {
+                pm->update_every = localhost->rrd_update_every;
+                inicfg_set_duration_seconds(&netdata_config, section, "update every", pm->update_every);
+            }
+        }
 
-    heartbeat_t hb;
-    heartbeat_init(&hb, localhost->rrd_update_every * USEC_PER_SEC);
+        pm->running = false;
+        pm->next_run_ut = 0;
+        pm->last_run_ut = 0;
+    }
 
     inside_lxc_container = is_lxcfs_proc_mounted();
     is_mem_swap_enabled = is_swap_enabled();
     is_mem_zswap_enabled = is_zswap_enabled();
     is_mem_ksm_enabled = is_ksm_enabled();
 
-#define LGS_MODULE_ID 0
+    // the main thread is one of the threads collecting the modules
+    size_t threads = (size_t)inicfg_get_number(&netdata_config, "plugin:proc", "threads", MIN(3, netdata_conf_cpus()));
+    if(threads < 1) threads = 1;
+    if(threads > PROC_MAX_THREADS + 1) threads = PROC_MAX_THREADS + 1;
+
+    for(size_t t = 0; t < threads - 1 ; t++) {
+        char tag[NETDATA_THREAD_TAG_MAX + 1];
+        snprintfz(tag, sizeof(tag), "P[proc %zu]", t + 1);
+        proc_threads[proc_threads_count++] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DEFAULT, proc_worker_thread, NULL);
+    }
+
+    heartbeat_t hb;
+    heartbeat_init(&hb, localhost->rrd_update_every * USEC_PER_SEC);
 
     ND_LOG_STACK lgs[] = {
             [LGS_MODULE_ID] = ND_LOG_FIELD_TXT(NDF_MODULE, "proc.plugin"),
@@ -249,31 +390,23 @@ void proc_main(void *ptr)
 
     while(service_running(SERVICE_COLLECTORS)) {
         worker_is_idle();
-        usec_t hb_dt = heartbeat_next(&hb);
+        heartbeat_next(&hb);
 
         if(unlikely(!service_running(SERVICE_COLLECTORS)))
             break;
 
-        for(i = 0; proc_modules[i].name; i++) {
-            if(unlikely(!service_running(SERVICE_COLLECTORS)))
-                break;
-
-            struct proc_module *pm = &proc_modules[i];
-            if(unlikely(!pm->enabled))
-                continue;
-
-            worker_is_busy(i);
-            lgs[LGS_MODULE_ID] = ND_LOG_FIELD_CB(NDF_MODULE, log_proc_module, pm);
-            pm->enabled = !pm->func(localhost->rrd_update_every, hb_dt);
-            lgs[LGS_MODULE_ID] = ND_LOG_FIELD_TXT(NDF_MODULE, "proc.plugin");
-        }
+        // the critical modules first, then help the other threads
+        proc_modules_collect(true, lgs);
+        proc_modules_collect(false, lgs);
     }
 }
 
 int get_numa_node_count(void)
 {
-    static int numa_node_count = -1;
+    static int cached_numa_node_count = -1;
 
+    // it may be called by modules running on different threads
+    int numa_node_count = __atomic_load_n(&cached_numa_node_count, __ATOMIC_RELAXED);
     if (numa_node_count != -1)
         return numa_node_count;
 
@@ -301,5 +434,6 @@ int get_numa_node_count(void)
         closedir(dir);
     }
 
+    __atomic_store_n(&cached_numa_node_count, numa_node_count, __ATOMIC_RELAXED);
     return numa_node_count;
 }
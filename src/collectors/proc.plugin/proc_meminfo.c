@@ -242,9 +242,11 @@ int do_proc_meminfo(int update_every, usec_t dt) {
     unsigned long long MemUsed = MemTotal - MemFree - MemCached - Buffers;
     // The Linux kernel doesn't report ZFS ARC usage as cache memory (the ARC is included in the total used system memory)
     if (!inside_lxc_container) {
-        MemCached += (zfs_arcstats_shrinkable_cache_size_bytes / 1024);
-        MemUsed -= (zfs_arcstats_shrinkable_cache_size_bytes / 1024);
-        MemAvailable += (zfs_arcstats_shrinkable_cache_size_bytes / 1024);
+        // the zfs module updates it on a thread of the pool
+        unsigned long long zfs_arc_shrinkable = __atomic_load_n(&zfs_arcstats_shrinkable_cache_size_bytes, __ATOMIC_RELAXED);
+        MemCached += (zfs_arc_shrinkable / 1024);
+        MemUsed -= (zfs_arc_shrinkable / 1024);
+        MemAvailable += (zfs_arc_shrinkable / 1024);
     }
 
     if(do_ram) {
@@ -188,10 +188,11 @@ int do_proc_spl_kstat_zfs_arcstats(int update_every, usec_t dt) {
         if(unlikely(arl_check(arl_base, key, value))) break;
     }
 
+    // meminfo reads it on another thread
     if (arcstats.size > arcstats.c_min) {
-        zfs_arcstats_shrinkable_cache_size_bytes = arcstats.size - arcstats.c_min;
+        __atomic_store_n(&zfs_arcstats_shrinkable_cache_size_bytes, arcstats.size - arcstats.c_min, __ATOMIC_RELAXED);
     } else {
-        zfs_arcstats_shrinkable_cache_size_bytes = 0;
+        __atomic_store_n(&zfs_arcstats_shrinkable_cache_size_bytes, 0, __ATOMIC_RELAXED);
     }
 
     if(unlikely(arcstats.l2exist == -1))
@@ -71,6 +71,39 @@ static inline void sampling_query_init(LOGS_QUERY_STATUS *lqs, FACETS *facets)
         lqs->c.samples_per_time_slot.enable_after_samples = lqs->rq.entries;
 }
 
+static inline void sampling_shard_init(LOGS_QUERY_STATUS *shard, size_t shards)
+{
+    // each shard sees only a part of the files, so the global thresholds
+    // are divided among the shards, while the per file ones remain intact
+
+    memset(&shard->c.samples_per_time_slot.sampled, 0, sizeof(shard->c.samples_per_time_slot.sampled));
+    memset(&shard->c.samples_per_time_slot.unsampled, 0, sizeof(shard->c.samples_per_time_slot.unsampled));
+    shard->c.samples.sampled = 0;
+    shard->c.samples.unsampled = 0;
+    shard->c.samples.estimated = 0;
+
+    if (!shard->rq.sampling || shards < 2)
+        return;
+
+    shard->c.samples.enable_after_samples /= shards;
+
+    shard->c.samples_per_time_slot.enable_after_samples /= shards;
+    if (shard->c.samples_per_time_slot.enable_after_samples < shard->rq.entries)
+        shard->c.samples_per_time_slot.enable_after_samples = shard->rq.entries;
+}
+
+static inline void sampling_shard_merge(LOGS_QUERY_STATUS *lqs, LOGS_QUERY_STATUS *shard)
+{
+    lqs->c.samples.sampled += shard->c.samples.sampled;
+    lqs->c.samples.unsampled += shard->c.samples.unsampled;
+    lqs->c.samples.estimated += shard->c.samples.estimated;
+
+    for (size_t slot = 0; slot < ND_SD_JOURNAL_SAMPLING_SLOTS; slot++) {
+        lqs->c.samples_per_time_slot.sampled[slot] += shard->c.samples_per_time_slot.sampled[slot];
+        lqs->c.samples_per_time_slot.unsampled[slot] += shard->c.samples_per_time_slot.unsampled[slot];
+    }
+}
+
 static inline void sampling_file_init(LOGS_QUERY_STATUS *lqs, struct nd_journal_file *jf __maybe_unused)
 {
     lqs->c.samples_per_file.sampled = 0;
@@ -91,6 +91,8 @@ struct lqs_extension {
 #define FACET_MAX_VALUE_LENGTH 8192
 #define ND_SD_JOURNAL_DEFAULT_TIMEOUT 60
 #define ND_SD_JOURNAL_PROGRESS_EVERY_UT (250 * USEC_PER_MS)
+#define ND_SD_JOURNAL_QUERY_MAX_THREADS 8
+#define ND_SD_JOURNAL_QUERY_MIN_FILES_PER_THREAD 4
 #define JOURNAL_KEY_ND_JOURNAL_FILE "ND_JOURNAL_FILE"
 #define JOURNAL_KEY_ND_JOURNAL_PROCESS "ND_JOURNAL_PROCESS"
 #define JOURNAL_DEFAULT_DIRECTION FACETS_ANCHOR_DIRECTION_BACKWARD
@@ -699,6 +701,219 @@ static bool jf_is_mine(struct nd_journal_file *njf, LOGS_QUERY_STATUS *fqs)
     return false;
 }
 
+// ----------------------------------------------------------------------------
+// parallel querying of journal files
+//
+// The matched files are distributed dynamically to a number of shards.
+// Each shard has its own copy of LOGS_QUERY_STATUS and its own FACETS (a shard
+// of the main one), so that sampling and facets are evaluated independently.
+// When all shards finish, they are merged into the main FACETS.
+
+struct nd_sd_journal_file_stats {
+    ND_SD_JOURNAL_STATUS status;
+    bool executed;
+
+    usec_t duration_ut;
+    size_t rows_read;
+    size_t rows_useful;
+    size_t bytes_read;
+    usec_t matches_setup_ut;
+    size_t fs_calls;
+    size_t fs_cached;
+
+    uint32_t sampled;
+    uint32_t unsampled;
+    uint32_t estimated;
+};
+
+struct nd_sd_journal_query_files {
+    const DICTIONARY_ITEM **items;
+    struct nd_sd_journal_file_stats *stats;
+    size_t used;
+
+    size_t next;                // the next file to be queried (atomic)
+    size_t done;                // the files completed (atomic)
+    bool stop;                  // stop querying more files (atomic)
+};
+
+struct nd_sd_journal_query_shard {
+    struct nd_sd_journal_query_files *files;
+    LOGS_QUERY_STATUS *lqs;
+    LOGS_QUERY_STATUS lqs_copy;
+    ND_THREAD *thread;
+
+    size_t fs_calls;
+    size_t fs_cached;
+};
+
+static size_t nd_sd_journal_query_threads(LOGS_QUERY_STATUS *lqs, size_t files_used)
+{
+    // data only queries stop as soon as they have enough rows,
+    // so they benefit from querying the files sequentially, in order
+    if (lqs->rq.data_only || files_used < 2 * ND_SD_JOURNAL_QUERY_MIN_FILES_PER_THREAD)
+        return 1;
+
+    size_t threads = files_used / ND_SD_JOURNAL_QUERY_MIN_FILES_PER_THREAD;
+
+    size_t cpus = os_get_system_cpus();
+    if (threads > cpus)
+        threads = cpus;
+
+    if (threads > ND_SD_JOURNAL_QUERY_MAX_THREADS)
+        threads = ND_SD_JOURNAL_QUERY_MAX_THREADS;
+
+    return threads ? threads : 1;
+}
+
+static void nd_sd_journal_query_shard_worker(void *ptr)
+{
+    struct nd_sd_journal_query_shard *shard = ptr;
+    struct nd_sd_journal_query_files *files = shard->files;
+    LOGS_QUERY_STATUS *lqs = shard->lqs;
+
+    size_t fs_calls_started = fstat_thread_calls;
+    size_t fs_cached_started = fstat_thread_cached_responses;
+
+    usec_t ended_ut = now_monotonic_usec();
+    usec_t max_duration_ut = 0, progress_duration_ut = 0;
+
+    while (!__atomic_load_n(&files->stop, __ATOMIC_RELAXED)) {
+        size_t f = __atomic_fetch_add(&files->next, 1, __ATOMIC_RELAXED);
+        if (f >= files->used)
+            break;
+
+        struct nd_sd_journal_file_stats *st = &files->stats[f];
+        const char *filename = dictionary_acquired_item_name(files->items[f]);
+        struct nd_journal_file *njf = dictionary_acquired_item_value(files->items[f]);
+
+        if (!jf_is_mine(njf, lqs))
+            continue;
+
+        usec_t started_ut = ended_ut;
+
+        // do not even try to do the query if we expect it to pass the timeout
+        if (ended_ut + max_duration_ut * 3 >= *lqs->stop_monotonic_ut) {
+            st->status = ND_SD_JOURNAL_TIMED_OUT;
+            __atomic_store_n(&files->stop, true, __ATOMIC_RELAXED);
+            break;
+        }
+
+        lqs->c.file_working++;
+
+        size_t fs_calls = fstat_thread_calls;
+        size_t fs_cached = fstat_thread_cached_responses;
+        size_t rows_useful = lqs->c.rows_useful;
+        size_t rows_read = lqs->c.rows_read;
+        size_t bytes_read = lqs->c.bytes_read;
+        size_t matches_setup_ut = lqs->c.matches_setup_ut;
+
+        sampling_file_init(lqs, njf);
+
+        st->status = nd_sd_journal_query_one_file(filename, NULL, lqs->facets, njf, lqs);
+        st->executed = true;
+
+        st->rows_useful = lqs->c.rows_useful - rows_useful;
+        st->rows_read = lqs->c.rows_read - rows_read;
+        st->bytes_read = lqs->c.bytes_read - bytes_read;
+        st->matches_setup_ut = lqs->c.matches_setup_ut - matches_setup_ut;
+        st->fs_calls = fstat_thread_calls - fs_calls;
+        st->fs_cached = fstat_thread_cached_responses - fs_cached;
+        st->sampled = lqs->c.samples_per_file.sampled;
+        st->unsampled = lqs->c.samples_per_file.unsampled;
+        st->estimated = lqs->c.samples_per_file.estimated;
+
+        ended_ut = now_monotonic_usec();
+        st->duration_ut = ended_ut - started_ut;
+
+        if (st->duration_ut > max_duration_ut)
+            max_duration_ut = st->duration_ut;
+
+        size_t done = __atomic_add_fetch(&files->done, 1, __ATOMIC_RELAXED);
+
+        progress_duration_ut += st->duration_ut;
+        if (progress_duration_ut >= ND_SD_JOURNAL_PROGRESS_EVERY_UT) {
+            progress_duration_ut = 0;
+            netdata_mutex_lock(&stdout_mutex);
+            pluginsd_function_progress_to_stdout(lqs->rq.transaction, done, files->used);
+            netdata_mutex_unlock(&stdout_mutex);
+        }
+
+        if (st->status == ND_SD_JOURNAL_CANCELLED || st->status == ND_SD_JOURNAL_TIMED_OUT) {
+            __atomic_store_n(&files->stop, true, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+
+    shard->fs_calls = fstat_thread_calls - fs_calls_started;
+    shard->fs_cached = fstat_thread_cached_responses - fs_cached_started;
+}
+
+static void nd_sd_journal_query_shards_run(LOGS_QUERY_STATUS *lqs, struct nd_sd_journal_query_files *files, size_t threads)
+{
+    if (threads < 2) {
+        struct nd_sd_journal_query_shard shard = {
+            .files = files,
+            .lqs = lqs,
+        };
+        nd_sd_journal_query_shard_worker(&shard);
+        return;
+    }
+
+    struct nd_sd_journal_query_shard *shards = callocz(threads, sizeof(*shards));
+
+    for (size_t t = 0; t < threads; t++) {
+        struct nd_sd_journal_query_shard *shard = &shards[t];
+        shard->files = files;
+        shard->lqs_copy = *lqs;
+        shard->lqs_copy.facets = facets_create_shard(lqs->facets);
+        shard->lqs = &shard->lqs_copy;
+        sampling_shard_init(shard->lqs, threads);
+    }
+
+    // the last shard runs on this thread
+    for (size_t t = 0; t < threads - 1; t++) {
+        char tag[ND_THREAD_TAG_MAX + 1];
+        snprintfz(tag, sizeof(tag), "SDJQ[%zu]", t);
+        shards[t].thread =
+            nd_thread_create(tag, NETDATA_THREAD_OPTION_DONT_LOG, nd_sd_journal_query_shard_worker, &shards[t]);
+
+        if (!shards[t].thread)
+            // we could not spawn a thread, run it here
+            nd_sd_journal_query_shard_worker(&shards[t]);
+    }
+
+    nd_sd_journal_query_shard_worker(&shards[threads - 1]);
+
+    for (size_t t = 0; t < threads; t++) {
+        struct nd_sd_journal_query_shard *shard = &shards[t];
+        LOGS_QUERY_STATUS *s = shard->lqs;
+
+        if (shard->thread)
+            nd_thread_join(shard->thread);
+
+        facets_merge(lqs->facets, s->facets);
+        facets_destroy(s->facets);
+        sampling_shard_merge(lqs, s);
+
+        lqs->c.rows_useful += s->c.rows_useful;
+        lqs->c.rows_read += s->c.rows_read;
+        lqs->c.bytes_read += s->c.bytes_read;
+        lqs->c.matches_setup_ut += s->c.matches_setup_ut;
+        lqs->c.file_working += s->c.file_working;
+
+        if (s->last_modified > lqs->last_modified)
+            lqs->last_modified = s->last_modified;
+
+        if (shard->thread) {
+            // the inline shards are already accounted on this thread
+            fstat_thread_calls += shard->fs_calls;
+            fstat_thread_cached_responses += shard->fs_cached;
+        }
+    }
+
+    freez(shards);
+}
+
 static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
 {
     FACETS *facets = lqs->facets;
@@ -714,13 +929,13 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
 
     size_t files_used = 0;
     size_t files_max = dictionary_entries(nd_journal_files_registry);
-    const DICTIONARY_ITEM *file_items[files_max];
+    const DICTIONARY_ITEM **file_items = mallocz(MAX(files_max, 1) * sizeof(*file_items));
 
     // count the files
     bool files_are_newer = false;
     dfe_start_read(nd_journal_files_registry, njf)
     {
-        if (!jf_is_mine(njf, lqs))
+        if (files_used >= files_max || !jf_is_mine(njf, lqs))
             continue;
 
         file_items[files_used++] = dictionary_acquired_item_dup(nd_journal_files_registry, njf_dfe.item);
@@ -737,6 +952,7 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
         for (size_t f = 0; f < files_used; f++)
             dictionary_acquired_item_release(nd_journal_files_registry, file_items[f]);
 
+        freez(file_items);
         return rrd_call_function_error(wb, "No new data since the previous call.", HTTP_RESP_NOT_MODIFIED);
     }
 
@@ -749,64 +965,32 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
     }
 
     bool partial = false;
-    usec_t query_started_ut = now_monotonic_usec();
-    usec_t started_ut = query_started_ut;
-    usec_t ended_ut = started_ut;
-    usec_t duration_ut = 0, max_duration_ut = 0;
-    usec_t progress_duration_ut = 0;
 
     sampling_query_init(lqs, facets);
 
+    struct nd_sd_journal_query_files files = {
+        .items = file_items,
+        .stats = callocz(MAX(files_used, 1), sizeof(struct nd_sd_journal_file_stats)),
+        .used = files_used,
+    };
+
+    nd_sd_journal_query_shards_run(lqs, &files, nd_sd_journal_query_threads(lqs, files_used));
+
     buffer_json_member_add_array(wb, "_journal_files");
     for (size_t f = 0; f < files_used; f++) {
-        const char *filename = dictionary_acquired_item_name(file_items[f]);
-        njf = dictionary_acquired_item_value(file_items[f]);
+        struct nd_sd_journal_file_stats *st = &files.stats[f];
 
-        if (!jf_is_mine(njf, lqs))
+        if (!st->executed) {
+            if (st->status == ND_SD_JOURNAL_TIMED_OUT) {
+                // the query of this file was not even attempted
+                partial = true;
+                status = ND_SD_JOURNAL_TIMED_OUT;
+            }
             continue;
-
-        started_ut = ended_ut;
-
-        // do not even try to do the query if we expect it to pass the timeout
-        if (ended_ut + max_duration_ut * 3 >= *lqs->stop_monotonic_ut) {
-            partial = true;
-            status = ND_SD_JOURNAL_TIMED_OUT;
-            break;
         }
 
-        lqs->c.file_working++;
-
-        size_t fs_calls = fstat_thread_calls;
-        size_t fs_cached = fstat_thread_cached_responses;
-        size_t rows_useful = lqs->c.rows_useful;
-        size_t rows_read = lqs->c.rows_read;
-        size_t bytes_read = lqs->c.bytes_read;
-        size_t matches_setup_ut = lqs->c.matches_setup_ut;
-
-        sampling_file_init(lqs, njf);
-
-        ND_SD_JOURNAL_STATUS tmp_status = nd_sd_journal_query_one_file(filename, wb, facets, njf, lqs);
-
-        rows_useful = lqs->c.rows_useful - rows_useful;
-        rows_read = lqs->c.rows_read - rows_read;
-        bytes_read = lqs->c.bytes_read - bytes_read;
-        matches_setup_ut = lqs->c.matches_setup_ut - matches_setup_ut;
-        fs_calls = fstat_thread_calls - fs_calls;
-        fs_cached = fstat_thread_cached_responses - fs_cached;
-
-        ended_ut = now_monotonic_usec();
-        duration_ut = ended_ut - started_ut;
-
-        if (duration_ut > max_duration_ut)
-            max_duration_ut = duration_ut;
-
-        progress_duration_ut += duration_ut;
-        if (progress_duration_ut >= ND_SD_JOURNAL_PROGRESS_EVERY_UT) {
-            progress_duration_ut = 0;
-            netdata_mutex_lock(&stdout_mutex);
-            pluginsd_function_progress_to_stdout(lqs->rq.transaction, f + 1, files_used);
-            netdata_mutex_unlock(&stdout_mutex);
-        }
+        const char *filename = dictionary_acquired_item_name(file_items[f]);
+        njf = dictionary_acquired_item_value(file_items[f]);
 
         buffer_json_add_array_item_object(wb); // journal file
         {
@@ -820,24 +1004,24 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
             buffer_json_member_add_uint64(wb, "_journal_vs_realtime_delta_ut", njf->max_journal_vs_realtime_delta_ut);
 
             // information about the current use of the file
-            buffer_json_member_add_uint64(wb, "duration_ut", ended_ut - started_ut);
-            buffer_json_member_add_uint64(wb, "rows_read", rows_read);
-            buffer_json_member_add_uint64(wb, "rows_useful", rows_useful);
+            buffer_json_member_add_uint64(wb, "duration_ut", st->duration_ut);
+            buffer_json_member_add_uint64(wb, "rows_read", st->rows_read);
+            buffer_json_member_add_uint64(wb, "rows_useful", st->rows_useful);
             buffer_json_member_add_double(
-                wb, "rows_per_second", (double)rows_read / (double)duration_ut * (double)USEC_PER_SEC);
-            buffer_json_member_add_uint64(wb, "bytes_read", bytes_read);
+                wb, "rows_per_second", (double)st->rows_read / (double)st->duration_ut * (double)USEC_PER_SEC);
+            buffer_json_member_add_uint64(wb, "bytes_read", st->bytes_read);
             buffer_json_member_add_double(
-                wb, "bytes_per_second", (double)bytes_read / (double)duration_ut * (double)USEC_PER_SEC);
-            buffer_json_member_add_uint64(wb, "duration_matches_ut", matches_setup_ut);
-            buffer_json_member_add_uint64(wb, "fstat_query_calls", fs_calls);
-            buffer_json_member_add_uint64(wb, "fstat_query_cached_responses", fs_cached);
+                wb, "bytes_per_second", (double)st->bytes_read / (double)st->duration_ut * (double)USEC_PER_SEC);
+            buffer_json_member_add_uint64(wb, "duration_matches_ut", st->matches_setup_ut);
+            buffer_json_member_add_uint64(wb, "fstat_query_calls", st->fs_calls);
+            buffer_json_member_add_uint64(wb, "fstat_query_cached_responses", st->fs_cached);
 
             if (lqs->rq.sampling) {
                 buffer_json_member_add_object(wb, "_sampling");
                 {
-                    buffer_json_member_add_uint64(wb, "sampled", lqs->c.samples_per_file.sampled);
-                    buffer_json_member_add_uint64(wb, "unsampled", lqs->c.samples_per_file.unsampled);
-                    buffer_json_member_add_uint64(wb, "estimated", lqs->c.samples_per_file.estimated);
+                    buffer_json_member_add_uint64(wb, "sampled", st->sampled);
+                    buffer_json_member_add_uint64(wb, "unsampled", st->unsampled);
+                    buffer_json_member_add_uint64(wb, "estimated", st->estimated);
                 }
                 buffer_json_object_close(wb); // _sampling
             }
@@ -845,24 +1029,24 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
         buffer_json_object_close(wb); // journal file
 
         bool stop = false;
-        switch (tmp_status) {
+        switch (st->status) {
             case ND_SD_JOURNAL_OK:
             case ND_SD_JOURNAL_NO_FILE_MATCHED:
-                status = (status == ND_SD_JOURNAL_OK) ? ND_SD_JOURNAL_OK : tmp_status;
+                status = (status == ND_SD_JOURNAL_OK) ? ND_SD_JOURNAL_OK : st->status;
                 break;
 
             case ND_SD_JOURNAL_FAILED_TO_OPEN:
             case ND_SD_JOURNAL_FAILED_TO_SEEK:
                 partial = true;
                 if (status == ND_SD_JOURNAL_NO_FILE_MATCHED)
-                    status = tmp_status;
+                    status = st->status;
                 break;
 
             case ND_SD_JOURNAL_CANCELLED:
             case ND_SD_JOURNAL_TIMED_OUT:
                 partial = true;
                 stop = true;
-                status = tmp_status;
+                status = st->status;
                 break;
 
             case ND_SD_JOURNAL_NOT_MODIFIED:
@@ -879,6 +1063,9 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
     for (size_t f = 0; f < files_used; f++)
         dictionary_acquired_item_release(nd_journal_files_registry, file_items[f]);
 
+    freez(files.stats);
+    freez(file_items);
+
     switch (status) {
         case ND_SD_JOURNAL_OK:
             if (lqs->rq.if_modified_since && !lqs->c.rows_useful)
@@ -322,6 +322,10 @@ int main(int argc, char **argv) {
         fprintf(stderr, "Sockets       [ found: %zu ]\n",
                 ls.stats.sockets_added);
 
+        fprintf(stderr, "\n");
+        fprintf(stderr, "Processes     [ scanned: %zu, cached: %zu ]\n",
+                ls.stats.pid_index_pids_scanned, ls.stats.pid_index_pids_cached);
+
         fprintf(stderr, "\n");
         fprintf(stderr, "Main Procfile [ opens: %zu, reads: %zu, resizes: %zu, memory: %zu ]\n"
                         "  \\_    reads [ total bytes read: %zu, average read size: %zu, max read size: %zu ]\n"
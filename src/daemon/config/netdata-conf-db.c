@@ -8,6 +8,8 @@ int default_rrd_history_entries = RRD_DEFAULT_HISTORY_ENTRIES;
 
 bool dbengine_enabled = false; // will become true if and when dbengine is initialized
 bool dbengine_use_direct_io = true;
+bool dbengine_tiers_background_downsampling = false;
+bool dbengine_elide_constant_pages = false;
 static size_t storage_tiers_grouping_iterations[RRD_STORAGE_TIERS] = {1, 60, 60, 60, 60};
 static time_t storage_tiers_retention_time_s[RRD_STORAGE_TIERS] = {14 * DAYS, 90 * DAYS, 2 * 365 * DAYS, 2 * 365 * DAYS, 2 * 365 * DAYS};
 
@@ -45,6 +47,8 @@ static void netdata_conf_dbengine_pre_logs(void) {
         tier_page_type[0] = RRDENG_PAGE_TYPE_GORILLA_32BIT;
     else if (strcmp(page_type, "raw") == 0)
         tier_page_type[0] = RRDENG_PAGE_TYPE_ARRAY_32BIT;
+    else if (strcmp(page_type, "adaptive") == 0)
+        tier_page_type[0] = RRDENG_PAGE_TYPE_ADAPTIVE_32BIT;
     else {
         tier_page_type[0] = RRDENG_PAGE_TYPE_ARRAY_32BIT;
         netdata_log_error("Invalid dbengine page type ''%s' given. Defaulting to 'raw'.", page_type);
@@ -208,6 +212,9 @@ void netdata_conf_dbengine_init(const char *hostname) {
         inicfg_set_number(&netdata_config, CONFIG_SECTION_DB, "storage tiers", nd_profile.storage_tiers);
     }
 
+    dbengine_tiers_background_downsampling = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_DB, "dbengine tiers background downsampling", dbengine_tiers_background_downsampling);
+    dbengine_elide_constant_pages = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_DB, "dbengine elide constant pages", dbengine_elide_constant_pages);
+
     new_dbengine_defaults =
         (!legacy_multihost_db_space &&
          !inicfg_exists(&netdata_config, CONFIG_SECTION_DB, "dbengine tier 1 update every iterations") &&
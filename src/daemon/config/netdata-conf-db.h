@@ -7,6 +7,8 @@
 
 extern bool dbengine_enabled;
 extern bool dbengine_use_direct_io;
+extern bool dbengine_tiers_background_downsampling;
+extern bool dbengine_elide_constant_pages;
 
 extern int default_rrd_history_entries;
 extern int gap_when_lost_iterations_above;
@@ -37,6 +37,8 @@ void netdata_conf_section_logs(void) {
     logs = (unsigned long)inicfg_get_number(&netdata_config, CONFIG_SECTION_LOGS, "logs to trigger flood protection", (long long int)logs);
     nd_log_set_flood_protection(logs, period);
 
+    nd_log_set_async(inicfg_get_boolean(&netdata_config, CONFIG_SECTION_LOGS, "async", CONFIG_BOOLEAN_NO));
+
     const char *netdata_log_level = getenv("NETDATA_LOG_LEVEL");
     netdata_log_level = netdata_log_level ? nd_log_id2priority(nd_log_priority2id(netdata_log_level)) : NDLP_INFO_STR;
 
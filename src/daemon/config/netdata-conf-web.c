@@ -139,6 +139,23 @@ void netdata_conf_section_web(void) {
         netdata_log_error("Invalid compression level %d. Valid levels are 1 (fastest) to 9 (best ratio). Proceeding with level 9 (best compression).", web_gzip_level);
         web_gzip_level = 9;
     }
+
+    web_enable_brotli = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_WEB, "enable brotli compression", web_enable_brotli);
+    web_brotli_level = (int)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "brotli compression level", web_brotli_level);
+    if(web_brotli_level < 0 || web_brotli_level > 11) {
+        netdata_log_error("Invalid brotli compression level %d. Valid levels are 0 (fastest) to 11 (best ratio). Proceeding with level 4.", web_brotli_level);
+        web_brotli_level = 4;
+    }
+
+    web_enable_zstd = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_WEB, "enable zstd compression", web_enable_zstd);
+    web_zstd_level = (int)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "zstd compression level", web_zstd_level);
+    if(web_zstd_level < 1 || web_zstd_level > 19) {
+        netdata_log_error("Invalid zstd compression level %d. Valid levels are 1 (fastest) to 19 (best ratio). Proceeding with level 3.", web_zstd_level);
+        web_zstd_level = 3;
+    }
+
+    web_static_files_cache_init(
+        (size_t)inicfg_get_size_bytes(&netdata_config, CONFIG_SECTION_WEB, "static files compression cache size", 64 * 1024 * 1024));
 }
 
 void netdata_conf_web_security_init(void) {
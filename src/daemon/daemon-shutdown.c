@@ -264,6 +264,8 @@ static void netdata_cleanup_and_exit(EXIT_REASON reason, bool abnormal, bool exi
     {
         // exit cleanly
         rrd_finalize_collection_for_all_hosts();
+        rrdhost_ingestion_stop();
+        rrddim_downsampling_stop();
         watcher_step_complete(WATCHER_STEP_ID_STOP_COLLECTION_FOR_ALL_HOSTS);
 
 #ifdef ENABLE_DBENGINE
@@ -333,6 +335,9 @@ static void netdata_cleanup_and_exit(EXIT_REASON reason, bool abnormal, bool exi
     watcher_shutdown_end();
     watcher_thread_stop();
 
+    // write the queued log messages, everything logged from now on is written synchronously
+    nd_log_async_stop();
+
 #if defined(FSANITIZE_ADDRESS)
     fprintf(stderr, "\n");
 
@@ -40,6 +40,7 @@ enum event_loop_job {
     UV_EVENT_DBENGINE_EVICT_OPEN_CACHE,
     UV_EVENT_DBENGINE_EVICT_EXTENT_CACHE,
     UV_EVENT_DBENGINE_BUFFERS_CLEANUP,
+    UV_EVENT_DBENGINE_PREFETCH,
     UV_EVENT_DBENGINE_FLUSH_DIRTY,
     UV_EVENT_DBENGINE_QUIESCE,
     UV_EVENT_DBENGINE_MRG_LOAD,
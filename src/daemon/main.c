@@ -167,6 +167,11 @@ int help(int exitcode) {
             "  -W cmakecache            Print the cmake cache used for building this agent\n"
             "  -W simple-pattern pattern string\n"
             "                           Check if string matches pattern and exit.\n\n"
+            "  -W simplepatterntest     Verify and benchmark compiled simple patterns and exit.\n\n"
+            "  -W procfiletest          Verify and benchmark the procfile parser on /proc snapshots and exit.\n\n"
+            "  -W collectionbench       Benchmark storing collected points per dimension and per chart and exit.\n\n"
+            "  -W ingestionbench        Benchmark storing the same chart updates inline and via the ingestion pipeline and exit.\n\n"
+            "  -W logbench              Benchmark logging from many threads synchronously and asynchronously and exit.\n\n"
 #ifdef OS_WINDOWS
             "  -W perflibdump [key]\n"
             "                           Dump the Windows Performance Counters Registry in JSON.\n\n"
@@ -213,6 +218,8 @@ int buffer_unittest(void);
 int pgc_unittest(void);
 int mrg_unittest(void);
 int pluginsd_parser_unittest(void);
+int pluginsd_shm_benchmark(void);
+int pluginsd_shm_unittest(void);
 void replication_initialize(void);
 void bearer_tokens_init(void);
 int unittest_stream_compressions(void);
@@ -430,6 +437,7 @@ int netdata_main(int argc, char **argv) {
                             // No call to load the config file on this code-path
                             if (unittest_prepare_rrd(&user)) return 1;
                             if (run_all_mockup_tests()) return 1;
+                            if (pluginsd_shm_unittest()) return 1;
                             if (unit_test_storage()) return 1;
 #ifdef ENABLE_DBENGINE
                             if (test_dbengine()) return 1;
@@ -503,6 +511,36 @@ int netdata_main(int argc, char **argv) {
                             unittest_running = true;
                             return string_unittest(10000);
                         }
+                        else if(strcmp(optarg, "simplepatterntest") == 0) {
+                            unittest_running = true;
+                            return simple_pattern_unittest();
+                        }
+                        else if(strcmp(optarg, "procfiletest") == 0) {
+                            unittest_running = true;
+                            return procfile_unittest();
+                        }
+                        else if(strcmp(optarg, "logbench") == 0) {
+                            unittest_running = true;
+                            return nd_log_async_benchmark();
+                        }
+                        else if(strcmp(optarg, "collectionbench") == 0) {
+                            unittest_running = true;
+                            if (sqlite_library_init())
+                                return 1;
+                            rrdlabels_aral_init(false);
+                            if (unittest_prepare_rrd(&user))
+                                return 1;
+                            return collection_benchmark();
+                        }
+                        else if(strcmp(optarg, "ingestionbench") == 0) {
+                            unittest_running = true;
+                            if (sqlite_library_init())
+                                return 1;
+                            rrdlabels_aral_init(false);
+                            if (unittest_prepare_rrd(&user))
+                                return 1;
+                            return ingestion_benchmark();
+                        }
                         else if(strcmp(optarg, "rrdlabelstest") == 0) {
                             unittest_running = true;
                             rrdlabels_aral_init(true);
@@ -570,6 +608,19 @@ int netdata_main(int argc, char **argv) {
                             unittest_running = true;
                             return pluginsd_parser_unittest();
                         }
+                        else if(strcmp(optarg, "pluginsd-shm-test") == 0) {
+                            unittest_running = true;
+                            if (sqlite_library_init())
+                                return 1;
+                            rrdlabels_aral_init(false);
+                            if (unittest_prepare_rrd(&user))
+                                return 1;
+                            return pluginsd_shm_unittest();
+                        }
+                        else if(strcmp(optarg, "pluginsd-shm-benchmark") == 0) {
+                            unittest_running = true;
+                            return pluginsd_shm_benchmark();
+                        }
                         else if(strcmp(optarg, "stream_compressions_test") == 0) {
                             unittest_running = true;
                             return unittest_stream_compressions();
@@ -1094,6 +1145,9 @@ int netdata_main(int argc, char **argv) {
 
     netdata_conf_reset_stack_size();
 
+    // the logger thread has to be started after forking
+    nd_log_async_start();
+
     // ----------------------------------------------------------------------------------------------------------------
     delta_startup_time("registry");
 
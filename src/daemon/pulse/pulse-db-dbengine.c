@@ -1088,6 +1088,8 @@ void pulse_dbengine_do(bool extended) {
         static RRDDIM *rd_pages_main_cache = NULL;
         static RRDDIM *rd_pages_disk = NULL;
         static RRDDIM *rd_pages_extent_cache = NULL;
+        static RRDDIM *rd_pages_constant = NULL;
+        static RRDDIM *rd_pages_summary = NULL;
 
         if (unlikely(!st_query_pages_data_source)) {
             st_query_pages_data_source = rrdset_create_localhost(
@@ -1107,16 +1109,141 @@ void pulse_dbengine_do(bool extended) {
             rd_pages_main_cache = rrddim_add(st_query_pages_data_source, "main cache", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
             rd_pages_disk = rrddim_add(st_query_pages_data_source, "disk", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
             rd_pages_extent_cache = rrddim_add(st_query_pages_data_source, "extent cache", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_pages_constant = rrddim_add(st_query_pages_data_source, "constant", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_pages_summary = rrddim_add(st_query_pages_data_source, "summary", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
         }
         priority++;
 
         rrddim_set_by_pointer(st_query_pages_data_source, rd_pages_main_cache, (collected_number)cache_efficiency_stats.pages_data_source_main_cache + (collected_number)cache_efficiency_stats.pages_data_source_main_cache_at_pass4);
         rrddim_set_by_pointer(st_query_pages_data_source, rd_pages_disk, (collected_number)cache_efficiency_stats.pages_to_load_from_disk);
         rrddim_set_by_pointer(st_query_pages_data_source, rd_pages_extent_cache, (collected_number)cache_efficiency_stats.pages_data_source_extent_cache);
+        rrddim_set_by_pointer(st_query_pages_data_source, rd_pages_constant, (collected_number)cache_efficiency_stats.pages_data_source_constant);
+        rrddim_set_by_pointer(st_query_pages_data_source, rd_pages_summary, (collected_number)cache_efficiency_stats.pages_data_source_summary);
 
         rrdset_done(st_query_pages_data_source);
     }
 
+    {
+        static RRDSET *st_constant_pages = NULL;
+        static RRDDIM *rd_elided = NULL;
+
+        if (unlikely(!st_constant_pages)) {
+            st_constant_pages = rrdset_create_localhost(
+                "netdata",
+                "dbengine_constant_pages_elided",
+                NULL,
+                "dbengine io",
+                NULL,
+                "Netdata DB engine constant pages elided from extents",
+                "pages/s",
+                "netdata",
+                "pulse",
+                priority,
+                localhost->rrd_update_every,
+                RRDSET_TYPE_LINE);
+
+            rd_elided = rrddim_add(st_constant_pages, "elided", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+        priority++;
+
+        rrddim_set_by_pointer(st_constant_pages, rd_elided, (collected_number)cache_efficiency_stats.pages_constant_elided);
+
+        rrdset_done(st_constant_pages);
+    }
+
+    {
+        static RRDSET *st_constant_bytes = NULL;
+        static RRDDIM *rd_saved = NULL;
+
+        if (unlikely(!st_constant_bytes)) {
+            st_constant_bytes = rrdset_create_localhost(
+                "netdata",
+                "dbengine_constant_pages_saved",
+                NULL,
+                "dbengine io",
+                NULL,
+                "Netdata DB engine bytes saved by eliding constant pages",
+                "KiB/s",
+                "netdata",
+                "pulse",
+                priority,
+                localhost->rrd_update_every,
+                RRDSET_TYPE_AREA);
+
+            rd_saved = rrddim_add(st_constant_bytes, "saved", NULL, 1, 1024, RRD_ALGORITHM_INCREMENTAL);
+        }
+        priority++;
+
+        rrddim_set_by_pointer(st_constant_bytes, rd_saved, (collected_number)cache_efficiency_stats.pages_constant_elided_bytes);
+
+        rrdset_done(st_constant_bytes);
+    }
+
+    {
+        static RRDSET *st_prefetch = NULL;
+        static RRDDIM *rd_issued = NULL;
+        static RRDDIM *rd_not_needed = NULL;
+        static RRDDIM *rd_hit = NULL;
+        static RRDDIM *rd_waste = NULL;
+
+        if (unlikely(!st_prefetch)) {
+            st_prefetch = rrdset_create_localhost(
+                "netdata",
+                "dbengine_prefetch",
+                NULL,
+                "dbengine query router",
+                NULL,
+                "Netdata DB engine hot window prefetches",
+                "windows/s",
+                "netdata",
+                "pulse",
+                priority,
+                localhost->rrd_update_every,
+                RRDSET_TYPE_LINE);
+
+            rd_issued = rrddim_add(st_prefetch, "issued", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_not_needed = rrddim_add(st_prefetch, "not needed", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_hit = rrddim_add(st_prefetch, "hit", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_waste = rrddim_add(st_prefetch, "waste", NULL, -1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+        priority++;
+
+        rrddim_set_by_pointer(st_prefetch, rd_issued, (collected_number)cache_efficiency_stats.prefetch_issued);
+        rrddim_set_by_pointer(st_prefetch, rd_not_needed, (collected_number)cache_efficiency_stats.prefetch_not_needed);
+        rrddim_set_by_pointer(st_prefetch, rd_hit, (collected_number)cache_efficiency_stats.prefetch_hit);
+        rrddim_set_by_pointer(st_prefetch, rd_waste, (collected_number)cache_efficiency_stats.prefetch_waste);
+
+        rrdset_done(st_prefetch);
+    }
+
+    {
+        static RRDSET *st_prefetch_pages = NULL;
+        static RRDDIM *rd_prefetched = NULL;
+
+        if (unlikely(!st_prefetch_pages)) {
+            st_prefetch_pages = rrdset_create_localhost(
+                "netdata",
+                "dbengine_prefetch_pages",
+                NULL,
+                "dbengine query router",
+                NULL,
+                "Netdata DB engine pages loaded by the hot window prefetcher",
+                "pages/s",
+                "netdata",
+                "pulse",
+                priority,
+                localhost->rrd_update_every,
+                RRDSET_TYPE_LINE);
+
+            rd_prefetched = rrddim_add(st_prefetch_pages, "prefetched", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+        priority++;
+
+        rrddim_set_by_pointer(st_prefetch_pages, rd_prefetched, (collected_number)cache_efficiency_stats.prefetch_pages);
+
+        rrdset_done(st_prefetch_pages);
+    }
+
     {
         static RRDSET *st_query_next_page = NULL;
         static RRDDIM *rd_pass4 = NULL;
@@ -16,8 +16,252 @@ static struct web_statistics {
 
     PAD64(uint64_t) content_size_uncompressed;
     PAD64(uint64_t) content_size_compressed;
+
+    PAD64(uint64_t) executor_queries;
+    PAD64(uint64_t) executor_overflows;
 } live_stats = { 0 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// query executor queue and execution time heatmaps
+
+#define WEB_EXECUTOR_HISTOGRAM_ENTRIES 16
+
+// the histogram MUST be all-inclusive for the possible durations,
+// so we start from 0, and the last value is UINT64_MAX.
+static const usec_t web_executor_histogram_upto[WEB_EXECUTOR_HISTOGRAM_ENTRIES] = {
+    // minimum
+    0,
+
+    // ms
+    1 * USEC_PER_MS, 5 * USEC_PER_MS, 10 * USEC_PER_MS, 25 * USEC_PER_MS, 50 * USEC_PER_MS,
+    100 * USEC_PER_MS, 250 * USEC_PER_MS, 500 * USEC_PER_MS,
+
+    // seconds
+    1 * USEC_PER_SEC, 2 * USEC_PER_SEC, 5 * USEC_PER_SEC, 10 * USEC_PER_SEC,
+    30 * USEC_PER_SEC, 60 * USEC_PER_SEC,
+
+    // maximum
+    UINT64_MAX
+};
+
+static struct web_executor_histogram {
+    size_t count[WEB_EXECUTOR_HISTOGRAM_ENTRIES];
+} web_executor_queue_heatmap = { 0 }, web_executor_exec_heatmap = { 0 };
+
+static inline size_t web_executor_histogram_slot(usec_t dt_ut) {
+    if(dt_ut <= web_executor_histogram_upto[0])
+        return 0;
+
+    if(dt_ut >= web_executor_histogram_upto[WEB_EXECUTOR_HISTOGRAM_ENTRIES - 1])
+        return WEB_EXECUTOR_HISTOGRAM_ENTRIES - 1;
+
+    // binary search for the first slot that includes this duration
+    size_t low = 1, high = WEB_EXECUTOR_HISTOGRAM_ENTRIES - 1;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (dt_ut <= web_executor_histogram_upto[mid])
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+void pulse_web_request_executed(usec_t queue_ut, usec_t exec_ut) {
+    __atomic_fetch_add(&live_stats.executor_queries, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&web_executor_queue_heatmap.count[web_executor_histogram_slot(queue_ut)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&web_executor_exec_heatmap.count[web_executor_histogram_slot(exec_ut)], 1, __ATOMIC_RELAXED);
+}
+
+void pulse_web_request_executor_overflow(void) {
+    __atomic_fetch_add(&live_stats.executor_overflows, 1, __ATOMIC_RELAXED);
+}
+
+static void pulse_web_executor_heatmap(struct web_executor_histogram *h, const char *id, const char *context, const char *title, long priority, RRDSET **st, RRDDIM **rds) {
+    if(unlikely(!*st)) {
+        *st = rrdset_create_localhost(
+            "netdata"
+            , id
+            , NULL
+            , "HTTP API"
+            , context
+            , title
+            , "queries"
+            , "netdata"
+            , "pulse"
+            , priority
+            , localhost->rrd_update_every
+            , RRDSET_TYPE_HEATMAP
+        );
+
+        rds[0] = rrddim_add(*st, "instant", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+        for(size_t i = 1; i < WEB_EXECUTOR_HISTOGRAM_ENTRIES - 1 ;i++) {
+            char buf[64];
+            snprintfz(buf, sizeof(buf) - 1, "%.3fs", (double)web_executor_histogram_upto[i] / (double)USEC_PER_SEC);
+            rds[i] = rrddim_add(*st, buf, NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+        }
+        rds[WEB_EXECUTOR_HISTOGRAM_ENTRIES - 1] = rrddim_add(*st, "+inf", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    for(size_t i = 0; i < WEB_EXECUTOR_HISTOGRAM_ENTRIES ;i++) {
+        size_t old_value = 0, new_value = 0;
+        __atomic_exchange(&h->count[i], &new_value, &old_value, __ATOMIC_RELAXED);
+        rrddim_set_by_pointer(*st, rds[i], (collected_number)old_value);
+    }
+
+    rrdset_done(*st);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// responses compression per content encoding
+
+typedef enum __attribute__((packed)) {
+    WEB_COMPRESSION_GZIP = 0,
+    WEB_COMPRESSION_BROTLI,
+    WEB_COMPRESSION_ZSTD,
+
+    // terminator
+    WEB_COMPRESSION_MAX,
+} WEB_COMPRESSION;
+
+static const HTTP_CONTENT_ENCODING web_compression_encoding[WEB_COMPRESSION_MAX] = {
+    [WEB_COMPRESSION_GZIP] = HTTP_CONTENT_ENCODING_GZIP,
+    [WEB_COMPRESSION_BROTLI] = HTTP_CONTENT_ENCODING_BROTLI,
+    [WEB_COMPRESSION_ZSTD] = HTTP_CONTENT_ENCODING_ZSTD,
+};
+
+static struct web_compression_statistics {
+    PAD64(uint64_t) responses;
+    PAD64(uint64_t) bytes_in;
+    PAD64(uint64_t) bytes_out;
+    PAD64(uint64_t) usec;
+} web_compression_stats[WEB_COMPRESSION_MAX] = { 0 };
+
+void pulse_web_response_compressed(HTTP_CONTENT_ENCODING encoding, size_t bytes_in, size_t bytes_out, usec_t ut) {
+    for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++) {
+        if(web_compression_encoding[i] != encoding)
+            continue;
+
+        struct web_compression_statistics *ws = &web_compression_stats[i];
+        __atomic_fetch_add(&ws->responses, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ws->bytes_in, bytes_in, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ws->bytes_out, bytes_out, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ws->usec, ut, __ATOMIC_RELAXED);
+        break;
+    }
+}
+
+static void pulse_web_compression_do(void) {
+    struct web_compression_statistics ws[WEB_COMPRESSION_MAX];
+    for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++) {
+        // read the smaller value first, since we don't lock
+        ws[i].bytes_out = __atomic_load_n(&web_compression_stats[i].bytes_out, __ATOMIC_RELAXED);
+        ws[i].bytes_in = __atomic_load_n(&web_compression_stats[i].bytes_in, __ATOMIC_RELAXED);
+        ws[i].responses = __atomic_load_n(&web_compression_stats[i].responses, __ATOMIC_RELAXED);
+        ws[i].usec = __atomic_load_n(&web_compression_stats[i].usec, __ATOMIC_RELAXED);
+    }
+
+    {
+        static RRDSET *st_responses = NULL;
+        static RRDDIM *rds[WEB_COMPRESSION_MAX] = { 0 };
+
+        if (unlikely(!st_responses)) {
+            st_responses = rrdset_create_localhost(
+                "netdata"
+                , "compression_responses"
+                , NULL
+                , "HTTP API"
+                , "netdata.http_api_compression_responses"
+                , "Netdata Web API Compressed Responses"
+                , "responses/s"
+                , "netdata"
+                , "pulse"
+                , 130601
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_STACKED
+            );
+
+            for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++)
+                rds[i] = rrddim_add(st_responses, HTTP_CONTENT_ENCODING_2str(web_compression_encoding[i]), NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++)
+            rrddim_set_by_pointer(st_responses, rds[i], (collected_number)ws[i].responses);
+
+        rrdset_done(st_responses);
+    }
+
+    {
+        static RRDSET *st_ratio = NULL;
+        static RRDDIM *rds[WEB_COMPRESSION_MAX] = { 0 };
+        static uint64_t old_bytes_in[WEB_COMPRESSION_MAX] = { 0 }, old_bytes_out[WEB_COMPRESSION_MAX] = { 0 };
+
+        if (unlikely(!st_ratio)) {
+            st_ratio = rrdset_create_localhost(
+                "netdata"
+                , "compression_encoding_ratio"
+                , NULL
+                , "HTTP API"
+                , "netdata.http_api_compression_encoding_ratio"
+                , "Netdata Web API Responses Compression Savings Ratio per Encoding"
+                , "percentage"
+                , "netdata"
+                , "pulse"
+                , 130602
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++)
+                rds[i] = rrddim_add(st_ratio, HTTP_CONTENT_ENCODING_2str(web_compression_encoding[i]), NULL, 1, 1000, RRD_ALGORITHM_ABSOLUTE);
+        }
+
+        for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++) {
+            uint64_t bytes_in = ws[i].bytes_in - old_bytes_in[i];
+            uint64_t bytes_out = ws[i].bytes_out - old_bytes_out[i];
+            old_bytes_in[i] = ws[i].bytes_in;
+            old_bytes_out[i] = ws[i].bytes_out;
+
+            if(bytes_in && bytes_in >= bytes_out)
+                rrddim_set_by_pointer(st_ratio, rds[i], (collected_number)(((bytes_in - bytes_out) * 100 * 1000) / bytes_in));
+        }
+
+        rrdset_done(st_ratio);
+    }
+
+    {
+        static RRDSET *st_time = NULL;
+        static RRDDIM *rds[WEB_COMPRESSION_MAX] = { 0 };
+
+        if (unlikely(!st_time)) {
+            st_time = rrdset_create_localhost(
+                "netdata"
+                , "compression_time"
+                , NULL
+                , "HTTP API"
+                , "netdata.http_api_compression_time"
+                , "Netdata Web API Responses Compression Time"
+                , "milliseconds/s"
+                , "netdata"
+                , "pulse"
+                , 130603
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_STACKED
+            );
+
+            for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++)
+                rds[i] = rrddim_add(st_time, HTTP_CONTENT_ENCODING_2str(web_compression_encoding[i]), NULL, 1, USEC_PER_MS, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        for(size_t i = 0; i < WEB_COMPRESSION_MAX ;i++)
+            rrddim_set_by_pointer(st_time, rds[i], (collected_number)ws[i].usec);
+
+        rrdset_done(st_time);
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 void pulse_web_client_connected(void) {
     __atomic_fetch_add(&live_stats.connected_clients, 1, __ATOMIC_RELAXED);
 }
@@ -52,6 +296,8 @@ static inline void pulse_web_copy(struct web_statistics *gs, uint8_t options) {
 //    gs->bytes_sent = __atomic_load_n(&live_stats.bytes_sent, __ATOMIC_RELAXED);
     gs->content_size_uncompressed = __atomic_load_n(&live_stats.content_size_uncompressed, __ATOMIC_RELAXED);
     gs->content_size_compressed = __atomic_load_n(&live_stats.content_size_compressed, __ATOMIC_RELAXED);
+    gs->executor_queries = __atomic_load_n(&live_stats.executor_queries, __ATOMIC_RELAXED);
+    gs->executor_overflows = __atomic_load_n(&live_stats.executor_overflows, __ATOMIC_RELAXED);
 
     if(options & GLOBAL_STATS_RESET_WEB_USEC_MAX) {
         uint64_t n = 0;
@@ -174,6 +420,57 @@ void pulse_web_do(bool extended) {
 
     // ----------------------------------------------------------------
 
+    {
+        static RRDSET *st_executor = NULL;
+        static RRDDIM *rd_executed = NULL, *rd_overflow = NULL;
+
+        if (unlikely(!st_executor)) {
+            st_executor = rrdset_create_localhost(
+                "netdata"
+                , "http_api_executor"
+                , NULL
+                , "HTTP API"
+                , "netdata.http_api_executor"
+                , "Netdata Web API Queries Offloaded to the Query Executor"
+                , "queries/s"
+                , "netdata"
+                , "pulse"
+                , 130510
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            rd_executed = rrddim_add(st_executor, "executed", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_overflow = rrddim_add(st_executor, "inline", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        rrddim_set_by_pointer(st_executor, rd_executed, (collected_number) gs.executor_queries);
+        rrddim_set_by_pointer(st_executor, rd_overflow, (collected_number) gs.executor_overflows);
+        rrdset_done(st_executor);
+    }
+
+    // ----------------------------------------------------------------
+
+    {
+        static RRDSET *st_queue = NULL;
+        static RRDDIM *rds_queue[WEB_EXECUTOR_HISTOGRAM_ENTRIES];
+        pulse_web_executor_heatmap(&web_executor_queue_heatmap
+                                   , "http_api_executor_queue_time"
+                                   , "netdata.http_api_executor_queue_time"
+                                   , "Netdata Web API Queries Time Waiting In The Executor Queue"
+                                   , 130511, &st_queue, rds_queue);
+
+        static RRDSET *st_exec = NULL;
+        static RRDDIM *rds_exec[WEB_EXECUTOR_HISTOGRAM_ENTRIES];
+        pulse_web_executor_heatmap(&web_executor_exec_heatmap
+                                   , "http_api_executor_execution_time"
+                                   , "netdata.http_api_executor_execution_time"
+                                   , "Netdata Web API Queries Execution Time In The Executor"
+                                   , 130512, &st_exec, rds_exec);
+    }
+
+    // ----------------------------------------------------------------
+
     if(!extended) return;
 
     // ----------------------------------------------------------------
@@ -223,4 +520,8 @@ void pulse_web_do(bool extended) {
 
         rrdset_done(st_compression);
     }
+
+    // ----------------------------------------------------------------
+
+    pulse_web_compression_do();
 }
\ No newline at end of file
@@ -14,6 +14,11 @@ void pulse_web_request_completed(uint64_t dt,
                                      uint64_t content_size,
                                      uint64_t compressed_content_size);
 
+void pulse_web_request_executed(usec_t queue_ut, usec_t exec_ut);
+void pulse_web_request_executor_overflow(void);
+
+void pulse_web_response_compressed(HTTP_CONTENT_ENCODING encoding, size_t bytes_in, size_t bytes_out, usec_t ut);
+
 #if defined(PULSE_INTERNALS)
 void pulse_web_do(bool extended);
 #endif
@@ -55,4 +55,97 @@ void pulse_ingestion_do(bool extended __maybe_unused) {
 
         rrdset_done(st_points_stored);
     }
+
+    if(!stream_receive.ingestion.enabled)
+        return;
+
+    struct rrdhost_ingestion_statistics is;
+    rrdhost_ingestion_get_statistics(&is);
+
+    {
+        static RRDSET *st_queue = NULL;
+        static RRDDIM *rd_queued = NULL;
+
+        if (unlikely(!st_queue)) {
+            st_queue = rrdset_create_localhost(
+                "netdata"
+                , "ingestion_pipeline_queue"
+                , NULL
+                , "Data Collection Samples"
+                , NULL
+                , "Netdata Ingestion Pipeline Queued Chart Updates"
+                , "updates"
+                , "netdata"
+                , "pulse"
+                , 131006
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            rd_queued = rrddim_add(st_queue, "queued", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+        }
+
+        rrddim_set_by_pointer(st_queue, rd_queued, (collected_number)(is.submitted - is.committed));
+        rrdset_done(st_queue);
+    }
+
+    {
+        static RRDSET *st_updates = NULL;
+        static RRDDIM *rd_submitted = NULL, *rd_committed = NULL;
+
+        if (unlikely(!st_updates)) {
+            st_updates = rrdset_create_localhost(
+                "netdata"
+                , "ingestion_pipeline_updates"
+                , NULL
+                , "Data Collection Samples"
+                , NULL
+                , "Netdata Ingestion Pipeline Chart Updates"
+                , "updates/s"
+                , "netdata"
+                , "pulse"
+                , 131007
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            rd_submitted = rrddim_add(st_updates, "queued", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_committed = rrddim_add(st_updates, "stored", NULL, -1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        rrddim_set_by_pointer(st_updates, rd_submitted, (collected_number)is.submitted);
+        rrddim_set_by_pointer(st_updates, rd_committed, (collected_number)is.committed);
+        rrdset_done(st_updates);
+    }
+
+    {
+        static RRDSET *st_backpressure = NULL;
+        static RRDDIM *rd_backpressure = NULL, *rd_resumed = NULL, *rd_waits = NULL;
+
+        if (unlikely(!st_backpressure)) {
+            st_backpressure = rrdset_create_localhost(
+                "netdata"
+                , "ingestion_pipeline_backpressure"
+                , NULL
+                , "Data Collection Samples"
+                , NULL
+                , "Netdata Ingestion Pipeline Backpressure"
+                , "events/s"
+                , "netdata"
+                , "pulse"
+                , 131008
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            rd_backpressure = rrddim_add(st_backpressure, "paused receivers", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_resumed = rrddim_add(st_backpressure, "resumed receivers", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_waits = rrddim_add(st_backpressure, "waits", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        rrddim_set_by_pointer(st_backpressure, rd_backpressure, (collected_number)is.backpressure);
+        rrddim_set_by_pointer(st_backpressure, rd_resumed, (collected_number)is.resumed);
+        rrddim_set_by_pointer(st_backpressure, rd_waits, (collected_number)is.waits);
+        rrdset_done(st_backpressure);
+    }
 }
@@ -20,6 +20,8 @@ static struct sqlite3_statistics {
     PAD64(uint64_t) sqlite3_context_cache_spill;
     PAD64(uint64_t) sqlite3_metadata_cache_write;
     PAD64(uint64_t) sqlite3_context_cache_write;
+    PAD64(uint64_t) sqlite3_metadata_rows_written;
+    PAD64(uint64_t) sqlite3_metadata_rows_skipped;
 } sqlite3_statistics = { 0 };
 
 void pulse_sqlite3_query_completed(bool success, bool busy, bool locked) {
@@ -47,6 +49,11 @@ void pulse_sqlite3_row_completed(void) {
     __atomic_fetch_add(&sqlite3_statistics.sqlite3_rows, 1, __ATOMIC_RELAXED);
 }
 
+void pulse_sqlite3_metadata_rows(size_t written, size_t skipped) {
+    __atomic_fetch_add(&sqlite3_statistics.sqlite3_metadata_rows_written, written, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sqlite3_statistics.sqlite3_metadata_rows_skipped, skipped, __ATOMIC_RELAXED);
+}
+
 static inline void sqlite3_statistics_copy(struct sqlite3_statistics *gs) {
     static usec_t last_run = 0;
 
@@ -56,6 +63,8 @@ static inline void sqlite3_statistics_copy(struct sqlite3_statistics *gs) {
     gs->sqlite3_queries_failed_busy   = __atomic_load_n(&sqlite3_statistics.sqlite3_queries_failed_busy, __ATOMIC_RELAXED);
     gs->sqlite3_queries_failed_locked = __atomic_load_n(&sqlite3_statistics.sqlite3_queries_failed_locked, __ATOMIC_RELAXED);
     gs->sqlite3_rows                  = __atomic_load_n(&sqlite3_statistics.sqlite3_rows, __ATOMIC_RELAXED);
+    gs->sqlite3_metadata_rows_written = __atomic_load_n(&sqlite3_statistics.sqlite3_metadata_rows_written, __ATOMIC_RELAXED);
+    gs->sqlite3_metadata_rows_skipped = __atomic_load_n(&sqlite3_statistics.sqlite3_metadata_rows_skipped, __ATOMIC_RELAXED);
 
     usec_t timeout = nd_profile.update_every * USEC_PER_SEC + nd_profile.update_every * USEC_PER_SEC / 3;
     usec_t now = now_monotonic_usec();
@@ -224,6 +233,36 @@ void pulse_sqlite3_do(bool extended) {
         rrdset_done(st_sqlite3_rows);
     }
 
+    if(gs.sqlite3_metadata_rows_written || gs.sqlite3_metadata_rows_skipped) {
+        static RRDSET *st_sqlite3_metadata_rows = NULL;
+        static RRDDIM *rd_written = NULL, *rd_skipped = NULL;
+
+        if (unlikely(!st_sqlite3_metadata_rows)) {
+            st_sqlite3_metadata_rows = rrdset_create_localhost(
+                "netdata"
+                , "sqlite3_metadata_rows"
+                , NULL
+                , "sqlite3"
+                , NULL
+                , "Netdata SQLite3 chart and dimension metadata rows"
+                , "rows/s"
+                , "netdata"
+                , "pulse"
+                , 131105
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+            );
+
+            rd_written = rrddim_add(st_sqlite3_metadata_rows, "written", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            rd_skipped = rrddim_add(st_sqlite3_metadata_rows, "skipped", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        }
+
+        rrddim_set_by_pointer(st_sqlite3_metadata_rows, rd_written, (collected_number)gs.sqlite3_metadata_rows_written);
+        rrddim_set_by_pointer(st_sqlite3_metadata_rows, rd_skipped, (collected_number)gs.sqlite3_metadata_rows_skipped);
+
+        rrdset_done(st_sqlite3_metadata_rows);
+    }
+
     if(gs.sqlite3_metadata_cache_hit) {
         static RRDSET *st_sqlite3_cache = NULL;
         static RRDDIM *rd_cache_hit = NULL;
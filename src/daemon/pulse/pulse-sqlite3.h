@@ -7,6 +7,7 @@
 
 void pulse_sqlite3_query_completed(bool success, bool busy, bool locked);
 void pulse_sqlite3_row_completed(void);
+void pulse_sqlite3_metadata_rows(size_t written, size_t skipped);
 
 #if defined(PULSE_INTERNALS)
 void pulse_sqlite3_do(bool extended);
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "common.h"
+#include "database/rrddim-collection.h"
 
 static bool cmd_arg_sanitization_test(const char *expected, const char *src, char *dst, size_t dst_size) {
     bool ok = sanitize_command_argument_string(dst, src, dst_size);
@@ -1633,6 +1634,214 @@ int unit_test(long delay, long shift)
     return ret;
 }
 
+// ----------------------------------------------------------------------------
+// storing the points of a chart, per dimension vs per chart
+
+#define COLLECTION_BENCHMARK_DIMENSIONS 1000
+#define COLLECTION_BENCHMARK_ITERATIONS 10000
+
+static RRDSET *collection_benchmark_chart(const char *id, RRDDIM **rds) {
+    RRDSET *st = rrdset_create_localhost("collectionbench", id, NULL, "collectionbench", NULL, "Collection Benchmark",
+                                         "value", "unittest", NULL, 1, 1, RRDSET_TYPE_LINE);
+
+    for(size_t d = 0; d < COLLECTION_BENCHMARK_DIMENSIONS; d++) {
+        char name[50];
+        snprintfz(name, sizeof(name), "dim%zu", d);
+        rds[d] = rrddim_add(st, name, NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    return st;
+}
+
+int collection_benchmark(void) {
+    fprintf(stderr, "%s() running...\n", __FUNCTION__ );
+
+    RRDDIM **per_dim = callocz(COLLECTION_BENCHMARK_DIMENSIONS, sizeof(RRDDIM *));
+    RRDDIM **per_chart = callocz(COLLECTION_BENCHMARK_DIMENSIONS, sizeof(RRDDIM *));
+    RRDDIM_STORE_POINT *points = callocz(COLLECTION_BENCHMARK_DIMENSIONS, sizeof(RRDDIM_STORE_POINT));
+
+    collection_benchmark_chart("per_dimension", per_dim);
+    RRDSET *st = collection_benchmark_chart("per_chart", per_chart);
+
+    usec_t first_ut = (now_realtime_sec() - COLLECTION_BENCHMARK_ITERATIONS) * USEC_PER_SEC;
+    size_t total_points = (size_t)COLLECTION_BENCHMARK_DIMENSIONS * COLLECTION_BENCHMARK_ITERATIONS;
+
+    usec_t started_ut = now_monotonic_usec();
+    for(size_t i = 0; i < COLLECTION_BENCHMARK_ITERATIONS; i++) {
+        usec_t point_ut = first_ut + i * USEC_PER_SEC;
+        for(size_t d = 0; d < COLLECTION_BENCHMARK_DIMENSIONS; d++)
+            rrddim_store_metric(per_dim[d], point_ut, (NETDATA_DOUBLE)(i * d), SN_DEFAULT_FLAGS);
+    }
+    usec_t per_dim_ut = now_monotonic_usec() - started_ut;
+
+    started_ut = now_monotonic_usec();
+    for(size_t i = 0; i < COLLECTION_BENCHMARK_ITERATIONS; i++) {
+        usec_t point_ut = first_ut + i * USEC_PER_SEC;
+        for(size_t d = 0; d < COLLECTION_BENCHMARK_DIMENSIONS; d++)
+            points[d] = (RRDDIM_STORE_POINT){ .rd = per_chart[d], .n = (NETDATA_DOUBLE)(i * d), .flags = SN_DEFAULT_FLAGS };
+
+        rrdset_store_metrics(st, point_ut, points, COLLECTION_BENCHMARK_DIMENSIONS);
+    }
+    usec_t per_chart_ut = now_monotonic_usec() - started_ut;
+
+    int errors = 0;
+    for(size_t d = 0; d < COLLECTION_BENCHMARK_DIMENSIONS; d++) {
+        if(memcmp(per_dim[d]->db.data, per_chart[d]->db.data, per_dim[d]->db.memsize) != 0) {
+            fprintf(stderr, "dimension %zu: the points stored per chart differ from the ones stored per dimension\n", d);
+            errors++;
+        }
+    }
+
+    fprintf(stderr, "stored %zu points per dimension in %"PRIu64" usec, %.0f points/s\n",
+            total_points, per_dim_ut, (double)total_points * USEC_PER_SEC / (double)(per_dim_ut ? per_dim_ut : 1));
+    fprintf(stderr, "stored %zu points per chart     in %"PRIu64" usec, %.0f points/s\n",
+            total_points, per_chart_ut, (double)total_points * USEC_PER_SEC / (double)(per_chart_ut ? per_chart_ut : 1));
+
+    freez(points);
+    freez(per_chart);
+    freez(per_dim);
+
+    if(errors) {
+        fprintf(stderr, "COLLECTION BENCHMARK FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// replaying the same chart updates, stored inline vs through the ingestion pipeline
+
+#define INGESTION_BENCHMARK_CHARTS      100
+#define INGESTION_BENCHMARK_DIMENSIONS  50
+#define INGESTION_BENCHMARK_ITERATIONS  2000
+
+static RRDSET *ingestion_benchmark_chart(const char *prefix, size_t c, RRDDIM_ACQUIRED **rda) {
+    char id[50];
+    snprintfz(id, sizeof(id), "%s%zu", prefix, c);
+
+    RRDSET *st = rrdset_create_localhost("ingestionbench", id, NULL, "ingestionbench", NULL, "Ingestion Benchmark",
+                                         "value", "unittest", NULL, 1, 1, RRDSET_TYPE_LINE);
+
+    for(size_t d = 0; d < INGESTION_BENCHMARK_DIMENSIONS; d++) {
+        char name[50];
+        snprintfz(name, sizeof(name), "dim%zu", d);
+        rrddim_add(st, name, NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+        rda[d] = rrddim_find_and_acquire(st, name, true);
+    }
+
+    return st;
+}
+
+static inline NETDATA_DOUBLE ingestion_benchmark_value(size_t i, size_t c, size_t d) {
+    // the same values on every run
+    return (NETDATA_DOUBLE)((i * 2654435761ULL + c * 40503ULL + d * 97ULL) % 100000);
+}
+
+int ingestion_benchmark(void) {
+    fprintf(stderr, "%s() running...\n", __FUNCTION__ );
+
+    size_t slots = INGESTION_BENCHMARK_CHARTS * INGESTION_BENCHMARK_DIMENSIONS;
+    RRDSET **inline_st = callocz(INGESTION_BENCHMARK_CHARTS, sizeof(RRDSET *));
+    RRDSET **pipelined_st = callocz(INGESTION_BENCHMARK_CHARTS, sizeof(RRDSET *));
+    RRDDIM_ACQUIRED **inline_rda = callocz(slots, sizeof(RRDDIM_ACQUIRED *));
+    RRDDIM_ACQUIRED **pipelined_rda = callocz(slots, sizeof(RRDDIM_ACQUIRED *));
+    RRDDIM_STORE_POINT *points = callocz(INGESTION_BENCHMARK_DIMENSIONS, sizeof(RRDDIM_STORE_POINT));
+
+    for(size_t c = 0; c < INGESTION_BENCHMARK_CHARTS; c++) {
+        inline_st[c] = ingestion_benchmark_chart("inline", c, &inline_rda[c * INGESTION_BENCHMARK_DIMENSIONS]);
+        pipelined_st[c] = ingestion_benchmark_chart("pipelined", c, &pipelined_rda[c * INGESTION_BENCHMARK_DIMENSIONS]);
+    }
+
+    usec_t first_ut = (now_realtime_sec() - INGESTION_BENCHMARK_ITERATIONS) * USEC_PER_SEC;
+    size_t total_points = slots * INGESTION_BENCHMARK_ITERATIONS;
+
+    // inline, the way the receivers store without the pipeline
+    usec_t started_ut = now_monotonic_usec();
+    for(size_t i = 0; i < INGESTION_BENCHMARK_ITERATIONS; i++) {
+        usec_t point_ut = first_ut + i * USEC_PER_SEC;
+        for(size_t c = 0; c < INGESTION_BENCHMARK_CHARTS; c++) {
+            for(size_t d = 0; d < INGESTION_BENCHMARK_DIMENSIONS; d++)
+                points[d] = (RRDDIM_STORE_POINT){
+                    .rd = rrddim_acquired_to_rrddim(inline_rda[c * INGESTION_BENCHMARK_DIMENSIONS + d]),
+                    .n = ingestion_benchmark_value(i, c, d),
+                    .flags = SN_DEFAULT_FLAGS,
+                };
+
+            rrdset_store_metrics(inline_st[c], point_ut, points, INGESTION_BENCHMARK_DIMENSIONS);
+        }
+    }
+    usec_t inline_ut = now_monotonic_usec() - started_ut;
+
+    // pipelined, the receiver queues and the storage workers store
+    stream_receive.ingestion.enabled = true;
+    rrdhost_ingestion_attach(localhost);
+
+    RRDHOST_INGESTION_BATCH batch = { 0 };
+    size_t backpressure = 0;
+    started_ut = now_monotonic_usec();
+    for(size_t i = 0; i < INGESTION_BENCHMARK_ITERATIONS; i++) {
+        usec_t point_ut = first_ut + i * USEC_PER_SEC;
+        for(size_t c = 0; c < INGESTION_BENCHMARK_CHARTS; c++) {
+            // a receiver would stop reading its socket here
+            if(rrdhost_ingestion_congested(localhost)) {
+                rrdhost_ingestion_wait(localhost);
+                backpressure++;
+            }
+
+            rrdhost_ingestion_batch_begin(&batch, pipelined_st[c], point_ut, false);
+
+            for(size_t d = 0; d < INGESTION_BENCHMARK_DIMENSIONS; d++)
+                rrdhost_ingestion_batch_add(&batch, pipelined_rda[c * INGESTION_BENCHMARK_DIMENSIONS + d],
+                                            ingestion_benchmark_value(i, c, d), SN_DEFAULT_FLAGS);
+
+            rrdhost_ingestion_batch_submit(localhost, &batch);
+        }
+    }
+    usec_t queued_ut = now_monotonic_usec() - started_ut;
+    rrdhost_ingestion_wait(localhost);
+    usec_t pipelined_ut = now_monotonic_usec() - started_ut;
+
+    rrdhost_ingestion_batch_cleanup(&batch);
+    rrdhost_ingestion_free(localhost);
+    rrdhost_ingestion_stop();
+    stream_receive.ingestion.enabled = false;
+
+    int errors = 0;
+    for(size_t s = 0; s < slots; s++) {
+        RRDDIM *rd1 = rrddim_acquired_to_rrddim(inline_rda[s]);
+        RRDDIM *rd2 = rrddim_acquired_to_rrddim(pipelined_rda[s]);
+        if(memcmp(rd1->db.data, rd2->db.data, rd1->db.memsize) != 0) {
+            fprintf(stderr, "dimension %zu: the points stored by the pipeline differ from the ones stored inline\n", s);
+            errors++;
+        }
+
+        rrddim_acquired_release(inline_rda[s]);
+        rrddim_acquired_release(pipelined_rda[s]);
+    }
+
+    fprintf(stderr, "stored %zu points inline        in %"PRIu64" usec, %.0f points/s\n",
+            total_points, inline_ut, (double)total_points * USEC_PER_SEC / (double)(inline_ut ? inline_ut : 1));
+    fprintf(stderr, "queued %zu points for storage   in %"PRIu64" usec, %.0f points/s (the receiver side)\n",
+            total_points, queued_ut, (double)total_points * USEC_PER_SEC / (double)(queued_ut ? queued_ut : 1));
+    fprintf(stderr, "stored %zu points via pipeline  in %"PRIu64" usec, %.0f points/s, %zu full queue waits\n",
+            total_points, pipelined_ut, (double)total_points * USEC_PER_SEC / (double)(pipelined_ut ? pipelined_ut : 1),
+            backpressure);
+
+    freez(points);
+    freez(pipelined_rda);
+    freez(inline_rda);
+    freez(pipelined_st);
+    freez(inline_st);
+
+    if(errors) {
+        fprintf(stderr, "INGESTION BENCHMARK FAILED\n");
+        return 1;
+    }
+
+    return 0;
+}
+
 int test_sqlite(void) {
     fprintf(stderr, "%s() running...\n", __FUNCTION__ );
     sqlite3  *db_mt;
@@ -7,6 +7,8 @@
 
 int unit_test_storage(void);
 int unit_test(long delay, long shift);
+int collection_benchmark(void);
+int ingestion_benchmark(void);
 int run_all_mockup_tests(void);
 int unit_test_str2ld(void);
 int unit_test_buffer(void);
@@ -338,6 +338,10 @@ void dbengine_stress_test(unsigned TEST_DURATION_SEC, unsigned DSET_CHARTS, unsi
 
     default_rrd_memory_mode = RRD_DB_MODE_DBENGINE;
     default_rrdeng_page_cache_mb = PAGE_CACHE_MB;
+
+    // let tier0 pages select the smallest encoding, so that we can report it
+    tier_page_type[0] = RRDENG_PAGE_TYPE_ADAPTIVE_32BIT;
+
     if (DISK_SPACE_MB) {
         fprintf(stderr, "By setting disk space limit data are allowed to be deleted. "
                         "Data validation is turned off for this run.\n");
@@ -454,6 +458,18 @@ void dbengine_stress_test(unsigned TEST_DURATION_SEC, unsigned DSET_CHARTS, unsi
     rrdeng_exit((struct rrdengine_instance *)host->db[0].si);
     rrdeng_enq_cmd(NULL, RRDENG_OPCODE_SHUTDOWN_EVLOOP, NULL, NULL, STORAGE_PRIORITY_BEST_EFFORT, NULL, NULL);
     rrd_wrunlock();
+
+    struct pgd_encoding_stats encodings[PGD_ENCODING_MAX];
+    pgd_encoding_stats_get(encodings);
+    fprintf(stderr, "\nPages flushed to disk, per encoding:\n");
+    for (i = 0 ; i < PGD_ENCODING_MAX ; ++i) {
+        if (!encodings[i].pages)
+            continue;
+
+        fprintf(stderr, "    %-10s %zu pages, %zu points, %zu bytes, %.3f bytes/point\n",
+                pgd_encoding_name(i), encodings[i].pages, encodings[i].points, encodings[i].bytes,
+                encodings[i].points ? (double)encodings[i].bytes / (double)encodings[i].points : 0.0);
+    }
 }
 
 #endif
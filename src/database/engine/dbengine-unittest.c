@@ -356,6 +356,345 @@ static size_t dbengine_test_rrdr_single_region(
     return errors + value_errors + time_errors + update_every_errors;
 }
 
+// ----------------------------------------------------------------------------
+// background downsampling of the higher tiers
+// it compares tier 2 aggregated inline from tier 0, to tier 2 downsampled from tier 1
+
+#define DOWNSAMPLING_TIERS 3
+#define DOWNSAMPLING_POINTS (16 * 512 + 5)          // 512 completed points of tier 2, and a few more
+#define DOWNSAMPLING_EVERY 1000                     // downsample at random points of the pages of tier 1
+static const uint32_t DOWNSAMPLING_TIER_GROUPING[DOWNSAMPLING_TIERS] = { 1, 4, 16 };
+
+// the agent stops at a random point, and tier 1 of the background dimension has lost its last points
+#define DOWNSAMPLING_RESTART_AT (16 * 256 + 7)
+#define DOWNSAMPLING_RESTART_LOST 600               // more than a batch of tier 1 points to backfill
+#define DOWNSAMPLING_RESTART_GAP 1000               // the points not collected while the agent is down
+
+struct downsampling_test_dim {
+    RRDDIM *rd;
+    STORAGE_METRICS_GROUP *smg[DOWNSAMPLING_TIERS];
+};
+
+static struct rrdengine_instance *test_dbengine_downsampling_instance(RRDHOST *host, size_t tier) {
+    char path[FILENAME_MAX + 1];
+    snprintfz(path, FILENAME_MAX, "%s/dbengine-tier%zu", host->cache_dir, tier);
+
+    if(mkdir(path, 0775) != 0 && errno != EEXIST)
+        fatal("DBENGINE: cannot create directory '%s'", path);
+
+    struct rrdengine_instance *ctx = NULL;
+    if(rrdeng_init(&ctx, path, default_rrdeng_disk_quota_mb, tier, 0) != 0 || !ctx)
+        fatal("DBENGINE: cannot initialize tier %zu at '%s'", tier, path);
+
+    rrdeng_readiness_wait(ctx);
+    return ctx;
+}
+
+static void test_dbengine_downsampling_dim_create(struct downsampling_test_dim *d, RRDSET *st, const char *id,
+                                                  struct rrdengine_instance *ctx[DOWNSAMPLING_TIERS]) {
+    RRDDIM *rd = callocz(1, sizeof(RRDDIM) + DOWNSAMPLING_TIERS * sizeof(struct rrddim_tier));
+    rd->id = string_strdupz(id);
+    rd->rrdset = st;
+
+    nd_uuid_t uuid;
+    uuid_generate(uuid);
+    rd->uuid = uuidmap_create(uuid);
+
+    for(size_t tier = 0; tier < DOWNSAMPLING_TIERS ;tier++) {
+        struct rrddim_tier *t = &rd->tiers[tier];
+        spinlock_init(&t->spinlock);
+        storage_point_unset(t->virtual_point);
+        if(!ctx[tier]) continue;
+
+        t->seb = STORAGE_ENGINE_BACKEND_DBENGINE;
+        t->tier_grouping = DOWNSAMPLING_TIER_GROUPING[tier];
+        t->last_completed_point_flush_modulo = 1;
+        t->smh = rrdeng_metric_get_or_create(rd, (STORAGE_INSTANCE *)ctx[tier]);
+        d->smg[tier] = rrdeng_metrics_group_get((STORAGE_INSTANCE *)ctx[tier], &uuid);
+        t->sch = storage_metric_store_init(t->seb, t->smh, st->update_every * t->tier_grouping, d->smg[tier]);
+    }
+
+    d->rd = rd;
+}
+
+static void test_dbengine_downsampling_dim_restart(struct downsampling_test_dim *d) {
+    // what the agent keeps in memory is lost
+    RRDDIM *rd = d->rd;
+
+    for(size_t tier = 0; tier < DOWNSAMPLING_TIERS ;tier++) {
+        struct rrddim_tier *t = &rd->tiers[tier];
+        if(!t->smh) continue;
+
+        storage_engine_store_finalize(t->sch);
+        t->sch = storage_metric_store_init(t->seb, t->smh, rd->rrdset->update_every * t->tier_grouping, d->smg[tier]);
+
+        storage_point_unset(t->virtual_point);
+        storage_point_unset(t->last_completed_point);
+        t->next_point_end_time_s = 0;
+    }
+
+    rrddim_option_clear(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+    rd->downsampling.points = 0;
+    rd->downsampling.first_s = 0;
+    rd->downsampling.after_s = 0;
+}
+
+static void test_dbengine_downsampling_dim_free(struct downsampling_test_dim *d, struct rrdengine_instance *ctx[DOWNSAMPLING_TIERS]) {
+    RRDDIM *rd = d->rd;
+
+    for(size_t tier = 0; tier < DOWNSAMPLING_TIERS ;tier++) {
+        struct rrddim_tier *t = &rd->tiers[tier];
+        if(!t->smh) continue;
+
+        if(t->sch)
+            storage_engine_store_finalize(t->sch);
+
+        rrdeng_metric_release(t->smh);
+        rrdeng_metrics_group_release((STORAGE_INSTANCE *)ctx[tier], d->smg[tier]);
+    }
+
+    string_freez(rd->id);
+    uuidmap_free(rd->uuid);
+    freez(rd);
+}
+
+static bool downsampling_values_differ(NETDATA_DOUBLE a, NETDATA_DOUBLE b) {
+    if(!netdata_double_isnumber(a) || !netdata_double_isnumber(b))
+        return netdata_double_isnumber(a) != netdata_double_isnumber(b);
+
+    return fabsndd(a - b) > 0.0001 * MAX(1.0, fabsndd(a));
+}
+
+static STORAGE_POINT downsampling_test_point(time_t time_start, time_t update_every, size_t p) {
+    // a few single gaps, and a long one to have gaps on tier 1 too
+    NETDATA_DOUBLE n = (p % 97 == 0 || (p >= 3000 && p < 3040)) ? NAN : (NETDATA_DOUBLE)((p * 7) % 1000);
+    SN_FLAGS flags = (p % 5 == 0) ? SN_FLAG_NONE : SN_FLAG_NOT_ANOMALOUS;
+
+    STORAGE_POINT sp = {
+        .start_time_s = time_start + (time_t)p * update_every,
+        .end_time_s = time_start + (time_t)(p + 1) * update_every,
+        .min = n,
+        .max = n,
+        .sum = n,
+        .count = 1,
+        .anomaly_count = (flags & SN_FLAG_NOT_ANOMALOUS) ? 0 : 1,
+        .flags = flags,
+    };
+
+    return sp;
+}
+
+static size_t test_dbengine_downsampling_compare(struct downsampling_test_dim *inl, struct downsampling_test_dim *bg,
+                                                 time_t time_start, time_t time_end, size_t *points_compared) {
+    struct storage_engine_query_handle q_inl, q_bg;
+    storage_engine_query_init(STORAGE_ENGINE_BACKEND_DBENGINE, inl->rd->tiers[2].smh, &q_inl, time_start, time_end, STORAGE_PRIORITY_NORMAL);
+    storage_engine_query_init(STORAGE_ENGINE_BACKEND_DBENGINE, bg->rd->tiers[2].smh, &q_bg, time_start, time_end, STORAGE_PRIORITY_NORMAL);
+
+    size_t points = 0, errors = 0;
+    while(!storage_engine_query_is_finished(&q_inl) && !storage_engine_query_is_finished(&q_bg)) {
+        STORAGE_POINT a = storage_engine_query_next_metric(&q_inl);
+        STORAGE_POINT b = storage_engine_query_next_metric(&q_bg);
+        points++;
+
+        if(a.start_time_s != b.start_time_s || a.end_time_s != b.end_time_s ||
+            a.count != b.count || a.anomaly_count != b.anomaly_count ||
+            downsampling_values_differ(a.sum, b.sum) ||
+            downsampling_values_differ(a.min, b.min) ||
+            downsampling_values_differ(a.max, b.max)) {
+
+            if(errors < 10)
+                fprintf(stderr, " >>> DBENGINE: TIER 2 POINTS DO NOT MATCH at point %zu: "
+                                "inline %ld - %ld, sum %f, min %f, max %f, count %u, anomalies %u, "
+                                "background %ld - %ld, sum %f, min %f, max %f, count %u, anomalies %u\n",
+                        points,
+                        a.start_time_s, a.end_time_s, (double)a.sum, (double)a.min, (double)a.max, a.count, a.anomaly_count,
+                        b.start_time_s, b.end_time_s, (double)b.sum, (double)b.min, (double)b.max, b.count, b.anomaly_count);
+
+            errors++;
+        }
+    }
+
+    if(!storage_engine_query_is_finished(&q_inl) || !storage_engine_query_is_finished(&q_bg)) {
+        fprintf(stderr, " >>> DBENGINE: TIER 2 HAS A DIFFERENT NUMBER OF POINTS inline vs background\n");
+        errors++;
+    }
+
+    storage_engine_query_finalize(&q_inl);
+    storage_engine_query_finalize(&q_bg);
+
+    *points_compared = points;
+    return errors;
+}
+
+static size_t test_dbengine_tier_downsampling_continuous(RRDSET *st, time_t now, struct rrdengine_instance *ctx[DOWNSAMPLING_TIERS]) {
+    // the inline dimension has only tier 2, the background one has tiers 1 and 2
+    struct rrdengine_instance *ctx_inline[DOWNSAMPLING_TIERS] = { NULL, NULL, ctx[2] };
+    struct rrdengine_instance *ctx_bg[DOWNSAMPLING_TIERS] = { NULL, ctx[1], ctx[2] };
+    struct downsampling_test_dim inl = { 0 }, bg = { 0 };
+    test_dbengine_downsampling_dim_create(&inl, st, "downsampling-inline", ctx_inline);
+    test_dbengine_downsampling_dim_create(&bg, st, "downsampling-background", ctx_bg);
+
+    time_t update_every = st->update_every;
+    time_t granularity = update_every * DOWNSAMPLING_TIER_GROUPING[2];
+    time_t time_start = now + 2 * granularity - (now % granularity);
+    bg.rd->downsampling.first_s = time_start;
+
+    for(size_t p = 0; p < DOWNSAMPLING_POINTS ;p++) {
+        STORAGE_POINT sp = downsampling_test_point(time_start, update_every, p);
+
+        store_metric_at_tier(inl.rd, 2, &inl.rd->tiers[2], sp, sp.end_time_s * USEC_PER_SEC);
+        store_metric_at_tier(bg.rd, 1, &bg.rd->tiers[1], sp, sp.end_time_s * USEC_PER_SEC);
+
+        if((p + 1) % DOWNSAMPLING_EVERY == 0)
+            rrddim_downsample_from_tier1(bg.rd, DOWNSAMPLING_TIERS);
+    }
+
+    // what finalizing the collection of the dimensions does
+    store_metric_at_tier_flush_last_completed(bg.rd, 1, &bg.rd->tiers[1]);
+    rrddim_downsample_from_tier1(bg.rd, DOWNSAMPLING_TIERS);
+    store_metric_at_tier_flush_last_completed(inl.rd, 2, &inl.rd->tiers[2]);
+
+    // the last point of tier 2 that has been completed
+    time_t time_end = time_start + (DOWNSAMPLING_POINTS / DOWNSAMPLING_TIER_GROUPING[2]) * granularity;
+
+    size_t points = 0;
+    size_t errors = test_dbengine_downsampling_compare(&inl, &bg, time_start, time_end, &points);
+
+    if(points != DOWNSAMPLING_POINTS / DOWNSAMPLING_TIER_GROUPING[2]) {
+        fprintf(stderr, " >>> DBENGINE: TIER 2 HAS %zu POINTS, expected %u\n",
+                points, DOWNSAMPLING_POINTS / DOWNSAMPLING_TIER_GROUPING[2]);
+        errors++;
+    }
+
+    test_dbengine_downsampling_dim_free(&inl, ctx_inline);
+    test_dbengine_downsampling_dim_free(&bg, ctx_bg);
+
+    if(errors)
+        fprintf(stderr, "%zu tier downsampling errors encountered (out of %zu points)\n", errors, points);
+
+    return errors;
+}
+
+static void test_dbengine_downsampling_store_tier0(struct downsampling_test_dim *d, STORAGE_POINT sp) {
+    // what the collectors store on tier 0
+    storage_engine_store_metric(d->rd->tiers[0].sch, sp.end_time_s * USEC_PER_SEC,
+                                sp.sum, 0, 0,
+                                1, 0, sp.flags);
+}
+
+static size_t test_dbengine_tier_downsampling_restart(RRDHOST *host, RRDSET *st, time_t now, struct rrdengine_instance *ctx[DOWNSAMPLING_TIERS]) {
+    // both dimensions have all the tiers, the inline one aggregates tier 2 from tier 0
+    struct rrdengine_instance *ctx_all[DOWNSAMPLING_TIERS] = { (struct rrdengine_instance *)host->db[0].si, ctx[1], ctx[2] };
+    struct downsampling_test_dim inl = { 0 }, bg = { 0 };
+    test_dbengine_downsampling_dim_create(&inl, st, "downsampling-restart-inline", ctx_all);
+    test_dbengine_downsampling_dim_create(&bg, st, "downsampling-restart-background", ctx_all);
+    rrddim_option_set(inl.rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+    rrddim_option_set(bg.rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+
+    time_t update_every = st->update_every;
+    time_t granularity = update_every * DOWNSAMPLING_TIER_GROUPING[2];
+    time_t time_start = now + 2 * granularity - (now % granularity);
+    bg.rd->downsampling.first_s = time_start;
+
+    size_t errors = 0;
+    for(size_t p = 0; p < DOWNSAMPLING_POINTS ;p++) {
+        if(p >= DOWNSAMPLING_RESTART_AT && p < DOWNSAMPLING_RESTART_AT + DOWNSAMPLING_RESTART_GAP)
+            continue;
+
+        STORAGE_POINT sp = downsampling_test_point(time_start, update_every, p);
+
+        if(p == DOWNSAMPLING_RESTART_AT + DOWNSAMPLING_RESTART_GAP) {
+            test_dbengine_downsampling_dim_restart(&inl);
+            test_dbengine_downsampling_dim_restart(&bg);
+
+            // what the collectors do on their first point after the restart
+            size_t storage_tiers = nd_profile.storage_tiers;
+            RRD_BACKFILL backfill = default_backfill;
+            nd_profile.storage_tiers = DOWNSAMPLING_TIERS;
+            default_backfill = RRD_BACKFILL_FULL;
+            bg.rd->downsampling.enabled = true;
+
+            for(size_t tier = 1; tier < DOWNSAMPLING_TIERS ;tier++) {
+                backfill_tier_from_smaller_tiers(inl.rd, tier, sp.end_time_s);
+                backfill_tier_from_smaller_tiers(bg.rd, tier, sp.end_time_s);
+            }
+
+            // the workers must not get the dimension while its collector backfills it
+            if(bg.rd->downsampling.points || __atomic_load_n(&bg.rd->downsampling.queued, __ATOMIC_ACQUIRE)) {
+                fprintf(stderr, " >>> DBENGINE: %u POINTS OF TIER 1 COUNTED FOR THE WORKERS WHILE BACKFILLING%s\n",
+                        bg.rd->downsampling.points,
+                        bg.rd->downsampling.queued ? ", AND QUEUED" : "");
+                errors++;
+            }
+
+            if(!bg.rd->downsampling.first_s) {
+                fprintf(stderr, " >>> DBENGINE: THE BACKFILLED POINTS OF TIER 1 ARE NOT MARKED FOR DOWNSAMPLING\n");
+                errors++;
+                bg.rd->downsampling.first_s = sp.start_time_s;
+            }
+
+            // this test downsamples synchronously
+            bg.rd->downsampling.enabled = false;
+            nd_profile.storage_tiers = storage_tiers;
+            default_backfill = backfill;
+
+            rrddim_option_set(inl.rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+            rrddim_option_set(bg.rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+        }
+
+        test_dbengine_downsampling_store_tier0(&inl, sp);
+        store_metric_at_tier(inl.rd, 1, &inl.rd->tiers[1], sp, sp.end_time_s * USEC_PER_SEC);
+        store_metric_at_tier(inl.rd, 2, &inl.rd->tiers[2], sp, sp.end_time_s * USEC_PER_SEC);
+
+        test_dbengine_downsampling_store_tier0(&bg, sp);
+        if(p < DOWNSAMPLING_RESTART_AT - DOWNSAMPLING_RESTART_LOST || p >= DOWNSAMPLING_RESTART_AT)
+            store_metric_at_tier(bg.rd, 1, &bg.rd->tiers[1], sp, sp.end_time_s * USEC_PER_SEC);
+
+        if((p + 1) % DOWNSAMPLING_EVERY == 0)
+            rrddim_downsample_from_tier1(bg.rd, DOWNSAMPLING_TIERS);
+    }
+
+    // what finalizing the collection of the dimensions does
+    store_metric_at_tier_flush_last_completed(bg.rd, 1, &bg.rd->tiers[1]);
+    rrddim_downsample_from_tier1(bg.rd, DOWNSAMPLING_TIERS);
+    store_metric_at_tier_flush_last_completed(inl.rd, 1, &inl.rd->tiers[1]);
+    store_metric_at_tier_flush_last_completed(inl.rd, 2, &inl.rd->tiers[2]);
+
+    time_t time_end = time_start + (DOWNSAMPLING_POINTS / DOWNSAMPLING_TIER_GROUPING[2]) * granularity;
+
+    size_t points = 0;
+    errors += test_dbengine_downsampling_compare(&inl, &bg, time_start, time_end, &points);
+
+    test_dbengine_downsampling_dim_free(&inl, ctx_all);
+    test_dbengine_downsampling_dim_free(&bg, ctx_all);
+
+    if(errors)
+        fprintf(stderr, "%zu tier downsampling errors encountered after a restart (out of %zu points)\n", errors, points);
+
+    return errors;
+}
+
+static size_t test_dbengine_tier_downsampling(RRDHOST *host, RRDSET *st, time_t now) {
+    fprintf(stderr, "DBENGINE Tier Downsampling Test, comparing background to inline downsampling...\n");
+
+    struct rrdengine_instance *ctx[DOWNSAMPLING_TIERS] = { 0 };
+    for(size_t tier = 1; tier < DOWNSAMPLING_TIERS ;tier++)
+        ctx[tier] = test_dbengine_downsampling_instance(host, tier);
+
+    size_t errors = test_dbengine_tier_downsampling_continuous(st, now, ctx);
+
+    // the restart uses different metrics, at the same time
+    errors += test_dbengine_tier_downsampling_restart(host, st, now, ctx);
+
+    for(size_t tier = 1; tier < DOWNSAMPLING_TIERS ;tier++) {
+        rrdeng_quiesce(ctx[tier]);
+        rrdeng_flush_all(ctx[tier]);
+        rrdeng_exit(ctx[tier]);
+    }
+
+    return errors;
+}
+
 int test_dbengine(void) {
     // provide enough threads to dbengine
     setenv("UV_THREADPOOL_SIZE", "48", 1);
@@ -410,6 +749,9 @@ int test_dbengine(void) {
         errors += dbengine_test_rrdr_single_region(st, rd, current_region, time_start[current_region], time_end[current_region]);
     }
 
+    // check the higher tiers downsampled in the background, against the inline aggregation
+    errors += test_dbengine_tier_downsampling(host, st[0], now);
+
     // prevent closing the database before the test is finished
     sleep(5);
 
@@ -771,7 +771,10 @@ static void journalfile_restore_extent_metadata(struct rrdengine_instance *ctx,
             vd.update_every_s,
             journalfile->datafile,
             jf_metric_data->extent_offset,
-            jf_metric_data->extent_size);
+            jf_metric_data->extent_size,
+            page_type,
+            (page_type == RRDENG_PAGE_TYPE_CONSTANT_32BIT) ? descr->constant.value : 0,
+            NULL);
 
         extent_first_time_s = MIN(extent_first_time_s, vd.start_time_s);
         extent_last_time_s = MAX(extent_last_time_s, vd.end_time_s);
@@ -937,6 +940,49 @@ static int journalfile_check_v2_metric_list(void *data_start, size_t file_size)
     return 0;
 }
 
+// Returns the page summary section header, when the file has a valid one
+struct journal_v2_summary_header *journalfile_v2_summary_header(struct journal_v2_header *j2_header, size_t journal_v2_file_size)
+{
+    struct journal_v2_summary_header *summary_header =
+        (struct journal_v2_summary_header *) ((uint8_t *) j2_header + sizeof(*j2_header));
+
+    if (summary_header->magic != JOURVAL_V2_SUMMARY_MAGIC)
+        return NULL;
+
+    size_t bases_size = (size_t) j2_header->metric_count * sizeof(uint32_t);
+    size_t summaries_size = (size_t) j2_header->page_count * sizeof(struct journal_page_summary);
+
+    if (summary_header->metric_base_offset < sizeof(*j2_header) + JOURNAL_V2_HEADER_PADDING_SZ ||
+        summary_header->metric_base_offset + bases_size != summary_header->summary_offset ||
+        summary_header->summary_offset + summaries_size != summary_header->trailer_offset ||
+        summary_header->trailer_offset + sizeof(struct journal_v2_block_trailer) > journal_v2_file_size - sizeof(struct journal_v2_block_trailer))
+        return NULL;
+
+    return summary_header;
+}
+
+// Checks that the page summaries checksum is valid
+static int journalfile_check_v2_summaries(void *data_start, size_t file_size)
+{
+    struct journal_v2_summary_header *summary_header = journalfile_v2_summary_header(data_start, file_size);
+    if (!summary_header)
+        // no summaries, or an older file
+        return 0;
+
+    struct journal_v2_block_trailer *journal_v2_trailer =
+        (struct journal_v2_block_trailer *) ((uint8_t *) data_start + summary_header->trailer_offset);
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, (uint8_t *) data_start + summary_header->metric_base_offset,
+                summary_header->trailer_offset - summary_header->metric_base_offset);
+    if (unlikely(crc32cmp(journal_v2_trailer->checksum, crc))) {
+        netdata_log_error("DBENGINE: page summaries CRC32 check: FAILED");
+        return 1;
+    }
+
+    return 0;
+}
+
 //
 // Return
 //   0 Ok
@@ -959,7 +1005,7 @@ static int journalfile_v2_validate(void *data_start, size_t journal_v2_file_size
         return 3;
 
     // Magic failure
-    if (j2_header->magic != JOURVAL_V2_MAGIC)
+    if (j2_header->magic != JOURVAL_V2_MAGIC && j2_header->magic != JOURVAL_V2_CONSTANT_MAGIC)
         return 1;
 
     if (j2_header->journal_v2_file_size != journal_v2_file_size)
@@ -988,6 +1034,9 @@ static int journalfile_v2_validate(void *data_start, size_t journal_v2_file_size
     rc = journalfile_check_v2_metric_list(data_start, journal_v2_file_size);
     if (rc) return 1;
 
+    rc = journalfile_check_v2_summaries(data_start, journal_v2_file_size);
+    if (rc) return 1;
+
     // Verify complete UUID chain
 
     struct journal_metric_list *metric = (void *) (data_start + j2_header->metric_offset);
@@ -1332,12 +1381,30 @@ void *journalfile_v2_write_data_page(struct journal_v2_header *j2_header, void *
     data_page->page_length = 0;
     data_page->type = 0;
 
+    struct extent_io_data *xio = page_info->custom_data;
+    if (xio && xio->page_type == RRDENG_PAGE_TYPE_CONSTANT_32BIT) {
+        data_page->constant_value = xio->constant_value;
+        data_page->type = RRDENG_PAGE_TYPE_CONSTANT_32BIT;
+
+        // older agents have to rebuild this file
+        j2_header->magic = JOURVAL_V2_CONSTANT_MAGIC;
+    }
+
     return ++data_page;
 }
 
+static void journalfile_v2_write_page_summary(struct journal_page_summary *summary, struct jv2_page_info *page_info)
+{
+    struct extent_io_data *xio = page_info->custom_data;
+    if (xio)
+        *summary = xio->summary;
+    else
+        memset(summary, 0, sizeof(*summary));
+}
+
 // Must be recorded in metric_info->entries
 static void *journalfile_v2_write_descriptors(struct journal_v2_header *j2_header, void *data, struct jv2_metrics_info *metric_info,
-        struct journal_metric_list *current_metric)
+        struct journal_metric_list *current_metric, struct journal_page_summary *summary)
 {
     Pvoid_t *PValue;
 
@@ -1357,6 +1424,8 @@ static void *journalfile_v2_write_descriptors(struct journal_v2_header *j2_heade
         update_every_s = page_info->update_every_s;
         if (NULL == data_page)
             break;
+
+        journalfile_v2_write_page_summary(summary++, page_info);
     }
     current_metric->update_every_s = update_every_s;
     return data_page;
@@ -1419,6 +1488,16 @@ bool journalfile_migrate_to_v2_callback(Word_t section, unsigned datafile_fileno
     uint32_t pages_offset = total_file_size;
     total_file_size  += (number_of_pages * (sizeof(struct journal_page_list) + sizeof(struct journal_page_header) + sizeof(struct journal_v2_block_trailer)));
 
+    // page summaries will start here
+    uint32_t summary_metric_base_offset = total_file_size;
+    total_file_size  += (number_of_metrics * sizeof(uint32_t));
+
+    uint32_t summary_offset = total_file_size;
+    total_file_size  += (number_of_pages * sizeof(struct journal_page_summary));
+
+    uint32_t summary_trailer_offset = total_file_size;
+    total_file_size  += sizeof(struct journal_v2_block_trailer);
+
     // File trailer
     uint32_t trailer_offset = total_file_size;
     total_file_size  += sizeof(struct journal_v2_block_trailer);
@@ -1484,6 +1563,10 @@ bool journalfile_migrate_to_v2_callback(Word_t section, unsigned datafile_fileno
         // Allocate array to sort UUIDs and keep them sorted in the journal because we want to do binary search when we do lookups
         uuid_list = mallocz(number_of_metrics * sizeof(struct journal_metric_list_to_sort));
 
+        uint32_t *summary_metric_base = (uint32_t *)(data_start + summary_metric_base_offset);
+        struct journal_page_summary *summaries = (struct journal_page_summary *)(data_start + summary_offset);
+        uint32_t summaries_written = 0;
+
         Word_t Index = 0;
         size_t count = 0;
         bool first_then_next = true;
@@ -1534,11 +1617,21 @@ bool journalfile_migrate_to_v2_callback(Word_t section, unsigned datafile_fileno
             void *metric_page =
                 journalfile_v2_write_data_page_header(&j2_header, data_start + pages_offset, metric_info, uuid_offset);
 
+            // The summaries of the pages of this metric start here
+            if (unlikely(summaries_written + metric_info->number_of_pages > number_of_pages)) {
+                data = data_start;
+                break;
+            }
+            summary_metric_base[Index] = summaries_written;
+
             // Start writing descr @ time
-            void *page_trailer = journalfile_v2_write_descriptors(&j2_header, metric_page, metric_info, current_metric);
+            void *page_trailer = journalfile_v2_write_descriptors(&j2_header, metric_page, metric_info, current_metric,
+                                                                  &summaries[summaries_written]);
             if (unlikely(!page_trailer))
                 break;
 
+            summaries_written += metric_info->number_of_pages;
+
             // Trailer (checksum)
             uint8_t *next_page_address =
                 journalfile_v2_write_data_page_trailer(&j2_header, page_trailer, data_start + pages_offset);
@@ -1568,6 +1661,20 @@ bool journalfile_migrate_to_v2_callback(Word_t section, unsigned datafile_fileno
             internal_error(
                 true, "DBENGINE: CALCULATE CRC FOR UUIDs  %llu", (now_monotonic_usec() - start_loading) / USEC_PER_MS);
 
+            // Calculate CRC for the page summaries, and describe them after the header
+            journal_v2_trailer = (struct journal_v2_block_trailer *)(data_start + summary_trailer_offset);
+            crc = crc32(0L, Z_NULL, 0);
+            crc = crc32(crc, (uint8_t *)data_start + summary_metric_base_offset, summary_trailer_offset - summary_metric_base_offset);
+            crc32set(journal_v2_trailer->checksum, crc);
+
+            struct journal_v2_summary_header summary_header = {
+                .magic = JOURVAL_V2_SUMMARY_MAGIC,
+                .metric_base_offset = summary_metric_base_offset,
+                .summary_offset = summary_offset,
+                .trailer_offset = summary_trailer_offset,
+            };
+            memcpy(data_start + sizeof(j2_header), &summary_header, sizeof(summary_header));
+
             // Prepare to write checksum for the file
             j2_header.data = NULL;
             journal_v2_trailer = (struct journal_v2_block_trailer *)(data_start + trailer_offset);
@@ -71,6 +71,12 @@ static inline uint64_t journalfile_current_size(struct rrdengine_journalfile *jo
 #define JOURVAL_V2_MAGIC           (0x01230317)
 #define JOURVAL_V2_REBUILD_MAGIC   (0x00230317)
 #define JOURVAL_V2_SKIP_MAGIC      (0x02230317)
+#define JOURVAL_V2_SUMMARY_MAGIC   (0x03230317)
+
+// JOURVAL_V2_MAGIC, for files whose page list has RRDENG_PAGE_TYPE_CONSTANT_32BIT pages.
+// Older agents do not know it, so they rebuild these files from journal v1, instead of
+// reading constant values as extent indexes.
+#define JOURVAL_V2_CONSTANT_MAGIC  (0x04230317)
 
 struct journal_v2_block_trailer {
     union {
@@ -112,6 +118,12 @@ struct journal_v2_block_trailer {
  * |   |   - Page Entries (20 bytes each)           |
  * |   |   - Page Trailer (4 bytes CRC)             |
  * +------------------------------------------------+
+ * | PAGE SUMMARY SECTION (optional)                |
+ * |   +--------------------------------------------+
+ * |   | First summary of each metric (4 bytes each)|
+ * |   | Page Summaries (24 bytes each)             |
+ * |   | Summary Section Trailer (4 bytes CRC)      |
+ * +------------------------------------------------+
  * | FILE TRAILER                                   |
  * |   - File CRC (4 bytes)                         |
  * +------------------------------------------------+
@@ -122,6 +134,11 @@ struct journal_v2_block_trailer {
  * - Each section (extent list, metric list) has its own trailer with CRC
  * - Each page header includes a CRC of its content
  *
+ * Page Summaries:
+ * - The summary section is described by a summary header, stored in the padding
+ *   right after the file header, so agents that do not know it just ignore it
+ * - Files without a summary header (zeros in the padding) have no page summaries
+ *
  * Time Representation:
  * - File-level times are stored in microseconds (start_time_ut, end_time_ut)
  * - Page-level times are stored as deltas in seconds relative to the journal start time
@@ -239,8 +256,14 @@ struct journal_page_list {
     // End time relative to journal start
     uint32_t delta_end_s;
 
-    // Offset into extent section
-    uint32_t extent_index;
+    union {
+        // Offset into extent section
+        uint32_t extent_index;
+
+        // The storage number of all the points, when type is RRDENG_PAGE_TYPE_CONSTANT_32BIT
+        // (these pages are not in any extent)
+        uint32_t constant_value;
+    };
 
     // Update frequency
     uint32_t update_every_s;
@@ -249,11 +272,53 @@ struct journal_page_list {
     uint16_t page_length;
 
     // Page type identifier
+    //   - 0: a page in an extent
+    //   - RRDENG_PAGE_TYPE_CONSTANT_32BIT: a page without data in any extent
     uint8_t type;
 
     // --- implicit padding of 1-byte because the struct is not packed ---
 };
 
+// Page summary section header (16 bytes)
+// It is stored right after the journal v2 header, in its padding.
+struct journal_v2_summary_header {
+    // JOURVAL_V2_SUMMARY_MAGIC, when the file has page summaries
+    uint32_t magic;
+
+    // Offset to the index of the first summary of each metric
+    //   - One uint32_t per item of the metric list, in the same order
+    uint32_t metric_base_offset;
+
+    // Offset to the page summaries
+    //   - One journal_page_summary per page, in the order the pages are in the file
+    uint32_t summary_offset;
+
+    // Offset to the section CRC, covering both arrays
+    uint32_t trailer_offset;
+};
+
+// Page summary section item (24 bytes)
+// The aggregates of all the points of a page, so that queries that group
+// whole pages together can use them instead of loading the page.
+struct journal_page_summary {
+    // The minimum and the maximum of the points with a value
+    float min;
+    float max;
+
+    // The sum of the points with a value
+    float sum;
+
+    // The number of points in the page
+    //   - 0: the page does not have a summary
+    uint32_t entries;
+
+    // The number of collected points aggregated (0 when the page has only gaps)
+    uint32_t count;
+
+    // The number of collected points found anomalous
+    uint32_t anomaly_count;
+};
+
 struct wal;
 
 void journalfile_v1_generate_path(struct rrdengine_datafile *datafile, char *str, size_t maxlen);
@@ -281,6 +346,8 @@ bool journalfile_migrate_to_v2_callback(Word_t section, unsigned datafile_fileno
                                         size_t number_of_extents, size_t number_of_metrics, size_t number_of_pages, void *user_data);
 
 
+struct journal_v2_summary_header *journalfile_v2_summary_header(struct journal_v2_header *j2_header, size_t journal_v2_file_size);
+
 bool journalfile_v2_data_available(struct rrdengine_journalfile *journalfile);
 size_t journalfile_v2_data_size_get(struct rrdengine_journalfile *journalfile);
 void journalfile_v2_data_set(struct rrdengine_journalfile *journalfile, int fd, void *journal_data, uint32_t journal_data_size);
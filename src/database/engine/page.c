@@ -25,6 +25,10 @@ typedef struct {
 typedef struct {
     gorilla_writer_t *writer;
     uint16_t num_buffers;
+
+    // adaptive pages: the encoding selected when the page is flushed
+    uint16_t encoded_size;
+    uint8_t encoding;
 } page_gorilla_t;
 
 struct pgd {
@@ -80,6 +84,11 @@ static PRINTFLIKE(2, 3) void pgd_fatal(const PGD *pg, const char *fmt, ...) {
             added = true;
         }
 
+        if (pg->type == RRDENG_PAGE_TYPE_ADAPTIVE_32BIT) {
+            buffer_sprintf(wb, added ? "|%s" : "%s", "ADAPTIVE_32BIT");
+            added = true;
+        }
+
         if (!added) {
             int type = pg->type;
             buffer_sprintf(wb, "%d", type);
@@ -439,6 +448,375 @@ ALWAYS_INLINE void dbengine_extent_free(void *extent, size_t size) {
     pgd_data_free(extent, size, 0);
 }
 
+// ----------------------------------------------------------------------------
+// adaptive pages
+//
+// Adaptive pages are collected in gorilla buffers, like gorilla pages.
+// When they are flushed, the smallest of these encodings is written to disk:
+//
+// - gorilla, the page is written as a RRDENG_PAGE_TYPE_GORILLA_32BIT page
+// - constant, for pages with the same storage number in all slots
+// - delta, delta-of-delta of the storage numbers with runs of zeros, for counters and flat metrics
+//
+// Constant and delta pages are decoded on the fly by the query cursor,
+// without expanding them in memory.
+
+static struct {
+    struct pgd_encoding_stats encodings[PGD_ENCODING_MAX];
+} pgd_encoding_globals = { 0 };
+
+const char *pgd_encoding_name(PGD_ENCODING encoding) {
+    switch(encoding) {
+        case PGD_ENCODING_RAW:
+            return "raw";
+        case PGD_ENCODING_GORILLA:
+            return "gorilla";
+        case PGD_ENCODING_CONSTANT:
+            return "constant";
+        case PGD_ENCODING_DELTA:
+            return "delta";
+        case PGD_ENCODING_ELIDED:
+            return "elided";
+        default:
+            return "unknown";
+    }
+}
+
+void pgd_encoding_stats_get(struct pgd_encoding_stats stats[PGD_ENCODING_MAX]) {
+    for(size_t i = 0; i < PGD_ENCODING_MAX ; i++) {
+        stats[i].pages = __atomic_load_n(&pgd_encoding_globals.encodings[i].pages, __ATOMIC_RELAXED);
+        stats[i].points = __atomic_load_n(&pgd_encoding_globals.encodings[i].points, __ATOMIC_RELAXED);
+        stats[i].bytes = __atomic_load_n(&pgd_encoding_globals.encodings[i].bytes, __ATOMIC_RELAXED);
+    }
+}
+
+static ALWAYS_INLINE void pgd_encoding_stats_add(PGD_ENCODING encoding, size_t points, size_t bytes) {
+    __atomic_add_fetch(&pgd_encoding_globals.encodings[encoding].pages, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pgd_encoding_globals.encodings[encoding].points, points, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pgd_encoding_globals.encodings[encoding].bytes, bytes, __ATOMIC_RELAXED);
+}
+
+#define PGD_ADAPTIVE_GORILLA 0
+
+static ALWAYS_INLINE uint32_t pgd_varint_put(uint8_t *dst, uint64_t v) {
+    uint32_t len = 0;
+    while(v >= 0x80) {
+        if(dst) dst[len] = (uint8_t)(v | 0x80);
+        len++;
+        v >>= 7;
+    }
+    if(dst) dst[len] = (uint8_t)v;
+    return len + 1;
+}
+
+static ALWAYS_INLINE bool pgd_varint_get(const uint8_t *src, uint32_t size, uint32_t *offset, uint64_t *v) {
+    uint64_t result = 0;
+    for(uint32_t shift = 0; shift < 64 && *offset < size ; shift += 7) {
+        uint8_t b = src[(*offset)++];
+        result |= (uint64_t)(b & 0x7f) << shift;
+        if(!(b & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static ALWAYS_INLINE uint64_t pgd_zigzag_encode(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static ALWAYS_INLINE int64_t pgd_zigzag_decode(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// append a varint token to the payload, returns false when it does not fit
+static ALWAYS_INLINE bool pgd_adaptive_delta_put(uint8_t *dst, uint32_t *pos, uint32_t max_size, uint64_t v) {
+    uint32_t len = pgd_varint_put(NULL, v);
+    if(*pos + len > max_size)
+        return false;
+
+    if(dst)
+        pgd_varint_put(&dst[*pos], v);
+
+    *pos += len;
+    return true;
+}
+
+static ALWAYS_INLINE uint64_t pgd_adaptive_delta_run_token(uint32_t run) {
+    // a single zero delta-of-delta is cheaper than a run
+    return (run == 1) ? 0 : ((uint64_t)run << 1) | 1;
+}
+
+// encode the storage numbers of a collected page with delta-of-delta
+// when dst is NULL, it only calculates the size
+// returns the size of the payload, or 0 if it does not fit in max_size
+static uint32_t pgd_adaptive_delta_encode(PGD *pg, uint8_t *dst, uint32_t max_size) {
+    gorilla_reader_t gr = gorilla_writer_get_reader(pg->gorilla.writer);
+    uint32_t pos = sizeof(struct rrdeng_adaptive_page_header) + sizeof(uint32_t);
+    if(pos > max_size)
+        return 0;
+
+    uint32_t first;
+    if(!gorilla_reader_read(&gr, &first))
+        return 0;
+
+    if(dst) {
+        struct rrdeng_adaptive_page_header hdr = {
+            .encoding = RRDENG_ADAPTIVE_ENCODING_DELTA,
+            .entries = pg->used,
+        };
+        memcpy(dst, &hdr, sizeof(hdr));
+        memcpy(&dst[sizeof(hdr)], &first, sizeof(first));
+    }
+
+    uint32_t prev = first, run = 0;
+    int32_t prev_delta = 0;
+    for(uint32_t i = 1; i < pg->used ; i++) {
+        uint32_t value;
+        if(!gorilla_reader_read(&gr, &value))
+            return 0;
+
+        int32_t delta = (int32_t)(value - prev);
+        int64_t dod = (int64_t)delta - (int64_t)prev_delta;
+        prev = value;
+        prev_delta = delta;
+
+        if(!dod) {
+            run++;
+            continue;
+        }
+
+        if(run) {
+            if(!pgd_adaptive_delta_put(dst, &pos, max_size, pgd_adaptive_delta_run_token(run)))
+                return 0;
+            run = 0;
+        }
+
+        if(!pgd_adaptive_delta_put(dst, &pos, max_size, pgd_zigzag_encode(dod) << 1))
+            return 0;
+    }
+
+    if(run && !pgd_adaptive_delta_put(dst, &pos, max_size, pgd_adaptive_delta_run_token(run)))
+        return 0;
+
+    return pos;
+}
+
+// select the encoding of a collected adaptive page, when it is about to be flushed
+static void pgd_adaptive_select_encoding(PGD *pg) {
+    uint32_t gorilla_size = pg->gorilla.num_buffers * RRDENG_GORILLA_32BIT_BUFFER_SIZE;
+    uint32_t max_size = MIN(gorilla_size, RRDENG_BLOCK_SIZE);
+
+    pg->gorilla.encoding = PGD_ADAPTIVE_GORILLA;
+    pg->gorilla.encoded_size = 0;
+
+    if(pg->used < 2 || gorilla_writer_entries(pg->gorilla.writer) != pg->used)
+        return;
+
+    // constant
+    gorilla_reader_t gr = gorilla_writer_get_reader(pg->gorilla.writer);
+    uint32_t first, value;
+    bool constant = gorilla_reader_read(&gr, &first);
+    for(uint32_t i = 1; constant && i < pg->used ; i++)
+        constant = gorilla_reader_read(&gr, &value) && value == first;
+
+    if(constant) {
+        pg->gorilla.encoding = RRDENG_ADAPTIVE_ENCODING_CONSTANT;
+        pg->gorilla.encoded_size = sizeof(struct rrdeng_adaptive_page_header) + sizeof(uint32_t);
+        return;
+    }
+
+    // delta-of-delta, when smaller than gorilla
+    uint32_t size = pgd_adaptive_delta_encode(pg, NULL, max_size - 1);
+    if(size) {
+        pg->gorilla.encoding = RRDENG_ADAPTIVE_ENCODING_DELTA;
+        pg->gorilla.encoded_size = size;
+    }
+}
+
+static void pgd_adaptive_copy_to_extent(PGD *pg, uint8_t *dst, uint32_t dst_size) {
+    switch(pg->gorilla.encoding) {
+        case RRDENG_ADAPTIVE_ENCODING_CONSTANT: {
+            gorilla_reader_t gr = gorilla_writer_get_reader(pg->gorilla.writer);
+            uint32_t value = 0;
+            gorilla_reader_read(&gr, &value);
+
+            struct rrdeng_adaptive_page_header hdr = {
+                .encoding = RRDENG_ADAPTIVE_ENCODING_CONSTANT,
+                .entries = pg->used,
+            };
+            memcpy(dst, &hdr, sizeof(hdr));
+            memcpy(&dst[sizeof(hdr)], &value, sizeof(value));
+            break;
+        }
+
+        case RRDENG_ADAPTIVE_ENCODING_DELTA: {
+            uint32_t size = pgd_adaptive_delta_encode(pg, dst, dst_size);
+            UNUSED(size);
+            internal_fatal(size != dst_size, "adaptive page delta encoding size changed (expected %u, got %u)", dst_size, size);
+            break;
+        }
+
+        default: {
+            bool ok = gorilla_writer_serialize(pg->gorilla.writer, dst, dst_size);
+            UNUSED(ok);
+            internal_fatal(!ok,
+                           "pgd_copy_to_extent() tried to serialize pg=%p, gw=%p (with dst_size=%u bytes, num_buffers=%u)",
+                           pg, pg->gorilla.writer, dst_size, pg->gorilla.num_buffers);
+            break;
+        }
+    }
+}
+
+// check the payload of an adaptive page loaded from disk, and return its entries
+static uint32_t pgd_adaptive_disk_entries(const void *base, uint32_t size) {
+    struct rrdeng_adaptive_page_header hdr;
+    if(size < sizeof(hdr) + sizeof(uint32_t))
+        return 0;
+
+    memcpy(&hdr, base, sizeof(hdr));
+    switch(hdr.encoding) {
+        case RRDENG_ADAPTIVE_ENCODING_CONSTANT:
+            if(size != sizeof(hdr) + sizeof(uint32_t))
+                return 0;
+            break;
+
+        case RRDENG_ADAPTIVE_ENCODING_DELTA:
+            break;
+
+        default:
+            return 0;
+    }
+
+    return hdr.entries;
+}
+
+// ----------------------------------------------------------------------------
+// constant pages
+//
+// Collected tier0 pages that have the same storage number in all their slots
+// are not written to extents. Their descriptors carry the value, and when they
+// are queried, they are recreated in memory as adaptive constant pages.
+
+ALWAYS_INLINE bool pgd_constant_value(PGD *pg, storage_number *value)
+{
+    if (!pg || pg == PGD_EMPTY || !pg->used ||
+        !(pg->states & (PGD_STATE_CREATED_FROM_COLLECTOR | PGD_STATE_SCHEDULED_FOR_FLUSHING)))
+        return false;
+
+    switch (pg->type) {
+        case RRDENG_PAGE_TYPE_ARRAY_32BIT: {
+            storage_number *array = (storage_number *) pg->raw.data;
+            for (uint32_t i = 1; i < pg->used; i++) {
+                if (array[i] != array[0])
+                    return false;
+            }
+
+            *value = array[0];
+            return true;
+        }
+
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
+            if (!pg->gorilla.writer || gorilla_writer_entries(pg->gorilla.writer) != pg->used)
+                return false;
+
+            gorilla_reader_t gr = gorilla_writer_get_reader(pg->gorilla.writer);
+            uint32_t first, n;
+            if (!gorilla_reader_read(&gr, &first))
+                return false;
+
+            for (uint32_t i = 1; i < pg->used; i++) {
+                if (!gorilla_reader_read(&gr, &n) || n != first)
+                    return false;
+            }
+
+            *value = first;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+PGD *pgd_create_constant(storage_number value, uint32_t entries)
+{
+    uint8_t payload[sizeof(struct rrdeng_adaptive_page_header) + sizeof(uint32_t)];
+
+    struct rrdeng_adaptive_page_header hdr = {
+        .encoding = RRDENG_ADAPTIVE_ENCODING_CONSTANT,
+        .entries = entries,
+    };
+    memcpy(payload, &hdr, sizeof(hdr));
+    memcpy(&payload[sizeof(hdr)], &value, sizeof(value));
+
+    return pgd_create_from_disk_data(RRDENG_PAGE_TYPE_ADAPTIVE_32BIT, payload, sizeof(payload));
+}
+
+void pgd_elide_from_extent(PGD *pg)
+{
+    if ((pg->states & PGD_STATE_SCHEDULED_FOR_FLUSHING) == 0)
+        fatal("Eliding from extent is supported only for PGDs that are scheduled for flushing.");
+
+    pgd_encoding_stats_add(PGD_ENCODING_ELIDED, pg->used, 0);
+    pg->states = PGD_STATE_FLUSHED_TO_DISK;
+}
+
+// ----------------------------------------------------------------------------
+// page summaries
+//
+// The aggregates of all the points of a page are computed when the page is
+// flushed, and are kept in the journals, so that queries that group whole
+// pages together do not need to load them.
+
+bool pgd_summarize(PGD *pg, struct journal_page_summary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+
+    uint32_t entries = pgd_slots_used(pg);
+    if (!entries)
+        return false;
+
+    NETDATA_DOUBLE min = NAN, max = NAN, sum = 0.0;
+    uint32_t count = 0, anomaly_count = 0;
+
+    PGDC pgdc;
+    pgdc_reset(&pgdc, pg, 0);
+
+    for (uint32_t i = 0; i < entries; i++) {
+        STORAGE_POINT sp = { 0 };
+        if (!pgdc_get_next_point(&pgdc, i, &sp))
+            return false;
+
+        if (storage_point_is_gap(sp))
+            continue;
+
+        // the queries have to see the resets of the counters
+        if (sp.flags & SN_FLAG_RESET)
+            return false;
+
+        if (!count || sp.min < min)
+            min = sp.min;
+
+        if (!count || sp.max > max)
+            max = sp.max;
+
+        sum += sp.sum;
+        count += sp.count;
+        anomaly_count += sp.anomaly_count;
+    }
+
+    summary->entries = entries;
+    summary->count = count;
+    summary->anomaly_count = anomaly_count;
+    summary->min = (float)(count ? min : 0.0);
+    summary->max = (float)(count ? max : 0.0);
+    summary->sum = (float)sum;
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // management api
 
@@ -453,7 +831,8 @@ ALWAYS_INLINE PGD *pgd_create(uint8_t type, uint32_t slots) {
     pg->slots = slots;
 
     switch (type) {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             internal_fatal(slots == 1,
                       "DBENGINE: invalid number of slots (%u) or page type (%u)", slots, type);
 
@@ -467,6 +846,8 @@ ALWAYS_INLINE PGD *pgd_create(uint8_t type, uint32_t slots) {
 
             *pg->gorilla.writer = gorilla_writer_init(gbuf, RRDENG_GORILLA_32BIT_BUFFER_SLOTS);
             pg->gorilla.num_buffers = 1;
+            pg->gorilla.encoded_size = 0;
+            pg->gorilla.encoding = PGD_ADAPTIVE_GORILLA;
 
             break;
         }
@@ -531,6 +912,24 @@ ALWAYS_INLINE PGD *pgd_create_from_disk_data(uint8_t type, void *base, uint32_t
             memcpy(pg->raw.data, base, size);
             break;
 
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
+            // the payload is kept encoded, the cursor decodes it
+            uint32_t entries = pgd_adaptive_disk_entries(base, size);
+            if(!entries || entries > UINT16_MAX) {
+                aral_freez(pgd_alloc_globals.aral_pgd[pg->partition], pg);
+                pg = PGD_EMPTY;
+                break;
+            }
+
+            pg->used = entries;
+            pg->slots = pg->used;
+
+            pg->raw.size = size;
+            pg->raw.data = pgd_data_alloc(size, pg->partition, false);
+            memcpy(pg->raw.data, base, size);
+            break;
+        }
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, type);
             aral_freez(pgd_alloc_globals.aral_pgd[pg->partition], pg);
@@ -550,7 +949,8 @@ void pgd_free(PGD *pg) {
 
     switch (pg->type)
     {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             if (pg->states & PGD_STATE_CREATED_FROM_DISK)
             {
                 internal_fatal(pg->raw.data == NULL, "Tried to free gorilla PGD loaded from disk with NULL data");
@@ -627,7 +1027,8 @@ static void pgd_aral_unmark(PGD *pg) {
 
     switch (pg->type)
     {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             if (pg->states & PGD_STATE_CREATED_FROM_DISK)
                 pgd_data_unmark(pg->raw.data, pg->raw.size, pg->partition);
 
@@ -672,6 +1073,12 @@ static void pgd_aral_unmark(PGD *pg) {
 
 ALWAYS_INLINE uint32_t pgd_type(PGD *pg)
 {
+    // adaptive pages that are flushed as gorilla, are gorilla pages on disk
+    if (pg->type == RRDENG_PAGE_TYPE_ADAPTIVE_32BIT &&
+        !(pg->states & (PGD_STATE_CREATED_FROM_DISK | PGD_STATE_CREATED_FROM_COLLECTOR)) &&
+        pg->gorilla.encoding == PGD_ADAPTIVE_GORILLA)
+        return RRDENG_PAGE_TYPE_GORILLA_32BIT;
+
     return pg->type;
 }
 
@@ -725,7 +1132,8 @@ ALWAYS_INLINE uint32_t pgd_memory_footprint(PGD *pg)
     size_t footprint = pgd_alloc_globals.sizeof_pgd;
 
     switch (pg->type) {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             if (pg->states & PGD_STATE_CREATED_FROM_DISK)
                 footprint += pgd_data_footprint(pg->raw.size, pg->partition);
 
@@ -761,7 +1169,8 @@ uint32_t pgd_buffer_memory_footprint(PGD *pg)
     size_t footprint = 0;
 
     switch (pg->type) {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             if (pg->states & PGD_STATE_CREATED_FROM_DISK)
                 footprint = pg->raw.size;
 
@@ -831,6 +1240,29 @@ uint32_t pgd_disk_footprint(PGD *pg)
             break;
         }
 
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
+            if (pg->states & PGD_STATE_CREATED_FROM_COLLECTOR) {
+                internal_fatal(!pg->gorilla.writer,
+                               "pgd_disk_footprint() not implemented for NULL gorilla writers");
+
+                pgd_adaptive_select_encoding(pg);
+
+                pulse_gorilla_tier0_page_flush(
+                    gorilla_writer_actual_nbytes(pg->gorilla.writer),
+                    gorilla_writer_optimal_nbytes(pg->gorilla.writer),
+                    tier_page_size[0]);
+            }
+            else if (!(pg->states & (PGD_STATE_SCHEDULED_FOR_FLUSHING | PGD_STATE_FLUSHED_TO_DISK)))
+                fatal("Asked disk footprint on unknown page state");
+
+            if (pg->gorilla.encoding == PGD_ADAPTIVE_GORILLA)
+                size = pg->gorilla.num_buffers * RRDENG_GORILLA_32BIT_BUFFER_SIZE;
+            else
+                size = pg->gorilla.encoded_size;
+
+            break;
+        }
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, pg->type);
             break;
@@ -872,11 +1304,38 @@ void pgd_copy_to_extent(PGD *pg, uint8_t *dst, uint32_t dst_size)
             memcpy(dst, pg->raw.data, dst_size);
             break;
 
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
+            if ((pg->states & PGD_STATE_SCHEDULED_FOR_FLUSHING) == 0)
+                fatal("Copying to extent is supported only for PGDs that are scheduled for flushing.");
+
+            pgd_adaptive_copy_to_extent(pg, dst, dst_size);
+            break;
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, pg->type);
             break;
     }
 
+    switch(pg->type) {
+        case RRDENG_PAGE_TYPE_ARRAY_32BIT:
+            pgd_encoding_stats_add(PGD_ENCODING_RAW, pg->used, dst_size);
+            break;
+
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+            pgd_encoding_stats_add(PGD_ENCODING_GORILLA, pg->used, dst_size);
+            break;
+
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
+            pgd_encoding_stats_add(
+                pg->gorilla.encoding == RRDENG_ADAPTIVE_ENCODING_CONSTANT ? PGD_ENCODING_CONSTANT :
+                pg->gorilla.encoding == RRDENG_ADAPTIVE_ENCODING_DELTA ? PGD_ENCODING_DELTA : PGD_ENCODING_GORILLA,
+                pg->used, dst_size);
+            break;
+
+        default:
+            break;
+    }
+
     pg->states = PGD_STATE_FLUSHED_TO_DISK;
 }
 
@@ -919,7 +1378,8 @@ size_t pgd_append_point(
               pg->type, pg->slots, pg->used /* FIXME:, pg->size */);
 
     switch (pg->type) {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             pg->used++;
             storage_number t = pack_storage_number(n, flags);
 
@@ -979,12 +1439,75 @@ size_t pgd_append_point(
 // ----------------------------------------------------------------------------
 // querying with cursor
 
+// decode the storage number at position of an adaptive page loaded from disk
+static ALWAYS_INLINE bool pgdc_adaptive_read(PGDC *pgdc, uint32_t position) {
+    PGD *pg = pgdc->pgd;
+    const uint8_t *data = pg->raw.data;
+    uint32_t size = pg->raw.size;
+
+    if (unlikely(!position)) {
+        uint8_t encoding = data[0];
+        memcpy(&pgdc->adaptive.value, &data[sizeof(struct rrdeng_adaptive_page_header)], sizeof(uint32_t));
+        pgdc->adaptive.offset = (encoding == RRDENG_ADAPTIVE_ENCODING_CONSTANT) ? 0 :
+            sizeof(struct rrdeng_adaptive_page_header) + sizeof(uint32_t);
+        pgdc->adaptive.delta = 0;
+        pgdc->adaptive.run = 0;
+        return true;
+    }
+
+    // constant pages
+    if (unlikely(!pgdc->adaptive.offset))
+        return true;
+
+    int64_t dod = 0;
+    if (pgdc->adaptive.run)
+        pgdc->adaptive.run--;
+    else {
+        uint64_t v;
+        if (unlikely(!pgd_varint_get(data, size, &pgdc->adaptive.offset, &v)))
+            return false;
+
+        if (v & 1) {
+            if (unlikely(v < 4))
+                return false;
+
+            // this is the first of the run
+            pgdc->adaptive.run = (uint32_t)(v >> 1) - 1;
+        }
+        else
+            dod = pgd_zigzag_decode(v >> 1);
+    }
+
+    pgdc->adaptive.delta = (int32_t)((int64_t)pgdc->adaptive.delta + dod);
+    pgdc->adaptive.value += (uint32_t)pgdc->adaptive.delta;
+    return true;
+}
+
 static void pgdc_seek(PGDC *pgdc, uint32_t position)
 {
     PGD *pg = pgdc->pgd;
 
+    if (pg->type == RRDENG_PAGE_TYPE_ADAPTIVE_32BIT && (pg->states & PGD_STATE_CREATED_FROM_DISK)) {
+        pgdc->slots = pg->used;
+        pgdc->adaptive.offset = 0;
+        pgdc->adaptive.value = 0;
+        pgdc->adaptive.delta = 0;
+        pgdc->adaptive.run = 0;
+
+        if (position > pgdc->slots)
+            position = pgdc->slots;
+
+        for (uint32_t i = 0; i != position; i++) {
+            if (!pgdc_adaptive_read(pgdc, i))
+                break;
+        }
+
+        return;
+    }
+
     switch (pg->type) {
-        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT: {
             if (pg->states & PGD_STATE_CREATED_FROM_DISK) {
                 pgdc->slots = pgdc->pgd->slots;
                 pgdc->gr = gorilla_reader_init((void *) pg->raw.data);
@@ -1060,6 +1583,26 @@ bool pgdc_get_next_point(PGDC *pgdc, uint32_t expected_position __maybe_unused,
 
     switch (pgdc->pgd->type)
     {
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
+            if (pgdc->pgd->states & PGD_STATE_CREATED_FROM_DISK) {
+                if (unlikely(!pgdc_adaptive_read(pgdc, pgdc->position++))) {
+                    // corrupted payload, stop here
+                    pgdc->slots = pgdc->position;
+                    storage_point_empty(*sp, sp->start_time_s, sp->end_time_s);
+                    return false;
+                }
+
+                storage_number n = pgdc->adaptive.value;
+                sp->min = sp->max = sp->sum = unpack_storage_number(n);
+                sp->flags = (SN_FLAGS)(n & SN_USER_FLAGS);
+                sp->count = 1;
+                sp->anomaly_count = is_storage_number_anomalous(n) ? 1 : 0;
+                return true;
+            }
+
+            // collected pages are gorilla pages
+            // fall through
+
         case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
             pgdc->position++;
 
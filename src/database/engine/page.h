@@ -15,6 +15,14 @@ typedef struct pgd_cursor {
     uint32_t slots;
 
     gorilla_reader_t gr;
+
+    // the state of the decoder of adaptive pages loaded from disk
+    struct {
+        uint32_t offset;    // the next byte of the payload
+        uint32_t value;     // the last storage number
+        int32_t delta;      // the last delta
+        uint32_t run;       // the remaining zero delta-of-delta of a run
+    } adaptive;
 } PGDC;
 
 #include "rrdengine.h"
@@ -43,6 +51,14 @@ size_t pgd_padding_bytes(void);
 
 void pgd_copy_to_extent(PGD *pg, uint8_t *dst, uint32_t dst_size);
 
+// constant pages are not written to extents, their descriptors have their value
+bool pgd_constant_value(PGD *pg, storage_number *value);
+PGD *pgd_create_constant(storage_number value, uint32_t entries);
+void pgd_elide_from_extent(PGD *pg);
+
+// the aggregates of all the points of a page, false when it cannot be summarized
+bool pgd_summarize(PGD *pg, struct journal_page_summary *summary);
+
 size_t pgd_append_point(PGD *pg,
                       usec_t point_in_time_ut,
                       NETDATA_DOUBLE n,
@@ -56,6 +72,27 @@ size_t pgd_append_point(PGD *pg,
 void pgdc_reset(PGDC *pgdc, PGD *pgd, uint32_t position);
 bool pgdc_get_next_point(PGDC *pgdc, uint32_t expected_position, STORAGE_POINT *sp);
 
+// the tier0 pages flushed to disk, per encoding
+typedef enum {
+    PGD_ENCODING_RAW = 0,
+    PGD_ENCODING_GORILLA,
+    PGD_ENCODING_CONSTANT,
+    PGD_ENCODING_DELTA,
+    PGD_ENCODING_ELIDED,
+
+    // terminator
+    PGD_ENCODING_MAX,
+} PGD_ENCODING;
+
+struct pgd_encoding_stats {
+    size_t pages;
+    size_t points;
+    size_t bytes;
+};
+
+const char *pgd_encoding_name(PGD_ENCODING encoding);
+void pgd_encoding_stats_get(struct pgd_encoding_stats stats[PGD_ENCODING_MAX]);
+
 void *dbengine_extent_alloc(size_t size);
 void dbengine_extent_free(void *extent, size_t size);
 
@@ -42,8 +42,24 @@ static void main_cache_flush_dirty_page_callback(PGC *cache __maybe_unused, PGC_
         descr->update_every_s = entries_array[Index].update_every_s;
 
         descr->pgd = pgc_page_data(pages_array[Index]);
-        descr->type = pgd_type(descr->pgd);
+        // the disk footprint selects the encoding of adaptive pages, so it has to be first
         descr->page_length = pgd_disk_footprint(descr->pgd);
+        descr->type = pgd_type(descr->pgd);
+        descr->constant_value = 0;
+
+        // the summary stays zeroed (unavailable) when the page cannot be summarized
+        pgd_summarize(descr->pgd, &descr->summary);
+
+        storage_number value;
+        if (dbengine_elide_constant_pages && descr->update_every_s <= UINT16_MAX && pgd_constant_value(descr->pgd, &value)) {
+            // elide it from the extent, its descriptor is enough
+            __atomic_add_fetch(&rrdeng_cache_efficiency_stats.pages_constant_elided, 1, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&rrdeng_cache_efficiency_stats.pages_constant_elided_bytes, descr->page_length, __ATOMIC_RELAXED);
+
+            descr->type = RRDENG_PAGE_TYPE_CONSTANT_32BIT;
+            descr->page_length = 0;
+            descr->constant_value = value;
+        }
 
         DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(base, descr, link.prev, link.next);
     }
@@ -211,6 +227,89 @@ static ALWAYS_INLINE_HOT struct page_details *pdc_find_page_for_time(
     return NULL;
 }
 
+// constant pages have no payload on disk, so we recreate them from their descriptors
+static PGC_PAGE *pgc_constant_page_add_and_acquire(struct rrdengine_instance *ctx, Word_t metric_id,
+        time_t start_time_s, time_t end_time_s, uint32_t update_every_s, storage_number value) {
+
+    size_t entries = (update_every_s) ? page_entries_by_time(start_time_s, end_time_s, update_every_s) : 1;
+    PGD *pgd = pgd_create_constant(value, entries);
+
+    PGC_ENTRY page_entry = {
+            .hot = false,
+            .section = (Word_t)ctx,
+            .metric_id = metric_id,
+            .start_time_s = start_time_s,
+            .end_time_s = end_time_s,
+            .update_every_s = update_every_s,
+            .size = pgd_memory_footprint(pgd),
+            .data = pgd,
+    };
+
+    bool added = true;
+    PGC_PAGE *page = pgc_page_add_and_acquire(main_cache, page_entry, &added);
+    if(added)
+        __atomic_add_fetch(&rrdeng_cache_efficiency_stats.pages_data_source_constant, 1, __ATOMIC_RELAXED);
+    else
+        pgd_free(pgd);
+
+    return page;
+}
+
+static void pd_set_constant_page(struct page_details *pd, PGC_PAGE *page) {
+    pd->page = page;
+    pd->status |= PDC_PAGE_READY | PDC_PAGE_PRELOADED;
+
+    if(pgd_is_empty(pgc_page_data(page)))
+        pd->status |= PDC_PAGE_EMPTY;
+}
+
+// ----------------------------------------------------------------------------
+// page summaries
+
+static void pd_set_summary(struct page_details *pd, struct extent_io_data *xio) {
+    // the summary has to describe the page we know
+    if(!xio->summary.entries || !pd->update_every_s ||
+        xio->summary.entries != page_entries_by_time(pd->first_time_s, pd->last_time_s, pd->update_every_s))
+        return;
+
+    pd->summary = xio->summary;
+    pd->status |= PDC_PAGE_SUMMARY_AVAILABLE;
+}
+
+// true when all the points of the page are in the same group of the query
+// the page covers (first_time_s - update_every_s, last_time_s], like its points
+static bool pd_fits_in_a_group(struct page_details *pd, time_t group_anchor_s, time_t group_every_s) {
+    if(!group_every_s || !(pd->status & PDC_PAGE_SUMMARY_AVAILABLE))
+        return false;
+
+    time_t start_s = pd->first_time_s - (time_t)pd->update_every_s - group_anchor_s;
+    time_t end_s = pd->last_time_s - group_anchor_s;
+
+    time_t group = start_s / group_every_s;
+    if(start_s % group_every_s < 0)
+        group--;
+
+    return end_s <= (group + 1) * group_every_s;
+}
+
+static void pd_summary_to_storage_point(struct page_details *pd, STORAGE_POINT *sp) {
+    sp->start_time_s = pd->first_time_s - (time_t)pd->update_every_s;
+    sp->end_time_s = pd->last_time_s;
+
+    if(!pd->summary.count) {
+        // all the points of the page are gaps
+        storage_point_empty(*sp, sp->start_time_s, sp->end_time_s);
+        return;
+    }
+
+    sp->min = pd->summary.min;
+    sp->max = pd->summary.max;
+    sp->sum = pd->summary.sum;
+    sp->count = pd->summary.count;
+    sp->anomaly_count = pd->summary.anomaly_count;
+    sp->flags = (pd->summary.anomaly_count) ? SN_FLAG_NONE : SN_FLAG_NOT_ANOMALOUS;
+}
+
 static ALWAYS_INLINE_HOT size_t get_page_list_from_pgc(PGC *cache, METRIC *metric, struct rrdengine_instance *ctx,
         time_t wanted_start_time_s, time_t wanted_end_time_s,
         Pvoid_t *JudyL_page_array, size_t *cache_gaps,
@@ -293,12 +392,17 @@ static ALWAYS_INLINE_HOT size_t get_page_list_from_pgc(PGC *cache, METRIC *metri
 
             if(open_cache_mode) {
                 struct rrdengine_datafile *datafile = pgc_page_data(page);
-                if(datafile_acquire(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS)) { // for pd
-                    struct extent_io_data *xio = (struct extent_io_data *) pgc_page_custom_data(cache, page);
+                struct extent_io_data *xio = (struct extent_io_data *) pgc_page_custom_data(cache, page);
+                if(xio->page_type == RRDENG_PAGE_TYPE_CONSTANT_32BIT) {
+                    pd_set_constant_page(pd, pgc_constant_page_add_and_acquire(
+                        ctx, metric_id, page_start_time_s, page_end_time_s, page_update_every_s, xio->constant_value));
+                }
+                else if(datafile_acquire(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS)) { // for pd
                     pd->datafile.ptr = pgc_page_data(page);
                     pd->datafile.block = xio->block;
                     pd->datafile.bytes = xio->bytes;
                     pd->status |= PDC_PAGE_DATAFILE_ACQUIRED | PDC_PAGE_DISK_PENDING;
+                    pd_set_summary(pd, xio);
                 }
                 else {
                     pd->status |= PDC_PAGE_FAILED | PDC_PAGE_FAILED_TO_ACQUIRE_DATAFILE;
@@ -364,7 +468,9 @@ static ALWAYS_INLINE_HOT size_t list_has_time_gaps(
         size_t *pages_overlapping,
         time_t *optimal_end_time_s,
         bool populate_gaps,
-        PDC_PAGE_STATUS *common_status
+        PDC_PAGE_STATUS *common_status,
+        time_t group_anchor_s,
+        time_t group_every_s
 ) {
     // we will recalculate these, so zero them
     *pages_to_load_from_disk = 0;
@@ -435,7 +541,7 @@ static ALWAYS_INLINE_HOT size_t list_has_time_gaps(
         if(!(pd->status & PDC_PAGE_PREPROCESSED)) {
             (*pages_overlapping)++;
             pd->status |= PDC_PAGE_SKIP;
-            pd->status &= ~(PDC_PAGE_READY | PDC_PAGE_DISK_PENDING);
+            pd->status &= ~(PDC_PAGE_READY | PDC_PAGE_DISK_PENDING | PDC_PAGE_SUMMARIZED);
             *common_status |= pd->status;
             continue;
         }
@@ -448,16 +554,22 @@ static ALWAYS_INLINE_HOT size_t list_has_time_gaps(
             if(pd->page) {
                 (*pages_found_pass4)++;
 
-                pd->status &= ~PDC_PAGE_DISK_PENDING;
+                pd->status &= ~(PDC_PAGE_DISK_PENDING | PDC_PAGE_SUMMARIZED);
                 pd->status |= PDC_PAGE_READY | PDC_PAGE_PRELOADED | PDC_PAGE_PRELOADED_PASS4;
 
                 if(pgd_is_empty(pgc_page_data(pd->page)))
                     pd->status |= PDC_PAGE_EMPTY;
 
             }
+            else if(!(pd->status & PDC_PAGE_FAILED) && pd_fits_in_a_group(pd, group_anchor_s, group_every_s)) {
+                // the query needs only the aggregates of this page
+                pd->status &= ~PDC_PAGE_DISK_PENDING;
+                pd->status |= PDC_PAGE_SUMMARIZED;
+            }
             else if(!(pd->status & PDC_PAGE_FAILED) && (pd->status & PDC_PAGE_DATAFILE_ACQUIRED)) {
                 (*pages_to_load_from_disk)++;
 
+                pd->status &= ~PDC_PAGE_SUMMARIZED;
                 pd->status |= PDC_PAGE_DISK_PENDING;
 
                 internal_fatal(pd->status & PDC_PAGE_SKIP, "page is disk pending and skipped");
@@ -565,6 +677,16 @@ static NOT_INLINE_HOT size_t get_page_list_from_journal_v2(struct rrdengine_inst
 
             struct journal_page_list *page_list =
                 (struct journal_page_list *)((uint8_t *)page_list_header + sizeof(*page_list_header));
+
+            // the summaries of the pages of this metric, when the file has them
+            struct journal_page_summary *summaries = NULL;
+            struct journal_v2_summary_header *summary_header = journalfile_v2_summary_header(j2_header, journal_v2_file_size);
+            if(summary_header) {
+                uint32_t *metric_base = (uint32_t *)((uint8_t *)j2_header + summary_header->metric_base_offset);
+                uint32_t base = metric_base[uuid_entry - uuid_list];
+                if(base <= j2_header->page_count && page_list_header->entries <= j2_header->page_count - base)
+                    summaries = (struct journal_page_summary *)((uint8_t *)j2_header + summary_header->summary_offset) + base;
+            }
             struct journal_extent_list *extent_list = (void *)((uint8_t *)j2_header + j2_header->extent_offset);
             uint32_t extent_entries = j2_header->extent_count;
             uint32_t uuid_page_entries = page_list_header->entries;
@@ -594,8 +716,10 @@ static NOT_INLINE_HOT size_t get_page_list_from_journal_v2(struct rrdengine_inst
                 if (prc == PAGE_IS_IN_THE_FUTURE)
                     break;
 
+                bool constant = (page_entry_in_journal->type == RRDENG_PAGE_TYPE_CONSTANT_32BIT);
+
                 // Make sure index is valid for this file
-                if (page_entry_in_journal->extent_index >= extent_entries) {
+                if (!constant && page_entry_in_journal->extent_index >= extent_entries) {
                     nd_log_limit_static_thread_var(erl, 60, 0);
                     nd_log_limit(&erl, NDLS_DAEMON, NDLP_ERR,
                                  "DBENGINE: Invalid extent index in journalfile %u",
@@ -610,10 +734,19 @@ static NOT_INLINE_HOT size_t get_page_list_from_journal_v2(struct rrdengine_inst
                     // add this page to open cache
                     bool added = false;
                     struct extent_io_data ei = {0};
-                    ei.block = OFFSET_TO_BLOCK(extent_list[page_entry_in_journal->extent_index].datafile_offset);
-                    ei.bytes = extent_list[page_entry_in_journal->extent_index].datafile_size;
+                    if (constant) {
+                        ei.page_type = RRDENG_PAGE_TYPE_CONSTANT_32BIT;
+                        ei.constant_value = page_entry_in_journal->constant_value;
+                    }
+                    else {
+                        ei.block = OFFSET_TO_BLOCK(extent_list[page_entry_in_journal->extent_index].datafile_offset);
+                        ei.bytes = extent_list[page_entry_in_journal->extent_index].datafile_size;
+                    }
                     ei.fileno = datafile->fileno;
 
+                    if (summaries)
+                        ei.summary = summaries[index];
+
                     PGC_ENTRY e = {0};
                     e.hot = false;
                     e.section = (Word_t)ctx;
@@ -653,8 +786,10 @@ release_journal:
 
 void add_page_details_from_journal_v2(PGC_PAGE *page, void *JudyL_pptr) {
     struct rrdengine_datafile *datafile = pgc_page_data(page);
+    struct extent_io_data *ei = pgc_page_custom_data(open_cache, page);
+    bool constant = (ei->page_type == RRDENG_PAGE_TYPE_CONSTANT_32BIT);
 
-    if(!datafile_acquire(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS)) // for pd
+    if(!constant && !datafile_acquire(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS)) // for pd
         return;
 
     Pvoid_t *PValue = PDCJudyLIns(JudyL_pptr, pgc_page_start_time_s(page), PJE0);
@@ -662,17 +797,29 @@ void add_page_details_from_journal_v2(PGC_PAGE *page, void *JudyL_pptr) {
         fatal("DBENGINE: corrupted judy array");
 
     if (unlikely(*PValue)) {
-        datafile_release(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS);
+        if(!constant)
+            datafile_release(datafile, DATAFILE_ACQUIRE_PAGE_DETAILS);
         return;
     }
 
     Word_t metric_id = pgc_page_metric(page);
 
     // let's add it to the judy
-    struct extent_io_data *ei = pgc_page_custom_data(open_cache, page);
     struct page_details *pd = page_details_get();
     *PValue = pd;
 
+    if(constant) {
+        pd->first_time_s = pgc_page_start_time_s(page);
+        pd->last_time_s = pgc_page_end_time_s(page);
+        pd->update_every_s = (uint32_t) pgc_page_update_every_s(page);
+        pd->metric_id = metric_id;
+        pd->status |= PDC_PAGE_SOURCE_JOURNAL_V2;
+        pd_set_constant_page(pd, pgc_constant_page_add_and_acquire(
+            (struct rrdengine_instance *)pgc_page_section(page), metric_id,
+            pd->first_time_s, pd->last_time_s, pd->update_every_s, ei->constant_value));
+        return;
+    }
+
     pd->datafile.block = ei->block;
     pd->datafile.bytes = ei->bytes;
     pd->first_time_s = pgc_page_start_time_s(page);
@@ -681,6 +828,7 @@ void add_page_details_from_journal_v2(PGC_PAGE *page, void *JudyL_pptr) {
     pd->update_every_s = (uint32_t) pgc_page_update_every_s(page);
     pd->metric_id = metric_id;
     pd->status |= PDC_PAGE_DISK_PENDING | PDC_PAGE_SOURCE_JOURNAL_V2 | PDC_PAGE_DATAFILE_ACQUIRED;
+    pd_set_summary(pd, ei);
 }
 
 // Return a judyL will all pages that have start_time_ut and end_time_ut
@@ -694,7 +842,9 @@ static ALWAYS_INLINE_HOT Pvoid_t get_page_list(
         usec_t end_time_ut,
         time_t *optimal_end_time_s,
         size_t *pages_to_load_from_disk,
-        PDC_PAGE_STATUS *common_status
+        PDC_PAGE_STATUS *common_status,
+        time_t group_anchor_s,
+        time_t group_every_s
 ) {
     *optimal_end_time_s = 0;
     *pages_to_load_from_disk = 0;
@@ -731,7 +881,8 @@ static ALWAYS_INLINE_HOT Pvoid_t get_page_list(
     if(pages_found_in_main_cache && !cache_gaps) {
         query_gaps = list_has_time_gaps(ctx, metric, JudyL_page_array, wanted_start_time_s, wanted_end_time_s,
                                         &pages_total, &pages_found_pass4, pages_to_load_from_disk, &pages_overlapping,
-                                        optimal_end_time_s, false, common_status);
+                                        optimal_end_time_s, false, common_status,
+                                        group_anchor_s, group_every_s);
 
         if (pages_total && !query_gaps)
             goto we_are_done;
@@ -753,7 +904,8 @@ static ALWAYS_INLINE_HOT Pvoid_t get_page_list(
     if(pages_found_in_open_cache) {
         query_gaps = list_has_time_gaps(ctx, metric, JudyL_page_array, wanted_start_time_s, wanted_end_time_s,
                                         &pages_total, &pages_found_pass4, pages_to_load_from_disk, &pages_overlapping,
-                                        optimal_end_time_s, false, common_status);
+                                        optimal_end_time_s, false, common_status,
+                                        group_anchor_s, group_every_s);
 
         if (pages_total && !query_gaps)
             goto we_are_done;
@@ -777,7 +929,8 @@ static ALWAYS_INLINE_HOT Pvoid_t get_page_list(
     pass4_ut = now_monotonic_usec();
     query_gaps = list_has_time_gaps(ctx, metric, JudyL_page_array, wanted_start_time_s, wanted_end_time_s,
                                     &pages_total, &pages_found_pass4, pages_to_load_from_disk, &pages_overlapping,
-                                    optimal_end_time_s, true, common_status);
+                                    optimal_end_time_s, true, common_status,
+                                    group_anchor_s, group_every_s);
     done_pass4 = true;
 
 we_are_done:
@@ -832,7 +985,11 @@ ALWAYS_INLINE_HOT void rrdeng_prep_query(struct page_details_control *pdc, bool
                                                  pdc->end_time_s * USEC_PER_SEC,
                                                  &pdc->optimal_end_time_s,
                                                  &pdc->pages_to_load_from_disk,
-                                                 &pdc->common_status);
+                                                 &pdc->common_status,
+                                                 pdc->group_anchor_s,
+                                                 pdc->group_every_s);
+
+    prefetch_query_prepared(pdc);
 
     internal_fatal(pdc->pages_to_load_from_disk && !(pdc->common_status & PDC_PAGE_DISK_PENDING),
                    "DBENGINE: PDC reports there are %zu pages to load from disk, "
@@ -904,6 +1061,8 @@ ALWAYS_INLINE_HOT void pg_cache_preload(struct rrdeng_query_handle *handle) {
     handle->pdc->start_time_s = handle->start_time_s;
     handle->pdc->end_time_s = handle->end_time_s;
     handle->pdc->priority = handle->priority;
+    handle->pdc->group_anchor_s = handle->group_anchor_s;
+    handle->pdc->group_every_s = handle->group_every_s;
     handle->pdc->optimal_end_time_s = handle->end_time_s;
     completion_init(&handle->pdc->prep_completion);
     completion_init(&handle->pdc->page_completion);
@@ -932,7 +1091,8 @@ struct pgc_page *pg_cache_lookup_next(
         PDC *pdc,
         time_t now_s,
         uint32_t last_update_every_s,
-        size_t *entries
+        size_t *entries,
+        STORAGE_POINT *summary
 ) {
     if (unlikely(!pdc))
         return NULL;
@@ -944,7 +1104,7 @@ struct pgc_page *pg_cache_lookup_next(
 
     usec_t start_ut = now_monotonic_usec();
     size_t gaps = 0;
-    bool waited = false, preloaded;
+    bool waited = false, preloaded, summarized = false;
     PGC_PAGE *page = NULL;
 
     while(!page) {
@@ -957,6 +1117,21 @@ struct pgc_page *pg_cache_lookup_next(
         if (!pd)
             break;
 
+        if(pdc_page_status_check(pd, PDC_PAGE_SUMMARIZED)) {
+            pdc_page_status_set(pd, PDC_PAGE_PROCESSED);
+
+            if(unlikely(pd->last_time_s < now_s)) {
+                __atomic_add_fetch(&rrdeng_cache_efficiency_stats.pages_past_time_skipped, 1, __ATOMIC_RELAXED);
+                continue;
+            }
+
+            pd_summary_to_storage_point(pd, summary);
+            *entries = pd->summary.entries;
+            summarized = true;
+            __atomic_add_fetch(&rrdeng_cache_efficiency_stats.pages_data_source_summary, 1, __ATOMIC_RELAXED);
+            break;
+        }
+
         page = pd->page;
         page_from_pd = true;
         preloaded = pdc_page_status_check(pd, PDC_PAGE_PRELOADED);
@@ -1040,6 +1215,9 @@ struct pgc_page *pg_cache_lookup_next(
         __atomic_add_fetch(&rrdeng_cache_efficiency_stats.queries_executed_with_gaps, 1, __ATOMIC_RELAXED);
     pdc->executed_with_gaps = +gaps;
 
+    if(summarized)
+        return NULL;
+
     if(page) {
         if(waited)
             __atomic_add_fetch(&rrdeng_cache_efficiency_stats.page_next_wait_loaded, 1, __ATOMIC_RELAXED);
@@ -1077,7 +1255,10 @@ void pgc_open_add_hot_page(
     uint32_t update_every_s,
     struct rrdengine_datafile *datafile,
     uint64_t extent_offset,
-    unsigned extent_size)
+    unsigned extent_size,
+    uint8_t page_type,
+    uint32_t constant_value,
+    struct journal_page_summary *summary)
 {
 
     if(!datafile_acquire(datafile, DATAFILE_ACQUIRE_OPEN_CACHE)) { // for open cache item
@@ -1092,8 +1273,14 @@ void pgc_open_add_hot_page(
             .fileno = datafile->fileno,
             .block = OFFSET_TO_BLOCK(extent_offset),
             .bytes = extent_size,
+            .constant_value = constant_value,
+            .page_type = page_type,
     };
 
+    // pages replayed from journal v1 files do not have summaries
+    if(summary)
+        ext_io_data.summary = *summary;
+
     PGC_ENTRY page_entry = {
             .hot = true,
             .section = section,
@@ -25,6 +25,8 @@ struct page_descr_with_data {
     uint8_t type;
     uint32_t update_every_s;
     uint32_t page_length;
+    uint32_t constant_value;    // for RRDENG_PAGE_TYPE_CONSTANT_32BIT pages
+    struct journal_page_summary summary;
     struct pgd *pgd;
 
     struct {
@@ -43,7 +45,8 @@ struct page_details_control;
 void rrdeng_prep_wait(struct page_details_control *pdc);
 void rrdeng_prep_query(struct page_details_control *pdc, bool worker);
 void pg_cache_preload(struct rrdeng_query_handle *handle);
-struct pgc_page *pg_cache_lookup_next(struct rrdengine_instance *ctx, struct page_details_control *pdc, time_t now_s, uint32_t last_update_every_s, size_t *entries);
+// it returns NULL and fills summary (its count is not zero), when the next page is answered by its summary
+struct pgc_page *pg_cache_lookup_next(struct rrdengine_instance *ctx, struct page_details_control *pdc, time_t now_s, uint32_t last_update_every_s, size_t *entries, STORAGE_POINT *summary);
 void pgc_and_mrg_initialize(void);
 
 void pgc_open_add_hot_page(
@@ -54,6 +57,9 @@ void pgc_open_add_hot_page(
     uint32_t update_every_s,
     struct rrdengine_datafile *datafile,
     uint64_t extent_offset,
-    unsigned extent_size);
+    unsigned extent_size,
+    uint8_t page_type,
+    uint32_t constant_value,
+    struct journal_page_summary *summary);
 
 #endif /* NETDATA_PAGECACHE_H */
@@ -412,7 +412,7 @@ static ALWAYS_INLINE void pdc_destroy(PDC *pdc) {
 
         internal_fatal(pd->datafile.ptr, "DBENGINE: page details has a datafile.ptr that is not released.");
 
-        if(!pd->page && !(status & (PDC_PAGE_READY | PDC_PAGE_FAILED | PDC_PAGE_RELEASED | PDC_PAGE_SKIP | PDC_PAGE_INVALID | PDC_PAGE_CANCELLED))) {
+        if(!pd->page && !(status & (PDC_PAGE_READY | PDC_PAGE_FAILED | PDC_PAGE_RELEASED | PDC_PAGE_SKIP | PDC_PAGE_INVALID | PDC_PAGE_CANCELLED | PDC_PAGE_SUMMARIZED))) {
             // pdc_page_status_set(pd, PDC_PAGE_FAILED);
             unroutable++;
         }
@@ -690,11 +690,19 @@ void collect_page_flags_to_buffer(BUFFER *wb, RRDENG_COLLECT_PAGE_FLAGS flags) {
         buffer_strcat(wb, "STEP_UNALIGNED");
 }
 
+static ALWAYS_INLINE time_t constant_page_end_time_s(const struct rrdeng_extent_page_descr *descr, time_t start_time_s) {
+    if(!descr->constant.entries)
+        return start_time_s;
+
+    return start_time_s + (time_t)(descr->constant.entries - 1) * descr->constant.update_every_s;
+}
+
 ALWAYS_INLINE VALIDATED_PAGE_DESCRIPTOR validate_extent_page_descr(const struct rrdeng_extent_page_descr *descr, time_t now_s, uint32_t overwrite_zero_update_every_s, bool have_read_error) {
     time_t start_time_s = (time_t) (descr->start_time_ut / USEC_PER_SEC);
 
     time_t end_time_s = 0;
     size_t entries = 0;
+    uint32_t update_every_s = 0;
 
     switch (descr->type) {
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
@@ -703,9 +711,15 @@ ALWAYS_INLINE VALIDATED_PAGE_DESCRIPTOR validate_extent_page_descr(const struct
             entries = 0;
             break;
         case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
             end_time_s = start_time_s + descr->gorilla.delta_time_s;
             entries = descr->gorilla.entries;
             break;
+        case RRDENG_PAGE_TYPE_CONSTANT_32BIT:
+            end_time_s = constant_page_end_time_s(descr, start_time_s);
+            entries = descr->constant.entries;
+            update_every_s = descr->constant.update_every_s;
+            break;
         default:
             // Nothing to do. Validate page will notify the user.
             break;
@@ -715,7 +729,7 @@ ALWAYS_INLINE VALIDATED_PAGE_DESCRIPTOR validate_extent_page_descr(const struct
             (nd_uuid_t *)descr->uuid,
             start_time_s,
             end_time_s,
-            0,
+            update_every_s,
             descr->page_length,
             descr->type,
             entries,
@@ -846,9 +860,13 @@ VALIDATED_PAGE_DESCRIPTOR validate_page(
                 entries = vd.entries;
             break;
         case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
             internal_fatal(entries == 0, "0 number of entries found on gorilla page");
             vd.entries = entries;
             break;
+        case RRDENG_PAGE_TYPE_CONSTANT_32BIT:
+            vd.entries = entries;
+            break;
         default:
             known_page_type = false;
             break;
@@ -874,9 +892,13 @@ VALIDATED_PAGE_DESCRIPTOR validate_page(
     // 512 bytes.
     max_page_length += ((page_type == RRDENG_PAGE_TYPE_GORILLA_32BIT) * (2 * RRDENG_GORILLA_32BIT_BUFFER_SIZE));
 
+    // constant pages have no payload
+    bool have_payload = (page_type != RRDENG_PAGE_TYPE_CONSTANT_32BIT);
+
     if (!known_page_type                                        ||
         have_read_error                                         ||
-        vd.page_length == 0                                     ||
+        (vd.page_length == 0) == have_payload                   ||
+        (vd.entries == 0 && !have_payload)                      ||
         vd.page_length > max_page_length                        ||
         vd.start_time_s > vd.end_time_s                         ||
         (now_s && vd.end_time_s > now_s)                        ||
@@ -973,8 +995,12 @@ static void epdl_extent_loading_error_log(struct rrdengine_instance *ctx, EPDL *
                 end_time_s = (time_t)(descr->end_time_ut / USEC_PER_SEC);
                 break;
             case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+            case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
                 end_time_s = (time_t) start_time_s + (descr->gorilla.delta_time_s);
                 break;
+            case RRDENG_PAGE_TYPE_CONSTANT_32BIT:
+                end_time_s = constant_page_end_time_s(descr, start_time_s);
+                break;
         }
         uuid_unparse_lower(descr->uuid, uuid);
         used_descr = true;
@@ -1140,8 +1166,9 @@ static bool epdl_populate_pages_from_extent_data(
     for (i = 0; i < count; i++, page_offset += page_length) {
         page_length = header->descr[i].page_length;
         time_t start_time_s = (time_t) (header->descr[i].start_time_ut / USEC_PER_SEC);
+        bool constant = (header->descr[i].type == RRDENG_PAGE_TYPE_CONSTANT_32BIT);
 
-        if(!page_length || !start_time_s) {
+        if((!page_length && !constant) || !start_time_s) {
             char log[200 + 1];
             snprintfz(log, sizeof(log) - 1, "page %u (out of %u) is EMPTY", i, count);
             epdl_extent_loading_error_log(ctx, epdl, &header->descr[i], log, NDLP_ERR);
@@ -1176,6 +1203,10 @@ static bool epdl_populate_pages_from_extent_data(
             pgd = PGD_EMPTY;
             stats_load_invalid_page++;
         }
+        else if (constant) {
+            // the descriptor has everything, there is nothing in the payload
+            pgd = pgd_create_constant(header->descr[i].constant.value, vd.entries);
+        }
         else {
             if (RRDENG_COMPRESSION_NONE == header->compression_algorithm) {
                 pgd = pgd_create_from_disk_data(header->descr[i].type,
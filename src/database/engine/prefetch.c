@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "prefetch.h"
+
+#define PREFETCH_EVERY_S            10              // how frequently the windows are checked
+#define PREFETCH_TRAILING_SLACK_S   (5 * 60)        // queries ending before now - this, are not dashboard windows
+#define PREFETCH_MAX_WINDOW_S       (7 * 86400)     // wider windows are not prefetched
+#define PREFETCH_MIN_QUERIES        2               // the queries a window needs, to be considered hot
+#define PREFETCH_IDLE_S             60              // prefetch windows that have not been queried for this long
+#define PREFETCH_EXPIRE_S           (30 * 60)       // forget windows that have not been queried for this long
+#define PREFETCH_MAX_WINDOWS        50000           // the max number of windows tracked
+#define PREFETCH_MAX_PER_RUN        1000            // the max number of windows prefetched per run
+#define PREFETCH_PARTITIONS         16              // the concurrent queries of different metrics rarely share a lock
+
+struct prefetch_window {
+    METRIC *metric;                 // acquired
+    struct rrdengine_instance *ctx;
+
+    time_t duration_s;              // the width of the last query of the window
+    time_t last_query_s;            // when the window was last queried
+    time_t prefetched_s;            // when it was last prefetched, 0 = not since its last query
+    uint32_t queries;               // the queries that have seen the window
+    bool pending;                   // the last prefetch loaded pages, the next query will evaluate it
+
+    struct prefetch_window *next;   // to free the windows after we release the lock
+};
+
+static struct {
+    struct {
+        SPINLOCK spinlock;
+        Pvoid_t JudyL;              // struct prefetch_window, by METRIC pointer
+    } index[PREFETCH_PARTITIONS];
+
+    size_t windows;                 // atomic, of all the partitions
+    time_t last_run_s;
+} prefetch_globals = {
+    .windows = 0,
+    .last_run_s = 0,
+};
+
+static inline size_t prefetch_partition(METRIC *metric) {
+    return indexing_partition((Word_t)metric, PREFETCH_PARTITIONS);
+}
+
+void prefetch_init(void) {
+    for(size_t i = 0; i < PREFETCH_PARTITIONS; i++) {
+        spinlock_init(&prefetch_globals.index[i].spinlock);
+        prefetch_globals.index[i].JudyL = NULL;
+    }
+}
+
+static inline bool prefetch_query_is_dashboard(PDC *pdc, time_t now_s) {
+    if(pdc->priority != STORAGE_PRIORITY_HIGH && pdc->priority != STORAGE_PRIORITY_NORMAL)
+        return false;
+
+    if(pdc->end_time_s < now_s - PREFETCH_TRAILING_SLACK_S)
+        return false;
+
+    time_t duration_s = pdc->end_time_s - pdc->start_time_s;
+    return duration_s > 0 && duration_s <= PREFETCH_MAX_WINDOW_S;
+}
+
+static void prefetch_prefetcher_prepared(PDC *pdc) {
+    if(pdc->pages_to_load_from_disk)
+        __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_pages, pdc->pages_to_load_from_disk, __ATOMIC_RELAXED);
+    else
+        __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_not_needed, 1, __ATOMIC_RELAXED);
+
+    size_t partition = prefetch_partition(pdc->metric);
+    spinlock_lock(&prefetch_globals.index[partition].spinlock);
+
+    Pvoid_t *PValue = JudyLGet(prefetch_globals.index[partition].JudyL, (Word_t)pdc->metric, PJE0);
+    if(PValue) {
+        struct prefetch_window *w = *PValue;
+        // when a query arrived while the prefetch was waiting in the queue, prefetched_s has been reset
+        if(w->prefetched_s && pdc->pages_to_load_from_disk)
+            w->pending = true;
+    }
+
+    spinlock_unlock(&prefetch_globals.index[partition].spinlock);
+}
+
+void prefetch_query_prepared(struct page_details_control *pdc) {
+    if(pdc->prefetch) {
+        prefetch_prefetcher_prepared(pdc);
+        return;
+    }
+
+    time_t now_s = now_realtime_sec();
+
+    if(!prefetch_query_is_dashboard(pdc, now_s) || !ctx_is_available_for_queries(pdc->ctx))
+        return;
+
+    size_t partition = prefetch_partition(pdc->metric);
+    spinlock_lock(&prefetch_globals.index[partition].spinlock);
+
+    struct prefetch_window *w;
+    Pvoid_t *PValue = JudyLGet(prefetch_globals.index[partition].JudyL, (Word_t)pdc->metric, PJE0);
+    if(PValue)
+        w = *PValue;
+    else {
+        // the limit is approximate, the partitions may add windows concurrently
+        METRIC *metric = NULL;
+        if(__atomic_load_n(&prefetch_globals.windows, __ATOMIC_RELAXED) >= PREFETCH_MAX_WINDOWS ||
+            !(metric = mrg_metric_dup(main_mrg, pdc->metric))) {
+            spinlock_unlock(&prefetch_globals.index[partition].spinlock);
+            return;
+        }
+
+        PValue = JudyLIns(&prefetch_globals.index[partition].JudyL, (Word_t)pdc->metric, PJE0);
+        if(!PValue || PValue == PJERR)
+            fatal("DBENGINE: corrupted prefetch JudyL array");
+
+        w = callocz(1, sizeof(*w));
+        w->metric = metric;
+        w->ctx = pdc->ctx;
+        *PValue = w;
+        __atomic_add_fetch(&prefetch_globals.windows, 1, __ATOMIC_RELAXED);
+    }
+
+    if(w->pending) {
+        if(pdc->pages_to_load_from_disk)
+            __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_waste, 1, __ATOMIC_RELAXED);
+        else
+            __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_hit, 1, __ATOMIC_RELAXED);
+
+        w->pending = false;
+    }
+
+    w->duration_s = pdc->end_time_s - pdc->start_time_s;
+    w->last_query_s = now_s;
+    w->prefetched_s = 0;
+    w->queries++;
+
+    spinlock_unlock(&prefetch_globals.index[partition].spinlock);
+}
+
+static void prefetch_window(struct rrdengine_instance *ctx, METRIC *metric, time_t duration_s, time_t now_s) {
+    // we own the metric reference we are given
+
+    if(!ctx_is_available_for_queries(ctx)) {
+        mrg_metric_release(main_mrg, metric);
+        return;
+    }
+
+    __atomic_add_fetch(&ctx->atomic.inflight_queries, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&rrdeng_cache_efficiency_stats.currently_running_queries, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_issued, 1, __ATOMIC_RELAXED);
+
+    PDC *pdc = pdc_get();
+    pdc->ctx = ctx;
+    pdc->refcount = 1; // the prep thread, nobody waits for this query
+    spinlock_init(&pdc->refcount_spinlock);
+    pdc->metric = metric;
+    pdc->start_time_s = now_s - duration_s;
+    pdc->end_time_s = now_s;
+    pdc->priority = STORAGE_PRIORITY_BEST_EFFORT;
+    pdc->optimal_end_time_s = now_s;
+    pdc->prefetch = true;
+    completion_init(&pdc->prep_completion);
+    completion_init(&pdc->page_completion);
+
+    rrdeng_enq_cmd(ctx, RRDENG_OPCODE_QUERY, pdc, NULL, STORAGE_PRIORITY_BEST_EFFORT, NULL, NULL);
+}
+
+static void prefetch_window_free(struct prefetch_window *w) {
+    mrg_metric_release(main_mrg, w->metric);
+    freez(w);
+}
+
+void prefetch_run(void) {
+    time_t now_s = now_realtime_sec();
+    if(now_s - prefetch_globals.last_run_s < PREFETCH_EVERY_S)
+        return;
+
+    prefetch_globals.last_run_s = now_s;
+
+    struct {
+        struct rrdengine_instance *ctx;
+        METRIC *metric;
+        time_t duration_s;
+    } *wanted = mallocz(PREFETCH_MAX_PER_RUN * sizeof(*wanted));
+    size_t used = 0;
+
+    struct prefetch_window *expired = NULL;
+    size_t waste = 0;
+
+    for(size_t partition = 0; partition < PREFETCH_PARTITIONS; partition++) {
+        spinlock_lock(&prefetch_globals.index[partition].spinlock);
+
+        Word_t idx = 0;
+        bool first_then_next = true;
+        Pvoid_t *PValue;
+        while((PValue = JudyLFirstThenNext(prefetch_globals.index[partition].JudyL, &idx, &first_then_next))) {
+            struct prefetch_window *w = *PValue;
+
+            if(now_s - w->last_query_s >= PREFETCH_EXPIRE_S || !ctx_is_available_for_queries(w->ctx)) {
+                if(w->pending)
+                    waste++;
+
+                JudyLDel(&prefetch_globals.index[partition].JudyL, idx, PJE0);
+                __atomic_sub_fetch(&prefetch_globals.windows, 1, __ATOMIC_RELAXED);
+
+                w->next = expired;
+                expired = w;
+                continue;
+            }
+
+            if(used < PREFETCH_MAX_PER_RUN &&
+                w->queries >= PREFETCH_MIN_QUERIES &&
+                !w->prefetched_s &&
+                now_s - w->last_query_s >= PREFETCH_IDLE_S &&
+                (wanted[used].metric = mrg_metric_dup(main_mrg, w->metric))) {
+                w->prefetched_s = now_s;
+                wanted[used].ctx = w->ctx;
+                wanted[used].duration_s = w->duration_s;
+                used++;
+            }
+        }
+
+        spinlock_unlock(&prefetch_globals.index[partition].spinlock);
+    }
+
+    if(waste)
+        __atomic_add_fetch(&rrdeng_cache_efficiency_stats.prefetch_waste, waste, __ATOMIC_RELAXED);
+
+    while(expired) {
+        struct prefetch_window *w = expired;
+        expired = w->next;
+        prefetch_window_free(w);
+    }
+
+    for(size_t i = 0; i < used; i++)
+        prefetch_window(wanted[i].ctx, wanted[i].metric, wanted[i].duration_s, now_s);
+
+    freez(wanted);
+}
+
+void prefetch_forget_ctx(struct rrdengine_instance *ctx) {
+    struct prefetch_window *expired = NULL;
+
+    for(size_t partition = 0; partition < PREFETCH_PARTITIONS; partition++) {
+        spinlock_lock(&prefetch_globals.index[partition].spinlock);
+
+        Word_t idx = 0;
+        bool first_then_next = true;
+        Pvoid_t *PValue;
+        while((PValue = JudyLFirstThenNext(prefetch_globals.index[partition].JudyL, &idx, &first_then_next))) {
+            struct prefetch_window *w = *PValue;
+            if(w->ctx != ctx)
+                continue;
+
+            JudyLDel(&prefetch_globals.index[partition].JudyL, idx, PJE0);
+            __atomic_sub_fetch(&prefetch_globals.windows, 1, __ATOMIC_RELAXED);
+
+            w->next = expired;
+            expired = w;
+        }
+
+        spinlock_unlock(&prefetch_globals.index[partition].spinlock);
+    }
+
+    while(expired) {
+        struct prefetch_window *w = expired;
+        expired = w->next;
+        prefetch_window_free(w);
+    }
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DBENGINE_PREFETCH_H
+#define DBENGINE_PREFETCH_H
+
+#include "../engine/rrdengine.h"
+
+// The hot window prefetcher.
+//
+// Dashboards view the same trailing windows of the same metrics again and again.
+// Between refreshes, the pages of these windows may be evicted from the main cache,
+// so the next refresh has to load them from disk again.
+//
+// The prefetcher learns these windows from the dashboard queries (HIGH and NORMAL
+// priority queries ending close to now) and, when a window has been queried a few
+// times but has not been queried for a while, it warms it with a best effort query,
+// so that the pages are in the main cache when the dashboard comes back.
+//
+// Every prefetch that had to load pages from disk is evaluated by the next query of
+// the same window: it is a hit when the query found all its pages in memory,
+// and a waste when the query still had to load pages, or never came.
+
+// called once, when dbengine initializes its structures
+void prefetch_init(void);
+
+// called by rrdeng_prep_query() after the page list of a query is ready
+void prefetch_query_prepared(struct page_details_control *pdc);
+
+// called periodically by the event loop, from a worker
+void prefetch_run(void);
+
+// release all the windows of a tier that is shutting down
+void prefetch_forget_ctx(struct rrdengine_instance *ctx);
+
+#endif // DBENGINE_PREFETCH_H
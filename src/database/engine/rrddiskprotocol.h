@@ -43,7 +43,28 @@ struct rrdeng_df_sb {
 #define RRDENG_PAGE_TYPE_ARRAY_32BIT    (0)
 #define RRDENG_PAGE_TYPE_ARRAY_TIER1    (1)
 #define RRDENG_PAGE_TYPE_GORILLA_32BIT  (2)
-#define RRDENG_PAGE_TYPE_MAX            (2) // Maximum page type (inclusive)
+#define RRDENG_PAGE_TYPE_ADAPTIVE_32BIT (3) // tier0, the encoding is selected per page when it is flushed
+#define RRDENG_PAGE_TYPE_CONSTANT_32BIT (4) // tier0, all points have the same value, the page has no payload
+#define RRDENG_PAGE_TYPE_MAX            (4) // Maximum page type (inclusive)
+
+/*
+ * Adaptive page payload
+ *
+ * Pages of type RRDENG_PAGE_TYPE_ADAPTIVE_32BIT are collected in gorilla buffers.
+ * When they are flushed, they are written as gorilla pages, unless one of
+ * the encodings below is smaller. The page descriptor is the same with gorilla pages.
+ */
+
+#define RRDENG_ADAPTIVE_ENCODING_CONSTANT   (1) // all storage numbers are the same, the payload is one uint32_t
+#define RRDENG_ADAPTIVE_ENCODING_DELTA      (2) // the first storage number as uint32_t, followed by varints of
+                                                // the zigzag delta-of-delta of the rest, shifted left by 1;
+                                                // varints with the lowest bit set are runs of zero delta-of-delta
+
+struct rrdeng_adaptive_page_header {
+    uint8_t encoding;
+    uint8_t reserved[3];
+    uint32_t entries;
+} __attribute__ ((packed));
 
 /*
  * Data file page descriptor
@@ -60,6 +81,14 @@ struct rrdeng_extent_page_descr {
             uint32_t delta_time_s;
         } gorilla  __attribute__((packed));
 
+        // RRDENG_PAGE_TYPE_CONSTANT_32BIT pages have page_length 0,
+        // and they are fully described by this
+        struct {
+            uint32_t value;             // the storage number of all the points
+            uint16_t entries;
+            uint16_t update_every_s;
+        } constant  __attribute__((packed));
+
         uint64_t end_time_ut;
     };
 } __attribute__ ((packed));
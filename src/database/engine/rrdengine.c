@@ -47,6 +47,7 @@ struct rrdeng_main {
     size_t evict_open_running;
     size_t evict_extent_running;
     size_t cleanup_running;
+    size_t prefetch_running;
 
     struct {
         ARAL *ar;
@@ -90,6 +91,7 @@ struct rrdeng_main {
         .flushes_running = 0,
         .evict_main_running = 0,
         .cleanup_running = 0,
+        .prefetch_running = 0,
 
         .cmd_queue = {
                 .unsafe = {
@@ -709,7 +711,10 @@ extent_flush_to_open(struct rrdengine_instance *ctx, struct extent_io_descriptor
                 descr->update_every_s,
                 datafile,
                 xt_io_descr->pos,
-                xt_io_descr->bytes);
+                xt_io_descr->bytes,
+                descr->type,
+                descr->constant_value,
+                &descr->summary);
 
         page_descriptor_release(descr);
     }
@@ -961,9 +966,15 @@ datafile_extent_build(struct rrdengine_instance *ctx, struct page_descr_with_dat
                 header->descr[i].end_time_ut = descr->end_time_ut;
                 break;
             case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+            case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
                 header->descr[i].gorilla.delta_time_s = (uint32_t) ((descr->end_time_ut - descr->start_time_ut) / USEC_PER_SEC);
                 header->descr[i].gorilla.entries = pgd_slots_used(descr->pgd);
                 break;
+            case RRDENG_PAGE_TYPE_CONSTANT_32BIT:
+                header->descr[i].constant.value = descr->constant_value;
+                header->descr[i].constant.entries = (uint16_t) pgd_slots_used(descr->pgd);
+                header->descr[i].constant.update_every_s = (uint16_t) descr->update_every_s;
+                break;
             default:
                 fatal("Unknown page type: %uc", descr->type);
         }
@@ -974,12 +985,15 @@ datafile_extent_build(struct rrdengine_instance *ctx, struct page_descr_with_dat
     // build the extent payload
     for (i = 0 ; i < count ; ++i) {
         descr = xt_io_descr->descr_array[i];
-        pgd_copy_to_extent(descr->pgd, xt_io_descr->buf + pos, descr->page_length);
+        if (descr->type == RRDENG_PAGE_TYPE_CONSTANT_32BIT)
+            pgd_elide_from_extent(descr->pgd);
+        else
+            pgd_copy_to_extent(descr->pgd, xt_io_descr->buf + pos, descr->page_length);
         pos += descr->page_length;
     }
 
-    // compress the payload
-    size_t compressed_size =
+    // compress the payload (it is empty when all the pages are constant)
+    size_t compressed_size = (!uncompressed_payload_length) ? 0 :
         (int)dbengine_compress(xt_io_descr->buf + payload_offset,
                                uncompressed_payload_length,
                                compression_algorithm);
@@ -1807,6 +1821,8 @@ static void after_ctx_shutdown(struct rrdengine_instance *ctx __maybe_unused, vo
 static void *ctx_shutdown_tp_worker(struct rrdengine_instance *ctx __maybe_unused, void *data __maybe_unused, struct completion *completion __maybe_unused, uv_work_t *uv_work_req __maybe_unused) {
     worker_is_busy(UV_EVENT_DBENGINE_SHUTDOWN);
 
+    prefetch_forget_ctx(ctx);
+
     bool logged = false;
     while(__atomic_load_n(&ctx->atomic.extents_currently_being_flushed, __ATOMIC_RELAXED) ||
             __atomic_load_n(&ctx->atomic.inflight_queries, __ATOMIC_RELAXED)) {
@@ -2116,6 +2132,16 @@ static void *cleanup_tp_worker(struct rrdengine_instance *ctx __maybe_unused, vo
     return data;
 }
 
+static void after_prefetch(struct rrdengine_instance *ctx __maybe_unused, void *data __maybe_unused, struct completion *completion __maybe_unused, uv_work_t* req __maybe_unused, int status __maybe_unused) {
+    rrdeng_main.prefetch_running--;
+}
+
+static void *prefetch_tp_worker(struct rrdengine_instance *ctx __maybe_unused, void *data __maybe_unused, struct completion *completion __maybe_unused, uv_work_t *uv_work_req __maybe_unused) {
+    worker_is_busy(UV_EVENT_DBENGINE_PREFETCH);
+    prefetch_run();
+    return data;
+}
+
 uint64_t rrdeng_get_used_disk_space(struct rrdengine_instance *ctx, bool having_lock)
 {
     uint64_t active_space = 0;
@@ -2214,6 +2240,7 @@ static void timer_per_sec_cb(uv_timer_t *handle __maybe_unused)
 
     rrdeng_enq_cmd(NULL, RRDENG_OPCODE_FLUSH_MAIN, NULL, NULL, STORAGE_PRIORITY_INTERNAL_DBENGINE, NULL, NULL);
     rrdeng_enq_cmd(NULL, RRDENG_OPCODE_CLEANUP, NULL, NULL, STORAGE_PRIORITY_INTERNAL_DBENGINE, NULL, NULL);
+    rrdeng_enq_cmd(NULL, RRDENG_OPCODE_PREFETCH, NULL, NULL, STORAGE_PRIORITY_INTERNAL_DBENGINE, NULL, NULL);
 
     worker_is_idle();
 }
@@ -2233,6 +2260,7 @@ static void dbengine_initialize_structures(void) {
     page_descriptors_init();
     extent_buffer_init();
     extent_io_descriptor_init();
+    prefetch_init();
 }
 
 bool rrdeng_dbengine_spawn(struct rrdengine_instance *ctx __maybe_unused) {
@@ -2384,6 +2412,7 @@ void dbengine_event_loop(void* arg) {
     worker_register_job_name(RRDENG_OPCODE_SHUTDOWN_EVLOOP,                          "dbengine shutdown");
     worker_register_job_name(RRDENG_OPCODE_PARALLEL_WEIGHT,                          "parallel weight");
     worker_register_job_name(RRDENG_OPCODE_MRG_LOAD,                                 "mrg tier load");
+    worker_register_job_name(RRDENG_OPCODE_PREFETCH,                                 "prefetch");
 
 
     worker_register_job_name(RRDENG_OPCODE_MAX,                                      "get opcode");
@@ -2400,6 +2429,7 @@ void dbengine_event_loop(void* arg) {
     worker_register_job_name(RRDENG_OPCODE_MAX + RRDENG_OPCODE_CTX_QUIESCE,          "ctx quiesce cb");
     worker_register_job_name(RRDENG_OPCODE_MAX + RRDENG_OPCODE_PARALLEL_WEIGHT,      "parallel weight cb");
     worker_register_job_name(RRDENG_OPCODE_MAX + RRDENG_OPCODE_MRG_LOAD,             "mrg tier load cb");
+    worker_register_job_name(RRDENG_OPCODE_MAX + RRDENG_OPCODE_PREFETCH,             "prefetch cb");
 
     // special jobs
     worker_register_job_name(RRDENG_RETENTION_TIMER_CB,                              "retention timer");
@@ -2519,6 +2549,14 @@ void dbengine_event_loop(void* arg) {
                     break;
                 }
 
+                case RRDENG_OPCODE_PREFETCH: {
+                    if(!rrdeng_main.prefetch_running) {
+                        rrdeng_main.prefetch_running++;
+                        work_dispatch(NULL, NULL, NULL, opcode, prefetch_tp_worker, after_prefetch);
+                    }
+                    break;
+                }
+
                 case RRDENG_OPCODE_JOURNAL_INDEX: {
                     struct rrdengine_instance *ctx = cmd.ctx;
                     struct rrdengine_datafile *datafile = cmd.data;
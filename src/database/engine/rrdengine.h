@@ -19,6 +19,7 @@
 #include "cache.h"
 #include "pdc.h"
 #include "page.h"
+#include "prefetch.h"
 
 #include "daemon/protected-access.h"
 
@@ -102,6 +103,10 @@ typedef enum __attribute__ ((__packed__)) {
     PDC_PAGE_SOURCE_JOURNAL_V2         = (1 << 19),
     PDC_PAGE_PRELOADED_PASS4           = (1 << 20),
 
+    // page summaries
+    PDC_PAGE_SUMMARY_AVAILABLE         = (1 << 21), // pd->summary has the aggregates of the page
+    PDC_PAGE_SUMMARIZED                = (1 << 22), // the query uses pd->summary, the page is not loaded
+
     // datafile acquired
     PDC_PAGE_DATAFILE_ACQUIRED         = (1 << 30),
 } PDC_PAGE_STATUS;
@@ -131,7 +136,15 @@ typedef struct page_details_control {
     time_t end_time_s;
     STORAGE_PRIORITY priority;
 
+    // the groups of the query, (group_anchor_s + N * group_every_s, group_anchor_s + (N + 1) * group_every_s]
+    // pages entirely within a group can be answered by their summaries
+    // when group_every_s is zero, the query needs all the points
+    time_t group_anchor_s;
+    time_t group_every_s;
+
     time_t optimal_end_time_s;
+
+    bool prefetch;                  // a query of the hot window prefetcher, nobody waits for its pages
 } PDC;
 
 PDC *pdc_get(void);
@@ -150,6 +163,8 @@ struct page_details {
     uint32_t update_every_s;
     PDC_PAGE_STATUS status;
 
+    struct journal_page_summary summary;    // when PDC_PAGE_SUMMARY_AVAILABLE is set
+
     struct {
         struct page_details *prev;
         struct page_details *next;
@@ -247,6 +262,10 @@ struct rrdeng_query_handle {
     time_t end_time_s;
     STORAGE_PRIORITY priority;
 
+    // the groups of the query, for using page summaries
+    time_t group_anchor_s;
+    time_t group_every_s;
+
     // internal data
     time_t now_s;
     uint32_t dt_s;
@@ -254,6 +273,10 @@ struct rrdeng_query_handle {
     unsigned position;
     unsigned entries;
 
+    // when there is no page, the point that summarizes it
+    bool summarized;
+    STORAGE_POINT summary;
+
 #ifdef NETDATA_INTERNAL_CHECKS
     usec_t started_time_s;
     pid_t query_pid;
@@ -286,6 +309,7 @@ enum rrdeng_opcode {
     RRDENG_OPCODE_PARALLEL_WEIGHT,
     RRDENG_OPCODE_MRG_LOAD,
     RRDENG_OPCODE_CLEANUP,
+    RRDENG_OPCODE_PREFETCH,
 
     RRDENG_OPCODE_MAX
 };
@@ -304,6 +328,13 @@ struct extent_io_data {
     unsigned fileno;
     uint32_t block;
     unsigned bytes;
+
+    // pages of type RRDENG_PAGE_TYPE_CONSTANT_32BIT are not in the extent
+    uint32_t constant_value;
+    uint8_t page_type;
+
+    // the aggregates of the points of the page (entries is zero when not available)
+    struct journal_page_summary summary;
 };
 
 struct extent_io_descriptor {
@@ -32,14 +32,16 @@ size_t tier_page_size[RRD_STORAGE_TIERS] = {4096, 2048, 384, 384, 384};
 size_t tier_quota_mb[RRD_STORAGE_TIERS] = {1024, 1024, 1024, 128, 64};
 #endif
 
-#if RRDENG_PAGE_TYPE_MAX != 2
-#error PAGE_TYPE_MAX is not 2 - you need to add allocations here
+#if RRDENG_PAGE_TYPE_MAX != 4
+#error PAGE_TYPE_MAX is not 4 - you need to add allocations here
 #endif
 
 size_t page_type_size[256] = {
         [RRDENG_PAGE_TYPE_ARRAY_32BIT] = sizeof(storage_number),
         [RRDENG_PAGE_TYPE_ARRAY_TIER1] = sizeof(storage_number_tier1_t),
-        [RRDENG_PAGE_TYPE_GORILLA_32BIT] = sizeof(storage_number)
+        [RRDENG_PAGE_TYPE_GORILLA_32BIT] = sizeof(storage_number),
+        [RRDENG_PAGE_TYPE_ADAPTIVE_32BIT] = sizeof(storage_number),
+        [RRDENG_PAGE_TYPE_CONSTANT_32BIT] = sizeof(storage_number),
 };
 
 static inline void initialize_single_ctx(struct rrdengine_instance *ctx) {
@@ -484,6 +486,7 @@ static PGD *rrdeng_alloc_new_page_data(struct rrdeng_collect_handle *handle, use
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
         case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_ADAPTIVE_32BIT:
             d = pgd_create(ctx->config.page_type, slots);
             break;
         default:
@@ -766,6 +769,8 @@ ALWAYS_INLINE_HOT void rrdeng_load_metric_init(
     handle->ctx = ctx;
     handle->metric = metric;
     handle->priority = priority;
+    handle->group_anchor_s = seqh->group_anchor_s;
+    handle->group_every_s = seqh->group_every_s;
 
     // IMPORTANT!
     // It is crucial not to exceed the db boundaries, because dbengine
@@ -822,12 +827,27 @@ static ALWAYS_INLINE_HOT bool rrdeng_load_page_next(struct storage_engine_query_
         handle->page = NULL;
         pgdc_reset(&handle->pgdc, NULL, UINT32_MAX);
     }
+    handle->summarized = false;
 
     if (unlikely(handle->now_s > seqh->end_time_s))
         return false;
 
     size_t entries = 0;
-    handle->page = pg_cache_lookup_next(ctx, handle->pdc, handle->now_s, handle->dt_s, &entries);
+    STORAGE_POINT summary = STORAGE_POINT_UNSET;
+    handle->page = pg_cache_lookup_next(ctx, handle->pdc, handle->now_s, handle->dt_s, &entries, &summary);
+
+    if (unlikely(!handle->page && !storage_point_is_unset(summary) && entries)) {
+        // all the points of the page are in the same group of the query,
+        // so we return a single point with their aggregates - its count tells
+        // the query how many points it stands for
+        handle->summarized = true;
+        handle->summary = summary;
+        handle->entries = 1;
+        handle->position = 0;
+        handle->dt_s = (uint32_t)((summary.end_time_s - summary.start_time_s) / (time_t)entries);
+        handle->now_s = summary.end_time_s;
+        return true;
+    }
 
     internal_fatal(handle->page && (pgc_page_data(handle->page) == PGD_EMPTY || !entries),
                    "A page was returned, but it is empty - pg_cache_lookup_next() should be handling this case");
@@ -892,7 +912,7 @@ ALWAYS_INLINE_HOT STORAGE_POINT rrdeng_load_metric_next(struct storage_engine_qu
         goto prepare_for_next_iteration;
     }
 
-    if (unlikely(!handle->page || handle->position >= handle->entries)) {
+    if (unlikely((!handle->page && !handle->summarized) || handle->position >= handle->entries)) {
         // We need to get a new page
 
         if (!rrdeng_load_page_next(seqh, false)) {
@@ -902,6 +922,11 @@ ALWAYS_INLINE_HOT STORAGE_POINT rrdeng_load_metric_next(struct storage_engine_qu
         }
     }
 
+    if (unlikely(handle->summarized)) {
+        sp = handle->summary;
+        goto prepare_for_next_iteration;
+    }
+
     sp.start_time_s = handle->now_s - handle->dt_s;
     sp.end_time_s = handle->now_s;
 
@@ -172,6 +172,8 @@ struct rrdeng_cache_efficiency_stats {
     PAD64(size_t) pages_data_source_main_cache_at_pass4;
     PAD64(size_t) pages_data_source_disk;
     PAD64(size_t) pages_data_source_extent_cache;              // loaded by a cached extent
+    PAD64(size_t) pages_data_source_constant;                  // constant pages recreated from their descriptors
+    PAD64(size_t) pages_data_source_summary;                   // pages answered by their summaries, without loading them
 
     // cache hits at different points
     PAD64(size_t) pages_load_ok_loaded_but_cache_hit_while_inserting; // found in cache while inserting it (conflict)
@@ -213,6 +215,17 @@ struct rrdeng_cache_efficiency_stats {
     PAD64(size_t) pages_invalid_update_every_fixed;
     PAD64(size_t) pages_invalid_entries_fixed;
 
+    // hot window prefetching
+    PAD64(size_t) prefetch_issued;                             // windows prefetched
+    PAD64(size_t) prefetch_not_needed;                         // prefetched windows that were already in memory
+    PAD64(size_t) prefetch_pages;                              // pages prefetched from disk
+    PAD64(size_t) prefetch_hit;                                // prefetches followed by a query that found all its pages in memory
+    PAD64(size_t) prefetch_waste;                              // prefetches followed by a query that loaded pages, or by no query
+
+    // constant pages elided from extents
+    PAD64(size_t) pages_constant_elided;
+    PAD64(size_t) pages_constant_elided_bytes;                 // the payload they would need
+
     // database events
     PAD64(size_t) journal_v2_mapped;
     PAD64(size_t) journal_v2_unmapped;
@@ -96,6 +96,8 @@ static inline uint32_t get_uint32_id() {
 #include "rrdset.h"
 #include "rrddim.h"
 #include "rrddim-backfill.h"
+#include "rrddim-downsampling.h"
+#include "rrdhost-ingestion.h"
 
 #include "streaming/stream-sender-commit.h"
 #include "streaming/stream-replication-tracking.h"
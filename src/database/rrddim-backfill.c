@@ -2,6 +2,7 @@
 
 #include "rrddim-backfill.h"
 #include "database/rrddim-collection.h"
+#include "database/rrddim-downsampling.h"
 
 // ----------------------------------------------------------------------------
 // fill the gap of a tier
@@ -33,9 +34,13 @@ NOT_INLINE_HOT bool backfill_tier_from_smaller_tiers(RRDDIM *rd, size_t tier, ti
 
     stream_control_backfill_query_started();
 
+    // the tiers downsampled in the background get the points of tier 1 only,
+    // the workers add the ones tier 1 has not stored yet, after the backfilling
+    int lowest_read_tier = (rd->downsampling.enabled && tier >= RRDDIM_DOWNSAMPLING_TIER) ? 1 : 0;
+
     // for each lower tier
     struct storage_engine_query_handle seqh;
-    for(int read_tier = (int)tier - 1; read_tier >= 0 ; read_tier--){
+    for(int read_tier = (int)tier - 1; read_tier >= lowest_read_tier ; read_tier--){
         time_t smaller_tier_first_time = storage_engine_oldest_time_s(rd->tiers[read_tier].seb, rd->tiers[read_tier].smh);
         time_t smaller_tier_last_time = storage_engine_latest_time_s(rd->tiers[read_tier].seb, rd->tiers[read_tier].smh);
         if(smaller_tier_last_time <= latest_time_s) continue;  // it is as bad as we are
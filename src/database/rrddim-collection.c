@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "rrddim-collection.h"
+#include "rrddim-downsampling.h"
 
 ALWAYS_INLINE void store_metric_collection_completed() {
     pulse_queries_rrdset_collection_completed(rrdset_done_statistics_points_stored_per_tier);
@@ -14,7 +15,7 @@ static inline time_t tier_next_point_time_s(RRDDIM *rd, struct rrddim_tier *t, t
 #define LAST_COMPLETED_POINT_EXISTS(t) (t->last_completed_point.end_time_s != 0)
 
 ALWAYS_INLINE_HOT
-void store_metric_at_tier_flush_last_completed(RRDDIM *rd __maybe_unused, size_t tier, struct rrddim_tier *t) {
+void store_metric_at_tier_flush_last_completed(RRDDIM *rd, size_t tier, struct rrddim_tier *t) {
     // when there is no end_time_s we do not have a saved last_completed_point
     if(!LAST_COMPLETED_POINT_EXISTS(t)) return;
 
@@ -43,6 +44,9 @@ void store_metric_at_tier_flush_last_completed(RRDDIM *rd __maybe_unused, size_t
 
     rrdset_done_statistics_points_stored_per_tier[tier]++;
 
+    if(unlikely(tier == 1 && rd->downsampling.enabled))
+        rrddim_downsampling_tier1_stored(rd, sp->end_time_s);
+
     // make the point unset
     t->last_completed_point.count = 0;      // make it unset
     t->last_completed_point.end_time_s = 0; // make it not saved
@@ -61,12 +65,14 @@ static void store_metric_at_tier_save_last_completed(RRDDIM *rd, size_t tier, st
 }
 
 ALWAYS_INLINE_HOT
-void store_metric_at_tier(RRDDIM *rd, size_t tier, struct rrddim_tier *t, STORAGE_POINT sp, usec_t now_ut __maybe_unused) {
+static void store_metric_at_tier_internal(RRDDIM *rd, size_t tier, struct rrddim_tier *t, STORAGE_POINT sp, time_t next_point_end_time_s) {
+    // next_point_end_time_s is the end of the tier point sp belongs to, or zero to calculate it
+
     if(LAST_COMPLETED_POINT_EXISTS(t) && sp.start_time_s % t->last_completed_point_flush_modulo == 0)
         store_metric_at_tier_flush_last_completed(rd, tier, t);
 
     if (unlikely(!t->next_point_end_time_s))
-        t->next_point_end_time_s = tier_next_point_time_s(rd, t, sp.end_time_s);
+        t->next_point_end_time_s = next_point_end_time_s ? next_point_end_time_s : tier_next_point_time_s(rd, t, sp.end_time_s);
 
     if(unlikely(sp.start_time_s >= t->next_point_end_time_s)) {
         // flush the virtual point, it is done
@@ -77,7 +83,7 @@ void store_metric_at_tier(RRDDIM *rd, size_t tier, struct rrddim_tier *t, STORAG
             store_metric_at_tier_save_last_completed(rd, tier, t, STORAGE_POINT_UNSET);
 
         t->virtual_point.count = 0; // make the point unset
-        t->next_point_end_time_s = tier_next_point_time_s(rd, t, sp.end_time_s);
+        t->next_point_end_time_s = next_point_end_time_s ? next_point_end_time_s : tier_next_point_time_s(rd, t, sp.end_time_s);
     }
 
     // merge the dates into our virtual point
@@ -107,21 +113,13 @@ void store_metric_at_tier(RRDDIM *rd, size_t tier, struct rrddim_tier *t, STORAG
     }
 }
 
-NOT_INLINE_HOT
-#ifdef NETDATA_LOG_COLLECTION_ERRORS
-void rrddim_store_metric_with_trace(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags, const char *function) {
-#else // !NETDATA_LOG_COLLECTION_ERRORS
-void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags) {
-#endif // !NETDATA_LOG_COLLECTION_ERRORS
-
-    static __thread struct log_stack_entry lgs[] = {
-        [0] = ND_LOG_FIELD_STR(NDF_NIDL_DIMENSION, NULL),
-        [1] = ND_LOG_FIELD_END(),
-    };
-    lgs[0].str = rd->id;
-    log_stack_push(lgs);
+ALWAYS_INLINE_HOT
+void store_metric_at_tier(RRDDIM *rd, size_t tier, struct rrddim_tier *t, STORAGE_POINT sp, usec_t now_ut __maybe_unused) {
+    store_metric_at_tier_internal(rd, tier, t, sp, 0);
+}
 
 #ifdef NETDATA_LOG_COLLECTION_ERRORS
+static void rrddim_store_metric_trace(RRDDIM *rd, usec_t point_end_time_ut, const char *function) {
     rd->rrddim_store_metric_count++;
 
     if(likely(rd->rrddim_store_metric_count > 1)) {
@@ -144,6 +142,25 @@ void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n,
 
     rd->rrddim_store_metric_last_ut = point_end_time_ut;
     rd->rrddim_store_metric_last_caller = function;
+}
+#endif // NETDATA_LOG_COLLECTION_ERRORS
+
+NOT_INLINE_HOT
+#ifdef NETDATA_LOG_COLLECTION_ERRORS
+void rrddim_store_metric_with_trace(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags, const char *function) {
+#else // !NETDATA_LOG_COLLECTION_ERRORS
+void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags) {
+#endif // !NETDATA_LOG_COLLECTION_ERRORS
+
+    static __thread struct log_stack_entry lgs[] = {
+        [0] = ND_LOG_FIELD_STR(NDF_NIDL_DIMENSION, NULL),
+        [1] = ND_LOG_FIELD_END(),
+    };
+    lgs[0].str = rd->id;
+    log_stack_push(lgs);
+
+#ifdef NETDATA_LOG_COLLECTION_ERRORS
+    rrddim_store_metric_trace(rd, point_end_time_ut, function);
 #endif // NETDATA_LOG_COLLECTION_ERRORS
 
     // store the metric on tier 0
@@ -166,17 +183,24 @@ void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n,
         .flags = flags
     };
 
-    for(size_t tier = 1; tier < nd_profile.storage_tiers;tier++) {
+    // with background downsampling, the collectors visit the higher tiers only to backfill them
+    bool backfilled = rrddim_option_check(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+    size_t tiers_inline = rrddim_tiers_aggregated_inline(rd);
+    size_t tiers = backfilled ? tiers_inline : nd_profile.storage_tiers;
+
+    for(size_t tier = 1; tier < tiers;tier++) {
         if(unlikely(!rd->tiers[tier].smh)) continue;
 
         struct rrddim_tier *t = &rd->tiers[tier];
 
-        if(!rrddim_option_check(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS)) {
+        if(!backfilled) {
             // we have not collected this tier before
             // let's fill any gap that may exist
             backfill_tier_from_smaller_tiers(rd, tier, now_s);
         }
 
+        if(unlikely(tier >= tiers_inline)) continue;
+
         store_metric_at_tier(rd, tier, t, sp, point_end_time_ut);
     }
     rrddim_option_set(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
@@ -184,3 +208,94 @@ void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n,
     rrdcontext_collected_rrddim(rd);
     log_stack_pop(&lgs);
 }
+
+// ----------------------------------------------------------------------------
+// chart level commit
+// all the dimensions of a chart are stored for the same timestamp, so the per
+// point overheads are paid once per chart: the log stack, the end of the tier
+// points, the loops over the tiers and the flags of the dimensions
+
+NOT_INLINE_HOT
+void rrdset_store_metrics(RRDSET *st, usec_t point_end_time_ut, RRDDIM_STORE_POINT *points, size_t entries) {
+    if(unlikely(!entries))
+        return;
+
+    static __thread struct log_stack_entry lgs[] = {
+        [0] = ND_LOG_FIELD_STR(NDF_NIDL_DIMENSION, NULL),
+        [1] = ND_LOG_FIELD_END(),
+    };
+    lgs[0].str = NULL;
+    log_stack_push(lgs);
+
+    // store the metrics on tier 0
+    for(size_t i = 0; i < entries ;i++) {
+        RRDDIM_STORE_POINT *p = &points[i];
+        lgs[0].str = p->rd->id;
+
+#ifdef NETDATA_LOG_COLLECTION_ERRORS
+        rrddim_store_metric_trace(p->rd, point_end_time_ut, __FUNCTION__);
+#endif
+
+        storage_engine_store_metric(p->rd->tiers[0].sch, point_end_time_ut,
+                                    p->n, 0, 0,
+                                    1, 0, p->flags);
+    }
+    rrdset_done_statistics_points_stored_per_tier[0] += entries;
+
+    time_t now_s = (time_t)(point_end_time_ut / USEC_PER_SEC);
+    time_t start_s = now_s - st->update_every;
+
+    // aggregate them on the higher tiers, one tier at a time
+    for(size_t tier = 1; tier < nd_profile.storage_tiers;tier++) {
+        // all the dimensions have the same update every and tier grouping,
+        // so the point of this tier they belong to ends at the same time
+        time_t next_point_end_time_s = 0;
+
+        for(size_t i = 0; i < entries ;i++) {
+            RRDDIM_STORE_POINT *p = &points[i];
+            RRDDIM *rd = p->rd;
+            struct rrddim_tier *t = &rd->tiers[tier];
+            if(unlikely(!t->smh)) continue;
+
+            lgs[0].str = rd->id;
+
+            if(unlikely(!rrddim_option_check(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS))) {
+                // we have not collected this tier before
+                // let's fill any gap that may exist
+                backfill_tier_from_smaller_tiers(rd, tier, now_s);
+            }
+
+            // the downsampling workers aggregate tier 1 into this tier
+            if(unlikely(tier >= rrddim_tiers_aggregated_inline(rd))) continue;
+
+            if(unlikely(!next_point_end_time_s))
+                next_point_end_time_s = tier_next_point_time_s(rd, t, now_s);
+
+            STORAGE_POINT sp = {
+                .start_time_s = start_s,
+                .end_time_s = now_s,
+                .min = p->n,
+                .max = p->n,
+                .sum = p->n,
+                .count = 1,
+                .anomaly_count = (p->flags & SN_FLAG_NOT_ANOMALOUS) ? 0 : 1,
+                .flags = p->flags
+            };
+
+            store_metric_at_tier_internal(rd, tier, t, sp, next_point_end_time_s);
+        }
+    }
+
+    for(size_t i = 0; i < entries ;i++) {
+        RRDDIM *rd = points[i].rd;
+
+        if(unlikely(!rrddim_option_check(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS)))
+            rrddim_option_set(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS);
+
+        // it returns immediately when the dimension is already collected
+        if(unlikely(!rd->rrdcontexts.collected))
+            rrdcontext_collected_rrddim(rd);
+    }
+
+    log_stack_pop(&lgs);
+}
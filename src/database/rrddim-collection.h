@@ -17,4 +17,15 @@ void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n,
 
 void store_metric_at_tier_flush_last_completed(RRDDIM *rd, size_t tier, struct rrddim_tier *t);
 
+// the point of a dimension, for storing all the dimensions of a chart at once
+typedef struct rrddim_store_point {
+    RRDDIM *rd;
+    NETDATA_DOUBLE n;
+    SN_FLAGS flags;
+} RRDDIM_STORE_POINT;
+
+// store the points of many dimensions of a chart, all for the same timestamp
+// it is equivalent to calling rrddim_store_metric() for each of them
+void rrdset_store_metrics(RRDSET *st, usec_t point_end_time_ut, RRDDIM_STORE_POINT *points, size_t entries);
+
 #endif //NETDATA_RRDDIM_COLLECTION_H
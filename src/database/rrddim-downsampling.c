@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "rrd.h"
+
+#define WORKER_JOB_DOWNSAMPLE           0
+#define WORKER_JOB_QUEUE_SIZE           1
+
+#define DOWNSAMPLING_MAX_THREADS        8
+
+static struct {
+    SPINLOCK spinlock;                  // protects starting and stopping the workers
+    bool started;
+    bool stop;
+
+    netdata_mutex_t mutex;              // protects the queue
+    netdata_cond_t cond;
+    netdata_cond_t done;                // a dimension has been downsampled
+    RRDDIM *first;
+    RRDDIM *last;
+    size_t queued;
+
+    size_t threads;
+    ND_THREAD **workers;
+} downsampling_globals = {
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+// ----------------------------------------------------------------------------
+// downsampling a dimension
+
+size_t rrddim_downsample_from_tier1(RRDDIM *rd, size_t tiers) {
+    struct rrddim_tier *t1 = &rd->tiers[1];
+    if(unlikely(!t1->smh))
+        return 0;
+
+    time_t after_s = rd->downsampling.after_s ? rd->downsampling.after_s : rd->downsampling.first_s;
+    time_t before_s = storage_engine_latest_time_s(t1->seb, t1->smh);
+    if(!after_s || before_s <= after_s)
+        return 0;
+
+    struct storage_engine_query_handle seqh;
+    storage_engine_query_init(t1->seb, t1->smh, &seqh, after_s, before_s, STORAGE_PRIORITY_LOW);
+
+    size_t points_read = 0;
+    while(!storage_engine_query_is_finished(&seqh)) {
+        STORAGE_POINT sp = storage_engine_query_next_metric(&seqh);
+        if(sp.end_time_s <= after_s)
+            continue;
+
+        for(size_t tier = RRDDIM_DOWNSAMPLING_TIER; tier < tiers; tier++) {
+            struct rrddim_tier *t = &rd->tiers[tier];
+
+            // skip the points the tier got when it was backfilled
+            if(unlikely(!t->smh || sp.end_time_s <= t->virtual_point.end_time_s))
+                continue;
+
+            store_metric_at_tier(rd, tier, t, sp, sp.end_time_s * USEC_PER_SEC);
+        }
+
+        after_s = sp.end_time_s;
+        points_read++;
+    }
+
+    storage_engine_query_finalize(&seqh);
+
+    // the collectors spread the writes of the completed points over time,
+    // but we write a batch at a time anyway, so there is nothing to spread
+    for(size_t tier = RRDDIM_DOWNSAMPLING_TIER; tier < tiers; tier++)
+        store_metric_at_tier_flush_last_completed(rd, tier, &rd->tiers[tier]);
+
+    store_metric_collection_completed();
+
+    rd->downsampling.after_s = after_s;
+    return points_read;
+}
+
+// ----------------------------------------------------------------------------
+// the downsampling workers
+
+static RRDDIM *rrddim_downsampling_get_work(void) {
+    RRDDIM *rd = NULL;
+
+    netdata_mutex_lock(&downsampling_globals.mutex);
+
+    while(!downsampling_globals.first && !__atomic_load_n(&downsampling_globals.stop, __ATOMIC_RELAXED)) {
+        worker_is_idle();
+        netdata_cond_timedwait(&downsampling_globals.cond, &downsampling_globals.mutex, NSEC_PER_SEC);
+    }
+
+    if(downsampling_globals.first) {
+        rd = downsampling_globals.first;
+        downsampling_globals.first = rd->downsampling.next;
+        if(!downsampling_globals.first)
+            downsampling_globals.last = NULL;
+        rd->downsampling.next = NULL;
+        downsampling_globals.queued--;
+    }
+
+    worker_set_metric(WORKER_JOB_QUEUE_SIZE, (NETDATA_DOUBLE)downsampling_globals.queued);
+
+    netdata_mutex_unlock(&downsampling_globals.mutex);
+    return rd;
+}
+
+static void rrddim_downsampling_worker(void *ptr) {
+    (void)ptr;
+
+    worker_register("DOWNSAMPLING");
+    worker_register_job_name(WORKER_JOB_DOWNSAMPLE, "downsample");
+    worker_register_job_custom_metric(WORKER_JOB_QUEUE_SIZE, "downsampling queue size", "dimensions", WORKER_METRIC_ABSOLUTE);
+
+    RRDDIM *rd;
+    while((rd = rrddim_downsampling_get_work())) {
+        worker_is_busy(WORKER_JOB_DOWNSAMPLE);
+        rrddim_downsample_from_tier1(rd, nd_profile.storage_tiers);
+
+        // give the dimension back to its collector, it may be finalized now
+        netdata_mutex_lock(&downsampling_globals.mutex);
+        __atomic_store_n(&rd->downsampling.queued, false, __ATOMIC_RELEASE);
+        netdata_cond_broadcast(&downsampling_globals.done);
+        netdata_mutex_unlock(&downsampling_globals.mutex);
+    }
+
+    worker_unregister();
+}
+
+static bool rrddim_downsampling_start_workers(void) {
+    spinlock_lock(&downsampling_globals.spinlock);
+
+    if(!downsampling_globals.started && !downsampling_globals.stop) {
+        netdata_mutex_init(&downsampling_globals.mutex);
+        netdata_cond_init(&downsampling_globals.cond);
+        netdata_cond_init(&downsampling_globals.done);
+
+        downsampling_globals.threads = FIT_IN_RANGE(netdata_conf_cpus() / 4, 1, DOWNSAMPLING_MAX_THREADS);
+        downsampling_globals.workers = callocz(downsampling_globals.threads, sizeof(ND_THREAD *));
+
+        for(size_t i = 0; i < downsampling_globals.threads; i++) {
+            char tag[NETDATA_THREAD_TAG_MAX + 1];
+            snprintfz(tag, NETDATA_THREAD_TAG_MAX, "DOWNSMPL[%zu]", i);
+            downsampling_globals.workers[i] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DEFAULT, rrddim_downsampling_worker, NULL);
+        }
+
+        downsampling_globals.started = true;
+    }
+
+    bool started = downsampling_globals.started;
+    spinlock_unlock(&downsampling_globals.spinlock);
+
+    return started;
+}
+
+void rrddim_downsampling_stop(void) {
+    spinlock_lock(&downsampling_globals.spinlock);
+
+    if(downsampling_globals.started) {
+        netdata_mutex_lock(&downsampling_globals.mutex);
+        __atomic_store_n(&downsampling_globals.stop, true, __ATOMIC_RELAXED);
+        netdata_cond_broadcast(&downsampling_globals.cond);
+        netdata_mutex_unlock(&downsampling_globals.mutex);
+
+        // the workers exit when the queue is empty
+        for(size_t i = 0; i < downsampling_globals.threads; i++)
+            nd_thread_join(downsampling_globals.workers[i]);
+
+        freez(downsampling_globals.workers);
+        downsampling_globals.workers = NULL;
+        downsampling_globals.threads = 0;
+        downsampling_globals.started = false;
+    }
+    else
+        __atomic_store_n(&downsampling_globals.stop, true, __ATOMIC_RELAXED);
+
+    spinlock_unlock(&downsampling_globals.spinlock);
+}
+
+static void rrddim_downsampling_queue(RRDDIM *rd) {
+    if(unlikely(__atomic_load_n(&downsampling_globals.stop, __ATOMIC_RELAXED)))
+        return;
+
+    if(unlikely(!__atomic_load_n(&downsampling_globals.started, __ATOMIC_ACQUIRE)) && !rrddim_downsampling_start_workers())
+        return;
+
+    // the workers are still downsampling the previous batch
+    if(__atomic_exchange_n(&rd->downsampling.queued, true, __ATOMIC_ACQ_REL))
+        return;
+
+    rd->downsampling.points = 0;
+
+    netdata_mutex_lock(&downsampling_globals.mutex);
+
+    rd->downsampling.next = NULL;
+    if(downsampling_globals.last)
+        downsampling_globals.last->downsampling.next = rd;
+    else
+        downsampling_globals.first = rd;
+    downsampling_globals.last = rd;
+    downsampling_globals.queued++;
+
+    netdata_cond_signal(&downsampling_globals.cond);
+    netdata_mutex_unlock(&downsampling_globals.mutex);
+}
+
+// ----------------------------------------------------------------------------
+// the dimensions
+
+void rrddim_downsampling_init(RRDDIM *rd) {
+    rd->downsampling.enabled =
+        dbengine_tiers_background_downsampling &&
+        nd_profile.storage_tiers > RRDDIM_DOWNSAMPLING_TIER &&
+        rd->tiers[1].smh && rd->tiers[1].sch;
+}
+
+void rrddim_downsampling_tier1_stored(RRDDIM *rd, time_t end_time_s) {
+    if(unlikely(!rd->downsampling.first_s))
+        rd->downsampling.first_s = end_time_s - (time_t)rd->tiers[1].tier_grouping * rd->rrdset->update_every;
+
+    // the collector is backfilling the higher tiers itself, the workers get
+    // the points of tier 1 stored after the backfilling
+    if(unlikely(!rrddim_option_check(rd, RRDDIM_OPTION_BACKFILLED_HIGH_TIERS)))
+        return;
+
+    if(unlikely(++rd->downsampling.points >= RRDDIM_DOWNSAMPLING_BATCH_POINTS))
+        rrddim_downsampling_queue(rd);
+}
+
+void rrddim_downsampling_sync(RRDDIM *rd) {
+    if(!rd->downsampling.enabled)
+        return;
+
+    // only the thread storing tier 1 queues the dimension, and this is it,
+    // so once the batch in progress is done, the workers will not touch it
+    if(__atomic_load_n(&rd->downsampling.queued, __ATOMIC_ACQUIRE)) {
+        // it has been queued, so the workers have been started
+        netdata_mutex_lock(&downsampling_globals.mutex);
+        while(__atomic_load_n(&rd->downsampling.queued, __ATOMIC_ACQUIRE))
+            netdata_cond_wait(&downsampling_globals.done, &downsampling_globals.mutex);
+        netdata_mutex_unlock(&downsampling_globals.mutex);
+    }
+
+    rrddim_downsample_from_tier1(rd, nd_profile.storage_tiers);
+}
+
+void rrddim_downsampling_finalize(RRDDIM *rd) {
+    rrddim_downsampling_sync(rd);
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_RRDDIM_DOWNSAMPLING_H
+#define NETDATA_RRDDIM_DOWNSAMPLING_H
+
+#include "rrddim.h"
+
+// Background downsampling of the higher tiers.
+//
+// Without it, the collectors aggregate every point they store on tier 0 into the
+// virtual points of all the higher tiers of the dimension.
+//
+// With it ([db].dbengine tiers background downsampling = yes), the collectors aggregate
+// only tier 1. Every time a dimension stores a page worth of points on tier 1, it is
+// queued to the downsampling workers, which read these points back from tier 1 and
+// aggregate them into tiers 2 and above, a batch at a time. Tier 1 points carry their
+// sum, min, max, count and anomaly count, so the higher tiers get the same points
+// they would get inline, just later.
+//
+// When the collection of a dimension starts, its collector backfills the higher tiers
+// (tiers 2 and above from tier 1 only), and tier 1 is queued only after that.
+//
+// The workers own the higher tiers of the dimensions. Finalizing the collection of a
+// dimension, or changing its collection frequency, waits for any batch of it in progress
+// and downsamples the last points of tier 1, before the higher tiers are touched.
+
+// the first tier derived from tier 1
+#define RRDDIM_DOWNSAMPLING_TIER 2
+
+// the points of a tier 1 page of dbengine (2 KiB of 16 byte points)
+#define RRDDIM_DOWNSAMPLING_BATCH_POINTS 128
+
+// a new dimension, it decides if its higher tiers will be downsampled in the background
+void rrddim_downsampling_init(RRDDIM *rd);
+
+// the collector of the dimension stored a point on tier 1
+void rrddim_downsampling_tier1_stored(RRDDIM *rd, time_t end_time_s);
+
+// aggregate the tier 1 points not downsampled yet, into the tiers up to (not including) tiers
+// it returns the number of tier 1 points read
+size_t rrddim_downsample_from_tier1(RRDDIM *rd, size_t tiers);
+
+// the thread storing tier 1 needs the higher tiers of the dimension: wait for the batch
+// in progress and bring them up to date - the workers do not touch them until tier 1
+// stores another batch
+void rrddim_downsampling_sync(RRDDIM *rd);
+
+// the collection of the dimension is being finalized, bring its higher tiers up to date
+void rrddim_downsampling_finalize(RRDDIM *rd);
+
+// stop the downsampling workers, at shutdown, after all dimensions have been finalized
+void rrddim_downsampling_stop(void);
+
+// the tiers the collectors aggregate their points into
+#define rrddim_tiers_aggregated_inline(rd) \
+    ((rd)->downsampling.enabled ? (size_t)RRDDIM_DOWNSAMPLING_TIER : nd_profile.storage_tiers)
+
+#endif //NETDATA_RRDDIM_DOWNSAMPLING_H
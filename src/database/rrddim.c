@@ -141,6 +141,8 @@ static void rrddim_insert_callback(const DICTIONARY_ITEM *item __maybe_unused, v
 
         if(!initialized)
             netdata_log_error("Failed to initialize data collection for all db tiers for chart '%s', dimension '%s", rrdset_name(st), rrddim_name(rd));
+
+        rrddim_downsampling_init(rd);
     }
 
     if(rrdset_number_of_dimensions(st) != 0) {
@@ -194,6 +196,10 @@ bool rrddim_finalize_collection_and_check_retention(RRDDIM *rd) {
     size_t tiers_available = 0, tiers_said_no_retention = 0;
 
     for(size_t tier = 0; tier < nd_profile.storage_tiers ;tier++) {
+        // the higher tiers need the last points of tier 1, before they are finalized
+        if(tier == RRDDIM_DOWNSAMPLING_TIER)
+            rrddim_downsampling_finalize(rd);
+
         spinlock_lock(&rd->tiers[tier].spinlock);
 
         if(rd->tiers[tier].sch) {
@@ -369,6 +375,14 @@ RRDDIM *rrddim_acquired_to_rrddim(RRDDIM_ACQUIRED *rda) {
     return (RRDDIM *) dictionary_acquired_item_value((const DICTIONARY_ITEM *)rda);
 }
 
+RRDDIM_ACQUIRED *rrddim_acquired_dup(RRDDIM_ACQUIRED *rda) {
+    if(unlikely(!rda))
+        return NULL;
+
+    RRDDIM *rd = rrddim_acquired_to_rrddim(rda);
+    return (RRDDIM_ACQUIRED *)dictionary_acquired_item_dup(rd->rrdset->rrddim_root_index, (const DICTIONARY_ITEM *)rda);
+}
+
 void rrddim_acquired_release(RRDDIM_ACQUIRED *rda) {
     if(unlikely(!rda))
         return;
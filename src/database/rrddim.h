@@ -82,6 +82,7 @@ struct rrddim {
 
     struct rrdset *rrdset;
     rrd_ml_dimension_t *ml_dimension;               // machine learning data about this dimension
+    uint64_t metadata_hash;                         // the hash of the metadata last saved to sqlite, 0 = unknown
 
     struct {
         RRDMETRIC_ACQUIRED *rrdmetric;              // the rrdmetric of this dimension
@@ -145,6 +146,18 @@ struct rrddim {
         NETDATA_DOUBLE last_stored_value;               // the last value as stored in the database (after interpolation)
     } collector;
 
+    // ------------------------------------------------------------------------
+    // background downsampling of the higher tiers
+
+    struct {
+        bool enabled;                                   // the tiers above 1 are derived from tier 1 in the background
+        bool queued;                                    // queued to the downsampling workers, or being downsampled
+        uint32_t points;                                // the points stored on tier 1, since the last time it was queued
+        time_t first_s;                                 // the start of the first point stored on tier 1
+        time_t after_s;                                 // tier 1 has been downsampled up to this time
+        struct rrddim *next;                            // in the queue of the downsampling workers
+    } downsampling;
+
     // ------------------------------------------------------------------------
 
     struct rrddim_tier tiers[];                         // our tiers of databases
@@ -276,6 +289,7 @@ int rrddim_set_divisor(RRDSET *st, RRDDIM *rd, int32_t divisor);
 RRDDIM *rrddim_find(RRDSET *st, const char *id, bool include_obsolete);
 RRDDIM_ACQUIRED *rrddim_find_and_acquire(RRDSET *st, const char *id, bool include_obsolete);
 RRDDIM *rrddim_acquired_to_rrddim(RRDDIM_ACQUIRED *rda);
+RRDDIM_ACQUIRED *rrddim_acquired_dup(RRDDIM_ACQUIRED *rda);
 void rrddim_acquired_release(RRDDIM_ACQUIRED *rda);
 #define rrddim_find_active(st, id) rrddim_find(st, id, false)
 
@@ -22,6 +22,9 @@ void rrdhost_finalize_collection(RRDHOST *host) {
            "RRD: 'host:%s' stopping data collection...",
            rrdhost_hostname(host));
 
+    // store everything the ingestion pipeline has queued for this host
+    rrdhost_ingestion_wait(host);
+
     RRDSET *st;
     rrdset_foreach_read(st, host)
         rrdset_finalize_collection(st, true);
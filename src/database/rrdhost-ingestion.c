@@ -0,0 +1,449 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "rrd.h"
+
+#define WORKER_JOB_COMMIT               0
+#define WORKER_JOB_RELEASE              1
+#define WORKER_JOB_UPDATE_EVERY         2
+#define WORKER_JOB_RESUME               3
+
+#define INGESTION_BATCHES_PER_TURN      1024        // the batches of a host to commit, before moving to the next host
+#define INGESTION_MAX_THREADS           64
+
+struct rrdhost_ingestion_commit {
+    RRDSET_ACQUIRED *rsa;
+    usec_t point_end_time_ut;
+    time_t update_every_s;              // non-zero: switch the storage engine to this update every
+    bool replayed;
+    uint32_t entries;
+    RRDDIM_ACQUIRED **rda;
+    struct rrdhost_ingestion_commit *next;
+    RRDDIM_STORE_POINT points[];
+};
+
+struct rrdhost_ingestion {
+    RRDHOST *host;
+
+    // the queue - the receiver of the host appends,
+    // only the worker draining the host removes
+    SPINLOCK spinlock;
+    struct rrdhost_ingestion_commit *first;
+    struct rrdhost_ingestion_commit *last;
+    size_t queued;                      // incremented when appended, decremented after being committed
+
+    size_t high_watermark;              // the receiver stops reading its socket at this size
+    size_t low_watermark;               // the workers resume the receiver at this size
+    bool paused;                        // the receiver waits for the workers to resume it
+
+    bool scheduled;                     // in the work list, or being drained by a worker
+    struct rrdhost_ingestion *next;     // in the work list
+};
+
+static struct {
+    SPINLOCK spinlock;                  // protects starting and stopping the workers
+    bool started;
+    bool stop;
+
+    netdata_mutex_t mutex;              // protects the work list
+    netdata_cond_t cond;
+    netdata_cond_t stored;              // broadcast when a worker stores everything queued for a host
+    struct rrdhost_ingestion *first;
+    struct rrdhost_ingestion *last;
+
+    size_t threads;
+    ND_THREAD **workers;
+
+    struct rrdhost_ingestion_statistics stats;
+} ingestion_globals = {
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+// ----------------------------------------------------------------------------
+// the storage workers
+
+// the caller holds the mutex and has set ri->scheduled
+static void rrdhost_ingestion_schedule_locked(struct rrdhost_ingestion *ri) {
+    ri->next = NULL;
+    if(ingestion_globals.last)
+        ingestion_globals.last->next = ri;
+    else
+        ingestion_globals.first = ri;
+    ingestion_globals.last = ri;
+
+    netdata_cond_signal(&ingestion_globals.cond);
+}
+
+static void rrdhost_ingestion_schedule(struct rrdhost_ingestion *ri) {
+    if(__atomic_exchange_n(&ri->scheduled, true, __ATOMIC_SEQ_CST))
+        return;
+
+    netdata_mutex_lock(&ingestion_globals.mutex);
+    rrdhost_ingestion_schedule_locked(ri);
+    netdata_mutex_unlock(&ingestion_globals.mutex);
+}
+
+static struct rrdhost_ingestion *rrdhost_ingestion_get_work(void) {
+    struct rrdhost_ingestion *ri = NULL;
+
+    netdata_mutex_lock(&ingestion_globals.mutex);
+
+    while(!ingestion_globals.first && !__atomic_load_n(&ingestion_globals.stop, __ATOMIC_RELAXED)) {
+        worker_is_idle();
+        netdata_cond_timedwait(&ingestion_globals.cond, &ingestion_globals.mutex, NSEC_PER_SEC);
+    }
+
+    if(ingestion_globals.first) {
+        ri = ingestion_globals.first;
+        ingestion_globals.first = ri->next;
+        if(!ingestion_globals.first)
+            ingestion_globals.last = NULL;
+        ri->next = NULL;
+    }
+
+    netdata_mutex_unlock(&ingestion_globals.mutex);
+    return ri;
+}
+
+static void rrdhost_ingestion_commit(struct rrdhost_ingestion_commit *c) {
+    RRDSET *st = rrdset_acquired_to_rrdset(c->rsa);
+
+    if(unlikely(c->update_every_s)) {
+        worker_is_busy(WORKER_JOB_UPDATE_EVERY);
+        rrdset_store_change_collection_frequency(st, c->update_every_s);
+    }
+    else {
+        worker_is_busy(WORKER_JOB_COMMIT);
+        rrdset_store_metrics(st, c->point_end_time_ut, c->points, c->entries);
+
+        if(!c->replayed) {
+            rrdcontext_collected_rrdset(st);
+            store_metric_collection_completed();
+        }
+
+        __atomic_add_fetch(&ingestion_globals.stats.points, c->entries, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&ingestion_globals.stats.committed, 1, __ATOMIC_RELAXED);
+    }
+
+    worker_is_busy(WORKER_JOB_RELEASE);
+
+    for(size_t i = 0; i < c->entries; i++)
+        rrddim_acquired_release(c->rda[i]);
+
+    // this may be the last reference to a deleted chart, which is finalized now
+    rrdset_acquired_release(c->rsa);
+
+    freez(c);
+}
+
+static void rrdhost_ingestion_resume_receiver(struct rrdhost_ingestion *ri) {
+    if(!__atomic_load_n(&ri->paused, __ATOMIC_SEQ_CST) || !__atomic_exchange_n(&ri->paused, false, __ATOMIC_SEQ_CST))
+        return;
+
+    worker_is_busy(WORKER_JOB_RESUME);
+    __atomic_add_fetch(&ingestion_globals.stats.resumed, 1, __ATOMIC_RELAXED);
+    stream_receiver_ingestion_resume(ri->host);
+}
+
+static void rrdhost_ingestion_drain_some(struct rrdhost_ingestion *ri) {
+    for(size_t i = 0; i < INGESTION_BATCHES_PER_TURN; i++) {
+        spinlock_lock(&ri->spinlock);
+        struct rrdhost_ingestion_commit *c = ri->first;
+        if(c) {
+            ri->first = c->next;
+            if(!ri->first)
+                ri->last = NULL;
+        }
+        spinlock_unlock(&ri->spinlock);
+
+        if(!c)
+            break;
+
+        rrdhost_ingestion_commit(c);
+
+        if(__atomic_sub_fetch(&ri->queued, 1, __ATOMIC_SEQ_CST) <= ri->low_watermark)
+            rrdhost_ingestion_resume_receiver(ri);
+    }
+
+    // unscheduling the host and checking its queue is one step for rrdhost_ingestion_wait(),
+    // which checks them under the mutex - once it sees the host idle, it may free it,
+    // so this is the last time we touch it
+    netdata_mutex_lock(&ingestion_globals.mutex);
+
+    __atomic_store_n(&ri->scheduled, false, __ATOMIC_SEQ_CST);
+
+    if(__atomic_load_n(&ri->queued, __ATOMIC_SEQ_CST)) {
+        // the receiver may have queued more while we were committing,
+        // without scheduling the host, because it was still scheduled
+        if(!__atomic_exchange_n(&ri->scheduled, true, __ATOMIC_SEQ_CST))
+            rrdhost_ingestion_schedule_locked(ri);
+    }
+    else {
+        // wake up anyone waiting for this host to be stored
+        netdata_cond_broadcast(&ingestion_globals.stored);
+    }
+
+    netdata_mutex_unlock(&ingestion_globals.mutex);
+}
+
+static void rrdhost_ingestion_worker(void *ptr __maybe_unused) {
+    worker_register("INGESTION");
+    worker_register_job_name(WORKER_JOB_COMMIT, "commit");
+    worker_register_job_name(WORKER_JOB_RELEASE, "release");
+    worker_register_job_name(WORKER_JOB_UPDATE_EVERY, "update every");
+    worker_register_job_name(WORKER_JOB_RESUME, "resume receiver");
+
+    struct rrdhost_ingestion *ri;
+    while((ri = rrdhost_ingestion_get_work()))
+        rrdhost_ingestion_drain_some(ri);
+
+    worker_unregister();
+}
+
+static void rrdhost_ingestion_start_workers(void) {
+    spinlock_lock(&ingestion_globals.spinlock);
+
+    if(!ingestion_globals.started) {
+        netdata_mutex_init(&ingestion_globals.mutex);
+        netdata_cond_init(&ingestion_globals.cond);
+        netdata_cond_init(&ingestion_globals.stored);
+
+        ingestion_globals.threads = FIT_IN_RANGE(stream_receive.ingestion.threads, 1, INGESTION_MAX_THREADS);
+        ingestion_globals.workers = callocz(ingestion_globals.threads, sizeof(ND_THREAD *));
+
+        for(size_t i = 0; i < ingestion_globals.threads; i++) {
+            char tag[NETDATA_THREAD_TAG_MAX + 1];
+            snprintfz(tag, NETDATA_THREAD_TAG_MAX, "INGEST[%zu]", i);
+            ingestion_globals.workers[i] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DEFAULT, rrdhost_ingestion_worker, NULL);
+        }
+
+        ingestion_globals.started = true;
+    }
+
+    spinlock_unlock(&ingestion_globals.spinlock);
+}
+
+void rrdhost_ingestion_stop(void) {
+    spinlock_lock(&ingestion_globals.spinlock);
+
+    if(ingestion_globals.started) {
+        netdata_mutex_lock(&ingestion_globals.mutex);
+        __atomic_store_n(&ingestion_globals.stop, true, __ATOMIC_RELAXED);
+        netdata_cond_broadcast(&ingestion_globals.cond);
+        netdata_mutex_unlock(&ingestion_globals.mutex);
+
+        // the workers exit when the work list is empty
+        for(size_t i = 0; i < ingestion_globals.threads; i++)
+            nd_thread_join(ingestion_globals.workers[i]);
+
+        freez(ingestion_globals.workers);
+        ingestion_globals.workers = NULL;
+        ingestion_globals.threads = 0;
+        ingestion_globals.started = false;
+    }
+
+    spinlock_unlock(&ingestion_globals.spinlock);
+}
+
+// ----------------------------------------------------------------------------
+// the hosts
+
+void rrdhost_ingestion_attach(RRDHOST *host) {
+    if(!stream_receive.ingestion.enabled || host->ingestion)
+        return;
+
+    rrdhost_ingestion_start_workers();
+
+    struct rrdhost_ingestion *ri = callocz(1, sizeof(*ri));
+    ri->host = host;
+    spinlock_init(&ri->spinlock);
+    ri->high_watermark = stream_receive.ingestion.queue_size;
+    ri->low_watermark = ri->high_watermark / 2;
+
+    __atomic_store_n(&host->ingestion, ri, __ATOMIC_RELEASE);
+}
+
+void rrdhost_ingestion_free(RRDHOST *host) {
+    struct rrdhost_ingestion *ri = host->ingestion;
+    if(!ri) return;
+
+    rrdhost_ingestion_wait(host);
+
+    host->ingestion = NULL;
+    freez(ri);
+}
+
+void rrdhost_ingestion_wait(RRDHOST *host) {
+    struct rrdhost_ingestion *ri = host->ingestion;
+    if(likely(!ri)) return;
+
+    netdata_mutex_lock(&ingestion_globals.mutex);
+
+    if(__atomic_load_n(&ri->queued, __ATOMIC_ACQUIRE) || __atomic_load_n(&ri->scheduled, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&ingestion_globals.stats.waits, 1, __ATOMIC_RELAXED);
+
+        // the worker that commits the last batch of the host broadcasts, after unscheduling it
+        while(__atomic_load_n(&ri->queued, __ATOMIC_ACQUIRE) || __atomic_load_n(&ri->scheduled, __ATOMIC_ACQUIRE))
+            netdata_cond_wait(&ingestion_globals.stored, &ingestion_globals.mutex);
+    }
+
+    netdata_mutex_unlock(&ingestion_globals.mutex);
+}
+
+bool rrdhost_ingestion_congested(RRDHOST *host) {
+    struct rrdhost_ingestion *ri = host->ingestion;
+    if(likely(!ri)) return false;
+
+    return __atomic_load_n(&ri->queued, __ATOMIC_RELAXED) >= ri->high_watermark;
+}
+
+bool rrdhost_ingestion_pause(RRDHOST *host) {
+    struct rrdhost_ingestion *ri = host->ingestion;
+    if(likely(!ri) || __atomic_load_n(&ri->queued, __ATOMIC_RELAXED) < ri->high_watermark)
+        return false;
+
+    __atomic_store_n(&ri->paused, true, __ATOMIC_SEQ_CST);
+
+    // the workers may have drained it below the low watermark before they could see the flag
+    if(__atomic_load_n(&ri->queued, __ATOMIC_SEQ_CST) <= ri->low_watermark &&
+        __atomic_exchange_n(&ri->paused, false, __ATOMIC_SEQ_CST))
+        return false;
+
+    __atomic_add_fetch(&ingestion_globals.stats.backpressure, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// the queue
+
+// the receiver keeps a reference to each chart it collects (released when the chart is unslotted),
+// so that the batches dup it, instead of looking up the chart in the index for each update
+static RRDSET_ACQUIRED *rrdhost_ingestion_acquire_chart(RRDSET *st) {
+    if(unlikely(!st->pluginsd.rsa)) {
+        spinlock_lock(&st->pluginsd.spinlock);
+        if(!st->pluginsd.rsa)
+            st->pluginsd.rsa = rrdset_acquire(st);
+        spinlock_unlock(&st->pluginsd.spinlock);
+    }
+
+    return rrdset_acquired_dup(st->pluginsd.rsa);
+}
+
+static void rrdhost_ingestion_enqueue(struct rrdhost_ingestion *ri, struct rrdhost_ingestion_commit *c) {
+    c->next = NULL;
+
+    spinlock_lock(&ri->spinlock);
+    if(ri->last)
+        ri->last->next = c;
+    else
+        ri->first = c;
+    ri->last = c;
+    __atomic_add_fetch(&ri->queued, 1, __ATOMIC_SEQ_CST);
+    spinlock_unlock(&ri->spinlock);
+
+    rrdhost_ingestion_schedule(ri);
+}
+
+bool rrdhost_ingestion_change_update_every(RRDSET *st, time_t update_every_s) {
+    struct rrdhost_ingestion *ri = st->rrdhost->ingestion;
+    if(likely(!ri) || !__atomic_load_n(&ri->queued, __ATOMIC_SEQ_CST))
+        return false;
+
+    RRDSET_ACQUIRED *rsa = rrdhost_ingestion_acquire_chart(st);
+    if(unlikely(!rsa))
+        return false;
+
+    struct rrdhost_ingestion_commit *c = callocz(1, sizeof(*c));
+    c->rsa = rsa;
+    c->update_every_s = update_every_s;
+    rrdhost_ingestion_enqueue(ri, c);
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// the batches
+
+bool rrdhost_ingestion_batch_begin(RRDHOST_INGESTION_BATCH *b, RRDSET *st, usec_t point_end_time_ut, bool replayed) {
+    internal_fatal(b->rsa || b->used, "INGESTION: a new batch begins while the previous has not been submitted");
+
+    // the batch keeps the chart alive until the worker stores its points
+    b->rsa = rrdhost_ingestion_acquire_chart(st);
+    if(unlikely(!b->rsa))
+        return false;
+
+    b->st = st;
+    b->point_end_time_ut = point_end_time_ut;
+    b->replayed = replayed;
+    return true;
+}
+
+void rrdhost_ingestion_batch_add(RRDHOST_INGESTION_BATCH *b, RRDDIM_ACQUIRED *rda, NETDATA_DOUBLE n, SN_FLAGS flags) {
+    if(unlikely(b->used >= b->size)) {
+        b->size = b->size ? b->size * 2 : 16;
+        b->points = reallocz(b->points, b->size * sizeof(*b->points));
+        b->rda = reallocz(b->rda, b->size * sizeof(*b->rda));
+    }
+
+    b->rda[b->used] = rrddim_acquired_dup(rda);
+    b->points[b->used] = (RRDDIM_STORE_POINT){
+        .rd = rrddim_acquired_to_rrddim(rda),
+        .n = n,
+        .flags = flags,
+    };
+    b->used++;
+}
+
+void rrdhost_ingestion_batch_submit(RRDHOST *host, RRDHOST_INGESTION_BATCH *b) {
+    struct rrdhost_ingestion *ri = host->ingestion;
+    internal_fatal(!ri, "INGESTION: submitting a batch to a host without an ingestion pipeline");
+
+    size_t entries = b->used;
+    struct rrdhost_ingestion_commit *c = mallocz(
+        sizeof(*c) + entries * sizeof(RRDDIM_STORE_POINT) + entries * sizeof(RRDDIM_ACQUIRED *));
+
+    c->rsa = b->rsa;
+    c->point_end_time_ut = b->point_end_time_ut;
+    c->update_every_s = 0;
+    c->replayed = b->replayed;
+    c->entries = entries;
+    c->rda = (RRDDIM_ACQUIRED **)&c->points[entries];
+    memcpy(c->points, b->points, entries * sizeof(RRDDIM_STORE_POINT));
+    memcpy(c->rda, b->rda, entries * sizeof(RRDDIM_ACQUIRED *));
+    b->rsa = NULL;
+    b->st = NULL;
+    b->used = 0;
+
+    // never waits - the stream thread stops reading when the queue is full
+    rrdhost_ingestion_enqueue(ri, c);
+    __atomic_add_fetch(&ingestion_globals.stats.submitted, 1, __ATOMIC_RELAXED);
+}
+
+void rrdhost_ingestion_batch_discard(RRDHOST_INGESTION_BATCH *b) {
+    for(size_t i = 0; i < b->used; i++)
+        rrddim_acquired_release(b->rda[i]);
+
+    rrdset_acquired_release(b->rsa);
+
+    b->rsa = NULL;
+    b->st = NULL;
+    b->used = 0;
+}
+
+void rrdhost_ingestion_batch_cleanup(RRDHOST_INGESTION_BATCH *b) {
+    rrdhost_ingestion_batch_discard(b);
+
+    freez(b->points);
+    freez(b->rda);
+    memset(b, 0, sizeof(*b));
+}
+
+// ----------------------------------------------------------------------------
+
+void rrdhost_ingestion_get_statistics(struct rrdhost_ingestion_statistics *stats) {
+    stats->submitted = __atomic_load_n(&ingestion_globals.stats.submitted, __ATOMIC_RELAXED);
+    stats->committed = __atomic_load_n(&ingestion_globals.stats.committed, __ATOMIC_RELAXED);
+    stats->points = __atomic_load_n(&ingestion_globals.stats.points, __ATOMIC_RELAXED);
+    stats->backpressure = __atomic_load_n(&ingestion_globals.stats.backpressure, __ATOMIC_RELAXED);
+    stats->resumed = __atomic_load_n(&ingestion_globals.stats.resumed, __ATOMIC_RELAXED);
+    stats->waits = __atomic_load_n(&ingestion_globals.stats.waits, __ATOMIC_RELAXED);
+}
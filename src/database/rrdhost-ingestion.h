@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_RRDHOST_INGESTION_H
+#define NETDATA_RRDHOST_INGESTION_H
+
+#include "rrddim-collection.h"
+
+// The ingestion pipeline of the stream receivers.
+//
+// Without it, the stream receivers store the points they receive while parsing,
+// so a slow dbengine page allocation stalls the socket of the child.
+//
+// With it ([db].ingestion pipeline = yes), the receivers that speak BEGIN2/END2 collect
+// the points of each chart update (and of each replayed chart update) in a batch and
+// queue it to the FIFO of the host. Storage workers commit these queues to the database,
+// one host at a time, in the order they were received.
+//
+// Each batch holds an acquired reference to its chart and its dimensions, so charts
+// cannot be deleted and finalized while they have points queued.
+//
+// When the queue of a host reaches its size, the stream thread stops reading from the
+// socket of the child. When the storage workers bring it down to half its size, they
+// send an opcode to the stream thread to resume reading. So the child gets the usual
+// TCP backpressure and buffers the data on its side, and nothing sleeps or spins.
+//
+// Update every changes of charts with points queued are queued too, so that the storage
+// engine switches frequency after storing the points collected with the previous one.
+
+typedef struct rrdhost_ingestion_batch {
+    RRDSET_ACQUIRED *rsa;               // NULL when the points are stored inline
+    RRDSET *st;
+    usec_t point_end_time_ut;
+    bool replayed;                      // the worker only stores the points of replication
+    uint32_t used;
+    uint32_t size;
+    struct rrddim_store_point *points;  // RRDDIM_STORE_POINT, which may not be defined yet when rrd.h includes us
+    RRDDIM_ACQUIRED **rda;              // the dimensions of the points, acquired
+} RRDHOST_INGESTION_BATCH;
+
+struct rrdhost_ingestion_statistics {
+    uint64_t submitted;                 // batches queued
+    uint64_t committed;                 // batches stored
+    uint64_t points;                    // points stored
+    uint64_t backpressure;              // times a receiver stopped reading its socket
+    uint64_t resumed;                   // times the workers resumed a receiver
+    uint64_t waits;                     // times a host had to wait for its queue to be stored
+};
+
+// a receiver connected to this host (does nothing when the pipeline is disabled)
+void rrdhost_ingestion_attach(RRDHOST *host);
+
+// the host is being freed
+void rrdhost_ingestion_free(RRDHOST *host);
+
+// stop the storage workers, at shutdown, after all hosts have been stored
+void rrdhost_ingestion_stop(void);
+
+static inline bool rrdhost_ingestion_pipelined(RRDHOST *host) {
+    return host->ingestion != NULL;
+}
+
+// the producer side, used by the receiver of the host
+bool rrdhost_ingestion_batch_begin(RRDHOST_INGESTION_BATCH *b, RRDSET *st, usec_t point_end_time_ut, bool replayed);
+void rrdhost_ingestion_batch_add(RRDHOST_INGESTION_BATCH *b, RRDDIM_ACQUIRED *rda, NETDATA_DOUBLE n, SN_FLAGS flags);
+void rrdhost_ingestion_batch_submit(RRDHOST *host, RRDHOST_INGESTION_BATCH *b);
+void rrdhost_ingestion_batch_discard(RRDHOST_INGESTION_BATCH *b);
+void rrdhost_ingestion_batch_cleanup(RRDHOST_INGESTION_BATCH *b);
+
+// queue an update every change of the chart after its queued points,
+// returns false when nothing is queued, so the caller has to apply it now
+bool rrdhost_ingestion_change_update_every(RRDSET *st, time_t update_every_s);
+
+// block until the storage workers commit everything queued for the host
+// not for the stream threads - only for host teardown, shutdown and benchmarks
+void rrdhost_ingestion_wait(RRDHOST *host);
+
+// the queue of the host is full - when this returns true, the stream thread stops
+// reading from the socket of the child, and the storage workers will call
+// stream_receiver_ingestion_resume() once they drain it to its low watermark
+bool rrdhost_ingestion_pause(RRDHOST *host);
+
+// the queue of the host is above its size
+bool rrdhost_ingestion_congested(RRDHOST *host);
+
+void rrdhost_ingestion_get_statistics(struct rrdhost_ingestion_statistics *stats);
+
+#endif //NETDATA_RRDHOST_INGESTION_H
@@ -53,4 +53,16 @@ void rrdhost_pluginsd_receive_chart_slots_free(RRDHOST *host) {
     }
 
     spinlock_unlock(&host->stream.rcv.pluginsd_chart_slots.spinlock);
+
+    // the references of the receiver to the charts it collected without slots
+    RRDSET *st;
+    rrdset_foreach_read(st, host) {
+        spinlock_lock(&st->pluginsd.spinlock);
+        RRDSET_ACQUIRED *rsa = st->pluginsd.rsa;
+        st->pluginsd.rsa = NULL;
+        spinlock_unlock(&st->pluginsd.spinlock);
+
+        rrdset_acquired_release(rsa);
+    }
+    rrdset_foreach_done(st);
 }
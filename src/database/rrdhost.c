@@ -773,6 +773,9 @@ bool rrdhost_should_run_health(RRDHOST *host) {
 void rrdhost_cleanup_data_collection_and_health(RRDHOST *host) {
     stream_receiver_signal_to_stop_and_wait(host, STREAM_HANDSHAKE_SND_DISCONNECT_HOST_CLEANUP);
 
+    // the queued batches of the ingestion pipeline reference the charts we are about to destroy
+    rrdhost_ingestion_wait(host);
+
     rrdhost_pluginsd_send_chart_slots_free(host);
     rrdhost_pluginsd_receive_chart_slots_free(host);
 
@@ -810,6 +813,7 @@ static void rrdhost_unlink___while_having_rrd_wrlock(RRDHOST *host) {
 
 static void rrdhost_free_unlinked(RRDHOST *host) {
     rrdhost_cleanup_data_collection_and_health(host);
+    rrdhost_ingestion_free(host);
 
     // ------------------------------------------------------------------------
     // free it
@@ -261,6 +261,8 @@ struct rrdhost {
     struct receiver_state *receiver;
     SPINLOCK receiver_lock;
 
+    struct rrdhost_ingestion *ingestion;            // the ingestion pipeline of the receiver, when enabled
+
     // ------------------------------------------------------------------------
 
     struct aclk_sync_cfg_t *aclk_host_config;
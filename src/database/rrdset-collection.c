@@ -3,6 +3,23 @@
 #include "rrdset-collection.h"
 #include "rrddim-collection.h"
 
+void rrdset_store_change_collection_frequency(RRDSET *st, time_t update_every_s) {
+    RRDDIM *rd;
+    rrddim_foreach_read(rd, st) {
+        // take the higher tiers back from the downsampling workers,
+        // with the points collected at the previous frequency
+        rrddim_downsampling_sync(rd);
+
+        for (size_t tier = 0; tier < nd_profile.storage_tiers; tier++) {
+            if (rd->tiers[tier].sch)
+                storage_engine_store_change_collection_frequency(
+                    rd->tiers[tier].sch,
+                    (int)(st->rrdhost->db[tier].tier_grouping * update_every_s));
+        }
+    }
+    rrddim_foreach_done(rd);
+}
+
 time_t rrdset_set_update_every_s(RRDSET *st, time_t update_every_s) {
     if(unlikely(update_every_s == st->update_every))
         return st->update_every;
@@ -13,17 +30,10 @@ time_t rrdset_set_update_every_s(RRDSET *st, time_t update_every_s) {
     time_t prev_update_every_s = (time_t) st->update_every;
     st->update_every = (int) update_every_s;
 
-    // switch update every to the storage engine
-    RRDDIM *rd;
-    rrddim_foreach_read(rd, st) {
-        for (size_t tier = 0; tier < nd_profile.storage_tiers; tier++) {
-            if (rd->tiers[tier].sch)
-                storage_engine_store_change_collection_frequency(
-                    rd->tiers[tier].sch,
-                    (int)(st->rrdhost->db[tier].tier_grouping * st->update_every));
-        }
-    }
-    rrddim_foreach_done(rd);
+    // switch update every to the storage engine - after the points
+    // of the ingestion pipeline that were collected with the previous one
+    if(!rrdhost_ingestion_change_update_every(st, update_every_s))
+        rrdset_store_change_collection_frequency(st, update_every_s);
 
     return prev_update_every_s;
 }
@@ -39,6 +49,9 @@ void rrdset_finalize_collection(RRDSET *st, bool dimensions_too) {
 
     RRDHOST *host = st->rrdhost;
 
+    // the batches of the ingestion pipeline hold a reference to the chart,
+    // so when this runs from its destructor, all its points have been stored
+
     rrdset_flag_set(st, RRDSET_FLAG_COLLECTION_FINISHED);
 
     if(dimensions_too) {
@@ -279,16 +292,19 @@ struct rda_item {
 };
 
 static __thread struct rda_item *thread_rda = NULL;
+static __thread RRDDIM_STORE_POINT *thread_store_points = NULL; // the points rrdset_done_interpolate() commits per chart
 static __thread size_t thread_rda_entries = 0;
 
 static struct rda_item *rrdset_thread_rda_get(size_t *dimensions) {
 
     if(unlikely(!thread_rda || (*dimensions) > thread_rda_entries)) {
-        size_t old_mem = thread_rda_entries * sizeof(struct rda_item);
+        size_t old_mem = thread_rda_entries * (sizeof(struct rda_item) + sizeof(RRDDIM_STORE_POINT));
         freez(thread_rda);
+        freez(thread_store_points);
         thread_rda_entries = *dimensions;
-        size_t new_mem = thread_rda_entries * sizeof(struct rda_item);
-        thread_rda = mallocz(new_mem);
+        size_t new_mem = thread_rda_entries * (sizeof(struct rda_item) + sizeof(RRDDIM_STORE_POINT));
+        thread_rda = mallocz(thread_rda_entries * sizeof(struct rda_item));
+        thread_store_points = mallocz(thread_rda_entries * sizeof(RRDDIM_STORE_POINT));
 
         __atomic_add_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, new_mem - old_mem, __ATOMIC_RELAXED);
     }
@@ -298,10 +314,12 @@ static struct rda_item *rrdset_thread_rda_get(size_t *dimensions) {
 }
 
 void rrdset_thread_rda_free(void) {
-    __atomic_sub_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, thread_rda_entries * sizeof(struct rda_item), __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, thread_rda_entries * (sizeof(struct rda_item) + sizeof(RRDDIM_STORE_POINT)), __ATOMIC_RELAXED);
 
     freez(thread_rda);
     thread_rda = NULL;
+    freez(thread_store_points);
+    thread_store_points = NULL;
     thread_rda_entries = 0;
 }
 
@@ -349,6 +367,10 @@ static inline size_t rrdset_done_interpolate(
 
         ml_chart_update_begin(st);
 
+        // the points of all the dimensions are stored together, after the loop
+        RRDDIM_STORE_POINT *points = thread_store_points;
+        size_t points_used = 0;
+
         struct rda_item *rda;
         size_t dim_id;
         for(dim_id = 0, rda = rda_base ; dim_id < rda_slots ; ++dim_id, ++rda) {
@@ -441,7 +463,7 @@ static inline size_t rrdset_done_interpolate(
                 if(rsb->wb && rsb->v2)
                     stream_send_rrddim_metrics_v2(rsb, rd, next_store_ut, NAN, SN_FLAG_NONE);
 
-                rrddim_store_metric(rd, next_store_ut, NAN, SN_FLAG_NONE);
+                points[points_used++] = (RRDDIM_STORE_POINT){ .rd = rd, .n = NAN, .flags = SN_FLAG_NONE };
                 continue;
             }
 
@@ -456,7 +478,7 @@ static inline size_t rrdset_done_interpolate(
                 if(rsb->wb && rsb->v2)
                     stream_send_rrddim_metrics_v2(rsb, rd, next_store_ut, new_value, dim_storage_flags);
 
-                rrddim_store_metric(rd, next_store_ut, new_value, dim_storage_flags);
+                points[points_used++] = (RRDDIM_STORE_POINT){ .rd = rd, .n = new_value, .flags = dim_storage_flags };
                 rd->collector.last_stored_value = new_value;
             }
             else {
@@ -467,13 +489,15 @@ static inline size_t rrdset_done_interpolate(
                 if(rsb->wb && rsb->v2)
                     stream_send_rrddim_metrics_v2(rsb, rd, next_store_ut, NAN, SN_FLAG_NONE);
 
-                rrddim_store_metric(rd, next_store_ut, NAN, SN_FLAG_NONE);
+                points[points_used++] = (RRDDIM_STORE_POINT){ .rd = rd, .n = NAN, .flags = SN_FLAG_NONE };
                 rd->collector.last_stored_value = NAN;
             }
 
             stored_entries++;
         }
 
+        rrdset_store_metrics(st, next_store_ut, points, points_used);
+
         ml_chart_update_end(st);
 
         st->counter = ++counter;
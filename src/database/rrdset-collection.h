@@ -17,5 +17,6 @@ void rrdset_done(RRDSET *st);
 
 void rrdset_finalize_collection(RRDSET *st, bool dimensions_too);
 time_t rrdset_set_update_every_s(RRDSET *st, time_t update_every_s);
+void rrdset_store_change_collection_frequency(RRDSET *st, time_t update_every_s);
 
 #endif //NETDATA_RRDSET_COLLECTION_H
@@ -381,6 +381,18 @@ RRDSET_ACQUIRED *rrdset_find_and_acquire(RRDHOST *host, const char *id, bool inc
     return sta;
 }
 
+// acquire a chart we already have a pointer to, returns NULL if it is not indexed anymore
+RRDSET_ACQUIRED *rrdset_acquire(RRDSET *st) {
+    RRDSET_ACQUIRED *rsa = (RRDSET_ACQUIRED *)dictionary_get_and_acquire_item(st->rrdhost->rrdset_root_index, rrdset_id(st));
+    if(unlikely(rsa && dictionary_acquired_item_value((const DICTIONARY_ITEM *)rsa) != st)) {
+        // a different chart with the same id
+        dictionary_acquired_item_release(st->rrdhost->rrdset_root_index, (const DICTIONARY_ITEM *)rsa);
+        return NULL;
+    }
+
+    return rsa;
+}
+
 RRDSET *rrdset_acquired_to_rrdset(RRDSET_ACQUIRED *rsa) {
     if(unlikely(!rsa))
         return NULL;
@@ -388,6 +400,14 @@ RRDSET *rrdset_acquired_to_rrdset(RRDSET_ACQUIRED *rsa) {
     return (RRDSET *) dictionary_acquired_item_value((const DICTIONARY_ITEM *)rsa);
 }
 
+RRDSET_ACQUIRED *rrdset_acquired_dup(RRDSET_ACQUIRED *rsa) {
+    if(unlikely(!rsa))
+        return NULL;
+
+    RRDSET *st = rrdset_acquired_to_rrdset(rsa);
+    return (RRDSET_ACQUIRED *)dictionary_acquired_item_dup(st->rrdhost->rrdset_root_index, (const DICTIONARY_ITEM *)rsa);
+}
+
 void rrdset_acquired_release(RRDSET_ACQUIRED *rsa) {
     if(unlikely(!rsa))
         return;
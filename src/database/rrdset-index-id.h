@@ -69,6 +69,8 @@ RRDSET *rrdset_find(RRDHOST *host, const char *id, bool include_obsolete);
 RRDSET *rrdset_find_bytype(RRDHOST *host, const char *type, const char *id, bool include_obsolete);
 
 RRDSET_ACQUIRED *rrdset_find_and_acquire(RRDHOST *host, const char *id, bool include_obsolete);
+RRDSET_ACQUIRED *rrdset_acquire(RRDSET *st);
+RRDSET_ACQUIRED *rrdset_acquired_dup(RRDSET_ACQUIRED *rsa);
 
 void rrdset_acquired_release(RRDSET_ACQUIRED *rsa);
 RRDSET *rrdset_acquired_to_rrdset(RRDSET_ACQUIRED *rsa);
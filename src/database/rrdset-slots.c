@@ -85,6 +85,7 @@ void rrdset_pluginsd_receive_unslot(RRDSET *st) {
         return;
 
     RRDDIM_ACQUIRED **detached_rdas = NULL;
+    RRDSET_ACQUIRED *detached_rsa = NULL;
     size_t detached_capacity = 0;
     size_t detached_entries = 0;
     bool we_are_collector = false;
@@ -177,6 +178,9 @@ void rrdset_pluginsd_receive_unslot(RRDSET *st) {
         st->pluginsd.last_slot = -1;
         st->pluginsd.dims_with_slots = false;
 
+        detached_rsa = st->pluginsd.rsa;
+        st->pluginsd.rsa = NULL;
+
         spinlock_unlock(&st->pluginsd.spinlock);
         break;
     }
@@ -194,6 +198,8 @@ void rrdset_pluginsd_receive_unslot(RRDSET *st) {
         prd_array_release(arr);
     }
 
+    rrdset_acquired_release(detached_rsa); // safe with NULL
+
     rrdset_clear_host_chart_slot_mapping(st, last_slot);
 }
 
@@ -260,11 +266,17 @@ void rrdset_pluginsd_receive_unslot_and_cleanup(RRDSET *st) {
     st->pluginsd.last_slot = -1;
     st->pluginsd.dims_with_slots = false;
 
+    RRDSET_ACQUIRED *old_rsa = st->pluginsd.rsa;
+    st->pluginsd.rsa = NULL;
+
     spinlock_unlock(&st->pluginsd.spinlock);
 
     // Clear the chart slot mapping using the captured last_slot value
     rrdset_clear_host_chart_slot_mapping(st, last_slot);
 
+    // The receiver's reference to the chart (safe with NULL)
+    rrdset_acquired_release(old_rsa);
+
     // Now handle the old array outside the lock
     if (old_arr) {
         // After prd_array_replace, we hold the only reference (refcount should be 1).
@@ -302,6 +314,7 @@ void rrdset_pluginsd_receive_slots_initialize(RRDSET *st) {
     spinlock_init(&st->pluginsd.spinlock);
     st->pluginsd.last_slot = -1;
     st->pluginsd.prd_array = NULL;  // Explicitly initialize to NULL
+    st->pluginsd.rsa = NULL;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
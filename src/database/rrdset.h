@@ -152,6 +152,7 @@ struct rrdset {
     struct timeval last_collected_time;             // when did this data set last collected values
 
     size_t rrdlabels_last_saved_version;
+    uint64_t metadata_hash;                         // the hash of the metadata last saved to sqlite, 0 = unknown
 
     DICTIONARY *functions_view;                     // collector functions this rrdset supports, can be NULL
 
@@ -219,6 +220,7 @@ struct rrdset {
         uint32_t pos;
         int32_t last_slot;
         struct pluginsd_rrddim_array *prd_array;  // Reference-counted array (use prd_array_* functions)
+        RRDSET_ACQUIRED *rsa;                      // the receiver's reference, dup'ed for each ingestion batch
     } pluginsd;
 
 #ifdef NETDATA_LOG_REPLICATION_REQUESTS
@@ -173,20 +173,32 @@ sqlite3 *db_meta = NULL;
 
 #define SQL_STORE_CHART                                                                                                \
     "INSERT INTO chart (chart_id, host_id, type, id, name, family, context, title, unit, plugin, module, priority, "   \
-    "update_every, chart_type, memory_mode, history_entries) "                                                         \
-    "values (@chart_id, @host_id, @type, @id, @name, @family, @context, @title, @unit, @plugin, @module, @priority, "  \
-    "@update_every, @chart_type, @memory_mode, @history_entries) "                                                     \
-    "ON CONFLICT(chart_id) DO UPDATE SET type=excluded.type, id=excluded.id, name=excluded.name, "                     \
+    "update_every, chart_type, memory_mode, history_entries) VALUES "
+
+#define SQL_STORE_CHART_ROW "(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+
+#define SQL_STORE_CHART_CONFLICT                                                                                       \
+    " ON CONFLICT(chart_id) DO UPDATE SET type=excluded.type, id=excluded.id, name=excluded.name, "                    \
     "family=excluded.family, context=excluded.context, title=excluded.title, unit=excluded.unit, "                     \
     "plugin=excluded.plugin, module=excluded.module, priority=excluded.priority, update_every=excluded.update_every, " \
     "chart_type=excluded.chart_type, memory_mode = excluded.memory_mode, history_entries = excluded.history_entries"
 
 #define SQL_STORE_DIMENSION                                                                                            \
-    "INSERT INTO dimension (dim_id, chart_id, id, name, multiplier, divisor , algorithm, options) "                    \
-    "VALUES (@dim_id, @chart_id, @id, @name, @multiplier, @divisor, @algorithm, @options) "                            \
-    "ON CONFLICT(dim_id) DO UPDATE SET id=excluded.id, name=excluded.name, multiplier=excluded.multiplier, "           \
+    "INSERT INTO dimension (dim_id, chart_id, id, name, multiplier, divisor , algorithm, options) VALUES "
+
+#define SQL_STORE_DIMENSION_ROW "(?, ?, ?, ?, ?, ?, ?, ?)"
+
+#define SQL_STORE_DIMENSION_CONFLICT                                                                                   \
+    " ON CONFLICT(dim_id) DO UPDATE SET id=excluded.id, name=excluded.name, multiplier=excluded.multiplier, "          \
     "divisor=excluded.divisor, algorithm=excluded.algorithm, options=excluded.options"
 
+#define SQL_SELECT_CHART_METADATA                                                                                      \
+    "SELECT host_id, type, id, name, family, context, title, unit, plugin, module, priority, update_every, "           \
+    "chart_type, memory_mode, history_entries FROM chart WHERE chart_id = @chart_id"
+
+#define SQL_SELECT_DIMENSION_METADATA                                                                                  \
+    "SELECT chart_id, id, name, multiplier, divisor, algorithm, options FROM dimension WHERE dim_id = @dim_id"
+
 #define SELECT_DIMENSION_LIST "SELECT dim_id, rowid FROM dimension WHERE rowid > @row_id"
 #define SELECT_CHART_LIST "SELECT chart_id, rowid FROM chart WHERE rowid > @row_id"
 #define SELECT_CHART_LABEL_LIST "SELECT chart_id, rowid FROM chart_label WHERE rowid > @row_id"
@@ -1037,6 +1049,16 @@ done:
     return rc != SQLITE_DONE;
 }
 
+// bumped whenever rows of the chart and dimension tables are deleted (deleting the last
+// dimension of a chart deletes the chart too) - it is part of the metadata hashes, so the
+// hashes remembered before a deletion stop matching and the next update writes the row again
+static uint32_t metadata_deletions_epoch = 0;
+
+static inline void metadata_rows_deleted(void)
+{
+    __atomic_add_fetch(&metadata_deletions_epoch, 1, __ATOMIC_RELAXED);
+}
+
 #define SQL_DELETE_DIMENSION_BY_ID   "DELETE FROM dimension WHERE rowid = @dimension_row AND dim_id = @uuid"
 
 static void delete_dimension_by_rowid(sqlite3_stmt **res, int64_t dimension_id, nd_uuid_t *dim_uuid)
@@ -1054,6 +1076,8 @@ static void delete_dimension_by_rowid(sqlite3_stmt **res, int64_t dimension_id,
     int rc = sqlite3_step_monitored(*res);
     if (unlikely(rc != SQLITE_DONE))
         error_report("Failed to delete dimension id, rc = %d", rc);
+    else
+        metadata_rows_deleted();
 
 done:
     REPORT_BIND_FAIL(*res, param);
@@ -1078,6 +1102,8 @@ static void delete_dimension_uuid(nd_uuid_t *dimension_uuid, sqlite3_stmt **acti
     rc = sqlite3_step_monitored(res);
     if (unlikely(rc != SQLITE_DONE))
         error_report("Failed to delete dimension uuid, rc = %d", rc);
+    else
+        metadata_rows_deleted();
 
 done:
     REPORT_BIND_FAIL(res, param);
@@ -1167,85 +1193,494 @@ static bool store_host_systeminfo(RRDHOST *host)
 }
 
 
-/*
- * Store a chart in the database
- */
+// ----------------------------------------------------------------------------
+// Batched writer of chart and dimension metadata
+//
+// Charts and dimensions are written with multi-row INSERT statements, in as few
+// transactions per cycle as possible. Each chart and dimension remembers a hash
+// of the metadata last persisted, so rows that have not changed are skipped.
+// When the hash is not known (e.g. after a restart), it is computed once from
+// the row already in the database. Deleting rows invalidates all the hashes.
+//
+// Each host is committed on its own, and large hosts every few thousand rows,
+// so that the other writers of the database do not wait for the whole cycle.
+
+#define METADATA_CHART_BATCH_SIZE (128)             // 16 parameters per chart
+#define METADATA_DIMENSION_BATCH_SIZE (256)         // 8 parameters per dimension
+#define METADATA_TRANSACTION_MAX_ROWS (4096)        // commit at least that often, to keep the locks short
+
+struct metadata_batch_entry {
+    const DICTIONARY_ITEM *item;                    // keeps the chart or dimension referenced until the batch is stored
+    void *ptr;                                      // RRDSET or RRDDIM
+    uint64_t hash;                                  // the hash of the metadata we write
+};
+
+struct metadata_writer {
+    sqlite3_stmt *select_chart;
+    sqlite3_stmt *select_dimension;
+    sqlite3_stmt *store_charts;                     // prepared for a full batch of charts
+    sqlite3_stmt *store_dimensions;                 // prepared for a full batch of dimensions
+    BUFFER *sql;
+
+    bool in_transaction;
+    size_t rows_in_transaction;
+
+    struct {
+        DICTIONARY *dict;
+        size_t count;
+        struct metadata_batch_entry entries[METADATA_CHART_BATCH_SIZE];
+    } charts;
+
+    struct {
+        size_t count;
+        struct {
+            DICTIONARY *dict;
+            const DICTIONARY_ITEM *chart_item;      // the chart of the dimension
+        } owners[METADATA_DIMENSION_BATCH_SIZE];
+        struct metadata_batch_entry entries[METADATA_DIMENSION_BATCH_SIZE];
+    } dimensions;
+
+    size_t written;
+    size_t skipped;
+    size_t failed;
+};
+
+static inline void metadata_hash_text(XXH3_state_t *state, const char *s)
+{
+    if (!s)
+        s = "";
+
+    // include the terminator, so that consecutive fields cannot be confused
+    XXH3_64bits_update(state, s, strlen(s) + 1);
+}
 
-static int store_chart_metadata(RRDSET *st, sqlite3_stmt **res)
+static inline void metadata_hash_int(XXH3_state_t *state, int64_t v)
+{
+    XXH3_64bits_update(state, &v, sizeof(v));
+}
+
+static inline uint64_t metadata_hash_final(XXH3_state_t *state)
+{
+    // the hashes remembered before a deletion of rows do not match any more
+    metadata_hash_int(state, __atomic_load_n(&metadata_deletions_epoch, __ATOMIC_RELAXED));
+
+    uint64_t hash = XXH3_64bits_digest(state);
+
+    // zero means that we don't know what is in the database
+    return hash ? hash : 1;
+}
+
+static uint64_t chart_metadata_hash(RRDSET *st)
+{
+    XXH3_state_t state;
+    XXH3_64bits_reset(&state);
+
+    XXH3_64bits_update(&state, &st->rrdhost->host_id.uuid, sizeof(st->rrdhost->host_id.uuid));
+    metadata_hash_text(&state, string2str(st->parts.type));
+    metadata_hash_text(&state, string2str(st->parts.id));
+    metadata_hash_text(&state, string2str(st->parts.name));
+    metadata_hash_text(&state, rrdset_family(st));
+    metadata_hash_text(&state, rrdset_context(st));
+    metadata_hash_text(&state, rrdset_title(st));
+    metadata_hash_text(&state, rrdset_units(st));
+    metadata_hash_text(&state, rrdset_plugin_name(st));
+    metadata_hash_text(&state, rrdset_module_name(st));
+    metadata_hash_int(&state, (int)st->priority);
+    metadata_hash_int(&state, st->update_every);
+    metadata_hash_int(&state, st->chart_type);
+    metadata_hash_int(&state, st->rrd_memory_mode);
+    metadata_hash_int(&state, (int)st->db.entries);
+
+    return metadata_hash_final(&state);
+}
+
+static uint64_t dimension_metadata_hash(RRDDIM *rd)
+{
+    XXH3_state_t state;
+    XXH3_64bits_reset(&state);
+
+    XXH3_64bits_update(&state, &rd->rrdset->chart_uuid, sizeof(rd->rrdset->chart_uuid));
+    metadata_hash_text(&state, string2str(rd->id));
+    metadata_hash_text(&state, string2str(rd->name));
+    metadata_hash_int(&state, (int)rd->multiplier);
+    metadata_hash_int(&state, (int)rd->divisor);
+    metadata_hash_int(&state, rd->algorithm);
+    metadata_hash_text(&state, rrddim_option_check(rd, RRDDIM_OPTION_HIDDEN) ? "hidden" : NULL);
+
+    return metadata_hash_final(&state);
+}
+
+// compute the hash of a row already in the database, using the same fields
+// returns 0 when the row is not there
+static uint64_t metadata_hash_from_db(sqlite3_stmt **res, const char *sql, nd_uuid_t *uuid, const char *types)
 {
     if (!*res) {
-        if (!PREPARE_STATEMENT(db_meta, SQL_STORE_CHART, res))
-            return 1;
+        if (!PREPARE_STATEMENT(db_meta, sql, res))
+            return 0;
     }
 
-    int rc = 1;
+    uint64_t hash = 0;
     int param = 0;
-    SQLITE_BIND_FAIL(done, sqlite3_bind_blob(*res, ++param, &st->chart_uuid, sizeof(st->chart_uuid), SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_blob(*res, ++param, &st->rrdhost->host_id.uuid, sizeof(st->rrdhost->host_id.uuid), SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, string2str(st->parts.type), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, string2str(st->parts.id), -1, SQLITE_STATIC));
-
-    const char *name = string2str(st->parts.name);
-    if (name && *name)
-        SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, name, -1, SQLITE_STATIC));
-    else
-        SQLITE_BIND_FAIL(done, sqlite3_bind_null(*res, ++param));
-
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_family(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_context(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_title(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_units(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_plugin_name(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, rrdset_module_name(st), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, (int) st->priority));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, st->update_every));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, st->chart_type));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, st->rrd_memory_mode));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, (int) st->db.entries));
+    SQLITE_BIND_FAIL(done, sqlite3_bind_blob(*res, ++param, uuid, sizeof(*uuid), SQLITE_STATIC));
 
     param = 0;
-    rc = sqlite3_step_monitored(*res);
-    if (unlikely(rc != SQLITE_DONE))
-        error_report("Failed to store chart, rc = %d", rc);
+    if (sqlite3_step_monitored(*res) == SQLITE_ROW) {
+        XXH3_state_t state;
+        XXH3_64bits_reset(&state);
+
+        for (int i = 0; types[i]; i++) {
+            switch (types[i]) {
+                case 'b':
+                    XXH3_64bits_update(&state, sqlite3_column_blob(*res, i), sqlite3_column_bytes(*res, i));
+                    break;
+
+                case 'i':
+                    metadata_hash_int(&state, sqlite3_column_int(*res, i));
+                    break;
+
+                default:
+                    metadata_hash_text(&state, (const char *)sqlite3_column_text(*res, i));
+                    break;
+            }
+        }
+
+        hash = metadata_hash_final(&state);
+    }
 
 done:
     REPORT_BIND_FAIL(*res, param);
     SQLITE_RESET(*res);
-    return rc != SQLITE_DONE;
+    return hash;
 }
 
-static bool store_dimension_metadata(RRDDIM *rd, sqlite3_stmt **res)
+static void metadata_writer_begin(struct metadata_writer *mw)
 {
-    if (!*res) {
-        if (!PREPARE_STATEMENT(db_meta, SQL_STORE_DIMENSION, res))
-            return 1;
+    if (mw->in_transaction)
+        return;
+
+    (void)db_execute(db_meta, "BEGIN TRANSACTION", NULL);
+    mw->in_transaction = true;
+    mw->rows_in_transaction = 0;
+}
+
+static void metadata_writer_commit(struct metadata_writer *mw)
+{
+    if (!mw->in_transaction)
+        return;
+
+    (void)db_execute(db_meta, "COMMIT TRANSACTION", NULL);
+    mw->in_transaction = false;
+    mw->rows_in_transaction = 0;
+}
+
+static sqlite3_stmt *metadata_writer_prepare(
+    struct metadata_writer *mw,
+    sqlite3_stmt **cached,
+    size_t count,
+    size_t batch_size,
+    const char *insert,
+    const char *row,
+    const char *conflict)
+{
+    if (count == batch_size && *cached)
+        return *cached;
+
+    buffer_flush(mw->sql);
+    buffer_strcat(mw->sql, insert);
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0)
+            buffer_strcat(mw->sql, ", ");
+        buffer_strcat(mw->sql, row);
     }
+    buffer_strcat(mw->sql, conflict);
 
-    int rc = 1;
-    int param = 0;
+    sqlite3_stmt *stmt = NULL;
+    if (!PREPARE_STATEMENT(db_meta, buffer_tostring(mw->sql), &stmt))
+        return NULL;
+
+    // full batches are frequent, keep their statement for the whole cycle
+    if (count == batch_size)
+        *cached = stmt;
+
+    return stmt;
+}
+
+static void metadata_writer_done_stmt(sqlite3_stmt **cached, sqlite3_stmt *stmt)
+{
+    if (stmt == *cached)
+        SQLITE_RESET(stmt);
+    else
+        SQLITE_FINALIZE(stmt);
+}
+
+static int bind_chart_metadata(sqlite3_stmt *res, int *param, RRDSET *st)
+{
+    int rc;
+    if ((rc = sqlite3_bind_blob(res, ++(*param), &st->chart_uuid, sizeof(st->chart_uuid), SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_blob(res, ++(*param), &st->rrdhost->host_id.uuid, sizeof(st->rrdhost->host_id.uuid), SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), string2str(st->parts.type), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), string2str(st->parts.id), -1, SQLITE_STATIC)) != SQLITE_OK)
+        return rc;
+
+    const char *name = string2str(st->parts.name);
+    if (name && *name)
+        rc = sqlite3_bind_text(res, ++(*param), name, -1, SQLITE_STATIC);
+    else
+        rc = sqlite3_bind_null(res, ++(*param));
+
+    if (rc != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_family(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_context(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_title(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_units(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_plugin_name(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), rrdset_module_name(st), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), (int) st->priority)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), st->update_every)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), st->chart_type)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), st->rrd_memory_mode)) != SQLITE_OK)
+        return rc;
 
+    return sqlite3_bind_int(res, ++(*param), (int) st->db.entries);
+}
+
+static int bind_dimension_metadata(sqlite3_stmt *res, int *param, RRDDIM *rd)
+{
+    int rc;
     nd_uuid_t *rd_uuid = uuidmap_uuid_ptr(rd->uuid);
-    SQLITE_BIND_FAIL(done, sqlite3_bind_blob(*res, ++param, rd_uuid, sizeof(*rd_uuid), SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_blob(*res, ++param, &rd->rrdset->chart_uuid, sizeof(rd->rrdset->chart_uuid), SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, string2str(rd->id), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, string2str(rd->name), -1, SQLITE_STATIC));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, (int) rd->multiplier));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, (int ) rd->divisor));
-    SQLITE_BIND_FAIL(done, sqlite3_bind_int(*res, ++param, rd->algorithm));
+    if ((rc = sqlite3_bind_blob(res, ++(*param), rd_uuid, sizeof(*rd_uuid), SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_blob(res, ++(*param), &rd->rrdset->chart_uuid, sizeof(rd->rrdset->chart_uuid), SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), string2str(rd->id), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_text(res, ++(*param), string2str(rd->name), -1, SQLITE_STATIC)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), (int) rd->multiplier)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), (int ) rd->divisor)) != SQLITE_OK ||
+        (rc = sqlite3_bind_int(res, ++(*param), rd->algorithm)) != SQLITE_OK)
+        return rc;
+
     if (rrddim_option_check(rd, RRDDIM_OPTION_HIDDEN))
-        SQLITE_BIND_FAIL(done, sqlite3_bind_text(*res, ++param, "hidden", -1, SQLITE_STATIC));
+        return sqlite3_bind_text(res, ++(*param), "hidden", -1, SQLITE_STATIC);
+
+    return sqlite3_bind_null(res, ++(*param));
+}
+
+// store the pending charts, returns true on success
+static bool metadata_writer_flush_charts(struct metadata_writer *mw)
+{
+    size_t count = mw->charts.count;
+    if (!count)
+        return true;
+
+    metadata_writer_begin(mw);
+
+    bool ok = false;
+    int param = 0;
+    sqlite3_stmt *res = metadata_writer_prepare(
+        mw, &mw->store_charts, count, METADATA_CHART_BATCH_SIZE, SQL_STORE_CHART, SQL_STORE_CHART_ROW, SQL_STORE_CHART_CONFLICT);
+
+    if (res) {
+        for (size_t i = 0; i < count; i++)
+            SQLITE_BIND_FAIL(done, bind_chart_metadata(res, &param, mw->charts.entries[i].ptr));
+
+        param = 0;
+        int rc = sqlite3_step_monitored(res);
+        if (unlikely(rc != SQLITE_DONE))
+            error_report("Failed to store a batch of %zu charts, rc = %d", count, rc);
+        else
+            ok = true;
+
+    done:
+        REPORT_BIND_FAIL(res, param);
+        metadata_writer_done_stmt(&mw->store_charts, res);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        struct metadata_batch_entry *e = &mw->charts.entries[i];
+        RRDSET *st = e->ptr;
+
+        if (likely(ok))
+            st->metadata_hash = e->hash;
+        else {
+            // retry on the next cycle
+            rrdset_flag_set(st, RRDSET_FLAG_METADATA_UPDATE);
+            error_report(
+                "METADATA: 'host:%s': Failed to store metadata for chart %s", rrdhost_hostname(st->rrdhost), rrdset_name(st));
+        }
+
+        dictionary_acquired_item_release(mw->charts.dict, e->item);
+    }
+
+    if (likely(ok)) {
+        mw->written += count;
+        mw->rows_in_transaction += count;
+    }
     else
-        SQLITE_BIND_FAIL(done, sqlite3_bind_null(*res, ++param));
+        mw->failed += count;
 
-    param = 0;
-    rc = sqlite3_step_monitored(*res);
-    if (unlikely(rc != SQLITE_DONE))
-        error_report("Failed to store dimension, rc = %d", rc);
+    mw->charts.count = 0;
 
-done:
-    REPORT_BIND_FAIL(*res, param);
-    SQLITE_RESET(*res);
-    return (rc != SQLITE_DONE);
+    if (mw->rows_in_transaction >= METADATA_TRANSACTION_MAX_ROWS)
+        metadata_writer_commit(mw);
+
+    return ok;
+}
+
+// store the pending dimensions, returns true on success
+static bool metadata_writer_flush_dimensions(struct metadata_writer *mw)
+{
+    size_t count = mw->dimensions.count;
+    if (!count)
+        return true;
+
+    // the charts of these dimensions may still be pending, they have to be there first
+    metadata_writer_flush_charts(mw);
+
+    metadata_writer_begin(mw);
+
+    bool ok = false;
+    int param = 0;
+    sqlite3_stmt *res = metadata_writer_prepare(
+        mw, &mw->store_dimensions, count, METADATA_DIMENSION_BATCH_SIZE,
+        SQL_STORE_DIMENSION, SQL_STORE_DIMENSION_ROW, SQL_STORE_DIMENSION_CONFLICT);
+
+    if (res) {
+        for (size_t i = 0; i < count; i++)
+            SQLITE_BIND_FAIL(done, bind_dimension_metadata(res, &param, mw->dimensions.entries[i].ptr));
+
+        param = 0;
+        int rc = sqlite3_step_monitored(res);
+        if (unlikely(rc != SQLITE_DONE))
+            error_report("Failed to store a batch of %zu dimensions, rc = %d", count, rc);
+        else
+            ok = true;
+
+    done:
+        REPORT_BIND_FAIL(res, param);
+        metadata_writer_done_stmt(&mw->store_dimensions, res);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        struct metadata_batch_entry *e = &mw->dimensions.entries[i];
+        RRDDIM *rd = e->ptr;
+
+        if (likely(ok))
+            rd->metadata_hash = e->hash;
+        else {
+            // retry on the next cycle
+            rrddim_flag_set(rd, RRDDIM_FLAG_METADATA_UPDATE);
+            error_report(
+                "METADATA: 'host:%s': Failed to store dimension metadata for chart %s. dimension %s",
+                rrdhost_hostname(rd->rrdset->rrdhost),
+                rrdset_name(rd->rrdset),
+                rrddim_name(rd));
+        }
+
+        RRDSET *st = rd->rrdset;
+        dictionary_acquired_item_release(mw->dimensions.owners[i].dict, e->item);
+        dictionary_acquired_item_release(st->rrdhost->rrdset_root_index, mw->dimensions.owners[i].chart_item);
+    }
+
+    if (likely(ok)) {
+        mw->written += count;
+        mw->rows_in_transaction += count;
+    }
+    else
+        mw->failed += count;
+
+    mw->dimensions.count = 0;
+
+    if (mw->rows_in_transaction >= METADATA_TRANSACTION_MAX_ROWS)
+        metadata_writer_commit(mw);
+
+    return ok;
+}
+
+// store everything pending and commit it, returns true on success
+static bool metadata_writer_flush(struct metadata_writer *mw)
+{
+    bool ok = metadata_writer_flush_charts(mw);
+    ok = metadata_writer_flush_dimensions(mw) && ok;
+    metadata_writer_commit(mw);
+    return ok;
+}
+
+// queue a chart for storage, unless its metadata are already in the database
+// returns false when the chart has been skipped
+static bool metadata_writer_add_chart(struct metadata_writer *mw, RRDSET *st, const DICTIONARY_ITEM *item)
+{
+    uint64_t hash = chart_metadata_hash(st);
+
+    if (!st->metadata_hash)
+        st->metadata_hash = metadata_hash_from_db(
+            &mw->select_chart, SQL_SELECT_CHART_METADATA, &st->chart_uuid, "btttttttttiiiii");
+
+    if (st->metadata_hash == hash) {
+        mw->skipped++;
+        return false;
+    }
+
+    DICTIONARY *dict = st->rrdhost->rrdset_root_index;
+    if (mw->charts.count && mw->charts.dict != dict)
+        metadata_writer_flush_charts(mw);
+
+    mw->charts.dict = dict;
+    struct metadata_batch_entry *e = &mw->charts.entries[mw->charts.count++];
+    e->item = dictionary_acquired_item_dup(dict, item);
+    e->ptr = st;
+    e->hash = hash;
+
+    if (mw->charts.count == METADATA_CHART_BATCH_SIZE)
+        metadata_writer_flush_charts(mw);
+
+    return true;
+}
+
+// queue a dimension for storage, unless its metadata are already in the database
+// returns false when the dimension has been skipped
+static bool metadata_writer_add_dimension(struct metadata_writer *mw, RRDDIM *rd, const DICTIONARY_ITEM *item, const DICTIONARY_ITEM *chart_item)
+{
+    uint64_t hash = dimension_metadata_hash(rd);
+
+    if (!rd->metadata_hash)
+        rd->metadata_hash = metadata_hash_from_db(
+            &mw->select_dimension, SQL_SELECT_DIMENSION_METADATA, uuidmap_uuid_ptr(rd->uuid), "bttiiit");
+
+    if (rd->metadata_hash == hash) {
+        mw->skipped++;
+        return false;
+    }
+
+    RRDSET *st = rd->rrdset;
+    size_t slot = mw->dimensions.count++;
+    mw->dimensions.owners[slot].dict = st->rrddim_root_index;
+    mw->dimensions.owners[slot].chart_item = dictionary_acquired_item_dup(st->rrdhost->rrdset_root_index, chart_item);
+
+    struct metadata_batch_entry *e = &mw->dimensions.entries[slot];
+    e->item = dictionary_acquired_item_dup(st->rrddim_root_index, item);
+    e->ptr = rd;
+    e->hash = hash;
+
+    if (mw->dimensions.count == METADATA_DIMENSION_BATCH_SIZE)
+        metadata_writer_flush_dimensions(mw);
+
+    return true;
+}
+
+static void metadata_writer_init(struct metadata_writer *mw, BUFFER *sql)
+{
+    memset(mw, 0, sizeof(*mw));
+    mw->sql = sql;
+}
+
+static void metadata_writer_finalize(struct metadata_writer *mw)
+{
+    metadata_writer_flush(mw);
+
+    SQLITE_FINALIZE(mw->select_chart);
+    SQLITE_FINALIZE(mw->select_dimension);
+    SQLITE_FINALIZE(mw->store_charts);
+    SQLITE_FINALIZE(mw->store_dimensions);
+
+    pulse_sqlite3_metadata_rows(mw->written, mw->skipped);
 }
 
 static bool dimension_can_be_deleted(nd_uuid_t *dim_uuid __maybe_unused, sqlite3_stmt **res __maybe_unused, bool flag __maybe_unused)
@@ -1389,6 +1824,8 @@ static void delete_chart_uuid(nd_uuid_t *chart_uuid, sqlite3_stmt **action_res,
     rc = sqlite3_step_monitored(res);
     if (unlikely(rc != SQLITE_DONE))
         error_report("Failed to delete a chart uuid from the %s table, rc = %d", label_only ? "labels" : "chart", rc);
+    else if (!label_only)
+        metadata_rows_deleted();
 
 skip:
     if (action_res)
@@ -2173,20 +2610,17 @@ size_t populate_metrics_from_database(void *mrg, void (*populate_cb)(void *mrg,
 }
 #endif
 
-static void metadata_scan_host(struct meta_config_s *config, RRDHOST *host, bool is_worker, BUFFER *work_buffer)
+static void metadata_scan_host(struct meta_config_s *config, RRDHOST *host, bool is_worker, BUFFER *work_buffer, struct metadata_writer *mw)
 {
     static bool skip_models = false;
     RRDSET *st;
     int rc;
 
     sqlite3_stmt *ml_load_stmt = NULL;
-    sqlite3_stmt *store_dimension = NULL;
-    sqlite3_stmt *store_chart = NULL;
 
     bool load_ml_models = is_worker;
 
-    bool host_need_recheck = false;
-    (void)db_execute(db_meta, "BEGIN TRANSACTION", NULL);
+    size_t failed = mw->failed;
 
     rrdset_foreach_reentrant(st, host) {
 
@@ -2200,19 +2634,14 @@ static void metadata_scan_host(struct meta_config_s *config, RRDHOST *host, bool
             if (is_worker)
                 worker_is_busy(UV_EVENT_STORE_CHART);
 
+            metadata_writer_begin(mw);
+
             rc = check_and_update_chart_labels(st, work_buffer);
             if (unlikely(rc))
                 error_report("METADATA: 'host:%s': Failed to update labels for chart %s", rrdhost_hostname(host), rrdset_name(st));
 
-            rc = store_chart_metadata(st, &store_chart);
-            if (unlikely(rc)) {
-                host_need_recheck = true;
-                rrdset_flag_set(st, RRDSET_FLAG_METADATA_UPDATE);
-                error_report(
-                    "METADATA: 'host:%s': Failed to store metadata for chart %s",
-                    rrdhost_hostname(host),
-                    rrdset_name(st));
-            }
+            metadata_writer_add_chart(mw, st, st_dfe.item);
+
             if (is_worker)
                 worker_is_idle();
         }
@@ -2247,16 +2676,7 @@ static void metadata_scan_host(struct meta_config_s *config, RRDHOST *host, bool
             if (is_worker)
                 worker_is_busy(UV_EVENT_STORE_DIMENSION);
 
-            rc = store_dimension_metadata(rd, &store_dimension);
-            if (unlikely(rc)) {
-                host_need_recheck = true;
-                rrddim_flag_set(rd, RRDDIM_FLAG_METADATA_UPDATE);
-                error_report(
-                    "METADATA: 'host:%s': Failed to store dimension metadata for chart %s. dimension %s",
-                    rrdhost_hostname(host),
-                    rrdset_name(st),
-                    rrddim_name(rd));
-            }
+            metadata_writer_add_dimension(mw, rd, rd_dfe.item, st_dfe.item);
 
             if (is_worker)
                 worker_is_idle();
@@ -2265,13 +2685,13 @@ static void metadata_scan_host(struct meta_config_s *config, RRDHOST *host, bool
     }
     rrdset_foreach_done(st);
 
-    (void)db_execute(db_meta, "COMMIT TRANSACTION", NULL);
-    if (host_need_recheck)
+    // the batches keep references to the charts of this host, store and commit them now
+    metadata_writer_flush(mw);
+
+    if (mw->failed != failed)
         rrdhost_flag_set(host,RRDHOST_FLAG_METADATA_UPDATE);
 
     SQLITE_FINALIZE(ml_load_stmt);
-    SQLITE_FINALIZE(store_dimension);
-    SQLITE_FINALIZE(store_chart);
 }
 
 
@@ -2538,6 +2958,11 @@ static void store_hosts_metadata(struct meta_config_s *config, bool is_worker)
     // Reusable buffer for building SQL statements
     BUFFER *work_buffer = buffer_create(1024, NULL);
 
+    // all the charts and dimensions of this cycle are written in batches,
+    // in one transaction per host (or per METADATA_TRANSACTION_MAX_ROWS rows)
+    struct metadata_writer *mw = mallocz(sizeof(*mw));
+    metadata_writer_init(mw, buffer_create(1024, NULL));
+
     size_t count = 0;
     dfe_start_reentrant(rrdhost_root_index, host)
     {
@@ -2559,13 +2984,19 @@ static void store_hosts_metadata(struct meta_config_s *config, bool is_worker)
         if (is_worker)
             worker_is_idle();
 
-        metadata_scan_host(config, host, is_worker, work_buffer);
+        metadata_scan_host(config, host, is_worker, work_buffer, mw);
 
         if (!is_worker)
             nd_log_daemon(NDLP_INFO, "METADATA: Progress of metadata storage: %6.2f%% completed", (100.0 * count / host_count));
     }
     dfe_done(host);
 
+    metadata_writer_finalize(mw);
+    nd_log_daemon(NDLP_DEBUG, "METADATA: Stored %zu chart and dimension rows, skipped %zu unchanged, %zu failed",
+                  mw->written, mw->skipped, mw->failed);
+    buffer_free(mw->sql);
+    freez(mw);
+
     buffer_free(work_buffer);
 
     if (!is_worker) {
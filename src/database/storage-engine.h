@@ -39,6 +39,13 @@ struct storage_engine_query_handle {
     time_t start_time_s;
     time_t end_time_s;
     STORAGE_PRIORITY priority;
+
+    // the query groups its points in (group_anchor_s + N * group_every_s, group_anchor_s + (N + 1) * group_every_s]
+    // so the storage engine may return a single point for all the points it has in a group
+    // zero group_every_s when the query needs all the points
+    time_t group_anchor_s;
+    time_t group_every_s;
+
     STORAGE_ENGINE_BACKEND seb;
     STORAGE_QUERY_HANDLE *handle;
 };
@@ -367,12 +374,16 @@ void rrddim_query_init(
     time_t start_time_s, time_t end_time_s, STORAGE_PRIORITY priority);
 
 ALWAYS_INLINE_HOT_FLATTEN
-static void storage_engine_query_init(
+static void storage_engine_query_init_grouped(
     STORAGE_ENGINE_BACKEND seb __maybe_unused,
     STORAGE_METRIC_HANDLE *smh, struct storage_engine_query_handle *seqh,
-    time_t start_time_s, time_t end_time_s, STORAGE_PRIORITY priority) {
+    time_t start_time_s, time_t end_time_s, STORAGE_PRIORITY priority,
+    time_t group_anchor_s, time_t group_every_s) {
     internal_fatal(!is_valid_backend(seb), "STORAGE: invalid backend");
 
+    seqh->group_anchor_s = group_anchor_s;
+    seqh->group_every_s = group_every_s;
+
 #ifdef ENABLE_DBENGINE
     if(likely(seb == STORAGE_ENGINE_BACKEND_DBENGINE))
         rrdeng_load_metric_init(smh, seqh, start_time_s, end_time_s, priority);
@@ -381,6 +392,14 @@ static void storage_engine_query_init(
         rrddim_query_init(smh, seqh, start_time_s, end_time_s, priority);
 }
 
+ALWAYS_INLINE_HOT_FLATTEN
+static void storage_engine_query_init(
+    STORAGE_ENGINE_BACKEND seb __maybe_unused,
+    STORAGE_METRIC_HANDLE *smh, struct storage_engine_query_handle *seqh,
+    time_t start_time_s, time_t end_time_s, STORAGE_PRIORITY priority) {
+    storage_engine_query_init_grouped(seb, smh, seqh, start_time_s, end_time_s, priority, 0, 0);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 STORAGE_POINT rrdeng_load_metric_next(struct storage_engine_query_handle *seqh);
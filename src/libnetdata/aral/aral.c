@@ -28,6 +28,12 @@
 
 #define ARAL_PAGE_INCOMING_PARTITIONS 4 // up to 32 (32-bits bitmap)
 
+// the per-thread magazines, the caches of free elements in front of the pages
+#define ARAL_MAGAZINES_PER_THREAD 16        // the ARALs each thread caches elements for
+#define ARAL_MAGAZINE_MAX_ELEMENTS 32       // the max elements of a magazine
+#define ARAL_MAGAZINE_MAX_BYTES (64ULL * 1024) // the max memory of a magazine, larger elements get fewer slots
+#define ARAL_MAGAZINE_PUBLISH_OPS 1024      // add the fast path operations to the ARAL counters this often
+
 typedef struct aral_free {
     size_t size;
     struct aral_free *next;
@@ -137,6 +143,13 @@ struct aral {
 
     struct aral_ops ops[2];
 
+    struct {
+        uint64_t id;                    // unique and never reused, it identifies the magazines of this ARAL
+        uint32_t size;                  // the max elements of each per-thread magazine, 0 = disabled
+        uint32_t epoch;                 // atomic, advances when pages are added, to make the magazines give back
+        struct aral_magazine *list;     // the magazines of all threads, under aral_magazines_globals.spinlock
+    } magazines;
+
     struct aral_statistics *stats;
 };
 
@@ -802,6 +815,9 @@ retry_acquisition:
         }
 
         if(can_add) {
+            // we are short of free elements, ask the per-thread magazines to give back some
+            __atomic_add_fetch(&ar->magazines.epoch, 1, __ATOMIC_RELAXED);
+
             page = aral_create_page___no_lock_needed(ar, page_allocation_size TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
             page->aral_lock.marked = page->started_marked = marked;
 
@@ -976,6 +992,257 @@ static inline void aral_add_free_slot___no_lock_required(ARAL *ar, ARAL_PAGE *pa
     }
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// per-thread magazines
+//
+// Each thread keeps a small cache (a magazine) of free elements for each ARAL it frees elements to.
+// Freeing an unmarked element pushes it to the magazine of the calling thread, and allocating an
+// unmarked element pops one from there, without touching any lock or shared cacheline.
+//
+// The elements in the magazines are still reserved on their pages (they are accounted as used),
+// so the pages cannot be freed under them. This makes cross-thread frees safe: the element goes
+// to the magazine of the thread freeing it, and is given back to its own page when that magazine
+// is full (half of it is given back), when the ARAL adds pages (the epoch of the ARAL advances
+// and each magazine gives back half its elements on its next free), or when the thread exits.
+// When all the magazines of a thread are used by other ARALs, the thread uses the pages directly.
+//
+// Threads created by nd_thread_create() release their magazines when they exit. All the other
+// threads are registered to a pthread key when they attach their first magazine, and its
+// destructor releases them.
+//
+// Each ARAL has a unique id, never reused. The magazines are matched to ARALs by id, and
+// aral_destroy() invalidates the magazines of all threads for the ARAL, so that a new ARAL
+// allocated at the same address will never find the elements of the old one.
+
+typedef struct aral_cached {
+    ARAL_PAGE *page;
+    struct aral_cached *next;
+} ARAL_CACHED;
+
+struct aral_magazine {
+    uint64_t id;                        // atomic, the id of the ARAL, 0 when unused or the ARAL has been destroyed
+    ARAL *ar;
+    ARAL_CACHED *list;
+    uint32_t count;
+    uint32_t epoch;                     // the epoch of the ARAL the last time we gave back elements
+
+    size_t malloc_ops;                  // fast path operations, not added to the ARAL counters yet
+    size_t free_ops;
+
+    struct aral_magazine *prev;         // the magazines of the ARAL, under aral_magazines_globals.spinlock
+    struct aral_magazine *next;
+};
+
+static struct {
+    SPINLOCK spinlock;                  // protects the magazine lists of all ARALs
+    uint64_t last_id;
+
+    bool key_created;
+    pthread_key_t key;                  // its destructor releases the magazines of exiting threads
+} aral_magazines_globals = {
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static __thread struct aral_magazine aral_thread_magazines[ARAL_MAGAZINES_PER_THREAD] = { 0 };
+static __thread bool aral_thread_magazines_registered = false;
+
+#ifdef NETDATA_TRACE_ALLOCATIONS
+#define ARAL_MAGAZINE_TRACE_PARAMS , __FILE__, __FUNCTION__, __LINE__
+#else
+#define ARAL_MAGAZINE_TRACE_PARAMS
+#endif
+
+static void aral_free_claimed_slot(ARAL *ar, ARAL_PAGE *page, void *ptr, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS);
+
+static size_t aral_magazine_size(ARAL *ar) {
+#ifdef NETDATA_TRACE_ALLOCATIONS
+    // every allocation has to be traced
+    return 0;
+#endif
+
+    // single threaded users have nothing to gain
+    if(ar->config.options & ARAL_LOCKLESS)
+        return 0;
+
+    // the cached elements keep their page pointer (zero, as freed) after the element
+    if(ar->config.element_size < sizeof(ARAL_CACHED) + sizeof(uintptr_t))
+        return 0;
+
+    return MIN(ARAL_MAGAZINE_MAX_ELEMENTS, ARAL_MAGAZINE_MAX_BYTES / ar->config.element_size);
+}
+
+static ALWAYS_INLINE void aral_magazine_publish_ops(ARAL *ar, struct aral_magazine *m) {
+    if(m->malloc_ops) {
+        __atomic_add_fetch(&ar->atomic.user_malloc_operations, m->malloc_ops, __ATOMIC_RELAXED);
+        m->malloc_ops = 0;
+    }
+
+    if(m->free_ops) {
+        __atomic_add_fetch(&ar->atomic.user_free_operations, m->free_ops, __ATOMIC_RELAXED);
+        m->free_ops = 0;
+    }
+}
+
+// give back to their pages the first elements of the magazine
+// the ARAL must be alive: either we are using it, or we hold aral_magazines_globals.spinlock
+static void aral_magazine_give_back(ARAL *ar, struct aral_magazine *m, size_t elements) {
+    aral_magazine_publish_ops(ar, m);
+
+    while(elements-- && m->list) {
+        ARAL_CACHED *c = m->list;
+        m->list = c->next;
+        m->count--;
+
+        aral_free_claimed_slot(ar, c->page, c, false ARAL_MAGAZINE_TRACE_PARAMS);
+    }
+}
+
+// give back all the elements of the magazine and detach it from its ARAL
+static void aral_magazine_release(struct aral_magazine *m) {
+    spinlock_lock(&aral_magazines_globals.spinlock);
+
+    // while we hold the lock, the ARAL cannot be destroyed
+    if(__atomic_load_n(&m->id, __ATOMIC_ACQUIRE)) {
+        ARAL *ar = m->ar;
+        DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(ar->magazines.list, m, prev, next);
+        aral_magazine_give_back(ar, m, m->count);
+        __atomic_store_n(&m->id, 0, __ATOMIC_RELEASE);
+    }
+
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+}
+
+static void aral_thread_magazines_destructor(void *ptr __maybe_unused) {
+    aral_thread_magazines_release();
+
+    // other destructors may free elements after us, they will register the thread again
+    aral_thread_magazines_registered = false;
+}
+
+// make sure the magazines of this thread will be released when it exits
+static bool aral_thread_magazines_register(void) {
+    if(likely(aral_thread_magazines_registered))
+        return true;
+
+    spinlock_lock(&aral_magazines_globals.spinlock);
+    if(!aral_magazines_globals.key_created &&
+        pthread_key_create(&aral_magazines_globals.key, aral_thread_magazines_destructor) == 0)
+        aral_magazines_globals.key_created = true;
+    bool created = aral_magazines_globals.key_created;
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+
+    // the value only has to be non-NULL for the destructor to be called
+    if(!created || pthread_setspecific(aral_magazines_globals.key, aral_thread_magazines) != 0)
+        return false;
+
+    aral_thread_magazines_registered = true;
+    return true;
+}
+
+static struct aral_magazine *aral_magazine_attach(ARAL *ar, struct aral_magazine *m) {
+    // when all the magazines of this thread are used by other ARALs, we don't evict
+    // any of them - giving back a full magazine for each free would cost more than
+    // using the pages directly
+    if(!m || !aral_thread_magazines_register())
+        return NULL;
+
+    spinlock_lock(&aral_magazines_globals.spinlock);
+
+    *m = (struct aral_magazine) {
+        .ar = ar,
+        .epoch = __atomic_load_n(&ar->magazines.epoch, __ATOMIC_RELAXED),
+    };
+    DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(ar->magazines.list, m, prev, next);
+    __atomic_store_n(&m->id, ar->magazines.id, __ATOMIC_RELEASE);
+
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+
+    return m;
+}
+
+static ALWAYS_INLINE struct aral_magazine *aral_magazine_of_this_thread(ARAL *ar, bool attach) {
+    struct aral_magazine *unused = NULL;
+
+    for(size_t i = 0; i < ARAL_MAGAZINES_PER_THREAD; i++) {
+        struct aral_magazine *m = &aral_thread_magazines[i];
+        uint64_t id = __atomic_load_n(&m->id, __ATOMIC_ACQUIRE);
+
+        if(id == ar->magazines.id)
+            return m;
+
+        if(!id && !unused)
+            unused = m;
+    }
+
+    return attach ? aral_magazine_attach(ar, unused) : NULL;
+}
+
+static ALWAYS_INLINE void *aral_magazine_get(ARAL *ar) {
+    struct aral_magazine *m = aral_magazine_of_this_thread(ar, false);
+    if(!m || !m->list)
+        return NULL;
+
+    ARAL_CACHED *c = m->list;
+    m->list = c->next;
+    m->count--;
+
+    if(unlikely(++m->malloc_ops >= ARAL_MAGAZINE_PUBLISH_OPS))
+        aral_magazine_publish_ops(ar, m);
+
+    aral_set_page_pointer_after_element___do_NOT_have_aral_lock(ar, c->page, c, false);
+    return c;
+}
+
+// returns false when this thread has no magazine for the ARAL
+static ALWAYS_INLINE bool aral_magazine_put(ARAL *ar, ARAL_PAGE *page, void *ptr) {
+    struct aral_magazine *m = aral_magazine_of_this_thread(ar, true);
+    if(unlikely(!m))
+        return false;
+
+    uint32_t epoch = __atomic_load_n(&ar->magazines.epoch, __ATOMIC_RELAXED);
+    if(unlikely(m->count >= ar->magazines.size || m->epoch != epoch)) {
+        m->epoch = epoch;
+        aral_magazine_give_back(ar, m, (m->count + 1) / 2);
+    }
+
+    ARAL_CACHED *c = ptr;
+    c->page = page;
+    c->next = m->list;
+    m->list = c;
+    m->count++;
+
+    if(unlikely(++m->free_ops >= ARAL_MAGAZINE_PUBLISH_OPS))
+        aral_magazine_publish_ops(ar, m);
+
+    return true;
+}
+
+// the ARAL is being destroyed, its pages will be freed, together with the elements in the magazines
+static void aral_magazines_invalidate(ARAL *ar) {
+    spinlock_lock(&aral_magazines_globals.spinlock);
+
+    struct aral_magazine *m;
+    while((m = ar->magazines.list)) {
+        DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(ar->magazines.list, m, prev, next);
+        __atomic_store_n(&m->id, 0, __ATOMIC_RELEASE);
+    }
+
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+}
+
+void aral_thread_magazine_flush(ARAL *ar) {
+    struct aral_magazine *m = aral_magazine_of_this_thread(ar, false);
+    if(m)
+        aral_magazine_release(m);
+}
+
+void aral_thread_magazines_release(void) {
+    for(size_t i = 0; i < ARAL_MAGAZINES_PER_THREAD; i++) {
+        if(__atomic_load_n(&aral_thread_magazines[i].id, __ATOMIC_ACQUIRE))
+            aral_magazine_release(&aral_thread_magazines[i]);
+    }
+}
+
 ALWAYS_INLINE void *aral_callocz_internal(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
     void *r = aral_mallocz_internal(ar, marked TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
     memset(r, 0, ar->config.requested_element_size);
@@ -992,6 +1259,12 @@ void *aral_mallocz_internal(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEF
     return mallocz(ar->config.requested_element_size);
 #endif
 
+    if(!marked && ar->magazines.size) {
+        void *data = aral_magazine_get(ar);
+        if(data)
+            return data;
+    }
+
     // reserve a slot on a free page
     ARAL_PAGE *page = aral_get_first_page_with_a_free_slot(ar, marked TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
     // the page returned has reserved a slot for us
@@ -1065,6 +1338,15 @@ void aral_freez_internal(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITI
     if(unlikely(!page))
         fatal("ARAL: '%s' double free, stale free, or corrupted pointer %p", ar->config.name, ptr);
 
+    if(!marked && ar->magazines.size && aral_magazine_put(ar, page, ptr))
+        return;
+
+    __atomic_add_fetch(&ar->atomic.user_free_operations, 1, __ATOMIC_RELAXED);
+    aral_free_claimed_slot(ar, page, ptr, marked TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+}
+
+// give back to its page a slot the caller has claimed from its user
+static void aral_free_claimed_slot(ARAL *ar, ARAL_PAGE *page, void *ptr, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
     size_t idx = mark_to_idx(marked);
     __atomic_add_fetch(&ar->ops[idx].atomic.deallocators, 1, __ATOMIC_RELAXED);
 
@@ -1073,7 +1355,6 @@ void aral_freez_internal(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITI
 
     // statistic, outside the lock
     aral_element_returned(ar, page);
-    __atomic_add_fetch(&ar->atomic.user_free_operations, 1, __ATOMIC_RELAXED);
 
     aral_page_lock(ar, page);
     internal_fatal(!page->page_lock.used_elements,
@@ -1180,6 +1461,8 @@ void aral_freez_internal(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITI
 }
 
 void aral_destroy_internal(ARAL *ar TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+    aral_magazines_invalidate(ar);
+
     aral_lock(ar);
 
     ARAL_PAGE **head_ptr = aral_pages_head_free(ar, false);
@@ -1316,6 +1599,12 @@ ARAL *aral_create(const char *name, size_t element_size, size_t initial_page_ele
     // set the starting allocation size for both marked and unmarked partitions
     ar->ops[0].adders.allocation_size = ar->ops[1].adders.allocation_size = ar->config.min_required_page_size;
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // the per-thread magazines
+
+    ar->magazines.id = __atomic_add_fetch(&aral_magazines_globals.last_id, 1, __ATOMIC_RELAXED);
+    ar->magazines.size = aral_magazine_size(ar);
+
     // ----------------------------------------------------------------------------------------------------------------
 
     ar->aral_lock.pages_free = NULL;
@@ -1695,6 +1984,9 @@ static void aral_test_thread(void *ptr) {
             pointers[i] = NULL;
         }
 
+        if (auc->single_threaded)
+            aral_thread_magazine_flush(ar);
+
         if (auc->single_threaded && ar->aral_lock.pages_free && ar->aral_lock.pages_free->page_lock.used_elements) {
             fprintf(stderr, "\n\nARAL leftovers detected (1)\n\n");
             __atomic_add_fetch(&auc->errors, 1, __ATOMIC_RELAXED);
@@ -1738,6 +2030,9 @@ static void aral_test_thread(void *ptr) {
             pointers[i] = NULL;
         }
 
+        if (auc->single_threaded)
+            aral_thread_magazine_flush(ar);
+
         if (auc->single_threaded && ar->aral_lock.pages_free && ar->aral_lock.pages_free->page_lock.used_elements) {
             fprintf(stderr, "\n\nARAL leftovers detected (2)\n\n");
             __atomic_add_fetch(&auc->errors, 1, __ATOMIC_RELAXED);
@@ -1820,6 +2115,114 @@ int aral_stress_test(size_t threads, size_t elements, size_t seconds) {
     return auc.errors;
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// multi-threaded allocation benchmark, with and without the per-thread magazines
+
+#define ARAL_BENCHMARK_BATCH 64
+#define ARAL_BENCHMARK_EXCHANGE_SLOTS 1024
+
+struct aral_benchmark_config {
+    ARAL *ar;
+    bool stop;
+    size_t operations;
+
+    // elements handed over between the threads, so that they free elements allocated by others
+    struct aral_unittest_entry *exchange[ARAL_BENCHMARK_EXCHANGE_SLOTS];
+};
+
+static void aral_benchmark_thread(void *ptr) {
+    struct aral_benchmark_config *abc = ptr;
+    ARAL *ar = abc->ar;
+
+    struct aral_unittest_entry *batch[ARAL_BENCHMARK_BATCH];
+    size_t operations = 0;
+
+    while(!__atomic_load_n(&abc->stop, __ATOMIC_RELAXED)) {
+        for(size_t i = 0; i < ARAL_BENCHMARK_BATCH; i++)
+            batch[i] = unittest_aral_malloc(ar, false);
+
+        // hand over one of our elements and free the one we get back
+        size_t slot = os_random(ARAL_BENCHMARK_EXCHANGE_SLOTS);
+        struct aral_unittest_entry *other = __atomic_exchange_n(&abc->exchange[slot], batch[0], __ATOMIC_ACQ_REL);
+        if(other)
+            aral_freez(ar, other);
+
+        for(size_t i = 1; i < ARAL_BENCHMARK_BATCH; i++)
+            aral_freez(ar, batch[i]);
+
+        operations += 2 * ARAL_BENCHMARK_BATCH;
+    }
+
+    __atomic_add_fetch(&abc->operations, operations, __ATOMIC_RELAXED);
+}
+
+static int aral_benchmark_run(size_t threads, size_t seconds, bool magazines, double *ops_per_sec) {
+    struct aral_benchmark_config *abc = callocz(1, sizeof(*abc));
+    abc->ar = aral_create("aral-benchmark",
+                          sizeof(struct aral_unittest_entry),
+                          0,
+                          65536,
+                          NULL,
+                          "aral-benchmark",
+                          NULL, false, false, false);
+
+    if(!magazines)
+        abc->ar->magazines.size = 0;
+
+    usec_t started_ut = now_monotonic_usec();
+    ND_THREAD **thread_ptrs = callocz(threads, sizeof(*thread_ptrs));
+
+    for(size_t i = 0; i < threads ; i++) {
+        char tag[ND_THREAD_TAG_MAX + 1];
+        snprintfz(tag, ND_THREAD_TAG_MAX, "ARALBENCH[%zu]", i);
+        thread_ptrs[i] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DONT_LOG, aral_benchmark_thread, abc);
+    }
+
+    sleep_usec(seconds * USEC_PER_SEC);
+    __atomic_store_n(&abc->stop, true, __ATOMIC_RELAXED);
+
+    // the threads give back their magazines when they exit
+    for(size_t i = 0; i < threads ; i++)
+        nd_thread_join(thread_ptrs[i]);
+
+    freez(thread_ptrs);
+
+    usec_t ended_ut = now_monotonic_usec();
+
+    for(size_t i = 0; i < ARAL_BENCHMARK_EXCHANGE_SLOTS; i++) {
+        if(abc->exchange[i])
+            aral_freez(abc->ar, abc->exchange[i]);
+    }
+    aral_thread_magazine_flush(abc->ar);
+
+    int errors = 0;
+    if(aral_used_bytes(abc->ar)) {
+        fprintf(stderr, "\n\nARAL benchmark leftovers detected: %zu bytes are still used\n\n", aral_used_bytes(abc->ar));
+        errors++;
+    }
+
+    *ops_per_sec = (double)__atomic_load_n(&abc->operations, __ATOMIC_RELAXED) * USEC_PER_SEC / (double)(ended_ut - started_ut);
+
+    aral_destroy(abc->ar);
+    freez(abc);
+
+    return errors;
+}
+
+static int aral_benchmark(size_t threads, size_t seconds) {
+    fprintf(stderr, "Running allocation benchmark of %zu threads, for %zu seconds with and without magazines...\n",
+            threads, seconds);
+
+    double without = 0, with = 0;
+    int errors = aral_benchmark_run(threads, seconds, false, &without);
+    errors += aral_benchmark_run(threads, seconds, true, &with);
+
+    fprintf(stderr, "ARAL benchmark: %0.2f M ops/s without magazines, %0.2f M ops/s with magazines (%0.2fx)\n",
+            without / 1000000.0, with / 1000000.0, without > 0 ? with / without : 0.0);
+
+    return errors;
+}
+
 int aral_unittest(size_t elements) {
     const char *cache_dir = "/tmp/";
 #ifdef NETDATA_INTERNAL_CHECKS
@@ -1853,6 +2256,7 @@ int aral_unittest(size_t elements) {
     aral_destroy(auc.ar);
 
     errors += aral_stress_test(2, elements, 10);
+    errors += aral_benchmark(FIT_IN_RANGE(os_get_system_cpus_cached(true), 2, 16), 3);
 
     int total_errors = auc.errors + errors;
     fprintf(stderr, "ARAL unittest: %s (%d errors)\n", total_errors ? "FAILED" : "PASSED", total_errors);
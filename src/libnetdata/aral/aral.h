@@ -81,6 +81,15 @@ size_t aral_free_bytes_from_stats(struct aral_statistics *stats);
 size_t aral_used_bytes_from_stats(struct aral_statistics *stats);
 size_t aral_padding_bytes_from_stats(struct aral_statistics *stats);
 
+// --------------------------------------------------------------------------------------------------------------------
+// per-thread magazines (caches of free elements)
+
+// give back the elements the calling thread caches for this ARAL
+void aral_thread_magazine_flush(ARAL *ar);
+
+// give back the elements the calling thread caches for all ARALs - called when threads exit
+void aral_thread_magazines_release(void);
+
 // --------------------------------------------------------------------------------------------------------------------
 
 ARAL *aral_by_size_acquire(size_t size);
@@ -219,6 +219,8 @@ struct facet_key {
 };
 
 struct facets {
+    FACETS *parent;                 // set on shards, the patterns are borrowed from the parent
+
     SIMPLE_PATTERN *visible_keys;
     SIMPLE_PATTERN *excluded_keys;
     SIMPLE_PATTERN *included_keys;
@@ -464,19 +466,7 @@ static inline FACET_VALUE *FACET_VALUE_GET_FROM_INDEX(FACET_KEY *k, FACETS_HASH
     return SIMPLE_HASHTABLE_SLOT_DATA(slot);
 }
 
-static inline FACET_VALUE *FACET_VALUE_ADD_TO_INDEX(FACET_KEY *k, const FACET_VALUE * const tv) {
-    SIMPLE_HASHTABLE_SLOT_VALUE *slot = simple_hashtable_get_slot_VALUE(&k->values.ht, tv->hash, NULL, true);
-
-    if(SIMPLE_HASHTABLE_SLOT_DATA(slot)) {
-        // already exists
-
-        FACET_VALUE *v = SIMPLE_HASHTABLE_SLOT_DATA(slot);
-        FACET_VALUE_ADD_CONFLICT(k, v, tv);
-        return v;
-    }
-
-    // we have to add it
-
+static inline FACET_VALUE *FACET_VALUE_CREATE_IN_SLOT(FACET_KEY *k, SIMPLE_HASHTABLE_SLOT_VALUE *slot, const FACET_VALUE * const tv) {
     FACET_VALUE *v = mallocz(sizeof(*v));
     simple_hashtable_set_slot_VALUE(&k->values.ht, slot, tv->hash, v);
 
@@ -501,7 +491,6 @@ static inline FACET_VALUE *FACET_VALUE_ADD_TO_INDEX(FACET_KEY *k, const FACET_VA
     if(v->name && v->name_len) {
         // an actual value, not a filter
         v->name = facets_value_dup(v->name, v->name_len);
-        facet_value_is_used(k, v);
     }
     else {
         v->name = NULL;
@@ -513,6 +502,27 @@ static inline FACET_VALUE *FACET_VALUE_ADD_TO_INDEX(FACET_KEY *k, const FACET_VA
     return v;
 }
 
+static inline FACET_VALUE *FACET_VALUE_ADD_TO_INDEX(FACET_KEY *k, const FACET_VALUE * const tv) {
+    SIMPLE_HASHTABLE_SLOT_VALUE *slot = simple_hashtable_get_slot_VALUE(&k->values.ht, tv->hash, NULL, true);
+
+    if(SIMPLE_HASHTABLE_SLOT_DATA(slot)) {
+        // already exists
+
+        FACET_VALUE *v = SIMPLE_HASHTABLE_SLOT_DATA(slot);
+        FACET_VALUE_ADD_CONFLICT(k, v, tv);
+        return v;
+    }
+
+    // we have to add it
+
+    FACET_VALUE *v = FACET_VALUE_CREATE_IN_SLOT(k, slot, tv);
+
+    if(v->name)
+        facet_value_is_used(k, v);
+
+    return v;
+}
+
 static inline void FACET_VALUE_ADD_UNSAMPLED_VALUE_TO_INDEX(FACET_KEY *k) {
     static const FACET_VALUE tv = {
             .hash = FACETS_HASH_UNSAMPLED,
@@ -1724,9 +1734,12 @@ void facets_destroy(FACETS *facets) {
 
     dictionary_destroy(facets->accepted_params);
     FACETS_KEYS_INDEX_DESTROY(facets);
-    simple_pattern_free(facets->visible_keys);
-    simple_pattern_free(facets->included_keys);
-    simple_pattern_free(facets->excluded_keys);
+
+    if(!facets->parent) {
+        simple_pattern_free(facets->visible_keys);
+        simple_pattern_free(facets->included_keys);
+        simple_pattern_free(facets->excluded_keys);
+    }
 
     while(facets->base) {
         FACET_ROW *r = facets->base;
@@ -2119,8 +2132,8 @@ static inline FACET_ROW *facets_row_keep_seek_to_position(FACETS *facets, usec_t
     return last;
 }
 
-static void facets_row_keep_first_entry(FACETS *facets, usec_t usec) {
-    facets->operations.last_added = facets_row_create(facets, usec, NULL);
+static void facets_row_keep_first_entry(FACETS *facets, usec_t usec, FACET_ROW *merged) {
+    facets->operations.last_added = merged ? merged : facets_row_create(facets, usec, NULL);
     DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(facets->base, facets->operations.last_added, prev, next);
     facets->items_to_return++;
     facets->operations.first++;
@@ -2168,12 +2181,15 @@ bool facets_row_candidate_to_keep(FACETS *facets, usec_t usec) {
             facets->items_to_return < facets->max_items_to_return;
 }
 
-static void facets_row_keep(FACETS *facets, usec_t usec) {
-    facets->operations.rows.matched++;
+// when merged is given, it is a row already created by a shard
+// and it is either linked to our list, or freed
+static void facets_row_keep(FACETS *facets, usec_t usec, FACET_ROW *merged) {
+    if(!merged)
+        facets->operations.rows.matched++;
 
     if(unlikely(!facets->base)) {
         // the first row to keep
-        facets_row_keep_first_entry(facets, usec);
+        facets_row_keep_first_entry(facets, usec, merged);
         return;
     }
 
@@ -2189,6 +2205,7 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
                 if(closest == facets->base->prev && usec < closest->usec) {
                     // this is to the end of the list, belonging to the next page
                     facets->operations.skips_after++;
+                    if(merged) facets_row_free(facets, merged);
                     return;
                 }
 
@@ -2203,6 +2220,7 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
                 if(closest == facets->base && usec > closest->usec) {
                     // this is to the beginning of the list, belonging to the next page
                     facets->operations.skips_before++;
+                    if(merged) facets_row_free(facets, merged);
                     return;
                 }
 
@@ -2222,7 +2240,14 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
     internal_fatal(!closest, "FACETS: closest cannot be NULL");
     internal_fatal(closest == to_replace, "FACETS: closest cannot be the same as to_replace");
 
-    facets->operations.last_added = facets_row_create(facets, usec, to_replace);
+    if(merged) {
+        if(to_replace)
+            facets_row_free(facets, to_replace);
+
+        facets->operations.last_added = merged;
+    }
+    else
+        facets->operations.last_added = facets_row_create(facets, usec, to_replace);
 
     if(usec < closest->usec) {
         DOUBLE_LINKED_LIST_INSERT_ITEM_AFTER_UNSAFE(facets->base, closest, facets->operations.last_added, prev, next);
@@ -2340,7 +2365,7 @@ bool facets_row_finished(FACETS *facets, usec_t usec) {
         facets_histogram_update_value(facets, usec);
 
         if(within_anchor)
-            facets_row_keep(facets, usec);
+            facets_row_keep(facets, usec, NULL);
     }
 
     facets_reset_keys_with_value_and_row(facets);
@@ -2348,6 +2373,187 @@ bool facets_row_finished(FACETS *facets, usec_t usec) {
     return selected_keys == total_keys;
 }
 
+
+// ----------------------------------------------------------------------------
+// shards - independent FACETS that can be filled in parallel and merged
+
+FACETS *facets_create_shard(FACETS *facets) {
+    FACETS *shard = callocz(1, sizeof(FACETS));
+    shard->parent = facets;
+    shard->all_keys_included_by_default = facets->all_keys_included_by_default;
+    shard->options = facets->options;
+
+    // the patterns are immutable while querying, so they are shared
+    shard->visible_keys = facets->visible_keys;
+    shard->included_keys = facets->included_keys;
+    shard->excluded_keys = facets->excluded_keys;
+    shard->query = facets->query;
+
+    shard->anchor = facets->anchor;
+    shard->timeframe = facets->timeframe;
+    shard->severity = facets->severity;
+    shard->max_items_to_return = facets->max_items_to_return;
+    shard->order = 1;
+
+    shard->histogram.enabled = facets->histogram.enabled;
+    shard->histogram.hash = facets->histogram.hash;
+    shard->histogram.slots = facets->histogram.slots;
+    shard->histogram.slot_width_ut = facets->histogram.slot_width_ut;
+    shard->histogram.after_ut = facets->histogram.after_ut;
+    shard->histogram.before_ut = facets->histogram.before_ut;
+
+    FACETS_KEYS_INDEX_CREATE(shard);
+
+    // copy the registered keys and the selected values (filters)
+    FACET_KEY *k;
+    foreach_key_in_facets(facets, k) {
+        FACET_KEY *sk = FACETS_KEY_ADD_TO_INDEX(shard, k->hash, k->name, k->name ? strlen(k->name) : 0, k->options);
+        sk->default_selected_for_values = k->default_selected_for_values;
+        sk->transform = k->transform;
+        sk->dynamic = k->dynamic;
+
+        if(!k->values.enabled)
+            continue;
+
+        facet_key_late_init(shard, sk);
+        if(!sk->values.enabled)
+            continue;
+
+        FACET_VALUE *v;
+        foreach_value_in_key(k, v) {
+            if(!v->selected || v->empty || v->unsampled || v->estimated || FACET_VALUE_GET_FROM_INDEX(sk, v->hash))
+                continue;
+
+            FACET_VALUE tv = {
+                    .hash = v->hash,
+                    .name = v->name,
+                    .name_len = v->name_len,
+                    .color = v->color,
+                    .selected = true,
+            };
+            SIMPLE_HASHTABLE_SLOT_VALUE *slot = simple_hashtable_get_slot_VALUE(&sk->values.ht, tv.hash, NULL, true);
+            FACET_VALUE_CREATE_IN_SLOT(sk, slot, &tv);
+        }
+        foreach_value_in_key_done(v);
+    }
+    foreach_key_in_facets_done(k);
+
+    return shard;
+}
+
+static inline void FACET_VALUE_MERGE_INTO_INDEX(FACETS *facets, FACET_KEY *k, FACET_VALUE *sv) {
+    SIMPLE_HASHTABLE_SLOT_VALUE *slot = simple_hashtable_get_slot_VALUE(&k->values.ht, sv->hash, NULL, true);
+    FACET_VALUE *v = SIMPLE_HASHTABLE_SLOT_DATA(slot);
+
+    if(!v) {
+        FACET_VALUE tv = {
+                .hash = sv->hash,
+                .name = sv->name,
+                .name_len = sv->name_len,
+                .color = sv->color,
+                .selected = sv->selected,
+                .empty = sv->empty,
+                .unsampled = sv->unsampled,
+                .estimated = sv->estimated,
+        };
+        v = FACET_VALUE_CREATE_IN_SLOT(k, slot, &tv);
+
+        if(v->empty)
+            k->empty_value.v = v;
+        else if(v->unsampled)
+            k->unsampled_value.v = v;
+        else if(v->estimated)
+            k->estimated_value.v = v;
+    }
+    else if(!v->name && sv->name && sv->name_len) {
+        // the shard found the name of a filtered hash
+        v->name = facets_value_dup(sv->name, sv->name_len);
+        v->name_len = sv->name_len;
+    }
+
+    v->rows_matching_facet_value += sv->rows_matching_facet_value;
+    v->final_facet_value_counter += sv->final_facet_value_counter;
+
+    if(sv->histogram) {
+        if(!v->histogram)
+            v->histogram = callocz(facets->histogram.slots, sizeof(*v->histogram));
+
+        for(uint32_t i = 0; i < facets->histogram.slots ;i++)
+            v->histogram[i] += sv->histogram[i];
+    }
+}
+
+void facets_merge(FACETS *dst, FACETS *src) {
+    internal_fatal(src->parent != dst, "FACETS: merging a shard to a FACETS that is not its parent");
+    internal_fatal(dst->histogram.slots != src->histogram.slots, "FACETS: merging shards with different histograms");
+
+    // keys and their values
+    FACET_KEY *sk;
+    foreach_key_in_facets(src, sk) {
+        FACET_KEY *dk = FACETS_KEY_ADD_TO_INDEX(dst, sk->hash, sk->name, sk->name ? strlen(sk->name) : 0,
+                                                sk->options & ~FACET_KEY_OPTION_REORDER_DONE);
+
+        if(!sk->values.enabled)
+            continue;
+
+        facet_key_late_init(dst, dk);
+        if(!dk->values.enabled)
+            continue;
+
+        FACET_VALUE *sv;
+        foreach_value_in_key(sk, sv) {
+            FACET_VALUE_MERGE_INTO_INDEX(dst, dk, sv);
+        }
+        foreach_value_in_key_done(sv);
+
+        if(unlikely(!dst->histogram.key && dst->histogram.hash == dk->hash))
+            dst->histogram.key = dk;
+    }
+    foreach_key_in_facets_done(sk);
+
+    // the kept rows, moved to dst (oldest first)
+    while(src->base) {
+        FACET_ROW *row = src->base->prev;
+        DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(src->base, row, prev, next);
+        src->items_to_return--;
+
+        if(row->bin_data.data) {
+            src->operations.bin_data_inflight--;
+            dst->operations.bin_data_inflight++;
+        }
+
+        facets_row_keep(dst, row->usec, row);
+    }
+
+    // statistics
+    dst->operations.first += src->operations.first;
+    dst->operations.forwards += src->operations.forwards;
+    dst->operations.backwards += src->operations.backwards;
+    dst->operations.skips_before += src->operations.skips_before;
+    dst->operations.skips_after += src->operations.skips_after;
+    dst->operations.prepends += src->operations.prepends;
+    dst->operations.appends += src->operations.appends;
+    dst->operations.shifts += src->operations.shifts;
+
+    dst->operations.rows.evaluated += src->operations.rows.evaluated;
+    dst->operations.rows.matched += src->operations.rows.matched;
+    dst->operations.rows.unsampled += src->operations.rows.unsampled;
+    dst->operations.rows.estimated += src->operations.rows.estimated;
+    dst->operations.rows.created += src->operations.rows.created;
+    dst->operations.rows.reused += src->operations.rows.reused;
+
+    dst->operations.values.registered += src->operations.values.registered;
+    dst->operations.values.transformed += src->operations.values.transformed;
+    dst->operations.values.dynamic += src->operations.values.dynamic;
+    dst->operations.values.empty += src->operations.values.empty;
+    dst->operations.values.unsampled += src->operations.values.unsampled;
+    dst->operations.values.estimated += src->operations.values.estimated;
+    dst->operations.values.indexed += src->operations.values.indexed;
+    dst->operations.values.conflicts += src->operations.values.conflicts;
+
+    dst->operations.fts.searches += src->operations.fts.searches;
+}
+
 // ----------------------------------------------------------------------------
 // output
 
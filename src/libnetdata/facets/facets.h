@@ -96,6 +96,11 @@ typedef enum __attribute__((packed)) {
 FACETS *facets_create(uint32_t items_to_return, FACETS_OPTIONS options, const char *visible_keys, const char *facet_keys, const char *non_facet_keys);
 void facets_destroy(FACETS *facets);
 
+// shards are FACETS sharing the configuration of their parent, to be filled
+// by another thread and then merged back to the parent (counters, histograms, rows)
+FACETS *facets_create_shard(FACETS *facets);
+void facets_merge(FACETS *dst, FACETS *src);
+
 void facets_accepted_param(FACETS *facets, const char *param);
 
 void facets_rows_begin(FACETS *facets);
@@ -33,6 +33,10 @@
 // enabled with the streaming capability STREAM_CAP_SLOTS
 #define PLUGINSD_KEYWORD_SLOT                   "SLOT" // to change the length of this, update pluginsd_extract_chart_slot() too
 
+// binary BEGIN, SET, END for external plugins, over a shared memory ring (see pluginsd_shm.h)
+#define PLUGINSD_KEYWORD_DATA_SHM_ATTACH        "DATA_SHM_ATTACH"
+#define PLUGINSD_KEYWORD_DATA_SHM_FLUSH         "DATA_SHM_FLUSH"
+
 // virtual hosts (only for external plugins - for streaming virtual hosts are like all other hosts)
 #define PLUGINSD_KEYWORD_HOST_DEFINE            "HOST_DEFINE"
 #define PLUGINSD_KEYWORD_HOST_DEFINE_END        "HOST_DEFINE_END"
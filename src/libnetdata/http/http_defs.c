@@ -17,6 +17,69 @@ ENUM_STR_MAP_DEFINE(HTTP_REQUEST_MODE) =
 
 ENUM_STR_DEFINE_FUNCTIONS(HTTP_REQUEST_MODE, 0, "UNKNOWN");
 
+ENUM_STR_MAP_DEFINE(HTTP_CONTENT_ENCODING) =
+{
+        { .name = "gzip", .id = HTTP_CONTENT_ENCODING_GZIP },
+        { .name = "br", .id = HTTP_CONTENT_ENCODING_BROTLI },
+        { .name = "zstd", .id = HTTP_CONTENT_ENCODING_ZSTD },
+
+        // terminator
+        { .name = NULL, .id = 0 }
+};
+
+ENUM_STR_DEFINE_FUNCTIONS(HTTP_CONTENT_ENCODING, HTTP_CONTENT_ENCODING_NONE, "identity");
+
+HTTP_CONTENT_ENCODING http_accept_encoding_parse(const char *s) {
+    HTTP_CONTENT_ENCODING encodings = HTTP_CONTENT_ENCODING_NONE;
+
+    while(s && *s) {
+        while(*s == ' ' || *s == '\t' || *s == ',') s++;
+        if(!*s) break;
+
+        const char *name = s;
+        while(*s && *s != ',' && *s != ';' && *s != ' ' && *s != '\t') s++;
+        size_t len = s - name;
+
+        // check the parameters of this encoding for q=0
+        bool refused = false;
+        while(*s && *s != ',') {
+            if(*s == ';') {
+                s++;
+                while(*s == ' ' || *s == '\t') s++;
+                if((*s == 'q' || *s == 'Q') && s[1] == '=') {
+                    const char *q = &s[2];
+                    refused = (*q == '0');
+                    if(refused && q[1] == '.') {
+                        for(q = &q[2]; *q >= '0' && *q <= '9'; q++) {
+                            if(*q != '0') {
+                                refused = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            else
+                s++;
+        }
+
+        if(refused || !len)
+            continue;
+
+        if(len == 4 && strncasecmp(name, "gzip", 4) == 0)
+            encodings |= HTTP_CONTENT_ENCODING_GZIP;
+        else if(len == 2 && strncasecmp(name, "br", 2) == 0)
+            encodings |= HTTP_CONTENT_ENCODING_BROTLI;
+        else if(len == 4 && strncasecmp(name, "zstd", 4) == 0)
+            encodings |= HTTP_CONTENT_ENCODING_ZSTD;
+        else if(len == 1 && *name == '*')
+            // be conservative with wildcards, gzip is universally supported
+            encodings |= HTTP_CONTENT_ENCODING_GZIP;
+    }
+
+    return encodings;
+}
+
 const char *http_response_code2string(int code) {
     switch(code) {
         case 100:
@@ -57,6 +57,18 @@ typedef enum __attribute__((__packed__)) {
 
 ENUM_STR_DEFINE_FUNCTIONS_EXTERN(HTTP_REQUEST_MODE);
 
+typedef enum __attribute__((__packed__)) {
+    HTTP_CONTENT_ENCODING_NONE      = 0,
+    HTTP_CONTENT_ENCODING_GZIP      = (1 << 0),
+    HTTP_CONTENT_ENCODING_BROTLI    = (1 << 1),
+    HTTP_CONTENT_ENCODING_ZSTD      = (1 << 2),
+} HTTP_CONTENT_ENCODING;
+
+ENUM_STR_DEFINE_FUNCTIONS_EXTERN(HTTP_CONTENT_ENCODING);
+
+// parse the value of an Accept-Encoding: header, ignoring the encodings refused with q=0
+HTTP_CONTENT_ENCODING http_accept_encoding_parse(const char *s);
+
 const char *http_response_code2string(int code);
 HTTP_CONTENT_TYPE contenttype_for_filename(const char *filename);
 
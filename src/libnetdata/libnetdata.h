@@ -133,6 +133,7 @@ extern const char *netdata_configured_host_prefix;
 #include "gorilla/gorilla.h"
 #include "facets/facets.h"
 #include "functions_evloop/functions_evloop.h"
+#include "pluginsd_shm/pluginsd_shm.h"
 #include "query_progress/progress.h"
 #include "stacktrace/stacktrace.h"
 
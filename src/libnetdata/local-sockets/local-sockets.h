@@ -72,6 +72,15 @@ struct local_port;
 #define SIMPLE_HASHTABLE_NAME _LISTENING_PORT
 #include "libnetdata/simple_hashtable/simple_hashtable.h"
 
+// --------------------------------------------------------------------------------------------------------------------
+// hashtable for keeping the persistent index of the sockets of all processes
+// key is the pid
+
+struct local_sockets_pid_entry;
+#define SIMPLE_HASHTABLE_VALUE_TYPE struct local_sockets_pid_entry *
+#define SIMPLE_HASHTABLE_NAME _PID_ENTRY
+#include "libnetdata/simple_hashtable/simple_hashtable.h"
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct local_socket_state;
@@ -149,6 +158,9 @@ typedef struct local_socket_state {
 #endif
 
         struct procfile_stats ff;
+
+        size_t pid_index_pids_scanned;
+        size_t pid_index_pids_cached;
     } stats;
 
     size_t timings_idx;
@@ -165,6 +177,9 @@ typedef struct local_socket_state {
 
     procfile *ff;
 
+    // optional, a persistent index of the sockets of all processes, shared between calls
+    struct local_sockets_pid_index *pid_index;
+
     ARAL *local_socket_aral;
     ARAL *pid_socket_aral;
     SPINLOCK spinlock; // for namespaces
@@ -203,6 +218,68 @@ struct pid_socket {
     char comm[TASK_COMM_LEN];
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// the persistent index of the sockets of all processes
+//
+// Reading the links of all /proc/<pid>/fd/* is the most expensive part of finding the processes
+// that own the sockets. The index keeps the socket inodes of every process and re-reads the fd table
+// of a process only when its signature changes (the inodes of /proc/<pid> and /proc/<pid>/fd, the number
+// of its fds and the mtime of /proc/<pid>/fd), or when it is older than LOCAL_SOCKETS_PID_INDEX_MAX_AGE_UT,
+// to catch sockets replacing other files without changing the number of fds.
+
+#define LOCAL_SOCKETS_PID_INDEX_MAX_AGE_UT (30 * USEC_PER_SEC)
+
+typedef enum __attribute__((packed)) {
+    LS_PID_INFO_NONE        = 0,
+    LS_PID_INFO_PID         = (1 << 0), // ppid
+    LS_PID_INFO_UID         = (1 << 1),
+    LS_PID_INFO_COMM        = (1 << 2),
+    LS_PID_INFO_CMDLINE     = (1 << 3),
+    LS_PID_INFO_NAMESPACES  = (1 << 4),
+} LS_PID_INFO;
+
+typedef struct local_sockets_pid_entry {
+    pid_t pid;
+    pid_t ppid;
+    uid_t uid;
+    uint64_t net_ns_inode;
+    char *cmdline;
+    char comm[TASK_COMM_LEN];
+
+    // the signature of the fd table, when it was read
+    struct {
+        ino_t pid_dir_inode;    // changes when the pid is reused
+        ino_t fd_dir_inode;
+        size_t fds;
+        struct timespec fd_dir_mtime;
+    } signature;
+
+    usec_t scanned_ut;
+    uint64_t generation;
+    LS_PID_INFO info;           // what we have read about the process
+
+    uint32_t sockets;
+    uint32_t sockets_size;
+    uint64_t *inodes;
+} LS_PID_ENTRY;
+
+typedef struct local_sockets_pid_index {
+    netdata_mutex_t mutex;      // callers are serialized, the second one finds everything up to date
+    uint64_t generation;
+    SIMPLE_HASHTABLE_PID_ENTRY pids;
+
+    struct {
+        size_t scans;
+        size_t pids;            // pids in the index
+        size_t pids_scanned;    // pids whose fd table was read
+        size_t pids_cached;     // pids reused from the index
+        size_t pids_removed;    // pids that exited
+        size_t fds_read;        // fd links read
+        usec_t scan_ut;         // time spent updating the index
+        usec_t last_scan_ut;
+    } stats;
+} LS_PID_INDEX;
+
 struct local_port {
     uint16_t protocol;
     uint16_t family;
@@ -581,19 +658,291 @@ static inline bool local_sockets_is_path_a_pid(const char *s) {
     return true;
 }
 
+static inline LS_PID_INFO local_sockets_pid_info_needed(LS_STATE *ls) {
+    return (ls->config.pid ? LS_PID_INFO_PID : 0) |
+           (ls->config.uid ? LS_PID_INFO_UID : 0) |
+           (ls->config.comm ? LS_PID_INFO_COMM : 0) |
+           (ls->config.cmdline ? LS_PID_INFO_CMDLINE : 0) |
+           (ls->config.namespaces ? LS_PID_INFO_NAMESPACES : 0);
+}
+
+static inline LS_PID_INDEX *local_sockets_pid_index_create(void) {
+    LS_PID_INDEX *idx = callocz(1, sizeof(*idx));
+    netdata_mutex_init(&idx->mutex);
+    simple_hashtable_init_PID_ENTRY(&idx->pids, 4096);
+    return idx;
+}
+
+static inline void local_sockets_pid_entry_free(LS_PID_ENTRY *pe) {
+    freez(pe->cmdline);
+    freez(pe->inodes);
+    freez(pe);
+}
+
+static inline void local_sockets_pid_index_destroy(LS_PID_INDEX *idx) {
+    if(!idx) return;
+
+    for(SIMPLE_HASHTABLE_SLOT_PID_ENTRY *sl = simple_hashtable_first_read_only_PID_ENTRY(&idx->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_PID_ENTRY(&idx->pids, sl)) {
+        LS_PID_ENTRY *pe = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(pe) local_sockets_pid_entry_free(pe);
+    }
+
+    simple_hashtable_destroy_PID_ENTRY(&idx->pids);
+    netdata_mutex_destroy(&idx->mutex);
+    freez(idx);
+}
+
+// read the ppid, uid, comm, cmdline and network namespace of a process
+static inline void local_sockets_pid_entry_read_info(LS_STATE *ls, LS_PID_ENTRY *pe, const char *proc_filename, const char *pid_str, LS_PID_INFO needed) {
+    char filename[FILENAME_MAX + 1];
+
+    pe->ppid = 0;
+    pe->uid = UID_UNSET;
+    pe->net_ns_inode = 0;
+    pe->comm[0] = '\0';
+    freez(pe->cmdline);
+    pe->cmdline = NULL;
+
+    if(needed & (LS_PID_INFO_UID | LS_PID_INFO_PID)) {
+        char status_buf[512];
+
+        snprintfz(filename, sizeof(filename), "%s/%s/status", proc_filename, pid_str);
+        if (read_txt_file(filename, status_buf, sizeof(status_buf)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            if(needed & LS_PID_INFO_UID) {
+                char *u = strstr(status_buf, "Uid:");
+                if(u) {
+                    u += 4;
+                    while(isspace((unsigned char)*u)) u++;     // skip spaces
+                    while(*u >= '0' && *u <= '9') u++;          // skip the first number (real uid)
+                    while(isspace((unsigned char)*u)) u++;     // skip spaces again
+                    pe->uid = strtol(u, NULL, 10);   // parse the 2nd number (effective uid)
+                }
+            }
+
+            if(needed & LS_PID_INFO_PID) {
+                char *p = strstr(status_buf, "PPid:");
+                if(p) {
+                    p += 5;
+                    while(isspace((unsigned char)*p)) p++;     // skip spaces
+                    pe->ppid = (pid_t)strtol(p, NULL, 10);      // parse parent pid
+                }
+            }
+        }
+    }
+
+    if(needed & LS_PID_INFO_COMM) {
+        snprintfz(filename, sizeof(filename), "%s/%s/comm", proc_filename, pid_str);
+        if (read_txt_file(filename, pe->comm, sizeof(pe->comm)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            size_t clen = strlen(pe->comm);
+            if(clen && pe->comm[clen - 1] == '\n')
+                pe->comm[clen - 1] = '\0';
+        }
+    }
+
+    if(needed & LS_PID_INFO_CMDLINE) {
+        char cmdline[LOCAL_SOCKETS_CMDLINE_MAX];
+        snprintfz(filename, sizeof(filename), "%s/%s/cmdline", proc_filename, pid_str);
+        if (read_proc_cmdline(filename, cmdline, sizeof(cmdline)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            local_sockets_fix_cmdline(cmdline);
+            const char *cmdline_trimmed = trim(cmdline);
+            if(cmdline_trimmed)
+                pe->cmdline = strdupz(cmdline_trimmed);
+        }
+    }
+
+    if(needed & LS_PID_INFO_NAMESPACES) {
+        snprintfz(filename, sizeof(filename), "%s/%s/ns/net", proc_filename, pid_str);
+        local_sockets_read_proc_inode_link(ls, filename, &pe->net_ns_inode, "net");
+    }
+
+    pe->info = needed;
+}
+
+// read the fd links of a process, keeping the socket inodes
+static inline bool local_sockets_pid_entry_read_fds(LS_STATE *ls, LS_PID_ENTRY *pe, const char *proc_filename, const char *pid_str, size_t *fds_read) {
+    char filename[FILENAME_MAX + 1];
+
+    snprintfz(filename, FILENAME_MAX, "%s/%s/fd/", proc_filename, pid_str);
+    DIR *fd_dir = opendir(filename);
+    if (fd_dir == NULL) {
+        local_sockets_log(ls, "cannot opendir() '%s'", filename);
+        ls->stats.pid_fds_opendir_failed++;
+        return false;
+    }
+
+    pe->sockets = 0;
+
+    struct dirent *fd_entry;
+    while ((fd_entry = readdir(fd_dir)) != NULL) {
+        if(fd_entry->d_type != DT_LNK)
+            continue;
+
+        snprintfz(filename, sizeof(filename), "%s/%s/fd/%s", proc_filename, pid_str, fd_entry->d_name);
+        (*fds_read)++;
+
+        uint64_t inode = 0;
+        if(!local_sockets_read_proc_inode_link(ls, filename, &inode, "socket"))
+            continue;
+
+        if(pe->sockets == pe->sockets_size) {
+            pe->sockets_size = pe->sockets_size ? pe->sockets_size * 2 : 4;
+            pe->inodes = reallocz(pe->inodes, pe->sockets_size * sizeof(*pe->inodes));
+        }
+        pe->inodes[pe->sockets++] = inode;
+    }
+
+    closedir(fd_dir);
+    return true;
+}
+
+// the number of fds of a process - the size of the fd directory on kernels 6.2+, otherwise we count them
+static inline size_t local_sockets_pid_fds(const char *fd_dir_filename, const struct stat *st) {
+    if(st->st_size > 0)
+        return (size_t)st->st_size;
+
+    DIR *fd_dir = opendir(fd_dir_filename);
+    if(!fd_dir)
+        return 0;
+
+    size_t fds = 0;
+    struct dirent *fd_entry;
+    while ((fd_entry = readdir(fd_dir)) != NULL)
+        if(fd_entry->d_type == DT_LNK)
+            fds++;
+
+    closedir(fd_dir);
+    return fds;
+}
+
+// bring the entry of a pid up to date; returns false when the process cannot be read
+static inline bool local_sockets_pid_entry_update(LS_STATE *ls, LS_PID_INDEX *idx, LS_PID_ENTRY **pe_ptr, pid_t pid, const char *proc_filename, const char *pid_str, usec_t now_ut) {
+    char filename[FILENAME_MAX + 1];
+    struct stat pid_st, fd_st;
+
+    snprintfz(filename, sizeof(filename), "%s/%s", proc_filename, pid_str);
+    if(stat(filename, &pid_st) != 0)
+        return false;
+
+    snprintfz(filename, sizeof(filename), "%s/%s/fd", proc_filename, pid_str);
+    if(stat(filename, &fd_st) != 0) {
+        local_sockets_log(ls, "cannot stat() '%s'", filename);
+        ls->stats.pid_fds_opendir_failed++;
+        return false;
+    }
+
+    size_t fds = local_sockets_pid_fds(filename, &fd_st);
+    LS_PID_INFO needed = local_sockets_pid_info_needed(ls);
+
+    LS_PID_ENTRY *pe = *pe_ptr;
+    if(pe &&
+        pe->pid == pid &&
+        pe->signature.pid_dir_inode == pid_st.st_ino &&
+        pe->signature.fd_dir_inode == fd_st.st_ino &&
+        pe->signature.fds == fds &&
+        pe->signature.fd_dir_mtime.tv_sec == fd_st.st_mtim.tv_sec &&
+        pe->signature.fd_dir_mtime.tv_nsec == fd_st.st_mtim.tv_nsec &&
+        (!pe->sockets || (pe->info & needed) == needed) &&
+        now_ut - pe->scanned_ut < LOCAL_SOCKETS_PID_INDEX_MAX_AGE_UT) {
+        idx->stats.pids_cached++;
+        ls->stats.pid_index_pids_cached++;
+        return true;
+    }
+
+    if(!pe) {
+        pe = callocz(1, sizeof(*pe));
+        *pe_ptr = pe;
+    }
+
+    pe->pid = pid;
+    pe->signature.pid_dir_inode = pid_st.st_ino;
+    pe->signature.fd_dir_inode = fd_st.st_ino;
+    pe->signature.fds = fds;
+    pe->signature.fd_dir_mtime = fd_st.st_mtim;
+    pe->scanned_ut = now_ut;
+
+    if(!local_sockets_pid_entry_read_fds(ls, pe, proc_filename, pid_str, &idx->stats.fds_read)) {
+        pe->sockets = 0;
+        pe->info = LS_PID_INFO_NONE;
+        return false;
+    }
+
+    // we need the details of the process only when it has sockets
+    if(pe->sockets)
+        local_sockets_pid_entry_read_info(ls, pe, proc_filename, pid_str, needed);
+    else
+        pe->info = LS_PID_INFO_NONE;
+
+    idx->stats.pids_scanned++;
+    ls->stats.pid_index_pids_scanned++;
+    return true;
+}
+
+// index the sockets of a process for this run
+static inline void local_sockets_pid_entry_to_pid_sockets(LS_STATE *ls, LS_PID_ENTRY *pe) {
+    for(uint32_t i = 0; i < pe->sockets ; i++) {
+        uint64_t inode = pe->inodes[i];
+
+        // fprintf(stderr, "%d: PID %d is using socket inode %"PRIu64"\n", gettid_uncached(), pe->pid, inode);
+        XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
+        SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &inode, true);
+        struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(ps && !(ps->pid == 1 && pe->pid != 1))
+            continue;
+
+        if(pe->net_ns_inode && ls->config.namespaces) {
+            XXH64_hash_t net_ns_inode_hash = XXH3_64bits(&pe->net_ns_inode, sizeof(pe->net_ns_inode));
+            SIMPLE_HASHTABLE_SLOT_NET_NS *sl_ns = simple_hashtable_get_slot_NET_NS(&ls->ns_hashtable, net_ns_inode_hash, &pe->net_ns_inode, true);
+            simple_hashtable_set_slot_NET_NS(&ls->ns_hashtable, sl_ns, pe->net_ns_inode, pe->net_ns_inode);
+        }
+
+        if(!ps)
+            ps = aral_callocz(ls->pid_socket_aral);
+
+        ps->inode = inode;
+        ps->pid = pe->pid;
+        ps->ppid = ls->config.pid ? pe->ppid : 0;
+        ps->uid = ls->config.uid ? pe->uid : UID_UNSET;
+        ps->net_ns_inode = ls->config.namespaces ? pe->net_ns_inode : 0;
+        strncpyz(ps->comm, ls->config.comm ? pe->comm : "", sizeof(ps->comm) - 1);
+
+        if(ps->cmdline)
+            freez(ps->cmdline);
+
+        ps->cmdline = (ls->config.cmdline && pe->cmdline) ? strdupz(pe->cmdline) : NULL;
+        simple_hashtable_set_slot_PID_SOCKET(&ls->pid_sockets_hashtable, sl, inode_hash, ps);
+        // fprintf(stderr, "%d: PID %d indexed for using socket inode %"PRIu64"\n", gettid_uncached(), pe->pid, inode);
+    }
+}
+
 static inline bool local_sockets_find_all_sockets_in_proc(LS_STATE *ls, const char *proc_filename) {
     DIR *proc_dir;
     struct dirent *proc_entry;
-    char filename[FILENAME_MAX + 1];
-    char comm[TASK_COMM_LEN];
-    char cmdline[LOCAL_SOCKETS_CMDLINE_MAX];
-    const char *cmdline_trimmed;
-    uint64_t net_ns_inode;
+
+    // without a persistent index, we use a temporary one
+    LS_PID_INDEX *idx = ls->pid_index;
+    if(!idx)
+        idx = local_sockets_pid_index_create();
+
+    netdata_mutex_lock(&idx->mutex);
+
+    usec_t started_ut = now_monotonic_usec();
+    uint64_t generation = ++idx->generation;
 
     proc_dir = opendir(proc_filename);
     if (proc_dir == NULL) {
         local_sockets_log(ls, "cannot opendir() '%s'", proc_filename);
         ls->stats.pid_fds_readlink_failed++;
+        netdata_mutex_unlock(&idx->mutex);
+        if(!ls->pid_index)
+            local_sockets_pid_index_destroy(idx);
         return false;
     }
 
@@ -607,132 +956,60 @@ static inline bool local_sockets_find_all_sockets_in_proc(LS_STATE *ls, const ch
         if(!local_sockets_is_path_a_pid(proc_entry->d_name))
             continue;
 
-        // Build the path to the fd directory of the process
-        snprintfz(filename, FILENAME_MAX, "%s/%s/fd/", proc_filename, proc_entry->d_name);
-        DIR *fd_dir = opendir(filename);
-        if (fd_dir == NULL) {
-            local_sockets_log(ls, "cannot opendir() '%s'", filename);
-            ls->stats.pid_fds_opendir_failed++;
-            continue;
-        }
-
-        comm[0] = '\0';
-        cmdline[0] = '\0';
-        cmdline_trimmed = NULL;
         pid_t pid = (pid_t)strtoul(proc_entry->d_name, NULL, 10);
         if(!pid) {
             local_sockets_log(ls, "cannot parse pid of '%s'", proc_entry->d_name);
-            closedir(fd_dir);
             continue;
         }
-        pid_t ppid = 0;
-        bool ppid_checked = false;
-        bool status_checked = false;
-        bool status_failed = false;
-        net_ns_inode = 0;
-        uid_t uid = UID_UNSET;
-
-        struct dirent *fd_entry;
-        while ((fd_entry = readdir(fd_dir)) != NULL) {
-            if(fd_entry->d_type != DT_LNK)
-                continue;
 
-            snprintfz(filename, sizeof(filename), "%s/%s/fd/%s", proc_filename, proc_entry->d_name, fd_entry->d_name);
-            uint64_t inode = 0;
-            if(!local_sockets_read_proc_inode_link(ls, filename, &inode, "socket"))
-                continue;
+        XXH64_hash_t pid_hash = XXH3_64bits(&pid, sizeof(pid));
+        SIMPLE_HASHTABLE_SLOT_PID_ENTRY *sl = simple_hashtable_get_slot_PID_ENTRY(&idx->pids, pid_hash, &pid, true);
+        LS_PID_ENTRY *pe = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        bool is_new = (pe == NULL);
 
-            // fprintf(stderr, "%d: PID %d is using socket inode %"PRIu64"\n", gettid_uncached(), pid, inode);
-            XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
-            SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &inode, true);
-            struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl);
-            if(!ps || (ps->pid == 1 && pid != 1)) {
-                if(!status_checked && !status_failed &&
-                   ((uid == UID_UNSET && ls->config.uid) || (!ppid_checked && ls->config.pid))) {
-                    char status_buf[512];
-
-                    snprintfz(filename, sizeof(filename), "%s/%s/status", proc_filename, proc_entry->d_name);
-                    if (read_txt_file(filename, status_buf, sizeof(status_buf))) {
-                        status_failed = true;
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    }
-                    else {
-                        status_checked = true;
-                        if(ls->config.pid)
-                            ppid_checked = true;
-
-                        if(ls->config.uid) {
-                            char *u = strstr(status_buf, "Uid:");
-                            if(u) {
-                                u += 4;
-                                while(isspace((unsigned char)*u)) u++;     // skip spaces
-                                while(*u >= '0' && *u <= '9') u++;          // skip the first number (real uid)
-                                while(isspace((unsigned char)*u)) u++;     // skip spaces again
-                                uid = strtol(u, NULL, 10);   // parse the 2nd number (effective uid)
-                            }
-                        }
-
-                        if(ls->config.pid) {
-                            char *p = strstr(status_buf, "PPid:");
-                            if(p) {
-                                p += 5;
-                                while(isspace((unsigned char)*p)) p++;     // skip spaces
-                                ppid = (pid_t)strtol(p, NULL, 10);          // parse parent pid
-                            }
-                        }
-                    }
-                }
-                if(!comm[0] && ls->config.comm) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/comm", proc_filename, proc_entry->d_name);
-                    if (read_txt_file(filename, comm, sizeof(comm)))
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    else {
-                        size_t clen = strlen(comm);
-                        if(comm[clen - 1] == '\n')
-                            comm[clen - 1] = '\0';
-                    }
-                }
-                if(!cmdline[0] && ls->config.cmdline) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/cmdline", proc_filename, proc_entry->d_name);
-                    if (read_proc_cmdline(filename, cmdline, sizeof(cmdline)))
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    else {
-                        local_sockets_fix_cmdline(cmdline);
-                        cmdline_trimmed = trim(cmdline);
-                    }
-                }
-                if(!net_ns_inode && ls->config.namespaces) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/ns/net", proc_filename, proc_entry->d_name);
-                    if(local_sockets_read_proc_inode_link(ls, filename, &net_ns_inode, "net")) {
-                        XXH64_hash_t net_ns_inode_hash = XXH3_64bits(&net_ns_inode, sizeof(net_ns_inode));
-                        SIMPLE_HASHTABLE_SLOT_NET_NS *sl_ns = simple_hashtable_get_slot_NET_NS(&ls->ns_hashtable, net_ns_inode_hash, &net_ns_inode, true);
-                        simple_hashtable_set_slot_NET_NS(&ls->ns_hashtable, sl_ns, net_ns_inode, net_ns_inode);
-                    }
-                }
+        if(!local_sockets_pid_entry_update(ls, idx, &pe, pid, proc_filename, proc_entry->d_name, started_ut)) {
+            if(is_new && pe)
+                simple_hashtable_set_slot_PID_ENTRY(&idx->pids, sl, pid_hash, pe);
+            continue;
+        }
 
-                if(!ps)
-                    ps = aral_callocz(ls->pid_socket_aral);
+        if(is_new)
+            simple_hashtable_set_slot_PID_ENTRY(&idx->pids, sl, pid_hash, pe);
 
-                ps->inode = inode;
-                ps->pid = pid;
-                ps->ppid = ppid;
-                ps->uid = uid;
-                ps->net_ns_inode = net_ns_inode;
-                strncpyz(ps->comm, comm, sizeof(ps->comm) - 1);
+        pe->generation = generation;
+        local_sockets_pid_entry_to_pid_sockets(ls, pe);
+    }
 
-                if(ps->cmdline)
-                    freez(ps->cmdline);
+    closedir(proc_dir);
 
-                ps->cmdline = cmdline_trimmed ? strdupz(cmdline_trimmed) : NULL;
-                simple_hashtable_set_slot_PID_SOCKET(&ls->pid_sockets_hashtable, sl, inode_hash, ps);
-                // fprintf(stderr, "%d: PID %d indexed for using socket inode %"PRIu64"\n", gettid_uncached(), pid, inode);
-            }
+    // remove the processes that have exited
+    size_t pids = 0;
+    for(SIMPLE_HASHTABLE_SLOT_PID_ENTRY *sl = simple_hashtable_first_read_only_PID_ENTRY(&idx->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_PID_ENTRY(&idx->pids, sl)) {
+        LS_PID_ENTRY *pe = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!pe) continue;
+
+        if(pe->generation != generation) {
+            simple_hashtable_del_slot_PID_ENTRY(&idx->pids, sl);
+            local_sockets_pid_entry_free(pe);
+            idx->stats.pids_removed++;
         }
-
-        closedir(fd_dir);
+        else
+            pids++;
     }
 
-    closedir(proc_dir);
+    usec_t ended_ut = now_monotonic_usec();
+    idx->stats.scans++;
+    idx->stats.pids = pids;
+    idx->stats.scan_ut += ended_ut - started_ut;
+    idx->stats.last_scan_ut = ended_ut - started_ut;
+
+    netdata_mutex_unlock(&idx->mutex);
+
+    if(!ls->pid_index)
+        local_sockets_pid_index_destroy(idx);
+
     return true;
 }
 
@@ -0,0 +1,473 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "nd_log-internals.h"
+
+// Asynchronous output to files.
+//
+// When enabled ([logs].async = yes), the threads logging to files (stdout and stderr
+// included) do not write() their messages. Each message is formatted into its own
+// buffer and the buffer is pushed to a bounded, lock-free, multiple producers, single
+// consumer ring. A logger thread drains the ring and writes the messages in the order
+// they were queued, so the messages of every source keep their order.
+//
+// When the ring is full, or the queued messages exceed ND_LOG_ASYNC_MAX_BYTES, new
+// messages are dropped and counted per source. The logger thread reports the drops
+// to the source that lost them.
+//
+// The ring is drained before fatal messages and at exit. The log files are reopened
+// with the logger disabled and the ring drained, so no message is queued for a file
+// descriptor that is being replaced. Synchronous writes drain the ring only when it
+// still has messages (e.g. while the logger is being disabled), so they never overtake
+// queued messages.
+
+#define ND_LOG_ASYNC_SLOTS (16 * 1024) // must be a power of 2
+#define ND_LOG_ASYNC_MAX_BYTES (16 * 1024 * 1024)
+#define ND_LOG_ASYNC_IDLE_TIMEOUT_NS (1 * NSEC_PER_SEC)
+
+struct nd_log_async_slot {
+    uint64_t seq;                   // the position this slot can be claimed (seq == pos) or consumed (seq == pos + 1)
+    int fd;
+    netdata_mutex_t *mutex;
+    struct nd_log_source *source;
+    BUFFER *wb;
+};
+
+static struct {
+    bool configured;
+    bool enabled;                   // producers may queue messages
+
+    // producers between checking 'enabled' and publishing their message
+    size_t producers;
+
+    uint64_t head __attribute__((aligned(64)));    // the next position to be claimed by producers
+    uint64_t tail __attribute__((aligned(64)));    // the next position to be consumed, under 'consumer'
+    size_t bytes;                                   // the memory of the queued buffers
+
+    struct nd_log_async_slot *slots;
+
+    netdata_mutex_t consumer;       // one thread drains the ring at a time
+
+    netdata_mutex_t mutex;          // for the logger thread to sleep on
+    netdata_cond_t cond;
+    bool sleeping;
+    bool stop;
+
+    ND_THREAD *thread;
+} nd_log_async = { 0 };
+
+// the logger thread writes its own messages synchronously,
+// and nobody waits for the ring while draining it
+static __thread bool nd_log_async_bypass = false;
+
+void nd_log_set_async(bool enabled) {
+    nd_log_async.configured = enabled;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// the consumer
+
+static inline bool nd_log_async_has_messages(void) {
+    if(!nd_log_async.slots)
+        return false;
+
+    uint64_t pos = __atomic_load_n(&nd_log_async.tail, __ATOMIC_ACQUIRE);
+    struct nd_log_async_slot *slot = &nd_log_async.slots[pos & (ND_LOG_ASYNC_SLOTS - 1)];
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) == pos + 1;
+}
+
+// must be called with the consumer lock held
+static size_t nd_log_async_drain_locked(void) {
+    size_t messages = 0;
+    netdata_mutex_t *locked = NULL;
+
+    bool bypass = nd_log_async_bypass;
+    nd_log_async_bypass = true;
+
+    while(true) {
+        uint64_t pos = __atomic_load_n(&nd_log_async.tail, __ATOMIC_RELAXED);
+        struct nd_log_async_slot *slot = &nd_log_async.slots[pos & (ND_LOG_ASYNC_SLOTS - 1)];
+
+        if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1)
+            break;
+
+        int fd = slot->fd;
+        netdata_mutex_t *mutex = slot->mutex;
+        BUFFER *wb = slot->wb;
+
+        // give the slot back to the producers, for the next round of the ring
+        __atomic_store_n(&slot->seq, pos + ND_LOG_ASYNC_SLOTS, __ATOMIC_RELEASE);
+        __atomic_store_n(&nd_log_async.tail, pos + 1, __ATOMIC_RELEASE);
+
+        // keep the mutex of the destination across consecutive messages to it
+        if(mutex != locked) {
+            if(locked)
+                netdata_mutex_unlock(locked);
+
+            if(mutex)
+                netdata_mutex_lock(mutex);
+
+            locked = mutex;
+        }
+
+        nd_logger_file_write(fd, buffer_tostring(wb), buffer_strlen(wb));
+
+        __atomic_sub_fetch(&nd_log_async.bytes, wb->size, __ATOMIC_RELAXED);
+        buffer_free(wb);
+        messages++;
+    }
+
+    if(locked)
+        netdata_mutex_unlock(locked);
+
+    nd_log_async_bypass = bypass;
+
+    return messages;
+}
+
+// true when messages are queued or being written - the bytes of a message are
+// accounted before it is queued and released after it has been written
+bool nd_log_async_pending(void) {
+    return nd_log_async.slots && __atomic_load_n(&nd_log_async.bytes, __ATOMIC_ACQUIRE);
+}
+
+// write everything queued so far - this also waits for the messages
+// the logger thread has already taken, but not written yet
+void nd_log_async_flush(void) {
+    if(nd_log_async_bypass || !nd_log_async.slots)
+        return;
+
+    netdata_mutex_lock(&nd_log_async.consumer);
+    nd_log_async_drain_locked();
+    netdata_mutex_unlock(&nd_log_async.consumer);
+}
+
+static void nd_log_async_report_drops(void) {
+    for(size_t i = 0; i < _NDLS_MAX; i++) {
+        struct nd_log_source *source = &nd_log.sources[i];
+
+        uint64_t dropped = __atomic_load_n(&source->async.dropped, __ATOMIC_RELAXED);
+        if(dropped == source->async.reported)
+            continue;
+
+        nd_log(i, NDLP_WARNING,
+               "LOGS: %" PRIu64 " messages of this log have been dropped, because the asynchronous logs queue was full.",
+               dropped - source->async.reported);
+
+        source->async.reported = dropped;
+    }
+}
+
+static void nd_log_async_thread(void *ptr) {
+    (void)ptr;
+    nd_log_async_bypass = true;
+
+    while(!__atomic_load_n(&nd_log_async.stop, __ATOMIC_ACQUIRE)) {
+        netdata_mutex_lock(&nd_log_async.consumer);
+        nd_log_async_drain_locked();
+        netdata_mutex_unlock(&nd_log_async.consumer);
+
+        // the messages we log here are written synchronously, after the queued ones
+        nd_log_async_report_drops();
+
+        netdata_mutex_lock(&nd_log_async.mutex);
+        __atomic_store_n(&nd_log_async.sleeping, true, __ATOMIC_SEQ_CST);
+
+        if(!nd_log_async_has_messages() && !__atomic_load_n(&nd_log_async.stop, __ATOMIC_ACQUIRE))
+            netdata_cond_timedwait(&nd_log_async.cond, &nd_log_async.mutex, ND_LOG_ASYNC_IDLE_TIMEOUT_NS);
+
+        __atomic_store_n(&nd_log_async.sleeping, false, __ATOMIC_RELAXED);
+        netdata_mutex_unlock(&nd_log_async.mutex);
+    }
+}
+
+static void nd_log_async_wakeup(void) {
+    netdata_mutex_lock(&nd_log_async.mutex);
+    netdata_cond_signal(&nd_log_async.cond);
+    netdata_mutex_unlock(&nd_log_async.mutex);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// the producers
+
+// Queue a formatted message to be written to fd by the logger thread.
+// On true, the buffer has been taken over (queued or dropped).
+// On false, the caller has to write the message synchronously.
+bool nd_log_async_enqueue(int fd, netdata_mutex_t *mutex, struct nd_log_source *source, BUFFER *wb) {
+    if(!__atomic_load_n(&nd_log_async.enabled, __ATOMIC_RELAXED) || nd_log_async_bypass || !mutex)
+        return false;
+
+    __atomic_add_fetch(&nd_log_async.producers, 1, __ATOMIC_SEQ_CST);
+
+    // nd_log_async_disable() clears 'enabled' and then waits for the producers to leave
+    if(!__atomic_load_n(&nd_log_async.enabled, __ATOMIC_SEQ_CST)) {
+        __atomic_sub_fetch(&nd_log_async.producers, 1, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    size_t size = wb->size;
+    if(__atomic_add_fetch(&nd_log_async.bytes, size, __ATOMIC_RELAXED) > ND_LOG_ASYNC_MAX_BYTES)
+        goto drop;
+
+    uint64_t pos = __atomic_load_n(&nd_log_async.head, __ATOMIC_RELAXED);
+    struct nd_log_async_slot *slot;
+    while(true) {
+        slot = &nd_log_async.slots[pos & (ND_LOG_ASYNC_SLOTS - 1)];
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+
+        if(diff == 0) {
+            if(__atomic_compare_exchange_n(&nd_log_async.head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if(diff < 0)
+            // the consumer has not freed this slot yet, the ring is full
+            goto drop;
+        else
+            pos = __atomic_load_n(&nd_log_async.head, __ATOMIC_RELAXED);
+    }
+
+    slot->fd = fd;
+    slot->mutex = mutex;
+    slot->source = source;
+    slot->wb = wb;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_sub_fetch(&nd_log_async.producers, 1, __ATOMIC_RELEASE);
+
+    // pairs with the logger thread setting 'sleeping' before checking the ring
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&nd_log_async.sleeping, __ATOMIC_RELAXED))
+        nd_log_async_wakeup();
+
+    return true;
+
+drop:
+    __atomic_sub_fetch(&nd_log_async.bytes, size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&source->async.dropped, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&nd_log_async.producers, 1, __ATOMIC_RELEASE);
+    buffer_free(wb);
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// control
+
+void nd_log_async_start(void) {
+    if(!nd_log_async.configured || nd_log_async.thread || nd_log.single_threaded_child)
+        return;
+
+    if(!nd_log_async.slots) {
+        nd_log_async.slots = callocz(ND_LOG_ASYNC_SLOTS, sizeof(*nd_log_async.slots));
+        for(uint64_t i = 0; i < ND_LOG_ASYNC_SLOTS; i++)
+            nd_log_async.slots[i].seq = i;
+
+        netdata_mutex_init(&nd_log_async.consumer);
+        netdata_mutex_init(&nd_log_async.mutex);
+        netdata_cond_init(&nd_log_async.cond);
+    }
+
+    __atomic_store_n(&nd_log_async.stop, false, __ATOMIC_RELEASE);
+    nd_log_async.thread = nd_thread_create("LOGGER", NETDATA_THREAD_OPTION_DEFAULT, nd_log_async_thread, NULL);
+    if(!nd_log_async.thread) {
+        netdata_log_error("LOGS: cannot start the logger thread, logs will be written synchronously.");
+        return;
+    }
+
+    __atomic_store_n(&nd_log_async.enabled, true, __ATOMIC_RELEASE);
+}
+
+// queue messages again, after nd_log_async_disable()
+void nd_log_async_enable(void) {
+    if(!nd_log_async.thread || __atomic_load_n(&nd_log_async.stop, __ATOMIC_ACQUIRE))
+        return;
+
+    __atomic_store_n(&nd_log_async.enabled, true, __ATOMIC_RELEASE);
+}
+
+// stop queueing new messages and write all the queued ones
+void nd_log_async_disable(void) {
+    if(!__atomic_load_n(&nd_log_async.enabled, __ATOMIC_RELAXED))
+        return;
+
+    __atomic_store_n(&nd_log_async.enabled, false, __ATOMIC_SEQ_CST);
+
+    while(__atomic_load_n(&nd_log_async.producers, __ATOMIC_ACQUIRE))
+        tinysleep();
+
+    nd_log_async_flush();
+}
+
+void nd_log_async_stop(void) {
+    if(!nd_log_async.thread)
+        return;
+
+    nd_log_async_disable();
+
+    __atomic_store_n(&nd_log_async.stop, true, __ATOMIC_RELEASE);
+    nd_log_async_wakeup();
+
+    if(!nd_thread_is_me(nd_log_async.thread)) {
+        nd_thread_join(nd_log_async.thread);
+        nd_log_async.thread = NULL;
+
+        nd_log_async_report_drops();
+    }
+}
+
+// Forked children do not have the logger thread, and the messages queued
+// by the parent are not theirs to write.
+void nd_log_async_forget(void) {
+    __atomic_store_n(&nd_log_async.enabled, false, __ATOMIC_RELAXED);
+    nd_log_async.thread = NULL;
+    nd_log_async.slots = NULL;
+    nd_log_async.producers = 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// benchmark
+
+#define ND_LOG_ASYNC_BENCHMARK_THREADS 8
+#define ND_LOG_ASYNC_BENCHMARK_MESSAGES 100000
+
+struct nd_log_async_benchmark_thread {
+    size_t id;
+    usec_t started_ut;
+    usec_t ended_ut;
+    ND_THREAD *thread;
+};
+
+static void nd_log_async_benchmark_thread(void *ptr) {
+    struct nd_log_async_benchmark_thread *t = ptr;
+
+    t->started_ut = now_monotonic_usec();
+    for(size_t i = 0; i < ND_LOG_ASYNC_BENCHMARK_MESSAGES; i++)
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "LOGBENCH thread %zu message %zu", t->id, i);
+    t->ended_ut = now_monotonic_usec();
+}
+
+// check that every thread's messages are in order, and count them
+static bool nd_log_async_benchmark_verify(const char *filename, size_t *found) {
+    size_t next[ND_LOG_ASYNC_BENCHMARK_THREADS] = { 0 };
+    bool ok = true;
+
+    *found = 0;
+
+    FILE *fp = fopen(filename, "r");
+    if(!fp) {
+        fprintf(stderr, "cannot open '%s' to verify it\n", filename);
+        return false;
+    }
+
+    char line[4096];
+    while(fgets(line, sizeof(line), fp)) {
+        const char *s = strstr(line, "LOGBENCH thread ");
+        if(!s) continue;
+
+        size_t id, msg;
+        if(sscanf(s, "LOGBENCH thread %zu message %zu", &id, &msg) != 2 || id >= ND_LOG_ASYNC_BENCHMARK_THREADS) {
+            fprintf(stderr, "cannot parse line: %s", line);
+            ok = false;
+            continue;
+        }
+
+        if(msg < next[id]) {
+            fprintf(stderr, "thread %zu: message %zu found after message %zu\n", id, msg, next[id] - 1);
+            ok = false;
+        }
+
+        next[id] = msg + 1;
+        (*found)++;
+    }
+
+    fclose(fp);
+    return ok;
+}
+
+static bool nd_log_async_benchmark_run(bool async) {
+    char filename[FILENAME_MAX + 1];
+    snprintfz(filename, sizeof(filename) - 1, "/tmp/netdata-logbench-XXXXXX");
+
+    int fd = mkstemp(filename);
+    if(fd == -1) {
+        fprintf(stderr, "cannot create a temporary file\n");
+        return false;
+    }
+
+    struct nd_log_source *source = &nd_log.sources[NDLS_COLLECTORS];
+    struct nd_log_source saved = *source;
+
+    source->method = NDLM_FILE;
+    source->format = NDLF_LOGFMT;
+    source->min_priority = NDLP_DEBUG;
+    source->fd = fd;
+    source->fp = fdopen(fd, "w");
+    source->limits = ND_LOG_LIMITS_UNLIMITED;
+    source->async.dropped = source->async.reported = 0;
+
+    nd_log_set_async(async);
+    nd_log_async_start();
+
+    struct nd_log_async_benchmark_thread threads[ND_LOG_ASYNC_BENCHMARK_THREADS];
+    usec_t started_ut = now_monotonic_usec();
+
+    for(size_t i = 0; i < ND_LOG_ASYNC_BENCHMARK_THREADS; i++) {
+        threads[i] = (struct nd_log_async_benchmark_thread){ .id = i };
+        threads[i].thread = nd_thread_create("LOGBENCH", NETDATA_THREAD_OPTION_DONT_LOG, nd_log_async_benchmark_thread, &threads[i]);
+    }
+
+    usec_t latency_ut = 0;
+    for(size_t i = 0; i < ND_LOG_ASYNC_BENCHMARK_THREADS; i++) {
+        nd_thread_join(threads[i].thread);
+        latency_ut += threads[i].ended_ut - threads[i].started_ut;
+    }
+
+    usec_t logged_ut = now_monotonic_usec();
+
+    // the drops are counted before stopping, the stop writes their report to the file
+    uint64_t dropped = __atomic_load_n(&source->async.dropped, __ATOMIC_RELAXED);
+    nd_log_async_stop();
+    usec_t written_ut = now_monotonic_usec();
+
+    fflush(source->fp);
+
+    size_t messages = ND_LOG_ASYNC_BENCHMARK_THREADS * ND_LOG_ASYNC_BENCHMARK_MESSAGES;
+    size_t found;
+    bool ok = nd_log_async_benchmark_verify(filename, &found);
+
+    if(found + dropped != messages) {
+        fprintf(stderr, "expected %zu messages, found %zu and %" PRIu64 " dropped\n", messages, found, dropped);
+        ok = false;
+    }
+
+    fprintf(stderr,
+            "%-5s: %zu threads, %zu messages, "
+            "%.0f messages/s while logging, %.2f usec per message in the threads, "
+            "%.0f messages/s written, %" PRIu64 " dropped - %s\n",
+            async ? "async" : "sync",
+            (size_t)ND_LOG_ASYNC_BENCHMARK_THREADS, messages,
+            (double)messages * USEC_PER_SEC / (double)(logged_ut - started_ut),
+            (double)latency_ut / (double)messages,
+            (double)found * USEC_PER_SEC / (double)(written_ut - started_ut),
+            dropped,
+            ok ? "OK" : "FAILED");
+
+    fclose(source->fp);
+    unlink(filename);
+    *source = saved;
+
+    return ok;
+}
+
+int nd_log_async_benchmark(void) {
+    bool configured = nd_log_async.configured;
+
+    fprintf(stderr, "\nLogging from %d threads to a file, synchronously and asynchronously:\n\n",
+            ND_LOG_ASYNC_BENCHMARK_THREADS);
+
+    bool ok = nd_log_async_benchmark_run(false);
+    ok = nd_log_async_benchmark_run(true) && ok;
+
+    nd_log_set_async(configured);
+
+    return ok ? 0 : 1;
+}
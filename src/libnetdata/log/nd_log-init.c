@@ -300,8 +300,14 @@ void nd_log_reopen_log_files(bool log) {
     if(log)
         netdata_log_info("Reopening all log files.");
 
+    // the queued messages belong to the files we are about to close,
+    // so write them and log synchronously until the new files are open
+    nd_log_async_disable();
+
     nd_log_initialize();
 
+    nd_log_async_enable();
+
     if(log)
         netdata_log_info("Log files re-opened.");
 }
@@ -314,6 +320,7 @@ void nd_log_reopen_log_files_for_spawn_server(const char *name) {
     nd_log.fatal_hook_cb = NULL;
     nd_log.fatal_final_cb = NULL;
     nd_log.single_threaded_child = true;
+    nd_log_async_forget();
 
     gettid_uncached();
 #if defined(HAVE_LIBBACKTRACE)
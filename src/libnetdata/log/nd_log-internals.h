@@ -111,6 +111,11 @@ struct nd_log_source {
     const char *pending_msg;
     struct nd_log_limit limits;
 
+    struct {
+        uint64_t dropped;       // messages lost because the async queue was full
+        uint64_t reported;      // the dropped messages the logger thread has already logged
+    } async;
+
 #if defined(OS_WINDOWS)
     ND_LOG_SOURCES source;
     HANDLE hEventLog;
@@ -239,7 +244,18 @@ bool nd_logger_journal_libsystemd(struct log_field *fields, size_t fields_max);
 // --------------------------------------------------------------------------------------------------------------------
 // output to file
 
-bool nd_logger_file(int fd, FILE *fp, netdata_mutex_t *mutex, ND_LOG_FORMAT format, struct log_field *fields, size_t fields_max);
+bool nd_logger_file(int fd, FILE *fp, netdata_mutex_t *mutex, struct nd_log_source *source, struct log_field *fields, size_t fields_max);
+bool nd_logger_file_write(int fd, const char *buf, size_t remaining);
+
+// --------------------------------------------------------------------------------------------------------------------
+// asynchronous output to file
+
+bool nd_log_async_enqueue(int fd, netdata_mutex_t *mutex, struct nd_log_source *source, BUFFER *wb);
+bool nd_log_async_pending(void);
+void nd_log_async_flush(void);
+void nd_log_async_enable(void);
+void nd_log_async_disable(void);
+void nd_log_async_forget(void);
 
 // --------------------------------------------------------------------------------------------------------------------
 // output to windows events log
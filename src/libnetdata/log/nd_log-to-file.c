@@ -25,18 +25,47 @@ void nd_log_chown_log_files(uid_t uid, gid_t gid) {
     }
 }
 
-bool nd_logger_file(int fd, FILE *fp, netdata_mutex_t *mutex, ND_LOG_FORMAT format, struct log_field *fields, size_t fields_max) {
+// write the whole buffer to fd, the caller serializes the writes
+bool nd_logger_file_write(int fd, const char *buf, size_t remaining) {
+    while(remaining > 0) {
+        size_t chunk = remaining;
+        if(chunk > (size_t)SSIZE_MAX)
+            chunk = (size_t)SSIZE_MAX;
+
+        ssize_t written = write(fd, buf, chunk);
+        if(written > 0) {
+            buf += written;
+            remaining -= written;
+        }
+        else if(written == 0)
+            break;
+        else if(errno != EINTR)
+            break;
+    }
+
+    return remaining == 0;
+}
+
+bool nd_logger_file(int fd, FILE *fp, netdata_mutex_t *mutex, struct nd_log_source *source, struct log_field *fields, size_t fields_max) {
     (void)fp;
 
     BUFFER *wb = buffer_create(1024, NULL);
 
-    if(format == NDLF_JSON)
+    if(source->format == NDLF_JSON)
         nd_logger_json(wb, fields, fields_max);
     else
         nd_logger_logfmt(wb, fields, fields_max);
 
     buffer_strcat(wb, "\n");
 
+    // with [logs].async enabled, the logger thread writes it (see nd_log-async.c)
+    if(nd_log_async_enqueue(fd, mutex, source, wb))
+        return true;
+
+    // don't overtake messages still queued for the logger thread
+    if(unlikely(nd_log_async_pending()))
+        nd_log_async_flush();
+
     // Serialize writes with a Netdata-owned mutex and use write() on the raw fd.
     //
     // We avoid libc's stdio locking (flockfile/funlockfile) because spawn-server
@@ -49,31 +78,14 @@ bool nd_logger_file(int fd, FILE *fp, netdata_mutex_t *mutex, ND_LOG_FORMAT form
     // Logger-owned streams are configured unbuffered when opened, so the logger
     // can stay on raw fd writes here without taking stdio-internal locks.
 
-    const char *buf = buffer_tostring(wb);
-    size_t remaining = buffer_strlen(wb);
-
     if(mutex)
         netdata_mutex_lock(mutex);
 
-    while(remaining > 0) {
-        size_t chunk = remaining;
-        if(chunk > (size_t)SSIZE_MAX)
-            chunk = (size_t)SSIZE_MAX;
-
-        ssize_t written = write(fd, buf, chunk);
-        if(written > 0) {
-            buf += written;
-            remaining -= written;
-        }
-        else if(written == 0)
-            break;
-        else if(errno != EINTR)
-            break;
-    }
+    bool ret = nd_logger_file_write(fd, buffer_tostring(wb), buffer_strlen(wb));
 
     if(mutex)
         netdata_mutex_unlock(mutex);
 
     buffer_free(wb);
-    return remaining == 0;
+    return ret;
 }
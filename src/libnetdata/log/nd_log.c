@@ -229,7 +229,7 @@ static void nd_logger_log_fields(FILE *fp, int fd, netdata_mutex_t *mutex, bool
         nd_logger_syslog(priority, source->format, fields, fields_max);
 
     if(output == NDLM_FILE)
-        nd_logger_file(fd, fp, mutex, source->format, fields, fields_max);
+        nd_logger_file(fd, fp, mutex, source, fields, fields_max);
 }
 
 static void nd_logger_unset_all_thread_fields(void) {
@@ -525,6 +525,9 @@ void netdata_logger_fatal(const char *file, const char *function, const unsigned
     saved_winerror = GetLastError();
 #endif
 
+    // write the messages queued before this one, and this one synchronously
+    nd_log_async_disable();
+
     // make sure the msg id does not leak
     {
         ND_LOG_STACK lgs[] = {
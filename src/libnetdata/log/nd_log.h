@@ -22,6 +22,10 @@ void nd_log_set_priority_level(const char *setting);
 void nd_log_initialize_mutexes(void);
 void nd_log_initialize(void);
 void nd_log_reopen_log_files(bool log);
+void nd_log_set_async(bool enabled);
+void nd_log_async_start(void);
+void nd_log_async_stop(void);
+int nd_log_async_benchmark(void);
 void chown_open_file(int fd, uid_t uid, gid_t gid);
 void nd_log_chown_log_files(uid_t uid, gid_t gid);
 void nd_log_set_flood_protection(size_t logs, time_t period);
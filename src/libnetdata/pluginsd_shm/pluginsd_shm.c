@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pluginsd_shm.h"
+
+#if defined(OS_WINDOWS)
+
+PLUGINSD_SHM_RING *pluginsd_shm_producer_create(FILE *fp __maybe_unused, size_t records __maybe_unused) {
+    return NULL;
+}
+
+bool pluginsd_shm_producer_flush(PLUGINSD_SHM_RING *ring __maybe_unused) {
+    return false;
+}
+
+bool pluginsd_shm_producer_wait_for_space(PLUGINSD_SHM_RING *ring __maybe_unused) {
+    return false;
+}
+
+PLUGINSD_SHM_RING *pluginsd_shm_consumer_attach(const char *name __maybe_unused, size_t size __maybe_unused) {
+    return NULL;
+}
+
+void pluginsd_shm_destroy(PLUGINSD_SHM_RING *ring __maybe_unused) {
+    ;
+}
+
+#else // !OS_WINDOWS
+
+#include <sys/mman.h>
+
+// the time the producer waits for the agent to consume records, before giving up
+#define PLUGINSD_SHM_PRODUCER_WAIT_UT (60 * USEC_PER_SEC)
+
+static size_t pluginsd_shm_size(size_t records) {
+    return sizeof(PLUGINSD_SHM_HEADER) + records * sizeof(PLUGINSD_SHM_RECORD);
+}
+
+static bool pluginsd_shm_name_is_valid(const char *name) {
+    // a single path component, starting with a slash
+    if(!name || name[0] != '/' || !name[1] || strlen(name) >= sizeof(((PLUGINSD_SHM_RING *)0)->name))
+        return false;
+
+    for(const char *s = &name[1]; *s ; s++) {
+        if(!isalnum((uint8_t)*s) && *s != '-' && *s != '_' && *s != '.')
+            return false;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// producer
+
+PLUGINSD_SHM_RING *pluginsd_shm_producer_create(FILE *fp, size_t records) {
+    const char *env = getenv(PLUGINSD_SHM_ENV_VARIABLE);
+    if(!fp || !env || !*env || strcmp(env, "1") != 0)
+        return NULL;
+
+    if(!records)
+        records = PLUGINSD_SHM_DEFAULT_RECORDS;
+    if(records > PLUGINSD_SHM_MAX_RECORDS)
+        records = PLUGINSD_SHM_MAX_RECORDS;
+    records = 1ULL << (64 - __builtin_clzll((records - 1) | 1));
+
+    static uint32_t serial = 0;
+    char name[64];
+    snprintfz(name, sizeof(name), "/netdata-pluginsd-%d-%u", getpid(), __atomic_add_fetch(&serial, 1, __ATOMIC_RELAXED));
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if(fd == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: cannot create shared memory '%s'", name);
+        return NULL;
+    }
+
+    size_t size = pluginsd_shm_size(records);
+    void *mem = MAP_FAILED;
+    if(ftruncate(fd, (off_t)size) == 0)
+        mem = nd_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mem == MAP_FAILED) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: cannot map shared memory '%s' of %zu bytes", name, size);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    PLUGINSD_SHM_RING *ring = callocz(1, sizeof(*ring));
+    ring->header = mem;
+    ring->records = (PLUGINSD_SHM_RECORD *)((uint8_t *)mem + sizeof(PLUGINSD_SHM_HEADER));
+    ring->size = size;
+    ring->mask = records - 1;
+    ring->producer = true;
+    ring->fp = fp;
+    strncpyz(ring->name, name, sizeof(ring->name) - 1);
+
+    ring->header->magic = PLUGINSD_SHM_MAGIC;
+    ring->header->version = PLUGINSD_SHM_VERSION;
+    ring->header->record_size = sizeof(PLUGINSD_SHM_RECORD);
+    ring->header->records = (uint32_t)records;
+    __atomic_store_n(&ring->header->consumer_attached, 0, __ATOMIC_RELEASE);
+
+    fprintf(fp, PLUGINSD_KEYWORD_DATA_SHM_ATTACH " '%s' %zu\n", ring->name, ring->size);
+    fflush(fp);
+
+    return ring;
+}
+
+bool pluginsd_shm_producer_flush(PLUGINSD_SHM_RING *ring) {
+    if(!ring || !pluginsd_shm_producer_active(ring))
+        return false;
+
+    if(ring->write_pos == ring->flushed_pos)
+        return true;
+
+    __atomic_store_n(&ring->header->write_pos, ring->write_pos, __ATOMIC_RELEASE);
+    fprintf(ring->fp, PLUGINSD_KEYWORD_DATA_SHM_FLUSH " %llu\n", (unsigned long long)ring->write_pos);
+    ring->flushed_pos = ring->write_pos;
+    return true;
+}
+
+bool pluginsd_shm_producer_wait_for_space(PLUGINSD_SHM_RING *ring) {
+    // the agent consumes records only when it parses DATA_SHM_FLUSH,
+    // so we have to send what we have before waiting
+    if(!pluginsd_shm_producer_flush(ring))
+        return false;
+
+    fflush(ring->fp);
+
+    usec_t started_ut = now_monotonic_usec();
+    usec_t sleep_ut = 10;
+    while(ring->write_pos - ring->read_pos > ring->mask) {
+        if(!pluginsd_shm_producer_active(ring))
+            return false;
+
+        if(now_monotonic_usec() - started_ut > PLUGINSD_SHM_PRODUCER_WAIT_UT) {
+            nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: the agent does not consume the records of '%s'", ring->name);
+            return false;
+        }
+
+        sleep_usec(sleep_ut);
+        if(sleep_ut < 1000)
+            sleep_ut *= 2;
+
+        ring->read_pos = __atomic_load_n(&ring->header->read_pos, __ATOMIC_ACQUIRE);
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// consumer
+
+PLUGINSD_SHM_RING *pluginsd_shm_consumer_attach(const char *name, size_t size) {
+    if(!pluginsd_shm_name_is_valid(name)) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: invalid shared memory name '%s'", name ? name : "");
+        return NULL;
+    }
+
+    int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if(fd == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: cannot open shared memory '%s'", name);
+        return NULL;
+    }
+
+    // the plugin created it for us, nobody else needs to open it
+    shm_unlink(name);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || size < sizeof(PLUGINSD_SHM_HEADER) || (size_t)st.st_size != size) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: shared memory '%s' does not have the expected size %zu", name, size);
+        close(fd);
+        return NULL;
+    }
+
+    void *mem = nd_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mem == MAP_FAILED) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: cannot map shared memory '%s' of %zu bytes", name, size);
+        return NULL;
+    }
+
+    PLUGINSD_SHM_HEADER *header = mem;
+    uint32_t records = header->records;
+    if(header->magic != PLUGINSD_SHM_MAGIC || header->version != PLUGINSD_SHM_VERSION ||
+        header->record_size != sizeof(PLUGINSD_SHM_RECORD) ||
+        !records || (records & (records - 1)) || records > PLUGINSD_SHM_MAX_RECORDS ||
+        pluginsd_shm_size(records) != size) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "PLUGINSD SHM: shared memory '%s' has an invalid header", name);
+        nd_munmap(mem, size);
+        return NULL;
+    }
+
+    PLUGINSD_SHM_RING *ring = callocz(1, sizeof(*ring));
+    ring->header = header;
+    ring->records = (PLUGINSD_SHM_RECORD *)((uint8_t *)mem + sizeof(PLUGINSD_SHM_HEADER));
+    ring->size = size;
+    ring->mask = records - 1;
+    ring->read_pos = __atomic_load_n(&header->read_pos, __ATOMIC_ACQUIRE);
+    ring->producer = false;
+    strncpyz(ring->name, name, sizeof(ring->name) - 1);
+
+    __atomic_store_n(&header->consumer_attached, 1, __ATOMIC_RELEASE);
+
+    return ring;
+}
+
+// ----------------------------------------------------------------------------
+
+void pluginsd_shm_destroy(PLUGINSD_SHM_RING *ring) {
+    if(!ring)
+        return;
+
+    if(ring->producer)
+        shm_unlink(ring->name);
+    else
+        __atomic_store_n(&ring->header->consumer_attached, 0, __ATOMIC_RELEASE);
+
+    nd_munmap(ring->header, ring->size);
+    freez(ring);
+}
+
+#endif // !OS_WINDOWS
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_PLUGINSD_SHM_H
+#define NETDATA_PLUGINSD_SHM_H
+
+#include "../libnetdata.h"
+
+// A binary data plane for external plugins.
+//
+// The text protocol is used for everything (CHART, DIMENSION, FUNCTION, etc),
+// but the BEGIN/SET/END traffic of charts and dimensions defined with SLOT:
+// may be written as fixed size binary records to a single-producer,
+// single-consumer ring in shared memory:
+//
+// 1. the agent exports PLUGINSD_SHM_ENV_VARIABLE to the plugins it runs
+// 2. the plugin creates the ring and sends: DATA_SHM_ATTACH <name> <size>
+// 3. the agent maps it and sets consumer_attached in its header
+//    (until the plugin sees this, it continues using the text protocol)
+// 4. the plugin appends records and publishes them with: DATA_SHM_FLUSH <write_pos>
+//    the agent processes all records up to write_pos when it parses this line,
+//    so records are always ordered with the text lines around them.
+
+#define PLUGINSD_SHM_ENV_VARIABLE       "NETDATA_PLUGINSD_SHM"
+#define PLUGINSD_SHM_MAGIC              0x4e445053U         // NDPS
+#define PLUGINSD_SHM_VERSION            1
+#define PLUGINSD_SHM_DEFAULT_RECORDS    (64 * 1024)
+#define PLUGINSD_SHM_MAX_RECORDS        (16 * 1024 * 1024)
+
+typedef enum __attribute__((packed)) {
+    PLUGINSD_SHM_RECORD_BEGIN       = 1,    // slot = chart slot, u64 = microseconds since the last collection (0 = unknown)
+    PLUGINSD_SHM_RECORD_SET         = 2,    // slot = dimension slot, i64 or f64 = the collected value
+    PLUGINSD_SHM_RECORD_END         = 3,    // u64 = collection time in microseconds (0 = now)
+} PLUGINSD_SHM_RECORD_TYPE;
+
+typedef enum __attribute__((packed)) {
+    PLUGINSD_SHM_FLAG_NONE          = 0,
+    PLUGINSD_SHM_FLAG_DOUBLE        = (1 << 0), // SET: the value is f64, otherwise i64
+    PLUGINSD_SHM_FLAG_EMPTY         = (1 << 1), // SET: the dimension has not been collected
+    PLUGINSD_SHM_FLAG_PENDING_NEXT  = (1 << 2), // END: the same as the 3rd parameter of END
+} PLUGINSD_SHM_RECORD_FLAGS;
+
+typedef struct pluginsd_shm_record {
+    uint8_t type;                   // PLUGINSD_SHM_RECORD_TYPE
+    uint8_t flags;                  // PLUGINSD_SHM_RECORD_FLAGS
+    uint16_t reserved;
+    uint32_t slot;
+    union {
+        uint64_t u64;
+        int64_t i64;
+        double f64;
+    };
+} PLUGINSD_SHM_RECORD;
+
+_Static_assert(sizeof(PLUGINSD_SHM_RECORD) == 16, "PLUGINSD_SHM_RECORD must be 16 bytes");
+
+typedef struct pluginsd_shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t records;               // the capacity of the ring, a power of 2
+    uint32_t consumer_attached;     // written by the agent
+
+    // each side writes its position on its own cache line
+    PAD64(uint64_t) write_pos;      // written by the plugin
+    PAD64(uint64_t) read_pos;       // written by the agent
+    uint8_t padding_end[64 - sizeof(uint64_t)];
+} PLUGINSD_SHM_HEADER;
+
+typedef struct pluginsd_shm_ring {
+    PLUGINSD_SHM_HEADER *header;
+    PLUGINSD_SHM_RECORD *records;
+    size_t size;                    // the size of the mapping
+    uint64_t mask;
+
+    // the local copies of the positions, for the side that owns them
+    uint64_t write_pos;             // producer: records appended, not published yet
+    uint64_t flushed_pos;           // producer: the last position sent to the agent
+    uint64_t read_pos;              // consumer: records processed, producer: the last read_pos seen
+
+    bool producer;
+    FILE *fp;                       // producer: where DATA_SHM_FLUSH is written
+    char name[64];
+} PLUGINSD_SHM_RING;
+
+// ----------------------------------------------------------------------------
+// producer API, for plugins
+
+// create a ring and send the attach request to the agent
+// it returns NULL when the agent does not support the data plane, or the ring cannot be created
+PLUGINSD_SHM_RING *pluginsd_shm_producer_create(FILE *fp, size_t records);
+
+// true when the agent is consuming the ring, so that the plugin can stop using text for data
+static inline bool pluginsd_shm_producer_active(PLUGINSD_SHM_RING *ring) {
+    return ring && __atomic_load_n(&ring->header->consumer_attached, __ATOMIC_ACQUIRE);
+}
+
+// publish the pending records and send DATA_SHM_FLUSH
+// call it before writing any text that should be processed after the records,
+// and before flushing the output of the plugin at the end of each iteration
+bool pluginsd_shm_producer_flush(PLUGINSD_SHM_RING *ring);
+
+// make room in the ring, flushing and waiting for the agent if needed
+bool pluginsd_shm_producer_wait_for_space(PLUGINSD_SHM_RING *ring);
+
+static inline bool pluginsd_shm_producer_append(PLUGINSD_SHM_RING *ring, PLUGINSD_SHM_RECORD_TYPE type, PLUGINSD_SHM_RECORD_FLAGS flags, uint32_t slot, uint64_t u64) {
+    if(unlikely(ring->write_pos - ring->read_pos > ring->mask)) {
+        ring->read_pos = __atomic_load_n(&ring->header->read_pos, __ATOMIC_ACQUIRE);
+        if(unlikely(ring->write_pos - ring->read_pos > ring->mask && !pluginsd_shm_producer_wait_for_space(ring)))
+            return false;
+    }
+
+    PLUGINSD_SHM_RECORD *r = &ring->records[ring->write_pos & ring->mask];
+    r->type = type;
+    r->flags = flags;
+    r->reserved = 0;
+    r->slot = slot;
+    r->u64 = u64;
+    ring->write_pos++;
+    return true;
+}
+
+static inline bool pluginsd_shm_begin(PLUGINSD_SHM_RING *ring, uint32_t chart_slot, usec_t microseconds) {
+    return pluginsd_shm_producer_append(ring, PLUGINSD_SHM_RECORD_BEGIN, PLUGINSD_SHM_FLAG_NONE, chart_slot, microseconds);
+}
+
+static inline bool pluginsd_shm_set_int(PLUGINSD_SHM_RING *ring, uint32_t dimension_slot, int64_t value) {
+    return pluginsd_shm_producer_append(ring, PLUGINSD_SHM_RECORD_SET, PLUGINSD_SHM_FLAG_NONE, dimension_slot, (uint64_t)value);
+}
+
+static inline bool pluginsd_shm_set_double(PLUGINSD_SHM_RING *ring, uint32_t dimension_slot, double value) {
+    uint64_t u64;
+    memcpy(&u64, &value, sizeof(u64));
+    return pluginsd_shm_producer_append(ring, PLUGINSD_SHM_RECORD_SET, PLUGINSD_SHM_FLAG_DOUBLE, dimension_slot, u64);
+}
+
+static inline bool pluginsd_shm_set_empty(PLUGINSD_SHM_RING *ring, uint32_t dimension_slot) {
+    return pluginsd_shm_producer_append(ring, PLUGINSD_SHM_RECORD_SET, PLUGINSD_SHM_FLAG_EMPTY, dimension_slot, 0);
+}
+
+static inline bool pluginsd_shm_end(PLUGINSD_SHM_RING *ring, usec_t collected_ut, bool pending_rrdset_next) {
+    return pluginsd_shm_producer_append(ring, PLUGINSD_SHM_RECORD_END,
+                                        pending_rrdset_next ? PLUGINSD_SHM_FLAG_PENDING_NEXT : PLUGINSD_SHM_FLAG_NONE,
+                                        0, collected_ut);
+}
+
+// ----------------------------------------------------------------------------
+// consumer API, for the agent
+
+// map the ring the plugin has created, and tell it we consume it
+PLUGINSD_SHM_RING *pluginsd_shm_consumer_attach(const char *name, size_t size);
+
+// validate a DATA_SHM_FLUSH position; returns the number of records to consume, or -1 when it is invalid
+static inline ssize_t pluginsd_shm_consumer_pending(PLUGINSD_SHM_RING *ring, uint64_t flushed_pos) {
+    uint64_t write_pos = __atomic_load_n(&ring->header->write_pos, __ATOMIC_ACQUIRE);
+    if(unlikely(flushed_pos > write_pos || flushed_pos < ring->read_pos || flushed_pos - ring->read_pos > ring->mask + 1))
+        return -1;
+
+    return (ssize_t)(flushed_pos - ring->read_pos);
+}
+
+// the next record to consume; the caller must have checked pluginsd_shm_consumer_pending()
+// we copy it, because the plugin owns the memory and may not be trusted
+static inline PLUGINSD_SHM_RECORD pluginsd_shm_consumer_next(PLUGINSD_SHM_RING *ring) {
+    PLUGINSD_SHM_RECORD r = ring->records[ring->read_pos & ring->mask];
+    ring->read_pos++;
+    return r;
+}
+
+// give the space of the consumed records back to the plugin
+static inline void pluginsd_shm_consumer_release(PLUGINSD_SHM_RING *ring) {
+    __atomic_store_n(&ring->header->read_pos, ring->read_pos, __ATOMIC_RELEASE);
+}
+
+// ----------------------------------------------------------------------------
+
+// unmap the ring; the producer also removes the shared memory object
+void pluginsd_shm_destroy(PLUGINSD_SHM_RING *ring);
+
+#endif //NETDATA_PLUGINSD_SHM_H
@@ -151,6 +151,109 @@ static inline void procfile_lines_free(pflines *fl) {
 }
 
 
+// ----------------------------------------------------------------------------
+// Skipping words in blocks of bytes
+//
+// Most of the bytes of /proc files are part of words. Instead of looking up
+// every byte in the separators table, the parser skips runs of word bytes in
+// blocks, stopping at the first byte that may not be a word byte: any byte
+// up to space, DEL, and the printable characters the caller has made special
+// (separators, quotes, open/close). Bytes with the high bit set are always
+// words. The parser then continues with the separators table, so stopping
+// early never changes the result.
+
+static bool procfile_fast_skip_enabled = true;
+
+static void procfile_fast_skip_update(procfile *ff) {
+    size_t count = 0;
+
+    for(size_t i = '!'; i < 256 ; i++) {
+        if(likely(ff->separators[i] == PF_CHAR_IS_WORD) || i == 0x7f)
+            continue;
+
+        if(count == PROCFILE_FAST_SKIP_MAX_CHARS) {
+            // too many, the byte by byte parser is faster
+            ff->fast_skip_chars_count = 0;
+            return;
+        }
+
+        ff->fast_skip_chars[count++] = (uint8_t)i;
+    }
+
+    // always have at least one, so that 0 means disabled
+    if(!count)
+        ff->fast_skip_chars[count++] = ' ';
+
+    ff->fast_skip_chars_count = count;
+}
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+ALWAYS_INLINE
+static char *procfile_skip_words(procfile *ff, char *s, char *e) {
+    const __m128i below = _mm_set1_epi8(0x21 - 0x80);
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i flip = _mm_set1_epi8((char)0x80);
+
+    while(s + 16 <= e) {
+        __m128i v = _mm_loadu_si128((const __m128i *)s);
+
+        // signed compare, after flipping the high bit, is an unsigned compare
+        __m128i m = _mm_or_si128(_mm_cmplt_epi8(_mm_xor_si128(v, flip), below), _mm_cmpeq_epi8(v, del));
+        for(size_t i = 0; i < ff->fast_skip_chars_count ; i++)
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)ff->fast_skip_chars[i])));
+
+        unsigned mask = (unsigned)_mm_movemask_epi8(m);
+        if(mask)
+            return s + __builtin_ctz(mask);
+
+        s += 16;
+    }
+
+    return s;
+}
+
+#else // !__SSE2__
+
+#define PF_SWAR_ONES (~(uint64_t)0 / 255)
+#define PF_SWAR_HIGHS (PF_SWAR_ONES * 0x80)
+
+ALWAYS_INLINE
+static uint64_t procfile_swar_zero_bytes(uint64_t v) {
+    return (v - PF_SWAR_ONES) & ~v & PF_SWAR_HIGHS;
+}
+
+ALWAYS_INLINE
+static char *procfile_skip_words(procfile *ff, char *s, char *e) {
+    while(s + 8 <= e) {
+        uint64_t v;
+        memcpy(&v, s, sizeof(v));
+
+        // bytes below 0x21 (bytes with the high bit set are excluded by ~v), and DEL
+        uint64_t m = ((v - PF_SWAR_ONES * 0x21) & ~v & PF_SWAR_HIGHS) |
+                     procfile_swar_zero_bytes(v ^ (PF_SWAR_ONES * 0x7f));
+
+        for(size_t i = 0; i < ff->fast_skip_chars_count ; i++)
+            m |= procfile_swar_zero_bytes(v ^ (PF_SWAR_ONES * ff->fast_skip_chars[i]));
+
+        if(m) {
+            // false positives may only appear above a true one, so the lowest is exact
+#if BYTE_ORDER == LITTLE_ENDIAN
+            return s + (__builtin_ctzll(m) / 8);
+#else
+            return s + (__builtin_clzll(m) / 8);
+#endif
+        }
+
+        s += 8;
+    }
+
+    return s;
+}
+
+#endif // !__SSE2__
+
 // ----------------------------------------------------------------------------
 // The procfile
 
@@ -181,6 +284,8 @@ static void procfile_parser(procfile *ff) {
     char quote = 0;                     // the quote character - only when in quoted string
     size_t opened = 0;                  // counts the number of open parenthesis
 
+    bool fast_skip = procfile_fast_skip_enabled && ff->fast_skip_chars_count;
+
     uint32_t *line_words = procfile_lines_add(ff);
 
     while(s < e) {
@@ -190,6 +295,9 @@ static void procfile_parser(procfile *ff) {
         // read more here: http://lazarenko.me/switch/
         if(likely(ct == PF_CHAR_IS_WORD)) {
             s++;
+
+            if(likely(fast_skip))
+                s = procfile_skip_words(ff, s, e);
         }
         else if(likely(ct == PF_CHAR_IS_SEPARATOR)) {
             if(!quote && !opened) {
@@ -316,7 +424,21 @@ procfile *procfile_readall(procfile *ff) {
 
         // netdata_log_info("Reading file '%s', from position %zd with length %zd", procfile_filename(ff), s, (ssize_t)(ff->size - s));
         ff->stats.reads++;
-        r = read(ff->fd, &ff->data[s], ff->size - s);
+
+        // pread() does not need to rewind the file after reading it
+        if(likely(!(ff->flags & PROCFILE_FLAG_NONSEEKABLE))) {
+            r = pread(ff->fd, &ff->data[s], ff->size - s, (off_t)s);
+
+            // Some procfs files (Ubuntu HWE 24.04 / kernel 6.14) may be non-seekable.
+            // Nothing has been read yet, so we can read them sequentially and reopen them.
+            if(unlikely(r == -1 && !s && (errno == ESPIPE || errno == EINVAL))) {
+                ff->flags |= PROCFILE_FLAG_NONSEEKABLE;
+                r = read(ff->fd, &ff->data[s], ff->size - s);
+            }
+        }
+        else
+            r = read(ff->fd, &ff->data[s], ff->size - s);
+
         if(unlikely(r == -1)) {
             if(unlikely(!(ff->flags & PROCFILE_FLAG_NO_ERROR_ON_FILE_IO))) collector_error(PF_PREFIX ": Cannot read from file '%s' on fd %d", procfile_filename(ff), ff->fd);
             else if(unlikely(ff->flags & PROCFILE_FLAG_ERROR_ON_ERROR_LOG))
@@ -330,29 +452,13 @@ procfile *procfile_readall(procfile *ff) {
 
         ff->len += r;
     }
-    
+
     if (unlikely(ff->flags & PROCFILE_FLAG_NONSEEKABLE)) {
+        // "rewind" by reopening
         char *fn = procfile_filename(ff);
         ff = procfile_reopen(ff, fn, NULL, ff->flags);
         if (unlikely(!ff))
             return NULL;
-    } else if (unlikely(lseek(ff->fd, 0, SEEK_SET) == -1)) {
-        // Some procfs files (Ubuntu HWE 24.04 / kernel 6.14) may be non-seekable.
-        // In that case, "rewind" by reopening.
-        if (errno == ESPIPE || errno == EINVAL) {
-            ff->flags |= PROCFILE_FLAG_NONSEEKABLE;
-            char *fn = procfile_filename(ff);
-            ff = procfile_reopen(ff, fn, NULL, ff->flags);
-            if (unlikely(!ff))
-                return NULL;
-        } else {
-            if (unlikely(!(ff->flags & PROCFILE_FLAG_NO_ERROR_ON_FILE_IO)))
-                collector_error(PF_PREFIX ": Cannot rewind on file '%s'.", procfile_filename(ff));
-            else if (unlikely(ff->flags & PROCFILE_FLAG_ERROR_ON_ERROR_LOG))
-                netdata_log_error(PF_PREFIX ": Cannot rewind on file '%s'.", procfile_filename(ff));
-            procfile_close(ff);
-            return NULL;
-        }
     }
 
     procfile_lines_reset(ff->lines);
@@ -408,6 +514,8 @@ static void procfile_set_separators(procfile *ff, const char *separators) {
     const char *s = separators;
     while(*s)
         ffs[(int)*s++] = PF_CHAR_IS_SEPARATOR;
+
+    procfile_fast_skip_update(ff);
 }
 
 void procfile_set_quotes(procfile *ff, const char *quotes) {
@@ -419,14 +527,12 @@ void procfile_set_quotes(procfile *ff, const char *quotes) {
         if(unlikely(ffs[i] == PF_CHAR_IS_QUOTE))
             ffs[i] = PF_CHAR_IS_WORD;
 
-    // if nothing given, return
-    if(unlikely(!quotes || !*quotes))
-        return;
-
     // set the quotes
-    const char *s = quotes;
+    const char *s = (quotes) ? quotes : "";
     while(*s)
         ffs[(int)*s++] = PF_CHAR_IS_QUOTE;
+
+    procfile_fast_skip_update(ff);
 }
 
 void procfile_set_open_close(procfile *ff, const char *open, const char *close) {
@@ -438,19 +544,20 @@ void procfile_set_open_close(procfile *ff, const char *open, const char *close)
         if(unlikely(ffs[i] == PF_CHAR_IS_OPEN || ffs[i] == PF_CHAR_IS_CLOSE))
             ffs[i] = PF_CHAR_IS_WORD;
 
-    // if nothing given, return
-    if(unlikely(!open || !*open || !close || !*close))
-        return;
-
-    // set the openings
-    const char *s = open;
-    while(*s)
-        ffs[(int)*s++] = PF_CHAR_IS_OPEN;
+    // set them, if given
+    if(likely(open && *open && close && *close)) {
+        // set the openings
+        const char *s = open;
+        while(*s)
+            ffs[(int)*s++] = PF_CHAR_IS_OPEN;
+
+        // set the closings
+        s = close;
+        while(*s)
+            ffs[(int)*s++] = PF_CHAR_IS_CLOSE;
+    }
 
-    // set the closings
-    s = close;
-    while(*s)
-        ffs[(int)*s++] = PF_CHAR_IS_CLOSE;
+    procfile_fast_skip_update(ff);
 }
 
 procfile *procfile_open(const char *filename, const char *separators, uint32_t flags) {
@@ -547,3 +654,189 @@ void procfile_print(procfile *ff) {
         }
     }
 }
+
+// ----------------------------------------------------------------------------
+// unittest and benchmark
+
+static struct {
+    const char *filename;
+    const char *separators;
+    const char *quotes;
+    const char *open;
+    const char *close;
+} procfile_unittest_files[] = {
+    { "/proc/stat",             " \t",     NULL,   NULL,   NULL },
+    { "/proc/meminfo",          " \t:",    NULL,   NULL,   NULL },
+    { "/proc/vmstat",           " \t:",    NULL,   NULL,   NULL },
+    { "/proc/diskstats",        " \t",     NULL,   NULL,   NULL },
+    { "/proc/interrupts",       " \t:",    NULL,   NULL,   NULL },
+    { "/proc/net/dev",          " \t,|",   NULL,   NULL,   NULL },
+    { "/proc/net/snmp",         " \t:",    NULL,   NULL,   NULL },
+    { "/proc/net/netstat",      " \t:",    NULL,   NULL,   NULL },
+    { "/proc/net/tcp",          " \t:",    NULL,   NULL,   NULL },
+    { "/proc/self/mountinfo",   " \t",     NULL,   NULL,   NULL },
+    { "/proc/self/status",      " \t:,-()/", NULL, NULL,   NULL },
+    { "/proc/self/stat",        " ",        NULL,   "(",    ")"  },
+    { "/proc/self/cgroup",      " \t:",    NULL,   NULL,   NULL },
+};
+
+// parse a snapshot of a file again, from memory
+static void procfile_unittest_parse(procfile *ff, const char *snapshot, size_t len) {
+    memcpy(ff->data, snapshot, len);
+    ff->len = len;
+    procfile_lines_reset(ff->lines);
+    procfile_words_reset(ff->words);
+    procfile_parser(ff);
+}
+
+int procfile_unittest(void) {
+    size_t files = _countof(procfile_unittest_files);
+    procfile *ffs[files];
+    char *snapshots[files];
+    size_t lens[files];
+    int errors = 0;
+
+    fprintf(stderr, "\nprocfile: capturing snapshots...\n");
+
+    size_t captured = 0;
+    for(size_t i = 0; i < files ; i++) {
+        ffs[i] = procfile_open(procfile_unittest_files[i].filename, procfile_unittest_files[i].separators, PROCFILE_FLAG_NO_ERROR_ON_FILE_IO);
+        if(ffs[i]) {
+            procfile_set_quotes(ffs[i], procfile_unittest_files[i].quotes);
+            procfile_set_open_close(ffs[i], procfile_unittest_files[i].open, procfile_unittest_files[i].close);
+            ffs[i] = procfile_readall(ffs[i]);
+        }
+
+        if(!ffs[i]) {
+            fprintf(stderr, "  %-25s: not available, skipped\n", procfile_unittest_files[i].filename);
+            snapshots[i] = NULL;
+            lens[i] = 0;
+            continue;
+        }
+
+        // keep a copy of the file as it was read, since the parser changes the data
+        procfile *ff = ffs[i];
+        snapshots[i] = mallocz(ff->size);
+        lens[i] = 0;
+        ssize_t r;
+        while(lens[i] < ff->size && (r = pread(ff->fd, &snapshots[i][lens[i]], ff->size - lens[i], (off_t)lens[i])) > 0)
+            lens[i] += r;
+
+        if(!lens[i] || lens[i] == ff->size) {
+            fprintf(stderr, "  %-25s: cannot take a snapshot, skipped\n", procfile_unittest_files[i].filename);
+            freez(snapshots[i]);
+            snapshots[i] = NULL;
+            continue;
+        }
+
+        fprintf(stderr, "  %-25s: %zu bytes, %zu lines, %zu words, %s\n",
+                procfile_unittest_files[i].filename, lens[i], procfile_lines(ff), ff->words->len,
+                ff->fast_skip_chars_count ? "fast skip" : "byte by byte");
+        captured++;
+    }
+
+    if(!captured) {
+        fprintf(stderr, "procfile: no files could be captured\n");
+        return 1;
+    }
+
+    // verify that skipping words in blocks gives the same results
+    fprintf(stderr, "\nprocfile: verifying the parser...\n");
+
+    for(size_t i = 0; i < files ; i++) {
+        if(!snapshots[i]) continue;
+        procfile *ff = ffs[i];
+
+        procfile_fast_skip_enabled = false;
+        procfile_unittest_parse(ff, snapshots[i], lens[i]);
+        size_t lines = procfile_lines(ff), words = ff->words->len;
+        ffline *expected_lines = mallocz(lines * sizeof(ffline) + 1);
+        memcpy(expected_lines, ff->lines->lines, lines * sizeof(ffline));
+        char **expected_words = mallocz(words * sizeof(char *) + 1);
+        for(size_t w = 0; w < words ; w++)
+            expected_words[w] = strdupz(ff->words->words[w]);
+
+        procfile_fast_skip_enabled = true;
+        procfile_unittest_parse(ff, snapshots[i], lens[i]);
+
+        if(procfile_lines(ff) != lines || ff->words->len != words ||
+            memcmp(expected_lines, ff->lines->lines, lines * sizeof(ffline)) != 0) {
+            fprintf(stderr, "  %-25s: FAILED, expected %zu lines and %zu words, got %zu lines and %zu words\n",
+                    procfile_unittest_files[i].filename, lines, words, procfile_lines(ff), ff->words->len);
+            errors++;
+        }
+        else {
+            for(size_t w = 0; w < words ; w++) {
+                if(strcmp(expected_words[w], ff->words->words[w]) != 0) {
+                    fprintf(stderr, "  %-25s: FAILED, word %zu is '%s', expected '%s'\n",
+                            procfile_unittest_files[i].filename, w, ff->words->words[w], expected_words[w]);
+                    errors++;
+                    break;
+                }
+            }
+        }
+
+        for(size_t w = 0; w < words ; w++)
+            freez(expected_words[w]);
+        freez(expected_words);
+        freez(expected_lines);
+    }
+
+    // benchmark the parser on the snapshots
+    fprintf(stderr, "\nprocfile: benchmarking the parser...\n");
+
+    const size_t iterations = 2000;
+    for(int fast = 0; fast <= 1 ; fast++) {
+        procfile_fast_skip_enabled = fast;
+
+        size_t total_words = 0, total_bytes = 0;
+        usec_t started_ut = now_monotonic_usec();
+        for(size_t it = 0; it < iterations ; it++) {
+            for(size_t i = 0; i < files ; i++) {
+                if(!snapshots[i]) continue;
+                procfile_unittest_parse(ffs[i], snapshots[i], lens[i]);
+                total_words += ffs[i]->words->len;
+                total_bytes += lens[i];
+            }
+        }
+        usec_t dt_ut = now_monotonic_usec() - started_ut;
+        if(!dt_ut) dt_ut = 1;
+
+        fprintf(stderr, "  %-12s: %zu words in %"PRIu64" usec, %.2f M words/s, %.2f MiB/s\n",
+                fast ? "fast skip" : "byte by byte", total_words, dt_ut,
+                (double)total_words / (double)dt_ut,
+                (double)total_bytes * USEC_PER_SEC / (double)dt_ut / 1024.0 / 1024.0);
+    }
+    procfile_fast_skip_enabled = true;
+
+    // benchmark reading and parsing the live files
+    fprintf(stderr, "\nprocfile: benchmarking reading and parsing...\n");
+    {
+        size_t total_files = 0, total_words = 0;
+        usec_t started_ut = now_monotonic_usec();
+        for(size_t it = 0; it < iterations / 10 ; it++) {
+            for(size_t i = 0; i < files ; i++) {
+                if(!ffs[i]) continue;
+                ffs[i] = procfile_readall(ffs[i]);
+                if(!ffs[i]) continue;
+                total_words += ffs[i]->words->len;
+                total_files++;
+            }
+        }
+        usec_t dt_ut = now_monotonic_usec() - started_ut;
+        if(!dt_ut) dt_ut = 1;
+
+        fprintf(stderr, "  %-12s: %zu files in %"PRIu64" usec, %.0f files/s, %.2f M words/s\n",
+                "readall", total_files, dt_ut,
+                (double)total_files * USEC_PER_SEC / (double)dt_ut,
+                (double)total_words / (double)dt_ut);
+    }
+
+    for(size_t i = 0; i < files ; i++) {
+        freez(snapshots[i]);
+        procfile_close(ffs[i]);
+    }
+
+    fprintf(stderr, "\nprocfile: %s\n", errors ? "FAILED" : "OK");
+    return errors ? 1 : 0;
+}
@@ -38,6 +38,10 @@ typedef struct {
 #define PROCFILE_FLAG_ERROR_ON_ERROR_LOG  0x00000002 // Store inside `error.log`
 #define PROCFILE_FLAG_NONSEEKABLE         0x00000004 // File doesn't support lseek(), reopen instead
 
+// the max number of printable characters that are not part of words (separators, quotes, open/close)
+// for which the parser can skip words in blocks of bytes
+#define PROCFILE_FAST_SKIP_MAX_CHARS 8
+
 typedef enum __attribute__ ((__packed__)) procfile_separator {
     PF_CHAR_IS_SEPARATOR,
     PF_CHAR_IS_NEWLINE,
@@ -71,6 +75,8 @@ typedef struct procfile {
     pflines *lines;
     pfwords *words;
     PF_CHAR_TYPE separators[256];
+    uint8_t fast_skip_chars_count;  // 0 = disabled
+    uint8_t fast_skip_chars[PROCFILE_FAST_SKIP_MAX_CHARS];
     struct procfile_stats stats;
     char data[];                    // allocated buffer to keep file contents
 } procfile;
@@ -91,6 +97,9 @@ procfile *procfile_reopen(procfile *ff, const char *filename, const char *separa
 // example walk-through a procfile parsed file
 void procfile_print(procfile *ff);
 
+// verify the parser and benchmark it on snapshots of /proc files
+int procfile_unittest(void);
+
 void procfile_set_quotes(procfile *ff, const char *quotes);
 void procfile_set_open_close(procfile *ff, const char *open, const char *close);
 
@@ -2,6 +2,11 @@
 
 #include "../libnetdata.h"
 
+// lists with at least this many patterns are compiled into automata
+#define SIMPLE_PATTERN_COMPILE_MIN_PATTERNS 16
+
+struct simple_pattern_compiled;
+
 struct simple_pattern {
     const char *match;
     uint32_t len;
@@ -12,8 +17,14 @@ struct simple_pattern {
 
     struct simple_pattern *child;
     struct simple_pattern *next;
+
+    // only on the first pattern of a list, when the list is compiled
+    struct simple_pattern_compiled *compiled;
 };
 
+static struct simple_pattern_compiled *simple_pattern_compile(struct simple_pattern *root);
+static void simple_pattern_compiled_free(struct simple_pattern_compiled *c);
+
 static struct simple_pattern *parse_pattern(char *str, SIMPLE_PREFIX_MODE default_mode, size_t count) {
     if(unlikely(count >= 1000))
         return NULL;
@@ -165,6 +176,10 @@ SIMPLE_PATTERN *simple_pattern_create(const char *list, const char *separators,
     }
 
     freez(buf);
+
+    if(root)
+        root->compiled = simple_pattern_compile(root);
+
     return (SIMPLE_PATTERN *)root;
 }
 
@@ -282,8 +297,8 @@ static bool match_pattern(struct simple_pattern *m, const char *str, size_t len,
 }
 
 ALWAYS_INLINE
-static SIMPLE_PATTERN_RESULT simple_pattern_matches_extract_with_length(SIMPLE_PATTERN *list, const char *str, size_t len, char *wildcarded, size_t wildcarded_size) {
-    struct simple_pattern *m, *root = (struct simple_pattern *)list;
+static SIMPLE_PATTERN_RESULT simple_pattern_matches_linear(struct simple_pattern *root, const char *str, size_t len, char *wildcarded, size_t wildcarded_size) {
+    struct simple_pattern *m;
 
     for(m = root; m ; m = m->next) {
         char *ws = wildcarded;
@@ -299,6 +314,346 @@ static SIMPLE_PATTERN_RESULT simple_pattern_matches_extract_with_length(SIMPLE_P
     return SP_NOT_MATCHED;
 }
 
+// ----------------------------------------------------------------------------
+// compiled lists
+//
+// The patterns of large lists are indexed by their position in the list:
+//  - exact and prefix patterns in a trie, walked from the start of the string
+//  - suffix patterns in a trie of the reversed patterns, walked from the end of the string
+//  - substring patterns in an Aho-Corasick automaton, scanning the string once
+//  - patterns with asterisks in the middle are indexed by their first part, in the prefix trie or
+//    the aho-corasick automaton, and are evaluated with match_pattern() only when their first part
+//    is found in the string
+//
+// Each of them finds the lowest position matching the string, so the result is the
+// same with the linear evaluation: the first pattern of the list that matches wins.
+
+#define SP_POS_NONE UINT32_MAX
+
+struct sp_trie_node {
+    uint32_t pos;               // the lowest position of the patterns ending at this node (or at its fail chain)
+    uint32_t exact;             // the lowest position of the exact patterns ending at this node
+    uint32_t fail;              // aho-corasick only
+    uint32_t edges;
+    uint8_t *bytes;
+    uint32_t *next;
+
+    // the positions of the patterns with asterisks in the middle, having their first part ending here
+    uint32_t candidates_count;
+    uint32_t *candidates;
+};
+
+struct sp_trie {
+    struct sp_trie_node *nodes;
+    uint32_t used;
+    uint32_t size;
+    uint32_t min_pos;           // the lowest position of all the patterns in the trie
+};
+
+struct simple_pattern_compiled {
+    uint8_t fold[256];
+
+    uint32_t match_all;         // the lowest position of the patterns matching everything
+
+    struct sp_trie prefix;      // exact and prefix patterns
+    struct sp_trie suffix;      // suffix patterns, reversed
+    struct sp_trie substring;   // substring patterns
+
+    struct simple_pattern **patterns;
+};
+
+static uint32_t sp_trie_node_new(struct sp_trie *t) {
+    if(t->used == t->size) {
+        t->size = t->size ? t->size * 2 : 64;
+        t->nodes = reallocz(t->nodes, t->size * sizeof(*t->nodes));
+    }
+
+    struct sp_trie_node *n = &t->nodes[t->used];
+    memset(n, 0, sizeof(*n));
+    n->pos = SP_POS_NONE;
+    n->exact = SP_POS_NONE;
+    return t->used++;
+}
+
+static void sp_trie_init(struct sp_trie *t) {
+    memset(t, 0, sizeof(*t));
+    t->min_pos = SP_POS_NONE;
+    sp_trie_node_new(t);
+}
+
+static void sp_trie_free(struct sp_trie *t) {
+    for(uint32_t i = 0; i < t->used; i++) {
+        freez(t->nodes[i].bytes);
+        freez(t->nodes[i].next);
+        freez(t->nodes[i].candidates);
+    }
+    freez(t->nodes);
+    memset(t, 0, sizeof(*t));
+}
+
+// the child of a node for a byte, or 0 (the root is never a child)
+ALWAYS_INLINE
+static uint32_t sp_trie_child(struct sp_trie *t, uint32_t node, uint8_t c) {
+    struct sp_trie_node *n = &t->nodes[node];
+    if(!n->edges) return 0;
+
+    const uint8_t *b = memchr(n->bytes, c, n->edges);
+    return b ? n->next[b - n->bytes] : 0;
+}
+
+static uint32_t sp_trie_add(struct sp_trie *t, const uint8_t *fold, const char *s, size_t len, bool reverse) {
+    uint32_t node = 0;
+
+    for(size_t i = 0; i < len; i++) {
+        uint8_t c = fold[(uint8_t)s[reverse ? len - i - 1 : i]];
+        uint32_t child = sp_trie_child(t, node, c);
+        if(!child) {
+            child = sp_trie_node_new(t);
+
+            // the nodes array may have been reallocated
+            struct sp_trie_node *n = &t->nodes[node];
+            n->bytes = reallocz(n->bytes, (n->edges + 1) * sizeof(*n->bytes));
+            n->next = reallocz(n->next, (n->edges + 1) * sizeof(*n->next));
+            n->bytes[n->edges] = c;
+            n->next[n->edges] = child;
+            n->edges++;
+        }
+        node = child;
+    }
+
+    return node;
+}
+
+static void sp_trie_set_pos(struct sp_trie *t, uint32_t node, uint32_t pos, bool exact) {
+    uint32_t *p = exact ? &t->nodes[node].exact : &t->nodes[node].pos;
+
+    // positions are added in order, the first one is the lowest
+    if(*p == SP_POS_NONE)
+        *p = pos;
+
+    if(pos < t->min_pos)
+        t->min_pos = pos;
+}
+
+static void sp_trie_add_candidates(struct sp_trie *t, uint32_t node, const uint32_t *pos, uint32_t count) {
+    if(!count) return;
+
+    struct sp_trie_node *n = &t->nodes[node];
+    n->candidates = reallocz(n->candidates, (n->candidates_count + count) * sizeof(*n->candidates));
+    memcpy(&n->candidates[n->candidates_count], pos, count * sizeof(*pos));
+    n->candidates_count += count;
+
+    for(uint32_t i = 0; i < count; i++)
+        if(pos[i] < t->min_pos)
+            t->min_pos = pos[i];
+}
+
+// turn the trie into an aho-corasick automaton
+static void sp_trie_build_failure_links(struct sp_trie *t) {
+    uint32_t *queue = mallocz(t->used * sizeof(*queue));
+    uint32_t head = 0, tail = 0;
+
+    for(uint32_t e = 0; e < t->nodes[0].edges; e++) {
+        uint32_t child = t->nodes[0].next[e];
+        t->nodes[child].fail = 0;
+        queue[tail++] = child;
+    }
+
+    while(head < tail) {
+        uint32_t node = queue[head++];
+
+        for(uint32_t e = 0; e < t->nodes[node].edges; e++) {
+            uint8_t c = t->nodes[node].bytes[e];
+            uint32_t child = t->nodes[node].next[e];
+
+            uint32_t f = t->nodes[node].fail, next;
+            while(!(next = sp_trie_child(t, f, c)) && f)
+                f = t->nodes[f].fail;
+
+            t->nodes[child].fail = next;
+
+            // the patterns ending at the fail node, also end at this node
+            if(t->nodes[next].pos < t->nodes[child].pos)
+                t->nodes[child].pos = t->nodes[next].pos;
+
+            sp_trie_add_candidates(t, child, t->nodes[next].candidates, t->nodes[next].candidates_count);
+
+            queue[tail++] = child;
+        }
+    }
+
+    freez(queue);
+}
+
+static struct simple_pattern_compiled *simple_pattern_compile(struct simple_pattern *root) {
+    uint32_t count = 0;
+    for(struct simple_pattern *m = root; m ; m = m->next)
+        count++;
+
+    if(count < SIMPLE_PATTERN_COMPILE_MIN_PATTERNS)
+        return NULL;
+
+    struct simple_pattern_compiled *c = callocz(1, sizeof(*c));
+    c->patterns = mallocz(count * sizeof(*c->patterns));
+    c->match_all = SP_POS_NONE;
+
+    // the same folding strcasecmp() and friends do
+    for(size_t i = 0; i < 256; i++)
+        c->fold[i] = root->case_sensitive ? (uint8_t)i : (uint8_t)tolower((int)i);
+
+    sp_trie_init(&c->prefix);
+    sp_trie_init(&c->suffix);
+    sp_trie_init(&c->substring);
+
+    uint32_t pos = 0;
+    for(struct simple_pattern *m = root; m ; m = m->next, pos++) {
+        c->patterns[pos] = m;
+
+        if(m->child) {
+            // a pattern with a child always starts with a non-empty prefix or substring
+            struct sp_trie *t = (m->mode == SIMPLE_PATTERN_PREFIX) ? &c->prefix : &c->substring;
+            sp_trie_add_candidates(t, sp_trie_add(t, c->fold, m->match, m->len, false), &pos, 1);
+            continue;
+        }
+
+        if(!m->len) {
+            if(c->match_all == SP_POS_NONE)
+                c->match_all = pos;
+            continue;
+        }
+
+        switch(m->mode) {
+            default:
+            case SIMPLE_PATTERN_EXACT:
+                sp_trie_set_pos(&c->prefix, sp_trie_add(&c->prefix, c->fold, m->match, m->len, false), pos, true);
+                break;
+
+            case SIMPLE_PATTERN_PREFIX:
+                sp_trie_set_pos(&c->prefix, sp_trie_add(&c->prefix, c->fold, m->match, m->len, false), pos, false);
+                break;
+
+            case SIMPLE_PATTERN_SUFFIX:
+                sp_trie_set_pos(&c->suffix, sp_trie_add(&c->suffix, c->fold, m->match, m->len, true), pos, false);
+                break;
+
+            case SIMPLE_PATTERN_SUBSTRING:
+                sp_trie_set_pos(&c->substring, sp_trie_add(&c->substring, c->fold, m->match, m->len, false), pos, false);
+                break;
+        }
+    }
+
+    sp_trie_build_failure_links(&c->substring);
+
+    return c;
+}
+
+static void simple_pattern_compiled_free(struct simple_pattern_compiled *c) {
+    if(!c) return;
+
+    sp_trie_free(&c->prefix);
+    sp_trie_free(&c->suffix);
+    sp_trie_free(&c->substring);
+    freez(c->patterns);
+    freez(c);
+}
+
+// evaluate the patterns with asterisks in the middle, that have their first part matched at a node
+ALWAYS_INLINE
+static uint32_t sp_trie_node_candidates(struct simple_pattern_compiled *c, struct sp_trie_node *n, const char *str, size_t len, uint32_t best) {
+    for(uint32_t i = 0; i < n->candidates_count ; i++) {
+        uint32_t pos = n->candidates[i];
+        size_t wss = 0;
+        if(pos < best && match_pattern(c->patterns[pos], str, len, NULL, &wss))
+            best = pos;
+    }
+
+    return best;
+}
+
+// the lowest position of the patterns matching str, or SP_POS_NONE
+ALWAYS_INLINE
+static uint32_t simple_pattern_compiled_match(struct simple_pattern_compiled *c, const char *str, size_t len) {
+    const uint8_t *s = (const uint8_t *)str;
+    uint32_t best = c->match_all;
+
+    if(c->prefix.min_pos < best) {
+        struct sp_trie *t = &c->prefix;
+        uint32_t node = 0;
+        for(size_t i = 0; i < len ; i++) {
+            node = sp_trie_child(t, node, c->fold[s[i]]);
+            if(!node) break;
+
+            struct sp_trie_node *n = &t->nodes[node];
+            if(n->pos < best)
+                best = n->pos;
+
+            if(i == len - 1 && n->exact < best)
+                best = n->exact;
+
+            if(unlikely(n->candidates_count))
+                best = sp_trie_node_candidates(c, n, str, len, best);
+        }
+    }
+
+    if(c->suffix.min_pos < best) {
+        struct sp_trie *t = &c->suffix;
+        uint32_t node = 0;
+        for(size_t i = len; i > 0 ; i--) {
+            node = sp_trie_child(t, node, c->fold[s[i - 1]]);
+            if(!node) break;
+
+            if(t->nodes[node].pos < best)
+                best = t->nodes[node].pos;
+        }
+    }
+
+    if(c->substring.min_pos < best) {
+        struct sp_trie *t = &c->substring;
+        uint32_t node = 0;
+        for(size_t i = 0; i < len && t->min_pos < best ; i++) {
+            uint8_t ch = c->fold[s[i]];
+            uint32_t next;
+            while(!(next = sp_trie_child(t, node, ch)) && node)
+                node = t->nodes[node].fail;
+            node = next;
+
+            struct sp_trie_node *n = &t->nodes[node];
+            if(n->pos < best)
+                best = n->pos;
+
+            if(unlikely(n->candidates_count))
+                best = sp_trie_node_candidates(c, n, str, len, best);
+        }
+    }
+
+    return best;
+}
+
+ALWAYS_INLINE
+static SIMPLE_PATTERN_RESULT simple_pattern_matches_extract_with_length(SIMPLE_PATTERN *list, const char *str, size_t len, char *wildcarded, size_t wildcarded_size) {
+    struct simple_pattern *root = (struct simple_pattern *)list;
+
+    if(!root->compiled)
+        return simple_pattern_matches_linear(root, str, len, wildcarded, wildcarded_size);
+
+    uint32_t pos = simple_pattern_compiled_match(root->compiled, str, len);
+
+    if(unlikely(wildcarded)) {
+        *wildcarded = '\0';
+
+        // only the pattern that matched fills the wildcarded parts
+        if(pos != SP_POS_NONE) {
+            size_t wss = wildcarded_size;
+            match_pattern(root->compiled->patterns[pos], str, len, wildcarded, &wss);
+        }
+    }
+
+    if(pos == SP_POS_NONE)
+        return SP_NOT_MATCHED;
+
+    return root->compiled->patterns[pos]->negative ? SP_MATCHED_NEGATIVE : SP_MATCHED_POSITIVE;
+}
+
 SIMPLE_PATTERN_RESULT simple_pattern_matches_buffer_extract(SIMPLE_PATTERN *list, BUFFER *str, char *wildcarded, size_t wildcarded_size) {
     if(!list || !str || buffer_strlen(str)) return SP_NOT_MATCHED;
     return simple_pattern_matches_extract_with_length(list, buffer_tostring(str), buffer_strlen(str), wildcarded, wildcarded_size);
@@ -331,6 +686,7 @@ static inline void free_pattern(struct simple_pattern *m) {
 void simple_pattern_free(SIMPLE_PATTERN *list) {
     if(!list) return;
 
+    simple_pattern_compiled_free(((struct simple_pattern *)list)->compiled);
     free_pattern(((struct simple_pattern *)list));
 }
 
@@ -457,3 +813,166 @@ bool simple_pattern_contains_wildcards(const char *str, const char *separators)
 
     return false;
 }
+
+// ----------------------------------------------------------------------------
+// unittest and benchmark of the compiled lists
+
+static uint64_t sp_unittest_random(uint64_t *state) {
+    // xorshift64, deterministic across runs
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static char *sp_unittest_patterns(size_t generated) {
+    BUFFER *wb = buffer_create(0, NULL);
+
+    // what users usually have in their configuration
+    buffer_strcat(wb,
+                  "!/dev !/dev/* !/run/user/* !/proc/* !/sys/* !/var/lib/docker/* !*/shm "
+                  "!loop* !ram* !zram* !dm-* !*-ifb !veth* !docker* !br-* !cali* !flannel* "
+                  "!*docker* !*kubepods* !*.mount !*.socket !*.slice/*.scope !*systemd* "
+                  "sd*p* nvme*n*p* eth* en* wl* *-data *backup* *.service system.slice/*/data ");
+
+    for(size_t i = 0; i < generated; i++) {
+        switch(i % 8) {
+            case 0: buffer_sprintf(wb, "host-%zu ", i); break;
+            case 1: buffer_sprintf(wb, "!container-%zu-* ", i); break;
+            case 2: buffer_sprintf(wb, "app%zu.* ", i); break;
+            case 3: buffer_sprintf(wb, "*.svc%zu ", i); break;
+            case 4: buffer_sprintf(wb, "!*-pod%zu-* ", i); break;
+            case 5: buffer_sprintf(wb, "*vol%zu* ", i); break;
+            case 6: buffer_sprintf(wb, "ns%zu/*/disk* ", i); break;
+            case 7: buffer_sprintf(wb, "!*tmp%zu*cache* ", i); break;
+        }
+    }
+
+    char *s = strdupz(buffer_tostring(wb));
+    buffer_free(wb);
+    return s;
+}
+
+static void sp_unittest_string(uint64_t *state, size_t generated, char *dst, size_t size) {
+    static const char *fragments[] = {
+        "/dev/", "/run/user/", "/var/lib/docker/", "/mnt/", "loop", "sd", "sda", "p1", "nvme0n1", "p2",
+        "eth", "ens", "veth", "docker", "kubepods", "system.slice/", ".service", ".mount", "/data",
+        "-data", "backup", "DOCKER", "Eth", "-", ".", "/", "x", "abc", "cache", "shm", "disk",
+        "host-", "container-", "app", "svc", "pod", "vol", "ns", "tmp",
+    };
+    size_t fragments_count = sizeof(fragments) / sizeof(fragments[0]);
+
+    size_t len = 0, parts = 1 + sp_unittest_random(state) % 6;
+    dst[0] = '\0';
+    for(size_t p = 0; p < parts && len < size - 24; p++) {
+        uint64_t r = sp_unittest_random(state);
+        if(r % 3 == 0)
+            len += snprintfz(&dst[len], size - len, "%s%zu", fragments[(r >> 8) % fragments_count], (size_t)((r >> 16) % (generated + 1)));
+        else
+            len += snprintfz(&dst[len], size - len, "%s", fragments[(r >> 8) % fragments_count]);
+    }
+}
+
+static int sp_unittest_list(const char *title, const char *patterns, SIMPLE_PREFIX_MODE mode, bool case_sensitive, size_t generated, size_t strings) {
+    SIMPLE_PATTERN *p = simple_pattern_create(patterns, NULL, mode, case_sensitive);
+    struct simple_pattern *root = (struct simple_pattern *)p;
+    if(!root || !root->compiled) {
+        fprintf(stderr, "%s: the list has not been compiled\n", title);
+        simple_pattern_free(p);
+        return 1;
+    }
+
+    char (*values)[256] = mallocz(strings * sizeof(*values));
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(size_t i = 0; i < strings; i++)
+        sp_unittest_string(&state, generated, values[i], sizeof(values[i]));
+
+    // the compiled list must give the same results with the linear evaluation
+    int errors = 0;
+    size_t matched = 0;
+    for(size_t i = 0; i < strings; i++) {
+        char ws1[256], ws2[256];
+        size_t len = strlen(values[i]);
+        SIMPLE_PATTERN_RESULT r1 = simple_pattern_matches_extract(p, values[i], ws1, sizeof(ws1));
+        SIMPLE_PATTERN_RESULT r2 = simple_pattern_matches_linear(root, values[i], len, ws2, sizeof(ws2));
+
+        if(r1 != r2 || (r1 != SP_NOT_MATCHED && strcmp(ws1, ws2) != 0)) {
+            if(errors < 10)
+                fprintf(stderr, "%s: '%s' compiled gives %d ('%s'), linear gives %d ('%s')\n",
+                        title, values[i], r1, ws1, r2, ws2);
+            errors++;
+        }
+
+        if(r1 != SP_NOT_MATCHED)
+            matched++;
+    }
+
+    size_t iterations = 10;
+    size_t positive = 0;
+
+    usec_t started_ut = now_monotonic_usec();
+    for(size_t it = 0; it < iterations; it++)
+        for(size_t i = 0; i < strings; i++)
+            positive += simple_pattern_matches_linear(root, values[i], strlen(values[i]), NULL, 0) == SP_MATCHED_POSITIVE;
+    usec_t linear_ut = now_monotonic_usec() - started_ut;
+
+    started_ut = now_monotonic_usec();
+    for(size_t it = 0; it < iterations; it++)
+        for(size_t i = 0; i < strings; i++)
+            positive -= simple_pattern_matches(p, values[i]);
+    usec_t compiled_ut = now_monotonic_usec() - started_ut;
+
+    size_t patterns_count = 0;
+    for(struct simple_pattern *m = root; m ; m = m->next)
+        patterns_count++;
+
+    fprintf(stderr, "%-40s: %5zu patterns, %zu strings (%zu matched), %s, "
+                    "linear %7.1f ns/match, compiled %7.1f ns/match, speedup %.1fx\n",
+            title, patterns_count, strings, matched, errors ? "FAILED" : "OK",
+            (double)linear_ut * 1000.0 / (double)(iterations * strings),
+            (double)compiled_ut * 1000.0 / (double)(iterations * strings),
+            compiled_ut ? (double)linear_ut / (double)compiled_ut : 0.0);
+
+    if(positive) {
+        fprintf(stderr, "%s: the benchmark loops gave different results\n", title);
+        errors++;
+    }
+
+    freez(values);
+    simple_pattern_free(p);
+    return errors;
+}
+
+int simple_pattern_unittest(void) {
+    int errors = 0;
+    size_t strings = 20000;
+
+    size_t sizes[] = { 0, 16, 128, 1024 };
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char *patterns = sp_unittest_patterns(sizes[i]);
+        char title[100];
+
+        snprintfz(title, sizeof(title), "exact, case sensitive, +%zu", sizes[i]);
+        errors += sp_unittest_list(title, patterns, SIMPLE_PATTERN_EXACT, true, sizes[i], strings);
+
+        snprintfz(title, sizeof(title), "exact, case insensitive, +%zu", sizes[i]);
+        errors += sp_unittest_list(title, patterns, SIMPLE_PATTERN_EXACT, false, sizes[i], strings);
+
+        snprintfz(title, sizeof(title), "substring, case insensitive, +%zu", sizes[i]);
+        errors += sp_unittest_list(title, patterns, SIMPLE_PATTERN_SUBSTRING, false, sizes[i], strings);
+
+        freez(patterns);
+    }
+
+    // duplicates, match-all patterns and negation must respect the order of the list
+    errors += sp_unittest_list("ordering",
+                               "a* !a* !*b b* x !x *c* !*c* abc*def !abc* d*e !d*e *s*p* s*p *1 !*2 * !*",
+                               SIMPLE_PATTERN_EXACT, true, 0, strings);
+    errors += sp_unittest_list("ordering, negative first",
+                               "!*a* a* !b* *b !ab !ba !*d*e* x* *x* y* z* w* !e*d *3 4* *5* 6",
+                               SIMPLE_PATTERN_EXACT, true, 0, strings);
+
+    fprintf(stderr, "\nSIMPLE PATTERN UNITTEST: %s\n", errors ? "FAILED" : "OK");
+    return errors;
+}
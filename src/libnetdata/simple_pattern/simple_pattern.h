@@ -49,6 +49,8 @@ void simple_pattern_dump(uint64_t debug_type, SIMPLE_PATTERN *p) ;
 int simple_pattern_is_potential_name(SIMPLE_PATTERN *p) ;
 char *simple_pattern_iterate(SIMPLE_PATTERN **p);
 
+int simple_pattern_unittest(void);
+
 // check if string contains pattern wildcards (*, ! prefix, or separators)
 bool simple_pattern_contains_wildcards(const char *str, const char *separators);
 
@@ -83,6 +83,46 @@ void poll_process_remove_from_poll(POLLINFO *pi) {
         pi->flags |= POLLINFO_FLAG_REMOVED_FROM_POLL;
 }
 
+bool poll_process_suspend(POLLINFO *pi) {
+    POLLJOB *p = pi->p;
+
+    internal_fatal(pi->flags & POLLINFO_FLAG_SUSPENDED, "POLLFD: socket %d is already suspended", pi->fd);
+
+    if(unlikely(p->resume.fds[PIPE_WRITE] == -1 || (pi->flags & POLLINFO_FLAG_REMOVED_FROM_POLL)))
+        return false;
+
+    poll_process_remove_from_poll(pi);
+    if(unlikely(!(pi->flags & POLLINFO_FLAG_REMOVED_FROM_POLL)))
+        return false;
+
+    pi->flags |= POLLINFO_FLAG_SUSPENDED;
+    p->resume.suspended++;
+    return true;
+}
+
+void poll_process_resume(POLLINFO *pi, nd_poll_event_t events, uint32_t flags) {
+    POLLJOB *p = pi->p;
+
+    internal_fatal(!(pi->flags & POLLINFO_FLAG_SUSPENDED), "POLLFD: socket %d is not suspended", pi->fd);
+
+    pi->resume_events = events;
+    pi->resume_flags = flags;
+
+    // we write to the pipe while holding the lock, so that once the poll thread
+    // gets the socket back, this thread does not touch the poll anymore
+    // (the poll thread may exit and release it right after)
+    spinlock_lock(&p->resume.spinlock);
+    bool send_pipe_msg = !p->resume.ll; // write to the pipe, only when the list was empty before this socket
+    pi->resume_next = p->resume.ll;
+    p->resume.ll = pi;
+
+    // when the pipe is full, the poll thread has already been signaled
+    if(send_pipe_msg && write(p->resume.fds[PIPE_WRITE], " ", 1) != 1 && errno != EAGAIN && errno != EWOULDBLOCK)
+        nd_log(NDLS_DAEMON, NDLP_ERR, "POLLFD: cannot write to the resume pipe");
+
+    spinlock_unlock(&p->resume.spinlock);
+}
+
 static inline void poll_close_fd(POLLINFO *pi, const char *func) {
     POLLJOB *p = pi->p;
 
@@ -165,18 +205,78 @@ void poll_default_tmr_callback(void *timer_data) {
     (void)timer_data;
 }
 
+static void poll_process_resumed(POLLJOB *p, time_t now) {
+    char buffer[64];
+    while(read(p->resume.fds[PIPE_READ], buffer, sizeof(buffer)) > 0) ;
+
+    spinlock_lock(&p->resume.spinlock);
+    POLLINFO *pi = p->resume.ll;
+    p->resume.ll = NULL;
+    spinlock_unlock(&p->resume.spinlock);
+
+    while(pi) {
+        POLLINFO *next = pi->resume_next;
+        pi->resume_next = NULL;
+
+        pi->flags &= ~(POLLINFO_FLAG_SUSPENDED);
+        pi->flags |= pi->resume_flags;
+        p->resume.suspended--;
+
+        // the other thread may have worked on it for long,
+        // refresh the receive timestamp so that the idle timeout starts now
+        pi->last_received_t = now;
+        pi->events = pi->resume_events;
+
+        if(!pi->events)
+            poll_close_fd(pi, __FUNCTION__ );
+
+        else if(!nd_poll_add(p->ndpl, pi->fd, pi->events, pi)) {
+            nd_log(NDLS_DAEMON, NDLP_ERR, "Failed to add resumed socket %d to nd_poll", pi->fd);
+            poll_close_fd(pi, __FUNCTION__ );
+        }
+        else {
+            pi->flags &= ~(POLLINFO_FLAG_REMOVED_FROM_POLL);
+            pi->events_we_wait_for = pi->events;
+        }
+
+        pi = next;
+    }
+}
+
 static void poll_events_cleanup(void *pptr) {
     POLLJOB *p = CLEANUP_FUNCTION_GET_PTR(pptr);
     if(!p) return;
 
-    while(p->ll) {
-        POLLINFO *pi = p->ll;
-        pi->flags &= ~(POLLINFO_FLAG_DONT_CLOSE);
-        poll_close_fd(pi, __FUNCTION__ );
-    }
+    // close the sockets we own, and wait for the ones handed over to other threads to come back -
+    // these threads use the resume state of this poll, so we cannot release it before they are done
+    do {
+        POLLINFO *pi, *next;
+        for(pi = p->ll; pi ; pi = next) {
+            next = pi->next;
+            if(!(pi->flags & POLLINFO_FLAG_SUSPENDED)) {
+                pi->flags &= ~(POLLINFO_FLAG_DONT_CLOSE);
+                poll_close_fd(pi, __FUNCTION__ );
+            }
+        }
+
+        if(p->resume.suspended) {
+            // only the resume pipe is left in the poll
+            nd_poll_result_t result;
+            if(nd_poll_wait(p->ndpl, 1000, &result) == -1)
+                sleep_usec(10 * USEC_PER_MS);
+
+            poll_process_resumed(p, now_boottime_sec());
+        }
+    } while(p->ll);
 
     nd_poll_destroy(p->ndpl);
     p->ndpl = NULL;
+
+    if(p->resume.fds[PIPE_READ] != -1) {
+        close(p->resume.fds[PIPE_READ]);
+        close(p->resume.fds[PIPE_WRITE]);
+        p->resume.fds[PIPE_READ] = p->resume.fds[PIPE_WRITE] = -1;
+    }
 }
 
 static int poll_process_error(POLLINFO *pi, nd_poll_event_t revents) {
@@ -364,9 +464,30 @@ void poll_events(LISTEN_SOCKETS *sockets
         .del_callback = del_callback?del_callback:poll_default_del_callback,
         .rcv_callback = rcv_callback?rcv_callback:poll_default_rcv_callback,
         .snd_callback = snd_callback?snd_callback:poll_default_snd_callback,
-        .tmr_callback = tmr_callback?tmr_callback:poll_default_tmr_callback
+        .tmr_callback = tmr_callback?tmr_callback:poll_default_tmr_callback,
+
+        .resume = {
+            .fds = { -1, -1 },
+        },
     };
 
+    spinlock_init(&p.resume.spinlock);
+    if(pipe(p.resume.fds) != 0) {
+        nd_log(NDLS_DAEMON, NDLP_ERR, "POLLFD: cannot create the resume pipe - sockets cannot be handed over to other threads");
+        p.resume.fds[PIPE_READ] = p.resume.fds[PIPE_WRITE] = -1;
+    }
+    else {
+        sock_setnonblock(p.resume.fds[PIPE_READ], true);
+        sock_setnonblock(p.resume.fds[PIPE_WRITE], true);
+
+        if(!nd_poll_add(p.ndpl, p.resume.fds[PIPE_READ], ND_POLL_READ, &p.resume)) {
+            nd_log(NDLS_DAEMON, NDLP_ERR, "POLLFD: failed to add the resume pipe to nd_poll()");
+            close(p.resume.fds[PIPE_READ]);
+            close(p.resume.fds[PIPE_WRITE]);
+            p.resume.fds[PIPE_READ] = p.resume.fds[PIPE_WRITE] = -1;
+        }
+    }
+
     size_t i;
     for(i = 0; i < sockets->opened ;i++) {
 
@@ -456,6 +577,12 @@ void poll_events(LISTEN_SOCKETS *sockets
             // timeout
             ;
         }
+        else if(result.data == &p.resume) {
+            if(unlikely(result.events & (ND_POLL_HUP | ND_POLL_INVALID | ND_POLL_ERROR)))
+                nd_log(NDLS_DAEMON, NDLP_ERR, "POLLFD: LISTENER: got errors on the resume pipe.");
+
+            poll_process_resumed(&p, now);
+        }
         else {
             POLLINFO *pi = (POLLINFO *)result.data;
 
@@ -546,6 +673,10 @@ void poll_events(LISTEN_SOCKETS *sockets
                 next = pi->next;
 
                 if(likely(pi->flags & POLLINFO_FLAG_CLIENT_SOCKET)) {
+                    if (unlikely(pi->flags & POLLINFO_FLAG_SUSPENDED))
+                        // another thread is working on it
+                        continue;
+
                     if (unlikely(
                         !(pi->flags & POLLINFO_FLAG_FIRST_REQUEST_RECEIVED) &&
                         pi->send_count == 0 &&
@@ -10,6 +10,7 @@
 #define POLLINFO_FLAG_DONT_CLOSE        (1U << 2)
 #define POLLINFO_FLAG_REMOVED_FROM_POLL (1U << 3)
 #define POLLINFO_FLAG_FIRST_REQUEST_RECEIVED (1U << 4)
+#define POLLINFO_FLAG_SUSPENDED         (1U << 5)
 
 typedef struct poll POLLJOB;
 typedef struct pollinfo POLLINFO;
@@ -51,6 +52,11 @@ struct pollinfo {
     void *data;
 
     struct pollinfo *prev, *next;
+
+    // the list of sockets resumed by other threads (see poll_process_resume())
+    nd_poll_event_t resume_events;
+    uint32_t resume_flags;
+    struct pollinfo *resume_next;
 };
 
 struct poll {
@@ -75,6 +81,14 @@ struct poll {
     poll_events_rcv_callback_t rcv_callback;
     poll_events_snd_callback_t snd_callback;
     poll_events_tmr_callback_t tmr_callback;
+
+    // sockets handed over to other threads, waiting to be resumed
+    struct {
+        int fds[2];             // the pipe that wakes up the poll thread
+        size_t suspended;       // accessed only by the poll thread
+        SPINLOCK spinlock;      // protects the list below
+        POLLINFO *ll;           // the sockets resumed, to be re-armed by the poll thread
+    } resume;
 };
 
 int poll_default_snd_callback(POLLINFO *pi, nd_poll_event_t *events);
@@ -84,6 +98,17 @@ void *poll_default_add_callback(POLLINFO *pi, nd_poll_event_t *events, void *dat
 
 void poll_process_remove_from_poll(POLLINFO *pi);
 
+// hand a socket over to another thread:
+// poll_process_suspend() must be called by the poll thread (i.e. from within a callback) - the socket
+// is removed from the poll and the poll thread will not touch it (or its data) until it is resumed.
+// It returns false when the socket cannot be handed over, in which case nothing is changed.
+// poll_process_resume() may be called from any thread, to give the socket back to the poll thread,
+// waiting for the events given - when no events are given, the socket is closed. The flags given are
+// set on the socket by the poll thread. A poll thread that exits waits for all its suspended sockets
+// to be resumed, so the other threads must resume them, even when they are stopping.
+bool poll_process_suspend(POLLINFO *pi);
+void poll_process_resume(POLLINFO *pi, nd_poll_event_t events, uint32_t flags);
+
 POLLINFO *poll_add_fd(POLLJOB *p
                       , int fd
                       , int socktype
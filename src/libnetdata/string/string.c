@@ -5,11 +5,30 @@
 
 // ----------------------------------------------------------------------------
 // STRING implementation - dedup all STRING
-
-#define STRING_PARTITION_SHIFTS (0)
-#define STRING_PARTITIONS (256 >> STRING_PARTITION_SHIFTS)
-#define string_partition_str(str) ((uint8_t)((str)[0]) >> STRING_PARTITION_SHIFTS)
-#define string_partition(string) (string_partition_str((string)->str))
+//
+// The index is split in partitions by the hash of the strings, so that strings
+// sharing a prefix (e.g. "k8s_", "cgroup_") are spread over all of them.
+// Each partition is a chained hash table:
+//
+//  - lookups are lock-free: they walk the bucket chains without any lock, and
+//    acquire a reference on the string they find.
+//  - inserts, deletes and resizes are serialized per partition with a spinlock.
+//    Every change is published with a single atomic pointer store, so lookups
+//    see either the old or the new chain. While a table is being resized, a
+//    lookup may miss a string; it is then found under the lock by the insert.
+//  - strings and tables removed from the index are not freed immediately, since
+//    lookups may still be reading them. They are retired and freed with epoch
+//    based reclamation: threads announce the epoch they entered the index with,
+//    and retired memory is freed when all threads in the index entered after it
+//    was retired.
+
+#define STRING_PARTITIONS 256
+#define string_partition_hash(hash) ((uint8_t)((hash) & (STRING_PARTITIONS - 1)))
+#define string_partition(string) (string_partition_hash((string)->hash))
+#define string_bucket_hash(hash) ((hash) >> 8)
+
+#define STRING_HASHTABLE_INITIAL_SIZE 16    // buckets, must be a power of 2
+#define STRING_RETIRED_BATCH 64             // the retired pointers of each partition, freed together
 
 struct netdata_string {
     uint32_t length;    // the string length including the terminating '\0'
@@ -17,7 +36,11 @@ struct netdata_string {
     REFCOUNT refcount;  // how many times this string is used
                         // We use a signed number to be able to detect duplicate frees of a string.
                         // If at any point this goes below zero, we have a duplicate free.
-                        
+
+    uint32_t hash;      // the hash of the string, for the partition and the bucket
+
+    STRING *next;       // atomic, the next string on the same bucket
+
 #ifdef FSANITIZE_ADDRESS
     STACKTRACE_ARRAY stacktraces;   // stack traces from all acquisition points
 #endif
@@ -25,17 +48,30 @@ struct netdata_string {
     const char str[];   // the string itself, is appended to this structure
 };
 
+struct string_hashtable {
+    uint32_t mask;              // the number of buckets - 1
+    STRING *buckets[];          // atomic, the first string of each bucket
+};
+
+struct string_retired {
+    uint64_t epoch;             // the epoch the batch was sealed at
+    size_t used;
+    struct string_retired *next;
+    void *ptrs[STRING_RETIRED_BATCH];
+};
+
 static struct string_partition {
-    RW_SPINLOCK spinlock;       // the R/W spinlock to protect the Judy array
+    SPINLOCK spinlock;          // serializes the writers, lookups do not lock
 
-    Pvoid_t JudyHSArray;        // the Judy array - hashtable
+    struct string_hashtable *hashtable; // atomic
+    struct string_retired *retired;     // the batch being filled, under the spinlock
 
     size_t inserts;             // the number of successful inserts to the index
     size_t deletes;             // the number of successful deleted from the index
 
     long int entries;           // the number of entries in the index
     long int memory;            // the memory used
-    long int memory_index;      // JudyHS (accurate)
+    long int memory_index;      // the hash table
 
 #ifdef FSANITIZE_ADDRESS
     Pvoid_t JudyLPointers;      // JudyL array to keep track of all string pointers for traversal
@@ -96,6 +132,195 @@ void string_statistics(size_t *inserts, size_t *deletes, size_t *searches, size_
     }
 }
 
+// ----------------------------------------------------------------------------
+// epoch based reclamation of the memory removed from the index
+
+struct string_reader {
+    PAD64(uint64_t) active_epoch;       // atomic, the epoch the thread entered the index with, 0 when outside
+    bool used;                          // the thread owning it is alive
+    struct string_reader *next;
+};
+
+static struct {
+    uint64_t epoch;                     // atomic, it starts at 1, so that 0 means outside the index
+
+    SPINLOCK spinlock;                  // protects everything below
+    struct string_reader *readers;      // all the threads that ever looked up strings
+    struct string_retired *first;       // the sealed batches, in the order of their epochs
+    struct string_retired *last;
+} string_reclaim = {
+    .epoch = 1,
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static __thread struct string_reader *string_thread_reader = NULL;
+
+static struct string_reader *string_reader_register(void) {
+    spinlock_lock(&string_reclaim.spinlock);
+
+    struct string_reader *r;
+    for(r = string_reclaim.readers; r && r->used; r = r->next) ;
+
+    if(!r) {
+        r = callocz(1, sizeof(*r));
+        r->next = string_reclaim.readers;
+        string_reclaim.readers = r;
+    }
+
+    r->used = true;
+    __atomic_store_n(&r->active_epoch, 0, __ATOMIC_RELAXED);
+
+    spinlock_unlock(&string_reclaim.spinlock);
+
+    string_thread_reader = r;
+    return r;
+}
+
+void string_thread_reader_release(void) {
+    struct string_reader *r = string_thread_reader;
+    if(!r) return;
+
+    spinlock_lock(&string_reclaim.spinlock);
+    __atomic_store_n(&r->active_epoch, 0, __ATOMIC_RELEASE);
+    r->used = false;
+    spinlock_unlock(&string_reclaim.spinlock);
+
+    string_thread_reader = NULL;
+}
+
+static ALWAYS_INLINE struct string_reader *string_reader_enter(void) {
+    struct string_reader *r = string_thread_reader;
+    if(unlikely(!r))
+        r = string_reader_register();
+
+    __atomic_store_n(&r->active_epoch, __atomic_load_n(&string_reclaim.epoch, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+
+    // the announcement must be visible before we read anything from the index
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return r;
+}
+
+static ALWAYS_INLINE void string_reader_exit(struct string_reader *r) {
+    __atomic_store_n(&r->active_epoch, 0, __ATOMIC_RELEASE);
+}
+
+static void string_retired_free(struct string_retired *b) {
+    while(b) {
+        struct string_retired *next = b->next;
+
+        for(size_t i = 0; i < b->used; i++)
+            freez(b->ptrs[i]);
+
+        freez(b);
+        b = next;
+    }
+}
+
+// seal a batch of pointers already removed from the index, and free the batches no thread can be reading
+static void string_retired_seal_and_reclaim(struct string_retired *b) {
+    struct string_retired *to_free = NULL;
+
+    spinlock_lock(&string_reclaim.spinlock);
+
+    if(b) {
+        // all the pointers of the batch have been removed from the index before this epoch ends
+        b->epoch = __atomic_load_n(&string_reclaim.epoch, __ATOMIC_SEQ_CST);
+        b->next = NULL;
+
+        if(string_reclaim.last)
+            string_reclaim.last->next = b;
+        else
+            string_reclaim.first = b;
+
+        string_reclaim.last = b;
+    }
+
+    // threads entering the index from now on cannot find anything retired so far
+    uint64_t oldest = __atomic_add_fetch(&string_reclaim.epoch, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    for(struct string_reader *r = string_reclaim.readers; r; r = r->next) {
+        uint64_t epoch = __atomic_load_n(&r->active_epoch, __ATOMIC_ACQUIRE);
+        if(epoch && epoch < oldest)
+            oldest = epoch;
+    }
+
+    // a thread that entered at the epoch of a batch may still be reading it
+    struct string_retired *last_to_free = NULL;
+    for(struct string_retired *t = string_reclaim.first; t && t->epoch < oldest; t = t->next)
+        last_to_free = t;
+
+    if(last_to_free) {
+        to_free = string_reclaim.first;
+        string_reclaim.first = last_to_free->next;
+        if(!string_reclaim.first)
+            string_reclaim.last = NULL;
+        last_to_free->next = NULL;
+    }
+
+    spinlock_unlock(&string_reclaim.spinlock);
+
+    string_retired_free(to_free);
+}
+
+// retire a pointer removed from the index, it returns a full batch to be sealed, after unlocking the partition
+static struct string_retired *string_retire___partition_locked(uint8_t partition, void *ptr) {
+    struct string_retired *b = string_base[partition].retired;
+    if(!b)
+        b = string_base[partition].retired = callocz(1, sizeof(*b));
+
+    b->ptrs[b->used++] = ptr;
+
+    if(b->used < STRING_RETIRED_BATCH)
+        return NULL;
+
+    string_base[partition].retired = NULL;
+    return b;
+}
+
+// ----------------------------------------------------------------------------
+// the hash tables of the partitions
+
+static ALWAYS_INLINE uint32_t string_hash(const char *str, size_t length) {
+    return (uint32_t)XXH3_64bits(str, length - 1);
+}
+
+static struct string_hashtable *string_hashtable_create(uint32_t size) {
+    struct string_hashtable *ht = callocz(1, sizeof(*ht) + size * sizeof(STRING *));
+    ht->mask = size - 1;
+    return ht;
+}
+
+static ALWAYS_INLINE long string_hashtable_memory(struct string_hashtable *ht) {
+    return ht ? (long)(sizeof(*ht) + (ht->mask + 1) * sizeof(STRING *)) : 0;
+}
+
+// double the buckets of the hash table of a partition
+// lookups walking the old table may miss strings while they are being moved
+static struct string_retired *string_hashtable_grow___partition_locked(uint8_t partition) {
+    struct string_hashtable *old = string_base[partition].hashtable;
+    struct string_hashtable *ht = string_hashtable_create((old->mask + 1) * 2);
+
+    for(uint32_t i = 0; i <= old->mask; i++) {
+        STRING *s = old->buckets[i];
+        while(s) {
+            STRING *next = s->next;
+            uint32_t bucket = string_bucket_hash(s->hash) & ht->mask;
+            __atomic_store_n(&s->next, ht->buckets[bucket], __ATOMIC_RELEASE);
+            ht->buckets[bucket] = s;
+            s = next;
+        }
+    }
+
+    __atomic_store_n(&string_base[partition].hashtable, ht, __ATOMIC_RELEASE);
+    string_base[partition].memory_index += string_hashtable_memory(ht) - string_hashtable_memory(old);
+
+    return string_retire___partition_locked(partition, old);
+}
+
+// ----------------------------------------------------------------------------
+
 static inline bool string_entry_check_and_acquire(STRING *se) {
 #ifdef NETDATA_INTERNAL_CHECKS
     uint8_t partition = string_partition(se);
@@ -133,39 +358,43 @@ STRING *string_dup(STRING *string) {
     return string;
 }
 
-// Search the index and return an ACQUIRED string entry, or NULL
-static STRING *string_index_search(const char *str, size_t length, uint8_t partition) {
-    STRING *string;
-
-    // Find the string in the index
-    // With a read-lock so that multiple readers can use the index concurrently.
-
-    rw_spinlock_read_lock(&string_base[partition].spinlock);
+static ALWAYS_INLINE bool string_equals(STRING *string, const char *str, size_t length, uint32_t hash) {
+    return string->hash == hash && string->length == length && memcmp(string->str, str, length - 1) == 0;
+}
 
-    Pvoid_t *Rc;
-    Rc = JudyHSGet(string_base[partition].JudyHSArray, (void *)str, length - 1);
-    if(likely(Rc)) {
-        // found in the hash table
-        string = *Rc;
+// Search the index and return an ACQUIRED string entry, or NULL
+static STRING *string_index_search(const char *str, size_t length, uint32_t hash) {
+    uint8_t partition = string_partition_hash(hash);
+    STRING *string = NULL;
+
+    // Find the string in the index, without any locks.
+    struct string_reader *r = string_reader_enter();
+
+    struct string_hashtable *ht = __atomic_load_n(&string_base[partition].hashtable, __ATOMIC_ACQUIRE);
+    if(likely(ht)) {
+        STRING *s = __atomic_load_n(&ht->buckets[string_bucket_hash(hash) & ht->mask], __ATOMIC_ACQUIRE);
+        for(; s; s = __atomic_load_n(&s->next, __ATOMIC_ACQUIRE)) {
+            if(!string_equals(s, str, length, hash))
+                continue;
+
+            if(string_entry_check_and_acquire(s)) {
+                // we can use this entry
+                string = s;
+                string_internal_stats_add(partition, found_available_on_search, 1);
+            }
+            else {
+                // this entry is about to be deleted by another thread
+                // do not touch it, let it go...
+                string_internal_stats_add(partition, found_deleted_on_search, 1);
+            }
 
-        if(string_entry_check_and_acquire(string)) {
-            // we can use this entry
-            string_internal_stats_add(partition, found_available_on_search, 1);
-        }
-        else {
-            // this entry is about to be deleted by another thread
-            // do not touch it, let it go...
-            string = NULL;
-            string_internal_stats_add(partition, found_deleted_on_search, 1);
+            break;
         }
     }
-    else {
-        // not found in the hash table
-        string = NULL;
-    }
+
+    string_reader_exit(r);
 
     string_stats_atomic_increment(partition, searches);
-    rw_spinlock_read_unlock(&string_base[partition].spinlock);
 
     return string;
 }
@@ -175,33 +404,28 @@ static STRING *string_index_search(const char *str, size_t length, uint8_t parti
 // The returned entry is ACQUIRED, and it can either be:
 //   1. a new item inserted, or
 //   2. an item found in the index that is not currently deleted
-static STRING *string_index_insert(const char *str, size_t length, uint8_t partition) {
-    STRING *string;
-
-    rw_spinlock_write_lock(&string_base[partition].spinlock);
-
-    int64_t judy_mem = 0;
-
-    STRING **ptr;
-    {
-        JError_t J_Error;
-
-        JudyAllocThreadPulseReset();
-
-        Pvoid_t *Rc = JudyHSIns(&string_base[partition].JudyHSArray, (void *)str, length - 1, &J_Error);
-
-        judy_mem = JudyAllocThreadPulseGetAndReset();
+static STRING *string_index_insert(const char *str, size_t length, uint32_t hash) {
+    uint8_t partition = string_partition_hash(hash);
+    STRING *string = NULL;
+    struct string_retired *retired = NULL;
+
+    spinlock_lock(&string_base[partition].spinlock);
+
+    struct string_hashtable *ht = string_base[partition].hashtable;
+    if(unlikely(!ht)) {
+        ht = string_hashtable_create(STRING_HASHTABLE_INITIAL_SIZE);
+        __atomic_store_n(&string_base[partition].hashtable, ht, __ATOMIC_RELEASE);
+        string_base[partition].memory_index += string_hashtable_memory(ht);
+    }
 
-        if (unlikely(Rc == PJERR)) {
-            fatal(
-                "STRING: Cannot insert entry to JudyHS, JU_ERRNO_* == %u, ID == %d",
-                JU_ERRNO(&J_Error),
-                JU_ERRID(&J_Error));
-        }
-        ptr = (STRING **)Rc;
+    STRING **bucket = &ht->buckets[string_bucket_hash(hash) & ht->mask];
+    STRING *s;
+    for(s = *bucket; s; s = s->next) {
+        if(string_equals(s, str, length, hash))
+            break;
     }
 
-    if (likely(*ptr == 0)) {
+    if (likely(!s)) {
         // a new item added to the index
         long mem_size = (long)sizeof(STRING) + (long)length;
         string = mallocz(mem_size);
@@ -209,7 +433,9 @@ static STRING *string_index_insert(const char *str, size_t length, uint8_t parti
         ((char *)string->str)[length - 1] = '\0';
         string->length = length;
         string->refcount = 1;
-        
+        string->hash = hash;
+        string->next = *bucket;
+
 #ifdef FSANITIZE_ADDRESS
         // Initialize stacktrace tracking
         stacktrace_array_init(&string->stacktraces);
@@ -220,61 +446,60 @@ static STRING *string_index_insert(const char *str, size_t length, uint8_t parti
         if (PValue != PJERR)
             *PValue = (void *)1;  // Use a simple value of 1 for now
 #endif
-        
-        *ptr = string;
+
+        // publish it, fully initialized
+        __atomic_store_n(bucket, string, __ATOMIC_RELEASE);
+
         string_base[partition].inserts++;
         string_base[partition].entries++;
         string_base[partition].memory += mem_size;
-        string_base[partition].memory_index += judy_mem;
+
+        if(unlikely((unsigned long)string_base[partition].entries > (unsigned long)ht->mask + 1))
+            retired = string_hashtable_grow___partition_locked(partition);
     }
     else {
         // the item is already in the index
-        string = *ptr;
-
-        if(string_entry_check_and_acquire(string)) {
+        if(string_entry_check_and_acquire(s)) {
             // we can use this entry
+            string = s;
             string_internal_stats_add(partition, found_available_on_insert, 1);
         }
         else {
             // this entry is about to be deleted by another thread
             // do not touch it, let it go...
-            string = NULL;
             string_internal_stats_add(partition, found_deleted_on_insert, 1);
         }
 
         string_stats_atomic_increment(partition, searches);
     }
 
-    rw_spinlock_write_unlock(&string_base[partition].spinlock);
+    spinlock_unlock(&string_base[partition].spinlock);
+
+    if(unlikely(retired))
+        string_retired_seal_and_reclaim(retired);
+
     return string;
 }
 
 // delete an entry from the index
 static void string_index_delete(STRING *string) {
     uint8_t partition = string_partition(string);
+    struct string_retired *retired = NULL;
 
-    rw_spinlock_write_lock(&string_base[partition].spinlock);
+    spinlock_lock(&string_base[partition].spinlock);
 
     bool deleted = false;
-    int64_t judy_mem = 0;
-
-    if (likely(string_base[partition].JudyHSArray)) {
-        JError_t J_Error;
-
-        JudyAllocThreadPulseReset();
-
-        int ret = JudyHSDel(&string_base[partition].JudyHSArray, (void *)string->str, string->length - 1, &J_Error);
-
-        judy_mem = JudyAllocThreadPulseGetAndReset();
-
-        if (unlikely(ret == JERR)) {
-            netdata_log_error(
-                "STRING: Cannot delete entry with name '%s' from JudyHS, JU_ERRNO_* == %u, ID == %d",
-                string->str,
-                JU_ERRNO(&J_Error),
-                JU_ERRID(&J_Error));
-        } else
+    struct string_hashtable *ht = string_base[partition].hashtable;
+    if (likely(ht)) {
+        STRING **ptr = &ht->buckets[string_bucket_hash(string->hash) & ht->mask];
+        while(*ptr && *ptr != string)
+            ptr = &(*ptr)->next;
+
+        if(likely(*ptr)) {
+            // lookups standing on this string can still move on to the next
+            __atomic_store_n(ptr, string->next, __ATOMIC_RELEASE);
             deleted = true;
+        }
     }
 
     if (unlikely(!deleted))
@@ -284,18 +509,21 @@ static void string_index_delete(STRING *string) {
         string_base[partition].deletes++;
         string_base[partition].entries--;
         string_base[partition].memory -= mem_size;
-        string_base[partition].memory_index += judy_mem;
-        
+
 #ifdef FSANITIZE_ADDRESS
         // Remove from the JudyL array if it exists
         if (string_base[partition].JudyLPointers)
             JudyLDel(&string_base[partition].JudyLPointers, (Word_t)string, PJE0);
 #endif
-        
-        freez(string);
+
+        // lookups may still be reading it, free it later
+        retired = string_retire___partition_locked(partition, string);
     }
 
-    rw_spinlock_write_unlock(&string_base[partition].spinlock);
+    spinlock_unlock(&string_base[partition].spinlock);
+
+    if(unlikely(retired))
+        string_retired_seal_and_reclaim(retired);
 }
 
 ALWAYS_INLINE
@@ -307,19 +535,19 @@ STRING *string_strdupz(const char *str) {
     if(unlikely(!length)) return NULL;
 
     length++;
-    uint8_t partition = string_partition_str(str);
-    STRING *string = string_index_search(str, length, partition);
+    uint32_t hash = string_hash(str, length);
+    STRING *string = string_index_search(str, length, hash);
 
     while(!string) {
         // The search above did not find anything,
         // We loop here, because during insert we may find an entry that is being deleted by another thread.
         // So, we have to let it go and retry to insert it again.
 
-        string = string_index_insert(str, length, partition);
+        string = string_index_insert(str, length, hash);
     }
 
     // statistics
-    string_stats_atomic_increment(partition, active_references);
+    string_stats_atomic_increment(string_partition_hash(hash), active_references);
 
 #ifdef FSANITIZE_ADDRESS
     // Add a stacktrace for this acquisition point too
@@ -333,13 +561,13 @@ ALWAYS_INLINE
 STRING *string_strndupz(const char *str, size_t len) {
     if(unlikely(!str || !*str || !len)) return NULL;
 
-    uint8_t partition = string_partition_str(str);
+    uint32_t hash = string_hash(str, len + 1);
 
-    STRING *string = string_index_search(str, len + 1, partition);
+    STRING *string = string_index_search(str, len + 1, hash);
     while(!string)
-        string = string_index_insert(str, len + 1, partition);
+        string = string_index_insert(str, len + 1, hash);
 
-    string_stats_atomic_increment(partition, active_references);
+    string_stats_atomic_increment(string_partition_hash(hash), active_references);
 
 #ifdef FSANITIZE_ADDRESS
     // Add a stacktrace for this acquisition point too
@@ -545,7 +773,7 @@ size_t string_destroy(void) {
     // Traverse all partitions
     for (size_t partition = 0; partition < STRING_PARTITIONS; partition++) {
         // Lock the partition to prevent new entries while we're cleaning up
-        rw_spinlock_write_lock(&string_base[partition].spinlock);
+        spinlock_lock(&string_base[partition].spinlock);
 
 #ifdef FSANITIZE_ADDRESS
         // First, collect statistics about remaining strings
@@ -589,17 +817,18 @@ size_t string_destroy(void) {
         }
 #endif
 
-        // Since JudyHS doesn't have simple traversal functions,
-        // we'll free the entire array at once.
-        if (string_base[partition].JudyHSArray) {
-            // We'll count all entries as "referenced" since we can't check them individually
+        // The strings still in the index are referenced, so we free only the index itself.
+        if (string_base[partition].hashtable) {
             referenced += string_base[partition].entries;
 
-            // Free the JudyHS array
-            JudyHSFreeArray(&string_base[partition].JudyHSArray, PJE0);
-            string_base[partition].JudyHSArray = NULL;
+            freez(string_base[partition].hashtable);
+            string_base[partition].hashtable = NULL;
         }
 
+        // the strings retired are not referenced, free them
+        string_retired_free(string_base[partition].retired);
+        string_base[partition].retired = NULL;
+
         // Reset partition statistics
         string_base[partition].inserts = 0;
         string_base[partition].deletes = 0;
@@ -619,9 +848,14 @@ size_t string_destroy(void) {
         string_base[partition].spins = 0;
 #endif
 
-        rw_spinlock_write_unlock(&string_base[partition].spinlock);
+        spinlock_unlock(&string_base[partition].spinlock);
     }
 
+    spinlock_lock(&string_reclaim.spinlock);
+    string_retired_free(string_reclaim.first);
+    string_reclaim.first = string_reclaim.last = NULL;
+    spinlock_unlock(&string_reclaim.spinlock);
+
 #ifdef FSANITIZE_ADDRESS
     // Collect stacktraces into an array for sorting
     typedef struct {
@@ -737,6 +971,147 @@ static size_t unittest_string_spins(void) {
 
 #endif // NETDATA_INTERNAL_CHECKS
 
+// ----------------------------------------------------------------------------
+// STRING stress benchmark, with skewed names
+
+#define STRING_BENCHMARK_HELD 64
+
+struct string_benchmark {
+    bool stop;
+    char **names;
+    size_t entries;
+    size_t operations;
+    size_t errors;
+};
+
+// names like the ones of charts, dimensions and labels, sharing a few prefixes
+static char **string_benchmark_generate_names(size_t entries) {
+    static const char *prefixes[] = { "k8s_", "cgroup_", "net.", "disk.", "system.", "app.", "netdata." };
+    static const char *suffixes[] = { "cpu", "mem", "io", "ops", "errors", "packets", "bandwidth", "utilization" };
+
+    char **names = mallocz(sizeof(char *) * entries);
+    for(size_t i = 0; i < entries ;i++) {
+        char buf[100 + 1];
+        snprintfz(buf, sizeof(buf) - 1, "%s%zu_%s",
+                  prefixes[i % _countof(prefixes)], i / _countof(prefixes), suffixes[i % _countof(suffixes)]);
+        names[i] = strdupz(buf);
+    }
+    return names;
+}
+
+// a few names are very popular, most are rare
+static ALWAYS_INLINE size_t string_benchmark_skewed_index(size_t entries) {
+    uint64_t r = os_random(entries);
+    return (size_t)((r * r / entries) * r / entries);
+}
+
+static void string_benchmark_thread(void *arg) {
+    struct string_benchmark *sb = arg;
+
+    STRING *held[STRING_BENCHMARK_HELD] = { 0 };
+    size_t operations = 0, errors = 0;
+
+    for(size_t i = 0; !__atomic_load_n(&sb->stop, __ATOMIC_RELAXED) ; i++) {
+        size_t idx = string_benchmark_skewed_index(sb->entries);
+        STRING *s = string_strdupz(sb->names[idx]);
+
+        // the same string must always give the same pointer
+        STRING *s2 = string_strdupz(sb->names[idx]);
+        if(s != s2 || strcmp(string2str(s), sb->names[idx]) != 0)
+            errors++;
+        string_freez(s2);
+
+        // keep a few of them for a while, releasing the oldest
+        size_t slot = i % STRING_BENCHMARK_HELD;
+        string_freez(held[slot]);
+        held[slot] = s;
+
+        operations += 3;
+    }
+
+    for(size_t i = 0; i < STRING_BENCHMARK_HELD ; i++)
+        string_freez(held[i]);
+
+    __atomic_add_fetch(&sb->operations, operations, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&sb->errors, errors, __ATOMIC_RELAXED);
+}
+
+static size_t string_benchmark(size_t threads, size_t entries, time_t seconds) {
+    struct string_benchmark sb = {
+        .names = string_benchmark_generate_names(entries),
+        .entries = entries,
+    };
+
+    long entries_starting = unittest_string_entries();
+
+    // check how evenly the names are spread over the partitions
+    {
+        STRING **strings = mallocz(entries * sizeof(STRING *));
+        long before[STRING_PARTITIONS];
+        for(size_t p = 0; p < STRING_PARTITIONS ;p++)
+            before[p] = string_base[p].entries;
+
+        for(size_t i = 0; i < entries ;i++)
+            strings[i] = string_strdupz(sb.names[i]);
+
+        long max = 0;
+        for(size_t p = 0; p < STRING_PARTITIONS ;p++) {
+            long added = string_base[p].entries - before[p];
+            if(added > max) max = added;
+        }
+
+        fprintf(stderr, "%zu names spread over %d partitions: max %ld, average %zu per partition\n",
+                entries, STRING_PARTITIONS, max, entries / STRING_PARTITIONS);
+
+        for(size_t i = 0; i < entries ;i++)
+            string_freez(strings[i]);
+
+        freez(strings);
+    }
+
+    fprintf(stderr, "Running STRING benchmark with %zu threads, on %zu skewed names, for %lld seconds...\n",
+            threads, entries, (long long)seconds);
+
+    size_t inserts, deletes, oinserts, odeletes;
+    string_statistics(&oinserts, &odeletes, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+    ND_THREAD **thread_ptrs = callocz(threads, sizeof(*thread_ptrs));
+    usec_t started_ut = now_monotonic_usec();
+
+    for(size_t i = 0; i < threads ; i++) {
+        char tag[ND_THREAD_TAG_MAX + 1];
+        snprintfz(tag, ND_THREAD_TAG_MAX, "STRBENCH[%zu]", i);
+        thread_ptrs[i] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DONT_LOG, string_benchmark_thread, &sb);
+    }
+
+    sleep_usec(seconds * USEC_PER_SEC);
+    __atomic_store_n(&sb.stop, true, __ATOMIC_RELAXED);
+
+    for(size_t i = 0; i < threads ; i++)
+        nd_thread_join(thread_ptrs[i]);
+
+    usec_t ended_ut = now_monotonic_usec();
+    freez(thread_ptrs);
+
+    string_statistics(&inserts, &deletes, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+    fprintf(stderr, "STRING benchmark: %0.2f M ops/s, %zu inserts, %zu deletes\n",
+            (double)sb.operations / (double)(ended_ut - started_ut),
+            inserts - oinserts, deletes - odeletes);
+
+    if(sb.errors)
+        fprintf(stderr, "ERROR: STRING benchmark found %zu strings with different pointers or contents\n", sb.errors);
+
+    if(unittest_string_entries() != entries_starting) {
+        fprintf(stderr, "ERROR: STRING benchmark left %ld strings in the index\n",
+                unittest_string_entries() - entries_starting);
+        sb.errors++;
+    }
+
+    string_unittest_free_char_pp(sb.names, entries);
+    return sb.errors;
+}
+
 int string_unittest(size_t entries) {
     size_t errors = 0;
 
@@ -954,6 +1329,8 @@ int string_unittest(size_t entries) {
 #endif
     }
 
+    errors += string_benchmark(4, 100000, 5);
+
     string_unittest_free_char_pp(names, entries);
 
     fprintf(stderr, "\n%zu errors found\n", errors);
@@ -962,7 +1339,7 @@ int string_unittest(size_t entries) {
 
 void string_init(void) {
     for (size_t i = 0; i != STRING_PARTITIONS; i++) {
-        rw_spinlock_init(&string_base[i].spinlock);
+        spinlock_init(&string_base[i].spinlock);
         
 #ifdef FSANITIZE_ADDRESS
         // Initialize the JudyL pointers array to NULL
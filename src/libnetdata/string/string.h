@@ -46,6 +46,9 @@ int string_unittest(size_t entries);
 
 void string_init(void);
 
+// the calling thread will not look up strings anymore - called when threads exit
+void string_thread_reader_release(void);
+
 static inline void cleanup_string_pp(STRING **stringpp) {
     if(stringpp)
         string_freez(*stringpp);
@@ -328,6 +328,8 @@ static void nd_thread_exit(ND_THREAD *nti) {
     rrdset_thread_rda_free();
     query_target_free();
     thread_cache_destroy();
+    aral_thread_magazines_release();
+    string_thread_reader_release();
     service_exits();
     worker_unregister();
 
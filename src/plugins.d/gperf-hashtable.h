@@ -56,6 +56,8 @@
 #define PLUGINSD_KEYWORD_ID_CONFIG                 100
 #define PLUGINSD_KEYWORD_ID_TRUST_DURATIONS        101
 #define PLUGINSD_KEYWORD_ID_PLUGIN_KEEPALIVE       102
+#define PLUGINSD_KEYWORD_ID_DATA_SHM_ATTACH        103
+#define PLUGINSD_KEYWORD_ID_DATA_SHM_FLUSH         104
 
 #define PLUGINSD_KEYWORD_ID_CLAIMED_ID             61
 #define PLUGINSD_KEYWORD_ID_BEGIN2                 2
@@ -79,7 +81,7 @@
 #define PLUGINSD_KEYWORD_ID_DELETE_JOB             906
 
 
-#define GPERF_PARSER_TOTAL_KEYWORDS 40
+#define GPERF_PARSER_TOTAL_KEYWORDS 42
 #define GPERF_PARSER_MIN_WORD_LENGTH 3
 #define GPERF_PARSER_MAX_WORD_LENGTH 22
 #define GPERF_PARSER_MIN_HASH_VALUE 4
@@ -134,95 +136,97 @@ static const PARSER_KEYWORD gperf_keywords[] =
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
-#line 71 "gperf-config.txt"
+#line 73 "gperf-config.txt"
     {"HOST",            PLUGINSD_KEYWORD_ID_HOST,            PARSER_INIT_PLUGINSD|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 4},
-#line 107 "gperf-config.txt"
+#line 111 "gperf-config.txt"
     {"REND",                 PLUGINSD_KEYWORD_ID_REND,                 PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 31},
-#line 70 "gperf-config.txt"
+#line 72 "gperf-config.txt"
     {"EXIT",            PLUGINSD_KEYWORD_ID_EXIT,            PARSER_INIT_PLUGINSD,                     WORKER_PARSER_FIRST_JOB + 3},
-#line 79 "gperf-config.txt"
+#line 83 "gperf-config.txt"
     {"CHART",                 PLUGINSD_KEYWORD_ID_CHART,                 PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA|PARSER_REP_REPLICATION, WORKER_PARSER_FIRST_JOB + 9},
-#line 91 "gperf-config.txt"
+#line 95 "gperf-config.txt"
     {"CONFIG",                PLUGINSD_KEYWORD_ID_CONFIG,                PARSER_INIT_PLUGINSD|PARSER_REP_METADATA,                       WORKER_PARSER_FIRST_JOB + 21},
-#line 88 "gperf-config.txt"
+#line 92 "gperf-config.txt"
     {"OVERWRITE",             PLUGINSD_KEYWORD_ID_OVERWRITE,             PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 18},
-#line 74 "gperf-config.txt"
+#line 76 "gperf-config.txt"
     {"HOST_LABEL",      PLUGINSD_KEYWORD_ID_HOST_LABEL,      PARSER_INIT_PLUGINSD|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 7},
-#line 72 "gperf-config.txt"
+#line 74 "gperf-config.txt"
     {"HOST_DEFINE",     PLUGINSD_KEYWORD_ID_HOST_DEFINE,     PARSER_INIT_PLUGINSD|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 5},
-#line 108 "gperf-config.txt"
+#line 112 "gperf-config.txt"
     {"RDSTATE",              PLUGINSD_KEYWORD_ID_RDSTATE,              PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 32},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
-#line 122 "gperf-config.txt"
+#line 126 "gperf-config.txt"
     {"DELETE_JOB",             PLUGINSD_KEYWORD_ID_DELETE_JOB,             PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 40},
-#line 73 "gperf-config.txt"
+#line 75 "gperf-config.txt"
     {"HOST_DEFINE_END", PLUGINSD_KEYWORD_ID_HOST_DEFINE_END, PARSER_INIT_PLUGINSD|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 6},
-#line 120 "gperf-config.txt"
+#line 124 "gperf-config.txt"
     {"DYNCFG_RESET",           PLUGINSD_KEYWORD_ID_DYNCFG_RESET,           PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 38},
-#line 117 "gperf-config.txt"
-    {"DYNCFG_ENABLE",          PLUGINSD_KEYWORD_ID_DYNCFG_ENABLE,          PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 35},
 #line 121 "gperf-config.txt"
+    {"DYNCFG_ENABLE",          PLUGINSD_KEYWORD_ID_DYNCFG_ENABLE,          PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 35},
+#line 125 "gperf-config.txt"
     {"REPORT_JOB_STATUS",      PLUGINSD_KEYWORD_ID_REPORT_JOB_STATUS,      PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 39},
-#line 89 "gperf-config.txt"
+#line 93 "gperf-config.txt"
     {"SET",                   PLUGINSD_KEYWORD_ID_SET,                   PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 19},
-#line 99 "gperf-config.txt"
+#line 103 "gperf-config.txt"
     {"SET2",       PLUGINSD_KEYWORD_ID_SET2,       PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 26},
-#line 106 "gperf-config.txt"
+#line 110 "gperf-config.txt"
     {"RSET",                 PLUGINSD_KEYWORD_ID_RSET,                 PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 30},
-#line 104 "gperf-config.txt"
+#line 108 "gperf-config.txt"
     {"CHART_DEFINITION_END", PLUGINSD_KEYWORD_ID_CHART_DEFINITION_END, PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 28},
-#line 119 "gperf-config.txt"
+#line 123 "gperf-config.txt"
     {"DYNCFG_REGISTER_JOB",    PLUGINSD_KEYWORD_ID_DYNCFG_REGISTER_JOB,    PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 37},
-#line 109 "gperf-config.txt"
+#line 113 "gperf-config.txt"
     {"RSSTATE",              PLUGINSD_KEYWORD_ID_RSSTATE,              PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 33},
-#line 80 "gperf-config.txt"
+#line 84 "gperf-config.txt"
     {"CLABEL",                PLUGINSD_KEYWORD_ID_CLABEL,                PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 10},
-#line 118 "gperf-config.txt"
+#line 122 "gperf-config.txt"
     {"DYNCFG_REGISTER_MODULE", PLUGINSD_KEYWORD_ID_DYNCFG_REGISTER_MODULE, PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING, WORKER_PARSER_FIRST_JOB + 36},
-#line 68 "gperf-config.txt"
+#line 70 "gperf-config.txt"
     {"FLUSH",           PLUGINSD_KEYWORD_ID_FLUSH,           PARSER_INIT_PLUGINSD,                     WORKER_PARSER_FIRST_JOB + 1},
-#line 84 "gperf-config.txt"
+#line 88 "gperf-config.txt"
     {"FUNCTION",              PLUGINSD_KEYWORD_ID_FUNCTION,              PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 14},
-#line 97 "gperf-config.txt"
+#line 101 "gperf-config.txt"
     {"CLAIMED_ID", PLUGINSD_KEYWORD_ID_CLAIMED_ID, PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 24},
-#line 83 "gperf-config.txt"
+#line 87 "gperf-config.txt"
     {"END",                   PLUGINSD_KEYWORD_ID_END,                   PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 13},
-#line 100 "gperf-config.txt"
+#line 104 "gperf-config.txt"
     {"END2",       PLUGINSD_KEYWORD_ID_END2,       PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 27},
-#line 81 "gperf-config.txt"
+#line 85 "gperf-config.txt"
     {"CLABEL_COMMIT",         PLUGINSD_KEYWORD_ID_CLABEL_COMMIT,         PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 11},
-#line 78 "gperf-config.txt"
+#line 82 "gperf-config.txt"
     {"BEGIN",                 PLUGINSD_KEYWORD_ID_BEGIN,                 PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 8},
-#line 98 "gperf-config.txt"
+#line 102 "gperf-config.txt"
     {"BEGIN2",     PLUGINSD_KEYWORD_ID_BEGIN2,     PARSER_INIT_STREAMING|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 25},
-#line 105 "gperf-config.txt"
+#line 109 "gperf-config.txt"
     {"RBEGIN",               PLUGINSD_KEYWORD_ID_RBEGIN,               PARSER_INIT_STREAMING|PARSER_REP_REPLICATION|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 29},
-#line 69 "gperf-config.txt"
+#line 71 "gperf-config.txt"
     {"DISABLE",         PLUGINSD_KEYWORD_ID_DISABLE,         PARSER_INIT_PLUGINSD,                     WORKER_PARSER_FIRST_JOB + 2},
-#line 86 "gperf-config.txt"
+#line 90 "gperf-config.txt"
     {"FUNCTION_PROGRESS",     PLUGINSD_KEYWORD_ID_FUNCTION_PROGRESS,     PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING,                     WORKER_PARSER_FIRST_JOB + 16},
-#line 82 "gperf-config.txt"
+#line 86 "gperf-config.txt"
     {"DIMENSION",             PLUGINSD_KEYWORD_ID_DIMENSION,             PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 12},
-#line 90 "gperf-config.txt"
+#line 94 "gperf-config.txt"
     {"VARIABLE",              PLUGINSD_KEYWORD_ID_VARIABLE,              PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 20},
-#line 92 "gperf-config.txt"
+#line 96 "gperf-config.txt"
     {"TRUST_DURATIONS",       PLUGINSD_KEYWORD_ID_TRUST_DURATIONS,       PARSER_INIT_PLUGINSD|PARSER_REP_METADATA,                       WORKER_PARSER_FIRST_JOB + 22},
-#line 85 "gperf-config.txt"
+#line 89 "gperf-config.txt"
     {"FUNCTION_RESULT_BEGIN", PLUGINSD_KEYWORD_ID_FUNCTION_RESULT_BEGIN, PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING,                     WORKER_PARSER_FIRST_JOB + 15},
-#line 93 "gperf-config.txt"
+#line 97 "gperf-config.txt"
     {"PLUGIN_KEEPALIVE",      PLUGINSD_KEYWORD_ID_PLUGIN_KEEPALIVE,      PARSER_INIT_PLUGINSD,                                           WORKER_PARSER_FIRST_JOB + 23},
-#line 113 "gperf-config.txt"
+#line 117 "gperf-config.txt"
     {"JSON",                 PLUGINSD_KEYWORD_ID_JSON,                 PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 34},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
+#line 78 "gperf-config.txt"
+    {"DATA_SHM_FLUSH",  PLUGINSD_KEYWORD_ID_DATA_SHM_FLUSH,  PARSER_INIT_PLUGINSD|PARSER_REP_DATA,     WORKER_PARSER_FIRST_JOB + 42},
+#line 77 "gperf-config.txt"
+    {"DATA_SHM_ATTACH", PLUGINSD_KEYWORD_ID_DATA_SHM_ATTACH, PARSER_INIT_PLUGINSD,                     WORKER_PARSER_FIRST_JOB + 41},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
     {(char*)0,0,PARSER_INIT_PLUGINSD,0},
-    {(char*)0,0,PARSER_INIT_PLUGINSD,0},
-    {(char*)0,0,PARSER_INIT_PLUGINSD,0},
-#line 87 "gperf-config.txt"
+#line 91 "gperf-config.txt"
     {"LABEL",                 PLUGINSD_KEYWORD_ID_LABEL,                 PARSER_INIT_PLUGINSD|PARSER_INIT_STREAMING|PARSER_REP_METADATA, WORKER_PARSER_FIRST_JOB + 17}
   };
 
@@ -282,6 +282,10 @@ void *pluginsd_main(void *ptr) {
     if (scan_frequency < 1)
         scan_frequency = 1;
 
+    // let the plugins know they can send their data via shared memory (opt-in)
+    if (inicfg_get_boolean(&netdata_config, CONFIG_SECTION_PLUGINS, "data via shared memory", CONFIG_BOOLEAN_NO))
+        nd_setenv(PLUGINSD_SHM_ENV_VARIABLE, "1", 1);
+
     // disable some plugins by default
     inicfg_get_boolean(&netdata_config, CONFIG_SECTION_PLUGINS, "slabinfo", CONFIG_BOOLEAN_NO);
     // it crashes (both threads) on Alpine after we made it multi-threaded
@@ -67,6 +67,7 @@ void parser_destroy(PARSER *parser) {
         return;
 
     pluginsd_inflight_functions_cleanup(parser);
+    pluginsd_shm_destroy(parser->shm);
 
     freez(parser);
 }
@@ -257,7 +257,7 @@ static inline void pluginsd_rrddim_put_to_slot(PARSER *parser, RRDSET *st, RRDDI
     }
 }
 
-static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension(RRDHOST *host, RRDSET *st, const char *dimension, ssize_t slot, const char *cmd) {
+static ALWAYS_INLINE struct pluginsd_rrddim *pluginsd_acquire_dimension_slot(RRDHOST *host, RRDSET *st, const char *dimension, ssize_t slot, const char *cmd) {
     if (unlikely(!dimension || !*dimension)) {
         netdata_log_error("PLUGINSD: 'host:%s/chart:%s' got a %s, without a dimension.",
                           rrdhost_hostname(host), rrdset_id(st), cmd);
@@ -306,7 +306,7 @@ static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension(RRDHOST *host, RRDSET *s
                                dimension, slot, prd->id ? prd->id : "(null)", t);
             }
 #endif
-            return rd;
+            return prd;
         }
     }
     else {
@@ -325,7 +325,7 @@ static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension(RRDHOST *host, RRDSET *s
 
             if(id && *id && strcmp(id, dimension) == 0) {
                 // we found it cached
-                return rd;
+                return prd;
             }
             else {
                 // the cached one is not good for us
@@ -351,7 +351,26 @@ static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension(RRDHOST *host, RRDSET *s
     prd->rd = rd = rrddim_acquired_to_rrddim(rda);
     prd->id = string2str(rd->id);
 
-    return rd;
+    return prd;
+}
+
+static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension(RRDHOST *host, RRDSET *st, const char *dimension, ssize_t slot, const char *cmd) {
+    struct pluginsd_rrddim *prd = pluginsd_acquire_dimension_slot(host, st, dimension, slot, cmd);
+    return prd ? prd->rd : NULL;
+}
+
+// the binary data plane addresses dimensions only by their slot
+static ALWAYS_INLINE RRDDIM *pluginsd_acquire_dimension_from_slot(RRDHOST *host, RRDSET *st, ssize_t slot, const char *cmd) {
+    // Get the array - we're protected by collector_tid being set, so it won't be freed
+    PRD_ARRAY *arr = prd_array_get_unsafe(&st->pluginsd.prd_array);
+
+    if(unlikely(!st->pluginsd.dims_with_slots || !arr || slot < 1 || slot > (ssize_t)arr->size || !arr->entries[slot - 1].rd)) {
+        netdata_log_error("PLUGINSD: 'host:%s/chart:%s' got a %s with dimension slot %zd, but no dimension has been defined on this slot.",
+                          rrdhost_hostname(host), rrdset_id(st), cmd, slot);
+        return NULL;
+    }
+
+    return arr->entries[slot - 1].rd;
 }
 
 static inline RRDSET *pluginsd_find_chart(RRDHOST *host, const char *chart, const char *cmd) {
@@ -435,6 +454,17 @@ static ALWAYS_INLINE RRDSET *pluginsd_rrdset_cache_get_from_slot(PARSER *parser,
     return st;
 }
 
+// the binary data plane addresses charts only by their slot
+static ALWAYS_INLINE RRDSET *pluginsd_rrdset_cache_get_from_slot_only(RRDHOST *host, ssize_t slot, const char *keyword) {
+    if(unlikely(slot < 1 || (size_t)slot > host->stream.rcv.pluginsd_chart_slots.size || !host->stream.rcv.pluginsd_chart_slots.array[slot - 1])) {
+        netdata_log_error("PLUGINSD: 'host:%s' got a %s with chart slot %zd, but no chart has been defined on this slot.",
+                          rrdhost_hostname(host), keyword, slot);
+        return NULL;
+    }
+
+    return host->stream.rcv.pluginsd_chart_slots.array[slot - 1];
+}
+
 static inline SN_FLAGS pluginsd_parse_storage_number_flags(const char *flags_str) {
     SN_FLAGS flags = SN_FLAG_NONE;
 
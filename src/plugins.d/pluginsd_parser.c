@@ -37,30 +37,10 @@ static inline PARSER_RC pluginsd_set(char **words, size_t num_words, PARSER *par
     return PARSER_RC_OK;
 }
 
-static inline PARSER_RC pluginsd_begin(char **words, size_t num_words, PARSER *parser) {
-    int idx = 1;
-    ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
-    if(slot >= 0) idx++;
-
-    char *id = get_word(words, num_words, idx++);
-    char *microseconds_txt = get_word(words, num_words, idx++);
-
-    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_BEGIN);
-    if(!host) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
-
-    RRDSET *st = pluginsd_rrdset_cache_get_from_slot(parser, host, id, slot, PLUGINSD_KEYWORD_BEGIN);
-    if(!st) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
-
+static inline PARSER_RC pluginsd_begin_chart(PARSER *parser, RRDHOST *host __maybe_unused, RRDSET *st, usec_t microseconds) {
     if(!pluginsd_set_scope_chart(parser, st, PLUGINSD_KEYWORD_BEGIN))
         return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
 
-    usec_t microseconds = 0;
-    if (microseconds_txt && *microseconds_txt) {
-        long long t = str2ll(microseconds_txt, NULL);
-        if(t >= 0)
-            microseconds = t;
-    }
-
 #ifdef NETDATA_LOG_REPLICATION_REQUESTS
     if(st->replay.log_next_data_collection) {
         st->replay.log_next_data_collection = false;
@@ -88,36 +68,65 @@ static inline PARSER_RC pluginsd_begin(char **words, size_t num_words, PARSER *p
     return PARSER_RC_OK;
 }
 
-static inline PARSER_RC pluginsd_end(char **words, size_t num_words, PARSER *parser) {
-    char *tv_sec = get_word(words, num_words, 1);
-    char *tv_usec = get_word(words, num_words, 2);
-    char *pending_rrdset_next = get_word(words, num_words, 3);
+static inline PARSER_RC pluginsd_begin(char **words, size_t num_words, PARSER *parser) {
+    int idx = 1;
+    ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
+    if(slot >= 0) idx++;
 
-    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_END);
+    char *id = get_word(words, num_words, idx++);
+    char *microseconds_txt = get_word(words, num_words, idx++);
+
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_BEGIN);
     if(!host) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
 
-    RRDSET *st = pluginsd_require_scope_chart(parser, PLUGINSD_KEYWORD_END, PLUGINSD_KEYWORD_BEGIN);
+    RRDSET *st = pluginsd_rrdset_cache_get_from_slot(parser, host, id, slot, PLUGINSD_KEYWORD_BEGIN);
     if(!st) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
 
+    usec_t microseconds = 0;
+    if (microseconds_txt && *microseconds_txt) {
+        long long t = str2ll(microseconds_txt, NULL);
+        if(t >= 0)
+            microseconds = t;
+    }
+
+    return pluginsd_begin_chart(parser, host, st, microseconds);
+}
+
+static inline PARSER_RC pluginsd_end_chart(PARSER *parser, RRDSET *st, struct timeval tv, bool pending_rrdset_next) {
     if (unlikely(rrdset_flag_check(st, RRDSET_FLAG_DEBUG)))
         netdata_log_debug(D_PLUGINSD, "requested an END on chart '%s'", rrdset_id(st));
 
     pluginsd_clear_scope_chart(parser, PLUGINSD_KEYWORD_END, NULL);
     parser->user.data_collections_count++;
 
-    struct timeval tv = {
-        .tv_sec  = (tv_sec  && *tv_sec)  ? str2ll(tv_sec,  NULL) : 0,
-        .tv_usec = (tv_usec && *tv_usec) ? str2ll(tv_usec, NULL) : 0
-    };
-    
     if(!tv.tv_sec)
         now_realtime_timeval(&tv);
 
-    rrdset_timed_done(st, tv, pending_rrdset_next && *pending_rrdset_next ? true : false);
+    // inline - the ingestion pipeline is attached only to children that send BEGIN2/END2
+    rrdset_timed_done(st, tv, pending_rrdset_next);
 
     return PARSER_RC_OK;
 }
 
+static inline PARSER_RC pluginsd_end(char **words, size_t num_words, PARSER *parser) {
+    char *tv_sec = get_word(words, num_words, 1);
+    char *tv_usec = get_word(words, num_words, 2);
+    char *pending_rrdset_next = get_word(words, num_words, 3);
+
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_END);
+    if(!host) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    RRDSET *st = pluginsd_require_scope_chart(parser, PLUGINSD_KEYWORD_END, PLUGINSD_KEYWORD_BEGIN);
+    if(!st) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    struct timeval tv = {
+        .tv_sec  = (tv_sec  && *tv_sec)  ? str2ll(tv_sec,  NULL) : 0,
+        .tv_usec = (tv_usec && *tv_usec) ? str2ll(tv_usec, NULL) : 0
+    };
+
+    return pluginsd_end_chart(parser, st, tv, pending_rrdset_next && *pending_rrdset_next ? true : false);
+}
+
 static void pluginsd_host_define_cleanup(PARSER *parser) {
     string_freez(parser->user.host_define.hostname);
     rrdlabels_destroy(parser->user.host_define.rrdlabels);
@@ -805,6 +814,10 @@ static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words,
     RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_BEGIN_V2);
     if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
 
+    // a BEGIN2 without an END2 leaves the points of the previous chart update queued
+    if(unlikely(parser->user.ingestion.rsa))
+        rrdhost_ingestion_batch_submit(host, &parser->user.ingestion);
+
     timing_step(TIMING_STEP_BEGIN2_PREPARE);
 
     RRDSET *st = pluginsd_rrdset_cache_get_from_slot(parser, host, id, slot, PLUGINSD_KEYWORD_BEGIN_V2);
@@ -851,6 +864,10 @@ static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words,
     parser->user.v2.wall_clock_time = wall_clock_time;
     parser->user.v2.ml_locked = ml_chart_update_begin(st);
 
+    if(rrdhost_ingestion_pipelined(host))
+        // when the chart cannot be acquired, its points are stored inline
+        rrdhost_ingestion_batch_begin(&parser->user.ingestion, st, end_time * USEC_PER_SEC, false);
+
     timing_step(TIMING_STEP_BEGIN2_ML);
 
     // ------------------------------------------------------------------------
@@ -955,8 +972,9 @@ static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, P
 
     timing_step(TIMING_STEP_SET2_PREPARE);
 
-    RRDDIM *rd = pluginsd_acquire_dimension(host, st, dimension, slot, PLUGINSD_KEYWORD_SET_V2);
-    if(unlikely(!rd)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+    struct pluginsd_rrddim *prd = pluginsd_acquire_dimension_slot(host, st, dimension, slot, PLUGINSD_KEYWORD_SET_V2);
+    if(unlikely(!prd)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+    RRDDIM *rd = prd->rd;
 
     st->pluginsd.set = true;
 
@@ -1078,7 +1096,11 @@ static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, P
     // ------------------------------------------------------------------------
     // store it
 
-    rrddim_store_metric(rd, parser->user.v2.end_time * USEC_PER_SEC, value, flags);
+    if(parser->user.ingestion.rsa)
+        rrdhost_ingestion_batch_add(&parser->user.ingestion, prd->rda, value, flags);
+    else
+        rrddim_store_metric(rd, parser->user.v2.end_time * USEC_PER_SEC, value, flags);
+
     rd->collector.last_collected_time.tv_sec = parser->user.v2.end_time;
     rd->collector.last_collected_time.tv_usec = 0;
     if(sender_sent_float)
@@ -1122,8 +1144,14 @@ static ALWAYS_INLINE PARSER_RC pluginsd_end_v2(char **words __maybe_unused, size
     // unblock data collection
 
     rrdset_previous_scope_chart_unlock(parser, PLUGINSD_KEYWORD_END_V2, false);
-    rrdcontext_collected_rrdset(st);
-    store_metric_collection_completed();
+
+    if(parser->user.ingestion.rsa)
+        // the storage worker will mark the chart as collected, after storing its points
+        rrdhost_ingestion_batch_submit(host, &parser->user.ingestion);
+    else {
+        rrdcontext_collected_rrdset(st);
+        store_metric_collection_completed();
+    }
 
     timing_step(TIMING_STEP_END2_RRDSET);
 
@@ -1207,6 +1235,125 @@ static inline PARSER_RC pluginsd_plugin_keepalive(char **words __maybe_unused, s
     return PARSER_RC_OK;
 }
 
+// ----------------------------------------------------------------------------
+// the binary data plane of external plugins
+
+static inline PARSER_RC pluginsd_data_shm_attach(char **words, size_t num_words, PARSER *parser) {
+    char *name = get_word(words, num_words, 1);
+    char *size_str = get_word(words, num_words, 2);
+
+    if(unlikely(!name || !*name || !size_str || !*size_str))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_ATTACH, "missing parameters");
+
+    if(unlikely(parser->shm))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_ATTACH, "the shared memory is already attached");
+
+    // when we cannot attach, the plugin continues to send its data as text
+    parser->shm = pluginsd_shm_consumer_attach(name, str2ull(size_str, NULL));
+    if(parser->shm)
+        nd_log(NDLS_COLLECTORS, NDLP_INFO,
+               "PLUGINSD: plugin '%s' sends its data via the shared memory '%s'",
+               parser->user.cd ? string2str(parser->user.cd->filename) : "unknown", name);
+
+    return PARSER_RC_OK;
+}
+
+static ALWAYS_INLINE PARSER_RC pluginsd_data_shm_begin(PARSER *parser, PLUGINSD_SHM_RECORD *r) {
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_BEGIN);
+    if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    RRDSET *st = pluginsd_rrdset_cache_get_from_slot_only(host, r->slot, PLUGINSD_KEYWORD_BEGIN);
+    if(unlikely(!st)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    return pluginsd_begin_chart(parser, host, st, r->u64);
+}
+
+static ALWAYS_INLINE PARSER_RC pluginsd_data_shm_set(PARSER *parser, PLUGINSD_SHM_RECORD *r) {
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_SET);
+    if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    RRDSET *st = pluginsd_require_scope_chart(parser, PLUGINSD_KEYWORD_SET, PLUGINSD_KEYWORD_BEGIN);
+    if(unlikely(!st)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    RRDDIM *rd = pluginsd_acquire_dimension_from_slot(host, st, r->slot, PLUGINSD_KEYWORD_SET);
+    if(unlikely(!rd)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    st->pluginsd.set = true;
+
+    if(r->flags & PLUGINSD_SHM_FLAG_EMPTY)
+        return PARSER_RC_OK;
+
+    if(r->flags & PLUGINSD_SHM_FLAG_DOUBLE) {
+        if(rrddim_is_float(rd))
+            rrddim_set_by_pointer_double(st, rd, (NETDATA_DOUBLE)r->f64);
+        else
+            rrddim_set_by_pointer(st, rd, (collected_number)r->f64);
+    }
+    else {
+        if(rrddim_is_float(rd))
+            rrddim_set_by_pointer_double(st, rd, (NETDATA_DOUBLE)r->i64);
+        else
+            rrddim_set_by_pointer(st, rd, r->i64);
+    }
+
+    return PARSER_RC_OK;
+}
+
+static ALWAYS_INLINE PARSER_RC pluginsd_data_shm_end(PARSER *parser, PLUGINSD_SHM_RECORD *r) {
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_END);
+    if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    RRDSET *st = pluginsd_require_scope_chart(parser, PLUGINSD_KEYWORD_END, PLUGINSD_KEYWORD_BEGIN);
+    if(unlikely(!st)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+
+    struct timeval tv = {
+        .tv_sec = (time_t)(r->u64 / USEC_PER_SEC),
+        .tv_usec = (suseconds_t)(r->u64 % USEC_PER_SEC),
+    };
+
+    return pluginsd_end_chart(parser, st, tv, (r->flags & PLUGINSD_SHM_FLAG_PENDING_NEXT) ? true : false);
+}
+
+static inline PARSER_RC pluginsd_data_shm_flush(char **words, size_t num_words, PARSER *parser) {
+    char *pos_str = get_word(words, num_words, 1);
+
+    if(unlikely(!pos_str || !*pos_str))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_FLUSH, "missing parameters");
+
+    if(unlikely(!parser->shm))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_FLUSH, "the shared memory is not attached");
+
+    ssize_t pending = pluginsd_shm_consumer_pending(parser->shm, str2ull(pos_str, NULL));
+    if(unlikely(pending < 0))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_FLUSH, "invalid position");
+
+    PARSER_RC rc = PARSER_RC_OK;
+    while(pending-- > 0 && rc == PARSER_RC_OK) {
+        PLUGINSD_SHM_RECORD r = pluginsd_shm_consumer_next(parser->shm);
+
+        switch(r.type) {
+            case PLUGINSD_SHM_RECORD_SET:
+                rc = pluginsd_data_shm_set(parser, &r);
+                break;
+
+            case PLUGINSD_SHM_RECORD_BEGIN:
+                rc = pluginsd_data_shm_begin(parser, &r);
+                break;
+
+            case PLUGINSD_SHM_RECORD_END:
+                rc = pluginsd_data_shm_end(parser, &r);
+                break;
+
+            default:
+                rc = PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_DATA_SHM_FLUSH, "invalid record type");
+                break;
+        }
+    }
+
+    pluginsd_shm_consumer_release(parser->shm);
+    return rc;
+}
+
 static void pluginsd_json_stream_paths(PARSER *parser, void *action_data __maybe_unused) {
     stream_path_set_from_json(parser->user.host, buffer_tostring(parser->defer.response), false);
     buffer_free(parser->defer.response);
@@ -1250,6 +1397,9 @@ PARSER_RC stream_receiver_pluginsd_claimed_id(char **words, size_t num_words, PA
 void pluginsd_cleanup_v2(PARSER *parser) {
     // this is called when the thread is stopped while processing
     pluginsd_clear_scope_chart(parser, "THREAD CLEANUP", NULL);
+
+    // the points of an unfinished chart update are dropped, the ones already queued are stored
+    rrdhost_ingestion_batch_cleanup(&parser->user.ingestion);
 }
 
 void pluginsd_process_cleanup(PARSER *parser) {
@@ -1410,6 +1560,8 @@ ALWAYS_INLINE PARSER_RC parser_execute(PARSER *parser, const PARSER_KEYWORD *key
     switch(keyword->id) {
         case PLUGINSD_KEYWORD_ID_SET2:
             return pluginsd_set_v2(words, num_words, parser);
+        case PLUGINSD_KEYWORD_ID_DATA_SHM_FLUSH:
+            return pluginsd_data_shm_flush(words, num_words, parser);
         case PLUGINSD_KEYWORD_ID_BEGIN2:
             return pluginsd_begin_v2(words, num_words, parser);
         case PLUGINSD_KEYWORD_ID_END2:
@@ -1476,6 +1628,8 @@ ALWAYS_INLINE PARSER_RC parser_execute(PARSER *parser, const PARSER_KEYWORD *key
             return pluginsd_trust_durations(words, num_words, parser);
         case PLUGINSD_KEYWORD_ID_PLUGIN_KEEPALIVE:
             return pluginsd_plugin_keepalive(words, num_words, parser);
+        case PLUGINSD_KEYWORD_ID_DATA_SHM_ATTACH:
+            return pluginsd_data_shm_attach(words, num_words, parser);
 
         case PLUGINSD_KEYWORD_ID_DYNCFG_ENABLE:
         case PLUGINSD_KEYWORD_ID_DYNCFG_REGISTER_MODULE:
@@ -1539,3 +1693,422 @@ int pluginsd_parser_unittest(void) {
     parser_destroy(p);
     return 0;
 }
+
+// ----------------------------------------------------------------------------
+// benchmark of the text protocol vs the binary data plane of external plugins
+// both consumers tokenize the text they receive and decode the values, but they do not store them
+
+#define PLUGINSD_SHM_BENCHMARK_CHARTS 100
+#define PLUGINSD_SHM_BENCHMARK_DIMENSIONS 30
+#define PLUGINSD_SHM_BENCHMARK_ITERATIONS 1000
+
+struct pluginsd_shm_benchmark {
+    FILE *fp;
+    bool shm;
+};
+
+static void pluginsd_shm_benchmark_producer(void *ptr) {
+    struct pluginsd_shm_benchmark *b = ptr;
+
+    PLUGINSD_SHM_RING *ring = NULL;
+    if(b->shm) {
+        ring = pluginsd_shm_producer_create(b->fp, 0);
+        if(!ring)
+            fatal("PLUGINSD SHM BENCHMARK: cannot create the shared memory ring");
+
+        while(!pluginsd_shm_producer_active(ring))
+            sleep_usec(100);
+    }
+
+    for(size_t i = 0; i < PLUGINSD_SHM_BENCHMARK_ITERATIONS ; i++) {
+        for(size_t c = 0; c < PLUGINSD_SHM_BENCHMARK_CHARTS ; c++) {
+            if(ring) {
+                pluginsd_shm_begin(ring, c + 1, 0);
+                for(size_t d = 0; d < PLUGINSD_SHM_BENCHMARK_DIMENSIONS ; d++)
+                    pluginsd_shm_set_int(ring, d + 1, (int64_t)(i * 1000 + d * c));
+                pluginsd_shm_end(ring, 0, false);
+            }
+            else {
+                fprintf(b->fp, PLUGINSD_KEYWORD_BEGIN " 'chart_%zu'\n", c);
+                for(size_t d = 0; d < PLUGINSD_SHM_BENCHMARK_DIMENSIONS ; d++)
+                    fprintf(b->fp, PLUGINSD_KEYWORD_SET " 'dimension_%zu' = %lld\n", d, (long long)(i * 1000 + d * c));
+                fprintf(b->fp, PLUGINSD_KEYWORD_END "\n");
+            }
+        }
+
+        pluginsd_shm_producer_flush(ring);
+        fflush(b->fp);
+    }
+
+    fclose(b->fp);
+    pluginsd_shm_destroy(ring);
+}
+
+static double pluginsd_shm_benchmark_run(PARSER *p, bool shm) {
+    int fds[2];
+    if(pipe(fds) != 0)
+        fatal("PLUGINSD SHM BENCHMARK: cannot create a pipe");
+
+    struct pluginsd_shm_benchmark b = {
+        .fp = fdopen(fds[1], "w"),
+        .shm = shm,
+    };
+
+    usec_t started_ut = now_monotonic_usec();
+    ND_THREAD *thread = nd_thread_create("SHMBENCH", NETDATA_THREAD_OPTION_DONT_LOG, pluginsd_shm_benchmark_producer, &b);
+
+    struct buffered_reader reader;
+    buffered_reader_init(&reader);
+    CLEAN_BUFFER *line = buffer_create(sizeof(reader.read_buffer) + 2, NULL);
+    char *words[PLUGINSD_MAX_WORDS];
+    PLUGINSD_SHM_RING *ring = NULL;
+    size_t values = 0;
+    int64_t sum = 0;
+
+    while(true) {
+        if(!buffered_reader_next_line(&reader, line)) {
+            if(buffered_reader_read_timeout(&reader, fds[0], 60 * MSEC_PER_SEC, false) != BUFFERED_READER_READ_OK)
+                break;
+            continue;
+        }
+
+        size_t num_words = quoted_strings_splitter_pluginsd(line->buffer, words, PLUGINSD_MAX_WORDS);
+        const char *command = get_word(words, num_words, 0);
+        const PARSER_KEYWORD *keyword = command ? parser_find_keyword(p, command) : NULL;
+
+        switch(keyword ? keyword->id : 0) {
+            case PLUGINSD_KEYWORD_ID_SET:
+                sum += str2ll_encoded(get_word(words, num_words, 2));
+                values++;
+                break;
+
+            case PLUGINSD_KEYWORD_ID_DATA_SHM_ATTACH:
+                ring = pluginsd_shm_consumer_attach(get_word(words, num_words, 1), str2ull(get_word(words, num_words, 2), NULL));
+                break;
+
+            case PLUGINSD_KEYWORD_ID_DATA_SHM_FLUSH: {
+                ssize_t pending = ring ? pluginsd_shm_consumer_pending(ring, str2ull(get_word(words, num_words, 1), NULL)) : -1;
+                if(pending < 0)
+                    fatal("PLUGINSD SHM BENCHMARK: invalid flush position");
+
+                while(pending-- > 0) {
+                    PLUGINSD_SHM_RECORD r = pluginsd_shm_consumer_next(ring);
+                    if(r.type == PLUGINSD_SHM_RECORD_SET) {
+                        sum += r.i64;
+                        values++;
+                    }
+                }
+                pluginsd_shm_consumer_release(ring);
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        line->len = 0;
+        line->buffer[0] = '\0';
+    }
+
+    nd_thread_join(thread);
+    usec_t ended_ut = now_monotonic_usec();
+
+    pluginsd_shm_destroy(ring);
+    close(fds[0]);
+
+    size_t expected = (size_t)PLUGINSD_SHM_BENCHMARK_ITERATIONS * PLUGINSD_SHM_BENCHMARK_CHARTS * PLUGINSD_SHM_BENCHMARK_DIMENSIONS;
+    if(values != expected)
+        fatal("PLUGINSD SHM BENCHMARK: received %zu values, expected %zu", values, expected);
+
+    double values_per_sec = (double)values * USEC_PER_SEC / (double)(ended_ut - started_ut);
+    fprintf(stderr, "%-25s: %zu values in %0.2f ms, %0.2f million values/s (checksum %"PRId64")\n",
+            shm ? "shared memory" : "text over pipe", values,
+            (double)(ended_ut - started_ut) / USEC_PER_MS, values_per_sec / 1000000.0, sum);
+
+    return values_per_sec;
+}
+
+int pluginsd_shm_benchmark(void) {
+    nd_setenv(PLUGINSD_SHM_ENV_VARIABLE, "1", 1);
+
+    PARSER *p = parser_init(NULL, -1, -1, PARSER_INPUT_SPLIT, NULL);
+    pluginsd_keywords_init(p, PARSER_INIT_PLUGINSD);
+
+    double text = pluginsd_shm_benchmark_run(p, false);
+    double shm = pluginsd_shm_benchmark_run(p, true);
+
+    fprintf(stderr, "\nshared memory is %0.2fx the values/s of text\n", shm / text);
+
+    parser_destroy(p);
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// unit test of the binary data plane of external plugins
+// the plugin side writes to a memory stream, and we give its lines to the parser, in order
+
+#if !defined(OS_WINDOWS)
+
+struct pluginsd_shm_unittest {
+    PARSER *parser;
+    FILE *fp;
+    char *buf;
+    size_t len;
+    size_t parsed;
+};
+
+static void pluginsd_shm_unittest_init(struct pluginsd_shm_unittest *t, PARSER_USER_OBJECT *user) {
+    memset(t, 0, sizeof(*t));
+    t->fp = open_memstream(&t->buf, &t->len);
+    if(!t->fp)
+        fatal("PLUGINSD SHM UNITTEST: cannot create a memory stream");
+
+    t->parser = parser_init(user, -1, -1, PARSER_INPUT_SPLIT, NULL);
+    pluginsd_keywords_init(t->parser, PARSER_INIT_PLUGINSD);
+}
+
+static void pluginsd_shm_unittest_cleanup(struct pluginsd_shm_unittest *t) {
+    pluginsd_process_cleanup(t->parser);
+    fclose(t->fp);
+    free(t->buf);
+}
+
+// parse everything the plugin has written so far, returns the number of lines that failed
+static size_t pluginsd_shm_unittest_feed(struct pluginsd_shm_unittest *t) {
+    fflush(t->fp);
+
+    size_t failed = 0;
+    char line[PLUGINSD_LINE_MAX + 1];
+    while(t->parsed < t->len) {
+        const char *s = &t->buf[t->parsed];
+        const char *nl = memchr(s, '\n', t->len - t->parsed);
+        size_t len = nl ? (size_t)(nl - s) + 1 : t->len - t->parsed;
+        t->parsed += len;
+
+        if(len > PLUGINSD_LINE_MAX)
+            len = PLUGINSD_LINE_MAX;
+
+        memcpy(line, s, len);
+        line[len] = '\0';
+
+        if(parser_action(t->parser, line))
+            failed++;
+    }
+
+    return failed;
+}
+
+static int pluginsd_shm_unittest_check(bool ok, const char *msg) {
+    fprintf(stderr, "    %-6s %s\n", ok ? "OK" : "FAILED", msg);
+    return ok ? 0 : 1;
+}
+
+static int pluginsd_shm_unittest_headers(void) {
+    const char *cases[] = {
+        "a valid ring is attached",
+        "a ring with a wrong magic is refused",
+        "a ring with a wrong version is refused",
+        "a ring with a wrong record size is refused",
+        "a ring with records not a power of 2 is refused",
+        "a ring with more records than its size is refused",
+        "a ring with a different size than requested is refused",
+        NULL,
+    };
+
+    int errors = 0;
+    fprintf(stderr, "\nPLUGINSD SHM: attaching to rings\n");
+
+    for(size_t i = 0; cases[i] ; i++) {
+        struct pluginsd_shm_unittest t;
+        pluginsd_shm_unittest_init(&t, NULL);
+
+        PLUGINSD_SHM_RING *ring = pluginsd_shm_producer_create(t.fp, 16);
+        if(!ring) {
+            errors += pluginsd_shm_unittest_check(false, "cannot create a ring");
+            pluginsd_shm_unittest_cleanup(&t);
+            continue;
+        }
+
+        size_t size = ring->size;
+        switch(i) {
+            case 1: ring->header->magic = ~PLUGINSD_SHM_MAGIC; break;
+            case 2: ring->header->version = PLUGINSD_SHM_VERSION + 1; break;
+            case 3: ring->header->record_size = sizeof(PLUGINSD_SHM_RECORD) * 2; break;
+            case 4: ring->header->records = 15; break;
+            case 5: ring->header->records = 32; break;
+            case 6: size += sizeof(PLUGINSD_SHM_RECORD); break;
+            default: break;
+        }
+
+        // ignore the attach request of the producer, send ours with the size we want
+        fflush(t.fp);
+        t.parsed = t.len;
+        fprintf(t.fp, PLUGINSD_KEYWORD_DATA_SHM_ATTACH " '%s' %zu\n", ring->name, size);
+
+        // a refused ring is not an error, the plugin continues with text
+        bool attached = (i == 0);
+        errors += pluginsd_shm_unittest_check(
+            pluginsd_shm_unittest_feed(&t) == 0 &&
+                (t.parser->shm != NULL) == attached &&
+                pluginsd_shm_producer_active(ring) == attached,
+            cases[i]);
+
+        pluginsd_shm_unittest_cleanup(&t);
+        pluginsd_shm_destroy(ring);
+    }
+
+    const char *names[] = { "netdata-pluginsd", "/netdata/pluginsd", "/../netdata", "/", NULL };
+    for(size_t i = 0; names[i] ; i++) {
+        struct pluginsd_shm_unittest t;
+        pluginsd_shm_unittest_init(&t, NULL);
+
+        char msg[100];
+        snprintfz(msg, sizeof(msg), "the invalid name '%s' is refused", names[i]);
+        fprintf(t.fp, PLUGINSD_KEYWORD_DATA_SHM_ATTACH " '%s' %zu\n", names[i], (size_t)4096);
+        errors += pluginsd_shm_unittest_check(pluginsd_shm_unittest_feed(&t) == 0 && !t.parser->shm, msg);
+
+        pluginsd_shm_unittest_cleanup(&t);
+    }
+
+    return errors;
+}
+
+static bool pluginsd_shm_unittest_values(RRDDIM *a, RRDDIM *b, NETDATA_DOUBLE va, NETDATA_DOUBLE vb) {
+    return a && b && rrddim_last_collected_as_double(a) == va && rrddim_last_collected_as_double(b) == vb;
+}
+
+static int pluginsd_shm_unittest_records(void) {
+    int errors = 0;
+    fprintf(stderr, "\nPLUGINSD SHM: consuming records\n");
+
+    struct plugind cd = {
+        .filename = string_strdupz("pluginsd-shm-unittest"),
+        .update_every = 1,
+    };
+
+    PARSER_USER_OBJECT user = {
+        .enabled = 1,
+        .host = localhost,
+        .cd = &cd,
+        .trust_durations = 1,
+    };
+
+    struct pluginsd_shm_unittest t;
+    pluginsd_shm_unittest_init(&t, &user);
+
+    fprintf(t.fp, PLUGINSD_KEYWORD_CHART " '" PLUGINSD_KEYWORD_SLOT ":1' 'shm_unittest.ring' '' 'ring' 'values' 'ring' 'shm_unittest.ring' 'line' 1000 1 '' 'unittest' 'ring'\n");
+    fprintf(t.fp, PLUGINSD_KEYWORD_DIMENSION " '" PLUGINSD_KEYWORD_SLOT ":1' 'a' '' 'absolute' 1 1 ''\n");
+    fprintf(t.fp, PLUGINSD_KEYWORD_DIMENSION " '" PLUGINSD_KEYWORD_SLOT ":2' 'b' '' 'absolute' 1 1 ''\n");
+
+    // a small ring, so that it wraps around
+    PLUGINSD_SHM_RING *ring = pluginsd_shm_producer_create(t.fp, 16);
+    if(!ring) {
+        errors += pluginsd_shm_unittest_check(false, "cannot create a ring");
+        goto cleanup;
+    }
+
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 0 && t.parser->shm && pluginsd_shm_producer_active(ring),
+        "the chart is created and the ring is attached");
+
+    RRDSET *st = rrdset_find(localhost, "shm_unittest.ring", false);
+    RRDDIM *a = st ? rrddim_find(st, "a", false) : NULL;
+    RRDDIM *b = st ? rrddim_find(st, "b", false) : NULL;
+    if(!a || !b) {
+        errors += pluginsd_shm_unittest_check(false, "cannot find the chart and its dimensions");
+        goto cleanup;
+    }
+
+    time_t start_s = now_realtime_sec() - 60;
+
+    // text that depends on records is processed after them
+    pluginsd_shm_begin(ring, 1, 0);
+    pluginsd_shm_set_int(ring, 1, 1);
+    pluginsd_shm_producer_flush(ring);
+    fprintf(t.fp, PLUGINSD_KEYWORD_SET " 'b' = 2\n");
+    fprintf(t.fp, PLUGINSD_KEYWORD_END " %lld 0\n", (long long)start_s + 1);
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 0 && pluginsd_shm_unittest_values(a, b, 1, 2),
+        "records are processed before the text after them");
+
+    // records and text set the same dimensions, the last one wins
+    fprintf(t.fp, PLUGINSD_KEYWORD_BEGIN " 'shm_unittest.ring' %llu\n", (unsigned long long)USEC_PER_SEC);
+    fprintf(t.fp, PLUGINSD_KEYWORD_SET " 'a' = 3\n");
+    pluginsd_shm_set_int(ring, 1, 4);
+    pluginsd_shm_set_double(ring, 2, 5.0);
+    pluginsd_shm_producer_flush(ring);
+    fprintf(t.fp, PLUGINSD_KEYWORD_SET " 'b' = 6\n");
+    pluginsd_shm_end(ring, (start_s + 2) * USEC_PER_SEC, false);
+    pluginsd_shm_producer_flush(ring);
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 0 && pluginsd_shm_unittest_values(a, b, 4, 6),
+        "records and text are processed in the order they are sent");
+
+    // 40 records through a ring of 16
+    size_t failed = 0;
+    for(int i = 0; i < 10 ; i++) {
+        pluginsd_shm_begin(ring, 1, USEC_PER_SEC);
+        pluginsd_shm_set_int(ring, 1, 100 + i);
+        pluginsd_shm_set_int(ring, 2, 200 + i);
+        pluginsd_shm_end(ring, (start_s + 3 + i) * USEC_PER_SEC, false);
+        pluginsd_shm_producer_flush(ring);
+        failed += pluginsd_shm_unittest_feed(&t);
+    }
+    errors += pluginsd_shm_unittest_check(
+        failed == 0 && pluginsd_shm_unittest_values(a, b, 109, 209) && t.parser->shm->read_pos == ring->write_pos,
+        "the ring wraps around");
+
+    // every record is validated against the slots the plugin has defined
+    pluginsd_shm_begin(ring, 1, USEC_PER_SEC);
+    pluginsd_shm_set_int(ring, 3, 1);
+    pluginsd_shm_producer_flush(ring);
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 1 && !t.parser->user.enabled,
+        "a record for an undefined dimension slot disables the plugin");
+
+    pluginsd_shm_begin(ring, 2, USEC_PER_SEC);
+    pluginsd_shm_producer_flush(ring);
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 1,
+        "a record for an undefined chart slot is refused");
+
+    pluginsd_shm_producer_append(ring, (PLUGINSD_SHM_RECORD_TYPE)99, PLUGINSD_SHM_FLAG_NONE, 1, 0);
+    pluginsd_shm_producer_flush(ring);
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 1,
+        "a record of an unknown type is refused");
+
+    // the positions of DATA_SHM_FLUSH are validated against the ring
+    fprintf(t.fp, PLUGINSD_KEYWORD_DATA_SHM_FLUSH " %llu\n", (unsigned long long)ring->write_pos + 1);
+    fprintf(t.fp, PLUGINSD_KEYWORD_DATA_SHM_FLUSH " %llu\n", (unsigned long long)ring->write_pos - 1);
+    fprintf(t.fp, PLUGINSD_KEYWORD_DATA_SHM_FLUSH "\n");
+    errors += pluginsd_shm_unittest_check(
+        pluginsd_shm_unittest_feed(&t) == 3 && t.parser->shm->read_pos == ring->write_pos,
+        "flush positions ahead or behind the ring are refused");
+
+    rrdset_is_obsolete___safe_from_collector_thread(st);
+
+cleanup:
+    pluginsd_shm_unittest_cleanup(&t);
+    pluginsd_shm_destroy(ring);
+    string_freez(cd.filename);
+    return errors;
+}
+
+#endif // !OS_WINDOWS
+
+int pluginsd_shm_unittest(void) {
+#if defined(OS_WINDOWS)
+    fprintf(stderr, "PLUGINSD SHM: the binary data plane is not available on this platform\n");
+    return 0;
+#else
+    nd_setenv(PLUGINSD_SHM_ENV_VARIABLE, "1", 1);
+
+    int errors = 0;
+    errors += pluginsd_shm_unittest_headers();
+    errors += pluginsd_shm_unittest_records();
+
+    fprintf(stderr, "\nPLUGINSD SHM: %d errors\n\n", errors);
+    return errors ? 1 : 0;
+#endif
+}
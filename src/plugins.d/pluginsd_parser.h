@@ -97,6 +97,9 @@ typedef struct parser_user_object {
         bool ml_locked;
     } v2;
 
+    // the points of the current chart update, when the host has an ingestion pipeline
+    RRDHOST_INGESTION_BATCH ingestion;
+
     struct {
         Pvoid_t JudyL;
     } vnodes;
@@ -138,6 +141,8 @@ struct parser {
     struct {
         SPINLOCK spinlock;
     } writer;
+
+    PLUGINSD_SHM_RING *shm;         // the binary data plane of external plugins, when attached
 };
 
 typedef struct parser PARSER;
@@ -133,6 +133,10 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_begin(char **words, size_t num_words, PA
     if(!pluginsd_set_scope_chart(parser, st, PLUGINSD_KEYWORD_REPLAY_BEGIN))
         return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
 
+    // a chart update without an end leaves its points queued
+    if(unlikely(parser->user.ingestion.rsa))
+        rrdhost_ingestion_batch_submit(host, &parser->user.ingestion);
+
     if(start_time_str && end_time_str) {
         time_t start_time = (time_t) str2ull_encoded(start_time_str);
         time_t end_time = (time_t) str2ull_encoded(end_time_str);
@@ -190,6 +194,11 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_begin(char **words, size_t num_words, PA
             parser->user.replay.wall_clock_time = wall_clock_time;
             parser->user.replay.rset_enabled = true;
 
+            // the replayed points are queued after the ones already queued for the host,
+            // when the chart cannot be acquired, they are stored inline
+            if(rrdhost_ingestion_pipelined(host))
+                rrdhost_ingestion_batch_begin(&parser->user.ingestion, st, parser->user.replay.end_time_ut, true);
+
             return PARSER_RC_OK;
         }
 
@@ -239,8 +248,9 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_set(char **words, size_t num_words, PARS
         return PARSER_RC_OK;
     }
 
-    RRDDIM *rd = pluginsd_acquire_dimension(host, st, dimension, slot, PLUGINSD_KEYWORD_REPLAY_SET);
-    if(!rd) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+    struct pluginsd_rrddim *prd = pluginsd_acquire_dimension_slot(host, st, dimension, slot, PLUGINSD_KEYWORD_REPLAY_SET);
+    if(!prd || !prd->rd) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+    RRDDIM *rd = prd->rd;
 
     st->pluginsd.set = true;
 
@@ -270,7 +280,11 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_set(char **words, size_t num_words, PARS
             flags = SN_EMPTY_SLOT;
         }
 
-        rrddim_store_metric(rd, parser->user.replay.end_time_ut, value, flags);
+        if(parser->user.ingestion.rsa)
+            rrdhost_ingestion_batch_add(&parser->user.ingestion, prd->rda, value, flags);
+        else
+            rrddim_store_metric(rd, parser->user.replay.end_time_ut, value, flags);
+
         rd->collector.last_collected_time.tv_sec = parser->user.replay.end_time;
         rd->collector.last_collected_time.tv_usec = 0;
         rd->collector.counter++;
@@ -413,6 +427,9 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_end(char **words, size_t num_words, PARS
 
     parser->user.data_collections_count++;
 
+    if(parser->user.ingestion.rsa)
+        rrdhost_ingestion_batch_submit(host, &parser->user.ingestion);
+
     // Reset empty response counter when we receive actual data
     if(parser->user.replay.rset_enabled && st)
         st->replication_empty_response_count = 0;
@@ -439,7 +439,7 @@ int registry_request_switch_json(RRDHOST *host, struct web_client *w, char *pers
 void registry_statistics(void) {
     if(!registry.enabled) return;
 
-    static RRDSET *sts = NULL, *stc = NULL, *stm = NULL;
+    static RRDSET *sts = NULL, *stc = NULL, *stm = NULL, *stt = NULL, *stf = NULL;
 
     if(unlikely(!sts)) {
         sts = rrdset_create_localhost(
@@ -495,6 +495,60 @@ void registry_statistics(void) {
 
     // ------------------------------------------------------------------------
 
+    if(unlikely(!stt)) {
+        stt = rrdset_create_localhost(
+                "netdata"
+                , "registry_persistence_time"
+                , NULL
+                , "registry"
+                , NULL
+                , "Netdata Registry Persistence Time"
+                , "milliseconds"
+                , "registry"
+                , "stats"
+                , 131200
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_LINE
+        );
+
+        rrddim_add(stt, "load",      NULL,  1, USEC_PER_MS, RRD_ALGORITHM_ABSOLUTE);
+        rrddim_add(stt, "locked",    NULL,  1, USEC_PER_MS, RRD_ALGORITHM_ABSOLUTE);
+        rrddim_add(stt, "save",      NULL,  1, USEC_PER_MS, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    rrddim_set(stt, "load",   (collected_number)registry.snapshot.load_ut);
+    rrddim_set(stt, "locked", (collected_number)registry.snapshot.encode_ut);
+    rrddim_set(stt, "save",   (collected_number)registry.snapshot.write_ut);
+    rrdset_done(stt);
+
+    // ------------------------------------------------------------------------
+
+    if(unlikely(!stf)) {
+        stf = rrdset_create_localhost(
+                "netdata"
+                , "registry_persistence_size"
+                , NULL
+                , "registry"
+                , NULL
+                , "Netdata Registry Persistence Size"
+                , "KiB"
+                , "registry"
+                , "stats"
+                , 131210
+                , localhost->rrd_update_every
+                , RRDSET_TYPE_STACKED
+        );
+
+        rrddim_add(stf, "snapshot",  NULL,  1, 1024, RRD_ALGORITHM_ABSOLUTE);
+        rrddim_add(stf, "log",       NULL,  1, 1024, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    rrddim_set(stf, "snapshot", (collected_number)registry.snapshot.bytes);
+    rrddim_set(stf, "log",      (collected_number)registry.changes.bytes);
+    rrdset_done(stf);
+
+    // ------------------------------------------------------------------------
+
     if(unlikely(!stm)) {
         stm = rrdset_create_localhost(
                 "netdata"
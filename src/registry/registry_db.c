@@ -3,237 +3,559 @@
 #include "database/rrd.h"
 #include "registry_internals.h"
 
+// The database is saved as a binary snapshot (registry.snapshot), every time the
+// changes log (registry_log.c) has more than [registry].registry save db every new entries.
+//
+// registry_db_save() is called with the registry locked, so it only encodes the
+// database in memory and rotates the changes log to a new segment. A background
+// thread writes the snapshot to disk and deletes the log segments it includes,
+// while the registry keeps serving requests.
+//
+// On startup, the snapshot is mmap()ed and decoded, without parsing any text.
+
+#define REGISTRY_SNAPSHOT_MAGIC "NDREGSNP"
+#define REGISTRY_SNAPSHOT_VERSION 1
+#define REGISTRY_SNAPSHOT_ENDIANNESS 0x01020304
+
+struct registry_snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;            // REGISTRY_SNAPSHOT_ENDIANNESS, in the byte order of the writer
+    uint64_t segment;               // the first changes log segment not included in the snapshot
+
+    uint64_t persons_count;
+    uint64_t machines_count;
+    uint64_t usages_count;
+    uint64_t persons_urls_count;
+    uint64_t machines_urls_count;
+
+    uint64_t payload_size;          // the records following the header
+    uint32_t payload_crc;
+    uint32_t reserved;
+};
+
+// 'M' machines and 'P' persons, each followed by its URLs
+struct registry_snapshot_object {
+    uint8_t type;
+    char guid[GUID_LEN];
+    uint32_t first_t;
+    uint32_t last_t;
+    uint32_t usages;
+} __attribute__((packed));
+
+// 'V' machine URLs, followed by the url
+struct registry_snapshot_machine_url {
+    uint8_t type;
+    uint8_t flags;
+    uint32_t first_t;
+    uint32_t last_t;
+    uint32_t usages;
+    uint32_t url_len;
+} __attribute__((packed));
+
+// 'U' person URLs, followed by the machine name and the url
+struct registry_snapshot_person_url {
+    uint8_t type;
+    uint8_t flags;
+    uint32_t first_t;
+    uint32_t last_t;
+    uint32_t usages;
+    char machine_guid[GUID_LEN];
+    uint32_t name_len;
+    uint32_t url_len;
+} __attribute__((packed));
+
+struct registry_snapshot {
+    uint8_t *data;                  // the header and the payload
+    size_t len;
+    size_t size;
+
+    uint64_t segment;
+    unsigned long long entries;     // the log entries included
+    bool migrate;
+};
+
+uint32_t registry_crc32(const void *data, size_t len) {
+    const uint8_t *s = data;
+    uLong crc = crc32(0L, Z_NULL, 0);
+
+    // crc32() takes 32-bit lengths
+    while(len) {
+        uInt chunk = (len > 1024 * 1024 * 1024) ? 1024 * 1024 * 1024 : (uInt)len;
+        crc = crc32(crc, s, chunk);
+        s += chunk;
+        len -= chunk;
+    }
+
+    return (uint32_t)crc;
+}
+
 int registry_db_should_be_saved(void) {
     netdata_log_debug(D_REGISTRY, "log entries %llu, max %llu", registry.log_count, registry.save_registry_every_entries);
     return registry.log_count > registry.save_registry_every_entries;
 }
 
 // ----------------------------------------------------------------------------
-// INTERNAL FUNCTIONS FOR SAVING REGISTRY OBJECTS
+// ENCODE THE REGISTRY DATABASE
 
-static int registry_machine_save_url(REGISTRY_MACHINE_URL *mu, FILE *fp) {
-    netdata_log_debug(D_REGISTRY, "REGISTRY: registry_machine_save_url('%s')", string2str(mu->url));
+static inline void *registry_snapshot_reserve(struct registry_snapshot *ss, size_t bytes) {
+    if(unlikely(ss->len + bytes > ss->size)) {
+        while(ss->len + bytes > ss->size)
+            ss->size = ss->size ? ss->size * 2 : 1024 * 1024;
 
-    int ret = fprintf(fp, "V\t%08x\t%08x\t%08x\t%02x\t%s\n",
-            mu->first_t,
-            mu->last_t,
-            mu->usages,
-            mu->flags,
-            string2str(mu->url)
-    );
+        ss->data = reallocz(ss->data, ss->size);
+    }
+
+    void *p = &ss->data[ss->len];
+    ss->len += bytes;
+    return p;
+}
 
-    // error handling is done at registry_db_save()
+static inline void registry_snapshot_append(struct registry_snapshot *ss, const void *src, size_t bytes) {
+    memcpy(registry_snapshot_reserve(ss, bytes), src, bytes);
+}
 
-    return ret;
+static void registry_snapshot_encode_machine(struct registry_snapshot *ss, REGISTRY_MACHINE *m) {
+    struct registry_snapshot_object o = {
+        .type = 'M',
+        .first_t = m->first_t,
+        .last_t = m->last_t,
+        .usages = m->usages,
+    };
+    memcpy(o.guid, m->guid, GUID_LEN);
+    registry_snapshot_append(ss, &o, sizeof(o));
+
+    for(REGISTRY_MACHINE_URL *mu = m->machine_urls; mu ; mu = mu->next) {
+        struct registry_snapshot_machine_url r = {
+            .type = 'V',
+            .flags = mu->flags,
+            .first_t = mu->first_t,
+            .last_t = mu->last_t,
+            .usages = mu->usages,
+            .url_len = (uint32_t)string_strlen(mu->url),
+        };
+        registry_snapshot_append(ss, &r, sizeof(r));
+        registry_snapshot_append(ss, string2str(mu->url), r.url_len);
+    }
 }
 
-static int registry_machine_save(const DICTIONARY_ITEM *item __maybe_unused, void *entry, void *file) {
+static void registry_snapshot_encode_person(struct registry_snapshot *ss, REGISTRY_PERSON *p) {
+    struct registry_snapshot_object o = {
+        .type = 'P',
+        .first_t = p->first_t,
+        .last_t = p->last_t,
+        .usages = p->usages,
+    };
+    memcpy(o.guid, p->guid, GUID_LEN);
+    registry_snapshot_append(ss, &o, sizeof(o));
+
+    for(REGISTRY_PERSON_URL *pu = p->person_urls; pu ; pu = pu->next) {
+        struct registry_snapshot_person_url r = {
+            .type = 'U',
+            .flags = pu->flags,
+            .first_t = pu->first_t,
+            .last_t = pu->last_t,
+            .usages = pu->usages,
+            .name_len = (uint32_t)string_strlen(pu->machine_name),
+            .url_len = (uint32_t)string_strlen(pu->url),
+        };
+        memcpy(r.machine_guid, pu->machine->guid, GUID_LEN);
+        registry_snapshot_append(ss, &r, sizeof(r));
+        registry_snapshot_append(ss, string2str(pu->machine_name), r.name_len);
+        registry_snapshot_append(ss, string2str(pu->url), r.url_len);
+    }
+}
 
-    REGISTRY_MACHINE *m = entry;
-    FILE *fp = file;
+// ----------------------------------------------------------------------------
+// WRITE THE SNAPSHOT, IN THE BACKGROUND
 
-    netdata_log_debug(D_REGISTRY, "REGISTRY: registry_machine_save('%s')", m->guid);
+static bool registry_snapshot_write(struct registry_snapshot *ss) {
+    char tmp_filename[FILENAME_MAX + 1];
+    snprintfz(tmp_filename, FILENAME_MAX, "%s.tmp", registry.snapshot_filename);
 
-    int ret = fprintf(fp, "M\t%08x\t%08x\t%08x\t%s\n",
-            m->first_t,
-            m->last_t,
-            m->usages,
-            m->guid
-    );
+    struct registry_snapshot_header *h = (struct registry_snapshot_header *)ss->data;
+    h->payload_crc = registry_crc32(&ss->data[sizeof(*h)], h->payload_size);
 
-    if(ret >= 0) {
-        for(REGISTRY_MACHINE_URL *mu = m->machine_urls; mu ; mu = mu->next) {
-            int rc = registry_machine_save_url(mu, fp);
-            if(rc < 0)
-                return -1;  // Error saving URL
+    int fd = open(tmp_filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0664);
+    if(fd == -1) {
+        netdata_log_error("REGISTRY: Cannot create file: %s", tmp_filename);
+        return false;
+    }
+
+    const uint8_t *s = ss->data;
+    size_t remaining = ss->len;
+    while(remaining) {
+        ssize_t written = write(fd, s, remaining);
+        if(written > 0) {
+            s += written;
+            remaining -= written;
         }
-        return 1;  // Successfully saved 1 machine
+        else if(written == -1 && errno == EINTR)
+            continue;
+        else
+            break;
     }
 
-    // error handling is done at registry_db_save()
+    if(remaining || fsync(fd) == -1) {
+        netdata_log_error("REGISTRY: Cannot write file: %s", tmp_filename);
+        close(fd);
+        unlink(tmp_filename);
+        return false;
+    }
+    close(fd);
 
-    return -1;  // Error writing machine record
+    if(rename(tmp_filename, registry.snapshot_filename) == -1) {
+        netdata_log_error("REGISTRY: cannot move file '%s' to '%s'. Saving registry DB failed!",
+                          tmp_filename, registry.snapshot_filename);
+        unlink(tmp_filename);
+        return false;
+    }
+
+    return true;
 }
 
-static inline int registry_person_save_url(REGISTRY_PERSON_URL *pu, FILE *fp) {
-    netdata_log_debug(D_REGISTRY, "REGISTRY: registry_person_save_url('%s')", string2str(pu->url));
+// the text files of older versions are now included in the snapshot
+static void registry_snapshot_migrated(void) {
+    char old_filename[FILENAME_MAX + 1];
 
-    int ret = fprintf(fp, "U\t%08x\t%08x\t%08x\t%02x\t%s\t%s\t%s\n",
-            pu->first_t,
-            pu->last_t,
-            pu->usages,
-            pu->flags,
-            pu->machine->guid,
-            string2str(pu->machine_name),
-            string2str(pu->url)
-    );
+    snprintfz(old_filename, FILENAME_MAX, "%s.old", registry.db_filename);
+    if(rename(registry.db_filename, old_filename) == -1 && errno != ENOENT)
+        netdata_log_error("REGISTRY: cannot move file '%s' to '%s'", registry.db_filename, old_filename);
 
-    // error handling is done at registry_db_save()
+    snprintfz(old_filename, FILENAME_MAX, "%s.old", registry.log_filename);
+    if(rename(registry.log_filename, old_filename) == -1 && errno != ENOENT)
+        netdata_log_error("REGISTRY: cannot move file '%s' to '%s'", registry.log_filename, old_filename);
 
-    return ret;
+    netdata_log_info("REGISTRY: the text database has been migrated to '%s'", registry.snapshot_filename);
 }
 
-static inline int registry_person_save(const DICTIONARY_ITEM *item __maybe_unused, void *entry, void *file) {
-    REGISTRY_PERSON *p = entry;
-    FILE *fp = file;
+static void registry_snapshot_save_thread(void *ptr) {
+    struct registry_snapshot *ss = ptr;
+    usec_t started_ut = now_monotonic_usec();
 
-    netdata_log_debug(D_REGISTRY, "REGISTRY: registry_person_save('%s')", p->guid);
+    bool ok = registry_snapshot_write(ss);
+    if(ok) {
+        registry_log_delete_segments_before(ss->segment);
 
-    int ret = fprintf(fp, "P\t%08x\t%08x\t%08x\t%s\n",
-            p->first_t,
-            p->last_t,
-            p->usages,
-            p->guid
-    );
+        if(ss->migrate)
+            registry_snapshot_migrated();
+    }
 
-    if(ret >= 0) {
-        for(REGISTRY_PERSON_URL *pu = p->person_urls; pu ;pu = pu->next) {
-            int rc = registry_person_save_url(pu, fp);
-            if(rc < 0)
-                return -1;  // Error saving URL
-        }
-        return 1;  // Successfully saved 1 person
+    netdata_mutex_lock(&registry.lock);
+
+    if(ok) {
+        registry.snapshot.bytes = ss->len;
+        registry.consecutive_save_failures = 0;
+        registry.last_save_failure = 0;
+    }
+    else {
+        // the log segments are still there, the next snapshot will include them
+        registry.log_count += ss->entries;
+        registry.snapshot.migrate = registry.snapshot.migrate || ss->migrate;
+        registry.consecutive_save_failures++;
+        registry.last_save_failure = now_realtime_sec();
     }
 
-    // error handling is done at registry_db_save()
+    registry.snapshot.write_ut = now_monotonic_usec() - started_ut;
+    registry.snapshot.running = false;
+
+    netdata_mutex_unlock(&registry.lock);
 
-    return -1;  // Error writing person record
+    freez(ss->data);
+    freez(ss);
 }
 
 // ----------------------------------------------------------------------------
 // SAVE THE REGISTRY DATABASE
 
-int registry_db_save(void) {
+// must be called with the registry locked (or while loading)
+int registry_db_save(bool force) {
     if(unlikely(!registry.enabled))
         return -1;
 
-    if(unlikely(!registry_db_should_be_saved()))
+    if(unlikely(!force && !registry_db_should_be_saved()))
         return -2;
 
+    // the previous snapshot is still being written
+    if(registry.snapshot.running)
+        return -4;
+
     // Implement exponential backoff for save failures
     if(registry.consecutive_save_failures > 0) {
         time_t now = now_realtime_sec();
         time_t backoff_seconds = 60 * (1 << (registry.consecutive_save_failures - 1)); // 60s, 120s, 240s, etc.
         if(backoff_seconds > 3600) backoff_seconds = 3600; // Cap at 1 hour
-        
+
         if((now - registry.last_save_failure) < backoff_seconds) {
-            netdata_log_debug(D_REGISTRY, "REGISTRY: skipping save due to backoff (failed %d times, waiting %ld seconds)", 
+            netdata_log_debug(D_REGISTRY, "REGISTRY: skipping save due to backoff (failed %d times, waiting %ld seconds)",
                              registry.consecutive_save_failures, backoff_seconds);
             return -3;
         }
     }
 
-    nd_log_limits_unlimited();
+    usec_t started_ut = now_monotonic_usec();
 
-    char tmp_filename[FILENAME_MAX + 1];
-    char old_filename[FILENAME_MAX + 1];
+    // the thread of the previous snapshot has finished
+    registry_db_save_wait();
 
-    snprintfz(old_filename, FILENAME_MAX, "%s.old", registry.db_filename);
-    snprintfz(tmp_filename, FILENAME_MAX, "%s.tmp", registry.db_filename);
+    struct registry_snapshot *ss = callocz(1, sizeof(*ss));
 
-    netdata_log_debug(D_REGISTRY, "REGISTRY: Creating file '%s'", tmp_filename);
-    FILE *fp = fopen(tmp_filename, "w");
-    if(!fp) {
-        netdata_log_error("REGISTRY: Cannot create file: %s", tmp_filename);
-        nd_log_limits_reset();
-        registry.consecutive_save_failures++;
-        registry.last_save_failure = now_realtime_sec();
+    // size it like the previous one, to avoid growing it
+    ss->size = registry.snapshot.bytes + registry.changes.bytes + sizeof(struct registry_snapshot_header);
+    ss->data = mallocz(ss->size);
+
+    registry_snapshot_reserve(ss, sizeof(struct registry_snapshot_header));
+
+    REGISTRY_MACHINE *m;
+    dfe_start_read(registry.machines, m) {
+        registry_snapshot_encode_machine(ss, m);
+    }
+    dfe_done(m);
+
+    REGISTRY_PERSON *p;
+    dfe_start_read(registry.persons, p) {
+        registry_snapshot_encode_person(ss, p);
+    }
+    dfe_done(p);
+
+    ss->segment = registry_log_rotate();
+    ss->entries = registry.log_count;
+    ss->migrate = registry.snapshot.migrate;
+    registry.log_count = 0;
+    registry.snapshot.migrate = false;
+
+    struct registry_snapshot_header *h = (struct registry_snapshot_header *)ss->data;
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, REGISTRY_SNAPSHOT_MAGIC, sizeof(h->magic));
+    h->version = REGISTRY_SNAPSHOT_VERSION;
+    h->endianness = REGISTRY_SNAPSHOT_ENDIANNESS;
+    h->segment = ss->segment;
+    h->persons_count = registry.persons_count;
+    h->machines_count = registry.machines_count;
+    h->usages_count = registry.usages_count + 1; // this is required - it is lost on db rotation
+    h->persons_urls_count = registry.persons_urls_count;
+    h->machines_urls_count = registry.machines_urls_count;
+    h->payload_size = ss->len - sizeof(*h);
+
+    registry.snapshot.running = true;
+    registry.snapshot.encode_ut = now_monotonic_usec() - started_ut;
+
+    registry.snapshot.thread = nd_thread_create("REGISTRY_SAVE", NETDATA_THREAD_OPTION_DONT_LOG,
+                                                registry_snapshot_save_thread, ss);
+
+    if(!registry.snapshot.thread) {
+        // the thread takes the lock we hold
+        netdata_log_error("REGISTRY: cannot start a thread to save the registry");
+        registry.log_count += ss->entries;
+        registry.snapshot.migrate = ss->migrate;
+        registry.snapshot.running = false;
+        freez(ss->data);
+        freez(ss);
         return -1;
     }
 
-    // dictionary_walkthrough_read() has its own locking, so this is safe to do
+    return 0;  // Success
+}
 
-    netdata_log_debug(D_REGISTRY, "REGISTRY: saving all machines");
-    int machines_saved = dictionary_walkthrough_read(registry.machines, registry_machine_save, fp);
-    if(machines_saved < 0) {
-        netdata_log_error("REGISTRY: Cannot save registry machines - return value %d", machines_saved);
-        fclose(fp);
-        nd_log_limits_reset();
-        registry.consecutive_save_failures++;
-        registry.last_save_failure = now_realtime_sec();
-        return machines_saved;
+// wait for the snapshot being written in the background, if any
+// the registry must not be locked, unless no snapshot is running
+void registry_db_save_wait(void) {
+    if(registry.snapshot.thread) {
+        nd_thread_join(registry.snapshot.thread);
+        registry.snapshot.thread = NULL;
     }
-    netdata_log_debug(D_REGISTRY, "REGISTRY: saved %d machines", machines_saved);
-
-    netdata_log_debug(D_REGISTRY, "Saving all persons");
-    int persons_saved = dictionary_walkthrough_read(registry.persons, registry_person_save, fp);
-    if(persons_saved < 0) {
-        netdata_log_error("REGISTRY: Cannot save registry persons - return value %d", persons_saved);
-        fclose(fp);
-        nd_log_limits_reset();
-        registry.consecutive_save_failures++;
-        registry.last_save_failure = now_realtime_sec();
-        return persons_saved;
-    }
-    netdata_log_debug(D_REGISTRY, "REGISTRY: saved %d persons", persons_saved);
-
-    // save the totals
-    fprintf(fp, "T\t%016llx\t%016llx\t%016llx\t%016llx\t%016llx\t%016llx\n",
-            registry.persons_count,
-            registry.machines_count,
-            registry.usages_count + 1, // this is required - it is lost on db rotation
-            0LLU, //registry.urls_count,
-            registry.persons_urls_count,
-            registry.machines_urls_count
-    );
+}
 
-    fclose(fp);
+// ----------------------------------------------------------------------------
+// LOAD THE REGISTRY DATABASE
 
-    errno_clear();
+// decode the records of a snapshot
+static bool registry_snapshot_decode(const uint8_t *data, size_t size) {
+    REGISTRY_PERSON *p = NULL;
+    REGISTRY_MACHINE *m = NULL;
+    char guid[GUID_LEN + 1];
+    char *strings = NULL;
+    size_t strings_size = 0;
+    size_t pos = 0;
+
+    while(pos < size) {
+        switch(data[pos]) {
+            case 'M':
+            case 'P': {
+                struct registry_snapshot_object o;
+                if(size - pos < sizeof(o))
+                    goto corrupted;
+
+                memcpy(&o, &data[pos], sizeof(o));
+                pos += sizeof(o);
+
+                memcpy(guid, o.guid, GUID_LEN);
+                guid[GUID_LEN] = '\0';
+
+                if(o.type == 'M') {
+                    p = NULL;
+                    m = registry_machine_allocate(guid, o.first_t);
+                    m->last_t = o.last_t;
+                    m->usages = o.usages;
+                }
+                else {
+                    m = NULL;
+                    p = registry_person_allocate(guid, o.first_t);
+                    p->last_t = o.last_t;
+                    p->usages = o.usages;
+                }
+                break;
+            }
 
-    // remove the .old db
-    netdata_log_debug(D_REGISTRY, "REGISTRY: Removing old db '%s'", old_filename);
-    if(unlink(old_filename) == -1 && errno != ENOENT)
-        netdata_log_error("REGISTRY: cannot remove old registry file '%s'", old_filename);
+            case 'V': {
+                struct registry_snapshot_machine_url r;
+                if(size - pos < sizeof(r))
+                    goto corrupted;
 
-    // rename the db to .old
-    netdata_log_debug(D_REGISTRY, "REGISTRY: Link current db '%s' to .old: '%s'", registry.db_filename, old_filename);
-    if(link(registry.db_filename, old_filename) == -1 && errno != ENOENT)
-        netdata_log_error("REGISTRY: cannot move file '%s' to '%s'. Saving registry DB failed!", registry.db_filename, old_filename);
+                memcpy(&r, &data[pos], sizeof(r));
+                pos += sizeof(r);
 
-    else {
-        // remove the database (it is saved in .old)
-        netdata_log_debug(D_REGISTRY, "REGISTRY: removing db '%s'", registry.db_filename);
-        if (unlink(registry.db_filename) == -1 && errno != ENOENT)
-            netdata_log_error("REGISTRY: cannot remove old registry file '%s'", registry.db_filename);
-
-        // move the .tmp to make it active
-        netdata_log_debug(D_REGISTRY, "REGISTRY: linking tmp db '%s' to active db '%s'", tmp_filename, registry.db_filename);
-        if (link(tmp_filename, registry.db_filename) == -1) {
-            netdata_log_error("REGISTRY: cannot move file '%s' to '%s'. Saving registry DB failed!", tmp_filename,
-                    registry.db_filename);
-
-            // move the .old back
-            netdata_log_debug(D_REGISTRY, "REGISTRY: linking old db '%s' to active db '%s'", old_filename, registry.db_filename);
-            if(link(old_filename, registry.db_filename) == -1)
-                netdata_log_error("REGISTRY: cannot move file '%s' to '%s'. Recovering the old registry DB failed!", old_filename, registry.db_filename);
-        }
-        else {
-            netdata_log_debug(D_REGISTRY, "REGISTRY: removing tmp db '%s'", tmp_filename);
-            if(unlink(tmp_filename) == -1)
-                netdata_log_error("REGISTRY: cannot remove tmp registry file '%s'", tmp_filename);
-
-            // it has been moved successfully
-            // discard the current registry log
-            registry_log_recreate();
-            registry.log_count = 0;
-            
-            // Reset failure tracking on success
-            registry.consecutive_save_failures = 0;
-            registry.last_save_failure = 0;
+                if(size - pos < r.url_len || !m)
+                    goto corrupted;
+
+                STRING *u = string_strndupz((const char *)&data[pos], r.url_len);
+                pos += r.url_len;
+
+                REGISTRY_MACHINE_URL *mu = registry_machine_url_find(m, u);
+                if(!mu)
+                    mu = registry_machine_url_allocate(m, u, r.first_t);
+
+                mu->last_t = r.last_t;
+                mu->usages = r.usages;
+                mu->flags = r.flags;
+
+                string_freez(u);
+                break;
+            }
+
+            case 'U': {
+                struct registry_snapshot_person_url r;
+                if(size - pos < sizeof(r))
+                    goto corrupted;
+
+                memcpy(&r, &data[pos], sizeof(r));
+                pos += sizeof(r);
+
+                if(size - pos < (uint64_t)r.name_len + r.url_len || !p)
+                    goto corrupted;
+
+                if(r.name_len + 1 > strings_size) {
+                    strings_size = (r.name_len + 1) * 2;
+                    strings = reallocz(strings, strings_size);
+                }
+                memcpy(strings, &data[pos], r.name_len);
+                strings[r.name_len] = '\0';
+                pos += r.name_len;
+
+                STRING *u = string_strndupz((const char *)&data[pos], r.url_len);
+                pos += r.url_len;
+
+                memcpy(guid, r.machine_guid, GUID_LEN);
+                guid[GUID_LEN] = '\0';
+
+                REGISTRY_MACHINE *pm = registry_machine_find(guid);
+                if(!pm) pm = registry_machine_allocate(guid, r.first_t);
+
+                if(!registry_machine_url_find(pm, u)) {
+                    netdata_log_error("REGISTRY: person URL '%s' was not linked to the machine it refers to", string2str(u));
+                    registry_machine_url_allocate(pm, u, r.first_t);
+                }
+
+                REGISTRY_PERSON_URL *pu = registry_person_url_index_find(p, u);
+                if(!pu)
+                    pu = registry_person_url_allocate(p, pm, u, strings, r.name_len, r.first_t);
+
+                pu->last_t = r.last_t;
+                pu->usages = r.usages;
+                pu->flags = r.flags;
+
+                string_freez(u);
+                break;
+            }
+
+            default:
+                goto corrupted;
         }
     }
 
-    // continue operations
-    nd_log_limits_reset();
+    freez(strings);
+    return true;
 
-    return 0;  // Success
+corrupted:
+    netdata_log_error("REGISTRY: snapshot '%s' is corrupted at offset %zu, ignoring the rest of it.",
+                      registry.snapshot_filename, pos);
+    freez(strings);
+    return false;
+}
+
+// load the snapshot and get the first log segment not included in it
+// it returns the bytes loaded, or -1 when there is no valid snapshot
+ssize_t registry_db_load(uint64_t *segment) {
+    *segment = 0;
+
+    netdata_log_debug(D_REGISTRY, "REGISTRY: loading snapshot from: '%s'", registry.snapshot_filename);
+    int fd = open(registry.snapshot_filename, O_RDONLY | O_CLOEXEC);
+    if(fd == -1) {
+        if(errno != ENOENT)
+            netdata_log_error("REGISTRY: cannot open registry file: '%s'", registry.snapshot_filename);
+        return -1;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(struct registry_snapshot_header)) {
+        netdata_log_error("REGISTRY: registry file '%s' is too small.", registry.snapshot_filename);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    uint8_t *data = nd_mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED) {
+        netdata_log_error("REGISTRY: cannot mmap registry file '%s'", registry.snapshot_filename);
+        return -1;
+    }
+    madvise_sequential(data, size);
+
+    struct registry_snapshot_header h;
+    memcpy(&h, data, sizeof(h));
+
+    const uint8_t *payload = &data[sizeof(h)];
+    if(memcmp(h.magic, REGISTRY_SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != REGISTRY_SNAPSHOT_VERSION ||
+        h.endianness != REGISTRY_SNAPSHOT_ENDIANNESS ||
+        h.payload_size != size - sizeof(h) ||
+        h.payload_crc != registry_crc32(payload, h.payload_size)) {
+        netdata_log_error("REGISTRY: registry file '%s' is not valid, ignoring it.", registry.snapshot_filename);
+        nd_munmap(data, size);
+        return -1;
+    }
+
+    registry_snapshot_decode(payload, h.payload_size);
+
+    registry.persons_count = h.persons_count;
+    registry.machines_count = h.machines_count;
+    registry.usages_count = h.usages_count;
+    registry.persons_urls_count = h.persons_urls_count;
+    registry.machines_urls_count = h.machines_urls_count;
+    registry.snapshot.bytes = size;
+
+    *segment = h.segment;
+
+    nd_munmap(data, size);
+    return (ssize_t)h.payload_size;
 }
 
 // ----------------------------------------------------------------------------
-// LOAD THE REGISTRY DATABASE
+// LOAD THE TEXT DATABASE OF OLDER VERSIONS
 
-size_t registry_db_load(void) {
+size_t registry_db_load_text(void) {
     char *s, buf[4096 + 1];
     REGISTRY_PERSON *p = NULL;
     REGISTRY_MACHINE *m = NULL;
@@ -91,6 +91,9 @@ void netdata_conf_section_registry(void) {
     snprintfz(filename, FILENAME_MAX, "%s/registry-log.db", registry.pathname);
     registry.log_filename = inicfg_get(&netdata_config, CONFIG_SECTION_REGISTRY, "registry log file", filename);
 
+    snprintfz(filename, FILENAME_MAX, "%s/registry.snapshot", registry.pathname);
+    registry.snapshot_filename = inicfg_get(&netdata_config, CONFIG_SECTION_REGISTRY, "registry snapshot file", filename);
+
     // configuration options
     registry.save_registry_every_entries = (unsigned long long)inicfg_get_number(&netdata_config, CONFIG_SECTION_REGISTRY, "registry save db every new entries", 1000000);
     registry.persons_expiration = inicfg_get_duration_days_to_seconds(&netdata_config, CONFIG_SECTION_REGISTRY, "registry expire idle persons", 365 * 86400);
@@ -131,6 +134,8 @@ void registry_init(void) {
     registry.persons_urls_count = 0;
     registry.machines_urls_count = 0;
 
+    registry.changes.fd = -1;
+
     // initialize locks
     netdata_mutex_init(&registry.lock);
 }
@@ -181,12 +186,25 @@ bool registry_load(void) {
                                                  &netdata_configured_cache_dir,
                                                  use_mmap, true, true);
 
-        registry_log_open();
-        registry_db_load();
-        registry_log_load();
+        usec_t started_ut = now_monotonic_usec();
+
+        uint64_t segment;
+        if(registry_db_load(&segment) < 0) {
+            // no snapshot, load the text database of older versions, if there
+            bool text_db = registry_db_load_text() > 0;
+            bool text_log = registry_log_load_text() > 0;
+            registry.snapshot.migrate = text_db || text_log;
+        }
 
-        if(unlikely(registry_db_should_be_saved()))
-            registry_db_save();
+        ssize_t records = registry_log_load(segment);
+
+        registry.snapshot.load_ut = now_monotonic_usec() - started_ut;
+        netdata_log_info("REGISTRY: loaded %llu persons and %llu machines, replayed %zd log records, in %llu ms",
+                         registry.persons_count, registry.machines_count, records,
+                         (unsigned long long)(registry.snapshot.load_ut / USEC_PER_MS));
+
+        if(unlikely(registry.snapshot.migrate || registry_db_should_be_saved()))
+            registry_db_save(true);
 
         //        registry_db_stats();
         //        registry_generate_curl_urls();
@@ -234,6 +252,9 @@ void registry_free(void) {
     if(!registry.enabled) return;
     registry.enabled = false;
 
+    registry_db_save_wait();
+    registry_log_close();
+
     netdata_log_debug(D_REGISTRY, "Registry: destroying persons dictionary");
     dictionary_walkthrough_read(registry.persons, registry_person_del_callback, NULL);
     dictionary_destroy(registry.persons);
@@ -43,11 +43,29 @@ struct registry {
 
     // file/path names
     const char *pathname;
-    const char *db_filename;
-    const char *log_filename;
-
-    // open files
-    FILE *log_fp;
+    const char *db_filename;        // the text database of older versions, migrated on startup
+    const char *log_filename;       // the text log of older versions, migrated on startup
+    const char *snapshot_filename;
+
+    // the append-only changes log (in registry_log.c)
+    struct {
+        bool logging;               // false while loading
+        bool open_failed;           // do not retry opening the current segment
+        int fd;
+        uint64_t segment;           // the segment we append to
+        uint64_t bytes;             // appended since the last snapshot
+    } changes;
+
+    // the snapshots of the database (in registry_db.c)
+    struct {
+        bool running;               // a snapshot is being written in the background
+        bool migrate;               // the next snapshot replaces the text files of older versions
+        ND_THREAD *thread;
+        size_t bytes;               // the size of the last snapshot
+        usec_t load_ut;             // the time to load the registry at startup
+        usec_t encode_ut;           // the time the registry was locked for the last snapshot
+        usec_t write_ut;            // the time to write the last snapshot in the background
+    } snapshot;
 
     // save failure tracking
     time_t last_save_failure;
@@ -81,12 +99,17 @@ REGISTRY_MACHINE *registry_request_machine(const char *person_guid, char *reques
 void registry_log(char action, REGISTRY_PERSON *p, REGISTRY_MACHINE *m, STRING *u, const char *name);
 int registry_log_open(void);
 void registry_log_close(void);
-void registry_log_recreate(void);
-ssize_t registry_log_load(void);
+uint64_t registry_log_rotate(void);
+void registry_log_delete_segments_before(uint64_t segment);
+ssize_t registry_log_load(uint64_t first_segment);
+ssize_t registry_log_load_text(void);
 
 // REGISTRY DB (in registry_db.c)
-int registry_db_save(void);
-size_t registry_db_load(void);
+int registry_db_save(bool force);
+void registry_db_save_wait(void);
+ssize_t registry_db_load(uint64_t *segment);
+size_t registry_db_load_text(void);
 int registry_db_should_be_saved(void);
+uint32_t registry_crc32(const void *data, size_t len);
 
 #endif //NETDATA_REGISTRY_INTERNALS_H_H
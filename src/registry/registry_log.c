@@ -3,77 +3,329 @@
 #include "database/rrd.h"
 #include "registry_internals.h"
 
-void registry_log(char action, REGISTRY_PERSON *p, REGISTRY_MACHINE *m, STRING *u, const char *name) {
-    if(likely(registry.log_fp)) {
-        if(unlikely(fprintf(registry.log_fp, "%c\t%08x\t%s\t%s\t%s\t%s\n",
-                action,
-                p->last_t,
-                p->guid,
-                m->guid,
-                name,
-                string2str(u)) < 0))
-            netdata_log_error("Registry: failed to save log. Registry data may be lost in case of abnormal restart.");
+// The changes log is a series of append-only segments (registry-changes-NNNNNNNNNN.bin)
+// in the registry directory. Every access and delete is appended to the current segment
+// as a binary record. Each snapshot of the database (registry_db.c) rotates the log to
+// a new segment, and deletes the segments it includes once it is on disk.
+//
+// On startup, the segments not included in the snapshot are replayed, in order.
+// A new segment is started on every startup, so a record torn by a crash is always
+// at the end of a segment that is never appended again.
 
-        // we increase the counter even on failures
-        // so that the registry will be saved periodically
-        registry.log_count++;
+#define REGISTRY_CHANGES_PREFIX "registry-changes-"
+#define REGISTRY_CHANGES_SUFFIX ".bin"
+
+struct registry_log_record {
+    uint32_t crc;                   // of everything after this field, up to the end of the record
+    uint32_t size;                  // of the whole record
+    uint8_t action;                 // 'A' for accesses, 'D' for deletes
+    uint32_t when;
+    char person_guid[GUID_LEN];
+    char machine_guid[GUID_LEN];
+    uint32_t name_len;
+    uint32_t url_len;
+    // followed by the name and the url, not terminated
+} __attribute__((packed));
+
+static void registry_log_segment_filename(char *dst, size_t size, uint64_t segment) {
+    snprintfz(dst, size, "%s/" REGISTRY_CHANGES_PREFIX "%010" PRIu64 REGISTRY_CHANGES_SUFFIX, registry.pathname, segment);
+}
 
-        // this must be outside the log_lock(), or a deadlock will happen.
-        // registry_db_save() checks the same inside the log_lock, so only
-        // one thread will save the db
-        if(unlikely(registry_db_should_be_saved()))
-            registry_db_save();
+static void registry_log_write(char action, REGISTRY_PERSON *p, REGISTRY_MACHINE *m, STRING *u, const char *name) {
+    // the registry is locked, so one buffer is enough
+    static uint8_t *buf = NULL;
+    static size_t buf_size = 0;
+
+    size_t name_len = strlen(name);
+    size_t url_len = string_strlen(u);
+    size_t size = sizeof(struct registry_log_record) + name_len + url_len;
+
+    if(unlikely(size > buf_size)) {
+        buf_size = size * 2;
+        buf = reallocz(buf, buf_size);
     }
+
+    struct registry_log_record r = {
+        .size = (uint32_t)size,
+        .action = (uint8_t)action,
+        .when = p->last_t,
+        .name_len = (uint32_t)name_len,
+        .url_len = (uint32_t)url_len,
+    };
+    memcpy(r.person_guid, p->guid, GUID_LEN);
+    memcpy(r.machine_guid, m->guid, GUID_LEN);
+
+    memcpy(buf, &r, sizeof(r));
+    memcpy(&buf[sizeof(r)], name, name_len);
+    memcpy(&buf[sizeof(r) + name_len], string2str(u), url_len);
+
+    r.crc = registry_crc32(&buf[sizeof(r.crc)], size - sizeof(r.crc));
+    memcpy(buf, &r.crc, sizeof(r.crc));
+
+    const uint8_t *s = buf;
+    size_t remaining = size;
+    while(remaining) {
+        ssize_t written = write(registry.changes.fd, s, remaining);
+        if(written > 0) {
+            s += written;
+            remaining -= written;
+        }
+        else if(written == -1 && errno == EINTR)
+            continue;
+        else {
+            netdata_log_error("Registry: failed to save log. Registry data may be lost in case of abnormal restart.");
+
+            // a partial record ends the segment, continue on a new one
+            registry_log_close();
+            registry.changes.segment++;
+            break;
+        }
+    }
+
+    registry.changes.bytes += size - remaining;
+}
+
+void registry_log(char action, REGISTRY_PERSON *p, REGISTRY_MACHINE *m, STRING *u, const char *name) {
+    if(unlikely(!registry.changes.logging))
+        return;
+
+    if(likely(registry.changes.fd != -1 || (!registry.changes.open_failed && registry_log_open() == 0)))
+        registry_log_write(action, p, m, u, name);
+
+    // we increase the counter even on failures
+    // so that the registry will be saved periodically
+    registry.log_count++;
+
+    if(unlikely(registry_db_should_be_saved()))
+        registry_db_save(false);
 }
 
 int registry_log_open(void) {
-    if(registry.log_fp)
-        fclose(registry.log_fp);
+    registry_log_close();
+
+    char filename[FILENAME_MAX + 1];
+    registry_log_segment_filename(filename, FILENAME_MAX, registry.changes.segment);
 
-    registry.log_fp = fopen(registry.log_filename, "a");
-    if(registry.log_fp) {
-        if (setvbuf(registry.log_fp, NULL, _IOLBF, 0) != 0)
-            netdata_log_error("Cannot set line buffering on registry log file.");
+    registry.changes.fd = open(filename, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0664);
+    if(registry.changes.fd != -1)
         return 0;
-    }
 
-    netdata_log_error("Cannot open registry log file '%s'. Registry data will be lost in case of netdata or server crash.", registry.log_filename);
+    registry.changes.open_failed = true;
+    netdata_log_error("Cannot open registry log file '%s'. Registry data will be lost in case of netdata or server crash.", filename);
     return -1;
 }
 
 void registry_log_close(void) {
-    if(registry.log_fp) {
-        fclose(registry.log_fp);
-        registry.log_fp = NULL;
+    if(registry.changes.fd != -1) {
+        close(registry.changes.fd);
+        registry.changes.fd = -1;
     }
+
+    registry.changes.open_failed = false;
+}
+
+// switch to a new segment, returning it - the segments before it are included in the snapshot being taken
+uint64_t registry_log_rotate(void) {
+    registry_log_close();
+    registry.changes.segment++;
+    registry.changes.bytes = 0;
+    return registry.changes.segment;
+}
+
+static int registry_log_segment_compar(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
 }
 
-void registry_log_recreate(void) {
-    if(registry.log_fp != NULL) {
-        registry_log_close();
+// find the segments in the registry directory, sorted
+static size_t registry_log_segments(uint64_t **segments) {
+    size_t used = 0, size = 0;
+    *segments = NULL;
 
-        // open it with truncate
-        registry.log_fp = fopen(registry.log_filename, "w");
-        if(registry.log_fp) fclose(registry.log_fp);
+    DIR *dir = opendir(registry.pathname);
+    if(!dir) {
+        netdata_log_error("Registry: cannot open directory '%s'", registry.pathname);
+        return 0;
+    }
+
+    struct dirent *de;
+    while((de = readdir(dir))) {
+        if(strncmp(de->d_name, REGISTRY_CHANGES_PREFIX, sizeof(REGISTRY_CHANGES_PREFIX) - 1) != 0)
+            continue;
+
+        char *end = NULL;
+        uint64_t segment = strtoull(&de->d_name[sizeof(REGISTRY_CHANGES_PREFIX) - 1], &end, 10);
+        if(!end || strcmp(end, REGISTRY_CHANGES_SUFFIX) != 0)
+            continue;
+
+        if(used == size) {
+            size = size ? size * 2 : 16;
+            *segments = reallocz(*segments, size * sizeof(uint64_t));
+        }
+        (*segments)[used++] = segment;
+    }
+    closedir(dir);
+
+    if(used)
+        qsort(*segments, used, sizeof(uint64_t), registry_log_segment_compar);
+
+    return used;
+}
+
+// delete the segments included in a snapshot
+void registry_log_delete_segments_before(uint64_t segment) {
+    uint64_t *segments;
+    size_t count = registry_log_segments(&segments);
+
+    char filename[FILENAME_MAX + 1];
+    for(size_t i = 0; i < count && segments[i] < segment; i++) {
+        registry_log_segment_filename(filename, FILENAME_MAX, segments[i]);
+        if(unlink(filename) == -1 && errno != ENOENT)
+            netdata_log_error("Registry: cannot delete log segment '%s'", filename);
+    }
+
+    freez(segments);
+}
+
+static ssize_t registry_log_load_segment(uint64_t segment) {
+    char filename[FILENAME_MAX + 1];
+    registry_log_segment_filename(filename, FILENAME_MAX, segment);
+
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if(fd == -1) {
+        netdata_log_error("Registry: cannot open log segment '%s'", filename);
+        return -1;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    uint8_t *data = nd_mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED) {
+        netdata_log_error("Registry: cannot mmap log segment '%s'", filename);
+        return -1;
+    }
+    madvise_sequential(data, size);
+
+    char person_guid[GUID_LEN + 1], machine_guid[GUID_LEN + 1];
+    char *strings = NULL;
+    size_t strings_size = 0;
+
+    ssize_t records = 0;
+    size_t pos = 0;
+    while(pos < size) {
+        struct registry_log_record r;
+
+        if(size - pos < sizeof(r))
+            break;
+
+        memcpy(&r, &data[pos], sizeof(r));
+
+        if(r.size != sizeof(r) + (uint64_t)r.name_len + r.url_len || r.size > size - pos ||
+            r.crc != registry_crc32(&data[pos + sizeof(r.crc)], r.size - sizeof(r.crc)))
+            break;
+
+        if(r.action != 'A' && r.action != 'D') {
+            netdata_log_error("Registry: ignoring record with action '%c' at offset %zu of '%s'.", r.action, pos, filename);
+            pos += r.size;
+            continue;
+        }
+
+        if(r.name_len + r.url_len + 2 > strings_size) {
+            strings_size = (r.name_len + r.url_len + 2) * 2;
+            strings = reallocz(strings, strings_size);
+        }
+
+        char *name = strings;
+        memcpy(name, &data[pos + sizeof(r)], r.name_len);
+        name[r.name_len] = '\0';
+
+        char *url = &strings[r.name_len + 1];
+        memcpy(url, &data[pos + sizeof(r) + r.name_len], r.url_len);
+        url[r.url_len] = '\0';
+
+        memcpy(person_guid, r.person_guid, GUID_LEN);
+        person_guid[GUID_LEN] = '\0';
+        memcpy(machine_guid, r.machine_guid, GUID_LEN);
+        machine_guid[GUID_LEN] = '\0';
+
+        // make sure the person exists
+        // without this, a new person guid will be created
+        REGISTRY_PERSON *p = registry_person_find(person_guid);
+        if(!p) p = registry_person_allocate(person_guid, r.when);
+
+        if(r.action == 'A')
+            registry_request_access(p->guid, machine_guid, url, name, r.when);
         else
-            netdata_log_error("Cannot truncate registry log '%s'", registry.log_filename);
+            registry_request_delete(p->guid, machine_guid, url, name, r.when);
 
-        registry.log_fp = NULL;
-        registry_log_open();
+        registry.log_count++;
+        records++;
+        pos += r.size;
     }
+
+    if(pos < size)
+        netdata_log_error("Registry: log segment '%s' is truncated or corrupted at offset %zu of %zu, ignoring the rest of it.",
+                          filename, pos, size);
+
+    registry.changes.bytes += pos;
+
+    freez(strings);
+    nd_munmap(data, size);
+    return records;
 }
 
-ssize_t registry_log_load(void) {
-    ssize_t line = -1;
+// replay the segments not included in the snapshot, and prepare a new segment for appending
+ssize_t registry_log_load(uint64_t first_segment) {
+    uint64_t *segments;
+    size_t count = registry_log_segments(&segments);
 
-    // closing the log is required here
-    // otherwise we will append to it the values we read
-    registry_log_close();
+    ssize_t records = 0;
+    uint64_t next = first_segment;
+    char filename[FILENAME_MAX + 1];
+
+    for(size_t i = 0; i < count; i++) {
+        if(segments[i] < first_segment) {
+            // the snapshot includes it, but it was not deleted
+            registry_log_segment_filename(filename, FILENAME_MAX, segments[i]);
+            if(unlink(filename) == -1 && errno != ENOENT)
+                netdata_log_error("Registry: cannot delete log segment '%s'", filename);
+            continue;
+        }
+
+        ssize_t rc = registry_log_load_segment(segments[i]);
+        if(rc > 0)
+            records += rc;
+
+        next = segments[i] + 1;
+    }
+
+    freez(segments);
+
+    registry.changes.segment = next;
+    registry.changes.logging = true;
+
+    return records;
+}
+
+// ----------------------------------------------------------------------------
+// the text log of older versions
+
+ssize_t registry_log_load_text(void) {
+    ssize_t line = -1;
 
     netdata_log_debug(D_REGISTRY, "Registry: loading active db from: %s", registry.log_filename);
     FILE *fp = fopen(registry.log_filename, "r");
-    if(!fp)
-        netdata_log_error("Registry: cannot open registry file: %s", registry.log_filename);
+    if(!fp) {
+        if(errno != ENOENT)
+            netdata_log_error("Registry: cannot open registry file: %s", registry.log_filename);
+    }
     else {
         char *s, buf[4096 + 1];
         line = 0;
@@ -130,8 +382,5 @@ ssize_t registry_log_load(void) {
         fclose(fp);
     }
 
-    // open the log again
-    registry_log_open();
-
     return line;
 }
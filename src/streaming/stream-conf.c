@@ -72,7 +72,12 @@ struct _stream_receive stream_receive = {
         .enabled = true,
         .period = 86400,
         .step = 3600,
-    }
+    },
+    .ingestion = {
+        .enabled = false,
+        .threads = 0,
+        .queue_size = 16384,
+    },
 };
 
 void stream_conf_set_sender_compression_levels(ND_COMPRESSION_PROFILE profile) {
@@ -169,6 +174,18 @@ void stream_conf_load() {
         inicfg_get_duration_seconds(&netdata_config, CONFIG_SECTION_DB, "replication step",
                                     stream_receive.replication.step);
 
+    stream_receive.ingestion.enabled =
+        inicfg_get_boolean(&netdata_config, CONFIG_SECTION_DB, "ingestion pipeline",
+                           stream_receive.ingestion.enabled);
+
+    stream_receive.ingestion.threads = inicfg_get_number_range(
+        &netdata_config, CONFIG_SECTION_DB, "ingestion pipeline threads",
+        MAX((long long)netdata_conf_cpus() / 4, 2), 1, 64);
+
+    stream_receive.ingestion.queue_size = inicfg_get_number_range(
+        &netdata_config, CONFIG_SECTION_DB, "ingestion pipeline queue size",
+        (long long)stream_receive.ingestion.queue_size, 256, 1048576);
+
     stream_send.replication.threads = inicfg_get_number_range(
         &netdata_config, CONFIG_SECTION_DB, "replication threads",
         replication_threads_default(), 1, MAX_REPLICATION_THREADS);
@@ -53,6 +53,12 @@ struct _stream_receive {
         time_t period;
         time_t step;
     } replication;
+
+    struct {
+        bool enabled;
+        size_t threads;
+        size_t queue_size;              // the chart updates each host can queue
+    } ingestion;
 };
 extern struct _stream_receive stream_receive;
 
@@ -75,6 +75,10 @@ struct receiver_state {
         nd_poll_event_t wanted;
         usec_t last_traffic_ut;
         struct pollfd_meta meta;
+
+        // we stopped reading the socket, until the storage workers
+        // drain the ingestion pipeline of the host and resume us
+        bool ingestion_paused;
     } thread;
 
     struct {
@@ -114,4 +118,6 @@ void stream_receiver_handle_op(struct stream_thread *sth, struct receiver_state
 void stream_receiver_check_all_nodes_from_poll(struct stream_thread *sth, usec_t now_ut);
 void stream_receiver_replication_check_from_poll(struct stream_thread *sth, usec_t now_ut);
 
+#define stream_receiver_wanted_read(rpt) ((rpt)->thread.ingestion_paused ? 0 : ND_POLL_READ)
+
 #endif //NETDATA_STREAM_RECEIVER_INTERNALS_H
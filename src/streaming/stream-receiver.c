@@ -300,6 +300,8 @@ static bool receiver_should_stop(struct receiver_state *rpt) {
 // --------------------------------------------------------------------------------------------------------------------
 
 ALWAYS_INLINE
+static void stream_receiver_ingestion_resume_from_opcode(struct stream_thread *sth, struct receiver_state *rpt);
+
 void stream_receiver_handle_op(struct stream_thread *sth, struct receiver_state *rpt, struct stream_opcode *msg) {
     ND_LOG_STACK lgs[] = {
         ND_LOG_FIELD_STR(NDF_NIDL_NODE, rpt->host->hostname),
@@ -328,8 +330,14 @@ void stream_receiver_handle_op(struct stream_thread *sth, struct receiver_state
         return;
     }
 
-    nd_log(NDLS_DAEMON, NDLP_ERR,
-           "STREAM RCV[%zu]: invalid msg id %u", sth->id, (unsigned)msg->opcode);
+    if(msg->opcode & STREAM_OPCODE_RECEIVER_INGESTION_RESUME) {
+        stream_receiver_ingestion_resume_from_opcode(sth, rpt);
+        msg->opcode &= ~(STREAM_OPCODE_RECEIVER_INGESTION_RESUME);
+    }
+
+    if(msg->opcode)
+        nd_log(NDLS_DAEMON, NDLP_ERR,
+               "STREAM RCV[%zu]: invalid msg id %u", sth->id, (unsigned)msg->opcode);
 }
 
 static ssize_t send_to_child(const char *txt, void *data, STREAM_TRAFFIC_TYPE type) {
@@ -536,6 +544,8 @@ static void stream_receiver_remove_internal(struct stream_thread *sth, struct re
     if(!nd_poll_del(sth->run.ndpl, rpt->sock.fd))
         nd_log(NDLS_DAEMON, NDLP_ERR, "Failed to delete receiver socket from nd_poll()");
 
+    rpt->thread.ingestion_paused = false;
+
     __atomic_store_n(&rpt->host->stream.rcv.status.tid, 0, __ATOMIC_RELAXED);
 
     // make sure send_to_plugin() will not write any data to the socket (or wait for it to finish)
@@ -696,7 +706,7 @@ bool stream_receiver_send_data(struct stream_thread *sth, struct receiver_state
             rpt->thread.last_traffic_ut = now_ut;
             stream_circular_buffer_del_unsafe(scb, rc, now_ut);
             if (!stats->bytes_outstanding) {
-                rpt->thread.wanted = ND_POLL_READ;
+                rpt->thread.wanted = stream_receiver_wanted_read(rpt);
                 if (!nd_poll_upd(sth->run.ndpl, rpt->sock.fd, rpt->thread.wanted))
                     nd_log(NDLS_DAEMON, NDLP_ERR,
                            "STREAM RCV[%zu] '%s' [from [%s]:%s]: cannot update nd_poll()",
@@ -769,6 +779,59 @@ bool stream_receiver_send_data(struct stream_thread *sth, struct receiver_state
     return EVLOOP_STATUS_STILL_ALIVE(status);
 }
 
+// ----------------------------------------------------------------------------
+// backpressure from the ingestion pipeline
+
+static void stream_receiver_ingestion_pause_if_congested(struct stream_thread *sth, struct receiver_state *rpt) {
+    if(rpt->thread.ingestion_paused || !rrdhost_ingestion_pause(rpt->host))
+        return;
+
+    // stop reading from the socket, so that the child will have to wait
+    rpt->thread.ingestion_paused = true;
+
+    rpt->thread.wanted &= ~ND_POLL_READ;
+    if(!nd_poll_upd(sth->run.ndpl, rpt->sock.fd, rpt->thread.wanted))
+        nd_log(NDLS_DAEMON, NDLP_ERR,
+               "STREAM RCV[%zu] '%s' [from [%s]:%s]: cannot update nd_poll()",
+               sth->id, rrdhost_hostname(rpt->host), rpt->remote_ip, rpt->remote_port);
+}
+
+static void stream_receiver_ingestion_resume_from_opcode(struct stream_thread *sth, struct receiver_state *rpt) {
+    internal_fatal(sth->tid != gettid_cached(), "Function %s() should only be used by the dispatcher thread", __FUNCTION__ );
+
+    if(!rpt->thread.ingestion_paused)
+        return;
+
+    rpt->thread.ingestion_paused = false;
+
+    // the time we were paused is not idle time
+    rpt->thread.last_traffic_ut = now_monotonic_usec();
+
+    rpt->thread.wanted |= ND_POLL_READ;
+    if(!nd_poll_upd(sth->run.ndpl, rpt->sock.fd, rpt->thread.wanted))
+        nd_log(NDLS_DAEMON, NDLP_ERR,
+               "STREAM RCV[%zu] '%s' [from [%s]:%s]: cannot update nd_poll()",
+               sth->id, rrdhost_hostname(rpt->host), rpt->remote_ip, rpt->remote_port);
+}
+
+// called by the storage workers, when they drain the queue of a paused receiver
+void stream_receiver_ingestion_resume(RRDHOST *host) {
+    rrdhost_receiver_lock(host);
+
+    struct receiver_state *rpt = host->receiver;
+    if(rpt) {
+        spinlock_lock(&rpt->thread.send_to_child.spinlock);
+        struct stream_opcode msg = rpt->thread.send_to_child.msg;
+        spinlock_unlock(&rpt->thread.send_to_child.spinlock);
+
+        msg.opcode = STREAM_OPCODE_RECEIVER_INGESTION_RESUME;
+        msg.reason = 0;
+        stream_receiver_send_opcode(rpt, msg);
+    }
+
+    rrdhost_receiver_unlock(host);
+}
+
 bool stream_receiver_receive_data(struct stream_thread *sth, struct receiver_state *rpt, usec_t now_ut, bool process_opcodes) {
     internal_fatal(sth->tid != gettid_cached(), "Function %s() should only be used by the dispatcher thread", __FUNCTION__ );
 
@@ -830,6 +893,9 @@ bool stream_receiver_receive_data(struct stream_thread *sth, struct receiver_sta
             status = EVLOOP_STATUS_OPCODE_ON_ME;
     }
 
+    if(EVLOOP_STATUS_STILL_ALIVE(status))
+        stream_receiver_ingestion_pause_if_congested(sth, rpt);
+
     return EVLOOP_STATUS_STILL_ALIVE(status);
 }
 
@@ -957,6 +1023,7 @@ void stream_receiver_check_all_nodes_from_poll(struct stream_thread *sth, usec_t
 
         time_t timeout_s = 600;
         if(unlikely(rpt->thread.last_traffic_ut + timeout_s * USEC_PER_SEC < now_ut &&
+                     !rpt->thread.ingestion_paused &&
                      !rrdhost_receiver_replicating_charts(rpt->host))) {
 
             ND_LOG_STACK lgs[] = {
@@ -989,7 +1056,7 @@ void stream_receiver_check_all_nodes_from_poll(struct stream_thread *sth, usec_t
             continue;
         }
 
-        nd_poll_event_t wanted = ND_POLL_READ | (stats.bytes_outstanding ? ND_POLL_WRITE : 0);
+        nd_poll_event_t wanted = stream_receiver_wanted_read(rpt) | (stats.bytes_outstanding ? ND_POLL_WRITE : 0);
         if(unlikely(rpt->thread.wanted != wanted)) {
 //            nd_log(NDLS_DAEMON, NDLP_DEBUG,
 //                   "STREAM RCV[%zu] '%s' [from %s]: nd_poll() wanted events mismatch.",
@@ -1185,9 +1252,14 @@ bool rrdhost_set_receiver(RRDHOST *host, struct receiver_state *rpt) {
     if(signal_rrdcontext)
         rrdcontext_host_child_connected(host);
 
-    if(set_this)
+    if(set_this) {
         ml_host_start(host);
 
+        // v1 children store inline with END, so only BEGIN2/END2 is pipelined
+        if(stream_has_capability(rpt, STREAM_CAP_INTERPOLATED))
+            rrdhost_ingestion_attach(host);
+    }
+
     return set_this;
 }
 
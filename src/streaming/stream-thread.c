@@ -49,7 +49,7 @@ static void stream_thread_handle_op(struct stream_thread *sth, struct stream_opc
         }
         else if(m->type == POLLFD_TYPE_RECEIVER) {
             if (msg->opcode & STREAM_OPCODE_RECEIVER_POLLOUT) {
-                m->rpt->thread.wanted = ND_POLL_READ | ND_POLL_WRITE;
+                m->rpt->thread.wanted = stream_receiver_wanted_read(m->rpt) | ND_POLL_WRITE;
                 if (!nd_poll_upd(sth->run.ndpl, m->rpt->sock.fd, m->rpt->thread.wanted)) {
                     nd_log_limit_static_global_var(erl, 1, 0);
                     nd_log_limit(&erl, NDLS_DAEMON, NDLP_ERR,
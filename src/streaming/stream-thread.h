@@ -25,6 +25,7 @@ typedef enum __attribute__((packed)) {
     STREAM_OPCODE_SENDER_RECONNECT_WITHOUT_COMPRESSION  = (1 << 4), // reconnect the node, but disable compression
     STREAM_OPCODE_SENDER_STOP_RECEIVER_LEFT             = (1 << 5), // disconnect the node, the receiver left
     STREAM_OPCODE_SENDER_STOP_HOST_CLEANUP              = (1 << 6), // disconnect the node, it is being de-allocated
+    STREAM_OPCODE_RECEIVER_INGESTION_RESUME             = (1 << 7), // read the socket again, the ingestion pipeline has room
 } STREAM_OPCODE;
 
 struct stream_opcode {
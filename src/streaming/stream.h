@@ -38,6 +38,7 @@ bool receiver_has_capability(struct rrdhost *host, STREAM_CAPABILITIES caps);
 void stream_receiver_free(struct receiver_state *rpt);
 bool stream_receiver_signal_to_stop_and_wait(struct rrdhost *host, STREAM_HANDSHAKE reason);
 char *stream_receiver_program_version_strdupz(struct rrdhost *host);
+void stream_receiver_ingestion_resume(struct rrdhost *host);
 
 #include "database/rrdhost-status.h"
 #include "protocol/commands.h"
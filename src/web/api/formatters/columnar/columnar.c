@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "columnar.h"
+
+#define COLUMNAR_ALIGN(x) (((x) + 7) & ~((size_t)7))
+
+static void columnar_add_padded(BUFFER *wb, const void *mem, size_t bytes) {
+    static const uint8_t zeros[8] = { 0 };
+
+    if(bytes)
+        buffer_memcat(wb, mem, bytes);
+
+    if(COLUMNAR_ALIGN(bytes) != bytes)
+        buffer_memcat(wb, zeros, COLUMNAR_ALIGN(bytes) - bytes);
+}
+
+static void columnar_add_string(BUFFER *wb, STRING *s) {
+    uint32_t len = (uint32_t)string_strlen(s);
+    buffer_memcat(wb, &len, sizeof(len));
+    columnar_add_padded(wb, string2str(s), len);
+}
+
+static inline size_t columnar_batch_bytes(size_t rows, size_t columns) {
+    size_t bitmap = COLUMNAR_ALIGN((rows + 7) / 8);
+    return sizeof(RRDR_COLUMNAR_BATCH)
+           + rows * sizeof(int64_t)
+           + columns * (2 * rows * sizeof(double) + 3 * bitmap);
+}
+
+void rrdr2columnar(RRDR *r, BUFFER *wb, RRDR_OPTIONS options) {
+    const size_t used = r->d;
+    const size_t rows = rrdr_rows(r);
+
+    size_t columns = 0;
+    for(size_t c = 0; c < used ; c++)
+        if(rrdr_dimension_should_be_exposed(r->od[c], options))
+            columns++;
+
+    RRDR_COLUMNAR_HEADER header = {
+        .byte_order_mark = RRDR_COLUMNAR_BYTE_ORDER_MARK,
+        .version = RRDR_COLUMNAR_VERSION,
+        .columns = (uint32_t)columns,
+        .flags = ((options & RRDR_OPTION_MILLISECONDS) ? RRDR_COLUMNAR_FLAG_MILLISECONDS : 0) |
+                 ((options & RRDR_OPTION_NULL2ZERO) ? RRDR_COLUMNAR_FLAG_NULL2ZERO : 0),
+        .rows = columns ? rows : 0,
+        .after = r->view.after,
+        .before = r->view.before,
+        .update_every = (uint32_t)r->view.update_every,
+    };
+    memcpy(header.magic, RRDR_COLUMNAR_MAGIC, sizeof(header.magic));
+    buffer_memcat(wb, &header, sizeof(header));
+
+    // the schema: id, name and units of each column
+    for(size_t c = 0; c < used ; c++) {
+        if(!rrdr_dimension_should_be_exposed(r->od[c], options))
+            continue;
+
+        columnar_add_string(wb, r->di[c]);
+        columnar_add_string(wb, r->dn[c]);
+        columnar_add_string(wb, r->du ? r->du[c] : NULL);
+    }
+
+    // the rows, in batches, so that clients can decode them while they are received
+    const bool reversed = (options & RRDR_OPTION_REVERSED);
+    const int64_t time_multiplier = (options & RRDR_OPTION_MILLISECONDS) ? (int64_t)MSEC_PER_SEC : 1;
+    const double empty_value = (options & RRDR_OPTION_NULL2ZERO) ? 0.0 : NAN;
+
+    size_t batch_rows_max = MIN(rows, (size_t)RRDR_COLUMNAR_MAX_BATCH_ROWS);
+    if(columns && rows)
+        buffer_need_bytes(wb, (rows / batch_rows_max + 1) * columnar_batch_bytes(batch_rows_max, columns) + sizeof(RRDR_COLUMNAR_BATCH) + 1);
+
+    for(size_t done = 0; columns && done < rows ; ) {
+        size_t n = MIN(rows - done, (size_t)RRDR_COLUMNAR_MAX_BATCH_ROWS);
+        size_t bitmap_bytes = COLUMNAR_ALIGN((n + 7) / 8);
+        size_t bytes = columnar_batch_bytes(n, columns);
+
+        // we write directly into the buffer
+        buffer_need_bytes(wb, bytes + 1);
+        uint8_t *p = (uint8_t *)&wb->buffer[wb->len];
+        memset(p, 0, bytes);
+
+        RRDR_COLUMNAR_BATCH *batch = (RRDR_COLUMNAR_BATCH *)p;
+        batch->rows = (uint32_t)n;
+        p += sizeof(*batch);
+
+        // the row index in RRDR of the k-th row of the batch
+        // the default order is newest to oldest, like all the other formats
+#define COLUMNAR_ROW(k) (reversed ? (done + (k)) : (rows - 1 - (done + (k))))
+
+        int64_t *t = (int64_t *)p;
+        for(size_t k = 0; k < n ; k++)
+            t[k] = (int64_t)r->t[COLUMNAR_ROW(k)] * time_multiplier;
+        p += n * sizeof(int64_t);
+
+        for(size_t c = 0; c < used ; c++) {
+            if(!rrdr_dimension_should_be_exposed(r->od[c], options))
+                continue;
+
+            double *values = (double *)p;
+            p += n * sizeof(double);
+
+            double *anomaly_rates = (double *)p;
+            p += n * sizeof(double);
+
+            uint8_t *valid = p;
+            p += bitmap_bytes;
+
+            uint8_t *reset = p;
+            p += bitmap_bytes;
+
+            uint8_t *partial = p;
+            p += bitmap_bytes;
+
+            for(size_t k = 0; k < n ; k++) {
+                size_t slot = COLUMNAR_ROW(k) * used + c;
+                RRDR_VALUE_FLAGS o = r->o[slot];
+
+                if(unlikely(o & RRDR_VALUE_EMPTY))
+                    values[k] = empty_value;
+                else {
+                    values[k] = (double)r->v[slot];
+                    valid[k >> 3] |= (uint8_t)(1 << (k & 7));
+                }
+
+                anomaly_rates[k] = (double)r->ar[slot];
+
+                if(unlikely(o & RRDR_VALUE_RESET))
+                    reset[k >> 3] |= (uint8_t)(1 << (k & 7));
+
+                if(unlikely(o & RRDR_VALUE_PARTIAL))
+                    partial[k >> 3] |= (uint8_t)(1 << (k & 7));
+            }
+        }
+
+#undef COLUMNAR_ROW
+
+        wb->len += bytes;
+        wb->buffer[wb->len] = '\0';
+        buffer_overflow_check(wb);
+
+        done += n;
+    }
+
+    RRDR_COLUMNAR_BATCH end = { .rows = 0 };
+    buffer_memcat(wb, &end, sizeof(end));
+}
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_API_FORMATTER_COLUMNAR_H
+#define NETDATA_API_FORMATTER_COLUMNAR_H
+
+#include "../rrd2json.h"
+
+// the binary columnar format - see README.md for the layout
+
+#define RRDR_COLUMNAR_MAGIC             "NDCOLUMN"
+#define RRDR_COLUMNAR_VERSION           1
+#define RRDR_COLUMNAR_BYTE_ORDER_MARK   0x01020304U
+#define RRDR_COLUMNAR_MAX_BATCH_ROWS    65536
+
+typedef enum __attribute__((packed)) {
+    RRDR_COLUMNAR_FLAG_NONE             = 0,
+    RRDR_COLUMNAR_FLAG_MILLISECONDS     = (1 << 0), // the timestamps are in milliseconds, otherwise seconds
+    RRDR_COLUMNAR_FLAG_NULL2ZERO        = (1 << 1), // empty values are 0, otherwise NaN
+} RRDR_COLUMNAR_FLAGS;
+
+typedef struct rrdr_columnar_header {
+    char magic[8];
+    uint32_t byte_order_mark;
+    uint32_t version;
+    uint32_t columns;
+    uint32_t flags;
+    uint64_t rows;
+    int64_t after;
+    int64_t before;
+    uint32_t update_every;
+    uint32_t reserved;
+} RRDR_COLUMNAR_HEADER;
+
+_Static_assert(sizeof(RRDR_COLUMNAR_HEADER) == 56, "RRDR_COLUMNAR_HEADER must be 56 bytes");
+
+typedef struct rrdr_columnar_batch {
+    uint32_t rows;                  // 0 marks the end of the stream
+    uint32_t reserved;
+} RRDR_COLUMNAR_BATCH;
+
+void rrdr2columnar(RRDR *r, BUFFER *wb, RRDR_OPTIONS options);
+
+#endif //NETDATA_API_FORMATTER_COLUMNAR_H
@@ -384,6 +384,12 @@ int data_query_execute(ONEWAYALLOC *owa, BUFFER *wb, QUERY_TARGET *qt, time_t *l
         rrdr2json_v2(r, wb);
         wrapper_end(r, wb);
         break;
+
+    case DATASOURCE_COLUMNAR:
+        // binary, it cannot be wrapped in json
+        wb->content_type = CT_APPLICATION_OCTET_STREAM;
+        rrdr2columnar(r, wb, options);
+        break;
     }
 
     rrdr_free(owa, r);
@@ -11,6 +11,7 @@
 #include "web/api/formatters/ssv/ssv.h"
 #include "web/api/formatters/json/json.h"
 #include "web/api/formatters/value/value.h"
+#include "web/api/formatters/columnar/columnar.h"
 
 #include "web/api/formatters/rrdset2json.h"
 #include "web/api/formatters/charts2json.h"
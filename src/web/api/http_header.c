@@ -5,17 +5,17 @@
 #include <string.h>
 #include <strings.h>
 
-static void web_client_enable_deflate(struct web_client *w, bool gzip) {
-    if(gzip)
+static void web_client_enable_compression(struct web_client *w) {
+    HTTP_CONTENT_ENCODING accepted = w->accept_encoding;
+
+    if(accepted & HTTP_CONTENT_ENCODING_GZIP)
         web_client_flag_set(w, WEB_CLIENT_ENCODING_GZIP);
-    else
-        web_client_flag_set(w, WEB_CLIENT_ENCODING_DEFLATE);
 
     if(!web_client_check_conn_unix(w) && !web_client_check_conn_tcp(w) && !web_client_check_conn_cloud(w))
         return;
 
-    if(unlikely(w->response.zinitialized)) {
-        // compression has already been initialized for this client.
+    if(unlikely(w->response.zoutput)) {
+        // compression has already been enabled for this client.
         return;
     }
 
@@ -24,37 +24,32 @@ static void web_client_enable_deflate(struct web_client *w, bool gzip) {
         return;
     }
 
-    w->response.zstream.zalloc = Z_NULL;
-    w->response.zstream.zfree = Z_NULL;
-    w->response.zstream.opaque = Z_NULL;
-
-    w->response.zstream.next_in = (Bytef *)w->response.data->buffer;
-    w->response.zstream.avail_in = 0;
-    w->response.zstream.total_in = 0;
-
-    w->response.zstream.next_out = w->response.zbuffer;
-    w->response.zstream.avail_out = 0;
-    w->response.zstream.total_out = 0;
+    if(web_client_check_conn_cloud(w))
+        // the cloud expects gzip responses
+        accepted &= HTTP_CONTENT_ENCODING_GZIP;
 
-    w->response.zstream.zalloc = Z_NULL;
-    w->response.zstream.zfree = Z_NULL;
-    w->response.zstream.opaque = Z_NULL;
+    // responses that are not finished with the request may grow while being sent
+    bool streaming = !(w->mode == HTTP_REQUEST_MODE_GET ||
+                       w->mode == HTTP_REQUEST_MODE_POST ||
+                       w->mode == HTTP_REQUEST_MODE_PUT ||
+                       w->mode == HTTP_REQUEST_MODE_DELETE);
 
-    // Select GZIP compression: windowbits = 15 + 16 = 31
-    if(deflateInit2(&w->response.zstream, web_gzip_level, Z_DEFLATED, 15 + ((gzip)?16:0), 8, web_gzip_strategy) != Z_OK) {
-        netdata_log_error("%llu: Failed to initialize zlib. Proceeding without compression.", w->id);
+    HTTP_CONTENT_ENCODING encoding = web_response_compression_select(accepted, streaming);
+    if(encoding == HTTP_CONTENT_ENCODING_NONE)
         return;
-    }
 
+    // the compressor is acquired when the response is ready, if its body is still
+    // to be compressed (static files may be sent pre-compressed or with sendfile())
+    w->response.zencoding = encoding;
     w->response.zsent = 0;
+    w->response.zhave = 0;
     w->response.zoutput = true;
-    w->response.zinitialized = true;
 
     if(!web_client_check_conn_cloud(w))
         // cloud sends the entire response at once, not in chunks
         web_client_flag_set(w, WEB_CLIENT_CHUNKED_TRANSFER);
 
-    netdata_log_debug(D_DEFLATE, "%llu: Initialized compression.", w->id);
+    netdata_log_debug(D_DEFLATE, "%llu: Enabled %s compression.", w->id, HTTP_CONTENT_ENCODING_2str(encoding));
 }
 
 static void http_header_origin(struct web_client *w, const char *v, size_t len __maybe_unused) {
@@ -134,14 +129,10 @@ static void http_header_host(struct web_client *w, const char *v, size_t len) {
 }
 
 static void http_header_accept_encoding(struct web_client *w, const char *v, size_t len __maybe_unused) {
-    if(web_enable_gzip) {
-        if(strcasestr(v, "gzip"))
-            web_client_enable_deflate(w, true);
+    w->accept_encoding = http_accept_encoding_parse(v);
 
-        // does not seem to work
-        // else if(strcasestr(v, "deflate"))
-        //  web_client_enable_deflate(w, 0);
-    }
+    if(web_enable_gzip)
+        web_client_enable_compression(w);
 }
 
 static void http_header_x_forwarded_host(struct web_client *w, const char *v, size_t len) {
@@ -37,6 +37,13 @@ static inline void tg_average_add(RRDR *r, NETDATA_DOUBLE value) {
     g->count++;
 }
 
+// a point that stands for many points of equal value (a page summary of tier 0)
+static inline void tg_average_add_weighted(RRDR *r, NETDATA_DOUBLE value, size_t weight) {
+    struct tg_average *g = (struct tg_average *)r->time_grouping.data;
+    g->sum += value * (NETDATA_DOUBLE)weight;
+    g->count += weight;
+}
+
 static inline NETDATA_DOUBLE tg_average_flush(RRDR *r, RRDR_VALUE_FLAGS *rrdr_value_options_ptr) {
     struct tg_average *g = (struct tg_average *)r->time_grouping.data;
 
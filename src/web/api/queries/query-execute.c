@@ -59,7 +59,10 @@ static long rrdr_line_init(RRDR *r __maybe_unused, time_t t __maybe_unused, long
         if(unlikely((point).sp.flags & SN_FLAG_RESET))                  \
             (ops)->group_value_flags |= RRDR_VALUE_RESET;               \
                                                                         \
-        time_grouping_add(r, (point).value, add_flush);                 \
+        if(unlikely((ops)->weigh_summaries && (point).sp.count > 1))   \
+            time_grouping_add_weighted(r, (point).value, (point).sp.count, add_flush); \
+        else                                                            \
+            time_grouping_add(r, (point).value, add_flush);             \
                                                                         \
         storage_point_merge_to((ops)->group_point, (point).sp);         \
         if(!(point).added)                                              \
@@ -725,6 +725,15 @@ void rrdr_set_grouping_function(RRDR *r, RRDR_TIME_GROUPING group_method) {
 }
 
 ALWAYS_INLINE_HOT_FLATTEN
+void time_grouping_add_weighted(RRDR *r, NETDATA_DOUBLE value, size_t weight, const RRDR_TIME_GROUPING add_flush) {
+    // only the average depends on the number of points,
+    // the other groupings that accept page summaries need their value once
+    if(add_flush == RRDR_GROUPING_AVERAGE)
+        tg_average_add_weighted(r, value, weight);
+    else
+        time_grouping_add(r, value, add_flush);
+}
+
 void time_grouping_add(RRDR *r, NETDATA_DOUBLE value, const RRDR_TIME_GROUPING add_flush) {
     switch(add_flush) {
         case RRDR_GROUPING_AVERAGE:
@@ -58,6 +58,7 @@ typedef struct query_engine_ops {
     size_t tier;
     struct query_metric_tier *tier_ptr;
     struct storage_engine_query_handle *seqh;
+    bool weigh_summaries;               // page summaries weigh as many points as they aggregate
 
     // aggregating points over time
     size_t group_points_non_zero;
@@ -95,6 +96,7 @@ void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr, QUERY_ENGINE_OPS *op
 
 // time aggregation
 void time_grouping_add(RRDR *r, NETDATA_DOUBLE value, const RRDR_TIME_GROUPING add_flush);
+void time_grouping_add_weighted(RRDR *r, NETDATA_DOUBLE value, size_t weight, const RRDR_TIME_GROUPING add_flush);
 NETDATA_DOUBLE time_grouping_flush(RRDR *r, RRDR_VALUE_FLAGS *rrdr_value_options_ptr, const RRDR_TIME_GROUPING add_flush);
 void rrdr_set_grouping_function(RRDR *r, RRDR_TIME_GROUPING group_method);
 
@@ -210,9 +210,43 @@ static size_t query_planer_expand_duration_in_points(time_t this_update_every, t
     return points;
 }
 
+// when the time aggregation needs only the min, max, sum and count of the points of
+// each group, the storage engine may give us a single point for many of its points
+static time_t query_planer_group_every(QUERY_ENGINE_OPS *ops) {
+    RRDR *r = ops->r;
+
+    // the absolute of the aggregates is not the aggregate of the absolute values
+    if(r->internal.qt->window.options & RRDR_OPTION_ABSOLUTE)
+        return 0;
+
+    switch(r->time_grouping.add_flush) {
+        case RRDR_GROUPING_AVERAGE:
+            // a page summary has to weigh as many points as it replaces, and only the
+            // summaries of tier 0 know them: their count is the number of their points
+            // (the points of higher tiers are averages themselves, with varying counts)
+            if(ops->qm->plan.used != 1 || ops->qm->plan.array[0].tier != 0)
+                return 0;
+
+            return ops->view_update_every;
+
+        case RRDR_GROUPING_MIN:
+        case RRDR_GROUPING_MAX:
+        case RRDR_GROUPING_SUM:
+            return ops->view_update_every;
+
+        default:
+            return 0;
+    }
+}
+
 static void query_planer_initialize_plans(QUERY_ENGINE_OPS *ops) {
     QUERY_METRIC *qm = ops->qm;
 
+    // rrd2rrdr_query_execute() groups the points in the same way
+    time_t group_every_s = query_planer_group_every(ops);
+    time_t group_anchor_s = ops->r->internal.qt->window.after - ops->query_granularity;
+    ops->weigh_summaries = group_every_s && ops->r->time_grouping.add_flush == RRDR_GROUPING_AVERAGE;
+
     for(size_t p = 0; p < qm->plan.used ; p++) {
         size_t tier = qm->plan.array[p].tier;
         time_t update_every = qm->tiers[tier].db_update_every_s;
@@ -251,8 +285,9 @@ static void query_planer_initialize_plans(QUERY_ENGINE_OPS *ops) {
 
         struct query_metric_tier *tier_ptr = &qm->tiers[tier];
         STORAGE_ENGINE *eng = query_metric_storage_engine(ops->r->internal.qt, qm, tier);
-        storage_engine_query_init(eng->seb, tier_ptr->smh, &ops->plans[p].handle,
-                                  after, before, ops->r->internal.qt->request.priority);
+        storage_engine_query_init_grouped(eng->seb, tier_ptr->smh, &ops->plans[p].handle,
+                                          after, before, ops->r->internal.qt->request.priority,
+                                          group_anchor_s, group_every_s);
 
         ops->plans[p].initialized = true;
         ops->plans[p].finalized = false;
@@ -167,13 +167,277 @@ static void web_server_del_callback(POLLINFO *pi) {
     worker_is_idle();
 }
 
+static bool web_server_should_stop(void) {
+    return !service_running(SERVICE_WEB_SERVER);
+}
+
 static __thread POLLINFO *current_thread_pollinfo = NULL;
 
 void web_server_remove_current_socket_from_poll(void) {
-    if(!current_thread_pollinfo) return;
+    // a suspended socket (one processed by the query executor) is not in the poll
+    if(!current_thread_pollinfo || (current_thread_pollinfo->flags & POLLINFO_FLAG_SUSPENDED)) return;
     poll_process_remove_from_poll(current_thread_pollinfo);
 }
 
+// it may run on the query executor threads, so it does not touch the POLLINFO,
+// it returns the POLLINFO flags the caller has to set on the poll thread
+static uint32_t web_server_process_request(POLLINFO *pi, struct web_client *w, nd_poll_event_t *events) {
+    int fd = pi->fd;
+    uint32_t flags = 0;
+
+    current_thread_pollinfo = pi;
+    web_client_process_request_from_web_server(w);
+    current_thread_pollinfo = NULL;
+
+    // The first-request timeout protects request ingress only.
+    // Once we no longer wait to receive request bytes, the first request is complete.
+    if(unlikely(!web_client_has_wait_receive(w)))
+        flags |= POLLINFO_FLAG_FIRST_REQUEST_RECEIVED;
+
+    if (unlikely(w->mode == HTTP_REQUEST_MODE_STREAM)) {
+        ssize_t rc = web_client_send(w);
+        if(rc > 0)
+            pulse_web_server_sent_bytes(rc);
+    }
+    else if(unlikely(w->fd == fd && web_client_has_wait_receive(w)))
+        *events |= ND_POLL_READ;
+
+    if(unlikely(w->fd == fd && web_client_has_wait_send(w)))
+        *events |= ND_POLL_WRITE;
+
+    return flags;
+}
+
+// ----------------------------------------------------------------------------
+// query executor
+// the expensive API queries are executed by a pool of threads, so that a slow
+// query does not block all the other sockets multiplexed on the same web server
+// thread - the socket is suspended while the query runs and it is given back
+// to its web server thread when the response is ready.
+
+typedef enum __attribute__((packed)) {
+    WEB_QUERY_PRIORITY_HIGH = 0,    // interactive queries (dashboards)
+    WEB_QUERY_PRIORITY_LOW,         // bulk queries (scoring, functions)
+
+    // terminator
+    WEB_QUERY_PRIORITY_MAX,
+} WEB_QUERY_PRIORITY;
+
+static const struct {
+    const char *endpoint;
+    size_t len;
+    WEB_QUERY_PRIORITY priority;
+} web_query_offloaded_endpoints[] = {
+    { "data",     4, WEB_QUERY_PRIORITY_HIGH },
+    { "weights",  7, WEB_QUERY_PRIORITY_LOW },
+    { "function", 8, WEB_QUERY_PRIORITY_LOW },
+
+    // terminator
+    { NULL,       0, 0 },
+};
+
+#define WORKER_JOB_QUERY_EXECUTE 0
+
+struct web_query_job {
+    POLLINFO *pi;
+    struct web_client *w;
+    usec_t queued_ut;
+    struct web_query_job *prev, *next;
+};
+
+static struct {
+    size_t threads;
+    size_t max_queued;
+    ND_THREAD **executors;
+
+    netdata_mutex_t mutex;
+    netdata_cond_t cond;
+    bool stop;
+    size_t queued;
+    struct web_query_job *queues[WEB_QUERY_PRIORITY_MAX];
+} web_query_executor = { 0 };
+
+static bool web_query_offloaded_priority(struct web_client *w, WEB_QUERY_PRIORITY *priority) {
+    const char *s = buffer_tostring(w->response.data);
+
+    // we need the complete request headers, so that the executor will not wait for more data
+    const char *eoh = strstr(s, "\r\n\r\n");
+    if(!eoh)
+        return false;
+
+    // skip the method
+    while(s < eoh && *s != ' ') s++;
+    while(s < eoh && *s == ' ') s++;
+
+    // find the API endpoint in the path (it may be prefixed by /host/xxx or /node/xxx)
+    const char *api = NULL;
+    for(const char *p = s; p < eoh && *p != ' ' && *p != '?'; p++) {
+        if(*p == '/' && strncmp(p, "/api/v", 6) == 0) {
+            api = &p[6];
+            break;
+        }
+    }
+    if(!api)
+        return false;
+
+    while(isdigit((uint8_t)*api)) api++;
+    if(*api++ != '/')
+        return false;
+
+    for(size_t i = 0; web_query_offloaded_endpoints[i].endpoint; i++) {
+        size_t len = web_query_offloaded_endpoints[i].len;
+        if(strncmp(api, web_query_offloaded_endpoints[i].endpoint, len) == 0 &&
+            (api[len] == '?' || api[len] == ' ' || api[len] == '/' || api[len] == '\0')) {
+            *priority = web_query_offloaded_endpoints[i].priority;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool web_query_executor_offload(POLLINFO *pi, struct web_client *w) {
+    WEB_QUERY_PRIORITY priority;
+
+    if(!web_query_executor.threads || w->mode == HTTP_REQUEST_MODE_STREAM || !web_query_offloaded_priority(w, &priority))
+        return false;
+
+    struct web_query_job *job = mallocz(sizeof(*job));
+    job->pi = pi;
+    job->w = w;
+    job->queued_ut = now_monotonic_usec();
+    job->prev = job->next = NULL;
+
+    netdata_mutex_lock(&web_query_executor.mutex);
+
+    // the queue is bounded - when it is full, the web server thread executes the query itself
+    bool overflow = web_query_executor.queued >= web_query_executor.max_queued;
+    if(web_query_executor.stop || overflow || !poll_process_suspend(pi)) {
+        netdata_mutex_unlock(&web_query_executor.mutex);
+        if(overflow)
+            pulse_web_request_executor_overflow();
+        freez(job);
+        return false;
+    }
+
+    DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(web_query_executor.queues[priority], job, prev, next);
+    web_query_executor.queued++;
+    netdata_cond_signal(&web_query_executor.cond);
+    netdata_mutex_unlock(&web_query_executor.mutex);
+
+    return true;
+}
+
+static struct web_query_job *web_query_executor_get_job(void) {
+    struct web_query_job *job = NULL;
+
+    netdata_mutex_lock(&web_query_executor.mutex);
+    while(!job) {
+        for(size_t p = 0; p < WEB_QUERY_PRIORITY_MAX && !job; p++) {
+            job = web_query_executor.queues[p];
+            if(job)
+                DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(web_query_executor.queues[p], job, prev, next);
+        }
+
+        if(job)
+            web_query_executor.queued--;
+        else if(web_query_executor.stop)
+            break;
+        else
+            netdata_cond_timedwait(&web_query_executor.cond, &web_query_executor.mutex, 100 * NSEC_PER_MSEC);
+    }
+    netdata_mutex_unlock(&web_query_executor.mutex);
+
+    return job;
+}
+
+static void web_query_executor_thread(void *ptr __maybe_unused) {
+    worker_register("WEBQUERY");
+    worker_register_job_name(WORKER_JOB_QUERY_EXECUTE, "query");
+
+    struct web_query_job *job;
+    while((job = web_query_executor_get_job())) {
+        worker_is_busy(WORKER_JOB_QUERY_EXECUTE);
+
+        POLLINFO *pi = job->pi;
+        struct web_client *w = job->w;
+
+        nd_poll_event_t events = ND_POLL_NONE;
+        uint32_t flags = 0;
+
+        // when the web server is stopping, its threads wait for their sockets,
+        // so we give them back without running the queries still queued
+        if(likely(!web_server_should_stop())) {
+            usec_t started_ut = now_monotonic_usec();
+
+            flags = web_server_process_request(pi, w, &events);
+            if(web_server_check_client_status(w) == -1)
+                events = ND_POLL_NONE;
+
+            pulse_web_request_executed(started_ut - job->queued_ut, now_monotonic_usec() - started_ut);
+        }
+
+        freez(job);
+
+        // give the socket back to its web server thread (or close it, when there are no events)
+        poll_process_resume(pi, events, flags);
+
+        worker_is_idle();
+    }
+
+    worker_unregister();
+}
+
+static void web_query_executor_start(void) {
+    size_t cpus = netdata_conf_cpus();
+    web_query_executor.threads = (size_t)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "web server query executor threads",
+                                                           (long long int)MIN(MAX(cpus, 2), 32));
+
+    web_query_executor.max_queued = (size_t)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "web server query executor queue size",
+                                                              1024);
+
+    if(!web_query_executor.threads || !web_query_executor.max_queued) {
+        netdata_log_info("web server query executor is disabled - queries will run on the web server threads");
+        web_query_executor.threads = 0;
+        return;
+    }
+
+    netdata_mutex_init(&web_query_executor.mutex);
+    netdata_cond_init(&web_query_executor.cond);
+
+    web_query_executor.executors = callocz(web_query_executor.threads, sizeof(ND_THREAD *));
+    for(size_t i = 0; i < web_query_executor.threads; i++) {
+        char tag[ND_THREAD_TAG_MAX + 1];
+        snprintfz(tag, sizeof(tag) - 1, "WEBQRY[%zu]", i);
+        web_query_executor.executors[i] = nd_thread_create(tag, NETDATA_THREAD_OPTION_DEFAULT,
+                                                           web_query_executor_thread, NULL);
+    }
+}
+
+static void web_query_executor_stop(void) {
+    if(!web_query_executor.threads)
+        return;
+
+    // the web server threads wait for all their sockets to be given back before exiting,
+    // so the queues are empty - just wake up the executors to exit
+    netdata_mutex_lock(&web_query_executor.mutex);
+    web_query_executor.stop = true;
+    netdata_cond_broadcast(&web_query_executor.cond);
+    netdata_mutex_unlock(&web_query_executor.mutex);
+
+    for(size_t i = 0; i < web_query_executor.threads; i++)
+        nd_thread_join(web_query_executor.executors[i]);
+
+    freez(web_query_executor.executors);
+    web_query_executor.executors = NULL;
+    web_query_executor.threads = 0;
+
+    netdata_cond_destroy(&web_query_executor.cond);
+    netdata_mutex_destroy(&web_query_executor.mutex);
+}
+
+// ----------------------------------------------------------------------------
+
 static int web_server_rcv_callback(POLLINFO *pi, nd_poll_event_t *events) {
     int ret = -1;
     worker_is_busy(WORKER_JOB_RCV_DATA);
@@ -190,32 +454,22 @@ static int web_server_rcv_callback(POLLINFO *pi, nd_poll_event_t *events) {
         pulse_web_server_received_bytes(bytes);
 
         netdata_log_debug(D_WEB_CLIENT, "%llu: processing received data on fd %d.", w->id, fd);
+
+        if(web_query_executor_offload(pi, w)) {
+            // the socket is now owned by the query executor
+            ret = 0;
+            goto cleanup;
+        }
+
         worker_is_idle();
         worker_is_busy(WORKER_JOB_PROCESS);
-        current_thread_pollinfo = pi;
-        web_client_process_request_from_web_server(w);
-        current_thread_pollinfo = NULL;
+        pi->flags |= web_server_process_request(pi, w, events);
 
         // Request processing may block for long-running functions.
         // Refresh receive timestamp so idle timeout uses the actual return time.
+        // (the poll thread does this when the query executor gives the socket back)
         pi->last_received_t = now_boottime_sec();
 
-        // The first-request timeout protects request ingress only.
-        // Once we no longer wait to receive request bytes, the first request is complete.
-        if(unlikely(!(pi->flags & POLLINFO_FLAG_FIRST_REQUEST_RECEIVED) && !web_client_has_wait_receive(w)))
-            pi->flags |= POLLINFO_FLAG_FIRST_REQUEST_RECEIVED;
-
-        if (unlikely(w->mode == HTTP_REQUEST_MODE_STREAM)) {
-            ssize_t rc = web_client_send(w);
-            if(rc > 0)
-                pulse_web_server_sent_bytes(rc);
-        }
-        else if(unlikely(w->fd == fd && web_client_has_wait_receive(w)))
-            *events |= ND_POLL_READ;
-
-        if(unlikely(w->fd == fd && web_client_has_wait_send(w)))
-            *events |= ND_POLL_WRITE;
-
     } else if(unlikely(bytes < 0)) {
         ret = -1;
         goto cleanup;
@@ -287,10 +541,6 @@ static void socket_listen_main_static_threaded_worker_cleanup(void *pptr) {
     worker_unregister();
 }
 
-static bool web_server_should_stop(void) {
-    return !service_running(SERVICE_WEB_SERVER);
-}
-
 void socket_listen_main_static_threaded_worker(void *ptr) {
     worker_private = ptr;
     spinlock_lock(&worker_private->spinlock);
@@ -354,6 +604,8 @@ static void socket_listen_main_static_threaded_cleanup(void *pptr) {
         (void) nd_thread_join(static_workers_private_data[i].thread);
     }
 
+    web_query_executor_stop();
+
     static_thread->enabled = NETDATA_MAIN_THREAD_EXITED;
 }
 
@@ -372,6 +624,7 @@ void socket_listen_main_static_threaded(void *ptr) {
     netdata_ssl_initialize_ctx(NETDATA_SSL_WEB_SERVER_CTX);
 
     static_threaded_workers_count = netdata_conf_web_query_threads();
+    web_query_executor_start();
 
     size_t max_sockets = (size_t)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "web server max sockets",
                                                    (long long int)(rlimit_nofile.rlim_cur / 4));
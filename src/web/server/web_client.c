@@ -1,10 +1,15 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "web_client.h"
+#include "web_static_files_cache.h"
 #include "web/websocket/websocket.h"
 #include "web/mcp/adapters/mcp-http.h"
 #include "web/mcp/adapters/mcp-sse.h"
 
+#if defined(OS_LINUX)
+#include <sys/sendfile.h>
+#endif
+
 // this is an async I/O implementation of the web server request parser
 // it is used by all netdata web servers
 
@@ -177,24 +182,30 @@ static void web_client_reset_allocations(struct web_client *w, bool free_all) {
     w->websocket.server_max_window_bits = 0;
 
     // if we had enabled compression, release it
-    if(w->response.zinitialized) {
-        deflateEnd(&w->response.zstream);
+    if(w->response.compressor) {
+        web_response_compressor_release(w->response.compressor);
+        w->response.compressor = NULL;
         w->response.zsent = 0;
         w->response.zhave = 0;
-        w->response.zstream.avail_in = 0;
-        w->response.zstream.avail_out = 0;
-        w->response.zstream.total_in = 0;
-        w->response.zstream.total_out = 0;
-        w->response.zinitialized = false;
         web_client_flag_clear(w, WEB_CLIENT_CHUNKED_TRANSFER);
     }
 
+    // if we were sending a file, close it
+    if(w->response.file.enabled) {
+        close(w->response.file.fd);
+        w->response.file.fd = -1;
+        w->response.file.offset = 0;
+        w->response.file.size = 0;
+        w->response.file.enabled = false;
+    }
+
     memset(w->transaction, 0, sizeof(w->transaction));
     memset(&w->auth, 0, sizeof(w->auth));
     memset(&w->user_auth, 0, sizeof(w->user_auth));
 
     web_client_reset_permissions(w);
     web_client_flag_clear(w, WEB_CLIENT_ENCODING_GZIP|WEB_CLIENT_ENCODING_DEFLATE);
+    w->accept_encoding = HTTP_CONTENT_ENCODING_NONE;
     web_client_flag_clear(w, WEB_CLIENT_FLAG_ACCEPT_JSON |
                              WEB_CLIENT_FLAG_ACCEPT_SSE |
                              WEB_CLIENT_FLAG_ACCEPT_TEXT);
@@ -205,8 +216,8 @@ void web_client_log_completed_request(struct web_client *w, bool update_web_stat
     struct timeval tv;
     now_monotonic_high_precision_timeval(&tv);
 
-    size_t size = w->response.data->len;
-    size_t sent = w->response.zoutput ? (size_t)w->response.zstream.total_out : size;
+    size_t size = w->response.data->len + (w->response.file.enabled ? w->response.file.size : 0);
+    size_t sent = (w->response.zoutput && w->response.compressor) ? web_response_compressor_total_out(w->response.compressor) : size;
 
     usec_t prep_ut = w->timings.tv_ready.tv_sec ? dt_usec(&w->timings.tv_ready, &w->timings.tv_in) : 0;
     usec_t sent_ut = w->timings.tv_ready.tv_sec ? dt_usec(&tv, &w->timings.tv_ready) : 0;
@@ -291,6 +302,7 @@ void web_client_request_done(struct web_client *w) {
     w->response.sent = 0;
     w->response.code = 0;
     w->response.zoutput = false;
+    w->response.zencoding = HTTP_CONTENT_ENCODING_NONE;
 
     w->statistics.received_bytes = 0;
     w->statistics.sent_bytes = 0;
@@ -350,6 +362,21 @@ static int append_slash_to_url_and_redirect(struct web_client *w) {
 // Work around a bug in the CMocka library by removing this function during testing.
 #ifndef REMOVE_MYSENDFILE
 
+static inline void web_client_disable_deflate(struct web_client *w) {
+    // no compressor has been acquired yet, it is acquired with the response header
+    w->response.zoutput = false;
+    web_client_flag_clear(w, WEB_CLIENT_CHUNKED_TRANSFER);
+}
+
+static inline bool web_client_can_sendfile(struct web_client *w) {
+#if defined(OS_LINUX)
+    return (web_client_check_conn_tcp(w) || web_client_check_conn_unix(w)) && !SSL_connection(&w->ssl);
+#else
+    (void)w;
+    return false;
+#endif
+}
+
 static inline int dashboard_version(struct web_client *w) {
     if(!web_client_flag_check(w, WEB_CLIENT_FLAG_PATH_WITH_VERSION))
         return -1;
@@ -487,23 +514,52 @@ static int web_server_static_file(struct web_client *w, char *filename) {
     if(is_dir && !web_client_flag_check(w, WEB_CLIENT_FLAG_PATH_HAS_TRAILING_SLASH))
         return append_slash_to_url_and_redirect(w);
 
-    buffer_flush(w->response.data);
-    buffer_need_bytes(w->response.data, (size_t)statbuf.st_size);
-    w->response.data->len = (size_t)statbuf.st_size;
+    HTTP_CONTENT_TYPE content_type = contenttype_for_filename(web_filename);
+    bool compressible = web_static_files_cache_compressible(content_type);
 
-    // open the file
-    int fd = open(web_filename, O_RDONLY | O_CLOEXEC);
+    // serve a pre-compressed version of the file, if the client accepts one
+    HTTP_CONTENT_ENCODING encoding = HTTP_CONTENT_ENCODING_NONE;
+    if(web_enable_gzip && w->accept_encoding && compressible)
+        encoding = web_static_files_cache_get(web_filename, &statbuf, content_type, w->accept_encoding, w->response.data);
 
-    // read the file
-    if(fd != -1 && read(fd, w->response.data->buffer, statbuf.st_size) != statbuf.st_size) {
-        // cannot read the whole file
-        nd_log(NDLS_DAEMON, NDLP_ERR, "Web server failed to read file '%s'", web_filename);
-        close(fd);
-        fd = -1;
+    int fd = -1;
+    if(encoding != HTTP_CONTENT_ENCODING_NONE) {
+        // the data are already compressed, do not compress them again
+        web_client_disable_deflate(w);
+        buffer_sprintf(w->response.header, "Content-Encoding: %s\r\nVary: Accept-Encoding\r\n",
+                       HTTP_CONTENT_ENCODING_2str(encoding));
+    }
+    else if(web_client_can_sendfile(w) && (!w->response.zoutput || !compressible)) {
+        // send the file as-is, without copying it to our buffers
+        buffer_flush(w->response.data);
+        fd = open(web_filename, O_RDONLY | O_CLOEXEC);
+        if(fd != -1) {
+            web_client_disable_deflate(w);
+            w->response.file.enabled = true;
+            w->response.file.fd = fd;
+            w->response.file.offset = 0;
+            w->response.file.size = (size_t)statbuf.st_size;
+        }
+    }
+    else {
+        buffer_flush(w->response.data);
+        buffer_need_bytes(w->response.data, (size_t)statbuf.st_size);
+        w->response.data->len = (size_t)statbuf.st_size;
+
+        // open the file
+        fd = open(web_filename, O_RDONLY | O_CLOEXEC);
+
+        // read the file
+        if(fd != -1 && read(fd, w->response.data->buffer, statbuf.st_size) != statbuf.st_size) {
+            // cannot read the whole file
+            nd_log(NDLS_DAEMON, NDLP_ERR, "Web server failed to read file '%s'", web_filename);
+            close(fd);
+            fd = -1;
+        }
     }
 
     // check for failures
-    if(fd == -1) {
+    if(fd == -1 && encoding == HTTP_CONTENT_ENCODING_NONE) {
         buffer_flush(w->response.data);
 
         if(errno == EBUSY || errno == EAGAIN) {
@@ -522,10 +578,10 @@ static int web_server_static_file(struct web_client *w, char *filename) {
             return HTTP_RESP_NOT_FOUND;
         }
     }
-    else
+    else if(fd != -1 && !w->response.file.enabled)
         close(fd);
 
-    w->response.data->content_type = contenttype_for_filename(web_filename);
+    w->response.data->content_type = content_type;
     netdata_log_debug(D_WEB_CLIENT_ACCESS, "%llu: Sending file '%s' (%"PRId64" bytes, fd %d).", w->id, web_filename, (int64_t)statbuf.st_size, w->fd);
 
     w->mode = HTTP_REQUEST_MODE_GET;
@@ -818,7 +874,25 @@ static inline ssize_t web_client_send_data(struct web_client *w,const void *buf,
     } while(true);
 }
 
+// the compressor of the response, acquired when its body is about to be compressed
+// returns NULL (and disables compression) when the response is not compressed
+WEB_RESPONSE_COMPRESSOR *web_client_response_compressor(struct web_client *w) {
+    if(!w->response.zoutput || w->response.compressor)
+        return w->response.compressor;
+
+    w->response.compressor = web_response_compressor_get(w->response.zencoding);
+    if(!w->response.compressor) {
+        w->response.zoutput = false;
+        web_client_flag_clear(w, WEB_CLIENT_CHUNKED_TRANSFER);
+    }
+
+    return w->response.compressor;
+}
+
 void web_client_build_http_header(struct web_client *w) {
+    // the body will be compressed, unless the response disabled compression
+    web_client_response_compressor(w);
+
     if(unlikely(w->response.code != HTTP_RESP_OK))
         buffer_no_cacheable(w->response.data);
 
@@ -930,15 +1004,17 @@ void web_client_build_http_header(struct web_client *w) {
         buffer_strcat(w->response.header_output, buffer_tostring(w->response.header));
 
     // headers related to the transfer method
-    if(likely(w->response.zoutput))
-        buffer_strcat(w->response.header_output, "Content-Encoding: gzip\r\n");
+    if(likely(w->response.zoutput && w->response.compressor))
+        buffer_sprintf(w->response.header_output, "Content-Encoding: %s\r\nVary: Accept-Encoding\r\n",
+                       HTTP_CONTENT_ENCODING_2str(web_response_compressor_encoding(w->response.compressor)));
 
     if(likely(w->flags & WEB_CLIENT_CHUNKED_TRANSFER))
         buffer_strcat(w->response.header_output, "Transfer-Encoding: chunked\r\n");
     else {
-        if(likely(w->response.data->len)) {
+        size_t content_length = w->response.data->len + (w->response.file.enabled ? w->response.file.size : 0);
+        if(likely(content_length)) {
             // we know the content length, put it
-            buffer_sprintf(w->response.header_output, "Content-Length: %zu\r\n", (size_t)w->response.data->len);
+            buffer_sprintf(w->response.header_output, "Content-Length: %zu\r\n", content_length);
         }
         else {
             // we don't know the content length, disable keep-alive
@@ -1537,7 +1613,7 @@ void web_client_process_request_from_web_server(struct web_client *w) {
     web_client_send_http_header(w);
 
     // enable sending immediately if we have data
-    if(w->response.data->len) web_client_enable_wait_send(w);
+    if(w->response.data->len || w->response.file.enabled) web_client_enable_wait_send(w);
     else web_client_disable_wait_send(w);
 
     switch(w->mode) {
@@ -1642,15 +1718,17 @@ ssize_t web_client_send_chunk_finalize(struct web_client *w)
 ssize_t web_client_send_deflate(struct web_client *w)
 {
     ssize_t len = 0, t = 0;
+    WEB_RESPONSE_COMPRESSOR *c = w->response.compressor;
 
     // when using compression,
     // w->response.sent is the amount of bytes passed through compression
 
     netdata_log_debug(D_DEFLATE,
-        "%llu: web_client_send_deflate(): w->response.data->len = %zu, w->response.sent = %zu, w->response.zhave = %zu, w->response.zsent = %zu, w->response.zstream.avail_in = %u, w->response.zstream.avail_out = %u, w->response.zstream.total_in = %lu, w->response.zstream.total_out = %lu.",
-        w->id, (size_t)w->response.data->len, w->response.sent, w->response.zhave, w->response.zsent, w->response.zstream.avail_in, w->response.zstream.avail_out, w->response.zstream.total_in, w->response.zstream.total_out);
+        "%llu: web_client_send_deflate(): w->response.data->len = %zu, w->response.sent = %zu, w->response.zhave = %zu, w->response.zsent = %zu, pending input = %zu, total_in = %zu, total_out = %zu.",
+        w->id, (size_t)w->response.data->len, w->response.sent, w->response.zhave, w->response.zsent,
+        web_response_compressor_pending_input(c), web_response_compressor_total_in(c), web_response_compressor_total_out(c));
 
-    if(w->response.data->len - w->response.sent == 0 && w->response.zstream.avail_in == 0 && w->response.zhave == w->response.zsent && w->response.zstream.avail_out != 0) {
+    if(w->response.data->len - w->response.sent == 0 && web_response_compressor_pending_input(c) == 0 && w->response.zhave == w->response.zsent && !web_response_compressor_has_output(c)) {
         // there is nothing to send
 
         netdata_log_debug(D_WEB_CLIENT, "%llu: Out of output data.", w->id);
@@ -1682,39 +1760,36 @@ ssize_t web_client_send_deflate(struct web_client *w)
             if(t < 0) return t;
         }
 
-        netdata_log_debug(D_DEFLATE, "%llu: Compressing %zu new bytes starting from %zu (and %u left behind).", w->id, (w->response.data->len - w->response.sent), w->response.sent, w->response.zstream.avail_in);
+        size_t pending = web_response_compressor_pending_input(c);
+        netdata_log_debug(D_DEFLATE, "%llu: Compressing %zu new bytes starting from %zu (and %zu left behind).", w->id, (w->response.data->len - w->response.sent), w->response.sent, pending);
 
-        // give the compressor all the data not passed through the compressor yet
-        if(w->response.data->len > w->response.sent) {
-            w->response.zstream.next_in = (Bytef *)&w->response.data->buffer[w->response.sent - w->response.zstream.avail_in];
-            w->response.zstream.avail_in += (uInt) (w->response.data->len - w->response.sent);
-        }
-
-        // reset the compressor output buffer
-        w->response.zstream.next_out = w->response.zbuffer;
-        w->response.zstream.avail_out = NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE;
+        // give the compressor all the data not consumed by the compressor yet
+        const char *in = &w->response.data->buffer[w->response.sent - pending];
+        size_t in_size = pending + (w->response.data->len - w->response.sent);
 
         // ask for FINISH if we have all the input
-        int flush = Z_SYNC_FLUSH;
+        bool finish = false;
         if((w->mode == HTTP_REQUEST_MODE_GET ||
              w->mode == HTTP_REQUEST_MODE_POST ||
              w->mode == HTTP_REQUEST_MODE_PUT ||
              w->mode == HTTP_REQUEST_MODE_DELETE)) {
-            flush = Z_FINISH;
-            netdata_log_debug(D_DEFLATE, "%llu: Requesting Z_FINISH, if possible.", w->id);
+            finish = true;
+            netdata_log_debug(D_DEFLATE, "%llu: Requesting FINISH, if possible.", w->id);
         }
         else {
-            netdata_log_debug(D_DEFLATE, "%llu: Requesting Z_SYNC_FLUSH.", w->id);
+            netdata_log_debug(D_DEFLATE, "%llu: Requesting FLUSH.", w->id);
         }
 
-        // compress
-        if(deflate(&w->response.zstream, flush) == Z_STREAM_ERROR) {
+        // compress - the output is limited to one chunk, so large responses
+        // are compressed progressively, as the socket accepts the data
+        ssize_t produced = web_response_compressor_compress(c, in, in_size, w->response.zbuffer, NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE, finish);
+        if(produced < 0) {
             netdata_log_error("%llu: Compression failed. Closing down client.", w->id);
             web_client_request_done(w);
             return(-1);
         }
 
-        w->response.zhave = NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE - w->response.zstream.avail_out;
+        w->response.zhave = (size_t)produced;
         w->response.zsent = 0;
 
         // keep track of the bytes passed through the compressor
@@ -1750,8 +1825,51 @@ ssize_t web_client_send_deflate(struct web_client *w)
     return(len);
 }
 
+#if defined(OS_LINUX)
+static ssize_t web_client_send_file(struct web_client *w) {
+    size_t left = w->response.file.size - (size_t)w->response.file.offset;
+
+    if(unlikely(!left)) {
+        // the whole file has been sent
+
+        if(unlikely(!web_client_has_keepalive(w))) {
+            netdata_log_debug(D_WEB_CLIENT, "%llu: Closing (keep-alive is not enabled). %zu bytes sent.", w->id, w->response.sent);
+            WEB_CLIENT_IS_DEAD(w);
+            return 0;
+        }
+
+        web_client_request_done(w);
+        netdata_log_debug(D_WEB_CLIENT, "%llu: Done sending file on socket. Waiting for next request on the same socket.", w->id);
+        return 0;
+    }
+
+    ssize_t bytes = sendfile(w->fd, w->response.file.fd, &w->response.file.offset, left);
+    if(likely(bytes > 0)) {
+        w->statistics.sent_bytes += bytes;
+        netdata_log_debug(D_WEB_CLIENT, "%llu: Sent %zd bytes of file.", w->id, bytes);
+    }
+    else if(bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        netdata_log_debug(D_WEB_CLIENT, "%llu: Did not send any bytes of file to the client.", w->id);
+        bytes = 0;
+    }
+    else {
+        // an error, or the file has been truncated since we started
+        netdata_log_debug(D_WEB_CLIENT, "%llu: Failed to send file to client.", w->id);
+        WEB_CLIENT_IS_DEAD(w);
+        bytes = -1;
+    }
+
+    return bytes;
+}
+#endif
+
 ssize_t web_client_send(struct web_client *w) {
-    if(likely(w->response.zoutput)) return web_client_send_deflate(w);
+    if(likely(w->response.zoutput && w->response.compressor)) return web_client_send_deflate(w);
+
+#if defined(OS_LINUX)
+    if(unlikely(w->response.file.enabled && w->response.data->len == w->response.sent))
+        return web_client_send_file(w);
+#endif
 
     ssize_t bytes;
 
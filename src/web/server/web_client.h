@@ -5,6 +5,7 @@
 
 #include "libnetdata/libnetdata.h"
 #include "../websocket/websocket.h"
+#include "web_response_compression.h"
 
 struct web_client;
 
@@ -159,11 +160,18 @@ struct response {
     short int code;         // the HTTP response code
     bool has_cookies;
     bool zoutput;           // if set to 1, web_client_send() will send compressed data
-    bool zinitialized;
-    z_stream zstream;                                    // zlib stream for sending compressed output to client
+    HTTP_CONTENT_ENCODING zencoding;                     // the encoding selected for the response, when zoutput is set
+    WEB_RESPONSE_COMPRESSOR *compressor;                 // the (pooled) compressor of the response, NULL until the body is compressed
     size_t zsent;                                        // the compressed bytes we have sent to the client
     size_t zhave;                                        // the compressed bytes that we have received from zlib
     Bytef zbuffer[NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE]; // temporary buffer for storing compressed output
+
+    struct {                // a static file sent with sendfile(), after the data buffer
+        bool enabled;
+        int fd;
+        off_t offset;       // the bytes of the file already sent
+        size_t size;        // the size of the file
+    } file;
 };
 
 struct web_client;
@@ -180,6 +188,7 @@ struct web_client {
     HTTP_ACL acl;                       // the access list of the client
     HTTP_ACL port_acl;                  // the operations permitted on the port the client connected to
     HTTP_ACCESS access;                 // the access permissions of the client
+    HTTP_CONTENT_ENCODING accept_encoding; // the encodings the client accepts (Accept-Encoding:)
     size_t header_parse_tries;
     size_t header_parse_last_size;
 
@@ -256,6 +265,7 @@ ssize_t web_client_receive(struct web_client *w);
 void web_client_process_request_from_web_server(struct web_client *w);
 void web_client_request_done(struct web_client *w);
 
+WEB_RESPONSE_COMPRESSOR *web_client_response_compressor(struct web_client *w);
 void web_client_build_http_header(struct web_client *w);
 
 void web_client_reuse_from_cache(struct web_client *w);
@@ -0,0 +1,356 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "web_response_compression.h"
+#include "web_client.h"
+#include "daemon/pulse/pulse-http-api.h"
+
+#ifdef ENABLE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+int web_enable_brotli = 1, web_brotli_level = 4;
+int web_enable_zstd = 1, web_zstd_level = 3;
+
+// the maximum number of idle compressors we keep per encoding
+#define WEB_RESPONSE_COMPRESSORS_POOL_MAX 64
+
+struct web_response_compressor {
+    HTTP_CONTENT_ENCODING encoding;
+    bool initialized;           // the compression context has been created
+    bool more_output;           // the compressor has more output to give
+
+    size_t pending_in;          // the input of the last call not consumed yet
+    size_t total_in;
+    size_t total_out;
+    usec_t time_ut;             // the time spent compressing
+
+    union {
+        z_stream zlib;
+#ifdef ENABLE_BROTLI
+        BrotliEncoderState *brotli;
+#endif
+#ifdef ENABLE_ZSTD
+        ZSTD_CCtx *zstd;
+#endif
+    };
+
+    struct web_response_compressor *prev, *next;
+};
+
+// brotli is not pooled: it cannot reset an encoder, so a pooled one would have
+// to be destroyed and created again on every reuse, like a new one
+typedef enum __attribute__((packed)) {
+    WEB_RESPONSE_COMPRESSOR_POOL_GZIP = 0,
+    WEB_RESPONSE_COMPRESSOR_POOL_ZSTD,
+
+    // terminator
+    WEB_RESPONSE_COMPRESSOR_POOL_MAX,
+} WEB_RESPONSE_COMPRESSOR_POOL;
+
+static struct {
+    SPINLOCK spinlock;
+    size_t count;
+    WEB_RESPONSE_COMPRESSOR *ll;
+} compressors_pool[WEB_RESPONSE_COMPRESSOR_POOL_MAX] = { 0 };
+
+// returns WEB_RESPONSE_COMPRESSOR_POOL_MAX for the encodings that are not pooled
+static inline WEB_RESPONSE_COMPRESSOR_POOL web_response_compressor_pool(HTTP_CONTENT_ENCODING encoding) {
+    switch(encoding) {
+        case HTTP_CONTENT_ENCODING_GZIP:
+            return WEB_RESPONSE_COMPRESSOR_POOL_GZIP;
+
+        case HTTP_CONTENT_ENCODING_ZSTD:
+            return WEB_RESPONSE_COMPRESSOR_POOL_ZSTD;
+
+        default:
+            return WEB_RESPONSE_COMPRESSOR_POOL_MAX;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+HTTP_CONTENT_ENCODING web_response_compression_select(HTTP_CONTENT_ENCODING accepted, bool streaming) {
+    if(!web_enable_gzip)
+        return HTTP_CONTENT_ENCODING_NONE;
+
+    // brotli and zstd cannot accept more input once they have been asked to finish,
+    // so responses that may grow while being sent are compressed with gzip.
+    if(!streaming) {
+#ifdef ENABLE_BROTLI
+        if(web_enable_brotli && (accepted & HTTP_CONTENT_ENCODING_BROTLI))
+            return HTTP_CONTENT_ENCODING_BROTLI;
+#endif
+
+#ifdef ENABLE_ZSTD
+        if(web_enable_zstd && (accepted & HTTP_CONTENT_ENCODING_ZSTD))
+            return HTTP_CONTENT_ENCODING_ZSTD;
+#endif
+    }
+
+    if(accepted & HTTP_CONTENT_ENCODING_GZIP)
+        return HTTP_CONTENT_ENCODING_GZIP;
+
+    return HTTP_CONTENT_ENCODING_NONE;
+}
+
+// ----------------------------------------------------------------------------
+// compression contexts
+
+static bool compressor_context_create(WEB_RESPONSE_COMPRESSOR *c) {
+    switch(c->encoding) {
+        case HTTP_CONTENT_ENCODING_GZIP:
+            c->zlib = (z_stream){ .zalloc = Z_NULL, .zfree = Z_NULL, .opaque = Z_NULL };
+
+            // Select GZIP compression: windowbits = 15 + 16 = 31
+            if(deflateInit2(&c->zlib, web_gzip_level, Z_DEFLATED, 15 + 16, 8, web_gzip_strategy) != Z_OK)
+                return false;
+            break;
+
+#ifdef ENABLE_BROTLI
+        case HTTP_CONTENT_ENCODING_BROTLI:
+            c->brotli = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+            if(!c->brotli)
+                return false;
+
+            BrotliEncoderSetParameter(c->brotli, BROTLI_PARAM_QUALITY, web_brotli_level);
+            BrotliEncoderSetParameter(c->brotli, BROTLI_PARAM_MODE, BROTLI_MODE_TEXT);
+            break;
+#endif
+
+#ifdef ENABLE_ZSTD
+        case HTTP_CONTENT_ENCODING_ZSTD:
+            c->zstd = ZSTD_createCCtx();
+            if(!c->zstd)
+                return false;
+
+            ZSTD_CCtx_setParameter(c->zstd, ZSTD_c_compressionLevel, web_zstd_level);
+            break;
+#endif
+
+        default:
+            return false;
+    }
+
+    c->initialized = true;
+    return true;
+}
+
+static void compressor_context_destroy(WEB_RESPONSE_COMPRESSOR *c) {
+    if(!c->initialized)
+        return;
+
+    switch(c->encoding) {
+        case HTTP_CONTENT_ENCODING_GZIP:
+            deflateEnd(&c->zlib);
+            break;
+
+#ifdef ENABLE_BROTLI
+        case HTTP_CONTENT_ENCODING_BROTLI:
+            BrotliEncoderDestroyInstance(c->brotli);
+            c->brotli = NULL;
+            break;
+#endif
+
+#ifdef ENABLE_ZSTD
+        case HTTP_CONTENT_ENCODING_ZSTD:
+            ZSTD_freeCCtx(c->zstd);
+            c->zstd = NULL;
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    c->initialized = false;
+}
+
+// prepare the context of a pooled compressor for a new response
+static bool compressor_context_reset(WEB_RESPONSE_COMPRESSOR *c) {
+    if(!c->initialized)
+        return compressor_context_create(c);
+
+    switch(c->encoding) {
+        case HTTP_CONTENT_ENCODING_GZIP:
+            return deflateReset(&c->zlib) == Z_OK;
+
+#ifdef ENABLE_ZSTD
+        case HTTP_CONTENT_ENCODING_ZSTD:
+            // this keeps the parameters and the allocated memory of the context
+            return !ZSTD_isError(ZSTD_CCtx_reset(c->zstd, ZSTD_reset_session_only));
+#endif
+
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// the pool
+
+WEB_RESPONSE_COMPRESSOR *web_response_compressor_get(HTTP_CONTENT_ENCODING encoding) {
+    WEB_RESPONSE_COMPRESSOR_POOL p = web_response_compressor_pool(encoding);
+    WEB_RESPONSE_COMPRESSOR *c = NULL;
+
+    if(p != WEB_RESPONSE_COMPRESSOR_POOL_MAX) {
+        spinlock_lock(&compressors_pool[p].spinlock);
+        c = compressors_pool[p].ll;
+        if(c) {
+            DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(compressors_pool[p].ll, c, prev, next);
+            compressors_pool[p].count--;
+        }
+        spinlock_unlock(&compressors_pool[p].spinlock);
+    }
+
+    if(!c) {
+        c = callocz(1, sizeof(*c));
+        c->encoding = encoding;
+    }
+
+    if(!compressor_context_reset(c)) {
+        netdata_log_error("Failed to initialize %s compression context. Proceeding without compression.",
+                          HTTP_CONTENT_ENCODING_2str(encoding));
+        compressor_context_destroy(c);
+        freez(c);
+        return NULL;
+    }
+
+    c->more_output = true;
+    c->pending_in = 0;
+    c->total_in = 0;
+    c->total_out = 0;
+    c->time_ut = 0;
+    return c;
+}
+
+void web_response_compressor_release(WEB_RESPONSE_COMPRESSOR *c) {
+    if(!c)
+        return;
+
+    if(c->total_in)
+        pulse_web_response_compressed(c->encoding, c->total_in, c->total_out, c->time_ut);
+
+    WEB_RESPONSE_COMPRESSOR_POOL p = web_response_compressor_pool(c->encoding);
+
+    if(p != WEB_RESPONSE_COMPRESSOR_POOL_MAX) {
+        spinlock_lock(&compressors_pool[p].spinlock);
+        if(compressors_pool[p].count < WEB_RESPONSE_COMPRESSORS_POOL_MAX) {
+            DOUBLE_LINKED_LIST_PREPEND_ITEM_UNSAFE(compressors_pool[p].ll, c, prev, next);
+            compressors_pool[p].count++;
+            c = NULL;
+        }
+        spinlock_unlock(&compressors_pool[p].spinlock);
+    }
+
+    if(c) {
+        compressor_context_destroy(c);
+        freez(c);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// compression
+
+ssize_t web_response_compressor_compress(WEB_RESPONSE_COMPRESSOR *c, const void *in, size_t in_size, void *out, size_t out_size, bool finish) {
+    usec_t started_ut = now_monotonic_usec();
+    size_t consumed = 0, produced = 0;
+
+    switch(c->encoding) {
+        case HTTP_CONTENT_ENCODING_GZIP: {
+            c->zlib.next_in = (Bytef *)in;
+            c->zlib.avail_in = (uInt)in_size;
+            c->zlib.next_out = out;
+            c->zlib.avail_out = (uInt)out_size;
+
+            if(deflate(&c->zlib, finish ? Z_FINISH : Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+                if(c->zlib.msg)
+                    netdata_log_error("Error compressing body. ZLIB error: \"%s\"", c->zlib.msg);
+                return -1;
+            }
+
+            consumed = in_size - c->zlib.avail_in;
+            produced = out_size - c->zlib.avail_out;
+
+            // when the output is full, zlib may have more to give
+            c->more_output = (c->zlib.avail_out == 0);
+            break;
+        }
+
+#ifdef ENABLE_BROTLI
+        case HTTP_CONTENT_ENCODING_BROTLI: {
+            const uint8_t *next_in = in;
+            size_t avail_in = in_size;
+            uint8_t *next_out = out;
+            size_t avail_out = out_size;
+
+            if(!BrotliEncoderCompressStream(c->brotli, finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH,
+                                            &avail_in, &next_in, &avail_out, &next_out, NULL)) {
+                netdata_log_error("Error compressing body with brotli.");
+                return -1;
+            }
+
+            consumed = in_size - avail_in;
+            produced = out_size - avail_out;
+            c->more_output = BrotliEncoderHasMoreOutput(c->brotli) || avail_in ||
+                             (finish && !BrotliEncoderIsFinished(c->brotli));
+            break;
+        }
+#endif
+
+#ifdef ENABLE_ZSTD
+        case HTTP_CONTENT_ENCODING_ZSTD: {
+            ZSTD_inBuffer inb = { .src = in, .size = in_size, .pos = 0 };
+            ZSTD_outBuffer outb = { .dst = out, .size = out_size, .pos = 0 };
+
+            size_t remaining = ZSTD_compressStream2(c->zstd, &outb, &inb, finish ? ZSTD_e_end : ZSTD_e_flush);
+            if(ZSTD_isError(remaining)) {
+                netdata_log_error("Error compressing body. ZSTD error: \"%s\"", ZSTD_getErrorName(remaining));
+                return -1;
+            }
+
+            consumed = inb.pos;
+            produced = outb.pos;
+
+            // zstd returns the bytes still to be flushed
+            c->more_output = (remaining != 0);
+            break;
+        }
+#endif
+
+        default:
+            return -1;
+    }
+
+    c->pending_in = in_size - consumed;
+    c->total_in += consumed;
+    c->total_out += produced;
+    c->time_ut += now_monotonic_usec() - started_ut;
+
+    return (ssize_t)produced;
+}
+
+// ----------------------------------------------------------------------------
+
+HTTP_CONTENT_ENCODING web_response_compressor_encoding(WEB_RESPONSE_COMPRESSOR *c) {
+    return c->encoding;
+}
+
+size_t web_response_compressor_pending_input(WEB_RESPONSE_COMPRESSOR *c) {
+    return c->pending_in;
+}
+
+bool web_response_compressor_has_output(WEB_RESPONSE_COMPRESSOR *c) {
+    return c->more_output;
+}
+
+size_t web_response_compressor_total_in(WEB_RESPONSE_COMPRESSOR *c) {
+    return c->total_in;
+}
+
+size_t web_response_compressor_total_out(WEB_RESPONSE_COMPRESSOR *c) {
+    return c->total_out;
+}
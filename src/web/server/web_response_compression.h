@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_WEB_RESPONSE_COMPRESSION_H
+#define NETDATA_WEB_RESPONSE_COMPRESSION_H 1
+
+#include "libnetdata/libnetdata.h"
+
+// Streaming compressors for the dynamic responses of the web server (gzip, brotli, zstd).
+// The gzip and zstd compressors are pooled per encoding and reset when reused, so that the
+// compression contexts (hash tables, windows) are not allocated for every request.
+// brotli encoders cannot be reset, so they are created for each response.
+//
+// What is reused across responses is the compression context (its match tables and
+// window memory). The history of a previous response is never used as a dictionary for
+// the next one: HTTP clients decode each response on its own, and preset dictionaries
+// need the client to have them too (Compression Dictionary Transport), which browsers
+// do not do for API responses.
+//
+// The body is compressed progressively while it is sent, one chunk at a time (see
+// web_client_send_deflate()), so a large response is never compressed in full before
+// its first bytes go out. It is not compressed while the API generates it: the
+// generators render the whole response into a BUFFER first, because its status and
+// headers depend on the outcome of the query.
+
+extern int web_enable_brotli, web_brotli_level;
+extern int web_enable_zstd, web_zstd_level;
+
+typedef struct web_response_compressor WEB_RESPONSE_COMPRESSOR;
+
+// the best encoding we can use for a response, given what the client accepts
+// streaming is true when the response may be extended after compression has started
+HTTP_CONTENT_ENCODING web_response_compression_select(HTTP_CONTENT_ENCODING accepted, bool streaming);
+
+// get a compressor for the encoding from the pool, or create a new one
+// call it only when the body of the response is going to be compressed
+WEB_RESPONSE_COMPRESSOR *web_response_compressor_get(HTTP_CONTENT_ENCODING encoding);
+
+// return a compressor to the pool and account its statistics
+void web_response_compressor_release(WEB_RESPONSE_COMPRESSOR *c);
+
+// compress up to in_size bytes of input into out
+// it returns the number of bytes written to out, or -1 on error
+// finish is true when there is no more input after this
+ssize_t web_response_compressor_compress(WEB_RESPONSE_COMPRESSOR *c, const void *in, size_t in_size, void *out, size_t out_size, bool finish);
+
+HTTP_CONTENT_ENCODING web_response_compressor_encoding(WEB_RESPONSE_COMPRESSOR *c);
+
+// the input bytes of the last call that have not been consumed yet
+size_t web_response_compressor_pending_input(WEB_RESPONSE_COMPRESSOR *c);
+
+// true when the compressor has more output to give, without new input
+bool web_response_compressor_has_output(WEB_RESPONSE_COMPRESSOR *c);
+
+// the bytes that have entered and exited the compressor since it was acquired
+size_t web_response_compressor_total_in(WEB_RESPONSE_COMPRESSOR *c);
+size_t web_response_compressor_total_out(WEB_RESPONSE_COMPRESSOR *c);
+
+#endif //NETDATA_WEB_RESPONSE_COMPRESSION_H
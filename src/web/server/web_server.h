@@ -55,6 +55,7 @@ struct web_client *web_client_create_on_listenfd(int listener);
 #include "web_client_cache.h"
 #endif // WEB_SERVER_INTERNALS
 
+#include "web_static_files_cache.h"
 #include "static/static-threaded.h"
 
 #endif /* NETDATA_WEB_SERVER_H */
@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "web_static_files_cache.h"
+
+#ifdef ENABLE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+// files outside these limits are served as-is
+#define STATIC_FILE_MIN_SIZE 1024
+#define STATIC_FILE_MAX_SIZE (32 * 1024 * 1024)
+
+// the files are compressed only once, so we use high compression levels
+#define STATIC_FILE_GZIP_LEVEL 9
+#define STATIC_FILE_BROTLI_QUALITY 9
+#define STATIC_FILE_ZSTD_LEVEL 15
+
+// we keep a compressed version only when it saves at least 10%
+#define STATIC_FILE_MIN_SAVINGS_PERCENT 10
+
+// the variants of each file, in the order we prefer them
+typedef enum __attribute__((packed)) {
+    STATIC_FILE_VARIANT_BROTLI = 0,
+    STATIC_FILE_VARIANT_ZSTD,
+    STATIC_FILE_VARIANT_GZIP,
+
+    // terminator
+    STATIC_FILE_VARIANT_MAX,
+} STATIC_FILE_VARIANT;
+
+static const HTTP_CONTENT_ENCODING static_file_variant_encoding[STATIC_FILE_VARIANT_MAX] = {
+    [STATIC_FILE_VARIANT_BROTLI] = HTTP_CONTENT_ENCODING_BROTLI,
+    [STATIC_FILE_VARIANT_ZSTD] = HTTP_CONTENT_ENCODING_ZSTD,
+    [STATIC_FILE_VARIANT_GZIP] = HTTP_CONTENT_ENCODING_GZIP,
+};
+
+struct static_file_variant {
+    bool done;                  // we have tried to compress the file with this encoding
+    void *data;                 // the compressed data, NULL when compression is not beneficial
+    size_t size;                // the size of the compressed data
+};
+
+struct static_file {
+    netdata_mutex_t mutex;      // serializes the compression of the file
+
+    // the identity of the file on disk, when it was compressed
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    time_t mtime_s;
+    long mtime_ns;
+
+    struct static_file_variant variants[STATIC_FILE_VARIANT_MAX];
+};
+
+static struct {
+    DICTIONARY *files;
+    size_t max_memory;
+    size_t memory;              // atomic, the memory used by the compressed variants
+} static_files_cache = { 0 };
+
+// ----------------------------------------------------------------------------
+// compressors
+
+static size_t static_file_compress_gzip(const void *src, size_t src_size, void **dst) {
+    z_stream zs = { 0 };
+    if(deflateInit2(&zs, STATIC_FILE_GZIP_LEVEL, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+        return 0;
+
+    size_t bound = deflateBound(&zs, src_size);
+    *dst = mallocz(bound);
+
+    zs.next_in = (Bytef *)src;
+    zs.avail_in = (uInt)src_size;
+    zs.next_out = *dst;
+    zs.avail_out = (uInt)bound;
+
+    size_t size = 0;
+    if(deflate(&zs, Z_FINISH) == Z_STREAM_END)
+        size = zs.total_out;
+
+    deflateEnd(&zs);
+    return size;
+}
+
+#ifdef ENABLE_BROTLI
+static size_t static_file_compress_brotli(const void *src, size_t src_size, void **dst) {
+    size_t size = BrotliEncoderMaxCompressedSize(src_size);
+    if(!size)
+        return 0;
+
+    *dst = mallocz(size);
+    if(!BrotliEncoderCompress(STATIC_FILE_BROTLI_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                              src_size, src, &size, *dst))
+        return 0;
+
+    return size;
+}
+#endif
+
+#ifdef ENABLE_ZSTD
+static size_t static_file_compress_zstd(const void *src, size_t src_size, void **dst) {
+    size_t bound = ZSTD_compressBound(src_size);
+    *dst = mallocz(bound);
+
+    size_t size = ZSTD_compress(*dst, bound, src, src_size, STATIC_FILE_ZSTD_LEVEL);
+    if(ZSTD_isError(size))
+        return 0;
+
+    return size;
+}
+#endif
+
+HTTP_CONTENT_ENCODING web_static_files_cache_encodings(void) {
+    HTTP_CONTENT_ENCODING encodings = HTTP_CONTENT_ENCODING_GZIP;
+
+#ifdef ENABLE_BROTLI
+    encodings |= HTTP_CONTENT_ENCODING_BROTLI;
+#endif
+
+#ifdef ENABLE_ZSTD
+    encodings |= HTTP_CONTENT_ENCODING_ZSTD;
+#endif
+
+    return encodings;
+}
+
+// ----------------------------------------------------------------------------
+
+bool web_static_files_cache_compressible(HTTP_CONTENT_TYPE content_type) {
+    switch(content_type) {
+        case CT_APPLICATION_JSON:
+        case CT_TEXT_PLAIN:
+        case CT_TEXT_HTML:
+        case CT_APPLICATION_X_JAVASCRIPT:
+        case CT_TEXT_CSS:
+        case CT_TEXT_XML:
+        case CT_APPLICATION_XML:
+        case CT_TEXT_XSL:
+        case CT_IMAGE_SVG_XML:
+        case CT_APPLICATION_X_FONT_TRUETYPE:
+        case CT_APPLICATION_X_FONT_OPENTYPE:
+        case CT_APPLICATION_VND_MS_FONTOBJ:
+        case CT_IMAGE_XICON:
+        case CT_IMAGE_BMP:
+        case CT_APPLICATION_WASM:
+        case CT_TEXT_YAML:
+        case CT_APPLICATION_YAML:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static void static_file_release_variants(struct static_file *sf) {
+    for(size_t v = 0; v < STATIC_FILE_VARIANT_MAX; v++) {
+        if(sf->variants[v].data) {
+            freez(sf->variants[v].data);
+            __atomic_sub_fetch(&static_files_cache.memory, sf->variants[v].size, __ATOMIC_RELAXED);
+        }
+
+        sf->variants[v] = (struct static_file_variant){ 0 };
+    }
+}
+
+static bool static_file_is_stale(struct static_file *sf, const struct stat *st) {
+#ifdef __APPLE__
+    time_t mtime_s = st->st_mtimespec.tv_sec;
+    long mtime_ns = st->st_mtimespec.tv_nsec;
+#else
+    time_t mtime_s = st->st_mtim.tv_sec;
+    long mtime_ns = st->st_mtim.tv_nsec;
+#endif
+
+    if(sf->dev == st->st_dev && sf->ino == st->st_ino && sf->size == st->st_size &&
+        sf->mtime_s == mtime_s && sf->mtime_ns == mtime_ns)
+        return false;
+
+    sf->dev = st->st_dev;
+    sf->ino = st->st_ino;
+    sf->size = st->st_size;
+    sf->mtime_s = mtime_s;
+    sf->mtime_ns = mtime_ns;
+    return true;
+}
+
+static void *static_file_read(const char *filename, size_t size) {
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+        return NULL;
+
+    char *data = mallocz(size);
+    size_t have = 0;
+    while(have < size) {
+        ssize_t rc = read(fd, &data[have], size - have);
+        if(rc <= 0) {
+            if(rc == -1 && errno == EINTR)
+                continue;
+            break;
+        }
+        have += rc;
+    }
+    close(fd);
+
+    if(have != size) {
+        freez(data);
+        return NULL;
+    }
+
+    return data;
+}
+
+static void static_file_compress(struct static_file *sf, STATIC_FILE_VARIANT v, const char *filename, void **data) {
+    struct static_file_variant *sv = &sf->variants[v];
+    sv->done = true;
+
+    size_t size = (size_t)sf->size;
+    if(__atomic_load_n(&static_files_cache.memory, __ATOMIC_RELAXED) + size > static_files_cache.max_memory)
+        // the cache is full, do not even try
+        return;
+
+    if(!*data) {
+        *data = static_file_read(filename, size);
+        if(!*data)
+            return;
+    }
+
+    void *compressed = NULL;
+    size_t compressed_size = 0;
+    switch(v) {
+        case STATIC_FILE_VARIANT_GZIP:
+            compressed_size = static_file_compress_gzip(*data, size, &compressed);
+            break;
+
+#ifdef ENABLE_BROTLI
+        case STATIC_FILE_VARIANT_BROTLI:
+            compressed_size = static_file_compress_brotli(*data, size, &compressed);
+            break;
+#endif
+
+#ifdef ENABLE_ZSTD
+        case STATIC_FILE_VARIANT_ZSTD:
+            compressed_size = static_file_compress_zstd(*data, size, &compressed);
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    if(!compressed_size || compressed_size > size * (100 - STATIC_FILE_MIN_SAVINGS_PERCENT) / 100) {
+        freez(compressed);
+        return;
+    }
+
+    sv->data = reallocz(compressed, compressed_size);
+    sv->size = compressed_size;
+    __atomic_add_fetch(&static_files_cache.memory, compressed_size, __ATOMIC_RELAXED);
+
+    netdata_log_debug(D_WEB_CLIENT, "Compressed static file '%s' with %s, from %zu to %zu bytes",
+                      filename, HTTP_CONTENT_ENCODING_2str(static_file_variant_encoding[v]), size, compressed_size);
+}
+
+HTTP_CONTENT_ENCODING web_static_files_cache_get(const char *filename, const struct stat *st, HTTP_CONTENT_TYPE content_type, HTTP_CONTENT_ENCODING accepted, BUFFER *dst) {
+    accepted &= web_static_files_cache_encodings();
+
+    if(!static_files_cache.files || !accepted ||
+        st->st_size < STATIC_FILE_MIN_SIZE || st->st_size > STATIC_FILE_MAX_SIZE ||
+        !web_static_files_cache_compressible(content_type))
+        return HTTP_CONTENT_ENCODING_NONE;
+
+    const DICTIONARY_ITEM *item = dictionary_set_and_acquire_item(static_files_cache.files, filename, NULL, sizeof(struct static_file));
+    struct static_file *sf = dictionary_acquired_item_value(item);
+    HTTP_CONTENT_ENCODING encoding = HTTP_CONTENT_ENCODING_NONE;
+    void *data = NULL;
+
+    netdata_mutex_lock(&sf->mutex);
+
+    if(static_file_is_stale(sf, st))
+        static_file_release_variants(sf);
+
+    for(STATIC_FILE_VARIANT v = 0; v < STATIC_FILE_VARIANT_MAX; v++) {
+        if(!(accepted & static_file_variant_encoding[v]))
+            continue;
+
+        if(!sf->variants[v].done)
+            static_file_compress(sf, v, filename, &data);
+
+        if(sf->variants[v].data) {
+            buffer_flush(dst);
+            buffer_need_bytes(dst, sf->variants[v].size);
+            memcpy(dst->buffer, sf->variants[v].data, sf->variants[v].size);
+            dst->len = sf->variants[v].size;
+            encoding = static_file_variant_encoding[v];
+            break;
+        }
+    }
+
+    netdata_mutex_unlock(&sf->mutex);
+    dictionary_acquired_item_release(static_files_cache.files, item);
+
+    freez(data);
+    return encoding;
+}
+
+// ----------------------------------------------------------------------------
+
+static void static_file_insert_cb(const DICTIONARY_ITEM *item __maybe_unused, void *value, void *data __maybe_unused) {
+    struct static_file *sf = value;
+    netdata_mutex_init(&sf->mutex);
+}
+
+static void static_file_delete_cb(const DICTIONARY_ITEM *item __maybe_unused, void *value, void *data __maybe_unused) {
+    struct static_file *sf = value;
+    static_file_release_variants(sf);
+    netdata_mutex_destroy(&sf->mutex);
+}
+
+void web_static_files_cache_init(size_t max_memory) {
+    FUNCTION_RUN_ONCE();
+
+    static_files_cache.max_memory = max_memory;
+    if(!max_memory)
+        return;
+
+    static_files_cache.files = dictionary_create_advanced(
+        DICT_OPTION_FIXED_SIZE | DICT_OPTION_DONT_OVERWRITE_VALUE, NULL, sizeof(struct static_file));
+
+    dictionary_register_insert_callback(static_files_cache.files, static_file_insert_cb, NULL);
+    dictionary_register_delete_callback(static_files_cache.files, static_file_delete_cb, NULL);
+}
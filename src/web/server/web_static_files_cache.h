@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_WEB_STATIC_FILES_CACHE_H
+#define NETDATA_WEB_STATIC_FILES_CACHE_H 1
+
+#include "libnetdata/libnetdata.h"
+
+// The static files of the dashboard are compressed once, the first time a client
+// accepting an encoding requests them, and the compressed copies are kept in memory,
+// so that the web server does not recompress the same files for every browser.
+// The cache is invalidated per file, when its size, inode or modification time changes.
+
+void web_static_files_cache_init(size_t max_memory);
+
+// true when it is worth compressing files of this content type
+bool web_static_files_cache_compressible(HTTP_CONTENT_TYPE content_type);
+
+// the encodings the cache can produce on this system
+HTTP_CONTENT_ENCODING web_static_files_cache_encodings(void);
+
+// copy to dst the best compressed version of the file the client accepts
+// it returns the encoding of the data copied, or HTTP_CONTENT_ENCODING_NONE when nothing has been copied
+HTTP_CONTENT_ENCODING web_static_files_cache_get(const char *filename, const struct stat *st, HTTP_CONTENT_TYPE content_type, HTTP_CONTENT_ENCODING accepted, BUFFER *dst);
+
+#endif //NETDATA_WEB_STATIC_FILES_CACHE_H